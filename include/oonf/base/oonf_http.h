@@ -94,6 +94,9 @@ enum oonf_http_result
 
   /*! special result to signal start of file transfer */
   HTTP_START_FILE_TRANSFER = 99999,
+
+  /*! special result to signal start of a streamed answer */
+  HTTP_START_STREAM_TRANSFER = 99998,
 };
 
 /**
@@ -142,6 +145,26 @@ struct oonf_http_session {
 
   /*! number of bytes already being downloaded */
   size_t transfer_length;
+
+  /**
+   * Callback to generate the next chunk of a streamed answer, must be
+   * set by a content handler that returns HTTP_START_STREAM_TRANSFER.
+   * It is called each time the output buffer is empty.
+   * @param out output buffer for the next chunk
+   * @param stream_data custom data of the stream
+   * @return -1 if an error happened, 0 if the answer is complete,
+   *   1 if more output will follow
+   */
+  int (*stream_next)(struct autobuf *out, void *stream_data);
+
+  /**
+   * Callback to free the resources of a streamed answer, might be NULL
+   * @param stream_data custom data of the stream
+   */
+  void (*stream_cleanup)(void *stream_data);
+
+  /*! custom data for streamed answer */
+  void *stream_data;
 };
 
 /**
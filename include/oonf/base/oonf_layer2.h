@@ -49,6 +49,7 @@
 #include <oonf/oonf.h>
 #include <oonf/libcommon/avl.h>
 #include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_timer.h>
 #include <oonf/base/os_interface.h>
 
 /*! subsystem identifier */
@@ -75,6 +76,9 @@
 enum {
   /*! maximum length of link id for layer2 neighbors */
   OONF_LAYER2_MAX_LINK_ID = 16,
+
+  /*! scaling of the poll volatility, value for "every poll changed data" */
+  OONF_LAYER2_POLL_VOLATILITY_MAX = 1000,
 };
 
 /* configuration Macros for Layer2 keys */
@@ -653,9 +657,59 @@ struct oonf_layer2_lid {
   struct avl_node _node;
 };
 
+/**
+ * Adaptive polling schedule of a layer2 data source. The interval
+ * between two polls shrinks when the polled data changes and grows
+ * (faster for expensive queries) while the data stays stable.
+ */
+struct oonf_layer2_poll {
+  /*! name of the poll, used for layer2info output */
+  char name[32];
+
+  /*! relative cost of a query, higher cost backs off faster (0 is treated as 1) */
+  uint32_t cost;
+
+  /*! shortest allowed interval between two polls in milliseconds */
+  uint64_t min_interval;
+
+  /*! longest allowed interval between two polls in milliseconds */
+  uint64_t max_interval;
+
+  /**
+   * Callback to trigger a poll of the data source, the source has
+   * to report the result with oonf_layer2_poll_done()
+   * @param poll poll object
+   */
+  void (*cb_poll)(struct oonf_layer2_poll *poll);
+
+  /*! current interval between two polls in milliseconds */
+  uint64_t interval;
+
+  /*! moving average of polls that changed data (0 - OONF_LAYER2_POLL_VOLATILITY_MAX) */
+  uint32_t volatility;
+
+  /*! number of finished polls */
+  uint32_t polls;
+
+  /*! number of finished polls that changed data */
+  uint32_t changed_polls;
+
+  /*! timer for triggering the next poll */
+  struct oonf_timer_instance _timer;
+
+  /*! hook into list of polls */
+  struct list_entity _node;
+};
+
 EXPORT void oonf_layer2_origin_add(struct oonf_layer2_origin *origin);
 EXPORT void oonf_layer2_origin_remove(struct oonf_layer2_origin *origin);
 
+EXPORT void oonf_layer2_poll_add(struct oonf_layer2_poll *poll);
+EXPORT void oonf_layer2_poll_remove(struct oonf_layer2_poll *poll);
+EXPORT void oonf_layer2_poll_set_bounds(struct oonf_layer2_poll *poll, uint64_t min_interval, uint64_t max_interval);
+EXPORT void oonf_layer2_poll_done(struct oonf_layer2_poll *poll, bool changed);
+EXPORT struct list_entity *oonf_layer2_get_poll_list(void);
+
 EXPORT int oonf_layer2_data_parse_string(
   union oonf_layer2_value *value, const struct oonf_layer2_metadata *meta, const char *input);
 EXPORT const char *oonf_layer2_data_to_string(
@@ -230,7 +230,9 @@ struct oonf_stream_config {
    */
   /**
    * Callback to notify that the user asked scheduler to write
-   * data, but outgoing buffer is empty
+   * data, but outgoing buffer is empty. This is also called
+   * in SEND_AND_QUIT state, so a session can stream a large
+   * answer chunk by chunk before it terminates.
    * @param session stream session
    * @return stream session status code
    */
@@ -56,6 +56,12 @@
 /*! subsystem identifier */
 #define OONF_TELNET_SUBSYSTEM "telnet"
 
+enum
+{
+  /*! preferred number of bytes a stream handler generates per call */
+  OONF_TELNET_STREAM_CHUNK = 16384,
+};
+
 /**
  * telnet session status
  */
@@ -135,6 +141,30 @@ struct oonf_telnet_data {
   /*! custom timer for stop handler */
   struct oonf_timer_instance stop_timer;
 
+  /**
+   * Callback triggered to generate the next chunk of a streamed
+   * command output as soon as the output buffer is empty.
+   * It should append about OONF_TELNET_STREAM_CHUNK bytes to the
+   * output buffer and return.
+   * @param data this telnet data object
+   * @return TELNET_RESULT_CONTINOUS if more output will follow,
+   *   TELNET_RESULT_ACTIVE if the output is complete
+   */
+  enum oonf_telnet_result (*stream_handler)(struct oonf_telnet_data *data);
+
+  /**
+   * Callback triggered when a streamed output is finished or aborted,
+   * might be NULL
+   * @param data this telnet data object
+   */
+  void (*stream_cleanup)(struct oonf_telnet_data *data);
+
+  /*! custom data for stream handler */
+  void *stream_data;
+
+  /*! length of output buffer before the current call of the stream handler */
+  size_t _stream_chunk_start;
+
   /*! list of cleanup handlers */
   struct list_entity cleanup_list;
 };
@@ -204,6 +234,14 @@ EXPORT void oonf_telnet_stop(struct oonf_telnet_data *data, bool print_prompt);
 EXPORT enum oonf_telnet_result oonf_telnet_execute(
   const char *cmd, const char *para, struct autobuf *out, struct netaddr *remote);
 
+EXPORT void oonf_telnet_session_init(
+  struct oonf_telnet_session *session, struct autobuf *out, struct netaddr *remote);
+EXPORT enum oonf_telnet_result oonf_telnet_session_execute(
+  struct oonf_telnet_session *session, const char *cmd, const char *para);
+EXPORT void oonf_telnet_session_cleanup(struct oonf_telnet_session *session);
+
+EXPORT enum oonf_telnet_result oonf_telnet_stream_next(struct oonf_telnet_data *data);
+
 /**
  * Add a cleanup handler to a telnet session
  * @param data pointer to telnet data
@@ -224,6 +262,26 @@ oonf_telnet_remove_cleanup(struct oonf_telnet_cleanup *cleanup) {
   list_remove(&cleanup->node);
 }
 
+/**
+ * @param data pointer to telnet data
+ * @return true if the telnet command is streaming its output
+ */
+static INLINE bool
+oonf_telnet_is_streaming(struct oonf_telnet_data *data) {
+  return data->stream_handler != NULL;
+}
+
+/**
+ * Check if a stream handler has generated enough output for
+ * this chunk
+ * @param data pointer to telnet data
+ * @return true if the stream handler should return
+ */
+static INLINE bool
+oonf_telnet_is_chunk_full(struct oonf_telnet_data *data) {
+  return abuf_getlen(data->out) - data->_stream_chunk_start >= OONF_TELNET_STREAM_CHUNK;
+}
+
 /**
  * Flushs the output stream of a telnet session. This will be only
  * necessary for continous output.
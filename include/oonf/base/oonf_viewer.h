@@ -53,6 +53,7 @@
 
 #include <oonf/libcore/oonf_subsystem.h>
 #include <oonf/base/oonf_telnet.h> /* compile-time dependency */
+#include <oonf/base/os_routing.h> /* compile-time dependency */
 
 /*! subsystem identifier */
 #define OONF_VIEWER_SUBSYSTEM "viewer"
@@ -78,6 +79,27 @@
  */
 #define OONF_VIEWER_DATA_RAW_FORMAT "dataraw"
 
+/**
+ * Position of a streamed viewer output, stores the key
+ * of the last element that has been printed.
+ */
+struct oonf_viewer_cursor {
+  /*! true if the cursor contains a valid key */
+  bool valid;
+
+  /*! custom index, e.g. for iterating over domains */
+  int32_t index;
+
+  /*! key of the last element that has been printed */
+  union {
+    /*! key of a tree with netaddr keys */
+    struct netaddr addr;
+
+    /*! key of a tree with routing keys */
+    struct os_route_key route;
+  } key;
+};
+
 /**
  * This struct defines a template engine command that can output both
  * table and JSON.
@@ -117,6 +139,23 @@ struct oonf_viewer_template {
    */
   int (*cb_function)(struct oonf_viewer_template *);
 
+  /**
+   * Callback triggered to generate the next part of the content of
+   * the template, might be NULL. It should stop generating output
+   * when oonf_viewer_output_is_chunk_full() returns true and store
+   * its position in the cursor.
+   * @param this viewer template
+   * @return -1 if an error happened, 0 if the output is complete,
+   *   1 if more output will follow
+   */
+  int (*cb_stream)(struct oonf_viewer_template *);
+
+  /*! position of streamed output */
+  struct oonf_viewer_cursor cursor;
+
+  /*! internal variable with length of output buffer at start of chunk */
+  size_t _chunk_start;
+
   /*! internal variable for template engine storage array */
   struct abuf_template_storage *_storage;
 
@@ -137,5 +176,20 @@ EXPORT enum oonf_telnet_result oonf_viewer_telnet_handler(struct autobuf *out, s
   const char *cmd, const char *param, struct oonf_viewer_template *templates, size_t count);
 EXPORT enum oonf_telnet_result oonf_viewer_telnet_help(
   struct autobuf *out, const char *cmd, const char *parameter, struct oonf_viewer_template *template, size_t count);
+EXPORT enum oonf_telnet_result oonf_viewer_telnet_stream(struct oonf_telnet_data *con,
+  struct abuf_template_storage *storage, const char *cmd, struct oonf_viewer_template *templates, size_t count);
+EXPORT struct avl_node *oonf_viewer_stream_next_node(
+  struct avl_tree *tree, struct oonf_viewer_cursor *cursor, size_t key_size);
+
+/**
+ * Check if a streamed viewer output has generated enough output
+ * for the current chunk
+ * @param template pointer to viewer template
+ * @return true if the stream callback should return
+ */
+static INLINE bool
+oonf_viewer_output_is_chunk_full(struct oonf_viewer_template *template) {
+  return abuf_getlen(template->out) - template->_chunk_start >= OONF_TELNET_STREAM_CHUNK;
+}
 
 #endif /* OONF_VIEWER_H_ */
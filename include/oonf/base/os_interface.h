@@ -76,6 +76,62 @@ struct os_interface_listener;
 #error "Unknown operation system"
 #endif
 
+/**
+ * Kinds of changes of an operation system interface, used as a bitmask
+ */
+enum os_interface_change
+{
+  /*! interface went up or down */
+  OS_INTERFACE_CHANGE_STATE = 1 << 0,
+
+  /*! promisc/pointtopoint/loopback/multicast flags changed */
+  OS_INTERFACE_CHANGE_FLAGS = 1 << 1,
+
+  /*! interface index or base index changed */
+  OS_INTERFACE_CHANGE_INDEX = 1 << 2,
+
+  /*! MAC address changed */
+  OS_INTERFACE_CHANGE_MAC = 1 << 3,
+
+  /*! MTU changed */
+  OS_INTERFACE_CHANGE_MTU = 1 << 4,
+
+  /*! IPv4 address added */
+  OS_INTERFACE_CHANGE_IPV4_ADDED = 1 << 5,
+
+  /*! IPv4 address removed */
+  OS_INTERFACE_CHANGE_IPV4_REMOVED = 1 << 6,
+
+  /*! IPv6 address added */
+  OS_INTERFACE_CHANGE_IPV6_ADDED = 1 << 7,
+
+  /*! IPv6 address removed */
+  OS_INTERFACE_CHANGE_IPV6_REMOVED = 1 << 8,
+
+  /*! peer address added or removed */
+  OS_INTERFACE_CHANGE_PEER = 1 << 9,
+
+  /*! listener was added or explicitly triggered, always delivered */
+  OS_INTERFACE_CHANGE_TRIGGER = 1 << 10,
+
+  /*! all link level changes */
+  OS_INTERFACE_CHANGE_LINK = OS_INTERFACE_CHANGE_STATE | OS_INTERFACE_CHANGE_FLAGS | OS_INTERFACE_CHANGE_INDEX |
+                             OS_INTERFACE_CHANGE_MAC | OS_INTERFACE_CHANGE_MTU,
+
+  /*! all IPv4 address changes */
+  OS_INTERFACE_CHANGE_IPV4 = OS_INTERFACE_CHANGE_IPV4_ADDED | OS_INTERFACE_CHANGE_IPV4_REMOVED,
+
+  /*! all IPv6 address changes */
+  OS_INTERFACE_CHANGE_IPV6 = OS_INTERFACE_CHANGE_IPV6_ADDED | OS_INTERFACE_CHANGE_IPV6_REMOVED,
+
+  /*! all local address changes */
+  OS_INTERFACE_CHANGE_ADDRESS = OS_INTERFACE_CHANGE_IPV4 | OS_INTERFACE_CHANGE_IPV6,
+
+  /*! all kinds of changes */
+  OS_INTERFACE_CHANGE_ALL = OS_INTERFACE_CHANGE_LINK | OS_INTERFACE_CHANGE_ADDRESS | OS_INTERFACE_CHANGE_PEER |
+                            OS_INTERFACE_CHANGE_TRIGGER,
+};
+
 /**
  * Handler for changing an interface address
  */
@@ -151,6 +207,9 @@ struct os_interface {
   /*! mac address of interface */
   struct netaddr mac;
 
+  /*! maximum transmission unit of interface */
+  uint32_t mtu;
+
   /**
    * point to one (mesh scope) IPv4 address of the interface
    * (or to NETADDR_UNSPEC if none available)
@@ -228,6 +287,12 @@ struct os_interface_listener {
   /*! true if this interface needs to be a mesh interface */
   bool mesh;
 
+  /**
+   * bitmask of os_interface_change values this listener is
+   * interested in, 0 for all changes
+   */
+  uint32_t change_mask;
+
   /**
    * Callback triggered when the interface changed
    * @param listener pointer to this listener
@@ -239,8 +304,11 @@ struct os_interface_listener {
   /*! pointer to interface data */
   struct os_interface *data;
 
-  /*! true if this listener still needs to process a change */
-  bool _dirty;
+  /**
+   * bitmask of os_interface_change values collected since the last
+   * successful call of the if_changed callback
+   */
+  uint32_t changes;
 
   /*! hook to global list of listeners */
   struct list_entity _node;
@@ -61,6 +61,10 @@ EXPORT int os_routing_linux_query(struct os_route *);
 EXPORT void os_routing_linux_interrupt(struct os_route *);
 EXPORT bool os_routing_linux_is_in_progress(struct os_route *);
 
+EXPORT bool os_routing_linux_supports_nexthop_objects(void);
+EXPORT int os_routing_linux_nexthop_set(struct os_route_nexthop *, bool set);
+EXPORT void os_routing_linux_nexthop_interrupt(struct os_route_nexthop *);
+
 EXPORT void os_routing_linux_listener_add(struct os_route_listener *);
 EXPORT void os_routing_linux_listener_remove(struct os_route_listener *);
 
@@ -123,6 +127,37 @@ os_routing_is_in_progress(struct os_route *route) {
   return os_routing_linux_is_in_progress(route);
 }
 
+/**
+ * Check if kernel supports nexthop objects
+ * @return true if routes can reference nexthop objects
+ */
+static INLINE bool
+os_routing_supports_nexthop_objects(void) {
+  return os_routing_linux_supports_nexthop_objects();
+}
+
+/**
+ * Create, update or remove a kernel nexthop object. The nexthop
+ * gets an id when it is set for the first time, the id can be used
+ * by routes directly after this call.
+ * @param nexthop nexthop object
+ * @param set true if nexthop should be set, false if it should be removed
+ * @return -1 if an error happened, 0 otherwise
+ */
+static INLINE int
+os_routing_nexthop_set(struct os_route_nexthop *nexthop, bool set) {
+  return os_routing_linux_nexthop_set(nexthop, set);
+}
+
+/**
+ * Stop processing of a nexthop command
+ * @param nexthop nexthop object
+ */
+static INLINE void
+os_routing_nexthop_interrupt(struct os_route_nexthop *nexthop) {
+  os_routing_linux_nexthop_interrupt(nexthop);
+}
+
 /**
  * Add routing change listener
  * @param listener routing change listener
@@ -47,6 +47,7 @@
 #define OS_ROUTING_LINUX_DATA_H_
 
 struct os_route_internal;
+struct os_route_nexthop_internal;
 struct os_route_listener_internal;
 
 #include <oonf/oonf.h>
@@ -63,8 +64,22 @@ struct os_route_internal {
 
   struct os_system_netlink_message msg;
 
+  /* (well aligned) buffer for netlink message, large enough for multipath routes */
+  uint64_t nl_buffer[512/sizeof(uint64_t)];
+};
+
+/**
+ * linux specific data for changing a kernel nexthop object
+ */
+struct os_route_nexthop_internal {
+  /*! hook into tree of allocated nexthop ids */
+  struct avl_node _node;
+
+  /*! netlink message for nexthop command */
+  struct os_system_netlink_message msg;
+
   /* (well aligned) buffer for netlink message */
-  uint64_t nl_buffer[256/sizeof(uint64_t)];
+  uint64_t nl_buffer[128/sizeof(uint64_t)];
 };
 
 /**
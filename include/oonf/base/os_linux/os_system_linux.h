@@ -65,6 +65,7 @@ EXPORT bool os_system_linux_is_ipv6_supported(void);
 EXPORT bool os_system_linux_is_minimal_kernel(int v1, int v2, int v3);
 EXPORT int os_system_linux_netlink_add(struct os_system_netlink *, int protocol);
 EXPORT void os_system_linux_netlink_remove(struct os_system_netlink *);
+EXPORT int os_system_linux_netlink_add_mc(struct os_system_netlink *, const uint32_t *groups, size_t count);
 EXPORT void os_system_linux_netlink_send(struct os_system_netlink *fd, struct os_system_netlink_message *msg);
 
 EXPORT int os_system_linux_netlink_addreq(
@@ -47,6 +47,7 @@
 #define OS_ROUTING_H_
 
 struct os_route;
+struct os_route_nexthop;
 struct os_route_listener;
 struct os_route_str;
 struct os_route_key;
@@ -84,6 +85,9 @@ struct os_route_listener;
 #define RT_TABLE_UNSPEC 0
 #endif
 
+/*! maximum number of next hops of a multipath route */
+#define OS_ROUTE_MAX_MULTIPATH 8
+
 
 /**
  * Struct for text representation of a route
@@ -111,6 +115,10 @@ struct os_route_str {
     /* table, protocol */
     + 6 + 4 + 9 + 4 + 3 + IF_NAMESIZE + 2 + 10 +
     2
+    /* nexthop */
+    + 9 + 10
+    /* multipath */
+    + 11 + 10
     /* footer and 0-byte */
     + 2];
 };
@@ -170,6 +178,20 @@ struct os_route_key {
   struct netaddr src;
 };
 
+/**
+ * one next hop of a multipath route
+ */
+struct os_route_path {
+  /*! gateway of the next hop */
+  struct netaddr gw;
+
+  /*! index of outgoing interface */
+  unsigned int if_index;
+
+  /*! relative weight of the next hop (1-256) */
+  uint16_t weight;
+};
+
 struct os_route_parameter {
   /*! address family */
   unsigned char family;
@@ -197,6 +219,15 @@ struct os_route_parameter {
 
   /*! index of outgoing interface */
   unsigned int if_index;
+
+  /*! id of kernel nexthop object that replaces gateway and interface, 0 if not used */
+  uint32_t nexthop_id;
+
+  /*! number of next hops of a multipath route, gateway and interface are ignored if 2 or more */
+  unsigned int multipath_count;
+
+  /*! next hops of a multipath route */
+  struct os_route_path multipath[OS_ROUTE_MAX_MULTIPATH];
 };
 
 /**
@@ -226,6 +257,37 @@ struct os_route {
   void (*cb_get)(struct os_route *filter, struct os_route *route);
 };
 
+/**
+ * Handler for a kernel nexthop object that can be shared
+ * between many routes
+ */
+struct os_route_nexthop {
+  /*! kernel id of the nexthop object, 0 if not allocated */
+  uint32_t id;
+
+  /*! address family */
+  unsigned char family;
+
+  /*! gateway of the nexthop */
+  struct netaddr gw;
+
+  /*! routing protocol */
+  unsigned char protocol;
+
+  /*! index of outgoing interface */
+  unsigned int if_index;
+
+  /*! used for delivering feedback about netlink commands */
+  struct os_route_nexthop_internal _internal;
+
+  /**
+   * Callback triggered when the nexthop has been set or removed
+   * @param nexthop this nexthop object
+   * @param error -1 if an error happened, 0 otherwise
+   */
+  void (*cb_finished)(struct os_route_nexthop *nexthop, int error);
+};
+
 /**
  * Listener for kernel route changes
  */
@@ -249,6 +311,10 @@ static INLINE int os_routing_query(struct os_route *);
 static INLINE void os_routing_interrupt(struct os_route *);
 static INLINE bool os_routing_is_in_progress(struct os_route *);
 
+static INLINE bool os_routing_supports_nexthop_objects(void);
+static INLINE int os_routing_nexthop_set(struct os_route_nexthop *, bool set);
+static INLINE void os_routing_nexthop_interrupt(struct os_route_nexthop *);
+
 static INLINE void os_routing_listener_add(struct os_route_listener *);
 static INLINE void os_routing_listener_remove(struct os_route_listener *);
 
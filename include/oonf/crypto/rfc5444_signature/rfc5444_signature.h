@@ -0,0 +1,170 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef RFC5444_SIGNATURE_H_
+#define RFC5444_SIGNATURE_H_
+
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/oonf.h>
+#include <oonf/crypto/rfc7182_provider/rfc7182_provider.h>
+#include <oonf/librfc5444/rfc5444_writer.h>
+
+/*! subsystem identifier */
+#define OONF_RFC5444_SIG_SUBSYSTEM "rfc5444_sig"
+
+/**
+ * Result of the key-id check of a signature
+ */
+enum rfc5444_sigid_check
+{
+  /*! key-id is okay, check signature */
+  RFC5444_SIGID_OKAY,
+
+  /*! ignore this signature TLV */
+  RFC5444_SIGID_IGNORE,
+
+  /*! drop message/packet */
+  RFC5444_SIGID_DROP,
+};
+
+/**
+ * Key of a signature definition
+ */
+struct rfc5444_signature_key {
+  /*! RFC7182 hash function id */
+  uint8_t hash_function;
+
+  /*! RFC7182 crypto function id */
+  uint8_t crypt_function;
+};
+
+/**
+ * Definition of a rfc5444 signature
+ */
+struct rfc5444_signature {
+  /*! hash and crypto function of signature */
+  struct rfc5444_signature_key key;
+
+  /*! true if the source IP address is part of the signature */
+  bool source_specific;
+
+  /*! true if messages/packets without a valid signature should be dropped */
+  bool drop_if_invalid;
+
+  /**
+   * Check if this signature applies to a message type
+   * @param sig this signature
+   * @param msg_type message type, RFC5444_WRITER_PKT_POSTPROCESSOR for packets
+   * @return true if signature applies to the message type
+   */
+  bool (*is_matching_signature)(struct rfc5444_signature *sig, int msg_type);
+
+  /**
+   * Check the key-id of an incoming signature (optional)
+   * @param sig this signature
+   * @param id pointer to key-id
+   * @param len length of key-id
+   * @return okay, ignore or drop
+   */
+  enum rfc5444_sigid_check (*verify_id)(struct rfc5444_signature *sig, const void *id, size_t len);
+
+  /**
+   * Get the cryptographic key of the signature
+   * @param sig this signature
+   * @param len pointer to length of key, will be set by this function
+   * @return pointer to key
+   */
+  const void *(*getCryptoKey)(struct rfc5444_signature *sig, size_t *len);
+
+  /**
+   * Get the key-id of outgoing signatures (optional)
+   * @param sig this signature
+   * @param len pointer to length of key-id, will be set by this function
+   * @return pointer to key-id
+   */
+  const void *(*getKeyId)(struct rfc5444_signature *sig, size_t *len);
+
+  /*! hash function, NULL if not registered */
+  struct rfc7182_hash *hash;
+
+  /*! crypto function, NULL if not registered */
+  struct rfc7182_crypt *crypt;
+
+  /*! true if the signature of the current message/packet was valid */
+  bool verified;
+
+  /*! source address of the current message/packet */
+  const struct netaddr *source;
+
+  /*! true if the signature of the current message/packet must be valid */
+  bool _must_be_verified;
+
+  /*! postprocessor to add the signature to outgoing messages/packets */
+  struct rfc5444_writer_postprocessor _postprocessor;
+
+  /*! node for tree of signatures */
+  struct avl_node _node;
+};
+
+/**
+ * Statistics of incoming signature verifications
+ */
+struct rfc5444_sig_statistics {
+  /*! number of signatures checked with the crypto function */
+  uint32_t verifications;
+
+  /*! number of message signatures answered by the verification cache */
+  uint32_t cache_hits;
+
+  /*! number of signatures checked together with other messages of the same packet */
+  uint32_t batched;
+};
+
+EXPORT void rfc5444_sig_add(struct rfc5444_signature *sig);
+EXPORT void rfc5444_sig_remove(struct rfc5444_signature *sig);
+EXPORT const struct rfc5444_sig_statistics *rfc5444_sig_get_statistics(void);
+
+#endif /* RFC5444_SIGNATURE_H_ */
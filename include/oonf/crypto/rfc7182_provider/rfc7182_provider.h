@@ -0,0 +1,317 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef RFC7182_PROVIDER_H_
+#define RFC7182_PROVIDER_H_
+
+#include <oonf/libcommon/avl.h>
+#include <oonf/oonf.h>
+#include <oonf/librfc5444/rfc5444_iana.h>
+
+/*! subsystem identifier */
+#define OONF_RFC7182_PROVIDER_SUBSYSTEM "rfc7182_provider"
+
+/*! class name of rfc7182 hash functions */
+#define OONF_RFC7182_HASH_CLASS "rfc7182_hash"
+
+/*! class name of rfc7182 crypto functions */
+#define OONF_RFC7182_CRYPTO_CLASS "rfc7182_crypto"
+
+/*! maximum size of the state of an incremental hash or signature calculation */
+#define RFC7182_MAX_CONTEXT_SIZE 1024
+
+/**
+ * Continuous part of the data that should be hashed/signed
+ */
+struct rfc7182_segment {
+  /*! pointer to data */
+  const void *data;
+
+  /*! length of data */
+  size_t length;
+};
+
+/**
+ * Signature check that is part of a batch with the same key
+ */
+struct rfc7182_validation {
+  /*! pointer to encrypted signature */
+  const void *encrypted;
+
+  /*! length of encrypted signature */
+  size_t encrypted_length;
+
+  /*! segments of signed data */
+  const struct rfc7182_segment *segments;
+
+  /*! number of segments */
+  size_t segment_count;
+
+  /*! result of check, true if signature matches */
+  bool valid;
+};
+
+/**
+ * Definition of a hash function
+ */
+struct rfc7182_hash {
+  /*! hash type as defined by RFC7182 */
+  uint8_t type;
+
+  /**
+   * Calculate the hash of a memory block
+   * @param hash this hash definition
+   * @param dst output buffer for hash
+   * @param dst_len pointer to length of output buffer,
+   *   will be set to hash length afterwards
+   * @param src original data to hash
+   * @param src_len length of original data
+   * @return -1 if an error happened, 0 otherwise
+   */
+  int (*hash)(struct rfc7182_hash *hash, void *dst, size_t *dst_len, const void *src, size_t src_len);
+
+  /*! length of hash value in bytes */
+  size_t hash_length;
+
+  /**
+   * size of the state of an incremental hash calculation,
+   * must not be larger than RFC7182_MAX_CONTEXT_SIZE
+   */
+  size_t context_size;
+
+  /**
+   * Initialize an incremental hash calculation (optional)
+   * @param hash this hash definition
+   * @param ctx memory block of 'context_size' bytes for hash state
+   * @return -1 if an error happened, 0 otherwise
+   */
+  int (*init)(struct rfc7182_hash *hash, void *ctx);
+
+  /**
+   * Add data to an incremental hash calculation
+   * @param hash this hash definition
+   * @param ctx hash state
+   * @param src data to hash
+   * @param src_len length of data
+   * @return -1 if an error happened, 0 otherwise
+   */
+  int (*update)(struct rfc7182_hash *hash, void *ctx, const void *src, size_t src_len);
+
+  /**
+   * Finish an incremental hash calculation. Must be called after
+   * every successful init() call, even if an update() failed.
+   * @param hash this hash definition
+   * @param ctx hash state
+   * @param dst output buffer for hash, NULL to just release the hash state
+   * @param dst_len pointer to length of output buffer,
+   *   will be set to hash length afterwards
+   * @return -1 if an error happened, 0 otherwise
+   */
+  int (*final)(struct rfc7182_hash *hash, void *ctx, void *dst, size_t *dst_len);
+
+  /*! node for tree of hash functions */
+  struct avl_node _node;
+};
+
+/**
+ * Definition of a cryptographic function
+ */
+struct rfc7182_crypt {
+  /*! crypto type as defined by RFC7182 */
+  uint8_t type;
+
+  /**
+   * Check a signature (optional)
+   * @param crypt this crypto definition
+   * @param hash the definition of the hash
+   * @param encrypted pointer to encrypted signature
+   * @param encrypted_length length of encrypted signature
+   * @param src unsigned original data
+   * @param src_len length of original data
+   * @param key key material for signature
+   * @param key_len length of key material
+   * @return true if signature matches, false otherwise
+   */
+  bool (*validate)(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, const void *encrypted,
+    size_t encrypted_length, const void *src, size_t src_len, const void *key, size_t key_len);
+
+  /**
+   * Generate a signature (optional)
+   * @param crypt this crypto definition
+   * @param hash the definition of the hash
+   * @param dst output buffer for cryptographic signature
+   * @param dst_len pointer to length of output buffer, will be set to
+   *   length of signature afterwards
+   * @param src unsigned original data
+   * @param src_len length of original data
+   * @param key key material for signature
+   * @param key_len length of key material
+   * @return -1 if an error happened, 0 otherwise
+   */
+  int (*sign)(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, void *dst, size_t *dst_len, const void *src,
+    size_t src_len, const void *key, size_t key_len);
+
+  /**
+   * Encrypt a hash value, used by the default sign() function
+   * @param crypt this crypto definition
+   * @param dst output buffer for encrypted data
+   * @param dst_len pointer to length of output buffer, will be set to
+   *   length of encrypted data afterwards
+   * @param src hash value
+   * @param src_len length of hash value
+   * @param key key material for signature
+   * @param key_len length of key material
+   * @return -1 if an error happened, 0 otherwise
+   */
+  int (*encrypt)(struct rfc7182_crypt *crypt, void *dst, size_t *dst_len, const void *src, size_t src_len,
+    const void *key, size_t key_len);
+
+  /**
+   * @param crypt this crypto definition
+   * @param hash the definition of the hash
+   * @return maximum length of a signature
+   */
+  size_t (*getSignSize)(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash);
+
+  /**
+   * size of the state of an incremental signature calculation,
+   * must not be larger than RFC7182_MAX_CONTEXT_SIZE
+   */
+  size_t context_size;
+
+  /**
+   * Initialize an incremental signature calculation (optional).
+   * Without this callback signatures are calculated by an incremental
+   * hash followed by the encrypt() callback.
+   * @param crypt this crypto definition
+   * @param hash the definition of the hash
+   * @param ctx memory block of 'context_size' bytes for signature state
+   * @param key key material for signature
+   * @param key_len length of key material
+   * @return -1 if an error happened, 0 otherwise
+   */
+  int (*sign_init)(
+    struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, void *ctx, const void *key, size_t key_len);
+
+  /**
+   * Add data to an incremental signature calculation
+   * @param crypt this crypto definition
+   * @param ctx signature state
+   * @param src data to sign
+   * @param src_len length of data
+   * @return -1 if an error happened, 0 otherwise
+   */
+  int (*sign_update)(struct rfc7182_crypt *crypt, void *ctx, const void *src, size_t src_len);
+
+  /**
+   * Finish an incremental signature calculation. Must be called after
+   * every successful sign_init() call, even if a sign_update() failed.
+   * @param crypt this crypto definition
+   * @param ctx signature state
+   * @param dst output buffer for signature, NULL to just release the state
+   * @param dst_len pointer to length of output buffer, will be set to
+   *   length of signature afterwards
+   * @return -1 if an error happened, 0 otherwise
+   */
+  int (*sign_final)(struct rfc7182_crypt *crypt, void *ctx, void *dst, size_t *dst_len);
+
+  /**
+   * Check multiple signatures that use the same key (optional).
+   * Without this callback every signature is checked on its own.
+   * @param crypt this crypto definition
+   * @param hash the definition of the hash
+   * @param validations array of signatures and signed data,
+   *   the callback sets the 'valid' field of each element
+   * @param count number of validations
+   * @param key key material for signature
+   * @param key_len length of key material
+   */
+  void (*validate_batch)(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash,
+    struct rfc7182_validation *validations, size_t count, const void *key, size_t key_len);
+
+  /*! node for tree of crypto functions */
+  struct avl_node _node;
+};
+
+EXPORT void rfc7182_add_hash(struct rfc7182_hash *hash);
+EXPORT void rfc7182_remove_hash(struct rfc7182_hash *hash);
+
+EXPORT void rfc7182_add_crypt(struct rfc7182_crypt *crypt);
+EXPORT void rfc7182_remove_crypt(struct rfc7182_crypt *crypt);
+
+EXPORT struct avl_tree *rfc7182_get_hash_tree(void);
+EXPORT struct avl_tree *rfc7182_get_crypt_tree(void);
+
+EXPORT int rfc7182_sign_segments(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, void *dst, size_t *dst_len,
+  const struct rfc7182_segment *segments, size_t segment_count, const void *key, size_t key_len);
+EXPORT bool rfc7182_validate_segments(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, const void *encrypted,
+  size_t encrypted_length, const struct rfc7182_segment *segments, size_t segment_count, const void *key,
+  size_t key_len);
+EXPORT void rfc7182_validate_batch(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash,
+  struct rfc7182_validation *validations, size_t count, const void *key, size_t key_len);
+
+/**
+ * @param type RFC7182 hash type
+ * @return hash definition, NULL if not registered
+ */
+static INLINE struct rfc7182_hash *
+rfc7182_get_hash(uint8_t type) {
+  struct rfc7182_hash *hash;
+
+  return avl_find_element(rfc7182_get_hash_tree(), &type, hash, _node);
+}
+
+/**
+ * @param type RFC7182 crypto type
+ * @return crypto definition, NULL if not registered
+ */
+static INLINE struct rfc7182_crypt *
+rfc7182_get_crypt(uint8_t type) {
+  struct rfc7182_crypt *crypt;
+
+  return avl_find_element(rfc7182_get_crypt_tree(), &type, crypt, _node);
+}
+
+#endif /* RFC7182_PROVIDER_H_ */
@@ -97,6 +97,15 @@ enum dlep_parser_error
   DLEP_NEW_PARSER_INTERNAL_ERROR = -9,
 };
 
+enum
+{
+  /*! number of TLV types in a page of the TLV lookup table */
+  DLEP_PARSER_TLV_PAGE_SIZE = 256,
+
+  /*! number of pages of the TLV lookup table */
+  DLEP_PARSER_TLV_PAGES = 65536 / DLEP_PARSER_TLV_PAGE_SIZE,
+};
+
 /**
  * Definition of a TLV that has been parsed by DLEP
  */
@@ -110,6 +119,9 @@ struct dlep_parser_tlv {
   /*! index of last session value for tlv, -1 if none */
   int32_t tlv_last;
 
+  /*! parser generation tlv_first/tlv_last belong to */
+  uint32_t _generation;
+
   /*! minimal length of tlv */
   uint16_t length_min;
 
@@ -144,6 +156,12 @@ struct dlep_session_parser {
   /*! tree of allowed TLVs for this session */
   struct avl_tree allowed_tlvs;
 
+  /*! lookup table of allowed TLVs, indexed by the high and low byte of the TLV type */
+  struct dlep_parser_tlv **tlv_table[DLEP_PARSER_TLV_PAGES];
+
+  /*! generation of the last parsed signal */
+  uint32_t _generation;
+
   /*! array of TLV values */
   struct dlep_parser_value *values;
 
@@ -247,6 +265,9 @@ struct dlep_session_config {
   /*! heartbeat settings for our heartbeats */
   uint64_t heartbeat_interval;
 
+  /*! interval to aggregate destination updates, 0 to send them immediately */
+  uint64_t update_interval;
+
   /*! true if normal neighbors should be sent with DLEP */
   bool send_neighbors;
 
@@ -336,6 +357,15 @@ struct dlep_session {
   /*! rate of remote heartbeats */
   uint64_t remote_heartbeat_interval;
 
+  /*! timer to send aggregated destination updates */
+  struct oonf_timer_instance update_timer;
+
+  /*! number of destination updates sent */
+  uint32_t updates_sent;
+
+  /*! number of destination updates merged into an already pending update */
+  uint32_t updates_suppressed;
+
   /*! local endpoint of current communication */
   union netaddr_socket local_socket;
 
@@ -392,8 +422,21 @@ struct oonf_layer2_neigh *dlep_session_get_l2_from_neighbor(struct dlep_local_ne
  */
 static INLINE struct dlep_parser_tlv *
 dlep_parser_get_tlv(struct dlep_session_parser *parser, uint16_t tlvtype) {
-  struct dlep_parser_tlv *tlv;
-  return avl_find_element(&parser->allowed_tlvs, &tlvtype, tlv, _node);
+  struct dlep_parser_tlv **page;
+
+  page = parser->tlv_table[tlvtype / DLEP_PARSER_TLV_PAGE_SIZE];
+  return page ? page[tlvtype % DLEP_PARSER_TLV_PAGE_SIZE] : NULL;
+}
+
+/**
+ * Check if a TLV was part of the last parsed signal
+ * @param parser dlep session parser
+ * @param tlv dlep session tlv
+ * @return true if signal contained the TLV
+ */
+static INLINE bool
+dlep_parser_has_tlv_value(struct dlep_session_parser *parser, struct dlep_parser_tlv *tlv) {
+  return tlv->_generation == parser->_generation && tlv->tlv_first != -1;
 }
 
 /**
@@ -404,7 +447,7 @@ dlep_parser_get_tlv(struct dlep_session_parser *parser, uint16_t tlvtype) {
  */
 static INLINE struct dlep_parser_value *
 dlep_session_get_tlv_first_value(struct dlep_session *session, struct dlep_parser_tlv *tlv) {
-  if (tlv->tlv_first == -1) {
+  if (!dlep_parser_has_tlv_value(&session->parser, tlv)) {
     return NULL;
   }
   return &session->parser.values[tlv->tlv_first];
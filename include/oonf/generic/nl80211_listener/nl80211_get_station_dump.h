@@ -51,5 +51,7 @@
 void nl80211_send_get_station_dump(
   struct os_system_netlink_message *nl_msg, struct genlmsghdr *hdr, struct nl80211_if *interf);
 void nl80211_process_get_station_dump_result(struct nl80211_if *interf, struct nlmsghdr *);
+void nl80211_process_new_station_event(struct nl80211_if *interf, struct nlmsghdr *);
+void nl80211_process_del_station_event(struct nl80211_if *interf, struct nlmsghdr *);
 
 #endif /* NL80211_GET_STATION_DUMP_H_ */
@@ -50,10 +50,14 @@
 #include <oonf/libcore/oonf_subsystem.h>
 #include <oonf/base/oonf_layer2.h>
 #include <oonf/base/os_interface.h>
+#include <oonf/base/os_system.h>
 
 /*! subsystem identifier */
 #define OONF_NL80211_LISTENER_SUBSYSTEM "nl80211_listener"
 
+/*! size of the buffer for outgoing netlink queries of a nl80211 interface */
+#define NL80211_IF_QUERY_BUFFER_SIZE 1024
+
 /**
  * Session data of an interface where the listener is probing
  */
@@ -79,6 +83,9 @@ struct nl80211_if {
   /*! true if data of interface were changed */
   bool ifdata_changed;
 
+  /*! true if data of a neighbor on this interface was changed by a station dump */
+  bool neighdata_changed;
+
   /*! true if interface should be removed */
   bool _remove;
 
@@ -88,6 +95,27 @@ struct nl80211_if {
   /*! true if nl80211 section config was already committed for interface */
   bool _nl80211_section;
 
+  /*! netlink message used for the queries of this interface */
+  struct os_system_netlink_message _nl_msg;
+
+  /*! buffer for outgoing netlink query */
+  uint32_t _nl_msgbuffer[NL80211_IF_QUERY_BUFFER_SIZE / sizeof(uint32_t)];
+
+  /*! index of the currently running query of this interface */
+  int _query;
+
+  /*! true if a series of queries is running for this interface */
+  bool _query_in_progress;
+
+  /*! true if the running series of queries includes a full station dump */
+  bool _station_dump;
+
+  /*! absolute timestamp when the next full station dump is due */
+  uint64_t _next_station_dump;
+
+  /*! adaptive schedule for the queries of this interface */
+  struct oonf_layer2_poll _poll;
+
   /*! hook into tree of nl80211 interfaces */
   struct avl_node _node;
 };
@@ -98,6 +126,7 @@ bool nl80211_change_l2net_data(struct oonf_layer2_net *l2net, enum oonf_layer2_n
 bool nl80211_change_l2net_neighbor_default(
   struct oonf_layer2_net *l2net, enum oonf_layer2_neighbor_index idx, int64_t value, int64_t scaling);
 void nl80211_cleanup_l2neigh_data(struct oonf_layer2_neigh *l2neigh);
+void nl80211_remove_l2neigh(struct oonf_layer2_neigh *l2neigh);
 bool nl80211_change_l2neigh_data(
   struct oonf_layer2_neigh *l2neigh, enum oonf_layer2_neighbor_index idx, int64_t value, int64_t scaling);
 bool nl80211_create_broadcast_neighbor(void);
@@ -68,6 +68,7 @@ EXPORT void json_start_object(struct json_session *, const char *name);
 EXPORT void json_end_object(struct json_session *);
 EXPORT void json_print_templates(struct json_session *, struct abuf_template_data *data, size_t count);
 EXPORT void json_print(struct json_session *session, const char *key, bool string, const char *value);
+EXPORT void json_print_raw(struct json_session *session, const void *fragment, size_t length);
 
 /**
  * Returns the JSON text representation of a boolean
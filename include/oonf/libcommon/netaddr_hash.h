@@ -0,0 +1,131 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef _NETADDR_HASH_H
+#define _NETADDR_HASH_H
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/container_of.h>
+#include <oonf/libcommon/netaddr.h>
+
+/**
+ * This element is a member of a netaddr hash table. It must be contained
+ * in all larger structs that should be put into a hash table.
+ */
+struct netaddr_hash_node {
+  /**
+   * object the key is unique for (e.g. the owner of a sub-database),
+   * NULL for global keys
+   */
+  const void *scope;
+
+  /**
+   * pointer to key of node, an array of key_count netaddr objects
+   */
+  const struct netaddr *key;
+
+  /**
+   * cached hash value of scope and key
+   */
+  uint32_t _hash;
+};
+
+/**
+ * Hash table with open addressing for netaddr keys. The table only
+ * stores pointers to the nodes, the nodes are part of the elements.
+ */
+struct netaddr_hash {
+  /**
+   * array of slots, NULL for an unused slot
+   */
+  struct netaddr_hash_node **_slots;
+
+  /**
+   * number of slots, always a power of two
+   */
+  uint32_t _size;
+
+  /**
+   * number of nodes in the hash table
+   */
+  uint32_t count;
+
+  /**
+   * number of consecutive netaddr objects that form a key
+   */
+  uint32_t key_count;
+};
+
+EXPORT void netaddr_hash_init(struct netaddr_hash *hash, uint32_t key_count);
+EXPORT void netaddr_hash_cleanup(struct netaddr_hash *hash);
+EXPORT int netaddr_hash_add(struct netaddr_hash *hash, struct netaddr_hash_node *node);
+EXPORT void netaddr_hash_remove(struct netaddr_hash *hash, struct netaddr_hash_node *node);
+EXPORT struct netaddr_hash_node *netaddr_hash_find(
+  const struct netaddr_hash *hash, const void *scope, const struct netaddr *key);
+
+/**
+ * @param hash pointer to netaddr hash table
+ * @param scope object the key is unique for, NULL for global keys
+ * @param key pointer to key
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_element name of the netaddr_hash_node element inside the
+ *    larger struct
+ * @return pointer to hash table element with the specified key,
+ *    NULL if no element was found
+ */
+#define netaddr_hash_find_element(hash, scope, key, element, node_element)                                             \
+  container_of_if_notnull(netaddr_hash_find(hash, scope, key), typeof(*(element)), node_element)
+
+/**
+ * @param hash pointer to netaddr hash table
+ * @return true if hash table is empty, false otherwise
+ */
+static INLINE bool
+netaddr_hash_is_empty(const struct netaddr_hash *hash) {
+  return hash->count == 0;
+}
+
+#endif /* _NETADDR_HASH_H */
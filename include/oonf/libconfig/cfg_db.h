@@ -180,6 +180,10 @@ EXPORT const struct const_strarray *cfg_db_get_schema_entry_value(
 EXPORT int cfg_db_remove_element(
   struct cfg_db *, const char *section_type, const char *section_name, const char *entry_name, const char *value);
 
+EXPORT bool cfg_db_is_namedsection_equal(
+  const struct cfg_named_section *named1, const struct cfg_named_section *named2);
+EXPORT bool cfg_db_is_sectiontype_equal(const struct cfg_section_type *type1, const struct cfg_section_type *type2);
+
 /**
  * Link a configuration schema to a database
  * @param db pointer to database
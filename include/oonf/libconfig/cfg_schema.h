@@ -1408,6 +1408,25 @@ cfg_schema_find_section(struct cfg_schema *schema, const char *type) {
   return avl_find_element(&schema->sections, type, section, _section_node);
 }
 
+/**
+ * Check if one of a list of schema entries changed during the
+ * current delta handler call
+ * @param entries pointer to first schema entry
+ * @param count number of schema entries
+ * @return true if at least one entry changed, false otherwise
+ */
+static INLINE bool
+cfg_schema_is_delta_changed(const struct cfg_schema_entry *entries, size_t count) {
+  size_t i;
+
+  for (i = 0; i < count; i++) {
+    if (entries[i].delta_changed) {
+      return true;
+    }
+  }
+  return false;
+}
+
 /**
  * Finds an entry in a schema section
  * @param section pointer to section
@@ -118,6 +118,63 @@ struct oonf_log_parameters {
   int prefixLength;
 };
 
+/*! state of a single logging call site */
+enum oonf_log_callsite_state
+{
+  /*! call site follows the logging mask of its source */
+  OONF_LOG_CALLSITE_DEFAULT = 0,
+
+  /*! call site is always active */
+  OONF_LOG_CALLSITE_ON,
+
+  /*! call site is never active */
+  OONF_LOG_CALLSITE_OFF,
+};
+
+/**
+ * Static descriptor of a logging macro call site. All descriptors of
+ * a binary are collected in the "oonf_log_callsites" linker section.
+ */
+struct oonf_log_callsite {
+  /*! file of the call site */
+  const char *file;
+
+  /*! format string of the call site */
+  const char *format;
+
+  /*! line number of the call site */
+  int line;
+
+  /*! severity of the call site */
+  enum oonf_log_severity severity;
+
+  /*! runtime state of the call site, see enum oonf_log_callsite_state */
+  uint8_t state;
+};
+
+/**
+ * Call site descriptors of a single binary (executable or shared object)
+ */
+struct oonf_log_callsite_section {
+  /*! first call site descriptor */
+  struct oonf_log_callsite *start;
+
+  /*! end of call site descriptors */
+  struct oonf_log_callsite *stop;
+
+  /*! hook into list of call site sections */
+  struct list_entity _node;
+};
+
+/* boundaries of the call site section of the current binary, generated by the linker */
+extern struct oonf_log_callsite __start_oonf_log_callsites[] __attribute__((weak, visibility("hidden")));
+extern struct oonf_log_callsite __stop_oonf_log_callsites[] __attribute__((weak, visibility("hidden")));
+
+/**
+ * Initializer for the call site section of the current binary
+ */
+#define OONF_LOG_CALLSITE_SECTION { .start = __start_oonf_log_callsites, .stop = __stop_oonf_log_callsites }
+
 /*
  * macros to check which logging levels are active
  *
@@ -171,8 +228,12 @@ struct oonf_log_parameters {
  */
 #define _OONF_LOG(severity, source, hexptr, hexlen, condition, fail, format, args...)                                  \
   do {                                                                                                                 \
-    if ((condition) && oonf_log_mask_test(log_global_mask, source, severity)) {                                        \
-      oonf_log(severity, source, &__FILE__[BASEPATH_LENGTH], __LINE__, hexptr, hexlen, format, ##args);                \
+    static struct oonf_log_callsite _oonf_log_site                                                                     \
+      __attribute__((section("oonf_log_callsites"), aligned(sizeof(void *)), used)) = {                                \
+        &__FILE__[BASEPATH_LENGTH], format, __LINE__, severity, OONF_LOG_CALLSITE_DEFAULT                              \
+      };                                                                                                               \
+    if ((condition) && __builtin_expect(oonf_log_callsite_test(&_oonf_log_site, source), 0)) {                         \
+      oonf_log_callsite(&_oonf_log_site, source, hexptr, hexlen, format, ##args);                                      \
       if (OONF_DO_ABORT && (fail)) { abort(); }                                                                        \
     }                                                                                                                  \
   } while (0)
@@ -366,6 +427,12 @@ struct oonf_log_handler_entry {
 
   /*! custom data for user */
   void *custom;
+
+  /**
+   * true if the handler can be called by the asynchronous logging
+   * thread, all other handlers are called by the scheduler thread
+   */
+  bool thread_safe;
 };
 
 /**
@@ -376,6 +443,16 @@ struct oonf_walltime_str {
   char buf[14];
 };
 
+/*! size limits of the asynchronous logging ring buffer in bytes */
+enum
+{
+  /*! default size of ring buffer */
+  OONF_LOG_ASYNC_DEFAULT_SIZE = 256 * 1024,
+
+  /*! minimum size of ring buffer */
+  OONF_LOG_ASYNC_MIN_SIZE = 16 * 1024,
+};
+
 /**
  * Macro to iterate over all logging severities
  * This macro should be used similar to a for() or while() construct
@@ -411,6 +488,19 @@ EXPORT const char *oonf_log_get_walltime(struct oonf_walltime_str *);
 EXPORT void oonf_log(enum oonf_log_severity, enum oonf_log_source, const char *, int, const void *, size_t,
   const char *, ...) __attribute__((format(printf, 7, 8)));
 
+EXPORT void oonf_log_callsite(const struct oonf_log_callsite *, enum oonf_log_source, const void *, size_t,
+  const char *, ...) __attribute__((format(printf, 5, 6)));
+EXPORT void oonf_log_register_callsites(struct oonf_log_callsite_section *);
+EXPORT void oonf_log_unregister_callsites(struct oonf_log_callsite_section *);
+EXPORT struct list_entity *oonf_log_get_callsite_sections(void);
+
+EXPORT int oonf_log_async_start(size_t buffer_size);
+EXPORT void oonf_log_async_stop(void);
+EXPORT void oonf_log_async_suspend(void);
+EXPORT void oonf_log_async_resume(void);
+EXPORT bool oonf_log_is_async(void);
+EXPORT uint64_t oonf_log_get_async_dropped(void);
+
 EXPORT void oonf_log_stderr(struct oonf_log_handler_entry *, struct oonf_log_parameters *);
 EXPORT void oonf_log_syslog(struct oonf_log_handler_entry *, struct oonf_log_parameters *);
 EXPORT void oonf_log_file(struct oonf_log_handler_entry *, struct oonf_log_parameters *);
@@ -468,4 +558,27 @@ oonf_log_mask_test(uint8_t *mask, enum oonf_log_source src, enum oonf_log_severi
   return (mask[src] & sev) != 0;
 }
 
+/**
+ * Test if a logging call site should produce output
+ * @param site logging call site
+ * @param src logging source
+ * @return true if call site is active, false otherwise
+ */
+static INLINE bool
+oonf_log_callsite_test(const struct oonf_log_callsite *site, enum oonf_log_source src) {
+  if (__builtin_expect(site->state == OONF_LOG_CALLSITE_DEFAULT, 1)) {
+    return oonf_log_mask_test(log_global_mask, src, site->severity);
+  }
+  return site->state == OONF_LOG_CALLSITE_ON;
+}
+
+/**
+ * Iterate over all logging call sites
+ * @param section iterator for call site section
+ * @param site iterator for call site
+ */
+#define OONF_FOR_ALL_LOGCALLSITES(section, site)                                                                      \
+  list_for_each_element(oonf_log_get_callsite_sections(), section, _node)                                             \
+    for (site = (section)->start; site < (section)->stop; site++)
+
 #endif /* OONF_LOGGING_H_ */
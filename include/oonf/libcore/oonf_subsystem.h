@@ -60,13 +60,20 @@
 
 /**
  * @def DECLARE_OONF_PLUGIN
- * Declaration of a subsystem. Creates a constructor that hooks the subsystem into the core.
+ * Declaration of a subsystem. Creates a constructor that hooks the subsystem and the
+ * logging call sites of its binary into the core.
  * @param subsystem pointer to subsystem definition
  */
 #define DECLARE_OONF_PLUGIN(subsystem)                                                                                 \
+  static struct oonf_log_callsite_section _callsites_##subsystem = OONF_LOG_CALLSITE_SECTION;                         \
   EXPORT void hookup_subsystem_##subsystem(void) __attribute__((constructor));                                         \
   void hookup_subsystem_##subsystem(void) {                                                                            \
+    oonf_log_register_callsites(&_callsites_##subsystem);                                                              \
     oonf_subsystem_hook(&subsystem);                                                                                   \
+  }                                                                                                                    \
+  EXPORT void unhook_subsystem_##subsystem(void) __attribute__((destructor));                                          \
+  void unhook_subsystem_##subsystem(void) {                                                                            \
+    oonf_log_unregister_callsites(&_callsites_##subsystem);                                                            \
   }
 
 /**
@@ -186,6 +186,22 @@ enum rfc7181_cont_seq_num_ext
   RFC7181_CONT_SEQ_NUM_BITMASK = 1,
 };
 
+/**
+ * TLVs and extension flags for differential TCs
+ */
+enum draft_olsrv2_differential_tc_iana
+{
+  /*! TC only contains the changes since the last complete TC, always set together with INCOMPLETE */
+  DRAFT_DIFF_TC_CONT_SEQ_NUM_DIFFERENTIAL = 2,
+
+  /*!
+   * HELLO: originator can process differential TCs,
+   * TC: originator and all its symmetric neighbors can process differential TCs
+   */
+  DRAFT_DIFF_TC_MSGTLV_CAPABILITY = RFC7181_MSGTLV_MPR_WILLING,
+  DRAFT_DIFF_TC_MSGTLV_CAPABILITY_EXT = 3,
+};
+
 /**
  * generic address TLV defined by IANA in RFC5497 (timetlv)
  */
@@ -250,7 +250,16 @@ struct nhdp_domain {
   /*! index in the domain array */
   int index;
 
-  /*! true if MPR should be recalculated */
+  /*! number of times a MPR recalculation was requested */
+  uint32_t mpr_requested;
+
+  /*! number of times the MPR set has been calculated */
+  uint32_t mpr_calculated;
+
+  /*! true if a MPR recalculation has been requested */
+  bool _mpr_requested;
+
+  /*! true if the MPR input changed and MPR should be recalculated */
   bool _mpr_outdated;
 
   /*! temporary storage for willingness processing */
@@ -346,6 +355,7 @@ EXPORT enum nhdp_metric_result nhdp_domain_get_metric(struct nhdp_domain *domain
 
 EXPORT bool nhdp_domain_node_is_mpr(void);
 EXPORT void nhdp_domain_delayed_mpr_recalculation(struct nhdp_domain *domain, struct nhdp_neighbor *neigh);
+EXPORT void nhdp_domain_request_mpr_recalculation(void);
 EXPORT void nhdp_domain_recalculate_mpr(void);
 
 EXPORT struct list_entity *nhdp_domain_get_list(void);
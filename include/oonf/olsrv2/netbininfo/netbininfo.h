@@ -0,0 +1,161 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Binary topology snapshot of the netbininfo plugin.
+ *
+ * All numbers are in network byte order. A snapshot starts with
+ * a 16 byte header:
+ *
+ *   uint8_t  schema version (NETBININFO_SCHEMA_VERSION)
+ *   uint8_t  snapshot flags (enum netbininfo_snapshot_flags)
+ *   uint16_t reserved, always 0
+ *   uint32_t instance id, changes with each restart of the router
+ *   uint32_t generation of the snapshot
+ *   uint32_t base generation of a delta snapshot, 0 for full snapshot
+ *
+ * followed by a sequence of records:
+ *
+ *   uint8_t  record type (enum netbininfo_record_type)
+ *   uint8_t  record flags (enum netbininfo_record_flags)
+ *   uint16_t length of record value
+ *   value    key of the record followed by its data
+ *
+ * A delta snapshot is requested with the instance id and generation
+ * of an earlier snapshot ("netbininfo delta <instance id> <generation>").
+ * If the instance id does not match (the router restarted) or the
+ * delta cannot be generated completely, a full snapshot is returned.
+ *
+ * A removed record only contains the key. Addresses are encoded as
+ * family (enum netbininfo_addr_family), prefix length and the
+ * address bytes (0, 4, 6 or 16 bytes depending on the family).
+ */
+
+#ifndef NETBININFO_H_
+#define NETBININFO_H_
+
+/*! subsystem identifier */
+#define OONF_NETBININFO_SUBSYSTEM "netbininfo"
+
+enum
+{
+  /*! version of the binary snapshot format */
+  NETBININFO_SCHEMA_VERSION = 1,
+
+  /*! length of the snapshot header */
+  NETBININFO_HEADER_LENGTH = 16,
+};
+
+/**
+ * Flags of a binary snapshot
+ */
+enum netbininfo_snapshot_flags
+{
+  /*! snapshot only contains records changed after the base generation */
+  NETBININFO_SNAPSHOT_DELTA = 1 << 0,
+};
+
+/**
+ * Flags of a snapshot record
+ */
+enum netbininfo_record_flags
+{
+  /*! record has been removed, value only contains the key */
+  NETBININFO_RECORD_REMOVED = 1 << 0,
+};
+
+/**
+ * Address family of an encoded address
+ */
+enum netbininfo_addr_family
+{
+  /*! unspecified address, no address bytes */
+  NETBININFO_AF_UNSPEC = 0,
+
+  /*! IPv4 address, 4 address bytes */
+  NETBININFO_AF_IPV4 = 4,
+
+  /*! IPv6 address, 16 address bytes */
+  NETBININFO_AF_IPV6 = 6,
+
+  /*! MAC48 address, 6 address bytes */
+  NETBININFO_AF_MAC48 = 48,
+};
+
+/**
+ * Types of snapshot records, the comment lists key | data of each record.
+ * A domain list is a count byte followed by the per-domain entries.
+ */
+enum netbininfo_record_type
+{
+  /*! originator | ANSN (16 bit), flags (8 bit, bit 0 = virtual node) */
+  NETBININFO_RECORD_NODE = 1,
+
+  /**
+   * originator, neighbor originator |
+   * domain list of ext (8 bit), cost (32 bit), inverse cost (32 bit)
+   */
+  NETBININFO_RECORD_EDGE = 2,
+
+  /**
+   * originator, destination prefix, source prefix |
+   * domain list of ext (8 bit), cost (32 bit), distance (8 bit)
+   */
+  NETBININFO_RECORD_ATTACHED = 3,
+
+  /**
+   * domain ext (8 bit), destination prefix, source prefix |
+   * gateway, interface index (32 bit), originator, next hop originator,
+   * last hop originator, path cost (32 bit), hop count (8 bit)
+   */
+  NETBININFO_RECORD_ROUTE = 4,
+
+  /**
+   * interface index (32 bit), neighbor originator, remote MAC |
+   * link status (8 bit, signed), domain list of ext (8 bit),
+   * incoming metric (32 bit), outgoing metric (32 bit)
+   */
+  NETBININFO_RECORD_NHDP_LINK = 5,
+};
+
+#endif /* NETBININFO_H_ */
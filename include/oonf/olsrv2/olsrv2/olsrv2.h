@@ -71,6 +71,30 @@
 /*! default IPv6 originator addresses */
 #define OLSRV2_ORIGINATOR_IPV6 "-::1\0-ff00::/8\0"
 
+/*! maximum number of fisheye TC scopes */
+#define OLSRV2_FISHEYE_MAX_SCOPES 8
+
+/**
+ * One scope of the fisheye TC schedule. TCs of a scope are flooded
+ * up to its hop limit every 'multiplier' TC intervals.
+ */
+struct olsrv2_fisheye_scope {
+  /*! hop limit of the TCs of this scope */
+  int32_t hop_limit;
+
+  /*! TCs of this scope are generated every n-th TC interval */
+  int32_t multiplier;
+
+  /*! number of TCs generated with this scope */
+  uint32_t tc_sent;
+
+  /*! number of differential TCs generated with this scope */
+  uint32_t differential_tc_sent;
+
+  /*! number of received TCs with a hop limit within this scope */
+  uint32_t tc_received;
+};
+
 EXPORT uint64_t olsrv2_get_tc_interval(void);
 EXPORT uint64_t olsrv2_get_tc_validity(void);
 EXPORT bool olsrv2_is_nhdp_routable(struct netaddr *addr);
@@ -81,6 +105,8 @@ EXPORT bool olsrv2_mpr_shall_forwarding(
 EXPORT void olsrv2_generate_tcs(bool);
 EXPORT uint64_t olsrv2_set_tc_interval(uint64_t new_interval);
 EXPORT uint64_t olsrv2_set_tc_validity(uint64_t new_interval);
+EXPORT const struct olsrv2_fisheye_scope *olsrv2_get_fisheye_scopes(size_t *count);
+EXPORT void olsrv2_fisheye_tc_received(int32_t hop_limit);
 
 /**
  * @return validity time of former originator IDs
@@ -51,5 +51,6 @@
 
 void olsrv2_reader_init(struct oonf_rfc5444_protocol *);
 void olsrv2_reader_cleanup(void);
+bool olsrv2_reader_neighbors_support_differential_tcs(void);
 
 #endif /* OLSRV2_READER_H_ */
@@ -57,10 +57,66 @@
 #include <oonf/nhdp/nhdp/nhdp_db.h>
 #include <oonf/nhdp/nhdp/nhdp_domain.h>
 
-/*! minimum time between two dijkstra calculations in milliseconds */
-enum
-{
-  OLSRv2_DIJKSTRA_RATE_LIMITATION = 1000
+/**
+ * memory class for routing set entries, the dijkstra only fires
+ * change events if the originator or last originator of an entry changed
+ */
+#define OLSRV2_CLASS_ROUTING_ENTRY "Olsrv2 Routing Set Entry"
+
+/*! memory class for kernel nexthop objects */
+#define OLSRV2_CLASS_ROUTING_NEXTHOP "Olsrv2 Routing Nexthop"
+
+/**
+ * parameters of the adaptive dijkstra throttling. After a quiet period
+ * a trigger runs the dijkstra after the initial delay, then the hold time
+ * between two runs doubles with every run until it reaches the maximum.
+ */
+struct olsrv2_routing_throttling {
+  /*! delay between the first trigger after a quiet period and the dijkstra run */
+  uint64_t initial_delay;
+
+  /*! hold time after the first dijkstra run of a series */
+  uint64_t hold_time;
+
+  /*! maximum hold time between two dijkstra runs */
+  uint64_t max_hold_time;
+
+  /*! time since the last dijkstra run that resets the hold time */
+  uint64_t quiet_period;
+};
+
+/**
+ * statistics of the dijkstra runs
+ */
+struct olsrv2_routing_statistics {
+  /*! number of dijkstra runs */
+  uint32_t runs;
+
+  /*! number of triggers that were delayed by the throttling */
+  uint32_t deferred;
+
+  /*! current hold time between two dijkstra runs */
+  uint64_t hold_time;
+
+  /*! duration of the last dijkstra run in nanoseconds */
+  uint64_t last_duration;
+
+  /*! duration of the longest dijkstra run in nanoseconds */
+  uint64_t max_duration;
+
+  /*! total duration of all dijkstra runs in nanoseconds */
+  uint64_t total_duration;
+};
+
+/**
+ * alternative loop-free path of a node in the dijkstra tree
+ */
+struct olsrv2_dijkstra_path {
+  /*! nhdp neighbor that represents the first hop of the path */
+  struct nhdp_neighbor *first_hop;
+
+  /*! total path cost */
+  uint32_t path_cost;
 };
 
 /**
@@ -85,6 +141,12 @@ struct olsrv2_dijkstra_node {
   /*! pointer to nhpd neighbor that represents the first hop */
   struct nhdp_neighbor *first_hop;
 
+  /*! alternative paths through other first hops, sorted by path cost */
+  struct olsrv2_dijkstra_path multipath[OS_ROUTE_MAX_MULTIPATH - 1];
+
+  /*! number of alternative paths */
+  uint8_t multipath_count;
+
   /**
    * address of the last originator in the routing tree before
    * the destination
@@ -99,6 +161,56 @@ struct olsrv2_dijkstra_node {
 
   /*! true if node already has been processed */
   bool done;
+
+  /*! dijkstra run this data belongs to, older data is reset on access */
+  uint32_t _run;
+
+  /*! true if node is part of the source-specific sub-topology */
+  bool _ss_topology;
+
+  /*! index of the first link of a tc node in the dijkstra adjacency */
+  uint32_t _link_first;
+
+  /*! number of links of a tc node in the dijkstra adjacency */
+  uint32_t _link_count;
+};
+
+/**
+ * key of a kernel nexthop object
+ */
+struct olsrv2_routing_nexthop_key {
+  /*! originator of the first hop neighbor */
+  struct netaddr originator;
+
+  /*! outgoing interface, the kernel flushes nexthops of interfaces that go down */
+  unsigned int if_index;
+
+  /*! address family of the routes using the nexthop */
+  int family;
+
+  /*! index of the nhdp domain of the routes */
+  int domain;
+};
+
+/**
+ * kernel nexthop object shared by all routes of a domain
+ * that use the same first hop neighbor and interface
+ */
+struct olsrv2_routing_nexthop {
+  /*! kernel nexthop object */
+  struct os_route_nexthop os;
+
+  /*! key of nexthop object */
+  struct olsrv2_routing_nexthop_key key;
+
+  /*! number of routing entries using this nexthop */
+  uint32_t usage;
+
+  /*! hook into tree of active nexthops */
+  struct avl_node _node;
+
+  /*! hook into list of nexthops waiting for their kernel removal */
+  struct list_entity _removed_node;
 };
 
 /**
@@ -135,6 +247,24 @@ struct olsrv2_routing_entry {
   /*! true if this route is being processed by the kernel at the moment */
   bool in_processing;
 
+  /**
+   * true if the route was read from the kernel at startup or after a
+   * table change and has not been confirmed by the dijkstra yet
+   */
+  bool adopted;
+
+  /**
+   * true if the kernel route in _adopt has to be adopted when the
+   * removal of the route from the old routing table is finished
+   */
+  bool adopt_pending;
+
+  /*! kernel route of the new routing table after a table change */
+  struct os_route_parameter _adopt;
+
+  /*! kernel nexthop object used by this route, NULL if none */
+  struct olsrv2_routing_nexthop *_nexthop;
+
   /*! old values of route before current dijstra run */
   struct os_route_parameter _old;
 
@@ -163,6 +293,15 @@ struct olsrv2_routing_domain {
 
   /*! domain uses source specific routing */
   bool source_specific;
+
+  /*! domain installs routes referencing kernel nexthop objects */
+  bool use_nexthop_objects;
+
+  /*! maximum number of next hops of a multipath route, 1 disables multipath */
+  int32_t multipath;
+
+  /*! percentage an alternative path can be more expensive than the best one */
+  int32_t multipath_tolerance;
 };
 
 /**
@@ -183,9 +322,11 @@ struct olsrv2_routing_filter {
 };
 
 int olsrv2_routing_init(void);
-void olsrv2_routing_initiate_shutdown(void);
+void olsrv2_routing_initiate_shutdown(bool keep_routes);
 void olsrv2_routing_cleanup(void);
 
+void olsrv2_routing_reconcile_kernel_routes(uint64_t hold_time);
+
 void olsrv2_routing_dijkstra_node_init(struct olsrv2_dijkstra_node *, const struct netaddr *originator);
 
 EXPORT uint16_t olsrv2_routing_get_ansn(void);
@@ -193,6 +334,9 @@ EXPORT void olsrv2_routing_force_ansn_increment(uint16_t increment);
 
 EXPORT void olsrv2_routing_set_domain_parameter(struct nhdp_domain *domain, struct olsrv2_routing_domain *parameter);
 
+EXPORT void olsrv2_routing_set_throttling(const struct olsrv2_routing_throttling *throttling);
+EXPORT const struct olsrv2_routing_statistics *olsrv2_routing_get_statistics(void);
+
 EXPORT void olsrv2_routing_domain_changed(struct nhdp_domain *domain, bool autoupdate_ansn);
 EXPORT void olsrv2_routing_force_update(bool skip_wait);
 EXPORT void olsrv2_routing_trigger_update(void);
@@ -49,6 +49,7 @@
 #include <oonf/libcommon/avl.h>
 #include <oonf/oonf.h>
 #include <oonf/libcommon/netaddr.h>
+#include <oonf/libcommon/netaddr_hash.h>
 
 #include <oonf/base/oonf_timer.h>
 
@@ -102,6 +103,9 @@ struct olsrv2_tc_target {
 
   /*! internal data for dijkstra run */
   struct olsrv2_dijkstra_node _dijkstra;
+
+  /*! internal data for paths through the source-specific sub-topology */
+  struct olsrv2_dijkstra_node _ss_dijkstra;
 };
 
 /**
@@ -124,9 +128,21 @@ struct olsrv2_tc_node {
   /*! node has announced it can do source specific routing */
   bool source_specific;
 
+  /*! node has announced that it and all its symmetric neighbors can process differential TCs */
+  bool differential_tcs;
+
+  /*! node was restored from a warm restart snapshot, accept any ANSN from it */
+  bool restored;
+
   /*! true if node has source specific attached networks per domain */
   bool ss_attached_networks[NHDP_MAXIMUM_DOMAINS];
 
+  /*! ANSN of the last fragment of a full TC */
+  uint16_t _full_tc_ansn;
+
+  /*! time when the first fragment of a full TC with _full_tc_ansn arrived, 0 if none */
+  uint64_t _full_tc_time;
+
   /*! time until this node has to be removed */
   struct oonf_timer_instance _validity_time;
 
@@ -138,6 +154,9 @@ struct olsrv2_tc_node {
 
   /*! node for tree of tc_nodes */
   struct avl_node _originator_node;
+
+  /*! node for hash index of tc_nodes */
+  struct netaddr_hash_node _originator_hash;
 };
 
 /**
@@ -211,6 +230,9 @@ struct olsrv2_tc_endpoint {
 
   /*! node for global tree of endpoints */
   struct avl_node _node;
+
+  /*! node for hash index of endpoints */
+  struct netaddr_hash_node _hash_node;
 };
 
 void olsrv2_tc_init(void);
@@ -227,20 +249,12 @@ EXPORT void olsrv2_tc_endpoint_remove(struct olsrv2_tc_attachment *);
 
 void olsrv2_tc_trigger_change(struct olsrv2_tc_node *);
 
+EXPORT struct olsrv2_tc_node *olsrv2_tc_node_get(const struct netaddr *originator);
+EXPORT struct olsrv2_tc_endpoint *olsrv2_tc_endpoint_get(const struct os_route_key *prefix);
+
 EXPORT struct avl_tree *olsrv2_tc_get_tree(void);
 EXPORT struct avl_tree *olsrv2_tc_get_endpoint_tree(void);
 
-/**
- * @param originator originator address of a tc node
- * @return pointer to tc node, NULL if not found
- */
-static INLINE struct olsrv2_tc_node *
-olsrv2_tc_node_get(struct netaddr *originator) {
-  struct olsrv2_tc_node *node;
-
-  return avl_find_element(olsrv2_tc_get_tree(), originator, node, _originator_node);
-}
-
 /**
  * @param node pointer to olsrv2 node
  * @return true if node is virtual
@@ -250,17 +264,6 @@ olsrv2_tc_is_node_virtual(struct olsrv2_tc_node *node) {
   return !oonf_timer_is_active(&node->_validity_time);
 }
 
-/**
- * @param prefix network prefix of tc endpoint, might be source specific
- * @return pointer to tc endpoint, NULL if not found
- */
-static INLINE struct olsrv2_tc_endpoint *
-olsrv2_tc_endpoint_get(struct os_route_key *prefix) {
-  struct olsrv2_tc_endpoint *end;
-
-  return avl_find_element(olsrv2_tc_get_endpoint_tree(), prefix, end, _node);
-}
-
 static INLINE uint32_t
 olsrv2_tc_attachment_get_metric(struct nhdp_domain *domain, struct olsrv2_tc_attachment *attached) {
   return attached->cost[domain->index];
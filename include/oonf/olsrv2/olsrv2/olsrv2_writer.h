@@ -52,7 +52,8 @@
 int olsrv2_writer_init(struct oonf_rfc5444_protocol *) __attribute__((warn_unused_result));
 void olsrv2_writer_cleanup(void);
 
-EXPORT void olsrv2_writer_send_tc(void);
+EXPORT void olsrv2_writer_send_tc(uint8_t hop_limit, bool differential);
+EXPORT void olsrv2_writer_set_differential_tcs(bool enable);
 EXPORT void olsrv2_writer_set_forwarding_selector(
   bool (*forward_target_selector)(struct rfc5444_writer_target *, struct rfc5444_reader_tlvblock_context *context));
 
@@ -61,6 +61,7 @@
 #include <oonf/libcore/oonf_logging.h>
 #include <oonf/libcore/oonf_subsystem.h>
 #include <oonf/libcore/os_core.h>
+#include <oonf/base/oonf_class.h>
 #include <oonf/base/oonf_stream_socket.h>
 #include <oonf/base/oonf_telnet.h>
 
@@ -87,6 +88,26 @@ struct _http_config {
   /*! internal variable with file descriptor to webserver directory */
   int www_dir_fd;
 };
+
+/**
+ * http session with the state of a streamed answer
+ */
+struct _http_session {
+  /*! tcp stream session, must be the first element */
+  struct oonf_stream_session session;
+
+  /*! callback to generate the next chunk of a streamed answer */
+  int (*stream_next)(struct autobuf *out, void *stream_data);
+
+  /*! callback to cleanup a streamed answer */
+  void (*stream_cleanup)(void *stream_data);
+
+  /*! custom data of streamed answer */
+  void *stream_data;
+
+  /*! true if the streamed answer uses chunked transfer encoding */
+  bool chunked;
+};
 /* HTTP text constants */
 static const char HTTP_VERSION_1_0[] = "HTTP/1.0";
 static const char HTTP_VERSION_1_1[] = "HTTP/1.1";
@@ -97,6 +118,8 @@ static const char HTTP_POST[] = "POST";
 static const char HTTP_CONTENT_LENGTH[] = "Content-Length";
 static const char HTTP_CONTENT_TYPE[] = "Content-Type";
 
+static const char HTTP_CHUNK_END[] = "0\r\n\r\n";
+
 static const char HTTP_RESPONSE_200[] = "OK";
 static const char HTTP_RESPONSE_400[] = "Bad Request";
 static const char HTTP_RESPONSE_401[] = "Unauthorized";
@@ -119,17 +142,23 @@ static void _cb_config_changed(void);
 static enum oonf_stream_session_state _cb_receive_data(struct oonf_stream_session *session);
 static void _cb_create_error(struct oonf_stream_session *session, enum oonf_stream_errors error);
 static void _cb_cleanup_session(struct oonf_stream_session *);
+static enum oonf_stream_session_state _cb_buffer_underrun(struct oonf_stream_session *session);
 
 static bool _auth_okay(struct oonf_http_handler *handler, struct oonf_http_session *session);
 static void _create_http_error(struct oonf_stream_session *session, enum oonf_http_result error);
 static struct oonf_http_handler *_get_site_handler(const char *uri);
 static const char *_get_headertype_string(enum oonf_http_result type);
-static void _create_http_header(
-  struct oonf_stream_session *session, enum oonf_http_result code, const char *content_type, size_t content_length);
+static void _create_http_header(struct oonf_stream_session *session, enum oonf_http_result code,
+  const char *content_type, size_t content_length, bool chunked);
+static void _start_stream_transfer(struct oonf_stream_session *session, struct oonf_http_session *header);
+static void _stop_stream_transfer(struct _http_session *http_session);
+static void _add_chunk_frame(struct autobuf *out);
 static int _parse_http_header(char *header_data, size_t header_len, struct oonf_http_session *header);
 static size_t _parse_query_string(char *s, char **name, char **value, size_t count);
 static void _decode_uri(char *src);
 static enum oonf_http_result _cb_telnet_handler(struct autobuf *out, struct oonf_http_session *);
+static int _cb_telnet_stream_next(struct autobuf *out, void *stream_data);
+static void _cb_telnet_stream_cleanup(void *stream_data);
 static enum oonf_http_result _cb_file_handler(struct autobuf *out, struct oonf_http_session *);
 
 /* configuration variables */
@@ -156,13 +185,25 @@ static struct cfg_schema_section _http_section = { .type = OONF_HTTP_SUBSYSTEM,
 static struct avl_tree _http_site_tree;
 
 /* http session handling */
+static struct oonf_class _http_memcookie = {
+  .name = "http session",
+  .size = sizeof(struct _http_session),
+};
+
+static struct oonf_class _telnet_bridge_memcookie = {
+  .name = "http telnet bridge",
+  .size = sizeof(struct oonf_telnet_session),
+};
+
 static struct oonf_stream_managed _http_managed_socket = {
   .config =
     {
       .session_timeout = 120000, /* 120 seconds */
       .maximum_input_buffer = 65536,
       .allowed_sessions = 10,
+      .memcookie = &_http_memcookie,
       .receive_data = _cb_receive_data,
+      .buffer_underrun = _cb_buffer_underrun,
       .create_error = _cb_create_error,
       .cleanup_session = _cb_cleanup_session,
     },
@@ -191,6 +232,7 @@ static struct oonf_http_handler _file_handler = {
 
 /* subsystem definition */
 static const char *_dependencies[] = {
+  OONF_CLASS_SUBSYSTEM,
   OONF_STREAM_SUBSYSTEM,
   OONF_TELNET_SUBSYSTEM,
 };
@@ -211,6 +253,9 @@ DECLARE_OONF_PLUGIN(_oonf_http_subsystem);
  */
 static int
 _init(void) {
+  oonf_class_add(&_http_memcookie);
+  oonf_class_add(&_telnet_bridge_memcookie);
+
   oonf_stream_add_managed(&_http_managed_socket);
   avl_init(&_http_site_tree, avl_comp_strcasecmp, false);
 
@@ -235,6 +280,9 @@ _cleanup(void) {
   oonf_http_remove(&_file_handler);
   oonf_stream_remove_managed(&_http_managed_socket, true);
   oonf_stream_free_managed_config(&_config.smc);
+
+  oonf_class_remove(&_telnet_bridge_memcookie);
+  oonf_class_remove(&_http_memcookie);
 }
 
 /**
@@ -389,7 +437,7 @@ _cb_receive_data(struct oonf_stream_session *session) {
   if (handler->content) {
     /* static content */
     abuf_memcpy(&session->out, handler->content, handler->content_size);
-    _create_http_header(session, HTTP_200_OK, NULL, abuf_getlen(&session->out));
+    _create_http_header(session, HTTP_200_OK, NULL, abuf_getlen(&session->out), false);
   }
   else {
     /* custom handler */
@@ -420,14 +468,17 @@ _cb_receive_data(struct oonf_stream_session *session) {
       session->copy_total_size = header.transfer_length;
       session->copy_bytes_sent = 0;
 
-      _create_http_header(session, HTTP_200_OK, header.content_type, header.transfer_length);
+      _create_http_header(session, HTTP_200_OK, header.content_type, header.transfer_length, false);
+    }
+    else if (result == HTTP_START_STREAM_TRANSFER) {
+      _start_stream_transfer(session, &header);
     }
     else if (result != HTTP_200_OK) {
       /* create error message */
       _create_http_error(session, result);
     }
     else {
-      _create_http_header(session, HTTP_200_OK, header.content_type, abuf_getlen(&session->out));
+      _create_http_header(session, HTTP_200_OK, header.content_type, abuf_getlen(&session->out), false);
     }
   }
   return STREAM_SESSION_SEND_AND_QUIT;
@@ -440,6 +491,111 @@ _cb_receive_data(struct oonf_stream_session *session) {
 static void
 _cb_cleanup_session(struct oonf_stream_session *session) {
   os_fd_close(&session->copy_fd);
+  _stop_stream_transfer((struct _http_session *)session);
+}
+
+/**
+ * Callback for an empty output buffer, used to generate the
+ * next chunk of a streamed answer
+ * @param session pointer to tcp session
+ * @return state of tcp session
+ */
+static enum oonf_stream_session_state
+_cb_buffer_underrun(struct oonf_stream_session *session) {
+  struct _http_session *http_session;
+  int result;
+
+  http_session = (struct _http_session *)session;
+  if (http_session->stream_next == NULL) {
+    return session->state;
+  }
+
+  do {
+    result = http_session->stream_next(&session->out, http_session->stream_data);
+  } while (result > 0 && abuf_getlen(&session->out) == 0);
+
+  if (result < 0 || abuf_has_failed(&session->out)) {
+    /* we cannot change the http result anymore, just close the session */
+    OONF_WARN(LOG_HTTP, "Error while generating streamed http answer");
+    _stop_stream_transfer(http_session);
+    return STREAM_SESSION_CLEANUP;
+  }
+
+  if (http_session->chunked) {
+    _add_chunk_frame(&session->out);
+    if (result == 0) {
+      abuf_puts(&session->out, HTTP_CHUNK_END);
+    }
+  }
+
+  if (result == 0) {
+    _stop_stream_transfer(http_session);
+  }
+  return session->state;
+}
+
+/**
+ * Initialize a streamed answer and generate its http header.
+ * HTTP/1.1 clients get a chunked answer, HTTP/1.0 clients get
+ * an answer terminated by the end of the tcp session.
+ * @param session pointer to tcp session
+ * @param header pointer to http session with stream callbacks
+ */
+static void
+_start_stream_transfer(struct oonf_stream_session *session, struct oonf_http_session *header) {
+  struct _http_session *http_session;
+
+  http_session = (struct _http_session *)session;
+  http_session->stream_next = header->stream_next;
+  http_session->stream_cleanup = header->stream_cleanup;
+  http_session->stream_data = header->stream_data;
+  http_session->chunked = strcmp(header->http_version, HTTP_VERSION_1_1) == 0;
+
+  if (http_session->chunked) {
+    /* output of the content handler becomes the first chunk */
+    _add_chunk_frame(&session->out);
+  }
+  _create_http_header(session, HTTP_200_OK, header->content_type, 0, http_session->chunked);
+}
+
+/**
+ * Stop a streamed answer and free its resources
+ * @param http_session pointer to http session
+ */
+static void
+_stop_stream_transfer(struct _http_session *http_session) {
+  void (*stream_cleanup)(void *);
+  void *stream_data;
+
+  stream_cleanup = http_session->stream_cleanup;
+  stream_data = http_session->stream_data;
+
+  http_session->stream_next = NULL;
+  http_session->stream_cleanup = NULL;
+  http_session->stream_data = NULL;
+
+  if (stream_cleanup) {
+    stream_cleanup(stream_data);
+  }
+}
+
+/**
+ * Put the content of an output buffer into a chunk of
+ * the chunked transfer encoding
+ * @param out output buffer
+ */
+static void
+_add_chunk_frame(struct autobuf *out) {
+  char chunk_header[20];
+
+  if (abuf_getlen(out) == 0) {
+    /* an empty chunk would end the transfer */
+    return;
+  }
+
+  snprintf(chunk_header, sizeof(chunk_header), "%zx\r\n", abuf_getlen(out));
+  abuf_memcpy_prepend(out, chunk_header, strlen(chunk_header));
+  abuf_puts(out, "\r\n");
 }
 
 /**
@@ -493,7 +649,7 @@ _create_http_error(struct oonf_stream_session *session, enum oonf_http_result er
     "<html><head><title>%s %s http server</title></head>"
     "<body><h1>HTTP error %d: %s</h1></body></html>",
     oonf_log_get_appdata()->app_name, oonf_log_get_libdata()->version, error, _get_headertype_string(error));
-  _create_http_header(session, error, NULL, abuf_getlen(&session->out));
+  _create_http_header(session, error, NULL, abuf_getlen(&session->out), false);
 }
 
 /**
@@ -575,16 +731,18 @@ _get_headertype_string(enum oonf_http_result type) {
  * @param content_type explicit content type or NULL for
  * @param content_length length of content, 0 for no content length
  *   plain html
+ * @param chunked true if content uses chunked transfer encoding
  */
 static void
-_create_http_header(
-  struct oonf_stream_session *session, enum oonf_http_result code, const char *content_type, size_t content_length) {
+_create_http_header(struct oonf_stream_session *session, enum oonf_http_result code,
+  const char *content_type, size_t content_length, bool chunked) {
   struct autobuf buf;
   struct timeval currtime;
 
   abuf_init(&buf);
 
-  abuf_appendf(&buf, "%s %d %s\r\n", HTTP_VERSION_1_0, code, _get_headertype_string(code));
+  abuf_appendf(&buf, "%s %d %s\r\n", chunked ? HTTP_VERSION_1_1 : HTTP_VERSION_1_0, code,
+    _get_headertype_string(code));
 
   /* Date */
   os_core_gettimeofday(&currtime);
@@ -609,6 +767,9 @@ _create_http_header(
   if (content_length > 0) {
     abuf_appendf(&buf, "Content-length: %zu\r\n", content_length);
   }
+  else if (chunked) {
+    abuf_puts(&buf, "Transfer-Encoding: chunked\r\n");
+  }
 
   if (code == HTTP_401_UNAUTHORIZED) {
     abuf_appendf(&buf, "WWW-Authenticate: Basic realm=\"%s\"\r\n", "RealmName");
@@ -877,13 +1038,22 @@ _decode_uri(char *src) {
 static enum oonf_http_result
 _cb_telnet_handler(struct autobuf *out, struct oonf_http_session *session) {
   static char EOL = 0;
+  struct oonf_telnet_session *telnet;
   enum oonf_telnet_result result;
+  enum oonf_http_result http_result;
   char buffer[1024];
   char *ptr1, *ptr2, *ptr3;
 
   session->content_type = HTTP_CONTENTTYPE_TEXT;
   strscpy(buffer, &session->decoded_request_uri[sizeof(HTTP_TO_TELNET) - 1], sizeof(buffer));
 
+  telnet = oonf_class_malloc(&_telnet_bridge_memcookie);
+  if (telnet == NULL) {
+    return HTTP_500_INTERNAL_SERVER_ERROR;
+  }
+  oonf_telnet_session_init(telnet, out, session->remote);
+
+  http_result = HTTP_200_OK;
   ptr1 = buffer;
   while (true) {
     ptr2 = strchr(ptr1, '/');
@@ -900,25 +1070,75 @@ _cb_telnet_handler(struct autobuf *out, struct oonf_http_session *session) {
       ptr3 = &EOL;
     }
 
-    result = oonf_telnet_execute(ptr1, ptr3, out, session->remote);
+    result = oonf_telnet_session_execute(telnet, ptr1, ptr3);
+    if (result == TELNET_RESULT_CONTINOUS && oonf_telnet_is_streaming(&telnet->data)) {
+      /* streamed output, will be finished before next command */
+      result = TELNET_RESULT_ACTIVE;
+    }
+
     switch (result) {
       case TELNET_RESULT_ACTIVE:
       case TELNET_RESULT_QUIT:
         break;
 
       case _TELNET_RESULT_UNKNOWN_COMMAND:
-        return HTTP_404_NOT_FOUND;
+        http_result = HTTP_404_NOT_FOUND;
+        break;
 
       default:
-        return HTTP_400_BAD_REQ;
+        http_result = HTTP_400_BAD_REQ;
+        break;
     }
 
-    if (!ptr2) {
+    if (!ptr2 || http_result != HTTP_200_OK) {
       break;
     }
     ptr1 = ptr2 + 1;
   }
-  return HTTP_200_OK;
+
+  if (http_result == HTTP_200_OK && oonf_telnet_is_streaming(&telnet->data)) {
+    /* the last command streams its output */
+    session->stream_next = _cb_telnet_stream_next;
+    session->stream_cleanup = _cb_telnet_stream_cleanup;
+    session->stream_data = telnet;
+    return HTTP_START_STREAM_TRANSFER;
+  }
+
+  _cb_telnet_stream_cleanup(telnet);
+  return http_result;
+}
+
+/**
+ * Generate the next chunk of a streamed telnet command
+ * @param out output buffer
+ * @param stream_data telnet session of the http to telnet bridge
+ * @return -1 if an error happened, 0 if output is complete,
+ *   1 if more output will follow
+ */
+static int
+_cb_telnet_stream_next(struct autobuf *out __attribute__((unused)), void *stream_data) {
+  struct oonf_telnet_session *telnet = stream_data;
+
+  switch (oonf_telnet_stream_next(&telnet->data)) {
+    case TELNET_RESULT_CONTINOUS:
+      return 1;
+    case TELNET_RESULT_ACTIVE:
+      return 0;
+    default:
+      return -1;
+  }
+}
+
+/**
+ * Free the telnet session of the http to telnet bridge
+ * @param stream_data telnet session
+ */
+static void
+_cb_telnet_stream_cleanup(void *stream_data) {
+  struct oonf_telnet_session *telnet = stream_data;
+
+  oonf_telnet_session_cleanup(telnet);
+  oonf_class_free(&_telnet_bridge_memcookie, telnet);
 }
 
 /**
@@ -53,6 +53,7 @@
 #include <oonf/libconfig/cfg_help.h>
 #include <oonf/libcore/oonf_subsystem.h>
 #include <oonf/base/oonf_class.h>
+#include <oonf/base/oonf_timer.h>
 #include <oonf/base/os_interface.h>
 
 #include <oonf/base/oonf_layer2.h>
@@ -66,11 +67,13 @@ static void _cleanup(void);
 
 static void _net_remove(struct oonf_layer2_net *l2net);
 static void _neigh_remove(struct oonf_layer2_neigh *l2neigh);
+static void _cb_poll_timer(struct oonf_timer_instance *ptr);
 
 /* subsystem definition */
 static const char *_dependencies[] = {
   OONF_CLASS_SUBSYSTEM,
   OONF_OS_INTERFACE_SUBSYSTEM,
+  OONF_TIMER_SUBSYSTEM,
 };
 
 static struct oonf_subsystem _oonf_layer2_subsystem = {
@@ -202,6 +205,14 @@ static struct avl_tree _lid_tree;
 
 static uint32_t _lid_originator_count;
 
+/* adaptive polling schedules of layer2 data sources */
+static struct list_entity _poll_list;
+
+static struct oonf_timer_class _poll_timer_class = {
+  .name = "layer2 poll",
+  .callback = _cb_poll_timer,
+};
+
 /**
  * Subsystem constructor
  * @return always returns 0
@@ -219,6 +230,9 @@ _init(void) {
   avl_init(&_oonf_originator_tree, avl_comp_strcasecmp, false);
   avl_init(&_local_peer_ips_tree, avl_comp_netaddr, true);
   avl_init(&_lid_tree, avl_comp_netaddr, false);
+  list_init_head(&_poll_list);
+
+  oonf_timer_add(&_poll_timer_class);
 
   _lid_originator_count = 0;
   return 0;
@@ -231,6 +245,12 @@ static void
 _cleanup(void) {
   struct oonf_layer2_net *l2net, *l2n_it;
   struct oonf_layer2_lid *lid, *lid_it;
+  struct oonf_layer2_poll *poll, *poll_it;
+
+  list_for_each_element_safe(&_poll_list, poll, _node, poll_it) {
+    oonf_layer2_poll_remove(poll);
+  }
+  oonf_timer_remove(&_poll_timer_class);
 
   avl_for_each_element_safe(&_oonf_layer2_net_tree, l2net, _node, l2n_it) {
     _net_remove(l2net);
@@ -263,6 +283,105 @@ oonf_layer2_origin_add(struct oonf_layer2_origin *origin) {
   }
 }
 
+/**
+ * Register an adaptive polling schedule for a layer2 data source.
+ * The first poll is triggered immediately.
+ * @param poll initialized poll object
+ */
+void
+oonf_layer2_poll_add(struct oonf_layer2_poll *poll) {
+  if (poll->max_interval < poll->min_interval) {
+    poll->max_interval = poll->min_interval;
+  }
+  poll->interval = poll->min_interval;
+  poll->volatility = OONF_LAYER2_POLL_VOLATILITY_MAX;
+  poll->polls = 0;
+  poll->changed_polls = 0;
+
+  poll->_timer.class = &_poll_timer_class;
+  list_add_tail(&_poll_list, &poll->_node);
+
+  if (poll->interval) {
+    oonf_timer_set(&poll->_timer, 1);
+  }
+}
+
+/**
+ * Unregister an adaptive polling schedule
+ * @param poll poll object
+ */
+void
+oonf_layer2_poll_remove(struct oonf_layer2_poll *poll) {
+  if (!list_is_node_added(&poll->_node)) {
+    return;
+  }
+  oonf_timer_stop(&poll->_timer);
+  list_remove(&poll->_node);
+}
+
+/**
+ * Change the interval bounds of a poll schedule, the schedule
+ * restarts at the new minimum interval with an immediate poll.
+ * @param poll poll object
+ * @param min_interval shortest interval between two polls
+ * @param max_interval longest interval between two polls
+ */
+void
+oonf_layer2_poll_set_bounds(struct oonf_layer2_poll *poll, uint64_t min_interval, uint64_t max_interval) {
+  poll->min_interval = min_interval;
+  poll->max_interval = max_interval < min_interval ? min_interval : max_interval;
+  poll->interval = min_interval;
+
+  if (list_is_node_added(&poll->_node) && poll->interval) {
+    oonf_timer_set(&poll->_timer, 1);
+  }
+}
+
+/**
+ * Report the result of a poll of a layer2 data source. Changed data
+ * halves the poll interval, stable data lets it grow depending on the
+ * cost of the query.
+ * @param poll poll object
+ * @param changed true if the poll changed the layer2 database
+ */
+void
+oonf_layer2_poll_done(struct oonf_layer2_poll *poll, bool changed) {
+  uint64_t interval, step;
+  uint32_t cost;
+
+  poll->polls++;
+  poll->volatility = (poll->volatility * 7 + (changed ? OONF_LAYER2_POLL_VOLATILITY_MAX : 0)) / 8;
+
+  interval = poll->interval;
+  if (changed) {
+    poll->changed_polls++;
+    interval /= 2;
+  }
+  else {
+    /* grow by a quarter of the minimum interval per cost unit */
+    cost = poll->cost ? poll->cost : 1;
+    step = (poll->min_interval * cost) / 4;
+    interval += step ? step : 1;
+  }
+
+  if (interval < poll->min_interval) {
+    interval = poll->min_interval;
+  }
+  if (interval > poll->max_interval) {
+    interval = poll->max_interval;
+  }
+
+  if (interval != poll->interval) {
+    OONF_DEBUG(LOG_LAYER2, "Poll '%s' changes interval from %" PRIu64 " to %" PRIu64 " ms",
+        poll->name, poll->interval, interval);
+    poll->interval = interval;
+
+    if (list_is_node_added(&poll->_node) && interval) {
+      oonf_timer_set(&poll->_timer, interval);
+    }
+  }
+}
+
 /**
  * Removes all layer2 data associated with this data originator
  * @param origin originator
@@ -1460,6 +1579,15 @@ oonf_layer2_get_net_tree(void) {
   return &_oonf_layer2_net_tree;
 }
 
+/**
+ * get list of layer2 poll schedules
+ * @return poll list
+ */
+struct list_entity *
+oonf_layer2_get_poll_list(void) {
+  return &_poll_list;
+}
+
 /**
  * get tree of layer2 originators
  * @return originator tree
@@ -1629,3 +1757,18 @@ _neigh_remove(struct oonf_layer2_neigh *l2neigh) {
   avl_remove(&l2neigh->network->neighbors, &l2neigh->_node);
   oonf_class_free(&_l2neighbor_class, l2neigh);
 }
+
+/**
+ * Callback for triggering the next poll of a data source
+ * @param ptr timer instance that fired
+ */
+static void
+_cb_poll_timer(struct oonf_timer_instance *ptr) {
+  struct oonf_layer2_poll *poll;
+
+  poll = container_of(ptr, struct oonf_layer2_poll, _timer);
+
+  /* rearm first, so a source that never reports back is still polled */
+  oonf_timer_set(&poll->_timer, poll->interval);
+  poll->cb_poll(poll);
+}
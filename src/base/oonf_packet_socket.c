@@ -275,6 +275,10 @@ oonf_packet_add_managed(struct oonf_packet_managed *managed) {
   managed->_if_listener.name = managed->_managed_config.interface;
   managed->_if_listener.mesh = managed->_managed_config.mesh;
 
+  /* MAC, MTU and peer address changes do not influence the socket bindings */
+  managed->_if_listener.change_mask =
+    OS_INTERFACE_CHANGE_STATE | OS_INTERFACE_CHANGE_FLAGS | OS_INTERFACE_CHANGE_INDEX | OS_INTERFACE_CHANGE_ADDRESS;
+
   managed->_change_callback.cb_trigger = _cb_delayed_change;
   managed->_change_callback.name = CHANGE_CALLBACK;
 }
@@ -203,6 +203,8 @@ static struct cfg_schema_entry _interface_entries[] = {
     _rfc5444_if_config, sock.rawip, "rawip", "false", "True if a raw IP socket should be used, false to use UDP"),
   CFG_MAP_INT32_MINMAX(
     _rfc5444_if_config, sock.ttl_multicast, "multicast_ttl", "1", "TTL value of outgoing multicast traffic", 0, 1, 255),
+
+  /* must be the last entry, it does not affect the socket */
   CFG_MAP_CLOCK(_rfc5444_if_config, aggregation_interval, "aggregation_interval", "0.100",
     "Interval in seconds for message aggregation"),
 
@@ -1437,9 +1439,16 @@ _cb_cfg_interface_changed(void) {
       OONF_WARN(LOG_RFC5444, "Could not generate interface '%s' for protocol '%s'", ifname, _rfc5444_protocol->name);
       goto interface_changed_cleanup;
     }
+    oonf_rfc5444_reconfigure_interface(interf, &config.sock);
+  }
+  else if (interf == NULL) {
+    goto interface_changed_cleanup;
+  }
+  else if (cfg_schema_is_delta_changed(_interface_entries, ARRAYSIZE(_interface_entries) - 1)) {
+    /* socket settings changed */
+    oonf_rfc5444_reconfigure_interface(interf, &config.sock);
   }
 
-  oonf_rfc5444_reconfigure_interface(interf, &config.sock);
   interf->aggregation_interval = config.aggregation_interval;
 
   /* fall through */
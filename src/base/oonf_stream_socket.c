@@ -352,6 +352,8 @@ oonf_stream_add_managed(struct oonf_stream_managed *managed) {
 
   managed->_if_listener.if_changed = _cb_interface_listener;
   managed->_if_listener.name = managed->_managed_config.interface;
+  managed->_if_listener.change_mask =
+    OS_INTERFACE_CHANGE_STATE | OS_INTERFACE_CHANGE_INDEX | OS_INTERFACE_CHANGE_ADDRESS;
 }
 
 /**
@@ -840,8 +842,9 @@ _cb_parse_connection(struct oonf_socket_entry *entry) {
     }
   }
 
-  /* check for buffer underrun */
-  if (session->state == STREAM_SESSION_ACTIVE && abuf_getlen(&session->out) == 0 &&
+  /* check for buffer underrun, a streaming session might want to generate more output */
+  if ((session->state == STREAM_SESSION_ACTIVE || session->state == STREAM_SESSION_SEND_AND_QUIT) &&
+      abuf_getlen(&session->out) == 0 && !os_fd_is_initialized(&session->copy_fd) &&
       s_sock->config.buffer_underrun != NULL) {
     session->state = s_sock->config.buffer_underrun(session);
   }
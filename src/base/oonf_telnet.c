@@ -75,15 +75,19 @@ static void _cleanup(void);
 static int _avl_comp_strcmdword(const void *txt1, const void *txt2);
 
 static void _call_stop_handler(struct oonf_telnet_data *data);
+static void _stop_stream(struct oonf_telnet_data *data);
+static enum oonf_telnet_result _drain_stream(struct oonf_telnet_data *data);
 static void _cb_config_changed(void);
 static int _cb_telnet_init(struct oonf_stream_session *);
 static void _cb_telnet_cleanup(struct oonf_stream_session *);
 static void _cb_telnet_create_error(struct oonf_stream_session *, enum oonf_stream_errors);
 static enum oonf_stream_session_state _cb_telnet_receive_data(struct oonf_stream_session *);
+static enum oonf_stream_session_state _cb_telnet_buffer_underrun(struct oonf_stream_session *);
 static enum oonf_telnet_result _telnet_handle_command(struct oonf_telnet_data *);
 static struct oonf_telnet_command *_check_telnet_command_acl(
   struct oonf_telnet_data *data, struct oonf_telnet_command *cmd);
 
+static enum oonf_telnet_result _handle_repeated_command(struct oonf_telnet_data *data);
 static void _cb_telnet_repeat_timer(struct oonf_timer_instance *data);
 static enum oonf_telnet_result _cb_telnet_quit(struct oonf_telnet_data *data);
 static enum oonf_telnet_result _cb_telnet_help(struct oonf_telnet_data *data);
@@ -160,6 +164,7 @@ static struct oonf_stream_managed _telnet_managed = {
       .init_session = _cb_telnet_init,
       .cleanup_session = _cb_telnet_cleanup,
       .receive_data = _cb_telnet_receive_data,
+      .buffer_underrun = _cb_telnet_buffer_underrun,
       .create_error = _cb_telnet_create_error,
     },
 };
@@ -245,31 +250,111 @@ oonf_telnet_stop(struct oonf_telnet_data *data, bool print_prompt) {
 enum oonf_telnet_result
 oonf_telnet_execute(const char *cmd, const char *para, struct autobuf *out, struct netaddr *remote)
 {
-  struct oonf_telnet_cleanup *handler, *it;
   struct oonf_telnet_session session;
   enum oonf_telnet_result result;
 
-  memset(&session, 0, sizeof(session));
-  session.data.command = cmd;
-  session.data.parameter = para;
-  session.data.out = out;
-  session.data.remote = remote;
+  oonf_telnet_session_init(&session, out, remote);
+
+  result = oonf_telnet_session_execute(&session, cmd, para);
+  if (result == TELNET_RESULT_CONTINOUS && oonf_telnet_is_streaming(&session.data)) {
+    /* caller needs the complete output */
+    result = _drain_stream(&session.data);
+  }
+
+  oonf_telnet_session_cleanup(&session);
+
+  return abuf_has_failed(out) ? TELNET_RESULT_INTERNAL_ERROR : result;
+}
+
+/**
+ * Initialize a telnet session that is not connected to a TCP stream,
+ * used by other subsystems to run telnet commands.
+ * @param session pointer to telnet session
+ * @param out buffer for output of commands
+ * @param remote pointer to address which triggers the execution
+ */
+void
+oonf_telnet_session_init(struct oonf_telnet_session *session, struct autobuf *out, struct netaddr *remote) {
+  memset(session, 0, sizeof(*session));
+  session->data.out = out;
+  session->data.remote = remote;
+
+  list_init_head(&session->data.cleanup_list);
+}
+
+/**
+ * Execute a telnet command in a session initialized by
+ * oonf_telnet_session_init(). If the command returns
+ * TELNET_RESULT_CONTINOUS and streams its output, the caller
+ * has to fetch the rest of the output with oonf_telnet_stream_next().
+ * @param session pointer to telnet session
+ * @param cmd pointer to name of command
+ * @param para pointer to parameter string
+ * @return result of telnet command
+ */
+enum oonf_telnet_result
+oonf_telnet_session_execute(struct oonf_telnet_session *session, const char *cmd, const char *para) {
+  /* finish output of the last command */
+  if (oonf_telnet_is_streaming(&session->data)) {
+    _drain_stream(&session->data);
+  }
 
-  list_init_head(&session.data.cleanup_list);
+  session->data.command = cmd;
+  session->data.parameter = para;
 
-  result = _telnet_handle_command(&session.data);
-  _call_stop_handler(&session.data);
+  return _telnet_handle_command(&session->data);
+}
+
+/**
+ * Cleanup a telnet session initialized by oonf_telnet_session_init()
+ * @param session pointer to telnet session
+ */
+void
+oonf_telnet_session_cleanup(struct oonf_telnet_session *session) {
+  struct oonf_telnet_cleanup *handler, *it;
+
+  _call_stop_handler(&session->data);
 
   /* call all cleanup handlers */
-  list_for_each_element_safe(&session.data.cleanup_list, handler, node, it) {
+  list_for_each_element_safe(&session->data.cleanup_list, handler, node, it) {
     /* remove from list first */
     oonf_telnet_remove_cleanup(handler);
 
     /* after this command the handler pointer might not be valid anymore */
     handler->cleanup_handler(handler);
   }
+}
 
-  return abuf_has_failed(session.data.out) ? TELNET_RESULT_INTERNAL_ERROR : result;
+/**
+ * Generate the next chunk of a streamed telnet command output.
+ * The stream is stopped automatically when it is complete.
+ * @param data pointer to telnet data
+ * @return TELNET_RESULT_CONTINOUS if more output will follow,
+ *   TELNET_RESULT_ACTIVE if the output is complete,
+ *   TELNET_RESULT_INTERNAL_ERROR if an error happened
+ */
+enum oonf_telnet_result
+oonf_telnet_stream_next(struct oonf_telnet_data *data) {
+  enum oonf_telnet_result result;
+  size_t len;
+
+  if (!oonf_telnet_is_streaming(data)) {
+    return TELNET_RESULT_ACTIVE;
+  }
+
+  len = abuf_getlen(data->out);
+  do {
+    data->_stream_chunk_start = len;
+    result = data->stream_handler(data);
+  } while (result == TELNET_RESULT_CONTINOUS && abuf_getlen(data->out) == len);
+
+  if (abuf_has_failed(data->out)) {
+    result = TELNET_RESULT_INTERNAL_ERROR;
+  }
+  if (result != TELNET_RESULT_CONTINOUS) {
+    _stop_stream(data);
+  }
+  return result;
 }
 
 /**
@@ -374,6 +459,8 @@ static void
 _call_stop_handler(struct oonf_telnet_data *data) {
   void (*stop_handler)(struct oonf_telnet_data *);
 
+  _stop_stream(data);
+
   if (data->stop_handler) {
     /*
      * make sure that stop_handler is not set anymore when
@@ -387,6 +474,45 @@ _call_stop_handler(struct oonf_telnet_data *data) {
   }
 }
 
+/**
+ * Stop a streamed telnet command output
+ * @param data pointer to telnet data
+ */
+static void
+_stop_stream(struct oonf_telnet_data *data) {
+  void (*stream_cleanup)(struct oonf_telnet_data *);
+
+  if (!oonf_telnet_is_streaming(data)) {
+    return;
+  }
+
+  stream_cleanup = data->stream_cleanup;
+
+  data->stream_handler = NULL;
+  data->stream_cleanup = NULL;
+
+  if (stream_cleanup) {
+    stream_cleanup(data);
+  }
+  data->stream_data = NULL;
+}
+
+/**
+ * Generate the complete output of a streamed telnet command
+ * @param data pointer to telnet data
+ * @return telnet result of the stream
+ */
+static enum oonf_telnet_result
+_drain_stream(struct oonf_telnet_data *data) {
+  enum oonf_telnet_result result;
+
+  do {
+    result = oonf_telnet_stream_next(data);
+  } while (result == TELNET_RESULT_CONTINOUS);
+
+  return result;
+}
+
 /**
  * Handler for receiving data from telnet session
  * @param session pointer to TCP session
@@ -408,6 +534,11 @@ _cb_telnet_receive_data(struct oonf_stream_session *session) {
   while (abuf_getlen(&session->in) > 0) {
     char *para = NULL, *cmd = NULL, *next = NULL;
 
+    if (oonf_telnet_is_streaming(&telnet_session->data)) {
+      /* keep the next command line queued until the running stream is complete */
+      break;
+    }
+
     /* search for end of line */
     eol = memchr(abuf_getptr(&session->in), '\n', abuf_getlen(&session->in));
     if (eol) {
@@ -453,6 +584,11 @@ _cb_telnet_receive_data(struct oonf_stream_session *session) {
         *para++ = 0;
       }
 
+      if (chainCommands && oonf_telnet_is_streaming(&telnet_session->data)) {
+        /* finish output of the last command before executing the next one */
+        _drain_stream(&telnet_session->data);
+      }
+
       /* if we are doing continous output, stop it ! */
       _call_stop_handler(&telnet_session->data);
 
@@ -523,6 +659,47 @@ _cb_telnet_receive_data(struct oonf_stream_session *session) {
   return STREAM_SESSION_ACTIVE;
 }
 
+/**
+ * Handler for an empty output buffer of a telnet session, used
+ * to generate the next chunk of a streamed command output
+ * @param session pointer to TCP session
+ * @return TCP session state
+ */
+static enum oonf_stream_session_state
+_cb_telnet_buffer_underrun(struct oonf_stream_session *session) {
+  struct oonf_telnet_session *telnet_session;
+  enum oonf_telnet_result result;
+
+  /* get telnet session pointer */
+  telnet_session = (struct oonf_telnet_session *)session;
+
+  if (!oonf_telnet_is_streaming(&telnet_session->data)) {
+    return session->state;
+  }
+
+  result = oonf_telnet_stream_next(&telnet_session->data);
+  if (result == TELNET_RESULT_CONTINOUS) {
+    return session->state;
+  }
+
+  if (result != TELNET_RESULT_ACTIVE) {
+    abuf_clear(&session->out);
+    abuf_appendf(&session->out, "Error in autobuffer during command '%s'.\n", telnet_session->data.command);
+  }
+
+  if (session->state == STREAM_SESSION_ACTIVE) {
+    /* stream is complete, print prompt */
+    telnet_session->data.show_echo = true;
+    abuf_puts(&session->out, "\n> ");
+
+    if (abuf_getlen(&session->in) > 0) {
+      /* handle command lines that arrived while the stream was running */
+      return _cb_telnet_receive_data(session);
+    }
+  }
+  return session->state;
+}
+
 /**
  * Helper function to call telnet command handler
  * @param data pointer to telnet data
@@ -666,6 +843,24 @@ _cb_telnet_repeat_stophandler(struct oonf_telnet_data *data) {
   data->stop_data[2] = NULL;
 }
 
+/**
+ * Call the command of a repeat telnet command, a streamed output
+ * is generated completely because the repeat command uses
+ * the stop handler of the session.
+ * @param data pointer to telnet data
+ * @return telnet command result
+ */
+static enum oonf_telnet_result
+_handle_repeated_command(struct oonf_telnet_data *data) {
+  enum oonf_telnet_result result;
+
+  result = _telnet_handle_command(data);
+  if (result == TELNET_RESULT_CONTINOUS && oonf_telnet_is_streaming(data)) {
+    result = _drain_stream(data);
+  }
+  return result;
+}
+
 /**
  * Timer event handler for repeating telnet commands
  * @param ptr timer instance that fired
@@ -681,7 +876,7 @@ _cb_telnet_repeat_timer(struct oonf_timer_instance *ptr) {
   telnet_data->command = telnet_data->stop_data[1];
   telnet_data->parameter = telnet_data->stop_data[2];
 
-  if (_telnet_handle_command(telnet_data) != TELNET_RESULT_ACTIVE) {
+  if (_handle_repeated_command(telnet_data) != TELNET_RESULT_ACTIVE) {
     _call_stop_handler(telnet_data);
   }
 
@@ -737,7 +932,7 @@ _cb_telnet_repeat(struct oonf_telnet_data *data) {
   data->command = data->stop_data[1];
   data->parameter = data->stop_data[2];
 
-  if (_telnet_handle_command(data) != TELNET_RESULT_ACTIVE) {
+  if (_handle_repeated_command(data) != TELNET_RESULT_ACTIVE) {
     _call_stop_handler(data);
   }
 
@@ -49,15 +49,35 @@
 #include <oonf/libcommon/json.h>
 #include <oonf/libcommon/template.h>
 #include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_class.h>
 #include <oonf/base/oonf_telnet.h> /* compile-time dependency */
 
 /* Definitions */
 #define LOG_VIEWER _oonf_viewer_subsystem.logging
 
+/**
+ * State of a streamed viewer output
+ */
+struct _viewer_stream {
+  /*! copy of the viewer template used for the stream */
+  struct oonf_viewer_template template;
+
+  /*! template storage of the stream */
+  struct abuf_template_storage storage;
+
+  /*! copy of the custom format string, NULL if not set */
+  char *format;
+};
+
 /* static function prototypes */
 static int _init(void);
 static void _cleanup(void);
 
+static struct oonf_viewer_template *_parse_subcommand(const char *param, struct oonf_viewer_template *templates,
+  size_t count, const char **format, bool *head);
+static enum oonf_telnet_result _cb_stream_handler(struct oonf_telnet_data *con);
+static void _cb_stream_cleanup(struct oonf_telnet_data *con);
+
 /* Template call help text for telnet */
 static const char _telnet_help[] = "\n"
                                    "Use '" OONF_VIEWER_JSON_FORMAT "' as the first parameter"
@@ -72,9 +92,21 @@ static const char _telnet_help[] = "\n"
                                    "You can also add a custom template (text with keys inside)"
                                    " as the last parameter instead.\n";
 
+/* memory class for streamed output */
+static struct oonf_class _stream_class = {
+  .name = "viewer stream",
+  .size = sizeof(struct _viewer_stream),
+};
+
 /* subsystem definition */
+static const char *_dependencies[] = {
+  OONF_CLASS_SUBSYSTEM,
+};
+
 static struct oonf_subsystem _oonf_viewer_subsystem = {
   .name = OONF_VIEWER_SUBSYSTEM,
+  .dependencies = _dependencies,
+  .dependencies_count = ARRAYSIZE(_dependencies),
   .init = _init,
   .cleanup = _cleanup,
 };
@@ -86,6 +118,7 @@ DECLARE_OONF_PLUGIN(_oonf_viewer_subsystem);
  */
 static int
 _init(void) {
+  oonf_class_add(&_stream_class);
   return 0;
 }
 
@@ -93,7 +126,9 @@ _init(void) {
  * Cleanup all allocated data of telnet subsystem
  */
 static void
-_cleanup(void) {}
+_cleanup(void) {
+  oonf_class_remove(&_stream_class);
+}
 
 /**
  * Prepare a viewer template for output. The create_json and
@@ -231,62 +266,29 @@ oonf_viewer_print_help(
 int
 oonf_viewer_call_subcommands(struct autobuf *out, struct abuf_template_storage *storage, const char *param,
   struct oonf_viewer_template *templates, size_t count) {
-  const char *next = NULL, *ptr = NULL;
+  struct oonf_viewer_template *template;
+  const char *format;
   int result = 0;
-  size_t i;
-  bool head = false;
-  bool json = false;
-  bool raw = false;
-  bool data = false;
+  bool head;
 
-  if ((next = str_hasnextword(param, OONF_VIEWER_HEAD_FORMAT))) {
-    head = true;
-  }
-  else if ((next = str_hasnextword(param, OONF_VIEWER_JSON_FORMAT))) {
-    json = true;
-  }
-  else if ((next = str_hasnextword(param, OONF_VIEWER_RAW_FORMAT))) {
-    raw = true;
+  template = _parse_subcommand(param, templates, count, &format, &head);
+  if (!template) {
+    return 1;
   }
-  else if ((next = str_hasnextword(param, OONF_VIEWER_JSON_RAW_FORMAT))) {
-    json = true;
-    raw = true;
-  }
-  else if ((next = str_hasnextword(param, OONF_VIEWER_DATA_FORMAT))) {
-    json = true;
-    data = true;
-  }
-  else if ((next = str_hasnextword(param, OONF_VIEWER_DATA_RAW_FORMAT))) {
-    json = true;
-    raw = true;
-    data = true;
+
+  oonf_viewer_output_prepare(template, storage, out, format);
+
+  if (head) {
+    abuf_add_template(out, template->_storage, true);
+    abuf_puts(out, "\n");
   }
   else {
-    next = param;
+    result = template->cb_function(template);
   }
 
-  for (i = 0; i < count; i++) {
-    if ((ptr = str_hasnextword(next, templates[i].json_name))) {
-      templates[i].create_json = json;
-      templates[i].create_raw = raw;
-      templates[i].create_only_data = data;
-
-      oonf_viewer_output_prepare(&templates[i], storage, out, ptr);
+  oonf_viewer_output_finish(template);
 
-      if (head) {
-        abuf_add_template(out, templates[i]._storage, true);
-        abuf_puts(out, "\n");
-      }
-      else {
-        result = templates[i].cb_function(&templates[i]);
-      }
-
-      oonf_viewer_output_finish(&templates[i]);
-
-      return result;
-    }
-  }
-  return 1;
+  return result;
 }
 
 /**
@@ -347,3 +349,187 @@ oonf_viewer_telnet_help(
 
   return TELNET_RESULT_ACTIVE;
 }
+
+/**
+ * Handles a telnet command for a viewer and streams the output
+ * of templates with a stream callback in chunks to the telnet
+ * session. Templates without a stream callback are handled
+ * like oonf_viewer_telnet_handler().
+ * @param con telnet session data
+ * @param storage template storage object for non-streamed output
+ * @param cmd telnet command
+ * @param templates template viewer array
+ * @param count number of template viewer entries
+ * @return telnet return code
+ */
+enum oonf_telnet_result
+oonf_viewer_telnet_stream(struct oonf_telnet_data *con, struct abuf_template_storage *storage, const char *cmd,
+  struct oonf_viewer_template *templates, size_t count) {
+  struct oonf_viewer_template *template;
+  struct _viewer_stream *stream;
+  const char *format;
+  bool head;
+
+  template = NULL;
+  if (con->parameter != NULL && *con->parameter != 0) {
+    template = _parse_subcommand(con->parameter, templates, count, &format, &head);
+  }
+  if (!template || head || !template->cb_stream) {
+    return oonf_viewer_telnet_handler(con->out, storage, cmd, con->parameter, templates, count);
+  }
+
+  stream = oonf_class_malloc(&_stream_class);
+  if (!stream) {
+    return TELNET_RESULT_INTERNAL_ERROR;
+  }
+
+  /* the stream needs its own copy of the template and the format */
+  memcpy(&stream->template, template, sizeof(*template));
+  memset(&stream->template.cursor, 0, sizeof(stream->template.cursor));
+  if (format && *format) {
+    stream->format = strdup(format);
+    if (!stream->format) {
+      oonf_class_free(&_stream_class, stream);
+      return TELNET_RESULT_INTERNAL_ERROR;
+    }
+  }
+
+  oonf_viewer_output_prepare(&stream->template, &stream->storage, con->out, stream->format);
+
+  con->stream_handler = _cb_stream_handler;
+  con->stream_cleanup = _cb_stream_cleanup;
+  con->stream_data = stream;
+
+  /* generate first chunk directly, small outputs will be finished here */
+  return oonf_telnet_stream_next(con);
+}
+
+/**
+ * Get the next node of a tree for a streamed viewer output and
+ * store its key in the cursor. The tree must not contain
+ * duplicate keys.
+ * @param tree pointer to avl tree
+ * @param cursor pointer to stream cursor
+ * @param key_size size of the key of the tree
+ * @return next node of the tree, NULL if end of tree
+ */
+struct avl_node *
+oonf_viewer_stream_next_node(struct avl_tree *tree, struct oonf_viewer_cursor *cursor, size_t key_size) {
+  struct avl_node *node;
+
+  if (avl_is_empty(tree)) {
+    return NULL;
+  }
+
+  if (!cursor->valid) {
+    node = list_first_element(&tree->list_head, node, list);
+  }
+  else {
+    /* the last printed node might have been removed in the meantime */
+    node = avl_find_greaterequal(tree, &cursor->key);
+    if (node != NULL && tree->comp(node->key, &cursor->key) == 0) {
+      node = avl_is_last(tree, node) ? NULL : list_next_element(node, list);
+    }
+  }
+
+  if (node) {
+    memcpy(&cursor->key, node->key, key_size);
+    cursor->valid = true;
+  }
+  return node;
+}
+
+/**
+ * Parse the parameter of a viewer telnet call
+ * @param param parameter of telnet call
+ * @param templates pointer to array of viewer templates
+ * @param count number of elements in viewer template array
+ * @param format pointer to custom format string, set by this function
+ * @param head pointer to head flag, set by this function
+ * @return selected template with initialized format flags,
+ *   NULL if no template was selected
+ */
+static struct oonf_viewer_template *
+_parse_subcommand(const char *param, struct oonf_viewer_template *templates, size_t count, const char **format,
+  bool *head) {
+  const char *next = NULL, *ptr = NULL;
+  size_t i;
+  bool json = false;
+  bool raw = false;
+  bool data = false;
+
+  *head = false;
+
+  if ((next = str_hasnextword(param, OONF_VIEWER_HEAD_FORMAT))) {
+    *head = true;
+  }
+  else if ((next = str_hasnextword(param, OONF_VIEWER_JSON_FORMAT))) {
+    json = true;
+  }
+  else if ((next = str_hasnextword(param, OONF_VIEWER_RAW_FORMAT))) {
+    raw = true;
+  }
+  else if ((next = str_hasnextword(param, OONF_VIEWER_JSON_RAW_FORMAT))) {
+    json = true;
+    raw = true;
+  }
+  else if ((next = str_hasnextword(param, OONF_VIEWER_DATA_FORMAT))) {
+    json = true;
+    data = true;
+  }
+  else if ((next = str_hasnextword(param, OONF_VIEWER_DATA_RAW_FORMAT))) {
+    json = true;
+    raw = true;
+    data = true;
+  }
+  else {
+    next = param;
+  }
+
+  for (i = 0; i < count; i++) {
+    if ((ptr = str_hasnextword(next, templates[i].json_name))) {
+      templates[i].create_json = json;
+      templates[i].create_raw = raw;
+      templates[i].create_only_data = data;
+
+      *format = ptr;
+      return &templates[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Generate the next chunk of a streamed viewer output
+ * @param con telnet session data
+ * @return telnet return code
+ */
+static enum oonf_telnet_result
+_cb_stream_handler(struct oonf_telnet_data *con) {
+  struct _viewer_stream *stream = con->stream_data;
+  int result;
+
+  stream->template._chunk_start = abuf_getlen(con->out);
+  result = stream->template.cb_stream(&stream->template);
+  if (result < 0) {
+    return TELNET_RESULT_INTERNAL_ERROR;
+  }
+  if (result > 0) {
+    return TELNET_RESULT_CONTINOUS;
+  }
+
+  oonf_viewer_output_finish(&stream->template);
+  return TELNET_RESULT_ACTIVE;
+}
+
+/**
+ * Free the state of a streamed viewer output
+ * @param con telnet session data
+ */
+static void
+_cb_stream_cleanup(struct oonf_telnet_data *con) {
+  struct _viewer_stream *stream = con->stream_data;
+
+  free(stream->format);
+  oonf_class_free(&_stream_class, stream);
+}
@@ -345,7 +345,7 @@ os_interface_linux_add(struct os_interface_listener *if_listener) {
   }
 
   /* trigger interface change listener if necessary */
-  if_listener->_dirty = true;
+  if_listener->changes = OS_INTERFACE_CHANGE_ALL;
   oonf_timer_start(&data->_change_timer, 200);
 
   return data;
@@ -396,7 +396,7 @@ os_interface_linux_get_tree(void) {
  */
 void
 os_interface_linux_trigger_handler(struct os_interface_listener *if_listener) {
-  if_listener->_dirty = true;
+  if_listener->changes |= OS_INTERFACE_CHANGE_TRIGGER;
   if (!oonf_timer_is_active(&if_listener->data->_change_timer)) {
     oonf_timer_start(&if_listener->data->_change_timer, OS_INTERFACE_CHANGE_TRIGGER_INTERVAL);
   }
@@ -839,21 +839,29 @@ _os_linux_writeToFile(const char *file, char *old, char value) {
 }
 
 /**
- * Trigger all change listeners of a network interface
+ * Trigger all change listeners of a network interface that are
+ * interested in at least one of the changes
  * @param os_if network interface
+ * @param changes bitmask of os_interface_change values
  */
 static void
-_trigger_if_change(struct os_interface *os_if) {
+_trigger_if_change(struct os_interface *os_if, uint32_t changes) {
   struct os_interface_listener *if_listener;
+  uint32_t mask;
+  bool triggered;
+
+  triggered = false;
+  list_for_each_element(&os_if->_listeners, if_listener, _node) {
+    mask = if_listener->change_mask ? if_listener->change_mask : OS_INTERFACE_CHANGE_ALL;
+    if (changes & mask) {
+      if_listener->changes |= (changes & mask);
+      triggered = true;
+    }
+  }
 
-  if (!oonf_timer_is_active(&os_if->_change_timer)) {
+  if (triggered && !oonf_timer_is_active(&os_if->_change_timer)) {
     /* inform listeners the interface changed */
     oonf_timer_start(&os_if->_change_timer, 200);
-
-    list_for_each_element(&os_if->_listeners, if_listener, _node) {
-      /* each interface should be informed */
-      if_listener->_dirty = true;
-    }
   }
 }
 
@@ -861,14 +869,15 @@ _trigger_if_change(struct os_interface *os_if) {
  * Trigger all change listeners of a network interface.
  * Trigger also all change listeners of the wildcard interface "any"
  * @param os_if network interface
+ * @param changes bitmask of os_interface_change values
  */
 static void
-_trigger_if_change_including_any(struct os_interface *os_if) {
-  _trigger_if_change(os_if);
+_trigger_if_change_including_any(struct os_interface *os_if, uint32_t changes) {
+  _trigger_if_change(os_if, changes);
 
   os_if = avl_find_element(&_interface_data_tree, OS_INTERFACE_ANY, os_if, _node);
   if (os_if) {
-    _trigger_if_change(os_if);
+    _trigger_if_change(os_if, changes);
   }
 }
 
@@ -884,8 +893,10 @@ _link_parse_nlmsg(const char *ifname, struct nlmsghdr *msg) {
   int ifi_len;
   struct netaddr addr;
   struct os_interface *ifdata;
+  struct os_interface_flags old_flags;
+  unsigned old_index, old_base_index;
+  uint32_t changes;
   int iflink;
-  bool old_up;
 #if defined(OONF_LOG_DEBUG_INFO)
   struct netaddr_str nbuf;
 #endif
@@ -899,7 +910,11 @@ _link_parse_nlmsg(const char *ifname, struct nlmsghdr *msg) {
     return;
   }
 
-  old_up = ifdata->flags.up;
+  memcpy(&old_flags, &ifdata->flags, sizeof(old_flags));
+  old_index = ifdata->index;
+  old_base_index = ifdata->base_index;
+  changes = 0;
+
   ifdata->flags.up = (ifi_msg->ifi_flags & IFF_UP) != 0;
   ifdata->flags.promisc = (ifi_msg->ifi_flags & IFF_PROMISC) != 0;
   ifdata->flags.pointtopoint = (ifi_msg->ifi_flags & IFF_POINTOPOINT) != 0;
@@ -913,7 +928,7 @@ _link_parse_nlmsg(const char *ifname, struct nlmsghdr *msg) {
   ifdata->index = ifi_msg->ifi_index;
   ifdata->base_index = ifdata->index;
 
-  if (!old_up && ifdata->flags.up && ifdata->flags.mesh && !ifdata->_internal.ignore_mesh) {
+  if (!old_flags.up && ifdata->flags.up && ifdata->flags.mesh && !ifdata->_internal.ignore_mesh) {
     /* refresh mesh parameters, might be gone for LTE-sticks */
     _refresh_mesh(ifdata, NULL, NULL);
   }
@@ -923,8 +938,16 @@ _link_parse_nlmsg(const char *ifname, struct nlmsghdr *msg) {
         netaddr_from_binary(&addr, RTA_DATA(ifi_attr), RTA_PAYLOAD(ifi_attr), AF_MAC48);
         OONF_DEBUG(LOG_OS_INTERFACE, "Link: %s", netaddr_to_string(&nbuf, &addr));
 
-        if (msg->nlmsg_type == RTM_NEWLINK) {
+        if (msg->nlmsg_type == RTM_NEWLINK && netaddr_cmp(&ifdata->mac, &addr) != 0) {
           memcpy(&ifdata->mac, &addr, sizeof(addr));
+          changes |= OS_INTERFACE_CHANGE_MAC;
+        }
+        break;
+      case IFLA_MTU:
+        if (msg->nlmsg_type == RTM_NEWLINK && RTA_PAYLOAD(ifi_attr) == sizeof(ifdata->mtu) &&
+            memcmp(&ifdata->mtu, RTA_DATA(ifi_attr), sizeof(ifdata->mtu)) != 0) {
+          memcpy(&ifdata->mtu, RTA_DATA(ifi_attr), sizeof(ifdata->mtu));
+          changes |= OS_INTERFACE_CHANGE_MTU;
         }
         break;
       case IFLA_LINK:
@@ -939,11 +962,27 @@ _link_parse_nlmsg(const char *ifname, struct nlmsghdr *msg) {
     }
   }
 
+  if (old_flags.up != ifdata->flags.up) {
+    changes |= OS_INTERFACE_CHANGE_STATE;
+  }
+  if (old_flags.promisc != ifdata->flags.promisc || old_flags.pointtopoint != ifdata->flags.pointtopoint ||
+      old_flags.loopback != ifdata->flags.loopback || old_flags.unicast_only != ifdata->flags.unicast_only) {
+    changes |= OS_INTERFACE_CHANGE_FLAGS;
+  }
+  if (old_index != ifdata->index || old_base_index != ifdata->base_index) {
+    changes |= OS_INTERFACE_CHANGE_INDEX;
+  }
+
   if (!ifdata->_link_initialized) {
     ifdata->_link_initialized = true;
+    changes |= OS_INTERFACE_CHANGE_LINK;
     OONF_INFO(LOG_OS_INTERFACE, "Interface %s link data initialized", ifdata->name);
   }
-  _trigger_if_change_including_any(ifdata);
+
+  if (changes) {
+    OONF_DEBUG(LOG_OS_INTERFACE, "Link changes of %s: 0x%x", ifdata->name, changes);
+    _trigger_if_change_including_any(ifdata, changes);
+  }
 }
 
 /**
@@ -1002,8 +1041,9 @@ _update_address_shortcuts(struct os_interface *os_if) {
  * @param os_if network interface
  * @param prefixed_addr full IP address with prefix length
  * @param peer true if this is a peer address, false otherwise
+ * @return true if the address was not known before, false otherwise
  */
-static void
+static bool
 _add_address(struct os_interface *os_if, struct netaddr *prefixed_addr, bool peer) {
   struct os_interface_ip *ip;
   struct avl_tree *tree;
@@ -1014,20 +1054,23 @@ _add_address(struct os_interface *os_if, struct netaddr *prefixed_addr, bool pee
   tree = peer ? &os_if->peers : &os_if->addresses;
 
   ip = avl_find_element(tree, prefixed_addr, ip, _node);
+  if (ip) {
+    /* nothing to do */
+    return false;
+  }
+
+  ip = oonf_class_malloc(&_interface_ip_class);
   if (!ip) {
-    ip = oonf_class_malloc(&_interface_ip_class);
-    if (!ip) {
-      return;
-    }
+    return false;
+  }
 
-    /* establish key and add to tree */
-    memcpy(&ip->prefixed_addr, prefixed_addr, sizeof(*prefixed_addr));
-    ip->_node.key = &ip->prefixed_addr;
-    avl_insert(tree, &ip->_node);
+  /* establish key and add to tree */
+  memcpy(&ip->prefixed_addr, prefixed_addr, sizeof(*prefixed_addr));
+  ip->_node.key = &ip->prefixed_addr;
+  avl_insert(tree, &ip->_node);
 
-    /* add back pointer */
-    ip->interf = os_if;
-  }
+  /* add back pointer */
+  ip->interf = os_if;
 
   OONF_INFO(LOG_OS_INTERFACE, "Add address to %s%s: %s", os_if->name, peer ? " (peer)" : "",
     netaddr_to_string(&nbuf, prefixed_addr));
@@ -1036,6 +1079,7 @@ _add_address(struct os_interface *os_if, struct netaddr *prefixed_addr, bool pee
   memcpy(&ip->address, prefixed_addr, sizeof(*prefixed_addr));
   netaddr_set_prefix_length(&ip->address, netaddr_get_maxprefix(&ip->address));
   netaddr_truncate(&ip->prefix, prefixed_addr);
+  return true;
 }
 
 /**
@@ -1043,8 +1087,9 @@ _add_address(struct os_interface *os_if, struct netaddr *prefixed_addr, bool pee
  * @param os_if network interface
  * @param prefixed_addr full IP address with prefix length
  * @param peer true if this is a peer address, false otherwise
+ * @return true if the address was removed, false if it was not known
  */
-static void
+static bool
 _remove_address(struct os_interface *os_if, struct netaddr *prefixed_addr, bool peer) {
   struct os_interface_ip *ip;
   struct avl_tree *tree;
@@ -1055,7 +1100,7 @@ _remove_address(struct os_interface *os_if, struct netaddr *prefixed_addr, bool
   tree = peer ? &os_if->peers : &os_if->addresses;
   ip = avl_find_element(tree, prefixed_addr, ip, _node);
   if (!ip) {
-    return;
+    return false;
   }
 
   OONF_INFO(LOG_OS_INTERFACE, "Remove address from %s%s: %s", os_if->name, peer ? " (peer)" : "",
@@ -1063,6 +1108,7 @@ _remove_address(struct os_interface *os_if, struct netaddr *prefixed_addr, bool
 
   avl_remove(tree, &ip->_node);
   oonf_class_free(&_interface_ip_class, ip);
+  return true;
 }
 
 /**
@@ -1077,7 +1123,7 @@ _address_parse_nlmsg(const char *ifname, struct nlmsghdr *msg) {
   int ifa_len;
   struct os_interface *ifdata;
   struct netaddr ifa_local, ifa_address;
-  bool update;
+  uint32_t changes;
 
   ifa_msg = NLMSG_DATA(msg);
   ifa_attr = IFA_RTA(ifa_msg);
@@ -1090,7 +1136,7 @@ _address_parse_nlmsg(const char *ifname, struct nlmsghdr *msg) {
 
   OONF_DEBUG(LOG_OS_INTERFACE, "Parse IFA_GETADDR %s (%u) (len=%u)", ifname, ifa_msg->ifa_index, ifa_len);
 
-  update = false;
+  changes = 0;
   netaddr_invalidate(&ifa_local);
   netaddr_invalidate(&ifa_address);
 
@@ -1116,33 +1162,41 @@ _address_parse_nlmsg(const char *ifname, struct nlmsghdr *msg) {
 
   if (!netaddr_is_unspec(&ifa_local)) {
     if (msg->nlmsg_type == RTM_NEWADDR) {
-      _add_address(ifdata, &ifa_local, false);
+      if (_add_address(ifdata, &ifa_local, false)) {
+        changes |= netaddr_get_address_family(&ifa_local) == AF_INET ? OS_INTERFACE_CHANGE_IPV4_ADDED
+                                                                    : OS_INTERFACE_CHANGE_IPV6_ADDED;
+      }
     }
-    else {
-      _remove_address(ifdata, &ifa_local, false);
+    else if (_remove_address(ifdata, &ifa_local, false)) {
+      changes |= netaddr_get_address_family(&ifa_local) == AF_INET ? OS_INTERFACE_CHANGE_IPV4_REMOVED
+                                                                  : OS_INTERFACE_CHANGE_IPV6_REMOVED;
     }
 
-    _update_address_shortcuts(ifdata);
-    update = true;
+    if (changes) {
+      _update_address_shortcuts(ifdata);
+    }
   }
 
   if (netaddr_cmp(&ifa_local, &ifa_address)) {
     if (msg->nlmsg_type == RTM_NEWADDR) {
-      _add_address(ifdata, &ifa_address, true);
+      if (_add_address(ifdata, &ifa_address, true)) {
+        changes |= OS_INTERFACE_CHANGE_PEER;
+      }
     }
-    else {
-      _remove_address(ifdata, &ifa_address, true);
+    else if (_remove_address(ifdata, &ifa_address, true)) {
+      changes |= OS_INTERFACE_CHANGE_PEER;
     }
+  }
 
-    update = true;
+  if (!netaddr_is_unspec(&ifa_local) && !ifdata->_addr_initialized) {
+    ifdata->_addr_initialized = true;
+    changes |= OS_INTERFACE_CHANGE_ADDRESS;
+    OONF_INFO(LOG_OS_INTERFACE, "Interface %s address data initialized", ifdata->name);
   }
 
-  if (update) {
-    if (!ifdata->_addr_initialized) {
-      ifdata->_addr_initialized = true;
-      OONF_INFO(LOG_OS_INTERFACE, "Interface %s address data initialized", ifdata->name);
-    }
-    _trigger_if_change_including_any(ifdata);
+  if (changes) {
+    OONF_DEBUG(LOG_OS_INTERFACE, "Address changes of %s: 0x%x", ifdata->name, changes);
+    _trigger_if_change_including_any(ifdata, changes);
   }
 }
 
@@ -1237,7 +1291,7 @@ _cb_delayed_interface_changed(struct oonf_timer_instance *timer) {
 
   error = false;
   list_for_each_element_safe(&data->_listeners, interf, _node, interf_it) {
-    if (!interf->_dirty) {
+    if (!interf->changes) {
       continue;
     }
 
@@ -1247,7 +1301,7 @@ _cb_delayed_interface_changed(struct oonf_timer_instance *timer) {
     }
     else {
       /* everything fine, job done */
-      interf->_dirty = false;
+      interf->changes = 0;
     }
   }
 
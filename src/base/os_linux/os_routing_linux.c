@@ -51,6 +51,10 @@
 #include <linux/rtnetlink.h>
 #include <sys/uio.h>
 
+#ifdef RTM_NEWNEXTHOP
+#include <linux/nexthop.h>
+#endif
+
 #include <oonf/oonf.h>
 #include <oonf/libcommon/avl.h>
 #include <oonf/libcommon/avl_comp.h>
@@ -63,6 +67,9 @@
 /* Definitions */
 #define LOG_OS_ROUTING _oonf_os_routing_subsystem.logging
 
+/*! first kernel id used for nexthop objects, far away from manually configured ids */
+#define NEXTHOP_ID_FIRST 0x10000000
+
 /**
  * Array to translate between OONF route types and internal kernel types
  */
@@ -79,8 +86,12 @@ static int _init(void);
 static void _cleanup(void);
 
 static int _routing_set(struct os_system_netlink_message *msg, struct os_route *route, unsigned char rt_scope);
+static int _routing_add_multipath(struct os_system_netlink_message *nl_msg, struct os_route *route);
+static void _routing_parse_multipath(struct os_route *route, struct rtattr *rt_attr);
 
 static void _routing_finished(struct os_route *route, int error);
+static void _nexthop_finished(struct os_route_nexthop *nexthop, int error);
+static bool _is_nexthop_message(struct os_system_netlink_message *nl_msg);
 static void _cb_rtnetlink_response(struct os_system_netlink_message *msg, struct nlmsghdr *header);
 static void _cb_rtnetlink_multicast(struct os_system_netlink *nl, struct nlmsghdr *header);
 static void _cb_rtnetlink_error(struct os_system_netlink_message *nl_msg);
@@ -146,6 +157,11 @@ static const struct os_route_parameter OS_ROUTE_WILDCARD = { .family = AF_UNSPEC
 
 /* kernel version check */
 static bool _is_kernel_3_11_0_or_better;
+static bool _is_kernel_5_3_0_or_better;
+
+/* tree of kernel nexthop objects with an allocated id */
+static struct avl_tree _nexthop_tree;
+static uint32_t _next_nexthop_id = NEXTHOP_ID_FIRST;
 
 /**
  * Initialize routing subsystem
@@ -158,8 +174,10 @@ _init(void) {
   }
  
   list_init_head(&_rtnetlink_listener);
+  avl_init(&_nexthop_tree, avl_comp_uint32, false);
 
   _is_kernel_3_11_0_or_better = os_system_linux_is_minimal_kernel(3, 11, 0);
+  _is_kernel_5_3_0_or_better = os_system_linux_is_minimal_kernel(5, 3, 0);
   return 0;
 }
 
@@ -187,6 +205,19 @@ os_routing_linux_supports_source_specific(int af_family) {
   return _is_kernel_3_11_0_or_better;
 }
 
+/**
+ * Check if kernel supports nexthop objects
+ * @return true if routes can reference nexthop objects
+ */
+bool
+os_routing_linux_supports_nexthop_objects(void) {
+#ifdef RTM_NEWNEXTHOP
+  return _is_kernel_5_3_0_or_better;
+#else
+  return false;
+#endif
+}
+
 /**
  * Update an entry of the kernel routing table. This call will only trigger
  * the change, the real change will be done as soon as the netlink socket is
@@ -236,15 +267,18 @@ os_routing_linux_set(struct os_route *route, bool set, bool del_similar) {
     netaddr_invalidate(&os_rt.p.src_ip);
 
     if (del_similar) {
-      /* no interface necessary */
+      /* no interface, nexthop object or multipath next hops necessary */
       os_rt.p.if_index = 0;
+      os_rt.p.nexthop_id = 0;
+      os_rt.p.multipath_count = 0;
 
       /* as wildcard for fuzzy deletion */
       scope = RT_SCOPE_NOWHERE;
     }
   }
 
-  if (netaddr_is_unspec(&os_rt.p.gw) && netaddr_get_address_family(&os_rt.p.key.dst) == AF_INET &&
+  if (os_rt.p.nexthop_id == 0 && netaddr_is_unspec(&os_rt.p.gw) &&
+      netaddr_get_address_family(&os_rt.p.key.dst) == AF_INET &&
       netaddr_get_prefix_length(&os_rt.p.key.dst) == netaddr_get_maxprefix(&os_rt.p.key.dst)) {
     /* use destination as gateway, to 'force' linux kernel to do proper source address selection */
     memcpy(&os_rt.p.gw, &os_rt.p.key.dst, sizeof(os_rt.p.gw));
@@ -262,6 +296,118 @@ os_routing_linux_set(struct os_route *route, bool set, bool del_similar) {
   return 0;
 }
 
+/**
+ * Create, update or remove a kernel nexthop object. The nexthop
+ * gets an id when it is set for the first time, the id can be used
+ * by routes directly after this call.
+ * @param nexthop nexthop object
+ * @param set true if nexthop should be set, false if it should be removed
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+os_routing_linux_nexthop_set(struct os_route_nexthop *nexthop, bool set) {
+#ifdef RTM_NEWNEXTHOP
+  struct os_system_netlink_message *nl_msg;
+  struct nlmsghdr *msg;
+  struct nhmsg *nh_msg;
+  uint32_t if_index;
+#ifdef OONF_LOG_DEBUG_INFO
+  struct netaddr_str nbuf;
+#endif
+
+  if (!os_routing_linux_supports_nexthop_objects()) {
+    return -1;
+  }
+  if (nexthop->family != AF_INET && nexthop->family != AF_INET6) {
+    return -1;
+  }
+  if (set && netaddr_get_address_family(&nexthop->gw) != AF_UNSPEC &&
+      netaddr_get_address_family(&nexthop->gw) != nexthop->family) {
+    OONF_WARN(LOG_OS_ROUTING, "Got nexthop gateway with address family %d instead of %d",
+      netaddr_get_address_family(&nexthop->gw), nexthop->family);
+    return -1;
+  }
+
+  if (set && nexthop->id == 0) {
+    /* allocate unused kernel id */
+    while (_next_nexthop_id < NEXTHOP_ID_FIRST || avl_find(&_nexthop_tree, &_next_nexthop_id)) {
+      _next_nexthop_id = _next_nexthop_id < NEXTHOP_ID_FIRST ? NEXTHOP_ID_FIRST : _next_nexthop_id + 1;
+    }
+    nexthop->id = _next_nexthop_id++;
+    nexthop->_internal._node.key = &nexthop->id;
+    avl_insert(&_nexthop_tree, &nexthop->_internal._node);
+  }
+  if (nexthop->id == 0) {
+    /* nexthop was never set */
+    return 0;
+  }
+
+  /* only the latest state of the nexthop is interesting */
+  os_system_linux_netlink_interrupt(&nexthop->_internal.msg);
+
+  /* clear netlink buffer */
+  msg = (struct nlmsghdr *)&nexthop->_internal.nl_buffer[0];
+  memset(msg, 0, sizeof(nexthop->_internal.nl_buffer));
+
+  /* get pointers for netlink message */
+  nl_msg = &nexthop->_internal.msg;
+  nl_msg->message = msg;
+  nl_msg->max_length = sizeof(nexthop->_internal.nl_buffer);
+
+  msg->nlmsg_flags = NLM_F_REQUEST;
+  msg->nlmsg_len = NLMSG_LENGTH(sizeof(struct nhmsg));
+
+  nh_msg = NLMSG_DATA(msg);
+  nh_msg->nh_family = nexthop->family;
+
+  if (os_system_linux_netlink_addreq(nl_msg, NHA_ID, &nexthop->id, sizeof(nexthop->id))) {
+    return -1;
+  }
+
+  if (set) {
+    msg->nlmsg_flags |= NLM_F_CREATE | NLM_F_REPLACE;
+    msg->nlmsg_type = RTM_NEWNEXTHOP;
+    nh_msg->nh_protocol = nexthop->protocol;
+
+    if_index = nexthop->if_index;
+    if (os_system_linux_netlink_addreq(nl_msg, NHA_OIF, &if_index, sizeof(if_index))) {
+      return -1;
+    }
+    if (netaddr_get_address_family(&nexthop->gw) != AF_UNSPEC) {
+      nh_msg->nh_flags |= RTNH_F_ONLINK;
+      if (os_system_linux_netlink_addnetaddr(nl_msg, NHA_GATEWAY, &nexthop->gw)) {
+        return -1;
+      }
+    }
+  }
+  else {
+    msg->nlmsg_type = RTM_DELNEXTHOP;
+
+    /* release kernel id, routes using it are removed together with the nexthop */
+    avl_remove(&_nexthop_tree, &nexthop->_internal._node);
+  }
+
+  OONF_DEBUG(LOG_OS_ROUTING, "%s nexthop %u: gw %s if %u", set ? "set" : "remove", nexthop->id,
+    netaddr_to_string(&nbuf, &nexthop->gw), nexthop->if_index);
+
+  os_system_linux_netlink_send(&_rtnetlink_handler, nl_msg);
+  return 0;
+#else
+  return set ? -1 : 0;
+#endif
+}
+
+/**
+ * Stop processing of a nexthop command
+ * @param nexthop nexthop object
+ */
+void
+os_routing_linux_nexthop_interrupt(struct os_route_nexthop *nexthop) {
+  if (!os_system_linux_netlink_is_done(&nexthop->_internal.msg)) {
+    _nexthop_finished(nexthop, -1);
+  }
+}
+
 /**
  * Request all routing data of a certain address family
  * @param route pointer to routing filter
@@ -366,6 +512,35 @@ _routing_finished(struct os_route *route, int error) {
   }
 }
 
+/**
+ * Stop processing of a nexthop command and set error code
+ * for callback
+ * @param nexthop pointer to nexthop object
+ * @param error error code, 0 if no error
+ */
+static void
+_nexthop_finished(struct os_route_nexthop *nexthop, int error) {
+  /* remove first to prevent any kind of recursive cleanup */
+  os_system_linux_netlink_interrupt(&nexthop->_internal.msg);
+
+  if (nexthop->cb_finished) {
+    nexthop->cb_finished(nexthop, error);
+  }
+}
+
+/**
+ * @param nl_msg netlink message
+ * @return true if netlink message is a nexthop object command
+ */
+static bool
+_is_nexthop_message(struct os_system_netlink_message *nl_msg) {
+#ifdef RTM_NEWNEXTHOP
+  return nl_msg->message->nlmsg_type == RTM_NEWNEXTHOP || nl_msg->message->nlmsg_type == RTM_DELNEXTHOP;
+#else
+  return false;
+#endif
+}
+
 /**
  * Initiatize the an netlink routing message
  * @param msg pointer to netlink message header
@@ -438,7 +613,23 @@ _routing_set(struct os_system_netlink_message *nl_msg, struct os_route *route, u
     }
   }
 
-  if (netaddr_get_address_family(&route->p.gw) != AF_UNSPEC) {
+  if (route->p.multipath_count > 1) {
+    /* gateways and interfaces are part of the multipath attribute */
+    if (_routing_add_multipath(nl_msg, route)) {
+      return -1;
+    }
+  }
+  else if (route->p.nexthop_id != 0) {
+#ifdef RTM_NEWNEXTHOP
+    /* gateway and interface are part of the nexthop object */
+    if (os_system_linux_netlink_addreq(nl_msg, RTA_NH_ID, &route->p.nexthop_id, sizeof(route->p.nexthop_id))) {
+      return -1;
+    }
+#else
+    return -1;
+#endif
+  }
+  else if (netaddr_get_address_family(&route->p.gw) != AF_UNSPEC) {
     rt_msg->rtm_flags |= RTNH_F_ONLINK;
 
     /* add gateway */
@@ -472,7 +663,7 @@ _routing_set(struct os_system_netlink_message *nl_msg, struct os_route *route, u
     }
   }
 
-  if (route->p.if_index) {
+  if (route->p.if_index && route->p.nexthop_id == 0 && route->p.multipath_count <= 1) {
     /* add interface*/
     if (os_system_linux_netlink_addreq(nl_msg, RTA_OIF, &route->p.if_index, sizeof(route->p.if_index))) {
       return -1;
@@ -481,6 +672,92 @@ _routing_set(struct os_system_netlink_message *nl_msg, struct os_route *route, u
   return 0;
 }
 
+/**
+ * Add the next hops of a multipath route as a RTA_MULTIPATH attribute
+ * @param nl_msg netlink message
+ * @param route multipath route
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_routing_add_multipath(struct os_system_netlink_message *nl_msg, struct os_route *route) {
+  uint8_t buffer[OS_ROUTE_MAX_MULTIPATH * RTNH_ALIGN(sizeof(struct rtnexthop) + RTA_SPACE(16))];
+  const struct os_route_path *path;
+  struct rtnexthop *rtnh;
+  struct rtattr *rta;
+  size_t i, len, addr_len;
+
+  if (route->p.multipath_count > OS_ROUTE_MAX_MULTIPATH) {
+    return -1;
+  }
+
+  memset(buffer, 0, sizeof(buffer));
+  len = 0;
+  for (i = 0; i < route->p.multipath_count; i++) {
+    path = &route->p.multipath[i];
+
+    rtnh = (struct rtnexthop *)&buffer[len];
+    rtnh->rtnh_len = sizeof(*rtnh);
+    rtnh->rtnh_ifindex = path->if_index;
+    rtnh->rtnh_hops = path->weight > 0 ? path->weight - 1 : 0;
+
+    if (netaddr_get_address_family(&path->gw) != AF_UNSPEC) {
+      if (netaddr_get_address_family(&path->gw) != route->p.family) {
+        return -1;
+      }
+      addr_len = netaddr_get_maxprefix(&path->gw) / 8;
+
+      rtnh->rtnh_flags |= RTNH_F_ONLINK;
+
+      rta = RTNH_DATA(rtnh);
+      rta->rta_type = RTA_GATEWAY;
+      rta->rta_len = RTA_LENGTH(addr_len);
+      memcpy(RTA_DATA(rta), netaddr_get_binptr(&path->gw), addr_len);
+
+      rtnh->rtnh_len += RTA_SPACE(addr_len);
+    }
+    len += RTNH_ALIGN(rtnh->rtnh_len);
+  }
+
+  return os_system_linux_netlink_addreq(nl_msg, RTA_MULTIPATH, buffer, len);
+}
+
+/**
+ * Parse the next hops of a RTA_MULTIPATH attribute into an os_route object.
+ * The first next hop is also stored as gateway and interface of the route.
+ * @param route pointer to target os_route
+ * @param rt_attr pointer to multipath attribute
+ */
+static void
+_routing_parse_multipath(struct os_route *route, struct rtattr *rt_attr) {
+  struct os_route_path *path;
+  struct rtnexthop *rtnh;
+  struct rtattr *attr;
+  int len, attr_len;
+
+  rtnh = RTA_DATA(rt_attr);
+  len = RTA_PAYLOAD(rt_attr);
+
+  for (; RTNH_OK(rtnh, len) && route->p.multipath_count < OS_ROUTE_MAX_MULTIPATH;
+       len -= RTNH_ALIGN(rtnh->rtnh_len), rtnh = RTNH_NEXT(rtnh)) {
+    path = &route->p.multipath[route->p.multipath_count++];
+    path->if_index = rtnh->rtnh_ifindex;
+    path->weight = rtnh->rtnh_hops + 1;
+
+    attr = RTNH_DATA(rtnh);
+    attr_len = rtnh->rtnh_len - sizeof(*rtnh);
+    for (; RTA_OK(attr, attr_len); attr = RTA_NEXT(attr, attr_len)) {
+      if (attr->rta_type == RTA_GATEWAY) {
+        netaddr_from_binary(&path->gw, RTA_DATA(attr), RTA_PAYLOAD(attr), route->p.family);
+      }
+    }
+  }
+
+  if (route->p.multipath_count > 0) {
+    memcpy(&route->p.gw, &route->p.multipath[0].gw, sizeof(route->p.gw));
+    route->p.if_index = route->p.multipath[0].if_index;
+  }
+}
+
 /**
  * Parse a rtnetlink header into a os_route object
  * @param route pointer to target os_route
@@ -554,6 +831,14 @@ _routing_parse_nlmsg(struct os_route *route, struct nlmsghdr *msg) {
       case RTA_OIF:
         memcpy(&route->p.if_index, RTA_DATA(rt_attr), sizeof(route->p.if_index));
         break;
+      case RTA_MULTIPATH:
+        _routing_parse_multipath(route, rt_attr);
+        break;
+#ifdef RTM_NEWNEXTHOP
+      case RTA_NH_ID:
+        memcpy(&route->p.nexthop_id, RTA_DATA(rt_attr), sizeof(route->p.nexthop_id));
+        break;
+#endif
       default:
         break;
     }
@@ -696,6 +981,13 @@ _cb_rtnetlink_error(struct os_system_netlink_message *nl_msg) {
   struct os_route_str rbuf;
 #endif
 
+  if (_is_nexthop_message(nl_msg)) {
+    OONF_DEBUG(LOG_OS_ROUTING, "Nexthop seqno %u failed: %s (%d)", nl_msg->message->nlmsg_seq,
+      strerror(nl_msg->result), nl_msg->result);
+    _nexthop_finished(container_of(nl_msg, struct os_route_nexthop, _internal.msg), nl_msg->result);
+    return;
+  }
+
   route = container_of(nl_msg, struct os_route, _internal.msg);
   OONF_DEBUG(LOG_OS_ROUTING, "Route seqno %u failed: %s (%d) %s",
              nl_msg->message->nlmsg_seq, strerror(nl_msg->result), nl_msg->result, os_routing_to_string(&rbuf, &route->p));
@@ -716,6 +1008,11 @@ _cb_rtnetlink_done(struct os_system_netlink_message *nl_msg) {
 
   OONF_DEBUG(LOG_OS_ROUTING, "received done message (seq=%u)", nl_msg->message->nlmsg_seq);
 
+  if (_is_nexthop_message(nl_msg)) {
+    _nexthop_finished(container_of(nl_msg, struct os_route_nexthop, _internal.msg), 0);
+    return;
+  }
+
   route = container_of(nl_msg, struct os_route, _internal.msg);
   OONF_DEBUG(LOG_OS_ROUTING, "Route done (seq=%u): %s", 
              nl_msg->message->nlmsg_seq, os_routing_to_string(&rbuf, &route->p));
@@ -341,6 +341,31 @@ os_system_linux_netlink_add(struct os_system_netlink *nl, int protocol) {
   return 0;
 }
 
+/**
+ * Join additional multicast groups with an already registered netlink handler.
+ * This is necessary for generic netlink families, which resolve their
+ * multicast group ids at runtime.
+ * @param nl pointer to netlink handler
+ * @param groups array of multicast group ids
+ * @param count number of multicast group ids
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+os_system_linux_netlink_add_mc(struct os_system_netlink *nl, const uint32_t *groups, size_t count) {
+  size_t i;
+
+  OONF_CLASS_GUARD_ASSERT(&_netlink_guard, nl, nl->used_by->logging);
+  for (i = 0; i < count; i++) {
+    if (setsockopt(os_fd_get_fd(&nl->nl_socket->nl_socket.fd),
+        SOL_NETLINK, NETLINK_ADD_MEMBERSHIP, &groups[i], sizeof(groups[i]))) {
+      OONF_WARN(nl->used_by->logging, "Netlink '%s': could not join mc group: %d",
+                nl->name, groups[i]);
+      return -1;
+    }
+  }
+  return 0;
+}
+
 /**
  * Close a netlink socket handler
  * @param nl pointer to handler
@@ -0,0 +1,673 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <openssl/core_names.h>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/params.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/crypto/rfc7182_provider/rfc7182_provider.h>
+#include <oonf/librfc5444/rfc5444_iana.h>
+
+#include <oonf/crypto/hash_openssl/hash_openssl.h>
+
+#define LOG_HASH_OPENSSL _hash_openssl_subsystem.logging
+
+/* constants for HMAC calculation */
+enum
+{
+  /*! number of remembered HMAC key states */
+  HASH_OPENSSL_KEY_STATES = 8,
+};
+
+/**
+ * OpenSSL extension for hash definition
+ */
+struct openssl_hash {
+  /*! rfc7182 hash provider */
+  struct rfc7182_hash h;
+
+  /*! OpenSSL name of hash */
+  const char *openssl_name;
+
+  /*! OpenSSL hash implementation */
+  const EVP_MD *md;
+};
+
+/**
+ * State of an incremental hash calculation
+ */
+struct openssl_hash_context {
+  /*! OpenSSL digest context */
+  EVP_MD_CTX *ctx;
+};
+
+/**
+ * HMAC state after processing a key, contains the hash state
+ * of the inner and outer padded key
+ */
+struct openssl_key_state {
+  /*! hash type of HMAC */
+  uint8_t hash_type;
+
+  /*! true while an incremental calculation uses the MAC context */
+  bool in_use;
+
+  /*! keyed OpenSSL MAC context */
+  EVP_MAC_CTX *ctx;
+
+  /*! length of key */
+  size_t key_len;
+
+  /*! copy of key */
+  uint8_t *key;
+};
+
+/**
+ * State of an incremental HMAC calculation
+ */
+struct openssl_hmac_context {
+  /*! OpenSSL MAC context */
+  EVP_MAC_CTX *ctx;
+
+  /*! key state the MAC context belongs to, NULL if the context must be freed */
+  struct openssl_key_state *state;
+};
+
+/* function prototypes */
+static int _init(void);
+static void _cleanup(void);
+
+static int _cb_sha_hash(struct rfc7182_hash *hash, void *dst, size_t *dst_len, const void *src, size_t src_len);
+static int _cb_sha_init(struct rfc7182_hash *hash, void *ctx);
+static int _cb_sha_update(struct rfc7182_hash *hash, void *ctx, const void *src, size_t src_len);
+static int _cb_sha_final(struct rfc7182_hash *hash, void *ctx, void *dst, size_t *dst_len);
+
+static size_t _cb_get_cryptsize(struct rfc7182_crypt *, struct rfc7182_hash *);
+static int _cb_hmac_sign(struct rfc7182_crypt *, struct rfc7182_hash *, void *dst, size_t *dst_len, const void *src,
+  size_t src_len, const void *key, size_t key_len);
+static int _cb_hmac_init(
+  struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, void *ctx, const void *key, size_t key_len);
+static int _cb_hmac_update(struct rfc7182_crypt *crypt, void *ctx, const void *src, size_t src_len);
+static int _cb_hmac_final(struct rfc7182_crypt *crypt, void *ctx, void *dst, size_t *dst_len);
+static void _cb_hmac_validate_batch(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash,
+  struct rfc7182_validation *validations, size_t count, const void *key, size_t key_len);
+
+static struct openssl_hash *_get_hash(uint8_t type);
+static EVP_MAC_CTX *_create_keyed_context(struct openssl_hash *sslhash, const void *key, size_t key_len);
+static struct openssl_key_state *_get_key_state(struct openssl_hash *sslhash, const void *key, size_t key_len);
+static void _free_key_state(struct openssl_key_state *state);
+
+/* hash openssl subsystem definition */
+static const char *_dependencies[] = {
+  OONF_RFC7182_PROVIDER_SUBSYSTEM,
+};
+static struct oonf_subsystem _hash_openssl_subsystem = {
+  .name = OONF_HASH_OPENSSL_SUBSYSTEM,
+  .dependencies = _dependencies,
+  .dependencies_count = ARRAYSIZE(_dependencies),
+  .descr = "RFC5444 hash/hmac functions OpenSSL plugin",
+  .author = "Henning Rogge",
+
+  .init = _init,
+  .cleanup = _cleanup,
+};
+DECLARE_OONF_PLUGIN(_hash_openssl_subsystem);
+
+/* definition for all sha1/2 hashes */
+static struct openssl_hash _hashes[] = {
+  {
+    .h =
+      {
+        .type = RFC7182_ICV_HASH_SHA_1,
+        .hash_length = 160 / 8,
+      },
+    .openssl_name = "SHA1",
+  },
+  {
+    .h =
+      {
+        .type = RFC7182_ICV_HASH_SHA_224,
+        .hash_length = 224 / 8,
+      },
+    .openssl_name = "SHA224",
+  },
+  {
+    .h =
+      {
+        .type = RFC7182_ICV_HASH_SHA_256,
+        .hash_length = 256 / 8,
+      },
+    .openssl_name = "SHA256",
+  },
+  {
+    .h =
+      {
+        .type = RFC7182_ICV_HASH_SHA_384,
+        .hash_length = 384 / 8,
+      },
+    .openssl_name = "SHA384",
+  },
+  {
+    .h =
+      {
+        .type = RFC7182_ICV_HASH_SHA_512,
+        .hash_length = 512 / 8,
+      },
+    .openssl_name = "SHA512",
+  },
+};
+
+/* definition of hmac crypto function */
+static struct rfc7182_crypt _hmac = {
+  .type = RFC7182_ICV_CRYPT_HMAC,
+  .sign = _cb_hmac_sign,
+  .getSignSize = _cb_get_cryptsize,
+
+  .context_size = sizeof(struct openssl_hmac_context),
+  .sign_init = _cb_hmac_init,
+  .sign_update = _cb_hmac_update,
+  .sign_final = _cb_hmac_final,
+
+  .validate_batch = _cb_hmac_validate_batch,
+};
+
+/* OpenSSL HMAC implementation */
+static EVP_MAC *_hmac_mac;
+
+/* remembered HMAC key states, so the key is not processed again for every message */
+static struct openssl_key_state _key_states[HASH_OPENSSL_KEY_STATES];
+static size_t _key_state_next;
+
+/**
+ * Constructor for subsystem
+ * @return -1 if OpenSSL has no HMAC, 0 otherwise
+ */
+static int
+_init(void) {
+  size_t i;
+
+  _hmac_mac = EVP_MAC_fetch(NULL, OSSL_MAC_NAME_HMAC, NULL);
+  if (_hmac_mac == NULL) {
+    OONF_WARN(LOG_HASH_OPENSSL, "OpenSSL does not provide HMAC");
+    return -1;
+  }
+
+  /* register hashes with rfc5444 signature API */
+  for (i = 0; i < ARRAYSIZE(_hashes); i++) {
+    _hashes[i].md = EVP_get_digestbyname(_hashes[i].openssl_name);
+    if (_hashes[i].md != NULL) {
+      _hashes[i].h.hash = _cb_sha_hash;
+      _hashes[i].h.context_size = sizeof(struct openssl_hash_context);
+      _hashes[i].h.init = _cb_sha_init;
+      _hashes[i].h.update = _cb_sha_update;
+      _hashes[i].h.final = _cb_sha_final;
+
+      OONF_INFO(LOG_HASH_OPENSSL, "Add %s hash to rfc7182 API", rfc7182_get_hash_name(_hashes[i].h.type));
+      rfc7182_add_hash(&_hashes[i].h);
+    }
+  }
+
+  rfc7182_add_crypt(&_hmac);
+  OONF_INFO(LOG_HASH_OPENSSL, "Add hmac to rfc7182 API");
+  return 0;
+}
+
+/**
+ * Destructor of subsystem
+ */
+static void
+_cleanup(void) {
+  size_t i;
+
+  /* unregister hashes with rfc5444 signature API */
+  for (i = 0; i < ARRAYSIZE(_hashes); i++) {
+    if (_hashes[i].md != NULL) {
+      rfc7182_remove_hash(&_hashes[i].h);
+    }
+  }
+
+  rfc7182_remove_crypt(&_hmac);
+
+  for (i = 0; i < ARRAYSIZE(_key_states); i++) {
+    _free_key_state(&_key_states[i]);
+  }
+
+  EVP_MAC_free(_hmac_mac);
+  _hmac_mac = NULL;
+}
+
+/**
+ * Generic SHA1/2 hash implementation based on OpenSSL
+ * @param hash rfc7182 hash
+ * @param dst output buffer for hash
+ * @param dst_len pointer to length of output buffer,
+ *   will be set to hash length afterwards
+ * @param src original data to hash
+ * @param src_len length of original data
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_sha_hash(struct rfc7182_hash *hash, void *dst, size_t *dst_len, const void *src, size_t src_len) {
+  struct openssl_hash *sslhash;
+  unsigned int len;
+
+  sslhash = container_of(hash, struct openssl_hash, h);
+  if (*dst_len < hash->hash_length) {
+    return -1;
+  }
+
+  if (!EVP_Digest(src, src_len, dst, &len, sslhash->md, NULL)) {
+    OONF_WARN(LOG_HASH_OPENSSL, "OpenSSL error while calculating %s", sslhash->openssl_name);
+    return -1;
+  }
+  *dst_len = len;
+  return 0;
+}
+
+/**
+ * Initialize an incremental SHA1/2 hash calculation
+ * @param hash rfc7182 hash
+ * @param ctx hash state
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_sha_init(struct rfc7182_hash *hash, void *ctx) {
+  struct openssl_hash_context *hash_ctx = ctx;
+  struct openssl_hash *sslhash;
+
+  sslhash = container_of(hash, struct openssl_hash, h);
+
+  hash_ctx->ctx = EVP_MD_CTX_new();
+  if (hash_ctx->ctx == NULL) {
+    return -1;
+  }
+  if (!EVP_DigestInit_ex(hash_ctx->ctx, sslhash->md, NULL)) {
+    EVP_MD_CTX_free(hash_ctx->ctx);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * Add data to an incremental SHA1/2 hash calculation
+ * @param hash rfc7182 hash
+ * @param ctx hash state
+ * @param src data to hash
+ * @param src_len length of data
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_sha_update(struct rfc7182_hash *hash __attribute__((unused)), void *ctx, const void *src, size_t src_len) {
+  struct openssl_hash_context *hash_ctx = ctx;
+
+  return EVP_DigestUpdate(hash_ctx->ctx, src, src_len) ? 0 : -1;
+}
+
+/**
+ * Finish an incremental SHA1/2 hash calculation
+ * @param hash rfc7182 hash
+ * @param ctx hash state
+ * @param dst output buffer for hash, NULL to release the state
+ * @param dst_len pointer to length of output buffer,
+ *   will be set to hash length afterwards
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_sha_final(struct rfc7182_hash *hash, void *ctx, void *dst, size_t *dst_len) {
+  struct openssl_hash_context *hash_ctx = ctx;
+  unsigned int len;
+  int result;
+
+  result = 0;
+  if (dst != NULL) {
+    if (*dst_len < hash->hash_length || !EVP_DigestFinal_ex(hash_ctx->ctx, dst, &len)) {
+      result = -1;
+    }
+    else {
+      *dst_len = len;
+    }
+  }
+
+  EVP_MD_CTX_free(hash_ctx->ctx);
+  hash_ctx->ctx = NULL;
+  return result;
+}
+
+/**
+ * @param crypt cryptographic function
+ * @param hash hash function
+ * @return length of signature based on chosen hash
+ */
+static size_t
+_cb_get_cryptsize(struct rfc7182_crypt *crypt __attribute__((unused)), struct rfc7182_hash *hash) {
+  return hash->hash_length;
+}
+
+/**
+ * HMAC function based on OpenSSL
+ * @param crypt this crypto definition
+ * @param hash the definition of the hash
+ * @param dst output buffer for cryptographic signature
+ * @param dst_len pointer to length of output buffer, will be set to
+ *   length of signature afterwards
+ * @param src unsigned original data
+ * @param src_len length of original data
+ * @param key key material for signature
+ * @param key_len length of key material
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_hmac_sign(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, void *dst, size_t *dst_len, const void *src,
+  size_t src_len, const void *key, size_t key_len) {
+  struct openssl_hmac_context hmac_ctx;
+
+  OONF_DEBUG_HEX(LOG_HASH_OPENSSL, src, src_len, "Calculate hash:");
+
+  if (_cb_hmac_init(crypt, hash, &hmac_ctx, key, key_len)) {
+    return -1;
+  }
+  if (_cb_hmac_update(crypt, &hmac_ctx, src, src_len)) {
+    _cb_hmac_final(crypt, &hmac_ctx, NULL, NULL);
+    return -1;
+  }
+  return _cb_hmac_final(crypt, &hmac_ctx, dst, dst_len);
+}
+
+/**
+ * Initialize an incremental HMAC calculation. The MAC context is
+ * taken from the remembered key states if possible.
+ * @param crypt this crypto definition
+ * @param hash the definition of the hash
+ * @param ctx HMAC state
+ * @param key key material for signature
+ * @param key_len length of key material
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_hmac_init(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, void *ctx, const void *key, size_t key_len) {
+  struct openssl_hmac_context *hmac_ctx = ctx;
+  struct openssl_key_state *state;
+  struct openssl_hash *sslhash;
+
+  sslhash = _get_hash(hash->type);
+  if (sslhash == NULL) {
+    OONF_WARN(LOG_HASH_OPENSSL, "Unsupported Hash for OpenSSL HMAC: %u", hash->type);
+    return -1;
+  }
+
+  hmac_ctx->state = NULL;
+
+  state = _get_key_state(sslhash, key, key_len);
+  if (state == NULL) {
+    /* no key state available, process the key for this calculation only */
+    hmac_ctx->ctx = _create_keyed_context(sslhash, key, key_len);
+    return hmac_ctx->ctx == NULL ? -1 : 0;
+  }
+
+  if (state->in_use) {
+    /* key state is used by another calculation, work on a copy */
+    hmac_ctx->ctx = EVP_MAC_CTX_dup(state->ctx);
+    if (hmac_ctx->ctx == NULL) {
+      return -1;
+    }
+  }
+  else {
+    hmac_ctx->ctx = state->ctx;
+    hmac_ctx->state = state;
+    state->in_use = true;
+  }
+
+  /* restart HMAC from the inner padded key state */
+  if (!EVP_MAC_init(hmac_ctx->ctx, NULL, 0, NULL)) {
+    OONF_WARN(LOG_HASH_OPENSSL, "OpenSSL error while restarting HMAC-%s", sslhash->openssl_name);
+    _cb_hmac_final(crypt, hmac_ctx, NULL, NULL);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * Add data to an incremental HMAC calculation
+ * @param crypt this crypto definition
+ * @param ctx HMAC state
+ * @param src data to sign
+ * @param src_len length of data
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_hmac_update(struct rfc7182_crypt *crypt __attribute__((unused)), void *ctx, const void *src, size_t src_len) {
+  struct openssl_hmac_context *hmac_ctx = ctx;
+
+  return EVP_MAC_update(hmac_ctx->ctx, src, src_len) ? 0 : -1;
+}
+
+/**
+ * Finish an incremental HMAC calculation
+ * @param crypt this crypto definition
+ * @param ctx HMAC state
+ * @param dst output buffer for signature, NULL to release the state
+ * @param dst_len pointer to length of output buffer, will be set to
+ *   length of signature afterwards
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_hmac_final(struct rfc7182_crypt *crypt __attribute__((unused)), void *ctx, void *dst, size_t *dst_len) {
+  struct openssl_hmac_context *hmac_ctx = ctx;
+  int result;
+
+  result = 0;
+  if (dst != NULL && !EVP_MAC_final(hmac_ctx->ctx, dst, dst_len, *dst_len)) {
+    result = -1;
+  }
+
+  if (hmac_ctx->state) {
+    /* keep keyed context for the next calculation */
+    hmac_ctx->state->in_use = false;
+    hmac_ctx->state = NULL;
+  }
+  else {
+    EVP_MAC_CTX_free(hmac_ctx->ctx);
+  }
+  hmac_ctx->ctx = NULL;
+  return result;
+}
+
+/**
+ * Check the HMAC of multiple data blocks with the same key,
+ * the key is only looked up once for all of them.
+ * @param crypt this crypto definition
+ * @param hash the definition of the hash
+ * @param validations array of signatures and signed data
+ * @param count number of validations
+ * @param key key material for signature
+ * @param key_len length of key material
+ */
+static void
+_cb_hmac_validate_batch(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash,
+  struct rfc7182_validation *validations, size_t count, const void *key, size_t key_len) {
+  struct openssl_hmac_context hmac_ctx;
+  uint8_t icv[EVP_MAX_MD_SIZE];
+  size_t i, j, icv_len;
+  bool okay;
+
+  for (i = 0; i < count; i++) {
+    validations[i].valid = false;
+  }
+
+  if (_cb_hmac_init(crypt, hash, &hmac_ctx, key, key_len)) {
+    return;
+  }
+
+  for (i = 0; i < count; i++) {
+    /* first HMAC has already been initialized */
+    okay = i == 0 || EVP_MAC_init(hmac_ctx.ctx, NULL, 0, NULL);
+    for (j = 0; okay && j < validations[i].segment_count; j++) {
+      okay = EVP_MAC_update(hmac_ctx.ctx, validations[i].segments[j].data, validations[i].segments[j].length);
+    }
+
+    icv_len = 0;
+    if (okay) {
+      okay = EVP_MAC_final(hmac_ctx.ctx, icv, &icv_len, sizeof(icv));
+    }
+
+    validations[i].valid = okay && icv_len == validations[i].encrypted_length &&
+                           CRYPTO_memcmp(icv, validations[i].encrypted, icv_len) == 0;
+  }
+
+  _cb_hmac_final(crypt, &hmac_ctx, NULL, NULL);
+}
+
+/**
+ * @param type RFC7182 hash type
+ * @return OpenSSL hash definition, NULL if not supported
+ */
+static struct openssl_hash *
+_get_hash(uint8_t type) {
+  size_t i;
+
+  for (i = 0; i < ARRAYSIZE(_hashes); i++) {
+    if (_hashes[i].h.type == type && _hashes[i].md != NULL) {
+      return &_hashes[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Create a new OpenSSL MAC context and process the HMAC key
+ * @param sslhash OpenSSL hash definition
+ * @param key key material
+ * @param key_len length of key material
+ * @return keyed MAC context, NULL if an error happened
+ */
+static EVP_MAC_CTX *
+_create_keyed_context(struct openssl_hash *sslhash, const void *key, size_t key_len) {
+  EVP_MAC_CTX *ctx;
+  OSSL_PARAM params[] = {
+    OSSL_PARAM_utf8_string(OSSL_MAC_PARAM_DIGEST, NULL, 0),
+    OSSL_PARAM_END,
+  };
+
+  ctx = EVP_MAC_CTX_new(_hmac_mac);
+  if (ctx == NULL) {
+    return NULL;
+  }
+
+  params[0].data = (char *)sslhash->openssl_name;
+  params[0].data_size = strlen(sslhash->openssl_name);
+
+  if (!EVP_MAC_init(ctx, key, key_len, params)) {
+    OONF_WARN(LOG_HASH_OPENSSL, "OpenSSL error while initializing HMAC-%s", sslhash->openssl_name);
+    EVP_MAC_CTX_free(ctx);
+    return NULL;
+  }
+  return ctx;
+}
+
+/**
+ * Get the remembered HMAC state of a key, create it if necessary
+ * @param sslhash OpenSSL hash definition
+ * @param key key material
+ * @param key_len length of key material
+ * @return key state, NULL if no state could be created
+ */
+static struct openssl_key_state *
+_get_key_state(struct openssl_hash *sslhash, const void *key, size_t key_len) {
+  struct openssl_key_state *state;
+  size_t i;
+
+  for (i = 0; i < ARRAYSIZE(_key_states); i++) {
+    state = &_key_states[i];
+    if (state->ctx != NULL && state->hash_type == sslhash->h.type && state->key_len == key_len &&
+        CRYPTO_memcmp(state->key, key, key_len) == 0) {
+      return state;
+    }
+  }
+
+  /* replace the oldest key state that is not in use */
+  for (i = 0; i < ARRAYSIZE(_key_states); i++) {
+    state = &_key_states[_key_state_next];
+    _key_state_next = (_key_state_next + 1) % ARRAYSIZE(_key_states);
+
+    if (!state->in_use) {
+      break;
+    }
+  }
+  if (state->in_use) {
+    return NULL;
+  }
+
+  _free_key_state(state);
+
+  state->key = OPENSSL_malloc(key_len > 0 ? key_len : 1);
+  if (state->key == NULL) {
+    return NULL;
+  }
+
+  state->ctx = _create_keyed_context(sslhash, key, key_len);
+  if (state->ctx == NULL) {
+    _free_key_state(state);
+    return NULL;
+  }
+
+  memcpy(state->key, key, key_len);
+  state->key_len = key_len;
+  state->hash_type = sslhash->h.type;
+  return state;
+}
+
+/**
+ * Release the resources of a key state
+ * @param state key state
+ */
+static void
+_free_key_state(struct openssl_key_state *state) {
+  EVP_MAC_CTX_free(state->ctx);
+  OPENSSL_clear_free(state->key, state->key_len);
+  memset(state, 0, sizeof(*state));
+}
@@ -43,6 +43,8 @@
  * @file
  */
 
+#include <stdlib.h>
+
 #include <oonf/libcommon/avl.h>
 #include <oonf/libcommon/avl_comp.h>
 #include <oonf/oonf.h>
@@ -57,14 +59,110 @@
 
 #define LOG_RFC5444_SIG _rfc5444_sig_subsystem.logging
 
+/* constants for signature processing */
+enum
+{
+  /*! maximum number of segments of the unsigned data of a packet/message */
+  RFC5444_SIG_MAX_SEGMENTS = 32,
+
+  /*! number of segments in front of the unsigned data (source IP, ICV prefix) */
+  RFC5444_SIG_PREFIX_SEGMENTS = 2,
+
+  /*! number of remembered message verifications */
+  RFC5444_SIG_CACHE_SIZE = 64,
+
+  /*! maximum number of messages of a packet that are checked in one batch */
+  RFC5444_SIG_MAX_BATCH = 16,
+};
+
+/**
+ * Unsigned data of a packet/message, split into segments
+ */
+struct _unsigned_data {
+  /*! copy of the header with modified length and hop fields */
+  uint8_t header[4 + RFC5444_MAX_ADDRLEN + 4 + 2];
+
+  /*! segments of data, the first ones are reserved for the signature prefix */
+  struct rfc7182_segment segments[RFC5444_SIG_PREFIX_SEGMENTS + RFC5444_SIG_MAX_SEGMENTS];
+
+  /*! number of segments behind the prefix, 0 if not generated yet */
+  size_t count;
+
+  /*! first signature TLV of the packet/message, NULL if none */
+  const uint8_t *icv_tlv;
+};
+
+/**
+ * Message signature that is checked as part of a batch
+ */
+struct _batch_message {
+  /*! unsigned data of the message */
+  struct _unsigned_data data;
+
+  /*! signature to check, NULL if not part of a batch (anymore) */
+  struct rfc5444_signature *sig;
+
+  /*! signature prefix and unsigned data */
+  const struct rfc7182_segment *segments;
+
+  /*! number of segments */
+  size_t segment_count;
+
+  /*! received integrity check value */
+  const uint8_t *icv;
+
+  /*! length of integrity check value */
+  size_t icv_length;
+};
+
+/**
+ * Remembered result of a message signature verification
+ */
+struct _sig_cache_entry {
+  /*! signature used for verification */
+  struct rfc5444_signature *sig;
+
+  /*! result of verification */
+  bool verified;
+
+  /*! length of cryptographic key */
+  size_t key_length;
+
+  /*! length of received integrity check value */
+  size_t icv_length;
+
+  /*! length of signed data */
+  size_t data_length;
+
+  /*! key, integrity check value and signed data */
+  uint8_t data[];
+};
+
 /* prototypes */
 static int _init(void);
 static void _cleanup(void);
 static enum rfc5444_result _cb_signature_tlv(struct rfc5444_reader_tlvblock_context *context);
+static enum rfc5444_result _cb_verify_packet_messages(struct rfc5444_reader_tlvblock_context *context);
 static int _cb_add_signature(struct rfc5444_writer_postprocessor *processor, struct rfc5444_writer_target *target,
   struct rfc5444_writer_message *msg, uint8_t *data, size_t *data_size);
 
-static size_t _remove_signature_data(uint8_t *dst, const struct rfc5444_reader_tlvblock_context *context);
+static int _prepare_unsigned_data(
+  struct _unsigned_data *unsigned_data, const struct rfc5444_reader_tlvblock_context *context);
+static bool _add_unsigned_segment(struct _unsigned_data *unsigned_data, const void *data, size_t length);
+static const struct rfc7182_segment *_add_signature_prefix(struct _unsigned_data *unsigned_data,
+  size_t *segment_count, const uint8_t *value, uint8_t key_id_len, bool source_specific);
+static int _get_message_context(
+  struct rfc5444_reader_tlvblock_context *context, const uint8_t *ptr, const uint8_t *end);
+static bool _add_batch_message(struct _batch_message *batch, const struct rfc5444_reader_tlvblock_context *context);
+static void _verify_batch(struct rfc5444_signature *sig, size_t first, size_t count);
+static bool _verify_signature(struct rfc5444_signature *sig, bool use_cache, const void *icv, size_t icv_length,
+  const struct rfc7182_segment *segments, size_t segment_count);
+
+static struct _sig_cache_entry *_get_cache_entry(struct rfc5444_signature *sig, const void *key, size_t key_length,
+  const void *icv, size_t icv_length, const struct rfc7182_segment *segments, size_t segment_count);
+static void _add_cache_entry(struct rfc5444_signature *sig, bool verified, const void *key, size_t key_length,
+  const void *icv, size_t icv_length, const struct rfc7182_segment *segments, size_t segment_count);
+static void _remove_cache_entries(struct rfc5444_signature *sig);
 
 static void _cb_hash_added(void *ptr);
 static void _cb_hash_removed(void *ptr);
@@ -109,6 +207,12 @@ static struct rfc5444_reader_tlvblock_consumer _signature_pkt_consumer = {
   .block_callback = _cb_signature_tlv,
 };
 
+/* checks all message signatures of a packet after the packet signature */
+static struct rfc5444_reader_tlvblock_consumer _signature_batch_consumer = {
+  .order = RFC5444_VALIDATOR_PRIORITY + 1,
+  .start_callback = _cb_verify_packet_messages,
+};
+
 static struct rfc5444_reader_tlvblock_consumer_entry _pkt_signature_tlv = {
   .type = RFC7182_PKTTLV_ICV,
 };
@@ -122,10 +226,25 @@ static struct oonf_rfc5444_protocol *_protocol;
 /* tree of registered signatures */
 static struct avl_tree _sig_tree;
 
-/* static buffer for signature calculation */
-static uint8_t _static_message_buffer[RFC5444_MAX_PACKET_SIZE];
+/* static buffers for signature calculation */
+static uint8_t _prefix_buffer[RFC5444_MAX_ADDRLEN + 3 + 255];
+static uint8_t _header_buffer[4 + RFC5444_MAX_ADDRLEN + 4 + 2];
 static uint8_t _crypt_buffer[RFC5444_MAX_PACKET_SIZE];
 
+/* unsigned data of the current context */
+static struct _unsigned_data _unsigned;
+
+/* message signatures of the current packet and their validation */
+static struct _batch_message _batch[RFC5444_SIG_MAX_BATCH];
+static struct rfc7182_validation _validations[RFC5444_SIG_MAX_BATCH];
+
+/* ringbuffer of remembered message verifications */
+static struct _sig_cache_entry *_sig_cache[RFC5444_SIG_CACHE_SIZE];
+static size_t _sig_cache_next;
+
+/* statistics of signature verification */
+static struct rfc5444_sig_statistics _statistics;
+
 /* listeners for crypto and hash algorithms */
 static struct oonf_class_extension _hash_listener = {
   .ext_name = "rfc5444 signatures",
@@ -142,17 +261,15 @@ static struct oonf_class_extension _crypt_listener = {
 
 /**
  * Constructor of subsystem
- * @return -1 if rfc5444 protocol was not available, 0 otherwise
+ * @return always 0
  */
 static int
 _init(void) {
-  _protocol = oonf_rfc5444_add_protocol(RFC5444_PROTOCOL, true);
-  if (_protocol == NULL) {
-    return -1;
-  }
+  _protocol = oonf_rfc5444_get_default_protocol();
 
   rfc5444_reader_add_message_consumer(&_protocol->reader, &_signature_msg_consumer, &_msg_signature_tlv, 1);
   rfc5444_reader_add_packet_consumer(&_protocol->reader, &_signature_pkt_consumer, &_pkt_signature_tlv, 1);
+  rfc5444_reader_add_packet_consumer(&_protocol->reader, &_signature_batch_consumer, NULL, 0);
   avl_init(&_sig_tree, _avl_cmp_signatures, true);
 
   oonf_class_extension_add(&_hash_listener);
@@ -170,10 +287,12 @@ _cleanup(void) {
   avl_for_each_element_safe(&_sig_tree, sig, _node, sig_it) {
     rfc5444_sig_remove(sig);
   }
+  _remove_cache_entries(NULL);
 
   rfc5444_reader_remove_message_consumer(&_protocol->reader, &_signature_msg_consumer);
   rfc5444_reader_remove_packet_consumer(&_protocol->reader, &_signature_pkt_consumer);
-  oonf_rfc5444_remove_protocol(_protocol);
+  rfc5444_reader_remove_packet_consumer(&_protocol->reader, &_signature_batch_consumer);
+  _protocol = NULL;
 
   oonf_class_extension_remove(&_hash_listener);
   oonf_class_extension_remove(&_crypt_listener);
@@ -200,6 +319,7 @@ rfc5444_sig_add(struct rfc5444_signature *sig) {
   sig->_postprocessor.priority = 0;
   sig->_postprocessor.process = _cb_add_signature;
   sig->_postprocessor.is_matching_signature = _cb_is_matching_signature;
+  sig->_postprocessor.target_specific = sig->source_specific;
 
   /* try to get hash/crypto */
   sig->hash = rfc7182_get_hash(sig->key.hash_function);
@@ -214,10 +334,19 @@ rfc5444_sig_add(struct rfc5444_signature *sig) {
  */
 void
 rfc5444_sig_remove(struct rfc5444_signature *sig) {
+  _remove_cache_entries(sig);
   rfc5444_writer_unregister_postprocessor(&_protocol->writer, &sig->_postprocessor);
   avl_remove(&_sig_tree, &sig->_node);
 }
 
+/**
+ * @return statistics of signature verification
+ */
+const struct rfc5444_sig_statistics *
+rfc5444_sig_get_statistics(void) {
+  return &_statistics;
+}
+
 /**
  * Callback for checking both message and packet signature TLVs
  * @param context rfc5444 TLV context
@@ -229,17 +358,13 @@ _cb_signature_tlv(struct rfc5444_reader_tlvblock_context *context) {
   struct rfc5444_reader_tlvblock_entry *tlv;
   struct rfc5444_signature *sig, *sigstart;
   struct rfc5444_signature_key sigkey;
+  const struct rfc7182_segment *segments;
   enum rfc5444_sigid_check check;
   enum rfc5444_result drop_value;
   int msg_type;
   uint8_t key_id_len;
-  uint8_t *static_data;
-  size_t static_length, key_length;
-  const void *key;
+  size_t segment_count;
   bool sig_to_verify;
-#ifdef OONF_LOG_DEBUG_INFO
-  struct netaddr_str nbuf;
-#endif
 
   if (context->type == RFC5444_CONTEXT_PACKET) {
     msg_type = RFC5444_WRITER_PKT_POSTPROCESSOR;
@@ -270,6 +395,9 @@ _cb_signature_tlv(struct rfc5444_reader_tlvblock_context *context) {
 
   OONF_DEBUG(LOG_RFC5444_SIG, "Start checking signature for message type %d", msg_type);
 
+  /* unsigned data is generated on demand once for all signature TLVs */
+  _unsigned.count = 0;
+
   for (tlv = sig_tlv->tlv; tlv; tlv = tlv->next_entry) {
     if (tlv->type_ext != RFC7182_ICV_EXT_CRYPTHASH && tlv->type_ext != RFC7182_ICV_EXT_SRCSPEC_CRYPTHASH) {
       /* unknown subtype, just ignore */
@@ -287,28 +415,21 @@ _cb_signature_tlv(struct rfc5444_reader_tlvblock_context *context) {
     key_id_len = tlv->single_value[2];
 
     if (tlv->length <= 3 + key_id_len) {
-      /* not enouOONF_LOG_DEBUG_INFOgh bytes for valid signature */
+      /* not enough bytes for valid signature */
       OONF_INFO_HEX(LOG_RFC5444_SIG, tlv->single_value, tlv->length, "Signature tlv %u/%u too short: %u bytes",
         tlv->single_value[0], tlv->single_value[1], tlv->length);
       continue;
     }
 
-    /* assemble static message buffer */
-    if (tlv->type_ext == RFC7182_ICV_EXT_SRCSPEC_CRYPTHASH) {
-      OONF_DEBUG(LOG_RFC5444_SIG, "incoming src IP: %s", netaddr_to_string(&nbuf, _protocol->input_address));
-
-      /* copy source address into buffer */
-      netaddr_to_binary(_static_message_buffer, _protocol->input_address, sizeof(_static_message_buffer));
-      static_length = netaddr_get_binlength(_protocol->input_address);
-    }
-    else {
-      static_length = 0;
+    if (_unsigned.count == 0 && _prepare_unsigned_data(&_unsigned, context)) {
+      OONF_INFO(LOG_RFC5444_SIG, "Cannot remove signature data from %s",
+        msg_type == RFC5444_WRITER_PKT_POSTPROCESSOR ? "packet" : "message");
+      return drop_value;
     }
-    memcpy(&_static_message_buffer[static_length], tlv->single_value, 3 + key_id_len);
-    static_length += 3 + key_id_len;
 
-    static_data = &_static_message_buffer[static_length];
-    static_length += _remove_signature_data(static_data, context);
+    /* signature prefix in front of the unsigned packet/message */
+    segments = _add_signature_prefix(&_unsigned, &segment_count, tlv->single_value, key_id_len,
+      tlv->type_ext == RFC7182_ICV_EXT_SRCSPEC_CRYPTHASH);
 
     /* loop over all possible signatures */
     avl_for_each_elements_with_key(&_sig_tree, sig, _node, sigstart, &sigkey) {
@@ -322,6 +443,11 @@ _cb_signature_tlv(struct rfc5444_reader_tlvblock_context *context) {
         continue;
       }
 
+      if (sig->hash == NULL || sig->crypt == NULL) {
+        /* hash or crypto function not available */
+        continue;
+      }
+
       /* see how signature want to handle the incoming key id */
       check = sig->verify_id(sig, &tlv->single_value[3], key_id_len);
       if (check == RFC5444_SIGID_IGNORE) {
@@ -335,12 +461,11 @@ _cb_signature_tlv(struct rfc5444_reader_tlvblock_context *context) {
       }
 
       /* remember source IP */
-      sig->source = _protocol->input_address;
+      sig->source = _protocol->input.src_address;
 
-      /* check signature */
-      key = sig->getCryptoKey(sig, &key_length);
-      sig->verified = sig->crypt->validate(sig->crypt, sig->hash, &tlv->single_value[3 + key_id_len],
-        tlv->length - 3 - key_id_len, _static_message_buffer, static_length, key, key_length);
+      /* check signature, forwarded messages are usually received more than once */
+      sig->verified = _verify_signature(sig, context->type == RFC5444_CONTEXT_MESSAGE,
+        &tlv->single_value[3 + key_id_len], tlv->length - 3 - key_id_len, segments, segment_count);
 
       OONF_DEBUG(LOG_RFC5444_SIG, "Checked signature hash=%d/crypt=%d: %s", sig->key.hash_function,
         sig->key.crypt_function, sig->verified ? "check" : "bad");
@@ -363,6 +488,96 @@ _cb_signature_tlv(struct rfc5444_reader_tlvblock_context *context) {
   return RFC5444_OKAY;
 }
 
+/**
+ * Callback to check the message signatures of a packet in one batch
+ * per signature before the messages are parsed. The results are stored
+ * in the verification cache, the message TLV callback still decides
+ * about each message.
+ * @param context rfc5444 packet context
+ * @return always RFC5444_OKAY
+ */
+static enum rfc5444_result
+_cb_verify_packet_messages(struct rfc5444_reader_tlvblock_context *context) {
+  struct rfc5444_reader_tlvblock_context msg_context;
+  const uint8_t *ptr, *end;
+  size_t count, i;
+
+  if (avl_is_empty(&_sig_tree)) {
+    return RFC5444_OKAY;
+  }
+
+  /* skip packet header and packet tlvblock */
+  ptr = context->pkt_buffer + (context->has_pktseqno ? 3 : 1);
+  end = context->pkt_buffer + context->pkt_size;
+  if (context->pkt_flags & RFC5444_PKT_FLAG_TLV) {
+    if (ptr + 2 > end) {
+      return RFC5444_OKAY;
+    }
+    ptr += 2 + 256 * ptr[0] + ptr[1];
+  }
+
+  /* collect message signatures */
+  count = 0;
+  while (ptr < end && count < RFC5444_SIG_MAX_BATCH) {
+    if (_get_message_context(&msg_context, ptr, end)) {
+      /* broken message, the rfc5444 reader will handle it */
+      break;
+    }
+    ptr += msg_context.msg_size;
+
+    if (_add_batch_message(&_batch[count], &msg_context)) {
+      count++;
+    }
+  }
+
+  /* check one batch per signature */
+  for (i = 0; i < count; i++) {
+    if (_batch[i].sig) {
+      _verify_batch(_batch[i].sig, i, count);
+    }
+  }
+  return RFC5444_OKAY;
+}
+
+/**
+ * Check the signature of a message/packet
+ * @param sig signature definition
+ * @param use_cache true if result should be looked up in (and stored into)
+ *   the verification cache
+ * @param icv received integrity check value
+ * @param icv_length length of integrity check value
+ * @param segments segments of signed data
+ * @param segment_count number of segments
+ * @return true if signature was valid, false otherwise
+ */
+static bool
+_verify_signature(struct rfc5444_signature *sig, bool use_cache, const void *icv, size_t icv_length,
+  const struct rfc7182_segment *segments, size_t segment_count) {
+  struct _sig_cache_entry *entry;
+  const void *key;
+  size_t key_length;
+  bool verified;
+
+  key = sig->getCryptoKey(sig, &key_length);
+
+  if (use_cache) {
+    entry = _get_cache_entry(sig, key, key_length, icv, icv_length, segments, segment_count);
+    if (entry) {
+      _statistics.cache_hits++;
+      return entry->verified;
+    }
+  }
+
+  _statistics.verifications++;
+  verified = rfc7182_validate_segments(
+    sig->crypt, sig->hash, icv, icv_length, segments, segment_count, key, key_length);
+
+  if (use_cache) {
+    _add_cache_entry(sig, verified, key, key_length, icv, icv_length, segments, segment_count);
+  }
+  return verified;
+}
+
 /**
  * Post processor to add a packet signature
  * @param processor rfc5444 post-processor
@@ -379,10 +594,11 @@ _cb_add_signature(struct rfc5444_writer_postprocessor *processor, struct rfc5444
   struct oonf_rfc5444_target *oonf_target;
   const union netaddr_socket *local_socket;
   struct netaddr srcaddr;
+  struct rfc7182_segment segments[3];
 
-  size_t hash_buffer_size, sig_size, sig_tlv_size, tlvblock_size, key_size;
+  size_t sig_size, sig_tlv_size, tlvblock_size, key_size, segment_count;
   uint8_t *tlvblock;
-  int idx;
+  size_t idx;
 
   size_t crypt_len;
 
@@ -403,10 +619,7 @@ _cb_add_signature(struct rfc5444_writer_postprocessor *processor, struct rfc5444
   }
   oonf_target = oonf_rfc5444_get_target_from_rfc5444_target(target);
 
-  /*
-   * copy data into static buffer, leave space in front
-   * for source address and signature data
-   */
+  /* generate source address and signature data in front of the unsigned data */
   if (sig->source_specific) {
     local_socket = oonf_rfc5444_target_get_local_socket(oonf_target);
     if (netaddr_from_socket(&srcaddr, local_socket)) {
@@ -414,7 +627,7 @@ _cb_add_signature(struct rfc5444_writer_postprocessor *processor, struct rfc5444
     }
     OONF_DEBUG(LOG_RFC5444_SIG, "outgoing src IP: %s", netaddr_to_string(&nbuf, &srcaddr));
 
-    netaddr_to_binary(_static_message_buffer, &srcaddr, sizeof(_static_message_buffer));
+    netaddr_to_binary(_prefix_buffer, &srcaddr, sizeof(_prefix_buffer));
     idx = netaddr_get_binlength(&srcaddr);
   }
   else {
@@ -424,57 +637,62 @@ _cb_add_signature(struct rfc5444_writer_postprocessor *processor, struct rfc5444
   key_id_length = 0;
   key_id = sig->getKeyId(sig, &key_id_length);
 
-  _static_message_buffer[idx++] = sig->key.hash_function;
-  _static_message_buffer[idx++] = sig->key.crypt_function;
-  _static_message_buffer[idx++] = key_id_length;
-  memcpy(&_static_message_buffer[idx], key_id, key_id_length);
+  _prefix_buffer[idx++] = sig->key.hash_function;
+  _prefix_buffer[idx++] = sig->key.crypt_function;
+  _prefix_buffer[idx++] = key_id_length;
+  memcpy(&_prefix_buffer[idx], key_id, key_id_length);
   idx += key_id_length;
-  hash_buffer_size = idx + *data_size;
 
-  if (msg) {
-    /* just copy message data, it always has a TLV block */
-    memcpy(&_static_message_buffer[idx], data, *data_size);
+  segments[0].data = _prefix_buffer;
+  segments[0].length = idx;
 
+  if (msg) {
     /*
-     * get pointer to message tlvblock
-     * zero hoplimit/hopcount in static buffer
+     * get pointer to message tlvblock,
+     * hash a copy of the header with zero hoplimit/hopcount
      */
-    idx += 4;
-    tlvblock = &data[4];
+    idx = 4;
     if (msg->has_origaddr) {
       idx += _protocol->writer.msg_addr_len;
-      tlvblock += _protocol->writer.msg_addr_len;
     }
+    memcpy(_header_buffer, data, idx);
     if (msg->has_hoplimit) {
-      _static_message_buffer[idx++] = 0;
-      tlvblock++;
+      _header_buffer[idx++] = 0;
     }
     if (msg->has_hopcount) {
-      _static_message_buffer[idx++] = 0;
-      tlvblock++;
+      _header_buffer[idx++] = 0;
     }
     if (msg->has_seqno) {
+      memcpy(&_header_buffer[idx], &data[idx], 2);
       idx += 2;
-      tlvblock += 2;
     }
+    tlvblock = &data[idx];
+
+    segments[1].data = _header_buffer;
+    segments[1].length = idx;
+    segments[2].data = tlvblock;
+    segments[2].length = *data_size - idx;
+    segment_count = 3;
   }
   else {
-    /* just copy packet for hashing */
-    memcpy(&_static_message_buffer[idx], data, *data_size);
-
+    /* just hash the packet */
     if (data[0] & RFC5444_PKT_FLAG_SEQNO) {
       tlvblock = &data[3];
     }
     else {
       tlvblock = &data[1];
     }
+
+    segments[1].data = data;
+    segments[1].length = *data_size;
+    segment_count = 2;
   }
 
   /* calculate encrypted hash value */
   crypt_len = sizeof(_crypt_buffer);
   key = sig->getCryptoKey(sig, &key_size);
-  if (sig->crypt->sign(
-        sig->crypt, sig->hash, _crypt_buffer, &crypt_len, _static_message_buffer, hash_buffer_size, key, key_size)) {
+  if (rfc7182_sign_segments(
+        sig->crypt, sig->hash, _crypt_buffer, &crypt_len, segments, segment_count, key, key_size)) {
     OONF_WARN(LOG_RFC5444_SIG, "Signature generation failed");
     return -1;
   }
@@ -567,27 +785,32 @@ _cb_add_signature(struct rfc5444_writer_postprocessor *processor, struct rfc5444
 }
 
 /**
- * Remove signature TLVs from a message/packet
- * @param dst pointer to destination buffer for unsigned message/packet
+ * Generate the segments of the unsigned data of a message/packet. Signature
+ * TLVs are skipped and header fields that differ from the signed
+ * data are replaced by a modified copy of the header.
+ * @param unsigned_data storage for unsigned data
  * @param context rfc5444 context
- * @return size of unsigned data
+ * @return -1 if an error happened, 0 otherwise
  */
-static size_t
-_remove_signature_data(uint8_t *dst, const struct rfc5444_reader_tlvblock_context *context) {
-  const uint8_t *src_ptr, *src_end;
-  uint8_t *dst_ptr, *tlvblock;
+static int
+_prepare_unsigned_data(struct _unsigned_data *unsigned_data, const struct rfc5444_reader_tlvblock_context *context) {
+  const uint8_t *src_ptr, *src_end, *tlv_end, *run;
   uint16_t len, hoplimit, hopcount;
-  uint16_t blocklen, tlvlen;
+  uint16_t blocklen;
+  size_t total, tlvlen, i;
 
   hoplimit = 0;
   hopcount = 0;
 
+  unsigned_data->count = 0;
+  unsigned_data->icv_tlv = NULL;
+
   /* initialize pointers to src/dst */
   if (context->type == RFC5444_CONTEXT_PACKET) {
     src_ptr = context->pkt_buffer;
     src_end = context->pkt_buffer + context->pkt_size;
 
-    /* calculate message header length */
+    /* calculate packet header length */
     if (context->has_pktseqno) {
       len = 3;
     }
@@ -616,34 +839,39 @@ _remove_signature_data(uint8_t *dst, const struct rfc5444_reader_tlvblock_contex
       len += 2;
     }
   }
-  dst_ptr = dst;
 
-  /* copy pakcet/message header */
-  memcpy(dst_ptr, src_ptr, len);
+  if (src_ptr + len + 2 > src_end) {
+    return -1;
+  }
+
+  /* copy packet/message header */
+  memcpy(unsigned_data->header, src_ptr, len);
 
   /* clear hoplimit/hopcount */
   if (hoplimit) {
-    dst_ptr[hoplimit] = 0;
+    unsigned_data->header[hoplimit] = 0;
   }
   if (hopcount) {
-    dst_ptr[hopcount] = 0;
+    unsigned_data->header[hopcount] = 0;
   }
 
-  /* advance to end of header */
-  src_ptr += len;
-  dst_ptr += len;
-  tlvblock = dst_ptr;
+  unsigned_data->count = 1;
+  unsigned_data->segments[RFC5444_SIG_PREFIX_SEGMENTS].data = unsigned_data->header;
 
-  /* copy all message tlvs except for signature tlvs */
+  /* advance to tlvblock */
+  src_ptr += len;
   blocklen = 256 * src_ptr[0] + src_ptr[1];
-
-  /* skip over message tlv block header, we write the number later */
   src_ptr += 2;
-  dst_ptr += 2;
 
-  /* loop over message tlvs */
-  len = blocklen;
-  while (len > 0) {
+  tlv_end = src_ptr + blocklen;
+  if (tlv_end > src_end) {
+    return -1;
+  }
+
+  /* add all tlvs except for signature tlvs */
+  blocklen = 0;
+  run = src_ptr;
+  while (src_ptr + 2 <= tlv_end) {
     /* calculate length of TLV */
     tlvlen = 2;
     if (src_ptr[1] & RFC5444_TLV_FLAG_TYPEEXT) {
@@ -652,6 +880,9 @@ _remove_signature_data(uint8_t *dst, const struct rfc5444_reader_tlvblock_contex
     }
     if (src_ptr[1] & RFC5444_TLV_FLAG_VALUE) {
       /* TLV has a value field */
+      if (src_ptr + tlvlen + 2 > tlv_end) {
+        break;
+      }
       if (src_ptr[1] & RFC5444_TLV_FLAG_EXTVALUE) {
         /* 2-byte value */
         tlvlen += (256 * src_ptr[tlvlen]) + src_ptr[tlvlen + 1] + 2;
@@ -662,42 +893,391 @@ _remove_signature_data(uint8_t *dst, const struct rfc5444_reader_tlvblock_contex
       }
     }
 
-    if (src_ptr[0] != RFC7182_MSGTLV_ICV) {
-      /* copy TLV if not signature TLV */
-      memcpy(dst_ptr, src_ptr, tlvlen);
-      dst_ptr += tlvlen;
-    }
-    else {
-      /* reduce blocklength */
-      blocklen -= tlvlen;
+    if (src_ptr[0] == RFC7182_MSGTLV_ICV) {
+      if (unsigned_data->icv_tlv == NULL) {
+        unsigned_data->icv_tlv = src_ptr;
+      }
+
+      /* end the current run of TLVs in front of the signature TLV */
+      if (src_ptr > run && !_add_unsigned_segment(unsigned_data, run, src_ptr - run)) {
+        return -1;
+      }
+      blocklen += src_ptr - run;
+      run = src_ptr + tlvlen;
     }
-    len -= tlvlen;
     src_ptr += tlvlen;
   }
 
+  if (src_ptr != tlv_end) {
+    /* tlvblock is broken */
+    return -1;
+  }
+  if (tlv_end > run && !_add_unsigned_segment(unsigned_data, run, tlv_end - run)) {
+    return -1;
+  }
+  blocklen += tlv_end - run;
+
   if (blocklen > 0 || context->type == RFC5444_CONTEXT_MESSAGE) {
-    /* overwrite message tlvblock length */
-    tlvblock[0] = blocklen / 256;
-    tlvblock[1] = blocklen & 255;
+    /* overwrite tlvblock length */
+    unsigned_data->header[len] = blocklen / 256;
+    unsigned_data->header[len + 1] = blocklen & 255;
+    len += 2;
   }
   else {
     /* remove empty packet tlvblock and fix flags */
-    dst_ptr -= 2;
-    dst[0] &= ~RFC5444_PKT_FLAG_TLV;
+    unsigned_data->header[0] &= ~RFC5444_PKT_FLAG_TLV;
   }
+  unsigned_data->segments[RFC5444_SIG_PREFIX_SEGMENTS].length = len;
 
-  /* copy rest of data */
-  len = src_end - src_ptr;
-  memcpy(dst_ptr, src_ptr, len);
+  /* add rest of data */
+  if (src_end > tlv_end && !_add_unsigned_segment(unsigned_data, tlv_end, src_end - tlv_end)) {
+    return -1;
+  }
 
-  /* calculate data length */
-  len = dst_ptr - dst + len;
   if (context->type == RFC5444_CONTEXT_MESSAGE) {
     /* overwrite message length */
-    dst[2] = len / 256;
-    dst[3] = len & 255;
+    total = 0;
+    for (i = 0; i < unsigned_data->count; i++) {
+      total += unsigned_data->segments[RFC5444_SIG_PREFIX_SEGMENTS + i].length;
+    }
+    unsigned_data->header[2] = total / 256;
+    unsigned_data->header[3] = total & 255;
+  }
+  return 0;
+}
+
+/**
+ * Add a segment to the unsigned data of a context
+ * @param unsigned_data unsigned data of context
+ * @param data pointer to data
+ * @param length length of data
+ * @return true if segment was added, false if there were too many segments
+ */
+static bool
+_add_unsigned_segment(struct _unsigned_data *unsigned_data, const void *data, size_t length) {
+  if (unsigned_data->count >= RFC5444_SIG_MAX_SEGMENTS) {
+    return false;
+  }
+
+  unsigned_data->segments[RFC5444_SIG_PREFIX_SEGMENTS + unsigned_data->count].data = data;
+  unsigned_data->segments[RFC5444_SIG_PREFIX_SEGMENTS + unsigned_data->count].length = length;
+  unsigned_data->count++;
+  return true;
+}
+
+/**
+ * Put the signature prefix (source IP, hash/crypt/key-id) in front
+ * of the unsigned data of a context
+ * @param unsigned_data unsigned data of context
+ * @param segment_count pointer to number of segments, will be set by this function
+ * @param value value of the signature TLV
+ * @param key_id_len length of key-id
+ * @param source_specific true if the source IP is part of the signature
+ * @return pointer to first segment of signed data
+ */
+static const struct rfc7182_segment *
+_add_signature_prefix(struct _unsigned_data *unsigned_data, size_t *segment_count, const uint8_t *value,
+  uint8_t key_id_len, bool source_specific) {
+  struct rfc7182_segment *segments;
+#ifdef OONF_LOG_DEBUG_INFO
+  struct netaddr_str nbuf;
+#endif
+
+  segments = &unsigned_data->segments[RFC5444_SIG_PREFIX_SEGMENTS];
+  *segment_count = unsigned_data->count;
+
+  segments--;
+  (*segment_count)++;
+  segments[0].data = value;
+  segments[0].length = 3 + key_id_len;
+
+  if (source_specific) {
+    OONF_DEBUG(LOG_RFC5444_SIG, "incoming src IP: %s", netaddr_to_string(&nbuf, _protocol->input.src_address));
+
+    segments--;
+    (*segment_count)++;
+    segments[0].data = netaddr_get_binptr(_protocol->input.src_address);
+    segments[0].length = netaddr_get_binlength(_protocol->input.src_address);
+  }
+  return segments;
+}
+
+/**
+ * Parse the header of a message in a packet buffer
+ * @param context message context, will be initialized by this function
+ * @param ptr pointer to start of message
+ * @param end pointer to end of packet
+ * @return -1 if message header is broken, 0 otherwise
+ */
+static int
+_get_message_context(struct rfc5444_reader_tlvblock_context *context, const uint8_t *ptr, const uint8_t *end) {
+  memset(context, 0, sizeof(*context));
+
+  if (ptr + 4 > end) {
+    return -1;
+  }
+
+  context->type = RFC5444_CONTEXT_MESSAGE;
+  context->msg_type = ptr[0];
+  context->msg_flags = ptr[1] & ~RFC5444_MSG_FLAG_ADDRLENMASK;
+  context->addr_len = (ptr[1] & RFC5444_MSG_FLAG_ADDRLENMASK) + 1;
+  context->has_origaddr = (ptr[1] & RFC5444_MSG_FLAG_ORIGINATOR) != 0;
+  context->has_hoplimit = (ptr[1] & RFC5444_MSG_FLAG_HOPLIMIT) != 0;
+  context->has_hopcount = (ptr[1] & RFC5444_MSG_FLAG_HOPCOUNT) != 0;
+  context->has_seqno = (ptr[1] & RFC5444_MSG_FLAG_SEQNO) != 0;
+
+  context->msg_buffer = ptr;
+  context->msg_size = 256 * ptr[2] + ptr[3];
+
+  if (context->msg_size < 4 || ptr + context->msg_size > end) {
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * Prepare the check of the first signature TLV of a message
+ * as part of a batch
+ * @param batch storage for batched message signature
+ * @param context message context
+ * @return true if message signature should be checked, false otherwise
+ */
+static bool
+_add_batch_message(struct _batch_message *batch, const struct rfc5444_reader_tlvblock_context *context) {
+  struct rfc5444_signature *sig, *sigstart;
+  struct rfc5444_signature_key sigkey;
+  const uint8_t *tlv, *value;
+  uint16_t length;
+  uint8_t type_ext, key_id_len;
+  bool matching;
+
+  batch->sig = NULL;
+
+  matching = false;
+  avl_for_each_element(&_sig_tree, sig, _node) {
+    if (sig->is_matching_signature(sig, context->msg_type)) {
+      matching = true;
+      break;
+    }
+  }
+  if (!matching) {
+    /* message type is not signed */
+    return false;
+  }
+
+  if (_prepare_unsigned_data(&batch->data, context) || batch->data.icv_tlv == NULL) {
+    return false;
+  }
+
+  /* parse signature TLV, length has been checked by _prepare_unsigned_data() */
+  tlv = batch->data.icv_tlv;
+  if ((tlv[1] & RFC5444_TLV_FLAG_TYPEEXT) == 0 || (tlv[1] & RFC5444_TLV_FLAG_VALUE) == 0) {
+    return false;
+  }
+  type_ext = tlv[2];
+  if (tlv[1] & RFC5444_TLV_FLAG_EXTVALUE) {
+    length = 256 * tlv[3] + tlv[4];
+    value = &tlv[5];
+  }
+  else {
+    length = tlv[3];
+    value = &tlv[4];
+  }
+
+  if (type_ext != RFC7182_ICV_EXT_CRYPTHASH && type_ext != RFC7182_ICV_EXT_SRCSPEC_CRYPTHASH) {
+    return false;
+  }
+  if (length < 4 || length <= 3 + value[2]) {
+    return false;
+  }
+
+  sigkey.hash_function = value[0];
+  sigkey.crypt_function = value[1];
+  key_id_len = value[2];
+
+  avl_for_each_elements_with_key(&_sig_tree, sig, _node, sigstart, &sigkey) {
+    if (sig->is_matching_signature(sig, context->msg_type) &&
+        (type_ext == RFC7182_ICV_EXT_SRCSPEC_CRYPTHASH) == sig->source_specific && sig->hash != NULL &&
+        sig->crypt != NULL && sig->verify_id(sig, &value[3], key_id_len) == RFC5444_SIGID_OKAY) {
+      batch->sig = sig;
+      break;
+    }
+  }
+  if (batch->sig == NULL) {
+    return false;
+  }
+
+  batch->segments = _add_signature_prefix(&batch->data, &batch->segment_count, value, key_id_len,
+    type_ext == RFC7182_ICV_EXT_SRCSPEC_CRYPTHASH);
+  batch->icv = &value[3 + key_id_len];
+  batch->icv_length = length - 3 - key_id_len;
+  return true;
+}
+
+/**
+ * Check all batched message signatures of a signature definition
+ * and remember the results in the verification cache
+ * @param sig signature definition
+ * @param first index of first batched message with this signature
+ * @param count number of batched messages
+ */
+static void
+_verify_batch(struct rfc5444_signature *sig, size_t first, size_t count) {
+  const void *key;
+  size_t key_length, validation_count, i;
+
+  key = sig->getCryptoKey(sig, &key_length);
+
+  validation_count = 0;
+  for (i = first; i < count; i++) {
+    if (_batch[i].sig != sig) {
+      continue;
+    }
+    _batch[i].sig = NULL;
+
+    if (_get_cache_entry(sig, key, key_length, _batch[i].icv, _batch[i].icv_length, _batch[i].segments,
+          _batch[i].segment_count)) {
+      /* message has been checked before */
+      continue;
+    }
+
+    _validations[validation_count].encrypted = _batch[i].icv;
+    _validations[validation_count].encrypted_length = _batch[i].icv_length;
+    _validations[validation_count].segments = _batch[i].segments;
+    _validations[validation_count].segment_count = _batch[i].segment_count;
+    validation_count++;
+  }
+
+  if (validation_count < 2) {
+    /* a single message is checked by the message TLV callback */
+    return;
+  }
+
+  rfc7182_validate_batch(sig->crypt, sig->hash, _validations, validation_count, key, key_length);
+  _statistics.verifications += validation_count;
+  _statistics.batched += validation_count;
+
+  for (i = 0; i < validation_count; i++) {
+    _add_cache_entry(sig, _validations[i].valid, key, key_length, _validations[i].encrypted,
+      _validations[i].encrypted_length, _validations[i].segments, _validations[i].segment_count);
+  }
+}
+
+/**
+ * Look up a remembered verification of signed data
+ * @param sig signature definition
+ * @param key cryptographic key
+ * @param key_length length of key
+ * @param icv received integrity check value
+ * @param icv_length length of integrity check value
+ * @param segments segments of signed data
+ * @param segment_count number of segments
+ * @return cache entry, NULL if data was not verified before
+ */
+static struct _sig_cache_entry *
+_get_cache_entry(struct rfc5444_signature *sig, const void *key, size_t key_length, const void *icv,
+  size_t icv_length, const struct rfc7182_segment *segments, size_t segment_count) {
+  struct _sig_cache_entry *entry;
+  const uint8_t *ptr;
+  size_t i, j, data_length;
+
+  data_length = 0;
+  for (i = 0; i < segment_count; i++) {
+    data_length += segments[i].length;
+  }
+
+  for (i = 0; i < RFC5444_SIG_CACHE_SIZE; i++) {
+    entry = _sig_cache[i];
+    if (entry == NULL || entry->sig != sig || entry->key_length != key_length || entry->icv_length != icv_length ||
+        entry->data_length != data_length) {
+      continue;
+    }
+
+    /* the integrity check value is the most likely difference */
+    ptr = entry->data;
+    if (memcmp(ptr + key_length, icv, icv_length) != 0 || memcmp(ptr, key, key_length) != 0) {
+      continue;
+    }
+
+    /* compare signed data */
+    ptr += key_length + icv_length;
+    for (j = 0; j < segment_count; j++) {
+      if (memcmp(ptr, segments[j].data, segments[j].length) != 0) {
+        break;
+      }
+      ptr += segments[j].length;
+    }
+    if (j == segment_count) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Remember the result of a signature verification
+ * @param sig signature definition
+ * @param verified result of verification
+ * @param key cryptographic key
+ * @param key_length length of key
+ * @param icv received integrity check value
+ * @param icv_length length of integrity check value
+ * @param segments segments of signed data
+ * @param segment_count number of segments
+ */
+static void
+_add_cache_entry(struct rfc5444_signature *sig, bool verified, const void *key, size_t key_length, const void *icv,
+  size_t icv_length, const struct rfc7182_segment *segments, size_t segment_count) {
+  struct _sig_cache_entry *entry;
+  uint8_t *ptr;
+  size_t i, data_length;
+
+  data_length = 0;
+  for (i = 0; i < segment_count; i++) {
+    data_length += segments[i].length;
+  }
+
+  entry = calloc(1, sizeof(*entry) + key_length + icv_length + data_length);
+  if (entry == NULL) {
+    return;
+  }
+
+  entry->sig = sig;
+  entry->verified = verified;
+  entry->key_length = key_length;
+  entry->icv_length = icv_length;
+  entry->data_length = data_length;
+
+  ptr = entry->data;
+  memcpy(ptr, key, key_length);
+  ptr += key_length;
+  memcpy(ptr, icv, icv_length);
+  ptr += icv_length;
+  for (i = 0; i < segment_count; i++) {
+    memcpy(ptr, segments[i].data, segments[i].length);
+    ptr += segments[i].length;
+  }
+
+  /* replace oldest entry */
+  free(_sig_cache[_sig_cache_next]);
+  _sig_cache[_sig_cache_next] = entry;
+  _sig_cache_next = (_sig_cache_next + 1) % RFC5444_SIG_CACHE_SIZE;
+}
+
+/**
+ * Remove all remembered verifications of a signature
+ * @param sig signature definition, NULL to remove all entries
+ */
+static void
+_remove_cache_entries(struct rfc5444_signature *sig) {
+  size_t i;
+
+  for (i = 0; i < RFC5444_SIG_CACHE_SIZE; i++) {
+    if (_sig_cache[i] != NULL && (sig == NULL || _sig_cache[i]->sig == sig)) {
+      free(_sig_cache[i]);
+      _sig_cache[i] = NULL;
+    }
   }
-  return len;
 }
 
 static void
@@ -60,12 +60,19 @@ static void _cleanup(void);
 static int _cb_identity_hash(struct rfc7182_hash *hash, void *dst, size_t *dst_len, const void *src, size_t src_len);
 static int _cb_identity_crypt(struct rfc7182_crypt *crypt, void *dst, size_t *dst_len, const void *src, size_t src_len,
   const void *key, size_t key_len);
+static size_t _cb_identity_signsize(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash);
 
 static bool _cb_validate_by_sign(struct rfc7182_crypt *, struct rfc7182_hash *, const void *encrypted,
   size_t encrypted_length, const void *src, size_t src_len, const void *key, size_t key_len);
 static int _cb_sign_by_crypthash(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, void *dst, size_t *dst_len,
   const void *src, size_t src_len, const void *key, size_t key_len);
 
+static int _sign_incremental(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, void *dst, size_t *dst_len,
+  const struct rfc7182_segment *segments, size_t segment_count, const void *key, size_t key_len);
+static int _hash_incremental(struct rfc7182_hash *hash, void *dst, size_t *dst_len,
+  const struct rfc7182_segment *segments, size_t segment_count);
+static const void *_linearize(size_t *length, const struct rfc7182_segment *segments, size_t segment_count);
+
 /* plugin declaration */
 static const char *_dependencies[] = {
   OONF_CLASS_SUBSYSTEM,
@@ -91,6 +98,7 @@ static struct rfc7182_hash _identity_hash = {
 static struct rfc7182_crypt _identity_crypt = {
   .type = RFC7182_ICV_CRYPT_IDENTITY,
   .encrypt = _cb_identity_crypt,
+  .getSignSize = _cb_identity_signsize,
 };
 
 /* tree of hash/crypt functions */
@@ -106,8 +114,17 @@ static struct oonf_class _crypt_class = {
   .size = sizeof(struct rfc7182_crypt),
 };
 
-/* static buffer for crypto calculation */
+/* static buffers for crypto calculation */
 static uint8_t _crypt_buffer[1500];
+static uint8_t _hash_buffer[1500];
+static uint8_t _segment_buffer[2048];
+
+/* state of incremental hash/signature calculation */
+static union {
+  uint64_t _align;
+  void *_ptr;
+  uint8_t data[RFC7182_MAX_CONTEXT_SIZE];
+} _context;
 
 /**
  * Constructor of subsystem
@@ -155,6 +172,12 @@ rfc7182_add_hash(struct rfc7182_hash *hash) {
   /* hook key into avl node */
   hash->_node.key = &hash->type;
 
+  if (hash->init != NULL
+      && (hash->update == NULL || hash->final == NULL || hash->context_size > RFC7182_MAX_CONTEXT_SIZE)) {
+    OONF_WARN(LOG_RFC7182_PROVIDER, "Incremental %s hash not usable", rfc7182_get_hash_name(hash->type));
+    hash->init = NULL;
+  }
+
   /* hook hash into hash tree */
   avl_insert(&_hash_functions, &hash->_node);
 
@@ -198,10 +221,16 @@ rfc7182_add_crypt(struct rfc7182_crypt *crypt) {
     crypt->sign = _cb_sign_by_crypthash;
   }
 
+  if (crypt->sign_init != NULL &&
+      (crypt->sign_update == NULL || crypt->sign_final == NULL || crypt->context_size > RFC7182_MAX_CONTEXT_SIZE)) {
+    OONF_WARN(LOG_RFC7182_PROVIDER, "Incremental %s signature not usable", rfc7182_get_crypt_name(crypt->type));
+    crypt->sign_init = NULL;
+  }
+
   /* hook crypt function into crypt tree */
   avl_insert(&_crypt_functions, &crypt->_node);
 
-  oonf_class_event(&_hash_class, crypt, OONF_OBJECT_ADDED);
+  oonf_class_event(&_crypt_class, crypt, OONF_OBJECT_ADDED);
 }
 
 /**
@@ -223,6 +252,123 @@ rfc7182_get_crypt_tree(void) {
   return &_crypt_functions;
 }
 
+/**
+ * Generate a signature over data that is split into multiple segments.
+ * The segments are fed into the incremental hash/signature functions
+ * if available, so the caller does not need to copy them into a
+ * continuous buffer.
+ * @param crypt crypto function
+ * @param hash hash function
+ * @param dst output buffer for cryptographic signature
+ * @param dst_len pointer to length of output buffer, will be set to
+ *   length of signature afterwards
+ * @param segments array of data segments
+ * @param segment_count number of data segments
+ * @param key key material for signature
+ * @param key_len length of key material
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+rfc7182_sign_segments(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, void *dst, size_t *dst_len,
+  const struct rfc7182_segment *segments, size_t segment_count, const void *key, size_t key_len) {
+  const void *src;
+  size_t src_len, hashed_length;
+
+  if (crypt->sign_init) {
+    return _sign_incremental(crypt, hash, dst, dst_len, segments, segment_count, key, key_len);
+  }
+
+  if (crypt->sign == _cb_sign_by_crypthash && hash->init) {
+    hashed_length = sizeof(_hash_buffer);
+    if (_hash_incremental(hash, _hash_buffer, &hashed_length, segments, segment_count)) {
+      OONF_WARN(LOG_RFC7182_PROVIDER, "Could not generate hash %u", hash->type);
+      return -1;
+    }
+    if (crypt->encrypt(crypt, dst, dst_len, _hash_buffer, hashed_length, key, key_len)) {
+      OONF_WARN(LOG_RFC7182_PROVIDER, "Could not generate crypt %u", crypt->type);
+      return -1;
+    }
+    return 0;
+  }
+
+  /* no incremental functions available, copy data into a continuous block */
+  src = _linearize(&src_len, segments, segment_count);
+  if (src == NULL) {
+    return -1;
+  }
+  return crypt->sign(crypt, hash, dst, dst_len, src, src_len, key, key_len);
+}
+
+/**
+ * Check a signature over data that is split into multiple segments.
+ * @param crypt crypto function
+ * @param hash hash function
+ * @param encrypted pointer to encrypted signature
+ * @param encrypted_length length of encrypted signature
+ * @param segments array of data segments
+ * @param segment_count number of data segments
+ * @param key key material for signature
+ * @param key_len length of key material
+ * @return true if signature matches, false otherwise
+ */
+bool
+rfc7182_validate_segments(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, const void *encrypted,
+  size_t encrypted_length, const struct rfc7182_segment *segments, size_t segment_count, const void *key,
+  size_t key_len) {
+  const void *src;
+  size_t src_len, crypt_length;
+
+  if (crypt->validate != _cb_validate_by_sign) {
+    /* crypto function needs the continuous data */
+    src = _linearize(&src_len, segments, segment_count);
+    if (src == NULL) {
+      return false;
+    }
+    return crypt->validate(crypt, hash, encrypted, encrypted_length, src, src_len, key, key_len);
+  }
+
+  crypt_length = sizeof(_crypt_buffer);
+  if (rfc7182_sign_segments(crypt, hash, _crypt_buffer, &crypt_length, segments, segment_count, key, key_len)) {
+    OONF_INFO(LOG_RFC7182_PROVIDER, "Crypto-error when checking signature");
+    return false;
+  }
+
+  if (crypt_length != encrypted_length) {
+    OONF_INFO(LOG_RFC7182_PROVIDER,
+      "signature has wrong length: "
+      "%" PRINTF_SIZE_T_SPECIFIER " != %" PRINTF_SIZE_T_SPECIFIER,
+      crypt_length, encrypted_length);
+    return false;
+  }
+  return memcmp(encrypted, _crypt_buffer, crypt_length) == 0;
+}
+
+/**
+ * Check multiple signatures that use the same crypto function, hash
+ * and key. The 'valid' field of each validation is set to the result.
+ * @param crypt crypto function
+ * @param hash hash function
+ * @param validations array of signatures and signed data
+ * @param count number of validations
+ * @param key key material for signature
+ * @param key_len length of key material
+ */
+void
+rfc7182_validate_batch(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash,
+  struct rfc7182_validation *validations, size_t count, const void *key, size_t key_len) {
+  size_t i;
+
+  if (crypt->validate_batch) {
+    crypt->validate_batch(crypt, hash, validations, count, key, key_len);
+    return;
+  }
+
+  for (i = 0; i < count; i++) {
+    validations[i].valid = rfc7182_validate_segments(crypt, hash, validations[i].encrypted,
+      validations[i].encrypted_length, validations[i].segments, validations[i].segment_count, key, key_len);
+  }
+}
+
 /**
  * 'Identity' hash function as defined in RFC7182
  * @param sig rfc5444 signature
@@ -236,6 +382,9 @@ rfc7182_get_crypt_tree(void) {
 static int
 _cb_identity_hash(
   struct rfc7182_hash *hash __attribute__((unused)), void *dst, size_t *dst_len, const void *src, size_t src_len) {
+  if (*dst_len < src_len) {
+    return -1;
+  }
   *dst_len = src_len;
   memcpy(dst, src, src_len);
   return 0;
@@ -255,11 +404,24 @@ static int
 _cb_identity_crypt(struct rfc7182_crypt *crypt __attribute((unused)), void *dst, size_t *dst_len, const void *src,
   size_t src_len, const void *key __attribute((unused)), size_t key_len __attribute((unused))) {
   /* just copy */
+  if (*dst_len < src_len) {
+    return -1;
+  }
   *dst_len = src_len;
-  memcpy(dst, src, src_len);
+  memmove(dst, src, src_len);
   return 0;
 }
 
+/**
+ * @param crypt this crypto definition
+ * @param hash the definition of the hash
+ * @return length of the unencrypted hash
+ */
+static size_t
+_cb_identity_signsize(struct rfc7182_crypt *crypt __attribute((unused)), struct rfc7182_hash *hash) {
+  return hash->hash_length;
+}
+
 /**
  * Callback to check a signature by generating a local signature
  * with the 'crypto' callback and then comparing both.
@@ -283,7 +445,7 @@ _cb_validate_by_sign(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, con
   crypt_length = sizeof(_crypt_buffer);
   if (crypt->sign(crypt, hash, _crypt_buffer, &crypt_length, src, src_len, key, key_len)) {
     OONF_INFO(LOG_RFC7182_PROVIDER, "Crypto-error when checking signature");
-    return -1;
+    return false;
   }
 
   /* compare length of both signatures */
@@ -292,7 +454,7 @@ _cb_validate_by_sign(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, con
       "signature has wrong length: "
       "%" PRINTF_SIZE_T_SPECIFIER " != %" PRINTF_SIZE_T_SPECIFIER,
       crypt_length, encrypted_length);
-    return -1;
+    return false;
   }
 
   /* binary compare both signatures */
@@ -309,16 +471,106 @@ _cb_sign_by_crypthash(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, vo
   const void *src, size_t src_len, const void *key, size_t key_len) {
   size_t hashed_length;
 
-  hashed_length = sizeof(_crypt_buffer);
-  if (hash->hash(hash, _crypt_buffer, &hashed_length, src, src_len)) {
+  hashed_length = sizeof(_hash_buffer);
+  if (hash->hash(hash, _hash_buffer, &hashed_length, src, src_len)) {
     OONF_WARN(LOG_RFC7182_PROVIDER, "Could not generate hash %u", hash->type);
     return -1;
   }
 
-  if (crypt->encrypt(crypt, dst, dst_len, _crypt_buffer, hashed_length, key, key_len)) {
+  if (crypt->encrypt(crypt, dst, dst_len, _hash_buffer, hashed_length, key, key_len)) {
     OONF_WARN(LOG_RFC7182_PROVIDER, "Could not generate crypt %u", crypt->type);
     return -1;
   }
 
   return 0;
 }
+
+/**
+ * Calculate a signature with the incremental functions of a crypto definition
+ * @param crypt crypto function
+ * @param hash hash function
+ * @param dst output buffer for cryptographic signature
+ * @param dst_len pointer to length of output buffer, will be set to
+ *   length of signature afterwards
+ * @param segments array of data segments
+ * @param segment_count number of data segments
+ * @param key key material for signature
+ * @param key_len length of key material
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_sign_incremental(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, void *dst, size_t *dst_len,
+  const struct rfc7182_segment *segments, size_t segment_count, const void *key, size_t key_len) {
+  size_t i;
+
+  if (crypt->sign_init(crypt, hash, _context.data, key, key_len)) {
+    OONF_WARN(LOG_RFC7182_PROVIDER, "Could not initialize crypt %u with hash %u", crypt->type, hash->type);
+    return -1;
+  }
+
+  for (i = 0; i < segment_count; i++) {
+    if (crypt->sign_update(crypt, _context.data, segments[i].data, segments[i].length)) {
+      OONF_WARN(LOG_RFC7182_PROVIDER, "Could not generate crypt %u", crypt->type);
+      crypt->sign_final(crypt, _context.data, NULL, NULL);
+      return -1;
+    }
+  }
+  return crypt->sign_final(crypt, _context.data, dst, dst_len);
+}
+
+/**
+ * Calculate a hash with the incremental functions of a hash definition
+ * @param hash hash function
+ * @param dst output buffer for hash
+ * @param dst_len pointer to length of output buffer,
+ *   will be set to hash length afterwards
+ * @param segments array of data segments
+ * @param segment_count number of data segments
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_hash_incremental(struct rfc7182_hash *hash, void *dst, size_t *dst_len, const struct rfc7182_segment *segments,
+  size_t segment_count) {
+  size_t i;
+
+  if (hash->init(hash, _context.data)) {
+    return -1;
+  }
+
+  for (i = 0; i < segment_count; i++) {
+    if (hash->update(hash, _context.data, segments[i].data, segments[i].length)) {
+      hash->final(hash, _context.data, NULL, NULL);
+      return -1;
+    }
+  }
+  return hash->final(hash, _context.data, dst, dst_len);
+}
+
+/**
+ * Copy data segments into a continuous buffer
+ * @param length pointer to length of data, will be set by this function
+ * @param segments array of data segments
+ * @param segment_count number of data segments
+ * @return pointer to continuous data, NULL if data was too long
+ */
+static const void *
+_linearize(size_t *length, const struct rfc7182_segment *segments, size_t segment_count) {
+  size_t i;
+
+  if (segment_count == 1) {
+    /* nothing to copy */
+    *length = segments[0].length;
+    return segments[0].data;
+  }
+
+  *length = 0;
+  for (i = 0; i < segment_count; i++) {
+    if (*length + segments[i].length > sizeof(_segment_buffer)) {
+      OONF_WARN(LOG_RFC7182_PROVIDER, "Data for signature too long");
+      return NULL;
+    }
+    memcpy(&_segment_buffer[*length], segments[i].data, segments[i].length);
+    *length += segments[i].length;
+  }
+  return _segment_buffer;
+}
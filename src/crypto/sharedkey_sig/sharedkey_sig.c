@@ -184,11 +184,11 @@ static struct avl_tree _sig_tree;
 static void
 _early_cfg_init(void) {
   /* we cannot do this statically because we draw the data from another subsystem */
-  _sharedkey_entries[IDX_CFG_HASH].validate_param[0].ptr = rfc7182_get_hashes();
   _sharedkey_entries[IDX_CFG_HASH].validate_param[1].s = RFC7182_ICV_HASH_COUNT;
+  _sharedkey_entries[IDX_CFG_HASH].validate_param[2].ptr = rfc7182_get_hashes();
 
-  _sharedkey_entries[IDX_CFG_CRYPTO].validate_param[0].ptr = rfc7182_get_crypto();
   _sharedkey_entries[IDX_CFG_CRYPTO].validate_param[1].s = RFC7182_ICV_CRYPT_COUNT;
+  _sharedkey_entries[IDX_CFG_CRYPTO].validate_param[2].ptr = rfc7182_get_crypto();
 }
 
 /**
@@ -165,6 +165,9 @@ static struct cfg_schema_entry _radio_entries[] = {
     "Filter which IPs are allowed to connect to the TCP server socket"),
   CFG_MAP_CLOCK_MINMAX(dlep_radio_if, interf.session.cfg.heartbeat_interval, "heartbeat_interval", "1.000",
     "Interval in seconds between two heartbeat signals", 1000, 65535 * 1000),
+  CFG_MAP_CLOCK_MAX(dlep_radio_if, interf.session.cfg.update_interval, "update_interval", "0.100",
+    "Interval in seconds to aggregate destination updates of the radio, 0 sends every update immediately",
+    65535 * 1000),
 
   CFG_MAP_CHOICE(dlep_radio_if, interf.udp_mode, "udp_mode", DLEP_IF_UDP_SINGLE_SESSION_STR,
     "Determines the UDP behavior of the radio. 'none' never sends/processes UDP, 'single_session' only does"
@@ -66,6 +66,8 @@ enum
 };
 
 static int _update_allowed_tlvs(struct dlep_session *session);
+static int _update_tlv_table(struct dlep_session_parser *parser);
+static void _free_tlv_table(struct dlep_session_parser *parser);
 static enum dlep_parser_error _parse_tlvstream(struct dlep_session *session, const uint8_t *buffer, size_t length);
 static enum dlep_parser_error _check_mandatory(
   struct dlep_session *session, struct dlep_extension *ext, int32_t signal_type);
@@ -209,6 +211,7 @@ dlep_session_remove(struct dlep_session *session) {
     avl_remove(&parser->allowed_tlvs, &tlv->_node);
     oonf_class_free(&_tlv_class, tlv);
   }
+  _free_tlv_table(parser);
 
   oonf_timer_stop(&session->local_event_timer);
   oonf_timer_stop(&session->remote_heartbeat_timeout);
@@ -762,9 +765,56 @@ _update_allowed_tlvs(struct dlep_session *session) {
     }
   }
 
+  return _update_tlv_table(parser);
+}
+
+/**
+ * Compile the tree of allowed TLVs into the lookup table
+ * used by the parser
+ * @param parser dlep session parser
+ * @return -1 if out of memory, 0 otherwise
+ */
+static int
+_update_tlv_table(struct dlep_session_parser *parser) {
+  struct dlep_parser_tlv *tlv;
+  struct dlep_parser_tlv **page;
+  size_t p;
+
+  /* clear existing pages */
+  for (p = 0; p < DLEP_PARSER_TLV_PAGES; p++) {
+    if (parser->tlv_table[p]) {
+      memset(parser->tlv_table[p], 0, sizeof(*page) * DLEP_PARSER_TLV_PAGE_SIZE);
+    }
+  }
+
+  avl_for_each_element(&parser->allowed_tlvs, tlv, _node) {
+    page = parser->tlv_table[tlv->id / DLEP_PARSER_TLV_PAGE_SIZE];
+    if (!page) {
+      page = calloc(DLEP_PARSER_TLV_PAGE_SIZE, sizeof(*page));
+      if (!page) {
+        return -1;
+      }
+      parser->tlv_table[tlv->id / DLEP_PARSER_TLV_PAGE_SIZE] = page;
+    }
+    page[tlv->id % DLEP_PARSER_TLV_PAGE_SIZE] = tlv;
+  }
   return 0;
 }
 
+/**
+ * Free the memory of the TLV lookup table
+ * @param parser dlep session parser
+ */
+static void
+_free_tlv_table(struct dlep_session_parser *parser) {
+  size_t p;
+
+  for (p = 0; p < DLEP_PARSER_TLV_PAGES; p++) {
+    free(parser->tlv_table[p]);
+    parser->tlv_table[p] = NULL;
+  }
+}
+
 /**
  * Check constraints of extensions and call the relevant callbacks
  * @param session dlep session
@@ -891,9 +941,14 @@ _parse_tlvstream(struct dlep_session *session, const uint8_t *buffer, size_t len
   tlv_count = 0;
   idx = 0;
 
-  avl_for_each_element(&parser->allowed_tlvs, tlv, _node) {
-    tlv->tlv_first = -1;
-    tlv->tlv_last = -1;
+  /* start new generation, this invalidates the values of all TLVs */
+  parser->_generation++;
+  if (parser->_generation == 0) {
+    /* overflow, make sure no TLV has the new generation */
+    avl_for_each_element(&parser->allowed_tlvs, tlv, _node) {
+      tlv->_generation = 0;
+    }
+    parser->_generation = 1;
   }
 
   while (idx < length) {
@@ -961,8 +1016,9 @@ _parse_tlvstream(struct dlep_session *session, const uint8_t *buffer, size_t len
     value->index = idx;
     value->length = tlv_length;
 
-    if (tlv->tlv_last == -1) {
+    if (tlv->_generation != parser->_generation) {
       /* first tlv */
+      tlv->_generation = parser->_generation;
       tlv->tlv_first = tlv_count;
     }
     else {
@@ -1017,7 +1073,7 @@ _check_mandatory(struct dlep_session *session, struct dlep_extension *ext, int32
       return DLEP_NEW_PARSER_INTERNAL_ERROR;
     }
 
-    if (tlv->tlv_first == -1) {
+    if (!dlep_parser_has_tlv_value(parser, tlv)) {
       OONF_WARN(session->log_source,
         "Missing mandatory TLV"
         " %u in extension %d",
@@ -1059,8 +1115,8 @@ _check_duplicate(struct dlep_session *session, struct dlep_extension *ext, int32
   }
 
   for (t = 0; t < extsig->supported_tlv_count; t++) {
-    tlv = avl_find_element(&parser->allowed_tlvs, &extsig->supported_tlvs[t], tlv, _node);
-    if (tlv == NULL || tlv->tlv_first == tlv->tlv_last) {
+    tlv = dlep_parser_get_tlv(parser, extsig->supported_tlvs[t]);
+    if (tlv == NULL || !dlep_parser_has_tlv_value(parser, tlv) || tlv->tlv_first == tlv->tlv_last) {
       continue;
     }
 
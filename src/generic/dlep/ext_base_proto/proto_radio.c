@@ -50,6 +50,7 @@
 
 #include <oonf/base/oonf_class.h>
 #include <oonf/base/oonf_layer2.h>
+#include <oonf/base/oonf_timer.h>
 
 #include <oonf/generic/dlep/dlep_extension.h>
 #include <oonf/generic/dlep/dlep_iana.h>
@@ -78,6 +79,7 @@ static void _l2_neigh_added_to_session(
   struct dlep_session *session, struct oonf_layer2_neigh *l2neigh, const struct oonf_layer2_neigh_key *mac);
 static void _l2_neigh_added(
   struct oonf_layer2_neigh *l2neigh, struct oonf_layer2_destination *l2dest, const struct oonf_layer2_neigh_key *mac);
+static void _schedule_update(struct dlep_session *session, struct dlep_local_neighbor *local);
 
 static void _cb_l2_net_changed(void *);
 
@@ -89,6 +91,7 @@ static void _cb_l2_dst_added(void *);
 static void _cb_l2_dst_removed(void *);
 
 static void _cb_destination_timeout(struct dlep_session *, struct dlep_local_neighbor *);
+static void _cb_send_updates(struct oonf_timer_instance *);
 
 static struct dlep_extension_implementation _radio_signals[] = {
   { .id = DLEP_UDP_PEER_DISCOVERY, .process = _radio_process_peer_discovery },
@@ -174,6 +177,11 @@ static struct oonf_class_extension _layer2_dst_listener = {
   .cb_remove = _cb_l2_dst_removed,
 };
 
+static struct oonf_timer_class _update_timer_class = {
+  .name = "dlep radio destination updates",
+  .callback = _cb_send_updates,
+};
+
 static struct dlep_extension *_base;
 
 /**
@@ -188,10 +196,24 @@ dlep_base_proto_radio_init(void) {
   oonf_class_extension_add(&_layer2_neigh_listener);
   oonf_class_extension_add(&_layer2_dst_listener);
 
+  oonf_timer_add(&_update_timer_class);
+
   _base->cb_session_init_radio = _cb_init_radio;
   _base->cb_session_cleanup_radio = _cb_cleanup_radio;
 }
 
+/**
+ * Cleanup the radios DLEP base protocol extension
+ */
+void
+dlep_base_proto_radio_cleanup(void) {
+  oonf_timer_remove(&_update_timer_class);
+
+  oonf_class_extension_remove(&_layer2_dst_listener);
+  oonf_class_extension_remove(&_layer2_neigh_listener);
+  oonf_class_extension_remove(&_layer2_net_listener);
+}
+
 /**
  * Callback to initialize the radio session
  * @param session dlep session
@@ -207,6 +229,7 @@ _cb_init_radio(struct dlep_session *session) {
   }
 
   session->cb_destination_timeout = _cb_destination_timeout;
+  session->update_timer.class = &_update_timer_class;
 }
 
 /**
@@ -216,6 +239,10 @@ _cb_init_radio(struct dlep_session *session) {
 static void
 _cb_cleanup_radio(struct dlep_session *session) {
   dlep_base_proto_stop_timers(session);
+  oonf_timer_stop(&session->update_timer);
+
+  OONF_DEBUG(session->log_source, "Destination updates: %u sent, %u suppressed", session->updates_sent,
+    session->updates_suppressed);
 
   oonf_class_extension_remove(&_layer2_net_listener);
   oonf_class_extension_remove(&_layer2_neigh_listener);
@@ -344,6 +371,7 @@ _radio_process_destination_up_ack(struct dlep_extension *ext __attribute__((unus
 
       if (local->changed) {
         dlep_session_generate_signal(session, DLEP_DESTINATION_UPDATE, &mac_lid);
+        session->updates_sent++;
         local->changed = false;
       }
     }
@@ -479,6 +507,34 @@ _l2_neigh_added_to_session(struct dlep_session *session, struct oonf_layer2_neig
   }
 }
 
+/**
+ * Mark a local neighbor as changed and schedule a destination update
+ * for it. All updates of a session within the update interval are
+ * sent together.
+ * @param session dlep session
+ * @param local local dlep neighbor
+ */
+static void
+_schedule_update(struct dlep_session *session, struct dlep_local_neighbor *local) {
+  if (local->changed) {
+    /* update is already pending */
+    session->updates_suppressed++;
+    return;
+  }
+
+  if (session->cfg.update_interval == 0) {
+    dlep_session_generate_signal(session, DLEP_DESTINATION_UPDATE, &local->key);
+    session->updates_sent++;
+    session->cb_send_buffer(session, 0);
+    return;
+  }
+
+  local->changed = true;
+  if (!oonf_timer_is_active(&session->update_timer)) {
+    oonf_timer_set(&session->update_timer, session->cfg.update_interval);
+  }
+}
+
 /**
  * Helper function triggered for a new layer2 neighbor
  * @param l2neigh layer2 neighbor
@@ -504,6 +560,7 @@ _l2_neigh_added(struct oonf_layer2_neigh *l2neigh, struct oonf_layer2_destinatio
       continue;
     }
     _l2_neigh_added_to_session(&radio_session->session, l2neigh, mac);
+    radio_session->session.cb_send_buffer(&radio_session->session, 0);
   }
 }
 
@@ -543,8 +600,7 @@ _l2_neigh_changed(
           local->changed = true;
           break;
         case DLEP_NEIGHBOR_UP_ACKED:
-          dlep_session_generate_signal(&radio_session->session, DLEP_DESTINATION_UPDATE, mac);
-          local->changed = false;
+          _schedule_update(&radio_session->session, local);
           break;
         case DLEP_NEIGHBOR_IDLE:
         case DLEP_NEIGHBOR_DOWN_SENT:
@@ -553,6 +609,7 @@ _l2_neigh_changed(
           local->state = DLEP_NEIGHBOR_UP_SENT;
           local->changed = false;
           oonf_timer_set(&local->_ack_timeout, radio_session->session.cfg.heartbeat_interval * 2);
+          radio_session->session.cb_send_buffer(&radio_session->session, 0);
           break;
         default:
           break;
@@ -597,7 +654,9 @@ _l2_neigh_removed(
 */
       dlep_session_generate_signal(&radio_session->session, DLEP_DESTINATION_DOWN, mac);
       local->state = DLEP_NEIGHBOR_DOWN_SENT;
+      local->changed = false;
       oonf_timer_set(&local->_ack_timeout, radio_session->session.cfg.heartbeat_interval * 2);
+      radio_session->session.cb_send_buffer(&radio_session->session, 0);
 //    }
   }
 }
@@ -701,3 +760,25 @@ static void
 _cb_destination_timeout(struct dlep_session *session, struct dlep_local_neighbor *local) {
   dlep_session_remove_local_neighbor(session, local);
 }
+
+/**
+ * Callback triggered to send all pending destination updates
+ * of a session in a single buffer
+ * @param ptr timer instance that fired
+ */
+static void
+_cb_send_updates(struct oonf_timer_instance *ptr) {
+  struct dlep_session *session;
+  struct dlep_local_neighbor *local;
+
+  session = container_of(ptr, struct dlep_session, update_timer);
+
+  avl_for_each_element(&session->local_neighbor_tree, local, _node) {
+    if (local->changed && local->state == DLEP_NEIGHBOR_UP_ACKED) {
+      dlep_session_generate_signal(session, DLEP_DESTINATION_UPDATE, &local->key);
+      session->updates_sent++;
+      local->changed = false;
+    }
+  }
+  session->cb_send_buffer(session, 0);
+}
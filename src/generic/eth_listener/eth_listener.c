@@ -69,21 +69,26 @@
  * Configuration object for eth listener
  */
 struct _eth_config {
-  /*! interval between two updates */
+  /*! minimal interval between two updates */
   uint64_t interval;
+
+  /*! maximal interval between two updates if link speeds are stable */
+  uint64_t max_interval;
 };
 
 /* prototypes */
 static int _init(void);
 static void _cleanup(void);
 
-static void _cb_transmission_event(struct oonf_timer_instance *);
+static void _cb_poll(struct oonf_layer2_poll *);
 static void _cb_config_changed(void);
 
 /* configuration */
 static struct cfg_schema_entry _eth_entries[] = {
   CFG_MAP_CLOCK_MIN(
     _eth_config, interval, "interval", "60.0", "Interval between two linklayer information updates", 100),
+  CFG_MAP_CLOCK_MIN(_eth_config, max_interval, "max_interval", "600.0",
+    "Longest interval between two linklayer information updates while the link speeds do not change", 100),
 };
 
 static struct cfg_schema_section _eth_section = {
@@ -116,15 +121,13 @@ static struct oonf_subsystem _eth_listener_subsystem = {
 };
 DECLARE_OONF_PLUGIN(_eth_listener_subsystem);
 
-/* timer for generating netlink requests */
-static struct oonf_timer_class _transmission_timer_info = {
-  .name = "nl80211 listener timer",
-  .callback = _cb_transmission_event,
-  .periodic = true,
+/* adaptive schedule for ethtool queries */
+static struct oonf_layer2_poll _eth_poll = {
+  .name = "ethernet listener",
+  .cost = 2,
+  .cb_poll = _cb_poll,
 };
 
-static struct oonf_timer_instance _transmission_timer = { .class = &_transmission_timer_info };
-
 static struct oonf_layer2_origin _l2_origin = {
   .name = "ethernet listener",
   .priority = OONF_LAYER2_ORIGIN_UNRELIABLE,
@@ -141,7 +144,6 @@ _init(void) {
     return -1;
   }
 
-  oonf_timer_add(&_transmission_timer_info);
   oonf_layer2_origin_add(&_l2_origin);
 
   return 0;
@@ -149,30 +151,30 @@ _init(void) {
 
 static void
 _cleanup(void) {
+  oonf_layer2_poll_remove(&_eth_poll);
   oonf_layer2_origin_remove(&_l2_origin);
 
-  oonf_timer_stop(&_transmission_timer);
-  oonf_timer_remove(&_transmission_timer_info);
-
   close(_ioctl_sock);
 }
 
 /**
  * Callback for querying ethernet status
- * @param ptr timer instance that fired
+ * @param poll layer2 poll schedule that fired
  */
 static void
-_cb_transmission_event(struct oonf_timer_instance *ptr __attribute((unused))) {
+_cb_poll(struct oonf_layer2_poll *poll) {
   struct oonf_layer2_net *l2net;
   struct os_interface *os_if;
   struct ethtool_cmd cmd;
   struct ifreq req;
   int64_t ethspeed;
+  bool changed;
   int err;
 #ifdef OONF_LOG_DEBUG_INFO
   struct isonumber_str ibuf;
 #endif
 
+  changed = false;
   avl_for_each_element(os_interface_get_tree(), os_if, _node) {
     /* initialize ethtool command */
     memset(&cmd, 0, sizeof(cmd));
@@ -223,9 +225,13 @@ _cb_transmission_event(struct oonf_timer_instance *ptr __attribute((unused))) {
     OONF_DEBUG(LOG_ETH, "Set default link speed of interface %s to %s", os_if->name,
       isonumber_from_s64(&ibuf, ethspeed, "bit/s", 0, false));
 
-    oonf_layer2_data_set_int64(&l2net->neighdata[OONF_LAYER2_NEIGH_RX_BITRATE], &_l2_origin, NULL, ethspeed, 1);
-    oonf_layer2_data_set_int64(&l2net->neighdata[OONF_LAYER2_NEIGH_TX_BITRATE], &_l2_origin, NULL, ethspeed, 1);
+    changed |= oonf_layer2_data_set_int64(
+      &l2net->neighdata[OONF_LAYER2_NEIGH_RX_BITRATE], &_l2_origin, NULL, ethspeed, 1);
+    changed |= oonf_layer2_data_set_int64(
+      &l2net->neighdata[OONF_LAYER2_NEIGH_TX_BITRATE], &_l2_origin, NULL, ethspeed, 1);
   }
+
+  oonf_layer2_poll_done(poll, changed);
 }
 
 static void
@@ -235,5 +241,12 @@ _cb_config_changed(void) {
     return;
   }
 
-  oonf_timer_set_ext(&_transmission_timer, 1, _config.interval);
+  if (!list_is_node_added(&_eth_poll._node)) {
+    _eth_poll.min_interval = _config.interval;
+    _eth_poll.max_interval = _config.max_interval;
+    oonf_layer2_poll_add(&_eth_poll);
+  }
+  else {
+    oonf_layer2_poll_set_bounds(&_eth_poll, _config.interval, _config.max_interval);
+  }
 }
@@ -82,6 +82,7 @@ static void _initialize_neigh_origin_values(struct oonf_layer2_data *data);
 static void _initialize_neigh_values(struct oonf_layer2_neigh *neigh);
 static void _initialize_neigh_ip_values(struct oonf_layer2_neighbor_address *neigh_addr);
 static void _initialize_origin_values(struct oonf_layer2_origin *l2origin);
+static void _initialize_poll_values(struct oonf_viewer_template *template, struct oonf_layer2_poll *poll);
 
 static int _cb_create_text_interface(struct oonf_viewer_template *);
 static int _cb_create_text_interface_ip(struct oonf_viewer_template *);
@@ -90,6 +91,7 @@ static int _cb_create_text_neighbor_ip(struct oonf_viewer_template *);
 static int _cb_create_text_default(struct oonf_viewer_template *);
 static int _cb_create_text_dst(struct oonf_viewer_template *);
 static int _cb_create_text_origin(struct oonf_viewer_template *);
+static int _cb_create_text_poll(struct oonf_viewer_template *);
 
 /*
  * list of template keys and corresponding buffers for values.
@@ -184,6 +186,30 @@ static int _cb_create_text_origin(struct oonf_viewer_template *);
 /*! template key for origin LID index */
 #define KEY_ORIGIN_LID_INDEX "origin_lid_index"
 
+/*! template key for name of poll schedule */
+#define KEY_POLL_NAME "poll_name"
+
+/*! template key for current poll interval */
+#define KEY_POLL_INTERVAL "poll_interval"
+
+/*! template key for minimal poll interval */
+#define KEY_POLL_MIN_INTERVAL "poll_min_interval"
+
+/*! template key for maximal poll interval */
+#define KEY_POLL_MAX_INTERVAL "poll_max_interval"
+
+/*! template key for query cost of poll */
+#define KEY_POLL_COST "poll_cost"
+
+/*! template key for volatility of polled data */
+#define KEY_POLL_VOLATILITY "poll_volatility"
+
+/*! template key for number of polls */
+#define KEY_POLL_COUNT "poll_count"
+
+/*! template key for number of polls that changed data */
+#define KEY_POLL_CHANGED "poll_changed"
+
 /*
  * buffer space for values that will be assembled
  * into the output of the plugin
@@ -218,6 +244,14 @@ static char _value_origin_proactive[TEMPLATE_JSON_BOOL_LENGTH];
 static char _value_origin_priority[10];
 static char _value_origin_lid[TEMPLATE_JSON_BOOL_LENGTH];
 static char _value_origin_lid_index[10];
+static char _value_poll_name[32];
+static struct isonumber_str _value_poll_interval;
+static struct isonumber_str _value_poll_min_interval;
+static struct isonumber_str _value_poll_max_interval;
+static char _value_poll_cost[11];
+static char _value_poll_volatility[11];
+static char _value_poll_count[11];
+static char _value_poll_changed[11];
 
 /* definition of the template data entries for JSON and table output */
 static struct abuf_template_data_entry _tde_if_key[] = {
@@ -278,6 +312,17 @@ static struct abuf_template_data_entry _tde_origin[] = {
   { KEY_ORIGIN_LID_INDEX, _value_origin_lid_index, false },
 };
 
+static struct abuf_template_data_entry _tde_poll[] = {
+  { KEY_POLL_NAME, _value_poll_name, true },
+  { KEY_POLL_INTERVAL, _value_poll_interval.buf, false },
+  { KEY_POLL_MIN_INTERVAL, _value_poll_min_interval.buf, false },
+  { KEY_POLL_MAX_INTERVAL, _value_poll_max_interval.buf, false },
+  { KEY_POLL_COST, _value_poll_cost, false },
+  { KEY_POLL_VOLATILITY, _value_poll_volatility, false },
+  { KEY_POLL_COUNT, _value_poll_count, false },
+  { KEY_POLL_CHANGED, _value_poll_changed, false },
+};
+
 static struct abuf_template_storage _template_storage;
 static struct autobuf _key_storage;
 
@@ -318,6 +363,9 @@ static struct abuf_template_data _td_dst[] = {
 static struct abuf_template_data _td_origin[] = {
   { _tde_origin, ARRAYSIZE(_tde_origin) },
 };
+static struct abuf_template_data _td_poll[] = {
+  { _tde_poll, ARRAYSIZE(_tde_poll) },
+};
 
 /* OONF viewer templates (based on Template Data arrays) */
 static struct oonf_viewer_template _templates[] = {
@@ -363,6 +411,12 @@ static struct oonf_viewer_template _templates[] = {
     .json_name = "origin",
     .cb_function = _cb_create_text_origin,
   },
+  {
+    .data = _td_poll,
+    .data_size = ARRAYSIZE(_td_poll),
+    .json_name = "poll",
+    .cb_function = _cb_create_text_poll,
+  },
 };
 
 /* telnet command of this plugin */
@@ -647,6 +701,23 @@ _initialize_origin_values(struct oonf_layer2_origin *l2origin) {
   snprintf(_value_origin_lid_index, sizeof(_value_origin_lid_index), "%u", l2origin->lid_index);
 }
 
+/**
+ * Initialize the value buffers for a layer2 poll schedule
+ * @param template viewer template
+ * @param poll layer2 poll schedule
+ */
+static void
+_initialize_poll_values(struct oonf_viewer_template *template, struct oonf_layer2_poll *poll) {
+  strscpy(_value_poll_name, poll->name, sizeof(_value_poll_name));
+  oonf_clock_toIntervalString_ext(&_value_poll_interval, poll->interval, template->create_raw);
+  oonf_clock_toIntervalString_ext(&_value_poll_min_interval, poll->min_interval, template->create_raw);
+  oonf_clock_toIntervalString_ext(&_value_poll_max_interval, poll->max_interval, template->create_raw);
+  snprintf(_value_poll_cost, sizeof(_value_poll_cost), "%u", poll->cost);
+  snprintf(_value_poll_volatility, sizeof(_value_poll_volatility), "%u", poll->volatility);
+  snprintf(_value_poll_count, sizeof(_value_poll_count), "%u", poll->polls);
+  snprintf(_value_poll_changed, sizeof(_value_poll_changed), "%u", poll->changed_polls);
+}
+
 /**
  * Callback to generate text/json description of all layer2 interfaces
  * @param template viewer template
@@ -807,3 +878,21 @@ _cb_create_text_origin(struct oonf_viewer_template *template) {
   }
   return 0;
 }
+
+/**
+ * Callback to generate text/json description of all layer2 poll schedules
+ * @param template viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_poll(struct oonf_viewer_template *template) {
+  struct oonf_layer2_poll *poll;
+
+  list_for_each_element(oonf_layer2_get_poll_list(), poll, _node) {
+    _initialize_poll_values(template, poll);
+
+    /* generate template output */
+    oonf_viewer_output_print_line(template);
+  }
+  return 0;
+}
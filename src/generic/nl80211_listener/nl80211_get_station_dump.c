@@ -87,6 +87,7 @@
 #include <oonf/generic/nl80211_listener/nl80211_internal.h>
 #include <oonf/generic/nl80211_listener/nl80211_listener.h>
 
+static void _process_station(struct nl80211_if *interf, struct nlmsghdr *hdr, bool full_dump);
 static bool _handle_traffic(struct oonf_layer2_neigh *l2neigh, enum oonf_layer2_neighbor_index idx, uint32_t new_32bit);
 static int64_t _get_bitrate(struct nlattr *bitrate_attr);
 
@@ -116,12 +117,71 @@ nl80211_send_get_station_dump(
  */
 void
 nl80211_process_get_station_dump_result(struct nl80211_if *interf, struct nlmsghdr *hdr) {
+  _process_station(interf, hdr, true);
+}
+
+/**
+ * Process NL80211_CMD_NEW_STATION multicast event. Only the data
+ * contained in the event is updated, older values of the station stay
+ * in the database until the next full station dump.
+ * @param interf nl80211 listener interface
+ * @param hdr pointer to netlink message header
+ */
+void
+nl80211_process_new_station_event(struct nl80211_if *interf, struct nlmsghdr *hdr) {
+  _process_station(interf, hdr, false);
+}
+
+/**
+ * Process NL80211_CMD_DEL_STATION multicast event
+ * @param interf nl80211 listener interface
+ * @param hdr pointer to netlink message header
+ */
+void
+nl80211_process_del_station_event(struct nl80211_if *interf, struct nlmsghdr *hdr) {
+  struct oonf_layer2_neigh *l2neigh;
+  struct netaddr l2neigh_mac;
+  struct nlattr *tb[NL80211_ATTR_MAX + 1];
+  struct genlmsghdr *gnlh;
+#ifdef OONF_LOG_DEBUG_INFO
+  struct netaddr_str nbuf;
+#endif
+
+  gnlh = nlmsg_data(hdr);
+
+  nla_parse(tb, NL80211_ATTR_MAX, genlmsg_attrdata(gnlh, 0), genlmsg_attrlen(gnlh, 0), NULL);
+
+  if (!tb[NL80211_ATTR_MAC]) {
+    /* station address missing */
+    return;
+  }
+
+  netaddr_from_binary(&l2neigh_mac, nla_data(tb[NL80211_ATTR_MAC]), 6, AF_MAC48);
+
+  OONF_DEBUG(LOG_NL80211, "Station %s left interface %s", netaddr_to_string(&nbuf, &l2neigh_mac), interf->name);
+
+  l2neigh = oonf_layer2_neigh_get(interf->l2net, &l2neigh_mac);
+  if (l2neigh) {
+    nl80211_remove_l2neigh(l2neigh);
+  }
+}
+
+/**
+ * Process a netlink message with station information
+ * @param interf nl80211 listener interface
+ * @param hdr pointer to netlink message header
+ * @param full_dump true if message is part of a full station dump,
+ *   false if it is a multicast event
+ */
+static void
+_process_station(struct nl80211_if *interf, struct nlmsghdr *hdr, bool full_dump) {
   struct oonf_layer2_neigh *l2neigh;
   struct netaddr l2neigh_mac;
 
   struct nlattr *tb[NL80211_ATTR_MAX + 1];
   struct genlmsghdr *gnlh;
   struct nlattr *sinfo[NL80211_STA_INFO_MAX + 1];
+  bool changed = false;
   static struct nla_policy stats_policy[NL80211_STA_INFO_MAX + 1] = {
     [NL80211_STA_INFO_INACTIVE_TIME] = { .type = NLA_U32 },
     [NL80211_STA_INFO_RX_BYTES] = { .type = NLA_U32 },
@@ -152,6 +212,10 @@ nl80211_process_get_station_dump_result(struct nl80211_if *interf, struct nlmsgh
     return;
   }
 
+  if (!tb[NL80211_ATTR_IFINDEX] || !tb[NL80211_ATTR_MAC]) {
+    /* interface or station address missing */
+    return;
+  }
   if (nl80211_get_if_baseindex(interf) != nla_get_u32(tb[NL80211_ATTR_IFINDEX])) {
     /* wrong interface */
     return;
@@ -174,37 +238,37 @@ nl80211_process_get_station_dump_result(struct nl80211_if *interf, struct nlmsgh
 
   /* byte data is 64 bit */
   if (sinfo[NL80211_STA_INFO_RX_BYTES64]) {
-    nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_RX_BYTES, nla_get_u64(sinfo[NL80211_STA_INFO_RX_BYTES64]),1 );
+    changed |= nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_RX_BYTES, nla_get_u64(sinfo[NL80211_STA_INFO_RX_BYTES64]),1 );
   }
   if (sinfo[NL80211_STA_INFO_TX_BYTES64]) {
-    nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_TX_BYTES, nla_get_u64(sinfo[NL80211_STA_INFO_TX_BYTES64]), 1);
+    changed |= nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_TX_BYTES, nla_get_u64(sinfo[NL80211_STA_INFO_TX_BYTES64]), 1);
   }
 
   /* packet data is only 32 bit */
   if (sinfo[NL80211_STA_INFO_RX_PACKETS]) {
-    _handle_traffic(l2neigh, OONF_LAYER2_NEIGH_RX_FRAMES, nla_get_u32(sinfo[NL80211_STA_INFO_RX_PACKETS]));
+    changed |= _handle_traffic(l2neigh, OONF_LAYER2_NEIGH_RX_FRAMES, nla_get_u32(sinfo[NL80211_STA_INFO_RX_PACKETS]));
   }
   if (sinfo[NL80211_STA_INFO_TX_PACKETS]) {
-    _handle_traffic(l2neigh, OONF_LAYER2_NEIGH_TX_FRAMES, nla_get_u32(sinfo[NL80211_STA_INFO_TX_PACKETS]));
+    changed |= _handle_traffic(l2neigh, OONF_LAYER2_NEIGH_TX_FRAMES, nla_get_u32(sinfo[NL80211_STA_INFO_TX_PACKETS]));
   }
   if (sinfo[NL80211_STA_INFO_TX_RETRIES]) {
-    _handle_traffic(l2neigh, OONF_LAYER2_NEIGH_TX_RETRIES, nla_get_u32(sinfo[NL80211_STA_INFO_TX_RETRIES]));
+    changed |= _handle_traffic(l2neigh, OONF_LAYER2_NEIGH_TX_RETRIES, nla_get_u32(sinfo[NL80211_STA_INFO_TX_RETRIES]));
   }
   if (sinfo[NL80211_STA_INFO_TX_FAILED]) {
-    _handle_traffic(l2neigh, OONF_LAYER2_NEIGH_TX_FAILED, nla_get_u32(sinfo[NL80211_STA_INFO_TX_FAILED]));
+    changed |= _handle_traffic(l2neigh, OONF_LAYER2_NEIGH_TX_FAILED, nla_get_u32(sinfo[NL80211_STA_INFO_TX_FAILED]));
   }
 
   /* bitrates are special */
   if (sinfo[NL80211_STA_INFO_TX_BITRATE]) {
     int64_t rate = _get_bitrate(sinfo[NL80211_STA_INFO_TX_BITRATE]);
     if (rate) {
-      nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_TX_BITRATE, rate, 1);
+      changed |= nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_TX_BITRATE, rate, 1);
     }
   }
   if (sinfo[NL80211_STA_INFO_RX_BITRATE]) {
     int64_t rate = _get_bitrate(sinfo[NL80211_STA_INFO_RX_BITRATE]);
     if (rate) {
-      nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_RX_BITRATE, rate, 1);
+      changed |= nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_RX_BITRATE, rate, 1);
     }
   }
 
@@ -215,7 +279,7 @@ nl80211_process_get_station_dump_result(struct nl80211_if *interf, struct nlmsgh
     rate = nla_get_u32(sinfo[NL80211_STA_INFO_EXPECTED_THROUGHPUT]);
 
     /* convert in bps */
-    nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_TX_THROUGHPUT, rate * 1024ll, 1);
+    changed |= nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_TX_THROUGHPUT, rate * 1024ll, 1);
   }
 
   /* signal strength is special too */
@@ -223,11 +287,14 @@ nl80211_process_get_station_dump_result(struct nl80211_if *interf, struct nlmsgh
     int8_t signal;
 
     signal = nla_get_u8(sinfo[NL80211_STA_INFO_SIGNAL]);
-    nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_RX_SIGNAL, signal, 1);
+    changed |= nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_RX_SIGNAL, signal, 1);
   }
 
-  /* remove old data */
-  nl80211_cleanup_l2neigh_data(l2neigh);
+  if (full_dump) {
+    /* remove old data */
+    nl80211_cleanup_l2neigh_data(l2neigh);
+    interf->neighdata_changed |= changed;
+  }
 
   /* and commit the changes */
   oonf_layer2_neigh_commit(l2neigh);
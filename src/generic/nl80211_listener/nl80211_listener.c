@@ -53,12 +53,13 @@
 #include <linux/netlink.h>
 #include <linux/types.h>
 #include <netlink/attr.h>
+#include <netlink/genl/genl.h>
 #include <netlink/msg.h>
-#include <sys/uio.h>
 
 #include <oonf/libcommon/autobuf.h>
 #include <oonf/libcommon/avl.h>
 #include <oonf/libcommon/avl_comp.h>
+#include <oonf/libcommon/container_of.h>
 #include <oonf/oonf.h>
 #include <oonf/libcommon/netaddr.h>
 #include <oonf/libcommon/netaddr_acl.h>
@@ -69,6 +70,7 @@
 #include <oonf/libcore/oonf_logging.h>
 #include <oonf/libcore/oonf_subsystem.h>
 #include <oonf/base/oonf_class.h>
+#include <oonf/base/oonf_clock.h>
 #include <oonf/base/oonf_layer2.h>
 #include <oonf/base/oonf_timer.h>
 #include <oonf/base/os_interface.h>
@@ -89,9 +91,15 @@
  * nl80211 configuration
  */
 struct _nl80211_config {
-  /*! interval between two series of netlink probes */
+  /*! minimal interval between two series of netlink probes */
   uint64_t interval;
 
+  /*! maximal interval between two series of netlink probes */
+  uint64_t max_interval;
+
+  /*! interval between two full station dumps */
+  uint64_t station_interval;
+
   /*! true if plugin should set multicast rate in the l2 db */
   bool report_multicast_rate;
 };
@@ -132,6 +140,8 @@ struct _nl80211_query {
 enum _nl80211_cfg_idx
 {
   IDX_INTERVAL,
+  IDX_MAX_INTERVAL,
+  IDX_STATION_INTERVAL,
   IDX_INTERFACES,
   IDX_MC_RATE,
 };
@@ -166,10 +176,13 @@ static void _nl80211_if_remove(struct nl80211_if *);
 static void _cb_config_changed(void);
 static void _cb_if_config_changed(void);
 
-static void _cb_transmission_event(struct oonf_timer_instance *);
-static void _trigger_next_netlink_query(void);
+static void _cb_poll(struct oonf_layer2_poll *);
+static void _trigger_family_query(void);
+static void _start_if_queries(struct nl80211_if *interf);
+static void _trigger_next_if_query(struct nl80211_if *interf);
 
 static void _cb_nl_response(struct os_system_netlink_message* nl_msg, struct nlmsghdr* hdr);
+static void _cb_nl_multicast(struct os_system_netlink *nl, struct nlmsghdr *hdr);
 static void _cb_nl_feedback(struct os_system_netlink_message *nl);
 
 /* configuration */
@@ -184,6 +197,12 @@ static struct cfg_schema_section _if_section = {
 static struct cfg_schema_entry _nl80211_entries[] = {
   [IDX_INTERVAL] = CFG_MAP_CLOCK_MIN(
     _nl80211_config, interval, "interval", "1.0", "Interval between two linklayer information updates", 100),
+  [IDX_MAX_INTERVAL] = CFG_MAP_CLOCK_MIN(_nl80211_config, max_interval, "max_interval", "5.0",
+    "Longest interval between two linklayer information updates while the data of an interface"
+    " and its stations does not change", 100),
+  [IDX_STATION_INTERVAL] = CFG_MAP_CLOCK_MIN(_nl80211_config, station_interval, "station_interval", "1.0",
+    "Interval between two full station dumps. New and lost stations are reported by nl80211 events in between,"
+    " so this only controls how fresh the per-station counters, rates and signal values are.", 100),
   [IDX_INTERFACES] = CFG_VALIDATE_PRINTABLE_LEN(
     "if", "", "List of additional interfaces to read nl80211 data from", IF_NAMESIZE, .list = true),
   [IDX_MC_RATE] = CFG_MAP_BOOL(_nl80211_config, report_multicast_rate, "report_mc_rate", "false",
@@ -203,6 +222,7 @@ static struct _nl80211_config _config;
 /* plugin declaration */
 static const char *_dependencies[] = {
   OONF_CLASS_SUBSYSTEM,
+  OONF_CLOCK_SUBSYSTEM,
   OONF_LAYER2_SUBSYSTEM,
   OONF_TIMER_SUBSYSTEM,
   OONF_OS_INTERFACE_SUBSYSTEM,
@@ -226,28 +246,29 @@ DECLARE_OONF_PLUGIN(_nl80211_listener_subsystem);
 
 enum oonf_log_source LOG_NL80211;
 
+/* netlink nl80211 identification */
+static uint32_t _nl80211_id = 0;
+static uint32_t _nl80211_multicast_group = 0;
+
 /* netlink specific data */
 static struct os_system_netlink _netlink_handler = {
   .name = "nl80211 listener",
   .used_by = &_nl80211_listener_subsystem,
+  .multicast_messages = &_nl80211_id,
   .cb_response = _cb_nl_response,
+  .cb_multicast = _cb_nl_multicast,
   .cb_error = _cb_nl_feedback,
   .cb_done = _cb_nl_feedback,
 };
 
-/* buffer for outgoing netlink message */
-static uint32_t _nl_msgbuffer[UIO_MAXIOV / sizeof(uint32_t)];
-static struct nlmsghdr *_nl_msg = (void *)_nl_msgbuffer;
-static struct os_system_netlink_message os_nl_msg = {
-  .message = (void *)_nl_msgbuffer,
-  .max_length = sizeof(_nl_msgbuffer),
+/* buffer for outgoing netlink family query */
+static uint32_t _family_msgbuffer[NL80211_IF_QUERY_BUFFER_SIZE / sizeof(uint32_t)];
+static struct os_system_netlink_message _family_msg = {
+  .message = (void *)_family_msgbuffer,
+  .max_length = sizeof(_family_msgbuffer),
   .originator = &_netlink_handler,
 };
 
-/* netlink nl80211 identification */
-static uint32_t _nl80211_id = 0;
-static uint32_t _nl80211_multicast_group = 0;
-
 /* layer2 metadata */
 static struct oonf_layer2_origin _layer2_updated_origin = {
   .name = "nl80211 updated",
@@ -260,19 +281,6 @@ static struct oonf_layer2_origin _layer2_data_origin = {
   .priority = OONF_LAYER2_ORIGIN_RELIABLE,
 };
 
-/* current query data */
-static struct nl80211_if *_current_query_if = NULL;
-static enum _if_query _current_query_number = QUERY_START;
-static bool _current_query_in_progress = false;
-
-/* timer for generating netlink requests */
-static struct oonf_timer_class _transmission_timer_info = {
-  .name = "nl80211 listener timer",
-  .callback = _cb_transmission_event,
-  .periodic = true,
-};
-
-static struct oonf_timer_instance _transmission_timer = { .class = &_transmission_timer_info };
 
 /* nl80211_if handling */
 static struct avl_tree _nl80211_if_tree;
@@ -342,8 +350,6 @@ _init(void) {
   /* get layer2 origin */
   oonf_layer2_origin_add(&_layer2_updated_origin);
   oonf_layer2_origin_add(&_layer2_data_origin);
-
-  oonf_timer_add(&_transmission_timer_info);
   return 0;
 }
 
@@ -359,8 +365,7 @@ _cleanup(void) {
   oonf_layer2_origin_remove(&_layer2_updated_origin);
   oonf_layer2_origin_remove(&_layer2_data_origin);
 
-  oonf_timer_stop(&_transmission_timer);
-  oonf_timer_remove(&_transmission_timer_info);
+  os_system_linux_netlink_interrupt(&_family_msg);
   os_system_linux_netlink_remove(&_netlink_handler);
 }
 
@@ -420,6 +425,18 @@ nl80211_cleanup_l2neigh_data(struct oonf_layer2_neigh *l2neigh) {
   oonf_layer2_neigh_cleanup(l2neigh, &_layer2_data_origin);
 }
 
+/**
+ * Remove all data generated by this listener from a layer2 neighbor
+ * and commit the change, which might remove the neighbor
+ * @param l2neigh pointer to layer2 neighbor
+ */
+void
+nl80211_remove_l2neigh(struct oonf_layer2_neigh *l2neigh) {
+  /* move everything to one origin so a single remove call cleans it up */
+  oonf_layer2_neigh_relabel(l2neigh, &_layer2_data_origin, &_layer2_updated_origin);
+  oonf_layer2_neigh_remove(l2neigh, &_layer2_data_origin);
+}
+
 /**
  * Change a layer2 neighbor setting
  * @param l2neigh pointer to layer2 neighbor
@@ -496,6 +513,19 @@ _nl80211_if_add(const char *name) {
   /* initialize interface */
   interf->wifi_phy_if = -1;
 
+  /* initialize netlink query message */
+  interf->_nl_msg.message = (void *)interf->_nl_msgbuffer;
+  interf->_nl_msg.max_length = sizeof(interf->_nl_msgbuffer);
+  interf->_nl_msg.originator = &_netlink_handler;
+
+  /* initialize adaptive query schedule */
+  snprintf(interf->_poll.name, sizeof(interf->_poll.name), "nl80211 %s", interf->name);
+  interf->_poll.cb_poll = _cb_poll;
+  interf->_poll.cost = 1;
+  interf->_poll.min_interval = _config.interval;
+  interf->_poll.max_interval = _config.max_interval;
+  oonf_layer2_poll_add(&interf->_poll);
+
   OONF_DEBUG(LOG_NL80211, "Add if %s", name);
   avl_insert(&_nl80211_if_tree, &interf->_node);
   return interf;
@@ -507,6 +537,8 @@ _nl80211_if_add(const char *name) {
  */
 static void
 _nl80211_if_remove(struct nl80211_if *interf) {
+  oonf_layer2_poll_remove(&interf->_poll);
+  os_system_linux_netlink_interrupt(&interf->_nl_msg);
   avl_remove(&_nl80211_if_tree, &interf->_node);
   os_interface_remove(&interf->if_listener);
   oonf_class_free(&_nl80211_if_class, interf);
@@ -541,140 +573,220 @@ _cb_if_config_changed(void) {
 }
 
 /**
- * Transmit the next netlink command to nl80211
- * @param ptr timer instance that fired
+ * Get a nl80211 interface by its interface index
+ * @param if_index interface index
+ * @return nl80211 interface, NULL if not found
+ */
+static struct nl80211_if *
+_nl80211_if_get_by_index(unsigned if_index) {
+  struct nl80211_if *interf;
+
+  avl_for_each_element(&_nl80211_if_tree, interf, _node) {
+    if (interf->if_listener.data && nl80211_get_if_baseindex(interf) == if_index) {
+      return interf;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Start the next series of netlink queries of an interface. Each
+ * interface runs its own adaptive schedule, so the queries of
+ * different interfaces are queued independently.
+ * @param poll layer2 poll schedule that fired
  */
 static void
-_cb_transmission_event(struct oonf_timer_instance *ptr __attribute__((unused))) {
-  if (!_current_query_in_progress) {
-    _trigger_next_netlink_query();
+_cb_poll(struct oonf_layer2_poll *poll) {
+  struct nl80211_if *interf;
+
+  if (!_nl80211_id || !_nl80211_multicast_group) {
+    _trigger_family_query();
+    return;
+  }
+
+  interf = container_of(poll, struct nl80211_if, _poll);
+  if (!interf->_query_in_progress) {
+    _start_if_queries(interf);
   }
 }
 
 /**
  * Send a netlink message to the nl80211 subsystem
- * @param interf nl80211 interface for message
+ * @param nl_msg netlink message buffer to use
+ * @param interf nl80211 interface for message, NULL for family query
  * @param query query id
  */
 static void
-_send_netlink_message(struct nl80211_if *interf, enum _if_query query) {
+_send_netlink_message(struct os_system_netlink_message *nl_msg, struct nl80211_if *interf, enum _if_query query) {
   struct genlmsghdr *hdr;
 
-  memset(&_nl_msgbuffer, 0, sizeof(_nl_msgbuffer));
+  memset(nl_msg->message, 0, nl_msg->max_length);
 
   /* generic netlink initialization */
-  _nl_msg->nlmsg_len = NLMSG_LENGTH(sizeof(struct genlmsghdr));
-  _nl_msg->nlmsg_flags = NLM_F_REQUEST;
+  nl_msg->message->nlmsg_len = NLMSG_LENGTH(sizeof(struct genlmsghdr));
+  nl_msg->message->nlmsg_flags = NLM_F_REQUEST;
 
   /* request nl80211 identifier */
   if (query == QUERY_GET_FAMILY) {
     /* request nl80211 identifier */
-    _nl_msg->nlmsg_type = GENL_ID_CTRL;
+    nl_msg->message->nlmsg_type = GENL_ID_CTRL;
   }
   else {
-    _nl_msg->nlmsg_type = _nl80211_id;
+    nl_msg->message->nlmsg_type = _nl80211_id;
   }
 
-  hdr = NLMSG_DATA(_nl_msg);
+  hdr = NLMSG_DATA(nl_msg->message);
 
   if (query < QUERY_END) {
     OONF_DEBUG(LOG_NL80211, "Get query %d for interface %s", query, interf->name);
   }
 
   if (query == QUERY_GET_FAMILY) {
-    genl_send_get_family(_nl_msg, hdr);
+    genl_send_get_family(nl_msg->message, hdr);
   }
   else if (_if_query_ops[query].send) {
-    _if_query_ops[query].send(&os_nl_msg, hdr, interf);
+    _if_query_ops[query].send(nl_msg, hdr, interf);
   }
 
-  os_system_linux_netlink_send(&_netlink_handler, &os_nl_msg);
+  os_system_linux_netlink_send(&_netlink_handler, nl_msg);
 }
 
 /**
- * Proceed to next query
+ * Request the nl80211 family id and multicast group
  */
 static void
-_get_next_query(void) {
-  if (avl_is_empty(&_nl80211_if_tree)) {
-    OONF_DEBUG(LOG_NL80211, "No nl80211 interfaces");
-    _current_query_if = NULL;
+_trigger_family_query(void) {
+  if (list_is_node_added(&_family_msg._node)) {
+    /* query still queued or waiting for response */
     return;
   }
 
-  /* no query left to do? start again at the first */
-  if (!_current_query_if) {
-    /* start with first interface and query */
-    _current_query_if = avl_first_element(&_nl80211_if_tree, _current_query_if, _node);
-    _current_query_number = QUERY_START;
-    _current_query_in_progress = true;
+  /* first we need to get the ID and multicast group */
+  OONF_DEBUG(LOG_NL80211, "Get nl80211 family and multicast id");
+  _send_netlink_message(&_family_msg, NULL, QUERY_GET_FAMILY);
+}
+
+/**
+ * Subscribe to the nl80211 multicast events and start the
+ * first series of queries for all interfaces
+ */
+static void
+_finish_family_query(void) {
+  struct nl80211_if *interf;
+
+  if (!_nl80211_id || !_nl80211_multicast_group) {
+    return;
+  }
+
+  if (_netlink_handler.multicast_message_count == 0) {
+    if (os_system_linux_netlink_add_mc(&_netlink_handler, &_nl80211_multicast_group, 1)) {
+      OONF_WARN(LOG_NL80211, "Could not subscribe to nl80211 events, station changes are only read by dumps");
+    }
+    else {
+      OONF_INFO(LOG_NL80211, "Subscribed to nl80211 multicast group %u", _nl80211_multicast_group);
+      _netlink_handler.multicast_message_count = 1;
+    }
   }
-  else {
-    /* next query */
-    _current_query_number++;
-
-    if (_current_query_number == QUERY_END) {
-      /* commit interface data */
-      if (_current_query_if->ifdata_changed) {
-        /* set fixed flags for nl80211 data */
-        oonf_layer2_data_set_bool(
-          &_current_query_if->l2net->data[OONF_LAYER2_NET_MCS_BY_PROBING], &_layer2_updated_origin, NULL, true);
-
-        /* cleanup old data and relable new one, then commit everything */
-        oonf_layer2_net_cleanup(_current_query_if->l2net, &_layer2_data_origin, true);
-        oonf_layer2_net_relabel(_current_query_if->l2net, &_layer2_data_origin, &_layer2_updated_origin);
-        oonf_layer2_net_commit(_current_query_if->l2net);
-        _current_query_if->ifdata_changed = false;
-      }
 
-      _current_query_if = avl_next_element_safe(&_nl80211_if_tree, _current_query_if, _node);
-      _current_query_number = QUERY_START;
+  avl_for_each_element(&_nl80211_if_tree, interf, _node) {
+    if (!interf->_query_in_progress) {
+      _start_if_queries(interf);
     }
   }
 }
 
 /**
- * Trigger the next netlink query
+ * Start a new series of queries for a nl80211 interface
+ * @param interf nl80211 interface
  */
 static void
-_trigger_next_netlink_query(void) {
-  if (!_nl80211_id || !_nl80211_multicast_group) {
-    if (_current_query_in_progress) {
-      /* wait for the next timer */
-      _current_query_in_progress = false;
-      return;
-    }
+_start_if_queries(struct nl80211_if *interf) {
+  if (!interf->if_listener.data->flags.up) {
+    /* ignore interfaces that are down */
+    return;
+  }
+
+  /* allow half a query interval of jitter before skipping the station dump */
+  interf->_station_dump = oonf_clock_is_past(interf->_next_station_dump);
+  if (interf->_station_dump) {
+    interf->_next_station_dump =
+      oonf_clock_get_absolute((int64_t)_config.station_interval - (int64_t)(interf->_poll.min_interval / 2));
+  }
+
+  interf->_query_in_progress = true;
+  interf->_query = QUERY_START;
+
+  OONF_INFO(LOG_NL80211, "Sending query %u to interface %s", interf->_query, interf->name);
+  _send_netlink_message(&interf->_nl_msg, interf, interf->_query);
+}
 
-    /* first we need to get the ID and multicast group */
-    OONF_DEBUG(LOG_NL80211, "Get nl80211 family and multicast id");
-    _current_query_in_progress = true;
-    _send_netlink_message(NULL, QUERY_GET_FAMILY);
+/**
+ * Commit the data collected by a series of queries of an interface
+ * @param interf nl80211 interface
+ */
+static void
+_commit_if_data(struct nl80211_if *interf) {
+  if (!interf->ifdata_changed) {
     return;
   }
 
-  /* calculate next interface/query, ignore interfaces that are down */
+  /* set fixed flags for nl80211 data */
+  oonf_layer2_data_set_bool(
+    &interf->l2net->data[OONF_LAYER2_NET_MCS_BY_PROBING], &_layer2_updated_origin, NULL, true);
+
+  /*
+   * cleanup old data and relable new one, then commit everything. Neighbor
+   * data is only outdated if this series contained a full station dump.
+   */
+  oonf_layer2_net_cleanup(interf->l2net, &_layer2_data_origin, interf->_station_dump);
+  oonf_layer2_net_relabel(interf->l2net, &_layer2_data_origin, &_layer2_updated_origin);
+  oonf_layer2_net_commit(interf->l2net);
+  interf->ifdata_changed = false;
+}
+
+/**
+ * Trigger the next netlink query of an interface
+ * @param interf nl80211 interface
+ */
+static void
+_trigger_next_if_query(struct nl80211_if *interf) {
+  bool changed;
+
   do {
-    _get_next_query();
-  } while (_current_query_if && !_current_query_if->if_listener.data->flags.up);
+    interf->_query++;
+  } while (interf->_query == QUERY_GET_STATION && !interf->_station_dump);
+
+  if (interf->_query == QUERY_END) {
+    changed = interf->ifdata_changed || interf->neighdata_changed;
+    interf->neighdata_changed = false;
+
+    _commit_if_data(interf);
+    oonf_layer2_poll_done(&interf->_poll, changed);
 
-  if (!_current_query_if) {
-    /* done with this series of queries, wait for next timer */
-    OONF_INFO(LOG_NL80211, "All queries done for all interfaces");
-    _current_query_in_progress = false;
+    OONF_INFO(LOG_NL80211, "All queries done for interface %s", interf->name);
+    interf->_query_in_progress = false;
     return;
   }
 
-  OONF_INFO(LOG_NL80211, "Sending query %u to interface %s", _current_query_number, _current_query_if->name);
-  _send_netlink_message(_current_query_if, _current_query_number);
+  if (!interf->if_listener.data->flags.up) {
+    /* interface went down, wait for next timer */
+    interf->_query_in_progress = false;
+    return;
+  }
+
+  OONF_INFO(LOG_NL80211, "Sending query %u to interface %s", interf->_query, interf->name);
+  _send_netlink_message(&interf->_nl_msg, interf, interf->_query);
 }
 
 /**
  * Parse an incoming netlink message from the kernel
+ * @param nl_msg netlink query this message is a response to
  * @param hdr pointer to netlink message
  */
 static void
-_cb_nl_response(struct os_system_netlink_message *nl_msg __attribute__((unused)), struct nlmsghdr *hdr) {
+_cb_nl_response(struct os_system_netlink_message *nl_msg, struct nlmsghdr *hdr) {
   struct genlmsghdr *gen_hdr;
+  struct nl80211_if *interf;
 
   gen_hdr = NLMSG_DATA(hdr);
   if (hdr->nlmsg_type == GENL_ID_CTRL && gen_hdr->cmd == CTRL_CMD_NEWFAMILY) {
@@ -686,33 +798,85 @@ _cb_nl_response(struct os_system_netlink_message *nl_msg __attribute__((unused))
     OONF_WARN(LOG_NL80211, "Unhandled netlink message type: %u", hdr->nlmsg_type);
     return;
   }
+  if (nl_msg == &_family_msg) {
+    return;
+  }
 
-  if (gen_hdr->cmd != _if_query_ops[_current_query_number].cmd) {
+  interf = container_of(nl_msg, struct nl80211_if, _nl_msg);
+  if (gen_hdr->cmd != _if_query_ops[interf->_query].cmd) {
     OONF_INFO(LOG_NL80211, "Received Nl80211 command %u for query %u (should be %u)", gen_hdr->cmd,
-      _current_query_number, _if_query_ops[_current_query_number].cmd);
+      interf->_query, _if_query_ops[interf->_query].cmd);
   }
-  else if (_if_query_ops[_current_query_number].process) {
-    OONF_DEBUG(LOG_NL80211, "Received Nl80211 command %u for query %u", gen_hdr->cmd, _current_query_number);
-    _current_query_if->l2net->if_type = OONF_LAYER2_TYPE_WIRELESS;
-    _if_query_ops[_current_query_number].process(_current_query_if, hdr);
+  else if (_if_query_ops[interf->_query].process) {
+    OONF_DEBUG(LOG_NL80211, "Received Nl80211 command %u for query %u", gen_hdr->cmd, interf->_query);
+    interf->l2net->if_type = OONF_LAYER2_TYPE_WIRELESS;
+    _if_query_ops[interf->_query].process(interf, hdr);
   }
 }
 
 /**
- * Callback triggered when a netlink message failes
- * @param seq sequence number
- * @param error error code
+ * Parse an incoming nl80211 multicast event from the kernel
+ * @param nl netlink handler
+ * @param hdr pointer to netlink message
  */
 static void
-_cb_nl_feedback(struct os_system_netlink_message *nlmsg __attribute__((unused))) {
+_cb_nl_multicast(struct os_system_netlink *nl __attribute__((unused)), struct nlmsghdr *hdr) {
+  struct nlattr *tb[NL80211_ATTR_MAX + 1];
+  struct genlmsghdr *gen_hdr;
+  struct nl80211_if *interf;
+
+  if (hdr->nlmsg_pid != 0) {
+    /* late response to an interrupted dump, not an event */
+    return;
+  }
+
+  gen_hdr = NLMSG_DATA(hdr);
+  if (gen_hdr->cmd != NL80211_CMD_NEW_STATION && gen_hdr->cmd != NL80211_CMD_DEL_STATION) {
+    /* not interested in this one */
+    return;
+  }
+
+  nla_parse(tb, NL80211_ATTR_MAX, genlmsg_attrdata(gen_hdr, 0), genlmsg_attrlen(gen_hdr, 0), NULL);
+  if (!tb[NL80211_ATTR_IFINDEX]) {
+    return;
+  }
+
+  interf = _nl80211_if_get_by_index(nla_get_u32(tb[NL80211_ATTR_IFINDEX]));
+  if (!interf || !interf->if_listener.data->flags.up) {
+    return;
+  }
+
+  OONF_DEBUG(LOG_NL80211, "Received Nl80211 event %u for interface %s", gen_hdr->cmd, interf->name);
+  if (gen_hdr->cmd == NL80211_CMD_NEW_STATION) {
+    interf->l2net->if_type = OONF_LAYER2_TYPE_WIRELESS;
+    nl80211_process_new_station_event(interf, hdr);
+  }
+  else {
+    nl80211_process_del_station_event(interf, hdr);
+  }
+}
+
+/**
+ * Callback triggered when a netlink message is done or failed
+ * @param nlmsg netlink message
+ */
+static void
+_cb_nl_feedback(struct os_system_netlink_message *nlmsg) {
+  struct nl80211_if *interf;
+
   OONF_INFO(LOG_NL80211, "seq %u: Result %d",
             nlmsg->message->nlmsg_seq, nlmsg->result);
-  if (_nl80211_id && _nl80211_multicast_group) {
-    if (_if_query_ops[_current_query_number].finalize) {
-      _if_query_ops[_current_query_number].finalize(_current_query_if);
-    }
-    _trigger_next_netlink_query();
+
+  if (nlmsg == &_family_msg) {
+    _finish_family_query();
+    return;
   }
+
+  interf = container_of(nlmsg, struct nl80211_if, _nl_msg);
+  if (_if_query_ops[interf->_query].finalize) {
+    _if_query_ops[interf->_query].finalize(interf);
+  }
+  _trigger_next_if_query(interf);
 }
 
 /**
@@ -729,8 +893,6 @@ _cb_config_changed(void) {
     return;
   }
 
-  /* set transmission timer */
-  oonf_timer_set_ext(&_transmission_timer, 1, _config.interval);
 
   /* mark old interfaces for removal */
   array = cfg_db_get_schema_entry_value(_nl80211_section.pre, &_nl80211_entries[IDX_INTERFACES]);
@@ -766,4 +928,9 @@ _cb_config_changed(void) {
       }
     }
   }
+
+  /* update query schedule of all interfaces */
+  avl_for_each_element(&_nl80211_if_tree, interf, _node) {
+    oonf_layer2_poll_set_bounds(&interf->_poll, _config.interval, _config.max_interval);
+  }
 }
@@ -102,6 +102,8 @@ static enum oonf_telnet_result _cb_handle_log(struct oonf_telnet_data *data);
 static enum oonf_telnet_result _cb_handle_config(struct oonf_telnet_data *data);
 static enum oonf_telnet_result _update_logfilter(
   struct oonf_telnet_data *data, uint8_t *mask, const char *current, bool value);
+static enum oonf_telnet_result _print_logsites(struct oonf_telnet_data *data, const char *filter);
+static enum oonf_telnet_result _update_logsites(struct oonf_telnet_data *data, const char *param);
 
 static enum oonf_telnet_result _start_logging(struct oonf_telnet_data *data, struct _remotecontrol_session *rc_session);
 static void _stop_logging(struct oonf_telnet_data *data);
@@ -157,7 +159,10 @@ static struct oonf_telnet_command _telnet_cmds[] = {
     "\"log\":      continuous output of logging to this console\n"
     "\"log show\": show configured logging option for debuginfo output\n"
     "\"log add <severity> <source1> <source2> ...\": Add one or more sources of a defined severity for logging\n"
-    "\"log remove <severity> <source1> <source2> ...\": Remove one or more sources of a defined severity for logging\n",
+    "\"log remove <severity> <source1> <source2> ...\": Remove one or more sources of a defined severity for logging\n"
+    "\"log sites [<file>]\": show all logging call sites (of a file)\n"
+    "\"log site <on|off|default> <file>[:<line>]\": switch logging call sites of a file/line on, off or back\n"
+    "                                             to the logging configuration\n",
     .acl = &_remotecontrol_config.acl),
   TELNET_CMD("config", _cb_handle_config,
     "\"config commit\":                                   Commit changed configuration\n"
@@ -285,6 +290,103 @@ _update_logfilter(struct oonf_telnet_data *data, uint8_t *mask, const char *para
   return TELNET_RESULT_ACTIVE;
 }
 
+/**
+ * Print the logging call sites of all binaries
+ * @param data pointer to telnet data
+ * @param filter substring of filenames to print, NULL for all call sites
+ * @return telnet result constant
+ */
+static enum oonf_telnet_result
+_print_logsites(struct oonf_telnet_data *data, const char *filter) {
+  static const char *STATE_NAMES[] = {
+    [OONF_LOG_CALLSITE_DEFAULT] = "default",
+    [OONF_LOG_CALLSITE_ON] = "on",
+    [OONF_LOG_CALLSITE_OFF] = "off",
+  };
+  struct oonf_log_callsite_section *section;
+  struct oonf_log_callsite *site;
+  const char *ptr;
+  size_t len;
+
+  OONF_FOR_ALL_LOGCALLSITES(section, site) {
+    if (filter && *filter && strstr(site->file, filter) == NULL) {
+      continue;
+    }
+    abuf_appendf(data->out, "%s:%d %s %s \"", site->file, site->line, LOG_SEVERITY_NAMES[site->severity],
+      STATE_NAMES[site->state]);
+
+    /* keep one call site per line */
+    for (ptr = site->format; *ptr; ptr += len) {
+      len = strcspn(ptr, "\n");
+      abuf_memcpy(data->out, ptr, len);
+      if (ptr[len] == '\n') {
+        abuf_puts(data->out, "\\n");
+        len++;
+      }
+    }
+    abuf_puts(data->out, "\"\n");
+  }
+  return TELNET_RESULT_ACTIVE;
+}
+
+/**
+ * Change the state of logging call sites
+ * @param data pointer to telnet data
+ * @param param parameters of log site command
+ * @return telnet result constant
+ */
+static enum oonf_telnet_result
+_update_logsites(struct oonf_telnet_data *data, const char *param) {
+  struct oonf_log_callsite_section *section;
+  struct oonf_log_callsite *site;
+  enum oonf_log_callsite_state state;
+  char file[256];
+  const char *next;
+  char *ptr;
+  int line, count;
+
+  if ((next = str_hasnextword(param, "on")) != NULL) {
+    state = OONF_LOG_CALLSITE_ON;
+  }
+  else if ((next = str_hasnextword(param, "off")) != NULL) {
+    state = OONF_LOG_CALLSITE_OFF;
+  }
+  else if ((next = str_hasnextword(param, "default")) != NULL) {
+    state = OONF_LOG_CALLSITE_DEFAULT;
+  }
+  else {
+    abuf_appendf(data->out, "Error, unknown call site state: %s\n", param);
+    return TELNET_RESULT_ACTIVE;
+  }
+
+  if (next == NULL || *next == 0) {
+    abuf_puts(data->out, "Error, missing file of call site\n");
+    return TELNET_RESULT_ACTIVE;
+  }
+
+  strscpy(file, next, sizeof(file));
+  line = 0;
+  if ((ptr = strrchr(file, ':')) != NULL) {
+    *ptr++ = 0;
+    line = atoi(ptr);
+  }
+
+  count = 0;
+  OONF_FOR_ALL_LOGCALLSITES(section, site) {
+    /* assertions cannot be switched off */
+    if (site->severity == LOG_SEVERITY_ASSERT || strstr(site->file, file) == NULL) {
+      continue;
+    }
+    if (line == 0 || site->line == line) {
+      site->state = state;
+      count++;
+    }
+  }
+
+  abuf_appendf(data->out, "%d call sites changed\n", count);
+  return TELNET_RESULT_ACTIVE;
+}
+
 /**
  * Log handler for telnet output
  * @param h logging handler
@@ -390,6 +492,12 @@ _cb_handle_log(struct oonf_telnet_data *data) {
   if ((next = str_hasnextword(data->parameter, "add")) != NULL) {
     return _update_logfilter(data, rc_session->mask, next, true);
   }
+  if ((next = str_hasnextword(data->parameter, "sites")) != NULL || strcasecmp(data->parameter, "sites") == 0) {
+    return _print_logsites(data, next);
+  }
+  if ((next = str_hasnextword(data->parameter, "site")) != NULL) {
+    return _update_logsites(data, next);
+  }
   if ((next = str_hasnextword(data->parameter, "remove")) != NULL) {
     return _update_logfilter(data, rc_session->mask, next, false);
   }
@@ -134,6 +134,28 @@ json_print(struct json_session *session, const char *key, bool string, const cha
   _json_printvalue(session->out, value, string);
 }
 
+/**
+ * Appends a pre-generated JSON fragment to the JSON session. The fragment
+ * must contain one or more complete, comma separated JSON elements
+ * (generated by a separate session), the necessary delimiter in front of
+ * it is added by this function.
+ * @param session JSON session
+ * @param fragment pointer to JSON fragment
+ * @param length length of fragment in bytes
+ */
+void
+json_print_raw(struct json_session *session, const void *fragment, size_t length) {
+  if (length == 0) {
+    return;
+  }
+  if (!session->empty) {
+    abuf_puts(session->out, ",");
+  }
+  session->empty = false;
+
+  abuf_memcpy(session->out, fragment, length);
+}
+
 /**
  * Ends a JSON object, should be paired with corresponding _start_object
  * call.
@@ -0,0 +1,259 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/libcommon/netaddr_hash.h>
+
+/*! number of slots allocated for the first node */
+#define NETADDR_HASH_MIN_SIZE 8
+
+/*! odd multiplier (golden ratio) to mix key data into hash value */
+#define NETADDR_HASH_MULTIPLIER 0x9e3779b97f4a7c15ull
+
+static uint32_t _hash_key(const void *scope, const struct netaddr *key, uint32_t key_count);
+static bool _is_match(
+  const struct netaddr_hash *hash, const struct netaddr_hash_node *node, uint32_t h, const void *scope,
+  const struct netaddr *key);
+static void _insert_slot(struct netaddr_hash *hash, struct netaddr_hash_node *node);
+static int _resize(struct netaddr_hash *hash, uint32_t size);
+
+/**
+ * Initialize a new netaddr hash table
+ * @param hash pointer to hash table
+ * @param key_count number of consecutive netaddr objects that form a key
+ */
+void
+netaddr_hash_init(struct netaddr_hash *hash, uint32_t key_count) {
+  memset(hash, 0, sizeof(*hash));
+  hash->key_count = key_count;
+}
+
+/**
+ * Release the memory of a netaddr hash table. The nodes
+ * inside the table are not touched.
+ * @param hash pointer to hash table
+ */
+void
+netaddr_hash_cleanup(struct netaddr_hash *hash) {
+  free(hash->_slots);
+  hash->_slots = NULL;
+  hash->_size = 0;
+  hash->count = 0;
+}
+
+/**
+ * Add a node to a netaddr hash table. The scope and key of
+ * the node must be initialized before.
+ * @param hash pointer to hash table
+ * @param node pointer to node
+ * @return -1 if an out of memory error happened, 0 otherwise
+ */
+int
+netaddr_hash_add(struct netaddr_hash *hash, struct netaddr_hash_node *node) {
+  /* keep the load factor below 50% to keep the probe sequences short */
+  if ((hash->count + 1) * 2 > hash->_size) {
+    if (_resize(hash, hash->_size ? hash->_size * 2 : NETADDR_HASH_MIN_SIZE)) {
+      return -1;
+    }
+  }
+
+  node->_hash = _hash_key(node->scope, node->key, hash->key_count);
+  _insert_slot(hash, node);
+  hash->count++;
+  return 0;
+}
+
+/**
+ * Remove a node from a netaddr hash table
+ * @param hash pointer to hash table
+ * @param node pointer to node
+ */
+void
+netaddr_hash_remove(struct netaddr_hash *hash, struct netaddr_hash_node *node) {
+  uint32_t mask, i, j, home;
+
+  if (hash->count == 0) {
+    return;
+  }
+
+  mask = hash->_size - 1;
+  for (i = node->_hash & mask; hash->_slots[i] != node; i = (i + 1) & mask) {
+    if (hash->_slots[i] == NULL) {
+      /* node is not part of the hash table */
+      return;
+    }
+  }
+
+  /* close the gap by moving back nodes that would not be found anymore */
+  for (j = (i + 1) & mask; hash->_slots[j] != NULL; j = (j + 1) & mask) {
+    home = hash->_slots[j]->_hash & mask;
+
+    /* node at j can be moved if its home slot is not between the gap and j */
+    if (i <= j ? (home <= i || home > j) : (home <= i && home > j)) {
+      hash->_slots[i] = hash->_slots[j];
+      i = j;
+    }
+  }
+
+  hash->_slots[i] = NULL;
+  hash->count--;
+}
+
+/**
+ * Find a node in a netaddr hash table
+ * @param hash pointer to hash table
+ * @param scope object the key is unique for, NULL for global keys
+ * @param key pointer to key
+ * @return pointer to hash table node, NULL if no node was found
+ */
+struct netaddr_hash_node *
+netaddr_hash_find(const struct netaddr_hash *hash, const void *scope, const struct netaddr *key) {
+  uint32_t h, mask, i;
+
+  if (hash->count == 0) {
+    return NULL;
+  }
+
+  h = _hash_key(scope, key, hash->key_count);
+  mask = hash->_size - 1;
+
+  for (i = h & mask; hash->_slots[i] != NULL; i = (i + 1) & mask) {
+    if (_is_match(hash, hash->_slots[i], h, scope, key)) {
+      return hash->_slots[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Calculate the hash value of a scope and key
+ * @param scope object the key is unique for
+ * @param key pointer to key
+ * @param key_count number of netaddr objects in key
+ * @return hash value
+ */
+static uint32_t
+_hash_key(const void *scope, const struct netaddr *key, uint32_t key_count) {
+  uint64_t h, part[2];
+  uint32_t i;
+
+  h = (uintptr_t)scope * NETADDR_HASH_MULTIPLIER;
+  for (i = 0; i < key_count; i++) {
+    memcpy(part, key[i]._addr, sizeof(part));
+
+    h = (h ^ part[0]) * NETADDR_HASH_MULTIPLIER;
+    h = (h ^ part[1]) * NETADDR_HASH_MULTIPLIER;
+    h = (h ^ (((uint32_t)key[i]._type << 8) | key[i]._prefix_len)) * NETADDR_HASH_MULTIPLIER;
+  }
+
+  /* final avalanche, so the lower bits used as slot index depend on all input bits */
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  return (uint32_t)h;
+}
+
+/**
+ * @param hash pointer to hash table
+ * @param node pointer to hash table node
+ * @param h hash value of scope and key
+ * @param scope object the key is unique for
+ * @param key pointer to key
+ * @return true if node has the scope and key, false otherwise
+ */
+static bool
+_is_match(const struct netaddr_hash *hash, const struct netaddr_hash_node *node, uint32_t h, const void *scope,
+  const struct netaddr *key) {
+  return node->_hash == h && node->scope == scope && memcmp(node->key, key, sizeof(*key) * hash->key_count) == 0;
+}
+
+/**
+ * Put a node into the first free slot of its probe sequence
+ * @param hash pointer to hash table
+ * @param node pointer to node with initialized hash value
+ */
+static void
+_insert_slot(struct netaddr_hash *hash, struct netaddr_hash_node *node) {
+  uint32_t mask, i;
+
+  mask = hash->_size - 1;
+  for (i = node->_hash & mask; hash->_slots[i] != NULL; i = (i + 1) & mask)
+    ;
+  hash->_slots[i] = node;
+}
+
+/**
+ * Change the number of slots of a hash table
+ * @param hash pointer to hash table
+ * @param size new number of slots, must be a power of two
+ * @return -1 if an out of memory error happened, 0 otherwise
+ */
+static int
+_resize(struct netaddr_hash *hash, uint32_t size) {
+  struct netaddr_hash_node **old_slots;
+  uint32_t old_size, i;
+
+  old_slots = hash->_slots;
+  old_size = hash->_size;
+
+  hash->_slots = calloc(size, sizeof(*hash->_slots));
+  if (hash->_slots == NULL) {
+    hash->_slots = old_slots;
+    return -1;
+  }
+  hash->_size = size;
+
+  for (i = 0; i < old_size; i++) {
+    if (old_slots[i]) {
+      _insert_slot(hash, old_slots[i]);
+    }
+  }
+  free(old_slots);
+  return 0;
+}
@@ -460,6 +460,60 @@ cfg_db_remove_element(
   return -1;
 }
 
+/**
+ * Compare the entries of two named sections
+ * @param named1 first named section, might be NULL
+ * @param named2 second named section, might be NULL
+ * @return true if both named sections contain the same entries
+ *   with the same values, false otherwise
+ */
+bool
+cfg_db_is_namedsection_equal(const struct cfg_named_section *named1, const struct cfg_named_section *named2) {
+  struct cfg_entry *entry1, *entry2;
+
+  if (named1 == NULL || named2 == NULL) {
+    return named1 == named2;
+  }
+  if (named1->entries.count != named2->entries.count) {
+    return false;
+  }
+
+  avl_for_each_element(&named1->entries, entry1, node) {
+    entry2 = cfg_db_get_entry(named2, entry1->name);
+    if (entry2 == NULL || strarray_cmp(&entry1->val, &entry2->val) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Compare the named sections of two section types
+ * @param type1 first section type, might be NULL
+ * @param type2 second section type, might be NULL
+ * @return true if both section types contain the same named sections
+ *   with the same entries and values, false otherwise
+ */
+bool
+cfg_db_is_sectiontype_equal(const struct cfg_section_type *type1, const struct cfg_section_type *type2) {
+  struct cfg_named_section *named1, *named2;
+
+  if (type1 == NULL || type2 == NULL) {
+    return type1 == type2;
+  }
+  if (type1->names.count != type2->names.count) {
+    return false;
+  }
+
+  avl_for_each_element(&type1->names, named1, node) {
+    named2 = cfg_db_get_named_section(type2, named1->name);
+    if (named2 == NULL || !cfg_db_is_namedsection_equal(named1, named2)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /**
  * Creates a section type in a configuration database
  * @param db pointer to configuration database
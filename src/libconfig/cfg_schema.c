@@ -878,6 +878,7 @@ _handle_db_changes(struct cfg_db *pre_change, struct cfg_db *post_change, bool s
   struct cfg_section_type *pre_type, *post_type;
   struct cfg_named_section *pre_named, *post_named, *named_it;
   struct cfg_named_section *pre_defnamed, *post_defnamed;
+  bool unnamed_equal;
 
   if (pre_change->schema == NULL || pre_change->schema != post_change->schema) {
     /* no valid schema found */
@@ -901,6 +902,16 @@ _handle_db_changes(struct cfg_db *pre_change, struct cfg_db *post_change, bool s
     pre_type = cfg_db_find_sectiontype(pre_change, s_section->type);
     post_type = cfg_db_find_sectiontype(post_change, s_section->type);
 
+    if (!startup && cfg_db_is_sectiontype_equal(pre_type, post_type)) {
+      /* nothing changed for this section type */
+      continue;
+    }
+
+    /* the unnamed section provides the defaults for all named ones */
+    unnamed_equal = pre_type != NULL && post_type != NULL &&
+                    cfg_db_is_namedsection_equal(
+                      cfg_db_get_unnamed_section(pre_type), cfg_db_get_unnamed_section(post_type));
+
     /* prepare for default named section */
     pre_defnamed = NULL;
     post_defnamed = NULL;
@@ -935,6 +946,11 @@ _handle_db_changes(struct cfg_db *pre_change, struct cfg_db *post_change, bool s
       /* handle new named sections and changes */
       pre_named = NULL;
       CFG_FOR_ALL_SECTION_NAMES(post_type, post_named, named_it) {
+        if (!startup && unnamed_equal &&
+            cfg_db_is_namedsection_equal(cfg_db_get_named_section(pre_type, post_named->name), post_named)) {
+          /* named section did not change */
+          continue;
+        }
         _handle_named_section_change(
           s_section, pre_change, post_change, post_named->name, startup, pre_defnamed, post_defnamed);
       }
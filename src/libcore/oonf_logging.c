@@ -44,6 +44,9 @@
  */
 
 #include <assert.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -57,6 +60,63 @@
 #include <oonf/libcore/oonf_logging.h>
 #include <oonf/libcore/os_core.h>
 
+/**
+ * Header of a logging event in the asynchronous ring buffer,
+ * followed by the zero terminated logging output
+ */
+struct _async_record {
+  /*! total length of record including header, 0 marks a jump back to the start of the ring */
+  uint32_t length;
+
+  /*! severity of logging event */
+  uint8_t severity;
+
+  /*! source of logging event */
+  uint8_t source;
+
+  /*! number of bytes used for the timestamp in the output */
+  uint16_t time_length;
+
+  /*! number of bytes used for the logging prefix in the output */
+  uint16_t prefix_length;
+
+  /*! true if logging masks of the handlers should be ignored */
+  bool forced;
+
+  /*! line number where the logging event happened */
+  int line;
+
+  /*! file where the logging event happened */
+  const char *file;
+
+  /*! logging output */
+  char text[];
+};
+
+/**
+ * Subset of logging handlers called for a logging event
+ */
+enum _log_handler_selection
+{
+  /*! all logging handlers */
+  _LOG_ALL_HANDLERS,
+
+  /*! handlers that must be called by the scheduler thread */
+  _LOG_SYNC_HANDLERS,
+
+  /*! handlers that can be called by the asynchronous logging thread */
+  _LOG_THREAD_SAFE_HANDLERS,
+};
+
+static void _log_event(enum oonf_log_severity severity, enum oonf_log_source source, const char *file, int line,
+  bool forced, const void *hexptr, size_t hexlen, const char *format, va_list ap) __attribute__((format(printf, 8, 0)));
+static void _log_to_handlers(struct oonf_log_parameters *param, bool forced, enum _log_handler_selection selection);
+static bool _async_enqueue(struct oonf_log_parameters *param, size_t length, bool forced);
+static void _async_drain(void);
+static void *_async_writer(void *ptr);
+static int _async_create_writer(void);
+static void _async_join_writer(void);
+
 static struct list_entity _handler_list;
 static struct autobuf _logbuffer;
 static const struct oonf_appdata *_appdata;
@@ -92,6 +152,38 @@ const char *LOG_SEVERITY_NAMES[LOG_SEVERITY_MAX + 1] = {
 
 static uint32_t _log_warnings[LOG_MAXIMUM_SOURCES];
 
+/* list of registered call site sections, filled by constructors before main() */
+static struct list_entity _callsite_sections = { &_callsite_sections, &_callsite_sections };
+
+/* call sites of this binary */
+static struct oonf_log_callsite_section _core_callsites = OONF_LOG_CALLSITE_SECTION;
+
+/* single producer/single consumer ring buffer for asynchronous logging */
+static char *_async_ring;
+static size_t _async_ring_size;
+
+/* next write position, only modified by the logging (scheduler) thread */
+static size_t _async_head;
+
+/* next read position, only modified by the writer thread */
+static size_t _async_tail;
+
+/* number of logging events that did not fit into the ring or were generated by the writer thread */
+static uint64_t _async_dropped;
+
+/* number of dropped logging events already reported by the writer thread */
+static uint64_t _async_reported;
+
+/* writer thread state */
+static pthread_t _async_thread;
+static sem_t _async_signal;
+static bool _async_running;
+static bool _async_stop;
+static int _async_suspended;
+
+/* true for the writer thread, which must not add events to the ring */
+static __thread bool _async_is_writer;
+
 /**
  * Initialize logging system
  * @param data builddata defined by application
@@ -109,6 +201,7 @@ oonf_log_init(const struct oonf_appdata *data, enum oonf_log_severity def_severi
   _source_count = LOG_CORESOURCE_COUNT;
 
   list_init_head(&_handler_list);
+  oonf_log_register_callsites(&_core_callsites);
 
   if (abuf_init(&_logbuffer)) {
     fputs("Not enough memory for logging buffer\n", stderr);
@@ -157,6 +250,9 @@ oonf_log_cleanup(void) {
   struct oonf_log_handler_entry *h, *iterator;
   enum oonf_log_source src;
 
+  /* write all pending logging events */
+  oonf_log_async_stop();
+
   /* remove all handlers */
   list_for_each_element_safe(&_handler_list, h, _node, iterator) {
     oonf_log_removehandler(h);
@@ -166,6 +262,7 @@ oonf_log_cleanup(void) {
     free((void *)LOG_SOURCE_NAMES[src]);
     LOG_SOURCE_NAMES[src] = NULL;
   }
+  oonf_log_unregister_callsites(&_core_callsites);
   abuf_free(&_logbuffer);
 }
 
@@ -176,8 +273,10 @@ oonf_log_cleanup(void) {
  */
 void
 oonf_log_addhandler(struct oonf_log_handler_entry *h) {
+  oonf_log_async_suspend();
   list_add_tail(&_handler_list, &h->_node);
   oonf_log_updatemask();
+  oonf_log_async_resume();
 }
 
 /**
@@ -186,8 +285,10 @@ oonf_log_addhandler(struct oonf_log_handler_entry *h) {
  */
 void
 oonf_log_removehandler(struct oonf_log_handler_entry *h) {
+  oonf_log_async_suspend();
   list_remove(&h->_node);
   oonf_log_updatemask();
+  oonf_log_async_resume();
 }
 
 /**
@@ -298,6 +399,9 @@ oonf_log_updatemask(void) {
   struct oonf_log_handler_entry *h, *iterator;
   uint8_t mask;
 
+  /* the writer thread reads the handler masks */
+  oonf_log_async_suspend();
+
   /* first reset global mask */
   oonf_log_mask_clear(log_global_mask);
 
@@ -328,6 +432,8 @@ oonf_log_updatemask(void) {
       log_global_mask[src] |= mask;
     }
   }
+
+  oonf_log_async_resume();
 }
 
 /**
@@ -368,64 +474,190 @@ oonf_log_get_walltime(struct oonf_walltime_str *buf) {
 void
 oonf_log(enum oonf_log_severity severity, enum oonf_log_source source, const char *file, int line,
   const void *hexptr, size_t hexlen, const char *format, ...) {
-  struct oonf_log_handler_entry *h, *iterator;
-  struct oonf_log_parameters param;
-  struct oonf_walltime_str tbuf;
-  char *last;
   va_list ap;
-  int p1 = 0, p2 = 0;
 
-  if (severity == LOG_SEVERITY_WARN) {
-    /* count warnings */
-    _log_warnings[source]++;
-    _log_warnings[LOG_ALL]++;
-  }
+  va_start(ap, format);
+  _log_event(severity, source, file, line, false, hexptr, hexlen, format, ap);
+  va_end(ap);
+}
+
+/**
+ * This function should not be called directly, use the macros OONF_{DEBUG,INFO,WARN} !
+ *
+ * Generates a logfile entry for a logging call site and calls all log handler
+ * to store/output it. Call sites that have been switched on explicitly
+ * are reported to all handlers, independent of their logging mask.
+ *
+ * @param site logging call site
+ * @param source source of the log event (LOG_LOGGING, ... )
+ * @param hexptr pointer to binary buffer that should be appended as a hexdump
+ * @param hexlen length of binary buffer to hexdump
+ * @param format printf format string for log output plus a variable number of arguments
+ */
+void
+oonf_log_callsite(const struct oonf_log_callsite *site, enum oonf_log_source source, const void *hexptr,
+  size_t hexlen, const char *format, ...) {
+  va_list ap;
 
   va_start(ap, format);
+  _log_event(site->severity, source, site->file, site->line, site->state == OONF_LOG_CALLSITE_ON, hexptr, hexlen,
+    format, ap);
+  va_end(ap);
+}
 
-  /* generate log string */
-  abuf_clear(&_logbuffer);
-  p1 = abuf_puts(&_logbuffer, oonf_log_get_walltime(&tbuf));
-  p2 = abuf_appendf(&_logbuffer, " %s(%s) %s %d: ", LOG_SEVERITY_NAMES[severity], LOG_SOURCE_NAMES[source], file, line);
-  abuf_vappendf(&_logbuffer, format, ap);
+/**
+ * Register the logging call sites of a binary. Sections of binaries
+ * that have already been registered are ignored.
+ * @param section call site section
+ */
+void
+oonf_log_register_callsites(struct oonf_log_callsite_section *section) {
+  struct oonf_log_callsite_section *s;
 
-  last = &abuf_getptr(&_logbuffer)[abuf_getlen(&_logbuffer) - 1];
-  if (hexptr) {
-    /* append \n at the end of the line if necessary */
-    if (*last != '\n') {
-      abuf_puts(&_logbuffer, "\n");
+  if (section->start == NULL || section->start == section->stop || list_is_node_added(&section->_node)) {
+    return;
+  }
+
+  list_for_each_element(&_callsite_sections, s, _node) {
+    if (s->start == section->start) {
+      return;
     }
+  }
+  list_add_tail(&_callsite_sections, &section->_node);
+}
 
-    abuf_hexdump(&_logbuffer, "", hexptr, hexlen);
+/**
+ * Unregister the logging call sites of a binary
+ * @param section call site section
+ */
+void
+oonf_log_unregister_callsites(struct oonf_log_callsite_section *section) {
+  if (list_is_node_added(&section->_node)) {
+    list_remove(&section->_node);
   }
-  else {
-    /* remove \n at the end of the line if necessary */
-    if (*last == '\n') {
-      *last = 0;
-    }
+}
+
+/**
+ * @return list of all registered call site sections
+ */
+struct list_entity *
+oonf_log_get_callsite_sections(void) {
+  return &_callsite_sections;
+}
+
+/**
+ * Start the asynchronous logging mode. Logging events will be stored
+ * in a ring buffer and a dedicated writer thread calls the thread safe
+ * logging handlers, so slow handlers (files, syslog) do not delay the
+ * scheduler. All other handlers are still called by the scheduler thread.
+ * Events that do not fit into the ring buffer are dropped and counted,
+ * as well as events generated by handlers on the writer thread.
+ * @param buffer_size size of ring buffer in bytes
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+oonf_log_async_start(size_t buffer_size) {
+  char *ring;
+
+  if (buffer_size < OONF_LOG_ASYNC_MIN_SIZE) {
+    buffer_size = OONF_LOG_ASYNC_MIN_SIZE;
   }
 
-  param.severity = severity;
-  param.source = source;
-  param.file = file;
-  param.line = line;
-  param.buffer = abuf_getptr(&_logbuffer);
-  param.timeLength = p1;
-  param.prefixLength = p2;
+  /* keep all records aligned to their header */
+  buffer_size &= ~(sizeof(uint64_t) - 1);
 
-  /* use stderr logger if nothing has been configured */
-  if (list_is_empty(&_handler_list)) {
-    oonf_log_stderr(NULL, &param);
+  if (_async_ring != NULL && _async_ring_size == buffer_size) {
+    return 0;
   }
-  else {
-    /* call all log handlers */
-    list_for_each_element_safe(&_handler_list, h, _node, iterator) {
-      if (oonf_log_mask_test(h->_processed_bitmask, source, severity)) {
-        h->handler(h, &param);
-      }
-    }
+
+  oonf_log_async_stop();
+
+  ring = calloc(1, buffer_size);
+  if (ring == NULL) {
+    OONF_WARN(LOG_LOGGING, "Not enough memory for asynchronous logging buffer");
+    return -1;
   }
-  va_end(ap);
+  if (sem_init(&_async_signal, 0, 0)) {
+    free(ring);
+    return -1;
+  }
+
+  _async_ring = ring;
+  _async_ring_size = buffer_size;
+  _async_head = 0;
+  _async_tail = 0;
+  _async_dropped = 0;
+  _async_reported = 0;
+
+  if (_async_suspended == 0 && _async_create_writer()) {
+    oonf_log_async_stop();
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * Write all pending logging events and stop the asynchronous logging mode
+ */
+void
+oonf_log_async_stop(void) {
+  if (_async_ring == NULL) {
+    return;
+  }
+
+  _async_join_writer();
+  _async_drain();
+
+  sem_destroy(&_async_signal);
+  free(_async_ring);
+  _async_ring = NULL;
+  _async_ring_size = 0;
+}
+
+/**
+ * Write all pending logging events and stop the writer thread until
+ * oonf_log_async_resume() is called. Logging events are handled
+ * synchronously in the meantime. Must be called before modifying
+ * logging handlers or forking the process. Calls can be nested.
+ */
+void
+oonf_log_async_suspend(void) {
+  if (_async_suspended++ == 0 && _async_ring != NULL) {
+    _async_join_writer();
+    _async_drain();
+  }
+}
+
+/**
+ * Restart the writer thread after oonf_log_async_suspend()
+ */
+void
+oonf_log_async_resume(void) {
+  if (_async_suspended == 0) {
+    return;
+  }
+  if (--_async_suspended == 0 && _async_ring != NULL && _async_create_writer()) {
+    OONF_WARN(LOG_LOGGING, "Could not restart logging thread, switch to synchronous logging");
+    oonf_log_async_stop();
+  }
+}
+
+/**
+ * @return true if asynchronous logging is active
+ */
+bool
+oonf_log_is_async(void) {
+  return _async_ring != NULL;
+}
+
+/**
+ * @return number of logging events dropped because the asynchronous
+ *   ring buffer was full or because they were generated on the
+ *   writer thread
+ */
+uint64_t
+oonf_log_get_async_dropped(void) {
+  return __atomic_load_n(&_async_dropped, __ATOMIC_RELAXED);
 }
 
 /**
@@ -481,3 +713,291 @@ void
 oonf_log_syslog(struct oonf_log_handler_entry *entry __attribute__((unused)), struct oonf_log_parameters *param) {
   os_core_syslog(param->severity, param->buffer + param->timeLength);
 }
+
+/**
+ * Call logging handlers for a logging event
+ * @param param logging parameter set
+ * @param forced true to ignore the logging masks of the handlers
+ * @param selection subset of logging handlers to call
+ */
+static void
+_log_to_handlers(struct oonf_log_parameters *param, bool forced, enum _log_handler_selection selection) {
+  struct oonf_log_handler_entry *h, *iterator;
+
+  /* use stderr logger if nothing has been configured */
+  if (list_is_empty(&_handler_list)) {
+    if (selection != _LOG_SYNC_HANDLERS) {
+      oonf_log_stderr(NULL, param);
+    }
+    return;
+  }
+
+  /* call all log handlers */
+  list_for_each_element_safe(&_handler_list, h, _node, iterator) {
+    if (selection == _LOG_SYNC_HANDLERS && h->thread_safe) {
+      continue;
+    }
+    if (selection == _LOG_THREAD_SAFE_HANDLERS && !h->thread_safe) {
+      continue;
+    }
+    if (forced || oonf_log_mask_test(h->_processed_bitmask, param->source, param->severity)) {
+      h->handler(h, param);
+    }
+  }
+}
+
+/**
+ * Copy a logging event into the asynchronous ring buffer.
+ * Only called by the logging (scheduler) thread.
+ * @param param logging parameter set
+ * @param length length of logging output without zero termination
+ * @param forced true to ignore the logging masks of the handlers
+ * @return true if the event was stored, false if it was dropped
+ */
+static bool
+_async_enqueue(struct oonf_log_parameters *param, size_t length, bool forced) {
+  struct _async_record *record;
+  size_t head, tail, max_length, record_length;
+
+  /* truncate huge hexdumps instead of blocking the whole ring */
+  max_length = _async_ring_size / 4 - sizeof(*record) - 1;
+  if (length > max_length) {
+    length = max_length;
+  }
+
+  record_length = (sizeof(*record) + length + 1 + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+
+  head = _async_head;
+  tail = __atomic_load_n(&_async_tail, __ATOMIC_ACQUIRE);
+
+  /* head must never catch up with tail, otherwise the ring would look empty */
+  if (head >= tail) {
+    if (head + record_length >= _async_ring_size) {
+      if (record_length >= tail) {
+        __atomic_add_fetch(&_async_dropped, 1, __ATOMIC_RELAXED);
+        return false;
+      }
+
+      /* mark the rest of the ring as unused and wrap around */
+      record = (struct _async_record *)(_async_ring + head);
+      record->length = 0;
+      head = 0;
+    }
+  }
+  else if (head + record_length >= tail) {
+    __atomic_add_fetch(&_async_dropped, 1, __ATOMIC_RELAXED);
+    return false;
+  }
+
+  record = (struct _async_record *)(_async_ring + head);
+  record->length = record_length;
+  record->severity = param->severity;
+  record->source = param->source;
+  record->time_length = param->timeLength;
+  record->prefix_length = param->prefixLength;
+  record->forced = forced;
+  record->line = param->line;
+  record->file = param->file;
+  memcpy(record->text, param->buffer, length);
+  record->text[length] = 0;
+
+  /* publish record to writer thread */
+  __atomic_store_n(&_async_head, head + record_length, __ATOMIC_RELEASE);
+  return true;
+}
+
+/**
+ * Call the logging handlers for all events in the asynchronous ring buffer.
+ * Only called by the writer thread or while the writer thread is stopped.
+ */
+static void
+_async_drain(void) {
+  struct oonf_log_parameters param;
+  struct _async_record *record;
+  uint64_t dropped;
+  size_t head, tail;
+  char buffer[128];
+
+  tail = _async_tail;
+  while ((head = __atomic_load_n(&_async_head, __ATOMIC_ACQUIRE)) != tail) {
+    while (tail != head) {
+      record = (struct _async_record *)(_async_ring + tail);
+      if (record->length == 0) {
+        tail = 0;
+        continue;
+      }
+
+      param.severity = record->severity;
+      param.source = record->source;
+      param.file = record->file;
+      param.line = record->line;
+      param.buffer = record->text;
+      param.timeLength = record->time_length;
+      param.prefixLength = record->prefix_length;
+      _log_to_handlers(&param, record->forced, _LOG_THREAD_SAFE_HANDLERS);
+
+      tail += record->length;
+    }
+
+    /* free space for the logging thread */
+    __atomic_store_n(&_async_tail, tail, __ATOMIC_RELEASE);
+  }
+
+  dropped = oonf_log_get_async_dropped();
+  if (dropped != _async_reported) {
+    param.severity = LOG_SEVERITY_WARN;
+    param.source = LOG_LOGGING;
+    param.file = __FILE__;
+    param.line = __LINE__;
+    param.timeLength = 0;
+    param.prefixLength = 0;
+    param.buffer = buffer;
+    snprintf(buffer, sizeof(buffer), "Asynchronous logging dropped %" PRIu64 " events",
+      dropped - _async_reported);
+    _log_to_handlers(&param, false, _LOG_THREAD_SAFE_HANDLERS);
+
+    _async_reported = dropped;
+  }
+}
+
+/**
+ * Main loop of the asynchronous logging thread
+ * @param ptr unused
+ * @return always NULL
+ */
+static void *
+_async_writer(void *ptr __attribute__((unused))) {
+  _async_is_writer = true;
+
+  while (!__atomic_load_n(&_async_stop, __ATOMIC_ACQUIRE)) {
+    if (sem_wait(&_async_signal) == 0) {
+      _async_drain();
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Start the asynchronous logging thread
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_async_create_writer(void) {
+  sigset_t blocked, old;
+  int result;
+
+  if (_async_running) {
+    return 0;
+  }
+
+  __atomic_store_n(&_async_stop, false, __ATOMIC_RELEASE);
+
+  /* signals must be handled by the scheduler thread */
+  sigfillset(&blocked);
+  pthread_sigmask(SIG_SETMASK, &blocked, &old);
+  result = pthread_create(&_async_thread, NULL, _async_writer, NULL);
+  pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+  if (result) {
+    return -1;
+  }
+  _async_running = true;
+  return 0;
+}
+
+/**
+ * Stop the asynchronous logging thread and wait until it is finished
+ */
+static void
+_async_join_writer(void) {
+  if (!_async_running) {
+    return;
+  }
+
+  __atomic_store_n(&_async_stop, true, __ATOMIC_RELEASE);
+  sem_post(&_async_signal);
+  pthread_join(_async_thread, NULL);
+
+  _async_running = false;
+}
+
+/**
+ * Generates a logfile entry and calls all log handler to store/output it.
+ * @param severity severity of the log event (LOG_SEVERITY_DEBUG to LOG_SEVERITY_WARN)
+ * @param source source of the log event (LOG_LOGGING, ... )
+ * @param file filename where the logging macro have been called
+ * @param line line number where the logging macro have been called
+ * @param forced true to ignore the logging masks of the handlers
+ * @param hexptr pointer to binary buffer that should be appended as a hexdump
+ * @param hexlen length of binary buffer to hexdump
+ * @param format printf format string for log output
+ * @param ap variable arguments of format string
+ */
+static void
+_log_event(enum oonf_log_severity severity, enum oonf_log_source source, const char *file, int line, bool forced,
+  const void *hexptr, size_t hexlen, const char *format, va_list ap) {
+  struct oonf_log_parameters param;
+  struct oonf_walltime_str tbuf;
+  char *last;
+  int p1 = 0, p2 = 0;
+
+  if (_async_is_writer) {
+    /* handlers called by the writer thread cannot log, the ring has only one producer */
+    __atomic_add_fetch(&_async_dropped, 1, __ATOMIC_RELAXED);
+    return;
+  }
+
+  if (severity == LOG_SEVERITY_WARN) {
+    /* count warnings */
+    _log_warnings[source]++;
+    _log_warnings[LOG_ALL]++;
+  }
+
+  /* generate log string */
+  abuf_clear(&_logbuffer);
+  p1 = abuf_puts(&_logbuffer, oonf_log_get_walltime(&tbuf));
+  p2 = abuf_appendf(&_logbuffer, " %s(%s) %s %d: ", LOG_SEVERITY_NAMES[severity], LOG_SOURCE_NAMES[source], file, line);
+  abuf_vappendf(&_logbuffer, format, ap);
+
+  last = &abuf_getptr(&_logbuffer)[abuf_getlen(&_logbuffer) - 1];
+  if (hexptr) {
+    /* append \n at the end of the line if necessary */
+    if (*last != '\n') {
+      abuf_puts(&_logbuffer, "\n");
+    }
+
+    abuf_hexdump(&_logbuffer, "", hexptr, hexlen);
+  }
+  else {
+    /* remove \n at the end of the line if necessary */
+    if (*last == '\n') {
+      *last = 0;
+    }
+  }
+
+  param.severity = severity;
+  param.source = source;
+  param.file = file;
+  param.line = line;
+  param.buffer = abuf_getptr(&_logbuffer);
+  param.timeLength = p1;
+  param.prefixLength = p2;
+
+  if (!_async_running || _async_suspended > 0) {
+    _log_to_handlers(&param, forced, _LOG_ALL_HANDLERS);
+  }
+  else if (severity == LOG_SEVERITY_ASSERT) {
+    /* process might abort after this message, so write everything now */
+    oonf_log_async_suspend();
+    _log_to_handlers(&param, forced, _LOG_ALL_HANDLERS);
+    oonf_log_async_resume();
+  }
+  else {
+    if (_async_enqueue(&param, abuf_getlen(&_logbuffer), forced)) {
+      sem_post(&_async_signal);
+    }
+
+    /* handlers that are not thread safe stay on the scheduler thread, they might log themselves */
+    _log_to_handlers(&param, forced, _LOG_SYNC_HANDLERS);
+  }
+}
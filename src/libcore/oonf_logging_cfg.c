@@ -49,6 +49,7 @@
 #include <string.h>
 
 #include <oonf/oonf.h>
+#include <oonf/libcommon/isonumber.h>
 #include <oonf/libconfig/cfg.h>
 #include <oonf/libconfig/cfg_db.h>
 #include <oonf/libconfig/cfg_schema.h>
@@ -78,6 +79,12 @@
 /*! configuration entry for activating stderr color logging */
 #define LOG_STDERR_COLOR_ENTRY "stderr_color"
 
+/*! configuration entry for activating asynchronous logging */
+#define LOG_ASYNC_ENTRY "async"
+
+/*! configuration entry for the buffer size of asynchronous logging */
+#define LOG_ASYNC_BUFFER_ENTRY "async_buffer"
+
 /* prototype for configuration change handler */
 static void _cb_logcfg_apply(void);
 static void _apply_log_setting(
@@ -94,6 +101,11 @@ static struct cfg_schema_entry _logging_entries[] = {
   CFG_VALIDATE_BOOL(LOG_SYSLOG_ENTRY, "false", "Set to true to activate logging to syslog"),
   CFG_VALIDATE_STRING(LOG_FILE_ENTRY, "", "Set a filename to log to a file"),
   CFG_VALIDATE_BOOL(LOG_STDERR_COLOR_ENTRY, "false", "Use ANSI colors for stderr logging"),
+  CFG_VALIDATE_BOOL(LOG_ASYNC_ENTRY, "false",
+    "Set to true to write logging output with a separate thread, so slow logging targets"
+    " do not delay the protocol. Events are dropped if the buffer is full."),
+  CFG_VALIDATE_INT32_MINMAX(LOG_ASYNC_BUFFER_ENTRY, "262144", "Buffer size for asynchronous logging in bytes", 0, false,
+    OONF_LOG_ASYNC_MIN_SIZE, 64 * 1024 * 1024),
 };
 
 static struct cfg_schema_section _logging_section = {
@@ -107,9 +119,19 @@ static struct cfg_schema_section _logging_section = {
 static uint8_t _logging_cfg[LOG_MAXIMUM_SOURCES];
 
 static bool _stderr_color = false;
-static struct oonf_log_handler_entry _stderr_handler = { .handler = oonf_log_stderr, .custom = &_stderr_color };
-static struct oonf_log_handler_entry _syslog_handler = { .handler = oonf_log_syslog };
-static struct oonf_log_handler_entry _file_handler = { .handler = oonf_log_file };
+static struct oonf_log_handler_entry _stderr_handler = {
+  .handler = oonf_log_stderr,
+  .custom = &_stderr_color,
+  .thread_safe = true,
+};
+static struct oonf_log_handler_entry _syslog_handler = {
+  .handler = oonf_log_syslog,
+  .thread_safe = true,
+};
+static struct oonf_log_handler_entry _file_handler = {
+  .handler = oonf_log_file,
+  .thread_safe = true,
+};
 
 /**
  * Initialize logging configuration
@@ -136,10 +158,10 @@ oonf_logcfg_cleanup(void) {
     FILE *f;
 
     f = _file_handler.custom;
+    oonf_log_removehandler(&_file_handler);
+
     fflush(f);
     fclose(f);
-
-    oonf_log_removehandler(&_file_handler);
   }
 }
 
@@ -153,7 +175,8 @@ oonf_logcfg_apply(struct cfg_db *db) {
   struct cfg_named_section *named;
   const char *ptr, *file_name;
   int file_errno = 0;
-  bool activate_syslog, activate_file, activate_stderr;
+  bool activate_syslog, activate_file, activate_stderr, activate_async;
+  int64_t async_buffer;
 
   /* clean up logging mask */
   oonf_log_mask_clear(_logging_cfg);
@@ -182,6 +205,17 @@ oonf_logcfg_apply(struct cfg_db *db) {
   ptr = cfg_db_get_entry_value(db, LOG_SECTION, NULL, LOG_STDERR_COLOR_ENTRY)->value;
   _stderr_color = cfg_get_bool(ptr);
 
+  ptr = cfg_db_get_entry_value(db, LOG_SECTION, NULL, LOG_ASYNC_ENTRY)->value;
+  activate_async = cfg_get_bool(ptr);
+
+  ptr = cfg_db_get_entry_value(db, LOG_SECTION, NULL, LOG_ASYNC_BUFFER_ENTRY)->value;
+  if (isonumber_to_s64(&async_buffer, ptr, NULL, 1)) {
+    async_buffer = OONF_LOG_ASYNC_DEFAULT_SIZE;
+  }
+
+  /* handlers are modified while the writer thread is stopped */
+  oonf_log_async_suspend();
+
   /* and finally modify the logging handlers */
   /* log.file */
   if (activate_file && !list_is_node_added(&_file_handler._node)) {
@@ -189,8 +223,8 @@ oonf_logcfg_apply(struct cfg_db *db) {
 
     f = fopen(file_name, "w");
     if (f != NULL) {
-      oonf_log_addhandler(&_file_handler);
       _file_handler.custom = f;
+      oonf_log_addhandler(&_file_handler);
     }
     else {
       file_errno = errno;
@@ -230,6 +264,16 @@ oonf_logcfg_apply(struct cfg_db *db) {
   /* reload logging mask */
   oonf_log_updatemask();
 
+  oonf_log_async_resume();
+
+  /* log.async */
+  if (activate_async) {
+    oonf_log_async_start(async_buffer);
+  }
+  else {
+    oonf_log_async_stop();
+  }
+
   if (file_errno) {
     OONF_WARN(LOG_MAIN, "Cannot open file '%s' for logging: %s (%d)", file_name, strerror(file_errno), file_errno);
     return 1;
@@ -260,11 +260,16 @@ oonf_main(int argc, char **argv, const struct oonf_appdata *appdata) {
   }
   /* see if we need to fork */
   if (config_global.fork && !_display_schema) {
+    /* the logging thread would not survive the fork */
+    oonf_log_async_suspend();
+
     /* tell main process that we are finished with initialization */
     if (daemon(0, 0) < 0) {
+      oonf_log_async_resume();
       OONF_WARN(LOG_MAIN, "Could not fork into background: %s (%d)", strerror(errno), errno);
       goto oonf_cleanup;
     }
+    oonf_log_async_resume();
 
     if (config_global.pidfile && *config_global.pidfile != 0) {
       if (_write_pidfile(config_global.pidfile)) {
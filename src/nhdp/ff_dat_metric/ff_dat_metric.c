@@ -1306,6 +1306,8 @@ _cb_cfg_changed(void) {
     return;
   }
 
-  /* start/change sampling timer */
-  oonf_timer_set(&ifconfig->_sampling_timer, 1000);
+  /* start sampling timer, the interval never changes */
+  if (!oonf_timer_is_active(&ifconfig->_sampling_timer)) {
+    oonf_timer_set(&ifconfig->_sampling_timer, 1000);
+  }
 }
@@ -239,7 +239,7 @@ nhdp_db_neighbor_remove(struct nhdp_neighbor *neigh) {
 #ifdef OONF_LOG_DEBUG_INFO
   struct netaddr_str nbuf;
 #endif
-  bool was_mpr;
+  bool mpr_outdated;
 
   OONF_DEBUG(LOG_NHDP, "Remove Neighbor: 0x%0zx (%s)", (size_t)neigh, netaddr_to_string(&nbuf, &neigh->originator));
 
@@ -264,17 +264,17 @@ nhdp_db_neighbor_remove(struct nhdp_neighbor *neigh) {
     avl_remove(&_neigh_originator_tree, &neigh->_originator_node);
   }
 
-  /* check if neighbor was a MPR */
-  was_mpr = false;
+  /* check if neighbor was part of the MPR selection or a MPR */
+  mpr_outdated = neigh->symmetric > 0;
   list_for_each_element(nhdp_domain_get_list(), domain, _node) {
     neighdata = nhdp_domain_get_neighbordata(domain, neigh);
     if (neighdata->neigh_is_mpr) {
-      was_mpr = true;
+      mpr_outdated = true;
       break;
     }
   }
 
-  if (was_mpr) {
+  if (mpr_outdated) {
     /* all domains might have changed */
     nhdp_domain_delayed_mpr_recalculation(NULL, neigh);
   }
@@ -318,6 +318,11 @@ nhdp_db_neighbor_join(struct nhdp_neighbor *dst, struct nhdp_neighbor *src) {
   /* fix symmetric link count */
   dst->symmetric += src->symmetric;
 
+  if (dst->symmetric > 0) {
+    /* links and addresses of a symmetric neighbor changed */
+    nhdp_domain_delayed_mpr_recalculation(NULL, dst);
+  }
+
   /* move links */
   list_for_each_element_safe(&src->_links, lnk, _neigh_node, l_it) {
     /* more addresses to new neighbor */
@@ -382,6 +387,10 @@ nhdp_db_neighbor_addr_add(struct nhdp_neighbor *neigh, const struct netaddr *add
   avl_insert(&_naddr_tree, &naddr->_global_node);
   avl_insert(&neigh->_neigh_addresses, &naddr->_neigh_node);
 
+  if (neigh->symmetric > 0) {
+    nhdp_domain_delayed_mpr_recalculation(NULL, neigh);
+  }
+
   /* trigger event */
   oonf_class_event(&_naddr_info, naddr, OONF_OBJECT_ADDED);
 
@@ -397,6 +406,10 @@ nhdp_db_neighbor_addr_remove(struct nhdp_naddr *naddr) {
   /* trigger event */
   oonf_class_event(&_naddr_info, naddr, OONF_OBJECT_REMOVED);
 
+  if (naddr->neigh->symmetric > 0) {
+    nhdp_domain_delayed_mpr_recalculation(NULL, naddr->neigh);
+  }
+
   /* remove from trees */
   avl_remove(&_naddr_tree, &naddr->_global_node);
   avl_remove(&naddr->neigh->_neigh_addresses, &naddr->_neigh_node);
@@ -415,6 +428,10 @@ nhdp_db_neighbor_addr_remove(struct nhdp_naddr *naddr) {
  */
 void
 nhdp_db_neighbor_addr_move(struct nhdp_neighbor *neigh, struct nhdp_naddr *naddr) {
+  if (neigh->symmetric > 0 || naddr->neigh->symmetric > 0) {
+    nhdp_domain_delayed_mpr_recalculation(NULL, neigh);
+  }
+
   /* remove from old neighbor */
   avl_remove(&naddr->neigh->_neigh_addresses, &naddr->_neigh_node);
 
@@ -461,6 +478,15 @@ nhdp_db_neighbor_set_originator(struct nhdp_neighbor *neigh, const struct netadd
     }
 
     netaddr_invalidate(&neigh2->originator);
+
+    if (neigh2->symmetric > 0) {
+      nhdp_domain_delayed_mpr_recalculation(NULL, neigh2);
+    }
+  }
+
+  if (neigh->symmetric > 0) {
+    /* the MPR selection keeps its neighbors sorted by originator */
+    nhdp_domain_delayed_mpr_recalculation(NULL, neigh);
   }
 
   /* copy originator address into neighbor */
@@ -757,6 +783,10 @@ nhdp_db_link_2hop_add(struct nhdp_link *lnk, const struct netaddr *addr) {
   /* initialize metrics */
   nhdp_domain_init_l2hop(l2hop);
 
+  if (lnk->neigh->symmetric > 0) {
+    nhdp_domain_delayed_mpr_recalculation(NULL, lnk->neigh);
+  }
+
   /* trigger event */
   oonf_class_event(&_l2hop_info, l2hop, OONF_OBJECT_ADDED);
 
@@ -772,6 +802,10 @@ nhdp_db_link_2hop_remove(struct nhdp_l2hop *l2hop) {
   /* trigger event */
   oonf_class_event(&_l2hop_info, l2hop, OONF_OBJECT_REMOVED);
 
+  if (l2hop->link->neigh->symmetric > 0) {
+    nhdp_domain_delayed_mpr_recalculation(NULL, l2hop->link->neigh);
+  }
+
   /* remove from link tree */
   avl_remove(&l2hop->link->_2hop, &l2hop->_link_node);
 
@@ -849,7 +883,6 @@ nhdp_db_link_update_status(struct nhdp_link *lnk) {
     /* link status was changed */
     lnk->last_status_change = oonf_clock_getNow();
     nhdp_domain_recalculate_metrics(NULL, lnk->neigh, true);
-    nhdp_domain_delayed_mpr_recalculation(NULL, lnk->neigh);
 
     /* trigger change event */
     oonf_class_event(&_link_info, lnk, OONF_OBJECT_CHANGED);
@@ -963,6 +996,7 @@ _link_status_now_symmetric(struct nhdp_link *lnk) {
   struct nhdp_naddr *naddr;
 
   lnk->neigh->symmetric++;
+  nhdp_domain_delayed_mpr_recalculation(NULL, lnk->neigh);
 
   if (lnk->neigh->symmetric == 1) {
     avl_for_each_element(&lnk->neigh->_neigh_addresses, naddr, _neigh_node) {
@@ -986,6 +1020,8 @@ _link_status_not_symmetric_anymore(struct nhdp_link *lnk) {
     nhdp_db_link_2hop_remove(twohop);
   }
 
+  nhdp_domain_delayed_mpr_recalculation(NULL, lnk->neigh);
+
   lnk->neigh->symmetric--;
   if (lnk->neigh->symmetric == 0) {
     /* mark all neighbor addresses as lost */
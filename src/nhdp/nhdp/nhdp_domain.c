@@ -73,6 +73,8 @@ static bool _recalculate_metrics(struct nhdp_domain *domain, struct nhdp_neighbo
 static bool _recalculate_neighbor_metric(struct nhdp_domain *domain, struct nhdp_neighbor *neigh);
 static bool _recalculate_routing_mpr_set(struct nhdp_domain *domain);
 static bool _recalculate_flooding_mpr_set(void);
+static bool _is_mpr_relevant_metric_change(uint32_t old_metric, uint32_t new_metric);
+static bool _is_flooding_link(struct nhdp_domain *domain, struct nhdp_link *lnk);
 
 static const char *_link_to_string(struct nhdp_metric_str *, uint32_t);
 static const char *_path_to_string(struct nhdp_metric_str *, uint32_t, uint8_t);
@@ -441,6 +443,7 @@ nhdp_domain_init_neighbor(struct nhdp_neighbor *neigh) {
 void
 nhdp_domain_process_metric_linktlv(struct nhdp_domain *domain, struct nhdp_link *lnk, const uint8_t *value) {
   struct rfc7181_metric_field metric_field;
+  struct nhdp_link_domaindata *linkdata;
   uint32_t metric;
   bool link, neigh;
 
@@ -452,7 +455,12 @@ nhdp_domain_process_metric_linktlv(struct nhdp_domain *domain, struct nhdp_link
   OONF_DEBUG(LOG_NHDP_R, "Set incoming %s/%s metric: %u",
              link ? "link":"-", neigh ? "neigh":"-", metric);
   if (link) {
-    nhdp_domain_get_linkdata(domain, lnk)->metric.out = metric;
+    linkdata = nhdp_domain_get_linkdata(domain, lnk);
+    if (_is_flooding_link(domain, lnk) && _is_mpr_relevant_metric_change(linkdata->metric.out, metric)) {
+      /* the routing MPRs only use the incoming metric */
+      _flooding_domain._mpr_outdated = true;
+    }
+    linkdata->metric.out = metric;
   }
   if (neigh) {
     nhdp_domain_get_neighbordata(domain, lnk->neigh)->metric.out = metric;
@@ -469,16 +477,26 @@ void
 nhdp_domain_process_metric_2hoptlv(struct nhdp_domain *domain, struct nhdp_l2hop *l2hop, const uint8_t *value) {
   struct rfc7181_metric_field metric_field;
   struct nhdp_l2hop_domaindata *data;
+  struct nhdp_neighbor *neigh;
   uint32_t metric;
 
   memcpy(&metric_field, value, sizeof(metric_field));
   metric = rfc7181_metric_decode(&metric_field);
 
   data = nhdp_domain_get_l2hopdata(domain, l2hop);
+  neigh = l2hop->link->neigh;
   if (rfc7181_metric_has_flag(&metric_field, RFC7181_LINKMETRIC_INCOMING_NEIGH)) {
+    /* 2-hop neighbors of unreachable neighbors are not part of the MPR selection */
+    if (neigh->symmetric > 0 && nhdp_domain_get_neighbordata(domain, neigh)->metric.in <= RFC7181_METRIC_MAX &&
+        _is_mpr_relevant_metric_change(data->metric.in, metric)) {
+      domain->_mpr_outdated = true;
+    }
     data->metric.in = metric;
   }
   if (rfc7181_metric_has_flag(&metric_field, RFC7181_LINKMETRIC_OUTGOING_NEIGH)) {
+    if (_is_flooding_link(domain, l2hop->link) && _is_mpr_relevant_metric_change(data->metric.out, metric)) {
+      _flooding_domain._mpr_outdated = true;
+    }
     data->metric.out = metric;
   }
 }
@@ -555,21 +573,45 @@ nhdp_domain_recalculate_mpr(void) {
   struct nhdp_domain *domain;
 
   list_for_each_element(&_domain_list, domain, _node) {
+    if (domain->_mpr_requested || domain->_mpr_outdated) {
+      domain->mpr_requested++;
+    }
     if (domain->_mpr_outdated) {
+      domain->mpr_calculated++;
       if (_recalculate_routing_mpr_set(domain)) {
-        domain->mpr->update_routing_mpr(domain);
         _fire_mpr_changed(domain);
       }
-      domain->_mpr_outdated = false;
     }
+    domain->_mpr_requested = false;
+    domain->_mpr_outdated = false;
+  }
+
+  if (_flooding_domain._mpr_requested || _flooding_domain._mpr_outdated) {
+    _flooding_domain.mpr_requested++;
   }
   if (_flooding_domain._mpr_outdated) {
+    _flooding_domain.mpr_calculated++;
     if (_recalculate_flooding_mpr_set()) {
-      _flooding_domain.mpr->update_flooding_mpr(&_flooding_domain);
       _fire_mpr_changed(&_flooding_domain);
     }
-    _flooding_domain._mpr_outdated = false;
   }
+  _flooding_domain._mpr_requested = false;
+  _flooding_domain._mpr_outdated = false;
+}
+
+/**
+ * This asks for a MPR recalculation of all domains as soon as a Hello is sent.
+ * The MPR sets are only recalculated if a change of the NHDP database
+ * relevant for the MPR selection has been recorded in the meantime.
+ */
+void
+nhdp_domain_request_mpr_recalculation(void) {
+  struct nhdp_domain *domain;
+
+  list_for_each_element(&_domain_list, domain, _node) {
+    domain->_mpr_requested = true;
+  }
+  _flooding_domain._mpr_requested = true;
 }
 
 /**
@@ -588,6 +630,7 @@ nhdp_domain_delayed_mpr_recalculation(struct nhdp_domain *domain, struct nhdp_ne
     return;
   }
 
+  domain->_mpr_requested = true;
   domain->_mpr_outdated = true;
 }
 
@@ -752,11 +795,17 @@ nhdp_domain_store_willingness(struct nhdp_link *lnk) {
   struct nhdp_neighbor_domaindata *neighdata;
   struct nhdp_domain *domain;
 
+  if (lnk->flooding_willingness != _flooding_domain._tmp_willingness) {
+    _flooding_domain._mpr_outdated = true;
+  }
   lnk->flooding_willingness = _flooding_domain._tmp_willingness;
   OONF_DEBUG(LOG_NHDP_R, "Set flooding willingness: %u", lnk->flooding_willingness);
 
   list_for_each_element(&_domain_list, domain, _node) {
     neighdata = nhdp_domain_get_neighbordata(domain, lnk->neigh);
+    if (neighdata->willingness != domain->_tmp_willingness) {
+      domain->_mpr_outdated = true;
+    }
     neighdata->willingness = domain->_tmp_willingness;
     OONF_DEBUG(LOG_NHDP_R, "Set routing willingness for domain %u: %u", domain->ext, neighdata->willingness);
   }
@@ -980,6 +1029,35 @@ _recalculate_flooding_mpr_set(void) {
   return false;
 }
 
+/**
+ * Check if a metric change of a neighbor or 2-hop neighbor can change
+ * the MPR selection. A change between two values above the maximum
+ * metric does not change the set of reachable nodes or any distance.
+ * @param old_metric metric before the change
+ * @param new_metric metric after the change
+ * @return true if the MPR set has to be recalculated
+ */
+static bool
+_is_mpr_relevant_metric_change(uint32_t old_metric, uint32_t new_metric) {
+  if (old_metric == new_metric) {
+    return false;
+  }
+  return old_metric <= RFC7181_METRIC_MAX || new_metric <= RFC7181_METRIC_MAX;
+}
+
+/**
+ * Check if the outgoing metrics of a domain for a link are used
+ * by the flooding MPR selection. The flooding domain has no metric
+ * of its own and uses the data of the domain with the same index.
+ * @param domain NHDP domain of the metric
+ * @param lnk NHDP link
+ * @return true if the link is part of the flooding MPR input
+ */
+static bool
+_is_flooding_link(struct nhdp_domain *domain, struct nhdp_link *lnk) {
+  return domain->index == _flooding_domain.index && lnk->status == NHDP_LINK_SYMMETRIC;
+}
+
 /**
  * Recalculate the MPR set of a NHDP domain
  * @param domain nhdp domain
@@ -1028,12 +1106,14 @@ _recalculate_neighbor_metric(struct nhdp_domain *domain, struct nhdp_neighbor *n
   struct nhdp_l2hop *l2hop;
   struct nhdp_l2hop_domaindata *l2hopdata;
   struct nhdp_neighbor_domaindata *neighdata;
+  uint32_t old_metric_in;
   bool changed;
 #ifdef OONF_LOG_INFO
   struct netaddr_str nbuf;
 #endif
 
   neighdata = nhdp_domain_get_neighbordata(domain, neigh);
+  old_metric_in = neighdata->metric.in;
   changed = false;
 
   /* reset metric */
@@ -1088,6 +1168,10 @@ _recalculate_neighbor_metric(struct nhdp_domain *domain, struct nhdp_neighbor *n
     neighdata->best_out_link_metric = linkdata->metric.out;
   }
 
+  /* link metric changes hidden by the metric hysteresis do not reach the neighbor metric */
+  if (_is_mpr_relevant_metric_change(old_metric_in, neighdata->metric.in)) {
+    domain->_mpr_outdated = true;
+  }
   return changed;
 }
 
@@ -1251,6 +1335,9 @@ static void
 _apply_mpr(struct nhdp_domain *domain, const char *mpr_name, uint8_t willingness) {
   struct nhdp_domain_mpr *mpr;
 
+  if (domain->local_willingness != willingness) {
+    domain->_mpr_outdated = true;
+  }
   domain->local_willingness = willingness;
 
   /* check if we have to remove the old mpr first */
@@ -1280,6 +1367,7 @@ _apply_mpr(struct nhdp_domain *domain, const char *mpr_name, uint8_t willingness
   /* link domain and mpr */
   domain->mpr->_refcount--;
   domain->mpr = mpr;
+  domain->_mpr_outdated = true;
 
   /* activate mpr */
   if (mpr->_refcount == 0 && mpr->enable) {
@@ -1301,6 +1389,7 @@ _remove_mpr(struct nhdp_domain *domain) {
   strscpy(domain->mpr_name, CFG_DOMAIN_NO_METRIC_MPR, sizeof(domain->mpr_name));
   domain->mpr = &_everyone_mprs;
   domain->mpr->_refcount++;
+  domain->_mpr_outdated = true;
 }
 
 static void
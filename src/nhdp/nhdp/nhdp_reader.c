@@ -984,7 +984,7 @@ _cb_msg_pass2_end(struct rfc5444_reader_tlvblock_context *context, bool dropped)
 
   /* update link metrics and MPR */
   nhdp_domain_recalculate_metrics(NULL, _current.neighbor, false);
-  nhdp_domain_delayed_mpr_recalculation(NULL, _current.neighbor);
+  nhdp_domain_request_mpr_recalculation();
 
   return RFC5444_OKAY;
 }
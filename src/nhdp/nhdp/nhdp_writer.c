@@ -43,6 +43,8 @@
  * @file
  */
 
+#include <stdlib.h>
+
 #include <oonf/libcommon/avl.h>
 #include <oonf/libcommon/avl_comp.h>
 #include <oonf/oonf.h>
@@ -64,18 +66,93 @@ enum
   IDX_ADDRTLV_MPR,
 };
 
+enum
+{
+  /*! number of address slots allocated at once for the Hello cache */
+  HELLO_CACHE_STEP = 32,
+
+  /*! value for unused link status and local-if TLVs */
+  HELLO_NO_TLV = 255,
+};
+
+/**
+ * Precalculated content of an address of a Hello message
+ */
+struct _hello_address {
+  /*! address of local interface or neighbor */
+  struct netaddr addr;
+
+  /*! value of LOCALIF TLV, HELLO_NO_TLV for neighbor addresses */
+  uint8_t localif;
+
+  /*! value of LINK_STATUS TLV, HELLO_NO_TLV if not present */
+  uint8_t linkstatus;
+
+  /*! value of OTHER_NEIGHB TLV */
+  uint8_t otherneigh;
+
+  /*! length of MPR TLV value, 0 if not present */
+  uint8_t mpr_len;
+
+  /*! value of MPR TLV */
+  uint8_t mpr[NHDP_MAXIMUM_DOMAINS];
+
+  /*! number of metric TLVs for each domain */
+  uint8_t metric_count[NHDP_MAXIMUM_DOMAINS];
+
+  /*! encoded metric TLV values for each domain */
+  struct rfc7181_metric_field metric[NHDP_MAXIMUM_DOMAINS][4];
+};
+
+/**
+ * Content of the Hello messages of an interface, generated once
+ * and shared between the IPv4 and the IPv6 message.
+ */
+struct _hello_cache {
+  /*! interface the cache has been generated for, NULL if invalid */
+  struct nhdp_interface *interf;
+
+  /*! encoded interval time */
+  uint8_t itime_encoded;
+
+  /*! encoded validity time */
+  uint8_t vtime_encoded;
+
+  /*! value of MPR_TYPES TLV */
+  uint8_t mprtypes[NHDP_MAXIMUM_DOMAINS];
+
+  /*! length of MPR_TYPES TLV */
+  uint8_t mprtypes_size;
+
+  /*! value of MPR_WILLING TLV */
+  uint8_t willingness[NHDP_MAXIMUM_DOMAINS];
+
+  /*! length of MPR_WILLING TLV */
+  size_t willingness_size;
+
+  /*! addresses of message, index 0 for IPv4, 1 for IPv6 */
+  struct _hello_address *addr[2];
+
+  /*! number of used addresses for each address family */
+  size_t addr_count[2];
+
+  /*! number of allocated addresses for each address family */
+  size_t addr_size[2];
+};
+
 /* prototypes */
 static int _cb_addMessageHeader(struct rfc5444_writer *, struct rfc5444_writer_message *);
 static void _cb_addMessageTLVs(struct rfc5444_writer *);
 static void _cb_addAddresses(struct rfc5444_writer *);
 
-static void _add_link_address(struct rfc5444_writer *writer, struct rfc5444_writer_content_provider *prv,
-  struct nhdp_interface *interf, struct nhdp_naddr *naddr);
-static void _add_localif_address(struct rfc5444_writer *writer, struct rfc5444_writer_content_provider *prv,
-  struct nhdp_interface *interf, struct nhdp_interface_addr *addr);
-
-static void _write_metric_tlv(struct rfc5444_writer *writer, struct rfc5444_writer_address *addr,
-  struct nhdp_neighbor *neigh, struct nhdp_link *lnk, struct nhdp_domain *domain);
+static struct _hello_cache *_get_hello_cache(struct nhdp_interface *interf);
+static struct _hello_address *_add_cache_address(const struct netaddr *addr);
+static void _cache_localif_address(struct nhdp_interface *interf, struct nhdp_interface_addr *addr);
+static void _cache_link_address(struct nhdp_interface *interf, struct nhdp_naddr *naddr);
+static uint8_t _encode_metric_tlvs(struct rfc7181_metric_field *tlvs, struct nhdp_neighbor *neigh,
+  struct nhdp_link *lnk, struct nhdp_domain *domain);
+static void _add_hello_address(struct rfc5444_writer *writer, struct rfc5444_writer_content_provider *prv,
+  struct _hello_address *cached);
 
 /* definition of NHDP writer */
 static struct rfc5444_writer_message *_nhdp_message = NULL;
@@ -98,6 +175,7 @@ static struct oonf_rfc5444_protocol *_protocol;
 static bool _cleanedup = false;
 static bool _add_mac_tlv = true;
 static struct nhdp_interface *_nhdp_if = NULL;
+static struct _hello_cache _hello_cache;
 
 /**
  * Initialize nhdp writer
@@ -137,6 +215,10 @@ nhdp_writer_cleanup(void) {
   rfc5444_writer_unregister_content_provider(
     &_protocol->writer, &_nhdp_msgcontent_provider, _nhdp_addrtlvs, ARRAYSIZE(_nhdp_addrtlvs));
   rfc5444_writer_unregister_message(&_protocol->writer, _nhdp_message);
+
+  free(_hello_cache.addr[0]);
+  free(_hello_cache.addr[1]);
+  memset(&_hello_cache, 0, sizeof(_hello_cache));
 }
 
 /**
@@ -181,6 +263,9 @@ nhdp_writer_send_hello(struct nhdp_interface *ninterf) {
     OONF_WARN(LOG_NHDP_W, "Could not send NHDP message to %s: %s (%d)",
       netaddr_to_string(&buf, &ninterf->rfc5444_if.interface->multicast6->dst), rfc5444_strerror(result), result);
   }
+
+  /* database might change before the next Hello */
+  _hello_cache.interf = NULL;
 }
 
 /**
@@ -243,14 +328,10 @@ _cb_addMessageHeader(struct rfc5444_writer *writer, struct rfc5444_writer_messag
  */
 static void
 _cb_addMessageTLVs(struct rfc5444_writer *writer) {
-  uint8_t vtime_encoded, itime_encoded;
   struct oonf_rfc5444_target *target;
   const struct netaddr *v4_originator;
   struct os_interface *os_if;
-  uint8_t willingness[NHDP_MAXIMUM_DOMAINS];
-  size_t willingness_size;
-  uint8_t mprtypes[NHDP_MAXIMUM_DOMAINS];
-  uint8_t mprtypes_size;
+  struct _hello_cache *cache;
   struct netaddr_str buf;
 
   target = oonf_rfc5444_get_target_from_writer(writer);
@@ -258,22 +339,22 @@ _cb_addMessageTLVs(struct rfc5444_writer *writer) {
   OONF_ASSERT(target == target->interface->multicast4 || target == target->interface->multicast6,
                 LOG_NHDP_W, "target for NHDP is no interface multicast: %s", netaddr_to_string(&buf, &target->dst));
 
-  itime_encoded = rfc5497_timetlv_encode(_nhdp_if->refresh_interval);
-  vtime_encoded = rfc5497_timetlv_encode(_nhdp_if->h_hold_time);
+  cache = _get_hello_cache(_nhdp_if);
 
-  rfc5444_writer_add_messagetlv(writer, RFC5497_MSGTLV_INTERVAL_TIME, 0, &itime_encoded, sizeof(itime_encoded));
-  rfc5444_writer_add_messagetlv(writer, RFC5497_MSGTLV_VALIDITY_TIME, 0, &vtime_encoded, sizeof(vtime_encoded));
+  rfc5444_writer_add_messagetlv(
+    writer, RFC5497_MSGTLV_INTERVAL_TIME, 0, &cache->itime_encoded, sizeof(cache->itime_encoded));
+  rfc5444_writer_add_messagetlv(
+    writer, RFC5497_MSGTLV_VALIDITY_TIME, 0, &cache->vtime_encoded, sizeof(cache->vtime_encoded));
 
-  /* generate MPRtypes */
-  mprtypes_size = nhdp_domain_encode_mprtypes_tlvvalue(mprtypes, sizeof(mprtypes));
-  if (mprtypes_size > 1) {
+  /* add MPRtypes */
+  if (cache->mprtypes_size > 1) {
     rfc5444_writer_add_messagetlv(
-      writer, RFC7722_MSGTLV_MPR_TYPES, RFC7722_MSGTLV_MPR_TYPES_EXT, &mprtypes, mprtypes_size);
+      writer, RFC7722_MSGTLV_MPR_TYPES, RFC7722_MSGTLV_MPR_TYPES_EXT, cache->mprtypes, cache->mprtypes_size);
   }
 
   /* add willingness for all domains */
-  willingness_size = nhdp_domain_encode_willingness_tlvvalue(willingness, sizeof(willingness));
-  rfc5444_writer_add_messagetlv(writer, RFC7181_MSGTLV_MPR_WILLING, 0, &willingness, willingness_size);
+  rfc5444_writer_add_messagetlv(
+    writer, RFC7181_MSGTLV_MPR_WILLING, 0, cache->willingness, cache->willingness_size);
 
   /* get v6 originator (might be unspecified) */
   v4_originator = nhdp_get_originator(AF_INET);
@@ -294,135 +375,186 @@ _cb_addMessageTLVs(struct rfc5444_writer *writer) {
 }
 
 /**
- * Add a rfc5444 address with localif TLV to the stream
- * @param writer RFC5444 writer instance
- * @param prv RFC5444 content provider instance
+ * Get the precalculated content of the Hello messages of an interface,
+ * generate it if necessary. The content is shared between the IPv4 and
+ * the IPv6 Hello of an interface, so the NHDP database has only to be
+ * walked once per Hello interval.
+ * @param interf NHDP interface
+ * @return pointer to Hello cache
+ */
+static struct _hello_cache *
+_get_hello_cache(struct nhdp_interface *interf) {
+  struct nhdp_interface_addr *addr;
+  struct nhdp_naddr *naddr;
+
+  if (_hello_cache.interf == interf) {
+    return &_hello_cache;
+  }
+
+  OONF_DEBUG(LOG_NHDP_W, "Generate Hello content for interface %s", nhdp_interface_get_name(interf));
+
+  _hello_cache.interf = interf;
+  _hello_cache.addr_count[0] = 0;
+  _hello_cache.addr_count[1] = 0;
+
+  _hello_cache.itime_encoded = rfc5497_timetlv_encode(interf->refresh_interval);
+  _hello_cache.vtime_encoded = rfc5497_timetlv_encode(interf->h_hold_time);
+
+  _hello_cache.mprtypes_size =
+    nhdp_domain_encode_mprtypes_tlvvalue(_hello_cache.mprtypes, sizeof(_hello_cache.mprtypes));
+  _hello_cache.willingness_size =
+    nhdp_domain_encode_willingness_tlvvalue(_hello_cache.willingness, sizeof(_hello_cache.willingness));
+
+  /* interface addresses first */
+  avl_for_each_element(nhdp_interface_get_address_tree(), addr, _global_node) {
+    if (!addr->removed) {
+      _cache_localif_address(interf, addr);
+    }
+  }
+
+  /* then neighbor addresses */
+  avl_for_each_element(nhdp_db_get_naddr_tree(), naddr, _global_node) {
+    _cache_link_address(interf, naddr);
+  }
+  return &_hello_cache;
+}
+
+/**
+ * Allocate a new address in the Hello cache
+ * @param addr address
+ * @return pointer to initialized cache entry, NULL if out of memory
+ *   or not an IP address
+ */
+static struct _hello_address *
+_add_cache_address(const struct netaddr *addr) {
+  struct _hello_address *cached;
+  struct netaddr_str buf;
+  int af;
+
+  switch (netaddr_get_address_family(addr)) {
+    case AF_INET:
+      af = 0;
+      break;
+    case AF_INET6:
+      af = 1;
+      break;
+    default:
+      return NULL;
+  }
+
+  if (_hello_cache.addr_count[af] == _hello_cache.addr_size[af]) {
+    cached = realloc(_hello_cache.addr[af], sizeof(*cached) * (_hello_cache.addr_size[af] + HELLO_CACHE_STEP));
+    if (!cached) {
+      OONF_WARN(LOG_NHDP_W, "Could not add address %s to NHDP hello", netaddr_to_string(&buf, addr));
+      return NULL;
+    }
+    _hello_cache.addr[af] = cached;
+    _hello_cache.addr_size[af] += HELLO_CACHE_STEP;
+  }
+
+  cached = &_hello_cache.addr[af][_hello_cache.addr_count[af]++];
+  memset(cached, 0, sizeof(*cached));
+  memcpy(&cached->addr, addr, sizeof(*addr));
+  cached->localif = HELLO_NO_TLV;
+  cached->linkstatus = HELLO_NO_TLV;
+  return cached;
+}
+
+/**
+ * Add a local interface address with localif TLV to the Hello cache
  * @param interf NHDP interface
  * @param addr NHDP interface address
  */
 static void
-_add_localif_address(struct rfc5444_writer *writer, struct rfc5444_writer_content_provider *prv,
-  struct nhdp_interface *interf, struct nhdp_interface_addr *addr) {
-  struct rfc5444_writer_address *address;
+_cache_localif_address(struct nhdp_interface *interf, struct nhdp_interface_addr *addr) {
+  struct _hello_address *cached;
   struct netaddr_str buf;
-  uint8_t value;
   bool this_if;
 
+  cached = _add_cache_address(&addr->if_addr);
+  if (!cached) {
+    return;
+  }
+
   /* check if address of local interface */
   this_if = NULL != avl_find_element(&interf->_if_addresses, &addr->if_addr, addr, _if_node);
 
   OONF_DEBUG(
-    LOG_NHDP_W, "Add %s (%s) to NHDP hello", netaddr_to_string(&buf, &addr->if_addr), this_if ? "this_if" : "other_if");
-
-  /* generate RFC5444 address */
-  address = rfc5444_writer_add_address(writer, prv->creator, &addr->if_addr, true);
-  if (address == NULL) {
-    OONF_WARN(LOG_NHDP_W, "Could not add address %s to NHDP hello", netaddr_to_string(&buf, &addr->if_addr));
-    return;
-  }
+    LOG_NHDP_W, "Add %s (%s) to NHDP hello", netaddr_to_string(&buf, &cached->addr), this_if ? "this_if" : "other_if");
 
-  /* Add LOCALIF TLV */
   if (this_if) {
-    value = RFC6130_LOCALIF_THIS_IF;
+    cached->localif = RFC6130_LOCALIF_THIS_IF;
   }
   else {
-    value = RFC6130_LOCALIF_OTHER_IF;
+    cached->localif = RFC6130_LOCALIF_OTHER_IF;
   }
-  rfc5444_writer_add_addrtlv(writer, address, &_nhdp_addrtlvs[IDX_ADDRTLV_LOCAL_IF], &value, sizeof(value), true);
 }
 
 /**
- * Add a rfc5444 address with link_status or other_neigh TLV to the stream
- * @param writer RFC5444 writer instance
- * @param prv RFC5444 content provider instance
+ * Add a neighbor address with link_status or other_neigh TLV
+ * to the Hello cache
  * @param interf NHDP interface
- * @param naddr NHDP interface address
+ * @param naddr NHDP neighbor address
  */
 static void
-_add_link_address(struct rfc5444_writer *writer, struct rfc5444_writer_content_provider *prv,
-  struct nhdp_interface *interf, struct nhdp_naddr *naddr) {
-  struct rfc5444_writer_address *address;
+_cache_link_address(struct nhdp_interface *interf, struct nhdp_naddr *naddr) {
+  struct _hello_address *cached;
   struct nhdp_domain *domain;
   struct nhdp_laddr *laddr;
+  struct nhdp_link *lnk;
+  struct nhdp_neighbor *neigh;
   struct netaddr_str buf;
-  uint8_t linkstatus, otherneigh_sym;
-  uint8_t mprvalue[NHDP_MAXIMUM_DOMAINS];
-  size_t len;
 
-  /* initialize flags for default (lost address) address */
-  linkstatus = 255;
-  otherneigh_sym = 0;
+  cached = _add_cache_address(&naddr->neigh_addr);
+  if (!cached) {
+    return;
+  }
 
   laddr = nhdp_interface_get_link_addr(interf, &naddr->neigh_addr);
   if (!nhdp_db_neighbor_addr_is_lost(naddr)) {
     if (laddr != NULL && laddr->link->local_if == interf && laddr->link->status != NHDP_LINK_PENDING) {
-      linkstatus = laddr->link->status;
+      cached->linkstatus = laddr->link->status;
     }
 
-    if (naddr->neigh->symmetric > 0 && linkstatus != NHDP_LINK_SYMMETRIC) {
-      otherneigh_sym = NHDP_LINK_SYMMETRIC;
+    if (naddr->neigh->symmetric > 0 && cached->linkstatus != NHDP_LINK_SYMMETRIC) {
+      cached->otherneigh = NHDP_LINK_SYMMETRIC;
     }
   }
 
-  /* generate RFC5444 address */
-  address = rfc5444_writer_add_address(writer, prv->creator, &naddr->neigh_addr, false);
-  if (address == NULL) {
-    OONF_WARN(LOG_NHDP_W, "Could not add address %s to NHDP hello", netaddr_to_string(&buf, &naddr->neigh_addr));
-    return;
-  }
-
-  if (linkstatus != 255) {
-    rfc5444_writer_add_addrtlv(
-      writer, address, &_nhdp_addrtlvs[IDX_ADDRTLV_LINK_STATUS], &linkstatus, sizeof(linkstatus), false);
-
-    OONF_DEBUG(LOG_NHDP_W, "Add %s (linkstatus=%d) to NHDP hello", netaddr_to_string(&buf, &naddr->neigh_addr),
-      laddr->link->status);
-  }
-
-  rfc5444_writer_add_addrtlv(
-    writer, address, &_nhdp_addrtlvs[IDX_ADDRTLV_OTHER_NEIGHB], &otherneigh_sym, sizeof(otherneigh_sym), false);
+  OONF_DEBUG(LOG_NHDP_W, "Add %s (linkstatus=%d, otherneigh=%d) to NHDP hello",
+    netaddr_to_string(&buf, &naddr->neigh_addr), cached->linkstatus, cached->otherneigh);
 
-  OONF_DEBUG(
-    LOG_NHDP_W, "Add %s (otherneigh=%d) to NHDP hello", netaddr_to_string(&buf, &naddr->neigh_addr), otherneigh_sym);
-
-  /* add MPR tlvs */
+  /* MPR tlvs */
   if (laddr != NULL) {
-    len = nhdp_domain_encode_mpr_tlvvalue(mprvalue, sizeof(mprvalue), laddr->link);
+    cached->mpr_len = nhdp_domain_encode_mpr_tlvvalue(cached->mpr, sizeof(cached->mpr), laddr->link);
+  }
 
-    if (len) {
-      rfc5444_writer_add_addrtlv(writer, address, &_nhdp_addrtlvs[IDX_ADDRTLV_MPR], &mprvalue, len, false);
-    }
+  /* linkcost TLVs */
+  lnk = NULL;
+  neigh = NULL;
+  if (cached->linkstatus == NHDP_LINK_HEARD || cached->linkstatus == NHDP_LINK_SYMMETRIC) {
+    lnk = laddr->link;
+  }
+  if (naddr->neigh->symmetric > 0 &&
+      (cached->linkstatus == NHDP_LINK_SYMMETRIC || cached->otherneigh == RFC6130_OTHERNEIGHB_SYMMETRIC)) {
+    neigh = naddr->neigh;
   }
 
-  /* add linkcost TLVs */
   list_for_each_element(nhdp_domain_get_list(), domain, _node) {
-    struct nhdp_link *lnk = NULL;
-    struct nhdp_neighbor *neigh = NULL;
-
-    OONF_DEBUG(LOG_NHDP_W, "Determine metric status: %d %d %d",
-               linkstatus, otherneigh_sym, naddr->neigh->symmetric);
-    if (linkstatus == NHDP_LINK_HEARD || linkstatus == NHDP_LINK_SYMMETRIC) {
-      lnk = laddr->link;
-    }
-    if (naddr->neigh->symmetric > 0 &&
-        (linkstatus == NHDP_LINK_SYMMETRIC || otherneigh_sym == RFC6130_OTHERNEIGHB_SYMMETRIC)) {
-      neigh = naddr->neigh;
-    }
-
-    _write_metric_tlv(writer, address, neigh, lnk, domain);
+    cached->metric_count[domain->index] = _encode_metric_tlvs(cached->metric[domain->index], neigh, lnk, domain);
   }
 }
 
 /**
- * Write up to four metric TLVs to an address
- * @param writer rfc5444 writer instance
- * @param addr rfc5444 address
+ * Encode up to four metric TLVs for an address
+ * @param tlvs array of four metric values for the TLVs
  * @param neigh symmetric NHDP neighbor, might be NULL
  * @param lnk symmetric NHDP link, might be NULL
  * @param domain NHDP domain
+ * @return number of metric TLVs
  */
-static void
-_write_metric_tlv(struct rfc5444_writer *writer, struct rfc5444_writer_address *addr, struct nhdp_neighbor *neigh,
+static uint8_t
+_encode_metric_tlvs(struct rfc7181_metric_field *tlvs, struct nhdp_neighbor *neigh,
   struct nhdp_link *lnk, struct nhdp_domain *domain) {
   static const enum rfc7181_linkmetric_flags flags[4] = {
     RFC7181_LINKMETRIC_INCOMING_LINK,
@@ -440,13 +572,14 @@ _write_metric_tlv(struct rfc5444_writer *writer, struct rfc5444_writer_address *
 #endif
   struct nhdp_link_domaindata *linkdata;
   struct nhdp_neighbor_domaindata *neighdata;
-  struct rfc7181_metric_field metric_encoded[4], tlv_value;
-  int i, j, k;
+  struct rfc7181_metric_field metric_encoded[4];
+  int i, j;
+  uint8_t k;
   uint32_t metrics[4] = { 0, 0, 0, 0 };
 
   if (lnk == NULL && neigh == NULL) {
     /* nothing to do */
-    return;
+    return 0;
   }
 
   /* get link metrics if available */
@@ -475,7 +608,7 @@ _write_metric_tlv(struct rfc5444_writer *writer, struct rfc5444_writer_address *
     if (metrics[i] > 0) {
       if (rfc7181_metric_encode(&metric_encoded[i], metrics[i])) {
         OONF_WARN(LOG_NHDP_W, "Metric encoding for %u failed", metrics[i]);
-        return;
+        return 0;
       }
     }
   }
@@ -489,28 +622,79 @@ _write_metric_tlv(struct rfc5444_writer *writer, struct rfc5444_writer_address *
     }
 
     /* create value */
-    tlv_value = metric_encoded[i];
+    tlvs[k] = metric_encoded[i];
 
     /* mark first metric value */
-    rfc7181_metric_set_flag(&tlv_value, flags[i]);
+    rfc7181_metric_set_flag(&tlvs[k], flags[i]);
 
     /* mark all metric pair that have the same linkmetric */
-    OONF_DEBUG(LOG_NHDP_W, "Add Metric %s (ext %u): 0x%02x%02x (%u)", lq_name[i], domain->ext, tlv_value.b[0],
-      tlv_value.b[1], metrics[i]);
+    OONF_DEBUG(LOG_NHDP_W, "Add Metric %s (ext %u): 0x%02x%02x (%u)", lq_name[i], domain->ext, tlvs[k].b[0],
+      tlvs[k].b[1], metrics[i]);
 
     for (j = 3; j > i; j--) {
       if (metrics[j] > 0 && memcmp(&metric_encoded[i], &metric_encoded[j], sizeof(metric_encoded[0])) == 0) {
-        rfc7181_metric_set_flag(&tlv_value, flags[j]);
+        rfc7181_metric_set_flag(&tlvs[k], flags[j]);
         metrics[j] = 0;
 
         OONF_DEBUG(LOG_NHDP_W, "Same metrics for %s (ext %u)", lq_name[j], domain->ext);
       }
     }
+    k++;
+  }
+  return k;
+}
 
-    /* add to rfc5444 address */
-    rfc5444_writer_add_addrtlv(writer, addr, &domain->_metric_addrtlvs[k++], &tlv_value, sizeof(tlv_value), true);
+/**
+ * Add a precalculated address and its address TLVs to the stream
+ * @param writer RFC5444 writer instance
+ * @param prv RFC5444 content provider instance
+ * @param cached cached Hello address
+ */
+static void
+_add_hello_address(struct rfc5444_writer *writer, struct rfc5444_writer_content_provider *prv,
+  struct _hello_address *cached) {
+  struct rfc5444_writer_address *address;
+  struct nhdp_domain *domain;
+  struct netaddr_str buf;
+  uint8_t i;
+
+  /* generate RFC5444 address */
+  address = rfc5444_writer_add_address(writer, prv->creator, &cached->addr, cached->localif != HELLO_NO_TLV);
+  if (address == NULL) {
+    OONF_WARN(LOG_NHDP_W, "Could not add address %s to NHDP hello", netaddr_to_string(&buf, &cached->addr));
+    return;
+  }
+
+  if (cached->localif != HELLO_NO_TLV) {
+    /* Add LOCALIF TLV */
+    rfc5444_writer_add_addrtlv(
+      writer, address, &_nhdp_addrtlvs[IDX_ADDRTLV_LOCAL_IF], &cached->localif, sizeof(cached->localif), true);
+    return;
+  }
+
+  if (cached->linkstatus != HELLO_NO_TLV) {
+    rfc5444_writer_add_addrtlv(writer, address, &_nhdp_addrtlvs[IDX_ADDRTLV_LINK_STATUS], &cached->linkstatus,
+      sizeof(cached->linkstatus), false);
+  }
+
+  rfc5444_writer_add_addrtlv(writer, address, &_nhdp_addrtlvs[IDX_ADDRTLV_OTHER_NEIGHB], &cached->otherneigh,
+    sizeof(cached->otherneigh), false);
+
+  /* add MPR tlvs */
+  if (cached->mpr_len) {
+    rfc5444_writer_add_addrtlv(
+      writer, address, &_nhdp_addrtlvs[IDX_ADDRTLV_MPR], cached->mpr, cached->mpr_len, false);
+  }
+
+  /* add linkcost TLVs */
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    for (i = 0; i < cached->metric_count[domain->index]; i++) {
+      rfc5444_writer_add_addrtlv(writer, address, &domain->_metric_addrtlvs[i], &cached->metric[domain->index][i],
+        sizeof(cached->metric[0][0]), true);
+    }
   }
 }
+
 /**
  * Callback to add the addresses and address TLVs to a HELLO message
  * @param writer RFC5444 writer instance
@@ -518,29 +702,19 @@ _write_metric_tlv(struct rfc5444_writer *writer, struct rfc5444_writer_address *
 void
 _cb_addAddresses(struct rfc5444_writer *writer) {
   struct oonf_rfc5444_target *target;
-
   struct nhdp_interface *interf;
-  struct nhdp_interface_addr *addr;
-  struct nhdp_naddr *naddr;
+  struct _hello_cache *cache;
+  size_t i;
+  int af;
 
   /* have already be checked for message TLVs, so they cannot be NULL */
   target = oonf_rfc5444_get_target_from_writer(writer);
   interf = nhdp_interface_get(target->interface->name);
 
-  /* transmit interface addresses first */
-  avl_for_each_element(nhdp_interface_get_address_tree(), addr, _global_node) {
-    if (addr->removed) {
-      continue;
-    }
-    if (netaddr_get_address_family(&addr->if_addr) == netaddr_get_address_family(&target->dst)) {
-      _add_localif_address(writer, &_nhdp_msgcontent_provider, interf, addr);
-    }
-  }
+  cache = _get_hello_cache(interf);
+  af = netaddr_get_address_family(&target->dst) == AF_INET ? 0 : 1;
 
-  /* then transmit neighbor addresses */
-  avl_for_each_element(nhdp_db_get_naddr_tree(), naddr, _global_node) {
-    if (netaddr_get_address_family(&naddr->neigh_addr) == netaddr_get_address_family(&target->dst)) {
-      _add_link_address(writer, &_nhdp_msgcontent_provider, interf, naddr);
-    }
+  for (i = 0; i < cache->addr_count[af]; i++) {
+    _add_hello_address(writer, &_nhdp_msgcontent_provider, &cache->addr[af][i]);
   }
 }
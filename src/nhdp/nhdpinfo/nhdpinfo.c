@@ -80,6 +80,7 @@ static void _initialize_nhdp_link_address_values(struct nhdp_laddr *laddr);
 static void _initialize_nhdp_link_twohop_values(struct nhdp_l2hop *twohop);
 static void _initialize_nhdp_neighbor_values(struct nhdp_neighbor *neigh);
 static void _initialize_nhdp_neighbor_address_values(struct nhdp_naddr *naddr);
+static void _initialize_nhdp_domain_values(const struct nhdp_domain *domain, bool flooding);
 
 static int _cb_create_text_interface(struct oonf_viewer_template *);
 static int _cb_create_text_if_address(struct oonf_viewer_template *);
@@ -88,6 +89,7 @@ static int _cb_create_text_link_address(struct oonf_viewer_template *);
 static int _cb_create_text_link_twohop(struct oonf_viewer_template *);
 static int _cb_create_text_neighbor(struct oonf_viewer_template *);
 static int _cb_create_text_neighbor_address(struct oonf_viewer_template *);
+static int _cb_create_text_domain(struct oonf_viewer_template *);
 
 /*
  * list of template keys and corresponding buffers for values.
@@ -227,6 +229,15 @@ static int _cb_create_text_neighbor_address(struct oonf_viewer_template *);
 /*! template key for routing willingness */
 #define KEY_DOMAIN_MPR_WILL "domain_mpr_willingness"
 
+/*! template key for flooding domain flag */
+#define KEY_DOMAIN_FLOODING "domain_flooding"
+
+/*! template key for number of requested MPR recalculations */
+#define KEY_DOMAIN_MPR_REQUESTED "domain_mpr_requested"
+
+/*! template key for number of executed MPR calculations */
+#define KEY_DOMAIN_MPR_CALCULATED "domain_mpr_calculated"
+
 /*
  * buffer space for values that will be assembled
  * into the output of the plugin
@@ -280,6 +291,9 @@ static char _value_domain_mpr[NHDP_DOMAIN_MPR_MAXLEN];
 static char _value_domain_mpr_local[TEMPLATE_JSON_BOOL_LENGTH];
 static char _value_domain_mpr_remote[TEMPLATE_JSON_BOOL_LENGTH];
 static char _value_domain_mpr_will[3];
+static char _value_domain_flooding[TEMPLATE_JSON_BOOL_LENGTH];
+static char _value_domain_mpr_requested[12];
+static char _value_domain_mpr_calculated[12];
 
 /* definition of the template data entries for JSON and table output */
 static struct abuf_template_data_entry _tde_if_key[] = {
@@ -346,6 +360,14 @@ static struct abuf_template_data_entry _tde_domain_mpr[] = {
   { KEY_DOMAIN_MPR_WILL, _value_domain_mpr_will, false },
 };
 
+static struct abuf_template_data_entry _tde_domain_stats[] = {
+  { KEY_DOMAIN_FLOODING, _value_domain_flooding, true },
+  { KEY_DOMAIN_METRIC, _value_domain_metric, true },
+  { KEY_DOMAIN_MPR, _value_domain_mpr, true },
+  { KEY_DOMAIN_MPR_REQUESTED, _value_domain_mpr_requested, false },
+  { KEY_DOMAIN_MPR_CALCULATED, _value_domain_mpr_calculated, false },
+};
+
 static struct abuf_template_data_entry _tde_link_addr[] = {
   { KEY_LINK_ADDRESS, _value_link_address.buf, true },
 };
@@ -411,6 +433,10 @@ static struct abuf_template_data _td_neigh_addr[] = {
   { _tde_neigh_key, ARRAYSIZE(_tde_neigh_key) },
   { _tde_neigh_addr, ARRAYSIZE(_tde_neigh_addr) },
 };
+static struct abuf_template_data _td_domain[] = {
+  { _tde_domain, ARRAYSIZE(_tde_domain) },
+  { _tde_domain_stats, ARRAYSIZE(_tde_domain_stats) },
+};
 
 /* OONF viewer templates (based on Template Data arrays) */
 static struct oonf_viewer_template _templates[] = { {
@@ -454,6 +480,12 @@ static struct oonf_viewer_template _templates[] = { {
     .data_size = ARRAYSIZE(_td_neigh_addr),
     .json_name = "neighbor_addr",
     .cb_function = _cb_create_text_neighbor_address,
+  },
+  {
+    .data = _td_domain,
+    .data_size = ARRAYSIZE(_td_domain),
+    .json_name = "domain",
+    .cb_function = _cb_create_text_domain,
   } };
 
 /* telnet command of this plugin */
@@ -632,6 +664,22 @@ _initialize_nhdp_neighbor_mpr_values(struct nhdp_domain *domain, struct nhdp_nei
   snprintf(_value_domain_mpr_will, sizeof(_value_domain_mpr_will), "%1u", domaindata->willingness & 15);
 }
 
+/**
+ * Initialize the value buffers for a NHDP domain
+ * @param domain NHDP domain
+ * @param flooding true if domain is the flooding domain
+ */
+static void
+_initialize_nhdp_domain_values(const struct nhdp_domain *domain, bool flooding) {
+  snprintf(_value_domain, sizeof(_value_domain), "%u", domain->ext);
+  strscpy(_value_domain_flooding, json_getbool(flooding), sizeof(_value_domain_flooding));
+  strscpy(_value_domain_metric, domain->metric->name, sizeof(_value_domain_metric));
+  strscpy(_value_domain_mpr, domain->mpr->name, sizeof(_value_domain_mpr));
+
+  snprintf(_value_domain_mpr_requested, sizeof(_value_domain_mpr_requested), "%u", domain->mpr_requested);
+  snprintf(_value_domain_mpr_calculated, sizeof(_value_domain_mpr_calculated), "%u", domain->mpr_calculated);
+}
+
 static void
 _initialize_nhdp_domain_metric_int_values(struct nhdp_domain *domain, struct nhdp_link *lnk) {
   nhdp_domain_get_internal_link_metric_value(&_value_domain_metric_internal, domain->metric, lnk);
@@ -880,3 +928,24 @@ _cb_create_text_neighbor_address(struct oonf_viewer_template *template) {
   }
   return 0;
 }
+
+/**
+ * Displays the NHDP domains and their MPR calculation statistics.
+ * @param template oonf viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_domain(struct oonf_viewer_template *template) {
+  struct nhdp_domain *domain;
+
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    _initialize_nhdp_domain_values(domain, false);
+
+    /* generate template output */
+    oonf_viewer_output_print_line(template);
+  }
+
+  _initialize_nhdp_domain_values(nhdp_domain_get_flooding_domain(), true);
+  oonf_viewer_output_print_line(template);
+  return 0;
+}
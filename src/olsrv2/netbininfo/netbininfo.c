@@ -0,0 +1,689 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+
+/**
+ * @file
+ */
+
+#include <arpa/inet.h>
+
+#include <oonf/libcommon/autobuf.h>
+#include <oonf/libcommon/avl.h>
+#include <oonf/oonf.h>
+#include <oonf/libconfig/cfg_schema.h>
+#include <oonf/libcore/oonf_logging.h>
+#include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/libcore/os_core.h>
+#include <oonf/base/oonf_class.h>
+#include <oonf/base/oonf_clock.h>
+#include <oonf/base/oonf_telnet.h>
+
+#include <oonf/nhdp/nhdp/nhdp.h>
+#include <oonf/nhdp/nhdp/nhdp_db.h>
+#include <oonf/nhdp/nhdp/nhdp_domain.h>
+#include <oonf/nhdp/nhdp/nhdp_interfaces.h>
+#include <oonf/olsrv2/olsrv2/olsrv2.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_routing.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_tc.h>
+
+#include <oonf/olsrv2/netbininfo/netbininfo.h>
+
+/* definitions */
+#define LOG_NETBININFO _olsrv2_netbininfo_subsystem.logging
+
+/*! name of delta parameter */
+#define NETBININFO_PARAM_DELTA "delta"
+
+enum
+{
+  /*! maximum length of a record value */
+  NETBININFO_RECORD_MAXLEN = 256,
+};
+
+/**
+ * Configuration of netbininfo plugin
+ */
+struct _config {
+  /*! time a removed record is kept for delta snapshots */
+  uint64_t tombstone_time;
+};
+
+/**
+ * Exported topology record
+ */
+struct _netbin_record {
+  /*! record type */
+  uint8_t type;
+
+  /*! true if record has been removed */
+  bool removed;
+
+  /*! true if record was found during the current synchronization */
+  bool seen;
+
+  /*! number of bytes of the value that are used as the record key */
+  uint16_t key_length;
+
+  /*! length of the record value */
+  uint16_t length;
+
+  /*! generation of the last change of the record */
+  uint32_t generation;
+
+  /*! absolute timestamp when a removed record will be purged */
+  uint64_t purge_time;
+
+  /*! record value (key followed by data) */
+  uint8_t value[NETBININFO_RECORD_MAXLEN];
+
+  /*! node for tree of records */
+  struct avl_node _node;
+};
+
+/* prototypes */
+static int _init(void);
+static void _cleanup(void);
+
+static void _sync_records(void);
+static void _sync_node(struct olsrv2_tc_node *node);
+static void _sync_edge(struct olsrv2_tc_edge *edge);
+static void _sync_attachment(struct olsrv2_tc_attachment *attached);
+static void _sync_route(struct nhdp_domain *domain, struct olsrv2_routing_entry *rtentry);
+static void _sync_nhdp_link(struct nhdp_link *lnk);
+static void _update_record(struct _netbin_record *record);
+static void _remove_record(struct _netbin_record *record);
+
+static void _record_init(struct _netbin_record *record, uint8_t type);
+static void _record_end_key(struct _netbin_record *record);
+static void _record_put_u8(struct _netbin_record *record, uint8_t value);
+static void _record_put_u16(struct _netbin_record *record, uint16_t value);
+static void _record_put_u32(struct _netbin_record *record, uint32_t value);
+static void _record_put_netaddr(struct _netbin_record *record, const struct netaddr *addr);
+
+static void _print_snapshot(struct autobuf *out, uint32_t base);
+static int _avl_comp_record(const void *k1, const void *k2);
+
+static enum oonf_telnet_result _cb_netbininfo(struct oonf_telnet_data *con);
+static void _cb_cfg_changed(void);
+
+/* configuration */
+static struct _config _config;
+
+static struct cfg_schema_entry _netbininfo_entries[] = {
+  CFG_MAP_CLOCK_MIN(_config, tombstone_time, "tombstone_time", "60.0",
+    "Time a removed topology record is kept to answer delta requests", 1000),
+};
+
+static struct cfg_schema_section _netbininfo_section = {
+  .type = OONF_NETBININFO_SUBSYSTEM,
+  .cb_delta_handler = _cb_cfg_changed,
+  .entries = _netbininfo_entries,
+  .entry_count = ARRAYSIZE(_netbininfo_entries),
+};
+
+/* telnet command of this plugin */
+static struct oonf_telnet_command _telnet_commands[] = {
+  TELNET_CMD(OONF_NETBININFO_SUBSYSTEM, _cb_netbininfo,
+    "The command returns a binary snapshot of the OLSRv2 topology (nodes, edges,"
+    " attached networks, routes and NHDP links).\n"
+    "> netbininfo\n"
+    "The 'delta' parameter only returns the records that changed after the"
+    " generation of an earlier snapshot of the same router instance (both"
+    " taken from the header of the earlier snapshot). If the instance id"
+    " does not match or the router cannot generate a complete delta, it"
+    " returns a full snapshot.\n"
+    "> netbininfo delta <instance id> <generation>\n"),
+};
+
+/* plugin declaration */
+static const char *_dependencies[] = {
+  OONF_CLASS_SUBSYSTEM,
+  OONF_CLOCK_SUBSYSTEM,
+  OONF_NHDP_SUBSYSTEM,
+  OONF_OLSRV2_SUBSYSTEM,
+  OONF_TELNET_SUBSYSTEM,
+};
+static struct oonf_subsystem _olsrv2_netbininfo_subsystem = {
+  .name = OONF_NETBININFO_SUBSYSTEM,
+  .dependencies = _dependencies,
+  .dependencies_count = ARRAYSIZE(_dependencies),
+  .descr = "OLSRv2 binary topology snapshot plugin",
+  .author = "Henning Rogge",
+
+  .cfg_section = &_netbininfo_section,
+
+  .init = _init,
+  .cleanup = _cleanup,
+};
+DECLARE_OONF_PLUGIN(_olsrv2_netbininfo_subsystem);
+
+/* memory class for records */
+static struct oonf_class _record_class = {
+  .name = "netbininfo record",
+  .size = sizeof(struct _netbin_record),
+};
+
+/* tree of all exported records */
+static struct avl_tree _record_tree;
+
+/* random id of this router instance */
+static uint32_t _instance_id;
+
+/* generation of the last change of the records */
+static uint32_t _generation;
+
+/* oldest base generation a complete delta can be generated for */
+static uint32_t _delta_horizon;
+
+/**
+ * Initialize plugin
+ * @return always returns 0
+ */
+static int
+_init(void) {
+  if (os_core_get_random(&_instance_id, sizeof(_instance_id))) {
+    _instance_id = (uint32_t)oonf_clock_getNow();
+  }
+  _generation = 0;
+  _delta_horizon = 0;
+
+  oonf_class_add(&_record_class);
+  avl_init(&_record_tree, _avl_comp_record, false);
+  oonf_telnet_add(&_telnet_commands[0]);
+  return 0;
+}
+
+/**
+ * Cleanup plugin
+ */
+static void
+_cleanup(void) {
+  struct _netbin_record *record, *record_it;
+
+  oonf_telnet_remove(&_telnet_commands[0]);
+
+  avl_for_each_element_safe(&_record_tree, record, _node, record_it) {
+    avl_remove(&_record_tree, &record->_node);
+    oonf_class_free(&_record_class, record);
+  }
+  oonf_class_remove(&_record_class);
+}
+
+/**
+ * Callback for netbininfo telnet command
+ * @param con telnet connection
+ * @return active or internal_error
+ */
+static enum oonf_telnet_result
+_cb_netbininfo(struct oonf_telnet_data *con) {
+  const char *next;
+  char *end;
+  unsigned long instance, base;
+
+  instance = _instance_id;
+  base = 0;
+  if (con->parameter && *con->parameter) {
+    end = NULL;
+    next = str_hasnextword(con->parameter, NETBININFO_PARAM_DELTA);
+    if (next != NULL && *next != 0) {
+      instance = strtoul(next, &end, 10);
+      if (*end == ' ') {
+        base = strtoul(end + 1, &end, 10);
+      }
+      else {
+        /* generation is missing */
+        end = NULL;
+      }
+    }
+    if (end == NULL || *end != 0 || instance > UINT32_MAX || base > UINT32_MAX) {
+      abuf_appendf(con->out, "Unknown parameter for command '%s': %s\n", con->command, con->parameter);
+      return TELNET_RESULT_ACTIVE;
+    }
+  }
+
+  _sync_records();
+
+  if (instance != _instance_id || base < _delta_horizon || base > _generation) {
+    /*
+     * the base generation belongs to another instance of the router or
+     * we cannot generate a complete delta, fall back to full snapshot
+     */
+    base = 0;
+  }
+
+  _print_snapshot(con->out, base);
+  return abuf_has_failed(con->out) ? TELNET_RESULT_INTERNAL_ERROR : TELNET_RESULT_ACTIVE;
+}
+
+/**
+ * Update the record database with the current topology
+ */
+static void
+_sync_records(void) {
+  struct _netbin_record *record, *record_it;
+  struct olsrv2_tc_node *node;
+  struct olsrv2_tc_edge *edge;
+  struct olsrv2_tc_attachment *attached;
+  struct olsrv2_routing_entry *rtentry;
+  struct nhdp_domain *domain;
+  struct nhdp_link *lnk;
+
+  avl_for_each_element(&_record_tree, record, _node) {
+    record->seen = false;
+  }
+
+  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
+    _sync_node(node);
+
+    avl_for_each_element(&node->_edges, edge, _node) {
+      _sync_edge(edge);
+    }
+    avl_for_each_element(&node->_attached_networks, attached, _src_node) {
+      _sync_attachment(attached);
+    }
+  }
+
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    avl_for_each_element(olsrv2_routing_get_tree(domain), rtentry, _node) {
+      _sync_route(domain, rtentry);
+    }
+  }
+
+  list_for_each_element(nhdp_db_get_link_list(), lnk, _global_node) {
+    _sync_nhdp_link(lnk);
+  }
+
+  avl_for_each_element_safe(&_record_tree, record, _node, record_it) {
+    if (!record->removed && !record->seen) {
+      _remove_record(record);
+    }
+    else if (record->removed && oonf_clock_is_past(record->purge_time)) {
+      /* deltas older than this record cannot be generated anymore */
+      if (record->generation > _delta_horizon) {
+        _delta_horizon = record->generation;
+      }
+      avl_remove(&_record_tree, &record->_node);
+      oonf_class_free(&_record_class, record);
+    }
+  }
+}
+
+/**
+ * Synchronize the record of an OLSRv2 node
+ * @param node OLSRv2 node
+ */
+static void
+_sync_node(struct olsrv2_tc_node *node) {
+  struct _netbin_record record;
+
+  _record_init(&record, NETBININFO_RECORD_NODE);
+  _record_put_netaddr(&record, &node->target.prefix.dst);
+  _record_end_key(&record);
+
+  _record_put_u16(&record, node->ansn);
+  _record_put_u8(&record, olsrv2_tc_is_node_virtual(node) ? 1 : 0);
+
+  _update_record(&record);
+}
+
+/**
+ * Synchronize the record of an OLSRv2 edge
+ * @param edge OLSRv2 edge
+ */
+static void
+_sync_edge(struct olsrv2_tc_edge *edge) {
+  struct _netbin_record record;
+  struct nhdp_domain *domain;
+
+  if (edge->virtual) {
+    return;
+  }
+
+  _record_init(&record, NETBININFO_RECORD_EDGE);
+  _record_put_netaddr(&record, &edge->src->target.prefix.dst);
+  _record_put_netaddr(&record, &edge->dst->target.prefix.dst);
+  _record_end_key(&record);
+
+  _record_put_u8(&record, nhdp_domain_get_count());
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    _record_put_u8(&record, domain->ext);
+    _record_put_u32(&record, edge->cost[domain->index]);
+    _record_put_u32(&record, edge->inverse->cost[domain->index]);
+  }
+
+  _update_record(&record);
+}
+
+/**
+ * Synchronize the record of an OLSRv2 attached network
+ * @param attached OLSRv2 attached network
+ */
+static void
+_sync_attachment(struct olsrv2_tc_attachment *attached) {
+  struct _netbin_record record;
+  struct nhdp_domain *domain;
+
+  _record_init(&record, NETBININFO_RECORD_ATTACHED);
+  _record_put_netaddr(&record, &attached->src->target.prefix.dst);
+  _record_put_netaddr(&record, &attached->dst->target.prefix.dst);
+  _record_put_netaddr(&record, &attached->dst->target.prefix.src);
+  _record_end_key(&record);
+
+  _record_put_u8(&record, nhdp_domain_get_count());
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    _record_put_u8(&record, domain->ext);
+    _record_put_u32(&record, attached->cost[domain->index]);
+    _record_put_u8(&record, attached->distance[domain->index]);
+  }
+
+  _update_record(&record);
+}
+
+/**
+ * Synchronize the record of an OLSRv2 routing entry
+ * @param domain NHDP domain of the routing entry
+ * @param rtentry OLSRv2 routing entry
+ */
+static void
+_sync_route(struct nhdp_domain *domain, struct olsrv2_routing_entry *rtentry) {
+  struct _netbin_record record;
+
+  _record_init(&record, NETBININFO_RECORD_ROUTE);
+  _record_put_u8(&record, domain->ext);
+  _record_put_netaddr(&record, &rtentry->route.p.key.dst);
+  _record_put_netaddr(&record, &rtentry->route.p.key.src);
+  _record_end_key(&record);
+
+  _record_put_netaddr(&record, &rtentry->route.p.gw);
+  _record_put_u32(&record, rtentry->route.p.if_index);
+  _record_put_netaddr(&record, &rtentry->originator);
+  _record_put_netaddr(&record, &rtentry->next_originator);
+  _record_put_netaddr(&record, &rtentry->last_originator);
+  _record_put_u32(&record, rtentry->path_cost);
+  _record_put_u8(&record, rtentry->path_hops);
+
+  _update_record(&record);
+}
+
+/**
+ * Synchronize the record of a NHDP link
+ * @param lnk NHDP link
+ */
+static void
+_sync_nhdp_link(struct nhdp_link *lnk) {
+  struct _netbin_record record;
+  struct nhdp_domain *domain;
+  struct nhdp_link_domaindata *ldata;
+
+  _record_init(&record, NETBININFO_RECORD_NHDP_LINK);
+  _record_put_u32(&record, nhdp_interface_get_if_listener(lnk->local_if)->data->index);
+  _record_put_netaddr(&record, &lnk->neigh->originator);
+  _record_put_netaddr(&record, &lnk->remote_mac);
+  _record_end_key(&record);
+
+  _record_put_u8(&record, (uint8_t)((int8_t)lnk->status));
+  _record_put_u8(&record, nhdp_domain_get_count());
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    ldata = nhdp_domain_get_linkdata(domain, lnk);
+
+    _record_put_u8(&record, domain->ext);
+    _record_put_u32(&record, ldata->metric.in);
+    _record_put_u32(&record, ldata->metric.out);
+  }
+
+  _update_record(&record);
+}
+
+/**
+ * Store a generated record in the record database and update its
+ * generation if its value changed
+ * @param record generated record
+ */
+static void
+_update_record(struct _netbin_record *record) {
+  struct _netbin_record *stored;
+
+  stored = avl_find_element(&_record_tree, record, stored, _node);
+  if (stored) {
+    if (stored->seen) {
+      /* duplicate key, keep the first one */
+      return;
+    }
+    stored->seen = true;
+
+    if (!stored->removed && stored->length == record->length
+        && memcmp(stored->value, record->value, record->length) == 0) {
+      /* unchanged */
+      return;
+    }
+  }
+  else {
+    stored = oonf_class_malloc(&_record_class);
+    if (!stored) {
+      OONF_WARN(LOG_NETBININFO, "Out of memory for topology record");
+      return;
+    }
+
+    stored->type = record->type;
+    stored->key_length = record->key_length;
+    memcpy(stored->value, record->value, record->key_length);
+    stored->_node.key = stored;
+    avl_insert(&_record_tree, &stored->_node);
+
+    stored->seen = true;
+  }
+
+  stored->removed = false;
+  stored->length = record->length;
+  memcpy(stored->value, record->value, record->length);
+  stored->generation = ++_generation;
+}
+
+/**
+ * Mark a record as removed, it will stay in the database as
+ * a tombstone for delta snapshots
+ * @param record stored record
+ */
+static void
+_remove_record(struct _netbin_record *record) {
+  record->removed = true;
+  record->length = record->key_length;
+  record->generation = ++_generation;
+  record->purge_time = oonf_clock_get_absolute(_config.tombstone_time);
+}
+
+/**
+ * Initialize a record for generation
+ * @param record record
+ * @param type record type
+ */
+static void
+_record_init(struct _netbin_record *record, uint8_t type) {
+  record->type = type;
+  record->length = 0;
+  record->key_length = 0;
+}
+
+/**
+ * Mark the current record value as the key of the record
+ * @param record record
+ */
+static void
+_record_end_key(struct _netbin_record *record) {
+  record->key_length = record->length;
+}
+
+/**
+ * Append an 8 bit value to a record
+ * @param record record
+ * @param value value
+ */
+static void
+_record_put_u8(struct _netbin_record *record, uint8_t value) {
+  record->value[record->length++] = value;
+}
+
+/**
+ * Append a 16 bit value in network byte order to a record
+ * @param record record
+ * @param value value
+ */
+static void
+_record_put_u16(struct _netbin_record *record, uint16_t value) {
+  value = htons(value);
+  memcpy(&record->value[record->length], &value, sizeof(value));
+  record->length += sizeof(value);
+}
+
+/**
+ * Append a 32 bit value in network byte order to a record
+ * @param record record
+ * @param value value
+ */
+static void
+_record_put_u32(struct _netbin_record *record, uint32_t value) {
+  value = htonl(value);
+  memcpy(&record->value[record->length], &value, sizeof(value));
+  record->length += sizeof(value);
+}
+
+/**
+ * Append an encoded address to a record
+ * @param record record
+ * @param addr address
+ */
+static void
+_record_put_netaddr(struct _netbin_record *record, const struct netaddr *addr) {
+  switch (netaddr_get_address_family(addr)) {
+    case AF_INET:
+      _record_put_u8(record, NETBININFO_AF_IPV4);
+      break;
+    case AF_INET6:
+      _record_put_u8(record, NETBININFO_AF_IPV6);
+      break;
+    case AF_MAC48:
+      _record_put_u8(record, NETBININFO_AF_MAC48);
+      break;
+    default:
+      _record_put_u8(record, NETBININFO_AF_UNSPEC);
+      _record_put_u8(record, 0);
+      return;
+  }
+
+  _record_put_u8(record, netaddr_get_prefix_length(addr));
+  memcpy(&record->value[record->length], netaddr_get_binptr(addr), netaddr_get_binlength(addr));
+  record->length += netaddr_get_binlength(addr);
+}
+
+/**
+ * Print a binary snapshot of the record database
+ * @param out output buffer
+ * @param base base generation for delta snapshot, 0 for full snapshot
+ */
+static void
+_print_snapshot(struct autobuf *out, uint32_t base) {
+  struct _netbin_record *record;
+  uint8_t header[NETBININFO_HEADER_LENGTH];
+  uint32_t u32;
+  uint16_t u16;
+
+  memset(header, 0, sizeof(header));
+  header[0] = NETBININFO_SCHEMA_VERSION;
+  header[1] = base > 0 ? NETBININFO_SNAPSHOT_DELTA : 0;
+
+  u32 = htonl(_instance_id);
+  memcpy(&header[4], &u32, sizeof(u32));
+  u32 = htonl(_generation);
+  memcpy(&header[8], &u32, sizeof(u32));
+  u32 = htonl(base);
+  memcpy(&header[12], &u32, sizeof(u32));
+
+  abuf_memcpy(out, header, sizeof(header));
+
+  avl_for_each_element(&_record_tree, record, _node) {
+    if (base == 0 && record->removed) {
+      /* full snapshot does not need tombstones */
+      continue;
+    }
+    if (record->generation <= base) {
+      continue;
+    }
+
+    abuf_append_uint8(out, record->type);
+    abuf_append_uint8(out, record->removed ? NETBININFO_RECORD_REMOVED : 0);
+    u16 = htons(record->length);
+    abuf_memcpy(out, &u16, sizeof(u16));
+    abuf_memcpy(out, record->value, record->length);
+  }
+}
+
+/**
+ * AVL comparator for records, compares type and key of the record
+ * @param k1 first record
+ * @param k2 second record
+ * @return +1 if k1>k2, -1 if k1<k2, 0 if k1==k2
+ */
+static int
+_avl_comp_record(const void *k1, const void *k2) {
+  const struct _netbin_record *r1 = k1, *r2 = k2;
+  int result;
+
+  if (r1->type != r2->type) {
+    return r1->type > r2->type ? 1 : -1;
+  }
+  if (r1->key_length != r2->key_length) {
+    return r1->key_length > r2->key_length ? 1 : -1;
+  }
+
+  result = memcmp(r1->value, r2->value, r1->key_length);
+  return result > 0 ? 1 : (result < 0 ? -1 : 0);
+}
+
+/**
+ * Callback for configuration changes
+ */
+static void
+_cb_cfg_changed(void) {
+  if (cfg_schema_tobin(&_config, _netbininfo_section.post, _netbininfo_entries, ARRAYSIZE(_netbininfo_entries))) {
+    OONF_WARN(LOG_NETBININFO, "Cannot convert configuration for " OONF_NETBININFO_SUBSYSTEM);
+  }
+}
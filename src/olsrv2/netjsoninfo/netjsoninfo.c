@@ -49,8 +49,11 @@
 
 #include <oonf/libcore/oonf_logging.h>
 #include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_class.h>
 #include <oonf/base/oonf_clock.h>
+#include <oonf/base/oonf_layer2.h>
 #include <oonf/base/oonf_telnet.h>
+#include <oonf/base/oonf_viewer.h>
 
 #include <oonf/nhdp/nhdp/nhdp.h>
 #include <oonf/nhdp/nhdp/nhdp_db.h>
@@ -129,23 +132,237 @@ enum netjson_edge_type
   NETJSON_EDGE_ATTACHED,
 };
 
+/*! netjson objects that are generated in multiple chunks */
+enum _netjson_object
+{
+  /*! no object in progress */
+  NETJSON_OBJECT_NONE,
+
+  /*! NetworkGraph objects */
+  NETJSON_OBJECT_GRAPH,
+
+  /*! NetworkRoutes objects */
+  NETJSON_OBJECT_ROUTE,
+};
+
+/*! generation phase of a streamed netjson object */
+enum _netjson_phase
+{
+  /*! head of the object */
+  NETJSON_PHASE_START,
+
+  /*! router nodes of a graph */
+  NETJSON_PHASE_NODES,
+
+  /*! links between routers of a graph */
+  NETJSON_PHASE_EDGES,
+
+  /*! links to attached networks of a graph */
+  NETJSON_PHASE_ATTACHED,
+
+  /*! entries of a routing tree */
+  NETJSON_PHASE_ROUTES,
+};
+
+/**
+ * State of a netjsoninfo command that generates its output in chunks
+ */
+struct _netjson_stream {
+  /*! json session for output */
+  struct json_session session;
+
+  /*! copy of the telnet parameter */
+  char *parameter;
+
+  /*! next object to parse in parameter */
+  const char *next;
+
+  /*! true if a single filtered object is generated */
+  bool filter;
+
+  /*! true if a parameter could not be parsed */
+  bool error;
+
+  /*! object currently generated */
+  enum _netjson_object object;
+
+  /*! domain id to generate, NULL for all domains */
+  const char *domain_filter;
+
+  /*! index of the domain currently generated */
+  int32_t domain_index;
+
+  /*! address family currently generated */
+  int af_type;
+
+  /*! generation phase of the current object */
+  enum _netjson_phase phase;
+
+  /*! position inside the current phase */
+  struct oonf_viewer_cursor cursor;
+
+  /*! length of output buffer at start of the current chunk */
+  size_t chunk_start;
+};
+
+/**
+ * Serialized JSON text of a netjson object, generated by a separate
+ * json session so it can be spliced into any output
+ */
+struct _netjson_fragment {
+  /*! JSON text, NULL if fragment is empty */
+  char *text;
+
+  /*! length of JSON text */
+  size_t length;
+
+  /*! generation of the object the fragment was generated for */
+  uint32_t generation;
+
+  /*! true if the fragment has been generated */
+  bool valid;
+};
+
+/**
+ * Fragment cache of a TC node
+ */
+struct _netjson_tc_node_cache {
+  /*! generation counter, incremented on every change of the node */
+  uint32_t generation;
+
+  /*! generation counter, incremented on every change of a node with an edge to this node */
+  uint32_t edge_generation;
+
+  /*! generation counters, incremented on changes of routes that start or end at this node */
+  uint32_t route_generation[NHDP_MAXIMUM_DOMAINS];
+
+  /*! dualstack partner used for the cached node object */
+  struct netaddr dualstack;
+
+  /*! graph node objects of the node and its attached networks */
+  struct _netjson_fragment nodes;
+
+  /*! graph edge objects to the neighbors of the node for each domain */
+  struct _netjson_fragment edges[NHDP_MAXIMUM_DOMAINS];
+
+  /*! graph edge objects to the attached networks of the node for each domain */
+  struct _netjson_fragment attachments[NHDP_MAXIMUM_DOMAINS];
+};
+
+/**
+ * Values of a routing entry used for its JSON route object
+ */
+struct _netjson_route_state {
+  /*! gateway of route */
+  struct netaddr gw;
+
+  /*! originator of the destination */
+  struct netaddr originator;
+
+  /*! originator of the next hop */
+  struct netaddr next_originator;
+
+  /*! originator of the last hop */
+  struct netaddr last_originator;
+
+  /*! outgoing interface index */
+  unsigned int if_index;
+
+  /*! path cost */
+  uint32_t path_cost;
+
+  /*! path hopcount */
+  uint8_t path_hops;
+};
+
+/**
+ * Fragment cache of a routing entry
+ */
+struct _netjson_route_cache {
+  /*! generation counter, incremented on every change of the route */
+  uint32_t generation;
+
+  /*! route values used for the cached route object */
+  struct _netjson_route_state state;
+
+  /*! originator of the route used for the graph edge fragments */
+  struct netaddr graph_originator;
+
+  /*! last originator of the route used for the graph edge fragments */
+  struct netaddr graph_last_originator;
+
+  /*! JSON route object */
+  struct _netjson_fragment route;
+};
+
+/**
+ * Fragment cache of a layer2 neighbor
+ */
+struct _netjson_l2neigh_cache {
+  /*! generation counter, incremented on every change of the neighbor */
+  uint32_t generation;
+
+  /*! JSON keys in front of the 'last_seen' key */
+  struct _netjson_fragment head;
+
+  /*! JSON 'neighbor_data' object */
+  struct _netjson_fragment data;
+};
+
 /* prototypes */
 static int _init(void);
 static void _cleanup(void);
 
-static void _print_graph(struct json_session *session, struct nhdp_domain *domain, int af_type);
-static void _create_graph_json(struct json_session *session, const char *filter);
-static void _print_routing_tree(struct json_session *session, struct nhdp_domain *domain, int af_type);
-static void _create_route_json(struct json_session *session, const char *filter);
+static bool _print_graph_head(struct json_session *session, struct nhdp_domain *domain, int af_type);
+static void _print_graph_tc_node(struct json_session *session, struct olsrv2_tc_node *node, int af_type);
+static void _print_graph_local_links(struct json_session *session, struct nhdp_domain *domain, int af_type);
+static void _print_graph_tc_edge_objects(
+  struct json_session *session, struct nhdp_domain *domain, struct olsrv2_tc_node *node);
+static void _print_graph_tc_edges(
+  struct json_session *session, struct nhdp_domain *domain, struct olsrv2_tc_node *node, int af_type);
+static void _print_graph_tc_attachment_objects(
+  struct json_session *session, struct nhdp_domain *domain, struct olsrv2_tc_node *node);
+static void _print_graph_tc_attachments(
+  struct json_session *session, struct nhdp_domain *domain, struct olsrv2_tc_node *node, int af_type);
+static bool _stream_graph(struct _netjson_stream *stream, struct nhdp_domain *domain);
+static bool _print_routing_tree_head(struct json_session *session, struct nhdp_domain *domain, int af_type);
+static void _print_routing_entry(
+  struct json_session *session, struct nhdp_domain *domain, struct olsrv2_routing_entry *rtentry);
+static bool _stream_routing_tree(struct _netjson_stream *stream, struct nhdp_domain *domain);
+static bool _stream_domain_objects(struct _netjson_stream *stream);
+static struct olsrv2_tc_node *_get_stream_tc_node(struct _netjson_stream *stream);
+static void _set_stream_phase(struct _netjson_stream *stream, enum _netjson_phase phase);
+static bool _is_chunk_full(struct _netjson_stream *stream);
+static const char *_handle_netjson_object(struct _netjson_stream *stream, const char *parameter);
+static void _start_domain_objects(struct _netjson_stream *stream, enum _netjson_object object, const char *filter);
 static void _create_domain_json(struct json_session *session);
 static void _create_id_json(struct json_session *session);
 static void _create_error_json(struct json_session *session, const char *message, const char *parameter);
 static enum oonf_telnet_result _cb_netjsoninfo(struct oonf_telnet_data *con);
+static enum oonf_telnet_result _cb_stream_netjsoninfo(struct oonf_telnet_data *con);
+static void _cb_stream_cleanup(struct oonf_telnet_data *con);
 static void _print_json_string(struct json_session *session, const char *key, const char *value);
 static void _print_json_bool(struct json_session *session, const char *key, bool value);
 static void _print_json_integer(struct json_session *session, const char *key, uint64_t value);
 static void _print_json_number(struct json_session *session, const char *key, const char *value);
 static void _print_json_netaddr(struct json_session *session, const char *key, const struct netaddr *addr);
+static struct json_session *_start_fragment(struct json_session *fragment_session);
+static void _store_fragment(
+  struct json_session *session, struct _netjson_fragment *fragment, uint32_t generation);
+static bool _is_fragment_current(const struct _netjson_fragment *fragment, uint32_t generation);
+static struct _netjson_tc_node_cache *_get_tc_link_cache(struct olsrv2_tc_node *node);
+static void _invalidate_tc_node_routes(struct nhdp_domain *domain, const struct netaddr *originator);
+static void _free_fragment(struct _netjson_fragment *fragment);
+static void _free_cache(void);
+static void _cb_tc_node_changed(void *ptr);
+static void _cb_tc_node_removed(void *ptr);
+static void _cb_tc_attached_changed(void *ptr);
+static void _cb_route_changed(void *ptr);
+static void _cb_route_removed(void *ptr);
+static void _cb_l2neigh_changed(void *ptr);
+static void _cb_l2neigh_removed(void *ptr);
+static void _cb_l2dst_changed(void *ptr);
+static void _cb_l2neigh_addr_changed(void *ptr);
 
 /* telnet command of this plugin */
 static struct oonf_telnet_command _telnet_commands[] = {
@@ -163,11 +380,78 @@ static struct oonf_telnet_command _telnet_commands[] = {
     "IPs/prefixes\n"),
 };
 
+/* memory class for streamed output */
+static struct oonf_class _stream_class = {
+  .name = "netjsoninfo stream",
+  .size = sizeof(struct _netjson_stream),
+};
+
+/* fragment cache of tc nodes */
+static struct oonf_class_extension _tc_node_cache_ext = {
+  .ext_name = "netjsoninfo cache",
+  .class_name = OLSRV2_CLASS_TC_NODE,
+  .size = sizeof(struct _netjson_tc_node_cache),
+  .cb_add = _cb_tc_node_changed,
+  .cb_change = _cb_tc_node_changed,
+  .cb_remove = _cb_tc_node_removed,
+};
+
+static struct oonf_class_extension _tc_attached_listener = {
+  .ext_name = "netjsoninfo cache",
+  .class_name = OLSRV2_CLASS_ATTACHED,
+  .cb_add = _cb_tc_attached_changed,
+  .cb_remove = _cb_tc_attached_changed,
+};
+
+/* fragment cache of routing entries */
+static struct oonf_class_extension _route_cache_ext = {
+  .ext_name = "netjsoninfo cache",
+  .class_name = OLSRV2_CLASS_ROUTING_ENTRY,
+  .size = sizeof(struct _netjson_route_cache),
+  .cb_add = _cb_route_changed,
+  .cb_change = _cb_route_changed,
+  .cb_remove = _cb_route_removed,
+};
+
+/* fragment cache of layer2 neighbors */
+static struct oonf_class_extension _l2neigh_cache_ext = {
+  .ext_name = "netjsoninfo cache",
+  .class_name = LAYER2_CLASS_NEIGHBOR,
+  .size = sizeof(struct _netjson_l2neigh_cache),
+  .cb_add = _cb_l2neigh_changed,
+  .cb_change = _cb_l2neigh_changed,
+  .cb_remove = _cb_l2neigh_removed,
+};
+
+static struct oonf_class_extension _l2dst_listener = {
+  .ext_name = "netjsoninfo cache",
+  .class_name = LAYER2_CLASS_DESTINATION,
+  .cb_add = _cb_l2dst_changed,
+  .cb_remove = _cb_l2dst_changed,
+};
+
+static struct oonf_class_extension _l2neigh_addr_listener = {
+  .ext_name = "netjsoninfo cache",
+  .class_name = LAYER2_CLASS_NEIGHBOR_ADDRESS,
+  .cb_add = _cb_l2neigh_addr_changed,
+  .cb_remove = _cb_l2neigh_addr_changed,
+};
+
+/* scratch buffer to generate fragments */
+static struct autobuf _fragment_buf;
+
+/* originators used for the cached graph edges, edges to the local node are not printed */
+static struct netaddr _graph_originator[2];
+static uint32_t _graph_originator_generation;
+
 /* plugin declaration */
 static const char *_dependencies[] = {
+  OONF_CLASS_SUBSYSTEM,
+  OONF_LAYER2_SUBSYSTEM,
   OONF_NHDP_SUBSYSTEM,
   OONF_OLSRV2_SUBSYSTEM,
   OONF_TELNET_SUBSYSTEM,
+  OONF_VIEWER_SUBSYSTEM,
 };
 static struct oonf_subsystem olsrv2_netjsoninfo = {
   .name = OONF_NETJSONINFO_SUBSYSTEM,
@@ -182,10 +466,28 @@ DECLARE_OONF_PLUGIN(olsrv2_netjsoninfo);
 
 /**
  * Initialize plugin
- * @return always returns 0
+ * @return -1 if an error happened, 0 otherwise
  */
 static int
 _init(void) {
+  if (abuf_init(&_fragment_buf)) {
+    return -1;
+  }
+
+  /*
+   * the fragment caches are optional, objects without a registered
+   * cache are just generated on every request
+   */
+  if (!oonf_class_extension_add(&_tc_node_cache_ext)) {
+    oonf_class_extension_add(&_tc_attached_listener);
+  }
+  oonf_class_extension_add(&_route_cache_ext);
+  if (!oonf_class_extension_add(&_l2neigh_cache_ext)) {
+    oonf_class_extension_add(&_l2dst_listener);
+    oonf_class_extension_add(&_l2neigh_addr_listener);
+  }
+
+  oonf_class_add(&_stream_class);
   oonf_telnet_add(&_telnet_commands[0]);
   return 0;
 }
@@ -196,6 +498,18 @@ _init(void) {
 static void
 _cleanup(void) {
   oonf_telnet_remove(&_telnet_commands[0]);
+  oonf_class_remove(&_stream_class);
+
+  _free_cache();
+
+  oonf_class_extension_remove(&_l2neigh_addr_listener);
+  oonf_class_extension_remove(&_l2dst_listener);
+  oonf_class_extension_remove(&_l2neigh_cache_ext);
+  oonf_class_extension_remove(&_route_cache_ext);
+  oonf_class_extension_remove(&_tc_attached_listener);
+  oonf_class_extension_remove(&_tc_node_cache_ext);
+
+  abuf_free(&_fragment_buf);
 }
 
 /**
@@ -381,6 +695,22 @@ _print_graph_node_me(struct json_session *session, int af_family) {
   _print_graph_node(session, &ebuf1, nbuf1.buf, olsrv2_originator_get(af_family), dualstack, NETJSON_NODE_LOCAL);
 }
 
+/**
+ * @param node tc node
+ * @return originator of the dualstack partner of a tc node,
+ *   NULL if there is none
+ */
+static const struct netaddr *
+_get_tc_node_dualstack(const struct olsrv2_tc_node *node) {
+  struct nhdp_neighbor *neigh;
+
+  neigh = nhdp_db_neighbor_get_by_originator(&node->target.prefix.dst);
+  if (neigh && neigh->dualstack_partner) {
+    return &neigh->dualstack_partner->originator;
+  }
+  return NULL;
+}
+
 /**
  * Print the JSON node element for a tc node
  * @param session json session
@@ -388,20 +718,14 @@ _print_graph_node_me(struct json_session *session, int af_family) {
  */
 static void
 _print_graph_node_tc(struct json_session *session, const struct olsrv2_tc_node *node) {
-  const struct netaddr *dualstack;
   struct _node_id_str ebuf;
   struct netaddr_str nbuf1;
-  struct nhdp_neighbor *neigh;
 
   _get_tc_node_id(&ebuf, node);
   netaddr_to_string(&nbuf1, &node->target.prefix.dst);
 
-  dualstack = NULL;
-  neigh = nhdp_db_neighbor_get_by_originator(&node->target.prefix.dst);
-  if (neigh && neigh->dualstack_partner) {
-    dualstack = &neigh->dualstack_partner->originator;
-  }
-  _print_graph_node(session, &ebuf, nbuf1.buf, &node->target.prefix.dst, dualstack, NETJSON_NODE_ROUTERS);
+  _print_graph_node(
+    session, &ebuf, nbuf1.buf, &node->target.prefix.dst, _get_tc_node_dualstack(node), NETJSON_NODE_ROUTERS);
 }
 
 /**
@@ -577,31 +901,24 @@ _print_graph_edge(struct json_session *session, struct nhdp_domain *domain, cons
 }
 
 /**
- * Print the JSON graph object
+ * Print the head of the JSON graph object including the local
+ * node and its attached networks
  * @param session json session
  * @param domain NHDP domain
  * @param af_type address family type
+ * @return false if there is no graph for this address family
  */
-static void
-_print_graph(struct json_session *session, struct nhdp_domain *domain, int af_type) {
-  struct os_route_key routekey;
+static bool
+_print_graph_head(struct json_session *session, struct nhdp_domain *domain, int af_type) {
   const struct netaddr *originator, *dualstack;
-  struct nhdp_neighbor *neigh;
-  struct olsrv2_tc_node *node;
-  struct olsrv2_tc_edge *edge;
-  struct olsrv2_tc_attachment *attached;
   struct olsrv2_lan_entry *lan;
-  struct avl_tree *rt_tree;
-  struct olsrv2_routing_entry *rt_entry;
   struct domain_id_str dbuf;
-  struct _node_id_str node_id1, node_id2;
+  struct _node_id_str node_id;
   int other_af;
 
-  bool outgoing;
-
   originator = olsrv2_originator_get(af_type);
   if (netaddr_is_unspec(originator)) {
-    return;
+    return false;
   }
 
   /* get "other" originator */
@@ -617,7 +934,7 @@ _print_graph(struct json_session *session, struct nhdp_domain *domain, int af_ty
   _print_json_string(session, "version", oonf_log_get_libdata()->version);
   _print_json_string(session, "revision", oonf_log_get_libdata()->git_commit);
 
-  _print_json_string(session, "router_id", _get_node_id_me(&node_id1, af_type));
+  _print_json_string(session, "router_id", _get_node_id_me(&node_id, af_type));
 
   _print_json_string(session, "metric", domain->metric->name);
   _print_json_string(session, "topology_id", _create_domain_id(&dbuf, domain, af_type));
@@ -625,7 +942,7 @@ _print_graph(struct json_session *session, struct nhdp_domain *domain, int af_ty
   json_start_object(session, "properties");
   _print_json_netaddr(session, "router_addr", originator);
   if (dualstack) {
-    _print_json_string(session, "dualstack_id", _get_node_id_me(&node_id1, other_af));
+    _print_json_string(session, "dualstack_id", _get_node_id_me(&node_id, other_af));
     _print_json_string(session, "dualstack_topology", _create_domain_id(&dbuf, domain, other_af));
     _print_json_netaddr(session, "dualstack_addr", dualstack);
   }
@@ -642,22 +959,93 @@ _print_graph(struct json_session *session, struct nhdp_domain *domain, int af_ty
       _print_graph_node_lan(session, lan);
     }
   }
+  return true;
+}
 
-  /* originators of all other nodes */
-  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
-    if (netaddr_get_address_family(&node->target.prefix.dst) == af_type) {
-      if (netaddr_cmp(&node->target.prefix.dst, originator) == 0) {
-        continue;
-      }
+/**
+ * Print the graph node objects of a remote router and its attached networks
+ * @param session json session
+ * @param node OLSRv2 node
+ */
+static void
+_print_graph_tc_node_objects(struct json_session *session, const struct olsrv2_tc_node *node) {
+  struct olsrv2_tc_attachment *attached;
 
-      _print_graph_node_tc(session, node);
+  _print_graph_node_tc(session, node);
 
-      /* attached networks */
-      avl_for_each_element(&node->_attached_networks, attached, _src_node) {
-        _print_graph_node_attached(session, attached);
-      }
-    }
+  /* attached networks */
+  avl_for_each_element(&node->_attached_networks, attached, _src_node) {
+    _print_graph_node_attached(session, attached);
+  }
+}
+
+/**
+ * Print the graph node of a remote router and its attached networks,
+ * using the fragment cache of the node if possible
+ * @param session json session
+ * @param node OLSRv2 node
+ * @param af_type address family type
+ */
+static void
+_print_graph_tc_node(struct json_session *session, struct olsrv2_tc_node *node, int af_type) {
+  struct _netjson_tc_node_cache *cache;
+  struct json_session fragment_session;
+  const struct netaddr *dualstack;
+
+  if (netaddr_get_address_family(&node->target.prefix.dst) != af_type) {
+    return;
   }
+  if (netaddr_cmp(&node->target.prefix.dst, olsrv2_originator_get(af_type)) == 0) {
+    return;
+  }
+
+  /* virtual nodes are freed without a REMOVED event, so they cannot keep a fragment */
+  if (!oonf_class_is_extension_registered(&_tc_node_cache_ext) || olsrv2_tc_is_node_virtual(node)) {
+    _print_graph_tc_node_objects(session, node);
+    return;
+  }
+
+  cache = oonf_class_get_extension(&_tc_node_cache_ext, node);
+
+  /* the dualstack partner is learned by NHDP, so there is no tc node event for it */
+  dualstack = _get_tc_node_dualstack(node);
+  if (dualstack == NULL) {
+    dualstack = &NETADDR_UNSPEC;
+  }
+  if (netaddr_cmp(&cache->dualstack, dualstack) != 0) {
+    memcpy(&cache->dualstack, dualstack, sizeof(cache->dualstack));
+    cache->generation++;
+  }
+
+  if (_is_fragment_current(&cache->nodes, cache->generation)) {
+    json_print_raw(session, cache->nodes.text, cache->nodes.length);
+  }
+  else {
+    _print_graph_tc_node_objects(_start_fragment(&fragment_session), node);
+    _store_fragment(session, &cache->nodes, cache->generation);
+  }
+}
+
+/**
+ * Close the node array of the JSON graph object and print the links
+ * of the local node
+ * @param session json session
+ * @param domain NHDP domain
+ * @param af_type address family type
+ */
+static void
+_print_graph_local_links(struct json_session *session, struct nhdp_domain *domain, int af_type) {
+  struct os_route_key routekey;
+  const struct netaddr *originator;
+  struct nhdp_neighbor *neigh;
+  struct olsrv2_lan_entry *lan;
+  struct avl_tree *rt_tree;
+  struct olsrv2_routing_entry *rt_entry;
+  struct _node_id_str node_id1, node_id2;
+  bool outgoing;
+
+  originator = olsrv2_originator_get(af_type);
+
   json_end_array(session);
 
   json_start_array(session, "links");
@@ -699,171 +1087,462 @@ _print_graph(struct json_session *session, struct nhdp_domain *domain, int af_ty
         outgoing, NETJSON_EDGE_LAN, NULL);
     }
   }
+}
 
-  /* print remote node links to neighbors */
-  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
-    if (netaddr_get_address_family(&node->target.prefix.dst) == af_type) {
-      _get_tc_node_id(&node_id1, node);
-
-      avl_for_each_element(&node->_edges, edge, _node) {
-        if (!edge->virtual) {
-          if (netaddr_cmp(&edge->dst->target.prefix.dst, originator) == 0) {
-            /* we already have this information from NHDP */
-            continue;
-          }
+/**
+ * Print the links of a remote router to its neighbors
+ * @param session json session
+ * @param domain NHDP domain
+ * @param node OLSRv2 node
+ */
+static void
+_print_graph_tc_edge_objects(struct json_session *session, struct nhdp_domain *domain, struct olsrv2_tc_node *node) {
+  const struct netaddr *originator;
+  struct olsrv2_tc_edge *edge;
+  struct avl_tree *rt_tree;
+  struct olsrv2_routing_entry *rt_entry;
+  struct _node_id_str node_id1, node_id2;
+  bool outgoing;
 
-          rt_entry = avl_find_element(rt_tree, &edge->dst->target.prefix, rt_entry, _node);
-          outgoing = rt_entry != NULL && netaddr_cmp(&rt_entry->last_originator, &node->target.prefix.dst) == 0;
+  originator = olsrv2_originator_get(netaddr_get_address_family(&node->target.prefix.dst));
+  rt_tree = olsrv2_routing_get_tree(domain);
 
-          _get_tc_node_id(&node_id2, edge->dst);
+  _get_tc_node_id(&node_id1, node);
 
-          _print_graph_edge(session, domain, &node_id1, &node_id2, &node->target.prefix.dst,
-            &edge->dst->target.prefix.dst, edge->cost[domain->index], edge->inverse->cost[domain->index], 0, outgoing,
-            NETJSON_EDGE_ROUTERS, NULL);
-        }
+  avl_for_each_element(&node->_edges, edge, _node) {
+    if (!edge->virtual) {
+      if (netaddr_cmp(&edge->dst->target.prefix.dst, originator) == 0) {
+        /* we already have this information from NHDP */
+        continue;
       }
+
+      rt_entry = avl_find_element(rt_tree, &edge->dst->target.prefix, rt_entry, _node);
+      outgoing = rt_entry != NULL && netaddr_cmp(&rt_entry->last_originator, &node->target.prefix.dst) == 0;
+
+      _get_tc_node_id(&node_id2, edge->dst);
+
+      _print_graph_edge(session, domain, &node_id1, &node_id2, &node->target.prefix.dst,
+        &edge->dst->target.prefix.dst, edge->cost[domain->index], edge->inverse->cost[domain->index], 0, outgoing,
+        NETJSON_EDGE_ROUTERS, NULL);
     }
   }
+}
 
-  /* print remote nodes neighbors */
-  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
-    if (netaddr_get_address_family(&node->target.prefix.dst) == af_type) {
-      _get_tc_node_id(&node_id1, node);
-
-      avl_for_each_element(&node->_attached_networks, attached, _src_node) {
-        rt_entry = avl_find_element(rt_tree, &attached->dst->target.prefix, rt_entry, _node);
-        outgoing = rt_entry != NULL && netaddr_cmp(&rt_entry->originator, &node->target.prefix.dst) == 0;
+/**
+ * Print the links of a remote router to its neighbors, using the
+ * fragment cache of the node if possible
+ * @param session json session
+ * @param domain NHDP domain
+ * @param node OLSRv2 node
+ * @param af_type address family type
+ */
+static void
+_print_graph_tc_edges(
+  struct json_session *session, struct nhdp_domain *domain, struct olsrv2_tc_node *node, int af_type) {
+  struct _netjson_tc_node_cache *cache;
+  struct json_session fragment_session;
+  uint32_t generation;
 
-        _get_tc_endpoint_id(&node_id2, attached);
+  if (netaddr_get_address_family(&node->target.prefix.dst) != af_type) {
+    return;
+  }
 
-        _print_graph_edge(session, domain, &node_id1, &node_id2, &node->target.prefix.dst,
-          &attached->dst->target.prefix.dst, attached->cost[domain->index], 0, attached->distance[domain->index],
-          outgoing, NETJSON_EDGE_ATTACHED, NULL);
-      }
-    }
+  cache = _get_tc_link_cache(node);
+  if (cache == NULL) {
+    _print_graph_tc_edge_objects(session, domain, node);
+    return;
   }
-  json_end_array(session);
 
-  json_end_object(session);
+  /* the edges depend on the node, its neighbors, the routing tree and the local originator */
+  generation = cache->generation + cache->edge_generation + cache->route_generation[domain->index] +
+               _graph_originator_generation;
+
+  if (_is_fragment_current(&cache->edges[domain->index], generation)) {
+    json_print_raw(session, cache->edges[domain->index].text, cache->edges[domain->index].length);
+  }
+  else {
+    _print_graph_tc_edge_objects(_start_fragment(&fragment_session), domain, node);
+    _store_fragment(session, &cache->edges[domain->index], generation);
+  }
 }
 
 /**
- * Print all JSON graph objects
+ * Print the links of a remote router to its attached networks
  * @param session json session
- * @param filter domain filter
+ * @param domain NHDP domain
+ * @param node OLSRv2 node
  */
 static void
-_create_graph_json(struct json_session *session, const char *filter) {
-  struct nhdp_domain *domain;
-  struct domain_id_str dbuf;
+_print_graph_tc_attachment_objects(
+  struct json_session *session, struct nhdp_domain *domain, struct olsrv2_tc_node *node) {
+  struct olsrv2_tc_attachment *attached;
+  struct avl_tree *rt_tree;
+  struct olsrv2_routing_entry *rt_entry;
+  struct _node_id_str node_id1, node_id2;
+  bool outgoing;
 
-  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
-    if (filter == NULL || strcmp(_create_domain_id(&dbuf, domain, AF_INET), filter) == 0) {
-      _print_graph(session, domain, AF_INET);
-    }
-    if (filter == NULL || strcmp(_create_domain_id(&dbuf, domain, AF_INET6), filter) == 0) {
-      _print_graph(session, domain, AF_INET6);
-    }
+  rt_tree = olsrv2_routing_get_tree(domain);
+
+  _get_tc_node_id(&node_id1, node);
+
+  avl_for_each_element(&node->_attached_networks, attached, _src_node) {
+    rt_entry = avl_find_element(rt_tree, &attached->dst->target.prefix, rt_entry, _node);
+    outgoing = rt_entry != NULL && netaddr_cmp(&rt_entry->originator, &node->target.prefix.dst) == 0;
+
+    _get_tc_endpoint_id(&node_id2, attached);
+
+    _print_graph_edge(session, domain, &node_id1, &node_id2, &node->target.prefix.dst,
+      &attached->dst->target.prefix.dst, attached->cost[domain->index], 0, attached->distance[domain->index], outgoing,
+      NETJSON_EDGE_ATTACHED, NULL);
   }
 }
 
 /**
- * Print the JSON routing tree
+ * Print the links of a remote router to its attached networks, using
+ * the fragment cache of the node if possible
  * @param session json session
  * @param domain NHDP domain
- * @param af_type address family
+ * @param node OLSRv2 node
+ * @param af_type address family type
  */
 static void
-_print_routing_tree(struct json_session *session, struct nhdp_domain *domain, int af_type) {
-  struct olsrv2_routing_entry *rtentry;
-  const struct netaddr *originator;
-  char ibuf[IF_NAMESIZE];
-  struct nhdp_metric_str mbuf;
-  struct domain_id_str dbuf;
-  struct _node_id_str idbuf;
+_print_graph_tc_attachments(
+  struct json_session *session, struct nhdp_domain *domain, struct olsrv2_tc_node *node, int af_type) {
+  struct _netjson_tc_node_cache *cache;
+  struct json_session fragment_session;
+  uint32_t generation;
 
-  originator = olsrv2_originator_get(af_type);
-  if (netaddr_get_address_family(originator) != af_type) {
+  if (netaddr_get_address_family(&node->target.prefix.dst) != af_type) {
     return;
   }
 
-  json_start_object(session, NULL);
+  cache = _get_tc_link_cache(node);
+  if (cache == NULL) {
+    _print_graph_tc_attachment_objects(session, domain, node);
+    return;
+  }
 
-  _print_json_string(session, "type", "NetworkRoutes");
-  _print_json_string(session, "protocol", "olsrv2");
-  _print_json_string(session, "version", oonf_log_get_libdata()->version);
-  _print_json_string(session, "revision", oonf_log_get_libdata()->git_commit);
+  /* the attachments depend on the node and the routing tree */
+  generation = cache->generation + cache->route_generation[domain->index];
 
-  _get_node_id_me(&idbuf, af_type);
-  _print_json_string(session, "router_id", idbuf.buf);
-  _print_json_string(session, "metric", domain->metric->name);
-  _print_json_string(session, "topology_id", _create_domain_id(&dbuf, domain, af_type));
+  if (_is_fragment_current(&cache->attachments[domain->index], generation)) {
+    json_print_raw(session, cache->attachments[domain->index].text, cache->attachments[domain->index].length);
+  }
+  else {
+    _print_graph_tc_attachment_objects(_start_fragment(&fragment_session), domain, node);
+    _store_fragment(session, &cache->attachments[domain->index], generation);
+  }
+}
 
-  json_start_object(session, "properties");
+/**
+ * Stream the next part of the JSON graph object
+ * @param stream netjson stream
+ * @param domain NHDP domain
+ * @return true if the graph object is complete
+ */
+static bool
+_stream_graph(struct _netjson_stream *stream, struct nhdp_domain *domain) {
+  struct olsrv2_tc_node *node;
+
+  while (!_is_chunk_full(stream)) {
+    switch (stream->phase) {
+      case NETJSON_PHASE_START:
+        if (!_print_graph_head(&stream->session, domain, stream->af_type)) {
+          return true;
+        }
+        _set_stream_phase(stream, NETJSON_PHASE_NODES);
+        break;
+
+      case NETJSON_PHASE_NODES:
+        if ((node = _get_stream_tc_node(stream))) {
+          _print_graph_tc_node(&stream->session, node, stream->af_type);
+        }
+        else {
+          _print_graph_local_links(&stream->session, domain, stream->af_type);
+          _set_stream_phase(stream, NETJSON_PHASE_EDGES);
+        }
+        break;
+
+      case NETJSON_PHASE_EDGES:
+        if ((node = _get_stream_tc_node(stream))) {
+          _print_graph_tc_edges(&stream->session, domain, node, stream->af_type);
+        }
+        else {
+          _set_stream_phase(stream, NETJSON_PHASE_ATTACHED);
+        }
+        break;
+
+      case NETJSON_PHASE_ATTACHED:
+        if ((node = _get_stream_tc_node(stream))) {
+          _print_graph_tc_attachments(&stream->session, domain, node, stream->af_type);
+        }
+        else {
+          json_end_array(&stream->session);
+          json_end_object(&stream->session);
+          return true;
+        }
+        break;
+
+      default:
+        return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Print the head of the JSON routing tree
+ * @param session json session
+ * @param domain NHDP domain
+ * @param af_type address family
+ * @return false if there is no routing tree for this address family
+ */
+static bool
+_print_routing_tree_head(struct json_session *session, struct nhdp_domain *domain, int af_type) {
+  const struct netaddr *originator;
+  struct domain_id_str dbuf;
+  struct _node_id_str idbuf;
+
+  originator = olsrv2_originator_get(af_type);
+  if (netaddr_get_address_family(originator) != af_type) {
+    return false;
+  }
+
+  json_start_object(session, NULL);
+
+  _print_json_string(session, "type", "NetworkRoutes");
+  _print_json_string(session, "protocol", "olsrv2");
+  _print_json_string(session, "version", oonf_log_get_libdata()->version);
+  _print_json_string(session, "revision", oonf_log_get_libdata()->git_commit);
+
+  _get_node_id_me(&idbuf, af_type);
+  _print_json_string(session, "router_id", idbuf.buf);
+  _print_json_string(session, "metric", domain->metric->name);
+  _print_json_string(session, "topology_id", _create_domain_id(&dbuf, domain, af_type));
+
+  json_start_object(session, "properties");
   _print_json_netaddr(session, "router_addr", originator);
   json_end_object(session);
 
   json_start_array(session, "routes");
+  return true;
+}
 
-  avl_for_each_element(olsrv2_routing_get_tree(domain), rtentry, _node) {
-    if (rtentry->route.p.family == af_type) {
-      json_start_object(session, NULL);
+/**
+ * Print a single JSON route object
+ * @param session json session
+ * @param domain NHDP domain
+ * @param rtentry routing entry
+ */
+static void
+_print_routing_entry_object(
+  struct json_session *session, struct nhdp_domain *domain, struct olsrv2_routing_entry *rtentry) {
+  char ibuf[IF_NAMESIZE];
+  struct nhdp_metric_str mbuf;
+  struct _node_id_str idbuf;
 
-      _print_json_netaddr(session, "destination", &rtentry->route.p.key.dst);
+  json_start_object(session, NULL);
 
-      if (netaddr_get_prefix_length(&rtentry->route.p.key.src) > 0) {
-        _print_json_netaddr(session, "source", &rtentry->route.p.key.src);
-      }
+  _print_json_netaddr(session, "destination", &rtentry->route.p.key.dst);
 
-      _get_node_id(&idbuf, &rtentry->next_originator, NULL);
-      _print_json_netaddr(session, "next", &rtentry->route.p.gw);
+  if (netaddr_get_prefix_length(&rtentry->route.p.key.src) > 0) {
+    _print_json_netaddr(session, "source", &rtentry->route.p.key.src);
+  }
 
-      _print_json_string(session, "device", if_indextoname(rtentry->route.p.if_index, ibuf));
-            _print_json_integer(session, "cost", rtentry->path_cost);
-      _print_json_string(
-        session, "cost_text", nhdp_domain_get_path_metric_value(&mbuf, domain, rtentry->path_cost, rtentry->path_hops));
+  _get_node_id(&idbuf, &rtentry->next_originator, NULL);
+  _print_json_netaddr(session, "next", &rtentry->route.p.gw);
 
-      json_start_object(session, "properties");
-      if (!netaddr_is_unspec(&rtentry->originator)) {
-        _get_node_id(&idbuf, &rtentry->originator, NULL);
-        _print_json_string(session, "destination_id", idbuf.buf);
-      }
-      _print_json_string(session, "next_router_id", idbuf.buf);
-      _print_json_netaddr(session, "next_router_addr", &rtentry->next_originator);
+  /* the interface might have been removed from the system in the meantime */
+  if (if_indextoname(rtentry->route.p.if_index, ibuf)) {
+    _print_json_string(session, "device", ibuf);
+  }
+  _print_json_integer(session, "cost", rtentry->path_cost);
+  _print_json_string(
+    session, "cost_text", nhdp_domain_get_path_metric_value(&mbuf, domain, rtentry->path_cost, rtentry->path_hops));
 
-            _print_json_integer(session, "hops", rtentry->path_hops);
+  json_start_object(session, "properties");
+  if (!netaddr_is_unspec(&rtentry->originator)) {
+    _get_node_id(&idbuf, &rtentry->originator, NULL);
+    _print_json_string(session, "destination_id", idbuf.buf);
+  }
+  _print_json_string(session, "next_router_id", idbuf.buf);
+  _print_json_netaddr(session, "next_router_addr", &rtentry->next_originator);
 
-      _get_node_id(&idbuf, &rtentry->last_originator, NULL);
-      _print_json_string(session, "last_router_id", idbuf.buf);
-      _print_json_netaddr(session, "last_router_addr", &rtentry->last_originator);
-      json_end_object(session);
+  _print_json_integer(session, "hops", rtentry->path_hops);
 
-      json_end_object(session);
-    }
-  }
+  _get_node_id(&idbuf, &rtentry->last_originator, NULL);
+  _print_json_string(session, "last_router_id", idbuf.buf);
+  _print_json_netaddr(session, "last_router_addr", &rtentry->last_originator);
+  json_end_object(session);
 
-  json_end_array(session);
   json_end_object(session);
 }
 
 /**
- * Print all JSON routes
+ * Print a single JSON route, using the fragment cache of the
+ * routing entry if possible
  * @param session json session
- * @param filter filter value to select domain
+ * @param domain NHDP domain
+ * @param rtentry routing entry
  */
 static void
-_create_route_json(struct json_session *session, const char *filter) {
+_print_routing_entry(struct json_session *session, struct nhdp_domain *domain, struct olsrv2_routing_entry *rtentry) {
+  struct _netjson_route_cache *cache;
+  struct _netjson_route_state state;
+  struct json_session fragment_session;
+
+  if (!oonf_class_is_extension_registered(&_route_cache_ext)) {
+    _print_routing_entry_object(session, domain, rtentry);
+    return;
+  }
+
+  cache = oonf_class_get_extension(&_route_cache_ext, rtentry);
+
+  /* the dijkstra updates routing entries without events, compare the printed values instead */
+  memset(&state, 0, sizeof(state));
+  memcpy(&state.gw, &rtentry->route.p.gw, sizeof(state.gw));
+  memcpy(&state.originator, &rtentry->originator, sizeof(state.originator));
+  memcpy(&state.next_originator, &rtentry->next_originator, sizeof(state.next_originator));
+  memcpy(&state.last_originator, &rtentry->last_originator, sizeof(state.last_originator));
+  state.if_index = rtentry->route.p.if_index;
+  state.path_cost = rtentry->path_cost;
+  state.path_hops = rtentry->path_hops;
+
+  if (memcmp(&cache->state, &state, sizeof(state)) != 0) {
+    memcpy(&cache->state, &state, sizeof(state));
+    cache->generation++;
+  }
+
+  if (_is_fragment_current(&cache->route, cache->generation)) {
+    json_print_raw(session, cache->route.text, cache->route.length);
+  }
+  else {
+    _print_routing_entry_object(_start_fragment(&fragment_session), domain, rtentry);
+    _store_fragment(session, &cache->route, cache->generation);
+  }
+}
+
+/**
+ * Stream the next part of the JSON routing tree
+ * @param stream netjson stream
+ * @param domain NHDP domain
+ * @return true if the routing tree is complete
+ */
+static bool
+_stream_routing_tree(struct _netjson_stream *stream, struct nhdp_domain *domain) {
+  struct olsrv2_routing_entry *rtentry;
+  struct avl_node *node;
+
+  while (!_is_chunk_full(stream)) {
+    switch (stream->phase) {
+      case NETJSON_PHASE_START:
+        if (!_print_routing_tree_head(&stream->session, domain, stream->af_type)) {
+          return true;
+        }
+        _set_stream_phase(stream, NETJSON_PHASE_ROUTES);
+        break;
+
+      case NETJSON_PHASE_ROUTES:
+        node = oonf_viewer_stream_next_node(
+          olsrv2_routing_get_tree(domain), &stream->cursor, sizeof(struct os_route_key));
+        if (!node) {
+          json_end_array(&stream->session);
+          json_end_object(&stream->session);
+          return true;
+        }
+
+        rtentry = container_of(node, typeof(*rtentry), _node);
+        if (rtentry->route.p.family == stream->af_type) {
+          _print_routing_entry(&stream->session, domain, rtentry);
+        }
+        break;
+
+      default:
+        return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Stream the next part of the current graph or route objects
+ * of all selected domains
+ * @param stream netjson stream
+ * @return true if all objects are complete
+ */
+static bool
+_stream_domain_objects(struct _netjson_stream *stream) {
   struct nhdp_domain *domain;
   struct domain_id_str dbuf;
+  bool done;
 
   list_for_each_element(nhdp_domain_get_list(), domain, _node) {
-    if (filter == NULL || strcmp(_create_domain_id(&dbuf, domain, AF_INET), filter) == 0) {
-      _print_routing_tree(session, domain, AF_INET);
+    if (domain->index < stream->domain_index) {
+      continue;
     }
-    if (filter == NULL || strcmp(_create_domain_id(&dbuf, domain, AF_INET6), filter) == 0) {
-      _print_routing_tree(session, domain, AF_INET6);
+    if (domain->index > stream->domain_index) {
+      /* start with IPv4 object of next domain */
+      stream->domain_index = domain->index;
+      stream->af_type = AF_INET;
+      _set_stream_phase(stream, NETJSON_PHASE_START);
+    }
+
+    while (stream->af_type != AF_UNSPEC) {
+      if (stream->domain_filter == NULL
+          || strcmp(_create_domain_id(&dbuf, domain, stream->af_type), stream->domain_filter) == 0) {
+        if (stream->object == NETJSON_OBJECT_GRAPH) {
+          done = _stream_graph(stream, domain);
+        }
+        else {
+          done = _stream_routing_tree(stream, domain);
+        }
+        if (!done) {
+          return false;
+        }
+      }
+
+      stream->af_type = stream->af_type == AF_INET ? AF_INET6 : AF_UNSPEC;
+      _set_stream_phase(stream, NETJSON_PHASE_START);
     }
   }
+  return true;
+}
+
+/**
+ * Get the next OLSRv2 node for the current phase of a stream
+ * @param stream netjson stream
+ * @return OLSRv2 node, NULL if all nodes have been processed
+ */
+static struct olsrv2_tc_node *
+_get_stream_tc_node(struct _netjson_stream *stream) {
+  struct olsrv2_tc_node *node;
+  struct avl_node *avl;
+
+  avl = oonf_viewer_stream_next_node(olsrv2_tc_get_tree(), &stream->cursor, sizeof(struct netaddr));
+  if (!avl) {
+    return NULL;
+  }
+  return container_of(avl, typeof(*node), _originator_node);
+}
+
+/**
+ * Switch a stream to a new phase and reset its cursor
+ * @param stream netjson stream
+ * @param phase new phase
+ */
+static void
+_set_stream_phase(struct _netjson_stream *stream, enum _netjson_phase phase) {
+  stream->phase = phase;
+  memset(&stream->cursor, 0, sizeof(stream->cursor));
+}
+
+/**
+ * @param stream netjson stream
+ * @return true if the current chunk of the stream is full
+ */
+static bool
+_is_chunk_full(struct _netjson_stream *stream) {
+  return abuf_getlen(stream->session.out) - stream->chunk_start >= OONF_TELNET_STREAM_CHUNK;
 }
 
 static void
@@ -966,16 +1645,10 @@ _print_layer2_data(struct json_session *session, const struct oonf_layer2_data *
 }
 
 static void
-_print_layer2_neighbor(struct json_session *session, struct oonf_layer2_neigh *l2neigh) {
-  const struct oonf_layer2_metadata *l2metadata;
+_print_layer2_neighbor_head(struct json_session *session, struct oonf_layer2_neigh *l2neigh) {
   struct oonf_layer2_neighbor_address *l2naddr;
   struct oonf_layer2_destination *l2dest;
-  struct oonf_layer2_data *l2data;
-  struct isonumber_str ibuf;
   char hexbuf[64];
-  enum oonf_layer2_neighbor_index neigh_idx;
-
-  json_start_object(session, NULL);
 
   if (netaddr_cmp(&l2neigh->key.addr, &l2neigh->network->if_listener.data->mac) != 0) {
     _print_json_netaddr(session, "radio_mac", &l2neigh->key.addr);
@@ -999,10 +1672,13 @@ _print_layer2_neighbor(struct json_session *session, struct oonf_layer2_neigh *l
     }
     json_end_array(session);
   }
+}
 
-  _print_json_number(session, "last_seen",
-    oonf_clock_toIntervalString(&ibuf,
-      -oonf_clock_get_relative(oonf_layer2_neigh_get_lastseen(l2neigh))));
+static void
+_print_layer2_neighbor_data(struct json_session *session, struct oonf_layer2_neigh *l2neigh) {
+  const struct oonf_layer2_metadata *l2metadata;
+  struct oonf_layer2_data *l2data;
+  enum oonf_layer2_neighbor_index neigh_idx;
 
   json_start_object(session, "neighbor_data");
   for (neigh_idx=0; neigh_idx < OONF_LAYER2_NEIGH_COUNT; neigh_idx++) {
@@ -1015,6 +1691,48 @@ _print_layer2_neighbor(struct json_session *session, struct oonf_layer2_neigh *l
     _print_layer2_data(session, l2data, l2metadata);
   }
   json_end_object(session);
+}
+
+static void
+_print_layer2_neighbor(struct json_session *session, struct oonf_layer2_neigh *l2neigh) {
+  struct _netjson_l2neigh_cache *cache;
+  struct json_session fragment_session;
+  struct isonumber_str ibuf;
+
+  json_start_object(session, NULL);
+
+  if (oonf_class_is_extension_registered(&_l2neigh_cache_ext)) {
+    cache = oonf_class_get_extension(&_l2neigh_cache_ext, l2neigh);
+    if (_is_fragment_current(&cache->head, cache->generation)) {
+      json_print_raw(session, cache->head.text, cache->head.length);
+    }
+    else {
+      _print_layer2_neighbor_head(_start_fragment(&fragment_session), l2neigh);
+      _store_fragment(session, &cache->head, cache->generation);
+    }
+  }
+  else {
+    cache = NULL;
+    _print_layer2_neighbor_head(session, l2neigh);
+  }
+
+  /* relative timestamp changes on every request, so it is never cached */
+  _print_json_number(session, "last_seen",
+    oonf_clock_toIntervalString(&ibuf,
+      -oonf_clock_get_relative(oonf_layer2_neigh_get_lastseen(l2neigh))));
+
+  if (cache) {
+    if (_is_fragment_current(&cache->data, cache->generation)) {
+      json_print_raw(session, cache->data.text, cache->data.length);
+    }
+    else {
+      _print_layer2_neighbor_data(_start_fragment(&fragment_session), l2neigh);
+      _store_fragment(session, &cache->data, cache->generation);
+    }
+  }
+  else {
+    _print_layer2_neighbor_data(session, l2neigh);
+  }
   json_end_object(session);
 }
 
@@ -1176,96 +1894,150 @@ _create_error_json(struct json_session *session, const char *message, const char
   json_end_object(session);
 }
 
+/**
+ * Parse the next netjson object of the parameter and generate it.
+ * Graph and route objects are only selected, they are generated
+ * by the stream handler.
+ * @param stream netjson stream
+ * @param parameter parameter string
+ * @return pointer to next object in parameter
+ */
 static const char *
-_handle_netjson_object(struct json_session *session, const char *parameter, bool filter, bool *error) {
+_handle_netjson_object(struct _netjson_stream *stream, const char *parameter) {
   const char *ptr;
 
   if ((ptr = str_hasnextword(parameter, JSON_NAME_GRAPH))) {
-    _create_graph_json(session, filter ? ptr : NULL);
+    _start_domain_objects(stream, NETJSON_OBJECT_GRAPH, stream->filter ? ptr : NULL);
   }
   else if ((ptr = str_hasnextword(parameter, JSON_NAME_ROUTE))) {
-    _create_route_json(session, filter ? ptr : NULL);
+    _start_domain_objects(stream, NETJSON_OBJECT_ROUTE, stream->filter ? ptr : NULL);
   }
-  else if (!filter && (ptr = str_hasnextword(parameter, JSON_NAME_DOMAIN))) {
-    _create_domain_json(session);
+  else if (!stream->filter && (ptr = str_hasnextword(parameter, JSON_NAME_DOMAIN))) {
+    _create_domain_json(&stream->session);
   }
-  else if (!filter && (ptr = str_hasnextword(parameter, JSON_NAME_ID))) {
-    _create_id_json(session);
+  else if (!stream->filter && (ptr = str_hasnextword(parameter, JSON_NAME_ID))) {
+    _create_id_json(&stream->session);
   }
-  else if (!filter && (ptr = str_hasnextword(parameter, JSON_NAME_LINK))) {
-    _create_link_json(session);
+  else if (!stream->filter && (ptr = str_hasnextword(parameter, JSON_NAME_LINK))) {
+    _create_link_json(&stream->session);
   }
   else {
     ptr = str_skipnextword(parameter);
-    *error = true;
+    stream->error = true;
   }
   return ptr;
 }
 
+/**
+ * Start streaming graph or route objects for all selected domains
+ * @param stream netjson stream
+ * @param object type of object
+ * @param filter domain filter, NULL for all domains
+ */
 static void
-_handle_filter(struct json_session *session, const char *parameter) {
-  bool error = false;
+_start_domain_objects(struct _netjson_stream *stream, enum _netjson_object object, const char *filter) {
+  stream->object = object;
+  stream->domain_filter = filter;
+  stream->domain_index = -1;
+  stream->af_type = AF_UNSPEC;
+  _set_stream_phase(stream, NETJSON_PHASE_START);
+}
 
-  _handle_netjson_object(session, parameter, true, &error);
-  if (error) {
-    _create_error_json(session, "Could not parse sub-command for netjsoninfo", parameter);
+/**
+ * Callback for netjsoninfo telnet command
+ * @param con telnet connection
+ * @return active, continous or internal_error
+ */
+static enum oonf_telnet_result
+_cb_netjsoninfo(struct oonf_telnet_data *con) {
+  struct _netjson_stream *stream;
+  const char *ptr;
+
+  if (con->parameter == NULL || *con->parameter == 0) {
+    return TELNET_RESULT_ACTIVE;
   }
-}
 
-static void
-_handle_collection(struct json_session *session, const char *parameter) {
-  const char *next;
-  bool error;
+  stream = oonf_class_malloc(&_stream_class);
+  if (!stream) {
+    return TELNET_RESULT_INTERNAL_ERROR;
+  }
 
-  json_start_object(session, NULL);
-  _print_json_string(session, "type", "NetworkCollection");
-  json_start_array(session, "collection");
+  /* the parameter of the telnet command does not outlive the first chunk */
+  stream->parameter = strdup(con->parameter);
+  if (!stream->parameter) {
+    oonf_class_free(&_stream_class, stream);
+    return TELNET_RESULT_INTERNAL_ERROR;
+  }
+
+  json_init_session(&stream->session, con->out);
 
-  error = 0;
-  next = parameter;
-  while (next && *next) {
-    next = _handle_netjson_object(session, next, false, &error);
+  if ((ptr = str_hasnextword(stream->parameter, JSON_NAME_FILTER))) {
+    stream->filter = true;
+    stream->next = ptr;
   }
+  else {
+    stream->next = stream->parameter;
 
-  if (error) {
-    _create_error_json(session, "Could not parse sub-command for netjsoninfo", parameter);
+    json_start_object(&stream->session, NULL);
+    _print_json_string(&stream->session, "type", "NetworkCollection");
+    json_start_array(&stream->session, "collection");
   }
 
-  json_end_array(session);
-  json_end_object(session);
+  con->stream_handler = _cb_stream_netjsoninfo;
+  con->stream_cleanup = _cb_stream_cleanup;
+  con->stream_data = stream;
+
+  return oonf_telnet_stream_next(con);
 }
 
 /**
- * Callback for netjsoninfo telnet command
+ * Generate the next chunk of netjsoninfo output
  * @param con telnet connection
- * @return active or internal_error
+ * @return active or continous
  */
 static enum oonf_telnet_result
-_cb_netjsoninfo(struct oonf_telnet_data *con) {
-  struct json_session session;
-  struct autobuf out;
-  const char *ptr, *next;
-
-  if (abuf_init(&out)) {
-    return TELNET_RESULT_INTERNAL_ERROR;
-  }
-
-  json_init_session(&session, &out);
+_cb_stream_netjsoninfo(struct oonf_telnet_data *con) {
+  struct _netjson_stream *stream = con->stream_data;
+
+  stream->chunk_start = abuf_getlen(con->out);
+  while (!_is_chunk_full(stream)) {
+    if (stream->object != NETJSON_OBJECT_NONE) {
+      if (!_stream_domain_objects(stream)) {
+        return TELNET_RESULT_CONTINOUS;
+      }
+      stream->object = NETJSON_OBJECT_NONE;
+    }
 
-  next = con->parameter;
-  if (next && *next) {
-    if ((ptr = str_hasnextword(next, JSON_NAME_FILTER))) {
-      _handle_filter(&session, ptr);
+    if (stream->next == NULL || *stream->next == 0) {
+      if (stream->error) {
+        _create_error_json(&stream->session, "Could not parse sub-command for netjsoninfo", stream->parameter);
+      }
+      if (!stream->filter) {
+        json_end_array(&stream->session);
+        json_end_object(&stream->session);
+      }
+      return TELNET_RESULT_ACTIVE;
     }
-    else {
-      _handle_collection(&session, next);
+
+    stream->next = _handle_netjson_object(stream, stream->next);
+    if (stream->filter) {
+      /* filter only handles a single object */
+      stream->next = NULL;
     }
   }
+  return TELNET_RESULT_CONTINOUS;
+}
 
-  /* copy output into telnet buffer */
-  abuf_memcpy(con->out, abuf_getptr(&out), abuf_getlen(&out));
-  abuf_free(&out);
-  return TELNET_RESULT_ACTIVE;
+/**
+ * Free the state of a netjsoninfo stream
+ * @param con telnet connection
+ */
+static void
+_cb_stream_cleanup(struct oonf_telnet_data *con) {
+  struct _netjson_stream *stream = con->stream_data;
+
+  free(stream->parameter);
+  oonf_class_free(&_stream_class, stream);
 }
 
 /**
@@ -1327,3 +2099,294 @@ _print_json_netaddr(struct json_session *session, const char *key, const struct
 
   json_print(session, key, true, netaddr_to_string(&nbuf, addr));
 }
+
+/**
+ * Start the generation of a new fragment in the scratch buffer
+ * @param fragment_session json session for the fragment
+ * @return pointer to json session
+ */
+static struct json_session *
+_start_fragment(struct json_session *fragment_session) {
+  abuf_clear(&_fragment_buf);
+  json_init_session(fragment_session, &_fragment_buf);
+  return fragment_session;
+}
+
+/**
+ * Store the content of the scratch buffer as a fragment and append
+ * it to a json session
+ * @param session json session
+ * @param fragment pointer to fragment
+ * @param generation generation of the object the fragment was generated for
+ */
+static void
+_store_fragment(struct json_session *session, struct _netjson_fragment *fragment, uint32_t generation) {
+  char *text;
+  size_t length;
+
+  length = abuf_getlen(&_fragment_buf);
+  json_print_raw(session, abuf_getptr(&_fragment_buf), length);
+
+  if (length == 0) {
+    _free_fragment(fragment);
+    fragment->generation = generation;
+    fragment->valid = !abuf_has_failed(&_fragment_buf);
+    return;
+  }
+
+  if (abuf_has_failed(&_fragment_buf)) {
+    /* try again on the next request */
+    fragment->valid = false;
+    return;
+  }
+
+  text = realloc(fragment->text, length);
+  if (text == NULL) {
+    fragment->valid = false;
+    return;
+  }
+
+  memcpy(text, abuf_getptr(&_fragment_buf), length);
+  fragment->text = text;
+  fragment->length = length;
+  fragment->generation = generation;
+  fragment->valid = true;
+}
+
+/**
+ * @param fragment pointer to fragment
+ * @param generation current generation of the fragments object
+ * @return true if fragment can be used for output
+ */
+static bool
+_is_fragment_current(const struct _netjson_fragment *fragment, uint32_t generation) {
+  return fragment->valid && fragment->generation == generation;
+}
+
+/**
+ * Free the text of a fragment
+ * @param fragment pointer to fragment
+ */
+static void
+_free_fragment(struct _netjson_fragment *fragment) {
+  free(fragment->text);
+  fragment->text = NULL;
+  fragment->length = 0;
+  fragment->valid = false;
+}
+
+/**
+ * Get the fragment cache for the graph edges of a tc node
+ * @param node tc node
+ * @return pointer to fragment cache, NULL if the edges cannot be cached
+ */
+static struct _netjson_tc_node_cache *
+_get_tc_link_cache(struct olsrv2_tc_node *node) {
+  const struct netaddr *originator;
+  int af_type, idx;
+
+  /* the outgoing tree is taken from the routes, they must announce their changes */
+  if (!oonf_class_is_extension_registered(&_tc_node_cache_ext) ||
+      !oonf_class_is_extension_registered(&_route_cache_ext) || olsrv2_tc_is_node_virtual(node)) {
+    return NULL;
+  }
+
+  af_type = netaddr_get_address_family(&node->target.prefix.dst);
+  idx = af_type == AF_INET ? 0 : 1;
+  originator = olsrv2_originator_get(af_type);
+  if (netaddr_cmp(&_graph_originator[idx], originator) != 0) {
+    memcpy(&_graph_originator[idx], originator, sizeof(*originator));
+    _graph_originator_generation++;
+  }
+  return oonf_class_get_extension(&_tc_node_cache_ext, node);
+}
+
+/**
+ * Invalidate the graph edge fragments that depend on the routes
+ * to or over a tc node
+ * @param domain NHDP domain of the routes
+ * @param originator originator of the tc node
+ */
+static void
+_invalidate_tc_node_routes(struct nhdp_domain *domain, const struct netaddr *originator) {
+  struct _netjson_tc_node_cache *cache;
+  struct olsrv2_tc_node *node;
+
+  if (!oonf_class_is_extension_registered(&_tc_node_cache_ext) || netaddr_is_unspec(originator)) {
+    return;
+  }
+
+  node = olsrv2_tc_node_get(originator);
+  if (node) {
+    cache = oonf_class_get_extension(&_tc_node_cache_ext, node);
+    cache->route_generation[domain->index]++;
+  }
+}
+
+/**
+ * Free all fragments of the existing objects
+ */
+static void
+_free_cache(void) {
+  struct olsrv2_routing_entry *rtentry;
+  struct oonf_layer2_neigh *l2neigh;
+  struct oonf_layer2_net *l2net;
+  struct olsrv2_tc_node *node;
+  struct nhdp_domain *domain;
+
+  if (oonf_class_is_extension_registered(&_tc_node_cache_ext)) {
+    avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
+      _cb_tc_node_removed(node);
+    }
+  }
+  if (oonf_class_is_extension_registered(&_route_cache_ext)) {
+    list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+      avl_for_each_element(olsrv2_routing_get_tree(domain), rtentry, _node) {
+        _cb_route_removed(rtentry);
+      }
+    }
+  }
+  if (oonf_class_is_extension_registered(&_l2neigh_cache_ext)) {
+    avl_for_each_element(oonf_layer2_get_net_tree(), l2net, _node) {
+      avl_for_each_element(&l2net->neighbors, l2neigh, _node) {
+        _cb_l2neigh_removed(l2neigh);
+      }
+    }
+  }
+}
+
+/**
+ * Callback for added or changed tc nodes
+ * @param ptr tc node
+ */
+static void
+_cb_tc_node_changed(void *ptr) {
+  struct _netjson_tc_node_cache *cache;
+  struct olsrv2_tc_node *node = ptr;
+  struct olsrv2_tc_edge *edge;
+
+  cache = oonf_class_get_extension(&_tc_node_cache_ext, node);
+  cache->generation++;
+
+  /* the edges of the neighbors print the inverse costs of this node */
+  avl_for_each_element(&node->_edges, edge, _node) {
+    cache = oonf_class_get_extension(&_tc_node_cache_ext, edge->dst);
+    cache->edge_generation++;
+  }
+}
+
+/**
+ * Callback for removed tc nodes
+ * @param ptr tc node
+ */
+static void
+_cb_tc_node_removed(void *ptr) {
+  struct _netjson_tc_node_cache *cache;
+  int i;
+
+  _cb_tc_node_changed(ptr);
+
+  cache = oonf_class_get_extension(&_tc_node_cache_ext, ptr);
+  _free_fragment(&cache->nodes);
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    _free_fragment(&cache->edges[i]);
+    _free_fragment(&cache->attachments[i]);
+  }
+}
+
+/**
+ * Callback for added or removed attached networks
+ * @param ptr tc attachment
+ */
+static void
+_cb_tc_attached_changed(void *ptr) {
+  struct olsrv2_tc_attachment *attached = ptr;
+
+  _cb_tc_node_changed(attached->src);
+}
+
+/**
+ * Callback for added routing entries and changed originators of
+ * routing entries
+ * @param ptr routing entry
+ */
+static void
+_cb_route_changed(void *ptr) {
+  struct olsrv2_routing_entry *rtentry = ptr;
+  struct _netjson_route_cache *cache;
+
+  cache = oonf_class_get_extension(&_route_cache_ext, rtentry);
+
+  /* the outgoing tree of the old and the new originators changed */
+  _invalidate_tc_node_routes(rtentry->domain, &cache->graph_originator);
+  _invalidate_tc_node_routes(rtentry->domain, &cache->graph_last_originator);
+
+  memcpy(&cache->graph_originator, &rtentry->originator, sizeof(cache->graph_originator));
+  memcpy(&cache->graph_last_originator, &rtentry->last_originator, sizeof(cache->graph_last_originator));
+
+  _invalidate_tc_node_routes(rtentry->domain, &cache->graph_originator);
+  _invalidate_tc_node_routes(rtentry->domain, &cache->graph_last_originator);
+}
+
+/**
+ * Callback for removed routing entries
+ * @param ptr routing entry
+ */
+static void
+_cb_route_removed(void *ptr) {
+  struct olsrv2_routing_entry *rtentry = ptr;
+  struct _netjson_route_cache *cache;
+
+  cache = oonf_class_get_extension(&_route_cache_ext, rtentry);
+  _invalidate_tc_node_routes(rtentry->domain, &cache->graph_originator);
+  _invalidate_tc_node_routes(rtentry->domain, &cache->graph_last_originator);
+  _free_fragment(&cache->route);
+}
+
+/**
+ * Callback for added or changed layer2 neighbors
+ * @param ptr layer2 neighbor
+ */
+static void
+_cb_l2neigh_changed(void *ptr) {
+  struct _netjson_l2neigh_cache *cache;
+
+  cache = oonf_class_get_extension(&_l2neigh_cache_ext, ptr);
+  cache->generation++;
+}
+
+/**
+ * Callback for removed layer2 neighbors
+ * @param ptr layer2 neighbor
+ */
+static void
+_cb_l2neigh_removed(void *ptr) {
+  struct _netjson_l2neigh_cache *cache;
+
+  cache = oonf_class_get_extension(&_l2neigh_cache_ext, ptr);
+  cache->generation++;
+  _free_fragment(&cache->head);
+  _free_fragment(&cache->data);
+}
+
+/**
+ * Callback for added or removed layer2 destinations
+ * @param ptr layer2 destination
+ */
+static void
+_cb_l2dst_changed(void *ptr) {
+  struct oonf_layer2_destination *l2dst = ptr;
+
+  _cb_l2neigh_changed(l2dst->neighbor);
+}
+
+/**
+ * Callback for added or removed layer2 neighbor addresses
+ * @param ptr layer2 neighbor address
+ */
+static void
+_cb_l2neigh_addr_changed(void *ptr) {
+  struct oonf_layer2_neighbor_address *l2naddr = ptr;
+
+  _cb_l2neigh_changed(l2naddr->l2neigh);
+}
@@ -44,6 +44,7 @@
  */
 
 #include <errno.h>
+#include <limits.h>
 
 #include <oonf/libcommon/avl.h>
 #include <oonf/oonf.h>
@@ -51,6 +52,7 @@
 #include <oonf/libcommon/netaddr.h>
 #include <oonf/libcommon/netaddr_acl.h>
 #include <oonf/libconfig/cfg_schema.h>
+#include <oonf/libconfig/cfg_tobin.h>
 #include <oonf/libcore/oonf_logging.h>
 #include <oonf/libcore/oonf_subsystem.h>
 #include <oonf/base/oonf_rfc5444.h>
@@ -65,6 +67,7 @@
 #include <oonf/olsrv2/olsrv2/olsrv2_originator.h>
 #include <oonf/olsrv2/olsrv2/olsrv2_reader.h>
 #include <oonf/olsrv2/olsrv2/olsrv2_tc.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_warm_restart.h>
 #include <oonf/olsrv2/olsrv2/olsrv2_writer.h>
 
 /* definitions */
@@ -72,6 +75,9 @@
 /*! configuration option for locally attached networks */
 #define _LOCAL_ATTACHED_NETWORK_KEY "lan"
 
+/*! configuration option for fisheye TC schedule */
+#define _FISHEYE_KEY "fisheye"
+
 /**
  * Default values for locally attached network parameters
  */
@@ -113,6 +119,12 @@ struct _config {
   /*! olsrv2 factor of a_hold_time in terms of tc_intervals */
   uint64_t a_hold_time_factor;
 
+  /*! every n-th TC is complete, all others are differential */
+  int32_t differential_tc_factor;
+
+  /*! throttling parameters of dijkstra calculation */
+  struct olsrv2_routing_throttling dijkstra;
+
   /*! decides NHDP routable status */
   bool nhdp_routable;
 
@@ -121,6 +133,12 @@ struct _config {
 
   /*! IP filter for valid originator */
   struct netaddr_acl originator_acl;
+
+  /*! snapshot file for warm restarts, empty if disabled */
+  char warm_restart_file[PATH_MAX];
+
+  /*! validity of restored topology and adopted kernel routes */
+  uint64_t warm_restart_validity;
 };
 
 /**
@@ -147,6 +165,10 @@ static void _initiate_shutdown(void);
 static void _cleanup(void);
 
 static void _cb_generate_tc(struct oonf_timer_instance *);
+static bool _is_differential_tc_supported(void);
+static void _cb_warm_restart(struct oonf_timer_instance *);
+static struct olsrv2_fisheye_scope *_get_next_fisheye_scope(void);
+static void _parse_fisheye_schedule(void);
 
 static void _update_originator(int af_family);
 static int _cb_if_event(struct os_interface_listener *);
@@ -165,6 +187,18 @@ static struct cfg_schema_entry _rt_domain_entries[] = {
     olsrv2_routing_domain, distance, "distance", "2", "Metric Distance to be used in routing table", 0, 1, 255),
   CFG_MAP_BOOL(
     olsrv2_routing_domain, source_specific, "source_specific", "true", "This domain uses IPv6 source specific routing"),
+  CFG_MAP_BOOL(olsrv2_routing_domain, use_nexthop_objects, "nexthop_objects", "false",
+    "Install one kernel nexthop object per first hop neighbor and interface and let the routes reference it,"
+    " so a changed gateway address of a neighbor only updates the nexthop object. Falls back to normal routes"
+    " if the kernel does not support nexthop objects."),
+  CFG_MAP_INT32_MINMAX(olsrv2_routing_domain, multipath, "multipath", "1",
+    "Maximum number of next hops of a route. Values larger than 1 install equal-cost (or weighted) multipath"
+    " routes over loop-free alternative first hops.",
+    0, 1, OS_ROUTE_MAX_MULTIPATH),
+  CFG_MAP_INT32_MINMAX(olsrv2_routing_domain, multipath_tolerance, "multipath_tolerance", "0",
+    "Percentage an alternative path may be more expensive than the best one to be used in a multipath route."
+    " Next hops are weighted inverse to their path cost.",
+    0, 0, 100),
 };
 
 static struct cfg_schema_section _rt_domain_section = {
@@ -175,6 +209,12 @@ static struct cfg_schema_section _rt_domain_section = {
   .entry_count = ARRAYSIZE(_rt_domain_entries),
 };
 
+static struct cfg_schema_entry _fisheye_entry[] = {
+  CFG_MAP_INT32_MINMAX(olsrv2_fisheye_scope, hop_limit, "hop_limit", "255", "Hop limit of TCs of this scope", 0, 1, 255),
+  CFG_MAP_INT32_MINMAX(olsrv2_fisheye_scope, multiplier, "multiplier", "1",
+    "TCs of this scope are generated every n-th TC interval", 0, 1, 255),
+};
+
 static struct cfg_schema_entry _olsrv2_entries[] = {
   CFG_MAP_CLOCK_MIN(_config, tc_interval, "tc_interval", "5.0", "Time between two TC messages", 100),
   CFG_MAP_CLOCK_MIN(_config, tc_validity, "tc_validity", "300.0", "Validity time of a TC messages", 100),
@@ -183,6 +223,21 @@ static struct cfg_schema_entry _olsrv2_entries[] = {
     _config, p_hold_time, "processing_hold_time", "300.0", "Holdtime for processing set information", 100),
   CFG_MAP_INT64_MINMAX(_config, a_hold_time_factor, "advertisement_hold_time_factor", "3",
     "Holdtime for TC advertisements as a factor of TC interval time", false, 1, 255),
+  CFG_MAP_INT32_MINMAX(_config, differential_tc_factor, "differential_tc_factor", "0",
+    "Every n-th full range TC advertises the complete neighbor set, all other TCs only advertise the changes"
+    " since the last complete TC. TCs of smaller fisheye scopes are always differential."
+    " 0 or 1 disables differential TCs. All nodes of the mesh must run a release that understands differential TCs,"
+    " older releases take them for complete TCs and drop the unchanged links. Differential TCs are only sent while"
+    " all symmetric neighbors and all known routers announce this capability.",
+    0, 0, 255),
+  CFG_MAP_CLOCK(_config, dijkstra.initial_delay, "dijkstra_initial_delay", "0.0",
+    "Delay between the first topology change after a quiet period and the dijkstra calculation"),
+  CFG_MAP_CLOCK_MIN(_config, dijkstra.hold_time, "dijkstra_hold_time", "1.0",
+    "Minimum time between two dijkstra calculations, doubled with every calculation during topology churn", 10),
+  CFG_MAP_CLOCK_MIN(_config, dijkstra.max_hold_time, "dijkstra_max_hold_time", "5.0",
+    "Maximum time between two dijkstra calculations", 10),
+  CFG_MAP_CLOCK_MIN(_config, dijkstra.quiet_period, "dijkstra_quiet_period", "10.0",
+    "Time without dijkstra calculation after which the hold time is reset", 10),
   CFG_MAP_BOOL(_config, nhdp_routable, "nhdp_routable", "no",
     "Decides if NHDP interface addresses"
     " are routed to other nodes. 'true' means the 'routable_acl' parameter"
@@ -194,6 +249,19 @@ static struct cfg_schema_entry _olsrv2_entries[] = {
     "Filter for router originator addresses (ipv4 and ipv6)"
     " from the interface addresses. Olsrv2 will prefer routable addresses"
     " over linklocal addresses and addresses from loopback over other interfaces."),
+  CFG_VALIDATE_TOKENS(_FISHEYE_KEY, "",
+    "Fisheye TC schedule, each entry is a hop limit and a TC interval multiplier."
+    " TCs are flooded with the largest scope whose multiplier divides the number of generated TCs,"
+    " the scope with the largest hop limit determines how far TCs travel at all."
+    " An empty schedule floods every TC through the whole network.",
+    _fisheye_entry, .list = true),
+  CFG_MAP_STRING_ARRAY(_config, warm_restart_file, "warm_restart_file", "",
+    "Snapshot file for warm restarts. If set, the topology database is saved on shutdown and the routes are"
+    " kept in the kernel. The next start restores the topology and adopts the routes until fresh information"
+    " has been received. An empty value disables warm restarts.",
+    PATH_MAX),
+  CFG_MAP_CLOCK_MIN(_config, warm_restart_validity, "warm_restart_validity", "30.0",
+    "Validity time of restored topology information and adopted kernel routes after a warm restart", 1000),
 };
 
 static struct cfg_schema_section _olsrv2_section = {
@@ -239,10 +307,21 @@ static struct oonf_timer_instance _tc_timer = {
   .class = &_tc_timer_class,
 };
 
+/* timer for restoring state after the configuration has been applied */
+static struct oonf_timer_class _warm_restart_timer_class = {
+  .name = "OLSRv2 warm restart",
+  .callback = _cb_warm_restart,
+};
+
+static struct oonf_timer_instance _warm_restart_timer = {
+  .class = &_warm_restart_timer_class,
+};
+
 /* global interface listener */
 static struct os_interface_listener _if_listener = {
   .name = OS_INTERFACE_ANY,
   .if_changed = _cb_if_event,
+  .change_mask = OS_INTERFACE_CHANGE_FLAGS | OS_INTERFACE_CHANGE_ADDRESS,
 };
 
 /* global variables */
@@ -254,6 +333,14 @@ static bool _generate_tcs = true;
 static uint64_t _overwrite_tc_interval;
 static uint64_t _overwrite_tc_validity;
 
+/* fisheye TC schedule, sorted by hop limit */
+static struct olsrv2_fisheye_scope _fisheye_scopes[OLSRV2_FISHEYE_MAX_SCOPES];
+static size_t _fisheye_scope_count;
+static uint32_t _fisheye_tc_count;
+
+/* number of full range TCs generated since differential TCs were enabled */
+static uint32_t _differential_tc_count;
+
 /* Additional logging sources, not static because used by other source files! */
 enum oonf_log_source LOG_OLSRV2;
 enum oonf_log_source LOG_OLSRV2_R;
@@ -300,7 +387,10 @@ _init(void) {
 
   /* initialize timer */
   oonf_timer_add(&_tc_timer_class);
+  oonf_timer_add(&_warm_restart_timer_class);
 
+  /* restore warm restart state after the startup configuration (including domains) has been applied */
+  oonf_timer_set(&_warm_restart_timer, 1);
   return 0;
 }
 
@@ -309,9 +399,16 @@ _init(void) {
  */
 static void
 _initiate_shutdown(void) {
+  bool keep_routes = false;
+
+  if (_olsrv2_config.warm_restart_file[0]) {
+    /* only keep the routes if the next instance can adopt them */
+    keep_routes = olsrv2_warm_restart_save(_olsrv2_config.warm_restart_file) == 0;
+  }
+
   olsrv2_writer_cleanup();
   olsrv2_reader_cleanup();
-  olsrv2_routing_initiate_shutdown();
+  olsrv2_routing_initiate_shutdown(keep_routes);
 }
 
 /**
@@ -322,6 +419,8 @@ _cleanup(void) {
   /* remove interface listener */
   os_interface_remove(&_if_listener);
 
+  oonf_timer_remove(&_warm_restart_timer_class);
+
   /* cleanup configuration */
   netaddr_acl_remove(&_olsrv2_config.routable_acl);
   netaddr_acl_remove(&_olsrv2_config.originator_acl);
@@ -557,12 +656,48 @@ olsrv2_set_tc_validity(uint64_t interval) {
   return old;
 }
 
+/**
+ * @param count pointer to size_t variable, will be set to the
+ *   number of fisheye scopes
+ * @return array of fisheye scopes sorted by hop limit,
+ *   empty if every TC is flooded through the whole network
+ */
+const struct olsrv2_fisheye_scope *
+olsrv2_get_fisheye_scopes(size_t *count) {
+  *count = _fisheye_scope_count;
+  return _fisheye_scopes;
+}
+
+/**
+ * Count a received TC in the fisheye scope statistics
+ * @param hop_limit hop limit the TC was originally sent with
+ */
+void
+olsrv2_fisheye_tc_received(int32_t hop_limit) {
+  size_t i;
+
+  if (_fisheye_scope_count == 0) {
+    return;
+  }
+
+  for (i = 0; i < _fisheye_scope_count - 1; i++) {
+    if (hop_limit <= _fisheye_scopes[i].hop_limit) {
+      break;
+    }
+  }
+  _fisheye_scopes[i].tc_received++;
+}
+
 /**
  * Callback to trigger normal tc generation with timer
  * @param ptr timer instance that fired
  */
 static void
 _cb_generate_tc(struct oonf_timer_instance *ptr __attribute__((unused))) {
+  struct olsrv2_fisheye_scope *scope = NULL;
+  uint8_t hop_limit, full_hop_limit;
+  bool differential;
+
   if (nhdp_domain_node_is_mpr() || !avl_is_empty(olsrv2_lan_get_tree())) {
     _unadvertised_tc_count = 0;
   }
@@ -570,9 +705,106 @@ _cb_generate_tc(struct oonf_timer_instance *ptr __attribute__((unused))) {
     _unadvertised_tc_count++;
   }
 
-  if (_unadvertised_tc_count <= _olsrv2_config.a_hold_time_factor) {
-    olsrv2_writer_send_tc();
+  if (_unadvertised_tc_count > _olsrv2_config.a_hold_time_factor) {
+    return;
+  }
+
+  if (_fisheye_scope_count == 0) {
+    hop_limit = 255;
+    full_hop_limit = 255;
+  }
+  else if ((scope = _get_next_fisheye_scope()) != NULL) {
+    OONF_DEBUG(LOG_OLSRV2, "Generate fisheye TC with hop limit %d", scope->hop_limit);
+    scope->tc_sent++;
+    hop_limit = scope->hop_limit;
+    full_hop_limit = _fisheye_scopes[_fisheye_scope_count - 1].hop_limit;
+  }
+  else {
+    /* no TC in this interval */
+    return;
+  }
+
+  differential = false;
+  if (_olsrv2_config.differential_tc_factor > 1 && !_is_differential_tc_supported()) {
+    /* restart with a complete full range TC as soon as all nodes support differential TCs */
+    _differential_tc_count = 0;
+  }
+  else if (_olsrv2_config.differential_tc_factor > 1) {
+    if (hop_limit < full_hop_limit) {
+      /*
+       * a complete TC becomes the baseline of the following differential
+       * TCs, so it must reach every node the full range TCs reach
+       */
+      differential = _differential_tc_count > 0;
+    }
+    else {
+      differential = (_differential_tc_count % (uint32_t)_olsrv2_config.differential_tc_factor) != 0;
+      _differential_tc_count++;
+    }
+  }
+
+  if (differential && scope != NULL) {
+    scope->differential_tc_sent++;
   }
+  olsrv2_writer_send_tc(hop_limit, differential);
+}
+
+/**
+ * Checks if all symmetric neighbors and all known routers have announced
+ * that they can process differential TCs. Routers running an older
+ * release would take a differential TC for a complete one.
+ * @return true if differential TCs can be sent
+ */
+static bool
+_is_differential_tc_supported(void) {
+  struct olsrv2_tc_node *node;
+
+  if (!olsrv2_reader_neighbors_support_differential_tcs()) {
+    return false;
+  }
+
+  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
+    if (!olsrv2_tc_is_node_virtual(node) && !node->differential_tcs) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Callback to restore the topology of the last instance after a warm
+ * restart and to reconcile the routing set with the kernel routes
+ * @param ptr timer instance that fired
+ */
+static void
+_cb_warm_restart(struct oonf_timer_instance *ptr __attribute__((unused))) {
+  uint64_t hold_time = 0;
+
+  if (_olsrv2_config.warm_restart_file[0] &&
+      olsrv2_warm_restart_load(_olsrv2_config.warm_restart_file, _olsrv2_config.warm_restart_validity) == 0) {
+    /* keep the routes of the last instance until the topology is complete again */
+    hold_time = _olsrv2_config.warm_restart_validity;
+  }
+  olsrv2_routing_reconcile_kernel_routes(hold_time);
+}
+
+/**
+ * Select the fisheye scope of the next generated TC
+ * @return largest scope whose multiplier divides the number of TC
+ *   intervals, NULL if no TC should be generated this interval
+ */
+static struct olsrv2_fisheye_scope *
+_get_next_fisheye_scope(void) {
+  uint32_t count;
+  size_t i;
+
+  count = _fisheye_tc_count++;
+  for (i = _fisheye_scope_count; i > 0; i--) {
+    if ((count % (uint32_t)_fisheye_scopes[i - 1].multiplier) == 0) {
+      return &_fisheye_scopes[i - 1];
+    }
+  }
+  return NULL;
 }
 
 static uint32_t
@@ -683,22 +915,92 @@ _update_originator(int af_family) {
  * @return always 0
  */
 static int
-_cb_if_event(struct os_interface_listener *if_listener __attribute__((unused))) {
-  _update_originator(AF_INET);
-  _update_originator(AF_INET6);
+_cb_if_event(struct os_interface_listener *if_listener) {
+  const uint32_t common = OS_INTERFACE_CHANGE_FLAGS | OS_INTERFACE_CHANGE_TRIGGER;
+
+  if (if_listener->changes & (common | OS_INTERFACE_CHANGE_IPV4)) {
+    _update_originator(AF_INET);
+  }
+  if (if_listener->changes & (common | OS_INTERFACE_CHANGE_IPV6)) {
+    _update_originator(AF_INET6);
+  }
   return 0;
 }
 
+/**
+ * Parse the fisheye TC schedule from the configuration and reset
+ * its statistics
+ */
+static void
+_parse_fisheye_schedule(void) {
+  struct olsrv2_fisheye_scope scope;
+  struct cfg_entry *entry;
+  const char *ptr;
+  size_t i;
+
+  _fisheye_scope_count = 0;
+  _fisheye_tc_count = 0;
+  memset(_fisheye_scopes, 0, sizeof(_fisheye_scopes));
+
+  entry = _olsrv2_section.post ? cfg_db_get_entry(_olsrv2_section.post, _FISHEYE_KEY) : NULL;
+  if (!entry) {
+    return;
+  }
+
+  strarray_for_each_element(&entry->val, ptr) {
+    memset(&scope, 0, sizeof(scope));
+    if (cfg_tobin_tokens(&scope, ptr, _fisheye_entry, ARRAYSIZE(_fisheye_entry), NULL)) {
+      OONF_WARN(LOG_OLSRV2, "Could not convert fisheye scope '%s' to binary", ptr);
+      continue;
+    }
+    if (_fisheye_scope_count == OLSRV2_FISHEYE_MAX_SCOPES) {
+      OONF_WARN(LOG_OLSRV2, "Too many fisheye scopes, ignoring '%s'", ptr);
+      continue;
+    }
+
+    /* insertion sort by hop limit */
+    for (i = _fisheye_scope_count; i > 0 && _fisheye_scopes[i - 1].hop_limit > scope.hop_limit; i--) {
+      _fisheye_scopes[i] = _fisheye_scopes[i - 1];
+    }
+    if (i > 0 && _fisheye_scopes[i - 1].hop_limit == scope.hop_limit) {
+      OONF_WARN(LOG_OLSRV2, "Duplicate fisheye hop limit %d, ignoring '%s'", scope.hop_limit, ptr);
+      memmove(&_fisheye_scopes[i], &_fisheye_scopes[i + 1], (_fisheye_scope_count - i) * sizeof(scope));
+      continue;
+    }
+    _fisheye_scopes[i] = scope;
+    _fisheye_scope_count++;
+  }
+
+  for (i = 1; i < _fisheye_scope_count; i++) {
+    if (_fisheye_scopes[i].multiplier <= _fisheye_scopes[i - 1].multiplier) {
+      OONF_WARN(LOG_OLSRV2, "Fisheye scope with hop limit %d should use a larger multiplier than %d",
+        _fisheye_scopes[i].hop_limit, _fisheye_scopes[i - 1].multiplier);
+    }
+  }
+}
+
 /**
  * Callback fired when olsrv2 section changed
  */
 static void
 _cb_cfg_olsrv2_changed(void) {
+  int32_t old_differential_factor;
+
+  old_differential_factor = _olsrv2_config.differential_tc_factor;
   if (cfg_schema_tobin(&_olsrv2_config, _olsrv2_section.post, _olsrv2_entries, ARRAYSIZE(_olsrv2_entries))) {
     OONF_WARN(LOG_OLSRV2, "Cannot convert OLSRV2 configuration.");
     return;
   }
 
+  _parse_fisheye_schedule();
+  olsrv2_routing_set_throttling(&_olsrv2_config.dijkstra);
+
+  if (old_differential_factor != _olsrv2_config.differential_tc_factor) {
+    /* next TC will be a complete one */
+    _differential_tc_count = 0;
+    olsrv2_writer_set_differential_tcs(_olsrv2_config.differential_tc_factor > 1);
+  }
+
   /* set tc timer interval */
   if (_generate_tcs && _overwrite_tc_interval == 0) {
     oonf_timer_set(&_tc_timer, _olsrv2_config.tc_interval);
@@ -45,13 +45,18 @@
 
 #include <oonf/libcommon/avl.h>
 #include <oonf/oonf.h>
+#include <oonf/libcommon/list.h>
 #include <oonf/libcommon/netaddr.h>
 #include <oonf/libcore/oonf_logging.h>
 #include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_class.h>
+#include <oonf/base/oonf_clock.h>
 #include <oonf/base/oonf_duplicate_set.h>
 #include <oonf/base/oonf_rfc5444.h>
 
+#include <oonf/nhdp/nhdp/nhdp_db.h>
 #include <oonf/nhdp/nhdp/nhdp_domain.h>
+#include <oonf/nhdp/nhdp/nhdp_interfaces.h>
 
 #include <oonf/olsrv2/olsrv2/olsrv2.h>
 #include <oonf/olsrv2/olsrv2/olsrv2_internal.h>
@@ -70,6 +75,13 @@ enum
   IDX_TLV_CONT_SEQ_NUM,
   IDX_TLV_MPRTYPES,
   IDX_TLV_SSR,
+  IDX_TLV_DIFF_TC,
+};
+
+/* HELLO message TLV array index */
+enum
+{
+  IDX_HELLO_TLV_DIFF_TC,
 };
 
 /* OLSRv2 address TLV array index pass 1 */
@@ -94,6 +106,12 @@ struct _olsrv2_data {
   /*! true if current TC is not fragmented */
   bool complete_tc;
 
+  /*! true if current TC only contains the changes since the last complete TC */
+  bool differential_tc;
+
+  /*! interval time of current TC */
+  uint64_t itime;
+
   /*! MPR type value of current TC */
   uint8_t mprtypes[NHDP_MAXIMUM_DOMAINS];
 
@@ -111,6 +129,10 @@ static enum rfc5444_result _cb_addresstlvs(struct rfc5444_reader_tlvblock_contex
 static void _handle_gateways(struct rfc5444_reader_tlvblock_entry *tlv, struct os_route_key *ssprefix,
   const uint32_t *cost_out, const struct netaddr *addr);
 static enum rfc5444_result _cb_messagetlvs_end(struct rfc5444_reader_tlvblock_context *context, bool dropped);
+static enum rfc5444_result _cb_hello_messagetlvs(struct rfc5444_reader_tlvblock_context *context);
+static bool _is_full_tc_round_over(void);
+static void _remove_outdated_entries(void);
+static bool _is_cost_infinite(const uint32_t *cost);
 
 /* definition of the RFC5444 reader components */
 static struct rfc5444_reader_tlvblock_consumer _olsrv2_message_consumer = {
@@ -148,6 +170,29 @@ static struct rfc5444_reader_tlvblock_consumer_entry _olsrv2_message_tlvs[] = {
   [IDX_TLV_SSR] = { .type = DRAFT_SSR_MSGTLV_CAPABILITY,
     .type_ext = DRAFT_SSR_MSGTLV_CAPABILITY_EXT,
     .match_type_ext = true },
+  [IDX_TLV_DIFF_TC] = { .type = DRAFT_DIFF_TC_MSGTLV_CAPABILITY,
+    .type_ext = DRAFT_DIFF_TC_MSGTLV_CAPABILITY_EXT,
+    .match_type_ext = true },
+};
+
+/* runs after NHDP has processed the HELLO and updated the link */
+static struct rfc5444_reader_tlvblock_consumer _olsrv2_hello_consumer = {
+  .order = RFC5444_MAIN_PARSER_PRIORITY + 2,
+  .msg_id = RFC6130_MSGTYPE_HELLO,
+  .block_callback = _cb_hello_messagetlvs,
+};
+
+static struct rfc5444_reader_tlvblock_consumer_entry _olsrv2_hello_tlvs[] = {
+  [IDX_HELLO_TLV_DIFF_TC] = { .type = DRAFT_DIFF_TC_MSGTLV_CAPABILITY,
+    .type_ext = DRAFT_DIFF_TC_MSGTLV_CAPABILITY_EXT,
+    .match_type_ext = true },
+};
+
+/* remember which neighbors announced that they can process differential TCs */
+static struct oonf_class_extension _neighbor_extension = {
+  .ext_name = "olsrv2 differential tc capability",
+  .class_name = NHDP_CLASS_NEIGHBOR,
+  .size = sizeof(bool),
 };
 
 static struct rfc5444_reader_tlvblock_consumer _olsrv2_address_consumer = {
@@ -193,6 +238,13 @@ olsrv2_reader_init(struct oonf_rfc5444_protocol *p) {
     &_protocol->reader, &_olsrv2_message_consumer, _olsrv2_message_tlvs, ARRAYSIZE(_olsrv2_message_tlvs));
   rfc5444_reader_add_message_consumer(
     &_protocol->reader, &_olsrv2_address_consumer, _olsrv2_address_tlvs, ARRAYSIZE(_olsrv2_address_tlvs));
+
+  if (oonf_class_extension_add(&_neighbor_extension)) {
+    OONF_WARN(LOG_OLSRV2_R, "Cannot track differential TC capability of neighbors");
+    return;
+  }
+  rfc5444_reader_add_message_consumer(
+    &_protocol->reader, &_olsrv2_hello_consumer, _olsrv2_hello_tlvs, ARRAYSIZE(_olsrv2_hello_tlvs));
 }
 
 /**
@@ -200,10 +252,36 @@ olsrv2_reader_init(struct oonf_rfc5444_protocol *p) {
  */
 void
 olsrv2_reader_cleanup(void) {
+  if (oonf_class_is_extension_registered(&_neighbor_extension)) {
+    rfc5444_reader_remove_message_consumer(&_protocol->reader, &_olsrv2_hello_consumer);
+    oonf_class_extension_remove(&_neighbor_extension);
+  }
   rfc5444_reader_remove_message_consumer(&_protocol->reader, &_olsrv2_address_consumer);
   rfc5444_reader_remove_message_consumer(&_protocol->reader, &_olsrv2_message_consumer);
 }
 
+/**
+ * @return true if all symmetric neighbors announced in their HELLOs
+ *   that they can process differential TCs
+ */
+bool
+olsrv2_reader_neighbors_support_differential_tcs(void) {
+  struct nhdp_neighbor *neigh;
+  bool *capable;
+
+  if (!oonf_class_is_extension_registered(&_neighbor_extension)) {
+    return false;
+  }
+
+  list_for_each_element(nhdp_db_get_neigh_list(), neigh, _global_node) {
+    capable = oonf_class_get_extension(&_neighbor_extension, neigh);
+    if (neigh->symmetric > 0 && !*capable) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /**
  * Callback that parses message TLVs of TC
  * @param context RFC5444 tlvblock reader context
@@ -259,12 +337,14 @@ _cb_messagetlvs(struct rfc5444_reader_tlvblock_context *context) {
   OONF_DEBUG(LOG_OLSRV2_R, "Originator: %s   Seqno: %u", netaddr_to_string(&buf, &context->orig_addr), context->seqno);
 
   /* get cont_seq_num extension */
-  tmp = _olsrv2_message_tlvs[IDX_TLV_CONT_SEQ_NUM].type_ext;
-  if (tmp != RFC7181_CONT_SEQ_NUM_COMPLETE && tmp != RFC7181_CONT_SEQ_NUM_INCOMPLETE) {
+  tmp = _olsrv2_message_tlvs[IDX_TLV_CONT_SEQ_NUM].tlv->type_ext;
+  if (tmp != RFC7181_CONT_SEQ_NUM_COMPLETE && tmp != RFC7181_CONT_SEQ_NUM_INCOMPLETE &&
+      tmp != (RFC7181_CONT_SEQ_NUM_INCOMPLETE | DRAFT_DIFF_TC_CONT_SEQ_NUM_DIFFERENTIAL)) {
     OONF_DEBUG(LOG_OLSRV2_R, "Illegal extension of CONT_SEQ_NUM TLV: %u", tmp);
     return RFC5444_DROP_MESSAGE;
   }
   _current.complete_tc = tmp == RFC7181_CONT_SEQ_NUM_COMPLETE;
+  _current.differential_tc = (tmp & DRAFT_DIFF_TC_CONT_SEQ_NUM_DIFFERENTIAL) != 0;
 
   /* get ANSN */
   memcpy(&ansn, _olsrv2_message_tlvs[IDX_TLV_CONT_SEQ_NUM].tlv->single_value, 2);
@@ -300,6 +380,11 @@ _cb_messagetlvs(struct rfc5444_reader_tlvblock_context *context) {
     return RFC5444_DROP_MSG_BUT_FORWARD;
   }
 
+  /* count TC in the scope of its original hop limit */
+  if (context->has_hoplimit && context->has_hopcount) {
+    olsrv2_fisheye_tc_received(context->hoplimit + context->hopcount);
+  }
+
   /* get tc node */
   _current.node = olsrv2_tc_node_add(&context->orig_addr, _current.vtime, ansn);
   if (_current.node == NULL) {
@@ -307,30 +392,32 @@ _cb_messagetlvs(struct rfc5444_reader_tlvblock_context *context) {
     return RFC5444_DROP_MSG_BUT_FORWARD;
   }
 
-  /* check if the topology information is recent enough */
-  if (_current.complete_tc) {
-    if (rfc5444_seqno_is_smaller(ansn, _current.node->ansn)) {
-      OONF_DEBUG(LOG_OLSRV2_R, "ANSN %u is smaller than last stored ANSN %u", ansn, _current.node->ansn);
-      return RFC5444_DROP_MSG_BUT_FORWARD;
-    }
-  }
-  else {
-    if (!rfc5444_seqno_is_larger(ansn, _current.node->ansn)) {
-      OONF_DEBUG(LOG_OLSRV2_R, "ANSN %u is smaller than last stored ANSN %u", ansn, _current.node->ansn);
-      return RFC5444_DROP_MSG_BUT_FORWARD;
-    }
+  /*
+   * check if the topology information is recent enough, incomplete TCs
+   * (fragments or differential TCs) of the current ANSN are still valid.
+   * The ANSN of restored information might be from an older instance of
+   * the originator.
+   */
+  if (!_current.node->restored && rfc5444_seqno_is_smaller(ansn, _current.node->ansn)) {
+    OONF_DEBUG(LOG_OLSRV2_R, "ANSN %u is smaller than last stored ANSN %u", ansn, _current.node->ansn);
+    return RFC5444_DROP_MSG_BUT_FORWARD;
   }
 
   /* overwrite old ansn */
   _current.node->ansn = ansn;
+  _current.node->restored = false;
 
   /* reset validity time and interval time */
   oonf_timer_set(&_current.node->_validity_time, _current.vtime);
   _current.node->interval_time = itime;
+  _current.itime = itime;
 
   /* set source-specific flags */
   _current.node->source_specific = _olsrv2_message_tlvs[IDX_TLV_SSR].tlv != NULL;
 
+  /* set differential TC capability of the node and its neighbors */
+  _current.node->differential_tcs = _olsrv2_message_tlvs[IDX_TLV_DIFF_TC].tlv != NULL;
+
   /* continue parsing the message */
   return RFC5444_OKAY;
 }
@@ -403,7 +490,7 @@ _cb_addresstlvs(struct rfc5444_reader_tlvblock_context *context __attribute__((u
             _current.changed[i] |= (edge->cost[i] != cost_out[i]);
             edge->cost[i] = cost_out[i];
           }
-          else if (_current.complete_tc) {
+          else {
             _current.changed[i] |= (edge->cost[i] != RFC7181_METRIC_INFINITE);
             edge->cost[i] = RFC7181_METRIC_INFINITE;
           }
@@ -411,7 +498,7 @@ _cb_addresstlvs(struct rfc5444_reader_tlvblock_context *context __attribute__((u
             _current.changed[i] |= (edge->inverse->cost[i] != cost_in[i]);
             edge->inverse->cost[i] = cost_in[i];
           }
-          else if (edge->inverse->virtual && _current.complete_tc) {
+          else if (edge->inverse->virtual) {
             _current.changed[i] |= (edge->inverse->cost[i] != RFC7181_METRIC_INFINITE);
             edge->inverse->cost[i] = RFC7181_METRIC_INFINITE;
           }
@@ -429,7 +516,7 @@ _cb_addresstlvs(struct rfc5444_reader_tlvblock_context *context __attribute__((u
             _current.changed[i] |= (end->cost[i] != cost_out[i]);
             end->cost[i] = cost_out[i];
           }
-          else if (_current.complete_tc) {
+          else {
             _current.changed[i] |= (end->cost[i] != RFC7181_METRIC_INFINITE);
             end->cost[i] = RFC7181_METRIC_INFINITE;
           }
@@ -548,15 +635,32 @@ _cb_messagetlvs_end(struct rfc5444_reader_tlvblock_context *context __attribute_
     return RFC5444_OKAY;
   }
 
-  avl_for_each_element_safe(&_current.node->_edges, edge, _node, edge_it) {
-    if (edge->ansn != _current.node->ansn) {
-      olsrv2_tc_edge_remove(edge);
+  if (_current.complete_tc) {
+    _remove_outdated_entries();
+  }
+  else if (!_current.differential_tc) {
+    /*
+     * fragment of a full TC, the addresses of the other fragments
+     * are only outdated when they were not refreshed by a whole round
+     * of fragments with the current ANSN.
+     */
+    if (_is_full_tc_round_over()) {
+      _remove_outdated_entries();
     }
   }
+  else {
+    /* differential TCs advertise removed addresses without metrics */
+    avl_for_each_element_safe(&_current.node->_edges, edge, _node, edge_it) {
+      if (!edge->virtual && edge->ansn == _current.node->ansn && _is_cost_infinite(edge->cost) &&
+          (!edge->inverse->virtual || _is_cost_infinite(edge->inverse->cost))) {
+        olsrv2_tc_edge_remove(edge);
+      }
+    }
 
-  avl_for_each_element_safe(&_current.node->_attached_networks, end, _src_node, end_it) {
-    if (end->ansn != _current.node->ansn) {
-      olsrv2_tc_endpoint_remove(end);
+    avl_for_each_element_safe(&_current.node->_attached_networks, end, _src_node, end_it) {
+      if (end->ansn == _current.node->ansn && _is_cost_infinite(end->cost)) {
+        olsrv2_tc_endpoint_remove(end);
+      }
     }
   }
 
@@ -590,3 +694,93 @@ _cb_messagetlvs_end(struct rfc5444_reader_tlvblock_context *context __attribute_
 
   return RFC5444_OKAY;
 }
+
+/**
+ * Callback that remembers if the neighbor sending a HELLO
+ * can process differential TCs
+ * @param context RFC5444 tlvblock reader context
+ * @return see rfc5444_result enum
+ */
+static enum rfc5444_result
+_cb_hello_messagetlvs(struct rfc5444_reader_tlvblock_context *context __attribute__((unused))) {
+  struct nhdp_interface *interf;
+  struct nhdp_laddr *laddr;
+  bool *capable;
+
+  interf = nhdp_interface_get(_protocol->input.interface->name);
+  if (interf == NULL) {
+    return RFC5444_OKAY;
+  }
+
+  /* NHDP has added the source address to the link of the neighbor */
+  laddr = nhdp_interface_get_link_addr(interf, _protocol->input.src_address);
+  if (laddr == NULL) {
+    return RFC5444_OKAY;
+  }
+
+  capable = oonf_class_get_extension(&_neighbor_extension, laddr->link->neigh);
+  *capable = _olsrv2_hello_tlvs[IDX_HELLO_TLV_DIFF_TC].tlv != NULL;
+  return RFC5444_OKAY;
+}
+
+/**
+ * Check if all fragments of a full TC with the current ANSN have been
+ * received at least once. The fragments of a full TC are generated
+ * together, the first fragment of the next full TC arrives about
+ * one interval time later.
+ * @return true if the node received a full TC with the current ANSN
+ *   in an earlier round
+ */
+static bool
+_is_full_tc_round_over(void) {
+  uint64_t round_time;
+
+  if (_current.node->_full_tc_time == 0 || _current.node->_full_tc_ansn != _current.node->ansn) {
+    /* first fragment of a full TC with this ANSN */
+    _current.node->_full_tc_ansn = _current.node->ansn;
+    _current.node->_full_tc_time = oonf_clock_getNow();
+    return false;
+  }
+
+  /* fall back to the validity time if the originator does not report its interval */
+  round_time = _current.itime ? _current.itime / 2 : _current.vtime / 4;
+  return oonf_clock_get_relative(_current.node->_full_tc_time) <= -(int64_t)round_time;
+}
+
+/**
+ * Remove all edges and attached networks of the current node
+ * which have not been advertised with the current ANSN
+ */
+static void
+_remove_outdated_entries(void) {
+  struct olsrv2_tc_edge *edge, *edge_it;
+  struct olsrv2_tc_attachment *end, *end_it;
+
+  avl_for_each_element_safe(&_current.node->_edges, edge, _node, edge_it) {
+    if (edge->ansn != _current.node->ansn) {
+      olsrv2_tc_edge_remove(edge);
+    }
+  }
+
+  avl_for_each_element_safe(&_current.node->_attached_networks, end, _src_node, end_it) {
+    if (end->ansn != _current.node->ansn) {
+      olsrv2_tc_endpoint_remove(end);
+    }
+  }
+}
+
+/**
+ * @param cost array of costs for all domains
+ * @return true if the cost is infinite for all domains
+ */
+static bool
+_is_cost_infinite(const uint32_t *cost) {
+  size_t i;
+
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    if (cost[i] <= RFC7181_METRIC_MAX) {
+      return false;
+    }
+  }
+  return true;
+}
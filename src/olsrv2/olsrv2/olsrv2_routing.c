@@ -44,6 +44,7 @@
  */
 
 #include <errno.h>
+#include <stdlib.h>
 
 #include <oonf/libcommon/avl.h>
 #include <oonf/libcommon/avl_comp.h>
@@ -53,8 +54,10 @@
 #include <oonf/libcore/oonf_logging.h>
 #include <oonf/libcore/os_core.h>
 #include <oonf/base/oonf_class.h>
+#include <oonf/base/oonf_clock.h>
 #include <oonf/base/oonf_rfc5444.h>
 #include <oonf/base/oonf_timer.h>
+#include <oonf/base/os_clock.h>
 #include <oonf/base/os_routing.h>
 
 #include <oonf/nhdp/nhdp/nhdp_db.h>
@@ -68,37 +71,90 @@
 #include <oonf/olsrv2/olsrv2/olsrv2_routing.h>
 #include <oonf/olsrv2/olsrv2/olsrv2_tc.h>
 
+/**
+ * Link of the dijkstra adjacency shared by all domains,
+ * the costs of all domains are stored next to each other
+ */
+struct _dijkstra_link {
+  /*! tc node or endpoint at the end of the link */
+  struct olsrv2_tc_target *dst;
+
+  /*! link cost for each domain */
+  uint32_t cost[NHDP_MAXIMUM_DOMAINS];
+
+  /*! hopcount of attached network for each domain */
+  uint8_t distance[NHDP_MAXIMUM_DOMAINS];
+
+  /*! true if link is an attachment of a network or address */
+  bool attachment;
+
+  /*! true if attached endpoint can be reached through multiple nodes */
+  bool shared;
+};
+
 /* Prototypes */
-static void _run_dijkstra(struct nhdp_domain *domain, int af_family, bool use_non_ss, bool use_ss);
+static int _prepare_topology(void);
+static void _run_dijkstra(struct nhdp_domain *domain, int af_family, bool split);
 static struct olsrv2_routing_entry *_add_entry(struct nhdp_domain *, struct os_route_key *prefix);
 static void _remove_entry(struct olsrv2_routing_entry *);
-static void _insert_into_working_tree(struct olsrv2_tc_target *target, struct nhdp_neighbor *neigh, uint32_t linkcost,
-  uint32_t path_cost, uint8_t path_hops, uint8_t distance, bool single_hop, const struct netaddr *last_originator);
+static void _insert_into_working_tree(struct nhdp_domain *domain, struct olsrv2_tc_target *target, bool ss,
+  struct nhdp_neighbor *neigh, const struct olsrv2_dijkstra_node *via, uint32_t linkcost, uint32_t path_cost,
+  uint8_t path_hops, uint8_t distance, bool single_hop, const struct netaddr *last_originator);
+static void _update_multipath(struct nhdp_domain *domain, struct olsrv2_dijkstra_node *node,
+  struct olsrv2_dijkstra_path *candidate, const struct olsrv2_dijkstra_node *via, uint32_t link_cost);
+static void _add_multipath_candidate(struct nhdp_domain *domain, struct olsrv2_dijkstra_node *node,
+  struct nhdp_neighbor *first_hop, uint32_t path_cost);
+static void _update_routing_entry(struct nhdp_domain *domain, struct os_route_key *dst_prefix,
+  const struct netaddr *dst_originator, struct nhdp_neighbor *first_hop, const struct olsrv2_dijkstra_node *via,
+  uint32_t via_cost, uint8_t distance, uint32_t pathcost, uint8_t path_hops, bool single_hop,
+  const struct netaddr *last_originator);
+static void _set_multipath(struct nhdp_domain *domain, struct olsrv2_routing_entry *rtentry,
+  const struct olsrv2_dijkstra_node *via, uint32_t via_cost);
 static void _prepare_routes(struct nhdp_domain *);
 static void _prepare_nodes(void);
+static struct olsrv2_dijkstra_node *_get_dijkstra_node(struct olsrv2_tc_target *target, bool ss);
 static bool _check_ssnode_split(struct nhdp_domain *domain, int af_family);
-static void _add_one_hop_nodes(struct nhdp_domain *domain, int family, bool, bool);
-static void _handle_working_queue(struct nhdp_domain *, bool, bool);
+static void _add_one_hop_nodes(struct nhdp_domain *domain, int family, bool split);
+static void _handle_working_queue(struct nhdp_domain *, bool split);
 static void _handle_nhdp_routes(struct nhdp_domain *);
 static void _add_route_to_kernel_queue(struct olsrv2_routing_entry *rtentry);
 static void _process_dijkstra_result(struct nhdp_domain *);
 static void _process_kernel_queue(void);
+static void _update_hold_time(void);
+static void _update_nexthop(struct olsrv2_routing_entry *rtentry);
+static struct olsrv2_routing_nexthop *_add_nexthop(struct olsrv2_routing_entry *rtentry);
+static void _remove_nexthop(struct olsrv2_routing_nexthop *nexthop);
+static bool _is_route_unchanged(struct olsrv2_routing_entry *rtentry);
+static int _avlcmp_nexthop_key(const void *, const void *);
 
 static void _cb_mpr_update(struct nhdp_domain *);
 static void _cb_metric_update(struct nhdp_domain *);
 static void _cb_trigger_dijkstra(struct oonf_timer_instance *);
 
 static void _cb_route_finished(struct os_route *route, int error);
+static void _reconcile_domain(struct nhdp_domain *domain);
+static bool _is_reconciliation_running(void);
+static void _cb_reconcile_route(struct os_route *filter, struct os_route *route);
+static void _adopt_kernel_route(struct olsrv2_routing_entry *rtentry, const struct os_route_parameter *param);
+static void _cb_reconcile_finished(struct os_route *filter, int error);
+static void _cb_adoption_timeout(struct oonf_timer_instance *);
+static void _cb_nexthop_finished(struct os_route_nexthop *os_nexthop, int error);
 
 /* Domain parameter of dijkstra algorithm */
 static struct olsrv2_routing_domain _domain_parameter[NHDP_MAXIMUM_DOMAINS];
 
 /* memory class for routing entries */
 static struct oonf_class _rtset_entry = {
-  .name = "Olsrv2 Routing Set Entry",
+  .name = OLSRV2_CLASS_ROUTING_ENTRY,
   .size = sizeof(struct olsrv2_routing_entry),
 };
 
+/* memory class for kernel nexthop objects */
+static struct oonf_class _nexthop_class = {
+  .name = OLSRV2_CLASS_ROUTING_NEXTHOP,
+  .size = sizeof(struct olsrv2_routing_nexthop),
+};
+
 /* rate limitation for dijkstra algorithm */
 static struct oonf_timer_class _dijkstra_timer_info = {
   .name = "Dijkstra rate limit timer",
@@ -109,6 +165,27 @@ static struct oonf_timer_instance _rate_limit_timer = { .class = &_dijkstra_time
 
 static bool _trigger_dijkstra = false;
 
+/* hold time for kernel routes adopted after a warm restart */
+static struct oonf_timer_class _adoption_timer_info = {
+  .name = "Adopted kernel route hold timer",
+  .callback = _cb_adoption_timeout,
+};
+
+static struct oonf_timer_instance _adoption_timer = { .class = &_adoption_timer_info };
+
+/* kernel route queries for reconciling the routing set with the kernel */
+static struct os_route _reconcile_query[NHDP_MAXIMUM_DOMAINS];
+
+/* parameters and statistics of dijkstra throttling */
+static struct olsrv2_routing_throttling _throttling = {
+  .initial_delay = 1,
+  .hold_time = 1000,
+  .max_hold_time = 1000,
+  .quiet_period = 1000,
+};
+static struct olsrv2_routing_statistics _statistics;
+static uint64_t _last_dijkstra;
+
 /* callback for NHDP domain events */
 static struct nhdp_domain_listener _nhdp_listener = {
   .mpr_update = _cb_mpr_update,
@@ -127,6 +204,22 @@ static struct list_entity _routing_filter_list;
 static struct avl_tree _dijkstra_working_tree;
 static struct list_entity _kernel_queue;
 
+/* adjacency of the tc graph, built once for all domains of a dijkstra run */
+static struct _dijkstra_link *_dijkstra_links;
+static size_t _dijkstra_link_capacity;
+
+/* number of (source-specific) tc nodes per address family and source-specific prefixes per domain */
+static uint32_t _tc_node_count[2], _ss_node_count[2];
+static bool _ss_prefix[NHDP_MAXIMUM_DOMAINS];
+
+/* identifier of the current dijkstra run, dijkstra nodes of other runs are reset on access */
+static uint32_t _dijkstra_run;
+
+/* kernel nexthop objects */
+static struct avl_tree _nexthop_tree;
+static struct list_entity _removed_nexthops;
+static bool _nexthop_objects_failed = false;
+
 static bool _initiate_shutdown = false;
 static bool _freeze_routes = false;
 
@@ -147,7 +240,9 @@ olsrv2_routing_init(void) {
   _update_ansn = false;
 
   oonf_class_add(&_rtset_entry);
+  oonf_class_add(&_nexthop_class);
   oonf_timer_add(&_dijkstra_timer_info);
+  oonf_timer_add(&_adoption_timer_info);
 
   for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
     avl_init(&_routing_tree[i], os_routing_avl_cmp_route_key, false);
@@ -155,16 +250,21 @@ olsrv2_routing_init(void) {
   list_init_head(&_routing_filter_list);
   avl_init(&_dijkstra_working_tree, avl_comp_uint32, true);
   list_init_head(&_kernel_queue);
+  avl_init(&_nexthop_tree, _avlcmp_nexthop_key, false);
+  list_init_head(&_removed_nexthops);
 
   return 0;
 }
 
 /**
  * Trigger cleanup of olsrv2 dijkstra and routing code
+ * @param keep_routes true to leave the routes in the kernel for a warm restart,
+ *   routes using kernel nexthop objects are removed anyways
  */
 void
-olsrv2_routing_initiate_shutdown(void) {
+olsrv2_routing_initiate_shutdown(bool keep_routes) {
   struct olsrv2_routing_entry *entry, *e_it;
+  struct olsrv2_routing_nexthop *nexthop, *nh_it;
   int i;
 
   /* remember we are in shutdown */
@@ -179,14 +279,29 @@ olsrv2_routing_initiate_shutdown(void) {
       os_routing_interrupt(&entry->route);
       entry->route.cb_finished = _cb_route_finished;
 
-      if (entry->set) {
+      if (keep_routes && entry->route.p.nexthop_id == 0) {
+        /* leave route in kernel for the next instance */
+        continue;
+      }
+      if (entry->set || entry->adopted) {
         entry->set = false;
+        entry->adopted = false;
         _add_route_to_kernel_queue(entry);
       }
     }
   }
 
   _process_kernel_queue();
+
+  /* remove nexthop objects after the routes using them */
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    avl_for_each_element(&_routing_tree[i], entry, _node) {
+      entry->_nexthop = NULL;
+    }
+  }
+  avl_for_each_element_safe(&_nexthop_tree, nexthop, _node, nh_it) {
+    _remove_nexthop(nexthop);
+  }
 }
 
 /**
@@ -196,10 +311,19 @@ void
 olsrv2_routing_cleanup(void) {
   struct olsrv2_routing_entry *entry, *e_it;
   struct olsrv2_routing_filter *filter, *f_it;
+  struct olsrv2_routing_nexthop *nexthop, *nh_it;
   int i;
 
   nhdp_domain_listener_remove(&_nhdp_listener);
   oonf_timer_stop(&_rate_limit_timer);
+  oonf_timer_stop(&_adoption_timer);
+
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    if (os_routing_is_in_progress(&_reconcile_query[i])) {
+      _reconcile_query[i].cb_finished = NULL;
+      os_routing_interrupt(&_reconcile_query[i]);
+    }
+  }
 
   for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
     avl_for_each_element_safe(&_routing_tree[i], entry, _node, e_it) {
@@ -212,7 +336,25 @@ olsrv2_routing_cleanup(void) {
     olsrv2_routing_filter_remove(filter);
   }
 
+  avl_for_each_element_safe(&_nexthop_tree, nexthop, _node, nh_it) {
+    _remove_nexthop(nexthop);
+  }
+  list_for_each_element_safe(&_removed_nexthops, nexthop, _removed_node, nh_it) {
+    /* stop internal nexthop processing */
+    nexthop->os.cb_finished = NULL;
+    os_routing_nexthop_interrupt(&nexthop->os);
+
+    list_remove(&nexthop->_removed_node);
+    oonf_class_free(&_nexthop_class, nexthop);
+  }
+
+  free(_dijkstra_links);
+  _dijkstra_links = NULL;
+  _dijkstra_link_capacity = 0;
+
+  oonf_timer_remove(&_adoption_timer_info);
   oonf_timer_remove(&_dijkstra_timer_info);
+  oonf_class_remove(&_nexthop_class);
   oonf_class_remove(&_rtset_entry);
 }
 
@@ -234,20 +376,67 @@ olsrv2_routing_force_ansn_increment(uint16_t increment) {
 }
 
 /**
- * Trigger a new dijkstra as soon as we are back in the mainloop
- * (unless the rate limitation timer is active, then we will wait for it)
+ * Trigger a new dijkstra after the initial throttling delay
+ * (unless the hold timer is active, then we will wait for it)
  */
 void
 olsrv2_routing_trigger_update(void) {
   _trigger_dijkstra = true;
-  if (!oonf_timer_is_active(&_rate_limit_timer)) {
-    /* trigger as soon as we hit the next time slice */
-    oonf_timer_set(&_rate_limit_timer, 1);
+  if (oonf_timer_is_active(&_rate_limit_timer)) {
+    _statistics.deferred++;
+  }
+  else {
+    /* a delay of zero would stop the timer, so wait at least for the next time slice */
+    oonf_timer_set(&_rate_limit_timer, _throttling.initial_delay > 0 ? _throttling.initial_delay : 1);
   }
 
   OONF_DEBUG(LOG_OLSRV2_ROUTING, "Trigger routing update");
 }
 
+/**
+ * Set the parameters of the dijkstra throttling
+ * @param throttling pointer to new throttling parameters
+ */
+void
+olsrv2_routing_set_throttling(const struct olsrv2_routing_throttling *throttling) {
+  memcpy(&_throttling, throttling, sizeof(_throttling));
+
+  if (_throttling.max_hold_time < _throttling.hold_time) {
+    _throttling.max_hold_time = _throttling.hold_time;
+  }
+}
+
+/**
+ * @return statistics of the dijkstra runs
+ */
+const struct olsrv2_routing_statistics *
+olsrv2_routing_get_statistics(void) {
+  return &_statistics;
+}
+
+/**
+ * Dump the routes of all domains from the kernel once and use them as
+ * the known kernel state of the routing set. The next dijkstra only
+ * sends the differences to the kernel and removes stale routes.
+ * With a hold time the adopted routes are kept until the dijkstra
+ * confirms them or the hold time is over, which bridges the gap after
+ * a warm restart until NHDP and TC information are complete again.
+ * @param hold_time time until unconfirmed routes are removed,
+ *   0 to remove them with the next dijkstra
+ */
+void
+olsrv2_routing_reconcile_kernel_routes(uint64_t hold_time) {
+  struct nhdp_domain *domain;
+
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    _reconcile_domain(domain);
+  }
+
+  if (hold_time > 0) {
+    oonf_timer_set(&_adoption_timer, hold_time);
+  }
+}
+
 /**
  * Freeze all modifications of all OLSRv2 routing table
  * @param freeze true to freeze tables, false to update them to
@@ -302,18 +491,27 @@ olsrv2_routing_domain_changed(struct nhdp_domain *domain, bool autoupdate_ansn)
 void
 olsrv2_routing_force_update(bool skip_wait) {
   struct nhdp_domain *domain;
-  bool splitv4, splitv6;
+  uint64_t start_time, end_time;
+  bool changed;
+  int i;
 
   if (_initiate_shutdown || _freeze_routes) {
     /* no dijkstra anymore when in shutdown */
     return;
   }
 
+  if (_is_reconciliation_running()) {
+    /* wait for the kernel state, the end of the dump triggers the dijkstra */
+    _statistics.deferred++;
+    return;
+  }
+
   /* handle dijkstra rate limitation timer */
   if (oonf_timer_is_active(&_rate_limit_timer)) {
     if (!skip_wait) {
       /* trigger dijkstra later */
       _trigger_dijkstra = true;
+      _statistics.deferred++;
 
       OONF_DEBUG(LOG_OLSRV2_ROUTING, "Delay Dijkstra");
       return;
@@ -329,6 +527,20 @@ olsrv2_routing_force_update(bool skip_wait) {
 
   OONF_DEBUG(LOG_OLSRV2_ROUTING, "Run Dijkstra");
 
+  if (os_clock_gettime64_ns(&start_time)) {
+    start_time = 0;
+  }
+
+  /* traverse the topology database once for all domains */
+  changed = false;
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    changed |= _domain_changed[i];
+  }
+  if (changed && _prepare_topology()) {
+    OONF_WARN(LOG_OLSRV2_ROUTING, "Not enough memory for dijkstra adjacency");
+    return;
+  }
+
   list_for_each_element(nhdp_domain_get_list(), domain, _node) {
     /* check if dijkstra is necessary */
     if (!_domain_changed[domain->index]) {
@@ -341,26 +553,9 @@ olsrv2_routing_force_update(bool skip_wait) {
     _prepare_routes(domain);
     _prepare_nodes();
 
-    /* run IPv4 dijkstra (might be two times because of source-specific data) */
-    splitv4 = _check_ssnode_split(domain, AF_INET);
-    _run_dijkstra(domain, AF_INET, true, !splitv4);
-
-    /* run IPv6 dijkstra (might be two times because of source-specific data) */
-    splitv6 = _check_ssnode_split(domain, AF_INET6);
-    _run_dijkstra(domain, AF_INET6, true, !splitv6);
-
-    /* handle source-specific sub-topology if necessary */
-    if (splitv4 || splitv6) {
-      /* re-initialize dijkstra specific node fields */
-      _prepare_nodes();
-
-      if (splitv4) {
-        _run_dijkstra(domain, AF_INET, false, true);
-      }
-      if (splitv6) {
-        _run_dijkstra(domain, AF_INET6, false, true);
-      }
-    }
+    /* run IPv4 and IPv6 dijkstra, including the source-specific sub-topology if necessary */
+    _run_dijkstra(domain, AF_INET, _check_ssnode_split(domain, AF_INET));
+    _run_dijkstra(domain, AF_INET6, _check_ssnode_split(domain, AF_INET6));
 
     /* check if direct one-hop routes are quicker */
     _handle_nhdp_routes(domain);
@@ -371,8 +566,19 @@ olsrv2_routing_force_update(bool skip_wait) {
 
   _process_kernel_queue();
 
+  /* update statistics */
+  if (start_time != 0 && os_clock_gettime64_ns(&end_time) == 0) {
+    _statistics.last_duration = end_time - start_time;
+    _statistics.total_duration += _statistics.last_duration;
+    if (_statistics.last_duration > _statistics.max_duration) {
+      _statistics.max_duration = _statistics.last_duration;
+    }
+  }
+  _statistics.runs++;
+
   /* make sure dijkstra is not called too often */
-  oonf_timer_set(&_rate_limit_timer, OLSRv2_DIJKSTRA_RATE_LIMITATION);
+  _update_hold_time();
+  oonf_timer_set(&_rate_limit_timer, _statistics.hold_time);
 }
 
 /**
@@ -384,6 +590,7 @@ void
 olsrv2_routing_dijkstra_node_init(struct olsrv2_dijkstra_node *dijkstra, const struct netaddr *originator) {
   dijkstra->_node.key = &dijkstra->path_cost;
   dijkstra->originator = originator;
+  dijkstra->_run = 0;
 }
 
 /**
@@ -394,20 +601,37 @@ olsrv2_routing_dijkstra_node_init(struct olsrv2_dijkstra_node *dijkstra, const s
 void
 olsrv2_routing_set_domain_parameter(struct nhdp_domain *domain, struct olsrv2_routing_domain *parameter) {
   struct olsrv2_routing_entry *rtentry;
+  bool moved;
 
   if (memcmp(parameter, &_domain_parameter[domain->index], sizeof(*parameter)) == 0) {
     /* no change */
     return;
   }
 
+  /* table, protocol and metric are part of the kernel route identity */
+  moved = parameter->table != _domain_parameter[domain->index].table ||
+          parameter->protocol != _domain_parameter[domain->index].protocol ||
+          parameter->distance != _domain_parameter[domain->index].distance;
+
   /* copy parameters */
   memcpy(&_domain_parameter[domain->index], parameter, sizeof(*parameter));
 
+  if (parameter->use_nexthop_objects && !os_routing_supports_nexthop_objects()) {
+    OONF_WARN(LOG_OLSRV2_ROUTING, "Kernel does not support nexthop objects, domain %u uses normal routes",
+      domain->ext);
+  }
+
   if (avl_is_empty(&_routing_tree[domain->index])) {
     /* no routes present */
     return;
   }
 
+  if (!moved) {
+    /* the dijkstra only updates the routes that are affected by the change */
+    olsrv2_routing_domain_changed(domain, false);
+    return;
+  }
+
   /* remove old kernel routes */
   avl_for_each_element(&_routing_tree[domain->index], rtentry, _node) {
     if (rtentry->set) {
@@ -424,9 +648,9 @@ olsrv2_routing_set_domain_parameter(struct nhdp_domain *domain, struct olsrv2_ro
 
   _process_kernel_queue();
 
-  /* trigger a dijkstra to write new routes in 100 milliseconds */
-  oonf_timer_set(&_rate_limit_timer, 100);
-  _trigger_dijkstra = true;
+  /* read the new table before the dijkstra writes new routes */
+  _reconcile_domain(domain);
+  olsrv2_routing_domain_changed(domain, false);
 }
 
 /**
@@ -489,24 +713,26 @@ _cb_metric_update(struct nhdp_domain *domain) {
 }
 
 /**
- * Run Dijkstra for a set domain, address family and
- * (non-)source-specific nodes
+ * Run Dijkstra for a set domain and address family. If source-specific
+ * and non-source-specific targets are split, the paths through the
+ * source-specific sub-topology are calculated in the same pass with
+ * a second set of dijkstra nodes.
  * @param domain nhdp domain
  * @param af_family address family
- * @param use_non_ss dijkstra should include non-source-specific ndoes
- * @param use_ss dijkstra should include source-specific ndoes
+ * @param split true if source-specific targets must only be reached
+ *   through source-specific nodes
  */
 static void
-_run_dijkstra(struct nhdp_domain *domain, int af_family, bool use_non_ss, bool use_ss) {
-  OONF_INFO(LOG_OLSRV2_ROUTING, "Run %s dijkstra on domain %d: %s/%s", af_family == AF_INET ? "ipv4" : "ipv6",
-    domain->index, use_non_ss ? "true" : "false", use_ss ? "true" : "false");
+_run_dijkstra(struct nhdp_domain *domain, int af_family, bool split) {
+  OONF_INFO(LOG_OLSRV2_ROUTING, "Run %s dijkstra on domain %d: split %s", af_family == AF_INET ? "ipv4" : "ipv6",
+    domain->index, split ? "true" : "false");
 
   /* add direct neighbors to working queue */
-  _add_one_hop_nodes(domain, af_family, use_non_ss, use_ss);
+  _add_one_hop_nodes(domain, af_family, split);
 
   /* run dijkstra */
   while (!avl_is_empty(&_dijkstra_working_tree)) {
-    _handle_working_queue(domain, use_non_ss, use_ss);
+    _handle_working_queue(domain, split);
   }
 }
 
@@ -546,6 +772,8 @@ _add_entry(struct nhdp_domain *domain, struct os_route_key *prefix) {
   rtentry->route.p.type = OS_ROUTE_UNICAST;
 
   avl_insert(&_routing_tree[domain->index], &rtentry->_node);
+
+  oonf_class_event(&_rtset_entry, rtentry, OONF_OBJECT_ADDED);
   return rtentry;
 }
 
@@ -559,6 +787,13 @@ _remove_entry(struct olsrv2_routing_entry *entry) {
   entry->route.cb_finished = NULL;
   os_routing_interrupt(&entry->route);
 
+  /* release nexthop object */
+  if (entry->_nexthop) {
+    entry->_nexthop->usage--;
+  }
+
+  oonf_class_event(&_rtset_entry, entry, OONF_OBJECT_REMOVED);
+
   /* remove entry from database */
   avl_remove(&_routing_tree[entry->domain->index], &entry->_node);
   oonf_class_free(&_rtset_entry, entry);
@@ -566,18 +801,24 @@ _remove_entry(struct olsrv2_routing_entry *entry) {
 
 /**
  * Insert a new entry into the dijkstra working queue
+ * @param domain nhdp domain
  * @param target pointer to tc target
+ * @param ss true to use the dijkstra node of the source-specific sub-topology
  * @param neigh next hop through which the target can be reached
+ * @param via dijkstra node before the target, NULL for one-hop neighbors
  * @param link_cost cost of the last hop of the path towards the target
  * @param path_cost remainder of the cost to the target
+ * @param path_hops number of hops of the path before the target
  * @param distance hopcount to be used for the route to the target
  * @param single_hop true if this is a single-hop route, false otherwise
  * @param last_originator address of the last originator before we reached the
  *   destination prefix
  */
 static void
-_insert_into_working_tree(struct olsrv2_tc_target *target, struct nhdp_neighbor *neigh, uint32_t link_cost,
-  uint32_t path_cost, uint8_t path_hops, uint8_t distance, bool single_hop, const struct netaddr *last_originator) {
+_insert_into_working_tree(struct nhdp_domain *domain, struct olsrv2_tc_target *target, bool ss,
+  struct nhdp_neighbor *neigh, const struct olsrv2_dijkstra_node *via, uint32_t link_cost, uint32_t path_cost,
+  uint8_t path_hops, uint8_t distance, bool single_hop, const struct netaddr *last_originator) {
+  struct olsrv2_dijkstra_path other_path;
   struct olsrv2_dijkstra_node *node;
 #ifdef OONF_LOG_DEBUG_INFO
   struct netaddr_str nbuf1, nbuf2;
@@ -586,7 +827,7 @@ _insert_into_working_tree(struct olsrv2_tc_target *target, struct nhdp_neighbor
     return;
   }
 
-  node = &target->_dijkstra;
+  node = _get_dijkstra_node(target, ss);
 
   /*
    * do not add ourselves to working queue,
@@ -604,12 +845,23 @@ _insert_into_working_tree(struct olsrv2_tc_target *target, struct nhdp_neighbor
     /* node already in dijkstra working queue */
 
     if (node->path_cost <= path_cost) {
-      /* current path is shorter than new one */
+      /* current path is shorter than new one, but new one might be an alternative */
+      other_path.first_hop = neigh;
+      other_path.path_cost = path_cost;
+      _update_multipath(domain, node, &other_path, via, link_cost);
       return;
     }
 
     /* we found a better path, remove node from working queue */
     avl_remove(&_dijkstra_working_tree, &node->_node);
+
+    /* old path might still be an alternative */
+    other_path.first_hop = node->first_hop;
+    other_path.path_cost = node->path_cost;
+  }
+  else {
+    other_path.first_hop = NULL;
+    node->multipath_count = 0;
   }
 
   OONF_DEBUG(LOG_OLSRV2_ROUTING, "Add dst %s [%s] with pathcost %u to dijstra tree (0x%zx)",
@@ -623,16 +875,124 @@ _insert_into_working_tree(struct olsrv2_tc_target *target, struct nhdp_neighbor
   node->single_hop = single_hop;
   node->last_originator = last_originator;
 
+  _update_multipath(domain, node, other_path.first_hop ? &other_path : NULL, via, link_cost);
+
   avl_insert(&_dijkstra_working_tree, &node->_node);
   return;
 }
 
+/**
+ * Recalculate the alternative paths of a dijkstra node after a new
+ * path towards the node was found
+ * @param domain nhdp domain
+ * @param node dijkstra node
+ * @param candidate additional path that is not the primary one of the node, NULL if none
+ * @param via dijkstra node before the target, NULL for one-hop neighbors
+ * @param link_cost cost of the last hop of the path towards the target
+ */
+static void
+_update_multipath(struct nhdp_domain *domain, struct olsrv2_dijkstra_node *node,
+  struct olsrv2_dijkstra_path *candidate, const struct olsrv2_dijkstra_node *via, uint32_t link_cost) {
+  struct olsrv2_dijkstra_path old[OS_ROUTE_MAX_MULTIPATH - 1];
+  size_t i, count;
+
+  if (_domain_parameter[domain->index].multipath <= 1) {
+    return;
+  }
+
+  /* primary path might have changed, so check all old alternatives again */
+  count = node->multipath_count;
+  memcpy(old, node->multipath, sizeof(old[0]) * count);
+  node->multipath_count = 0;
+
+  for (i = 0; i < count; i++) {
+    _add_multipath_candidate(domain, node, old[i].first_hop, old[i].path_cost);
+  }
+  if (candidate) {
+    _add_multipath_candidate(domain, node, candidate->first_hop, candidate->path_cost);
+  }
+  if (via) {
+    /* alternatives of the previous node are alternatives of this one too */
+    for (i = 0; i < via->multipath_count; i++) {
+      _add_multipath_candidate(domain, node, via->multipath[i].first_hop, via->multipath[i].path_cost + link_cost);
+    }
+  }
+}
+
+/**
+ * Add a path to the alternatives of a dijkstra node if it is loop-free,
+ * not too expensive and uses a different first hop
+ * @param domain nhdp domain
+ * @param node dijkstra node
+ * @param first_hop first hop of the path
+ * @param path_cost total cost of the path
+ */
+static void
+_add_multipath_candidate(
+  struct nhdp_domain *domain, struct olsrv2_dijkstra_node *node, struct nhdp_neighbor *first_hop, uint32_t path_cost) {
+  struct olsrv2_routing_domain *param;
+  uint32_t neigh_cost;
+  size_t i, max_count;
+
+  param = &_domain_parameter[domain->index];
+  max_count = param->multipath - 1;
+
+  if (first_hop == node->first_hop) {
+    return;
+  }
+  if ((uint64_t)path_cost * 100 > (uint64_t)node->path_cost * (100 + param->multipath_tolerance)) {
+    /* path is too expensive */
+    return;
+  }
+
+  /* the first hop must be closer to the target than we are, otherwise the path might loop */
+  neigh_cost = nhdp_domain_get_neighbordata(domain, first_hop)->metric.out;
+  if (path_cost <= neigh_cost || path_cost - neigh_cost >= node->path_cost) {
+    return;
+  }
+
+  /* keep only the cheapest path through each first hop */
+  for (i = 0; i < node->multipath_count; i++) {
+    if (node->multipath[i].first_hop == first_hop) {
+      if (node->multipath[i].path_cost <= path_cost) {
+        return;
+      }
+      node->multipath_count--;
+      memmove(&node->multipath[i], &node->multipath[i + 1], sizeof(node->multipath[0]) * (node->multipath_count - i));
+      break;
+    }
+  }
+
+  /* keep alternatives sorted by path cost, use originator as tie breaker */
+  for (i = 0; i < node->multipath_count; i++) {
+    if (path_cost < node->multipath[i].path_cost ||
+        (path_cost == node->multipath[i].path_cost &&
+          netaddr_cmp(&first_hop->originator, &node->multipath[i].first_hop->originator) < 0)) {
+      break;
+    }
+  }
+  if (i >= max_count) {
+    return;
+  }
+
+  if (node->multipath_count == max_count) {
+    /* drop most expensive alternative */
+    node->multipath_count--;
+  }
+  memmove(&node->multipath[i + 1], &node->multipath[i], sizeof(node->multipath[0]) * (node->multipath_count - i));
+  node->multipath[i].first_hop = first_hop;
+  node->multipath[i].path_cost = path_cost;
+  node->multipath_count++;
+}
+
 /**
  * Initialize a routing entry with the result of the dijkstra calculation
  * @param domain nhdp domain
  * @param dst_prefix routing destination prefix
  * @param dst_originator originator address of destination
  * @param first_hop nhdp neighbor for first hop to target
+ * @param via dijkstra node with alternative paths towards the target, NULL if none
+ * @param via_cost additional cost from the via node to the target
  * @param distance hopcount distance that should be used for route
  * @param pathcost pathcost to target
  * @param path_hops number of hops to the target
@@ -641,13 +1001,14 @@ _insert_into_working_tree(struct olsrv2_tc_target *target, struct nhdp_neighbor
  */
 static void
 _update_routing_entry(struct nhdp_domain *domain, struct os_route_key *dst_prefix, const struct netaddr *dst_originator,
-  struct nhdp_neighbor *first_hop, uint8_t distance, uint32_t pathcost, uint8_t path_hops, bool single_hop,
-  const struct netaddr *last_originator) {
+  struct nhdp_neighbor *first_hop, const struct olsrv2_dijkstra_node *via, uint32_t via_cost, uint8_t distance,
+  uint32_t pathcost, uint8_t path_hops, bool single_hop, const struct netaddr *last_originator) {
   struct nhdp_neighbor_domaindata *neighdata;
   struct olsrv2_routing_entry *rtentry;
   const struct netaddr *originator;
   struct olsrv2_lan_entry *lan;
   struct olsrv2_lan_domaindata *landata;
+  bool changed;
 #ifdef OONF_LOG_DEBUG_INFO
   struct netaddr_str nbuf1, nbuf2, nbuf3;
 #endif
@@ -707,6 +1068,10 @@ _update_routing_entry(struct nhdp_domain *domain, struct os_route_key *dst_prefi
     netaddr_to_string(&nbuf3, &first_hop->originator), domain->ext, pathcost,
     neighdata->best_out_link->local_if->os_if_listener.data->name);
 
+  /* the originators place the route in the routing tree, so their change is announced */
+  changed = netaddr_cmp(&rtentry->originator, dst_originator) != 0 ||
+            netaddr_cmp(&rtentry->last_originator, last_originator) != 0;
+
   /* remember originator */
   memcpy(&rtentry->originator, dst_originator, sizeof(struct netaddr));
 
@@ -716,6 +1081,10 @@ _update_routing_entry(struct nhdp_domain *domain, struct os_route_key *dst_prefi
   /* remember last originator */
   memcpy(&rtentry->last_originator, last_originator, sizeof(*last_originator));
 
+  if (changed) {
+    oonf_class_event(&_rtset_entry, rtentry, OONF_OBJECT_CHANGED);
+  }
+
   /* mark route as set */
   rtentry->set = true;
 
@@ -726,6 +1095,78 @@ _update_routing_entry(struct nhdp_domain *domain, struct os_route_key *dst_prefi
   else {
     memcpy(&rtentry->route.p.gw, &neighdata->best_out_link->if_addr, sizeof(struct netaddr));
   }
+
+  _set_multipath(domain, rtentry, via, via_cost);
+}
+
+/**
+ * Fill the multipath next hops of a routing entry with the primary
+ * path and the alternative paths of a dijkstra node
+ * @param domain nhdp domain
+ * @param rtentry routing entry with primary gateway and interface
+ * @param via dijkstra node with alternative paths towards the target, NULL if none
+ * @param via_cost additional cost from the via node to the target
+ */
+static void
+_set_multipath(struct nhdp_domain *domain, struct olsrv2_routing_entry *rtentry,
+  const struct olsrv2_dijkstra_node *via, uint32_t via_cost) {
+  struct nhdp_neighbor_domaindata *neighdata;
+  struct os_route_path *path;
+  const struct netaddr *gw;
+  uint64_t weight;
+  size_t i, j, count;
+
+  memset(rtentry->route.p.multipath, 0, sizeof(rtentry->route.p.multipath));
+  rtentry->route.p.multipath_count = 0;
+
+  if (via == NULL || via->multipath_count == 0 ||
+      netaddr_get_address_family(&rtentry->route.p.gw) == AF_UNSPEC) {
+    return;
+  }
+
+  /* primary path first, next hops are weighted relative to it */
+  path = &rtentry->route.p.multipath[0];
+  memcpy(&path->gw, &rtentry->route.p.gw, sizeof(path->gw));
+  path->if_index = rtentry->route.p.if_index;
+  path->weight = 100;
+  count = 1;
+
+  for (i = 0; i < via->multipath_count; i++) {
+    neighdata = nhdp_domain_get_neighbordata(domain, via->multipath[i].first_hop);
+    if (neighdata->best_out_link == NULL) {
+      continue;
+    }
+
+    gw = &neighdata->best_out_link->if_addr;
+    if (netaddr_get_address_family(gw) != netaddr_get_address_family(&rtentry->route.p.gw)) {
+      continue;
+    }
+
+    for (j = 0; j < count; j++) {
+      if (rtentry->route.p.multipath[j].if_index == neighdata->best_link_ifindex &&
+          netaddr_cmp(&rtentry->route.p.multipath[j].gw, gw) == 0) {
+        break;
+      }
+    }
+    if (j < count) {
+      /* duplicate next hop */
+      continue;
+    }
+
+    weight = (uint64_t)rtentry->path_cost * 100 / (via->multipath[i].path_cost + via_cost);
+
+    path = &rtentry->route.p.multipath[count++];
+    memcpy(&path->gw, gw, sizeof(path->gw));
+    path->if_index = neighdata->best_link_ifindex;
+    path->weight = weight > 0 ? weight : 1;
+  }
+
+  if (count > 1) {
+    rtentry->route.p.multipath_count = count;
+  }
+  else {
+    memset(rtentry->route.p.multipath, 0, sizeof(rtentry->route.p.multipath));
+  }
 }
 
 /**
@@ -743,29 +1184,113 @@ _prepare_routes(struct nhdp_domain *domain) {
 }
 
 /**
- * Initialize internal fields for dijkstra calculation
+ * Build the adjacency of the tc graph for all domains and count the
+ * (source-specific) nodes, so the per domain dijkstra runs do not
+ * need to traverse the topology database again.
+ * @return -1 if an out of memory error happened, 0 otherwise
  */
-static void
-_prepare_nodes(void) {
-  struct olsrv2_tc_endpoint *end;
+static int
+_prepare_topology(void) {
   struct olsrv2_tc_node *node;
+  struct olsrv2_tc_edge *edge;
+  struct olsrv2_tc_attachment *attached;
+  struct _dijkstra_link *link, *links;
+  size_t count;
+  int i, af;
+
+  /* calculate maximum size of adjacency */
+  count = 0;
+  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
+    count += node->_edges.count + node->_attached_networks.count;
+  }
 
-  /* initialize private dijkstra data on nodes */
+  if (count > _dijkstra_link_capacity) {
+    links = realloc(_dijkstra_links, sizeof(*links) * count);
+    if (links == NULL) {
+      return -1;
+    }
+    _dijkstra_links = links;
+    _dijkstra_link_capacity = count;
+  }
+
+  memset(_tc_node_count, 0, sizeof(_tc_node_count));
+  memset(_ss_node_count, 0, sizeof(_ss_node_count));
+  memset(_ss_prefix, 0, sizeof(_ss_prefix));
+
+  link = _dijkstra_links;
   avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
-    node->target._dijkstra.first_hop = NULL;
-    node->target._dijkstra.path_cost = RFC7181_METRIC_INFINITE_PATH;
-    node->target._dijkstra.path_hops = 255;
-    node->target._dijkstra.local = olsrv2_originator_is_local(&node->target.prefix.dst);
-    node->target._dijkstra.done = false;
+    af = netaddr_get_address_family(&node->target.prefix.dst) == AF_INET ? 0 : 1;
+    _tc_node_count[af]++;
+    if (node->source_specific) {
+      _ss_node_count[af]++;
+    }
+    for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+      _ss_prefix[i] |= node->ss_attached_networks[i];
+    }
+
+    node->target._dijkstra._link_first = link - _dijkstra_links;
+
+    avl_for_each_element(&node->_edges, edge, _node) {
+      if (edge->virtual) {
+        continue;
+      }
+      link->dst = &edge->dst->target;
+      memcpy(link->cost, edge->cost, sizeof(link->cost));
+      link->attachment = false;
+      link->shared = false;
+      link++;
+    }
+
+    avl_for_each_element(&node->_attached_networks, attached, _src_node) {
+      link->dst = &attached->dst->target;
+      memcpy(link->cost, attached->cost, sizeof(link->cost));
+      memcpy(link->distance, attached->distance, sizeof(link->distance));
+      link->attachment = true;
+      link->shared = attached->dst->_attached_networks.count > 1;
+      link++;
+    }
+
+    node->target._dijkstra._link_count = (link - _dijkstra_links) - node->target._dijkstra._link_first;
+  }
+  return 0;
+}
+
+/**
+ * Initialize internal fields for dijkstra calculation
+ */
+static void
+_prepare_nodes(void) {
+  /* dijkstra nodes are reset when the dijkstra reaches them */
+  _dijkstra_run++;
+  if (_dijkstra_run == 0) {
+    /* zero is reserved for new nodes */
+    _dijkstra_run = 1;
   }
+}
 
-  /* initialize private dijkstra data on endpoints */
-  avl_for_each_element(olsrv2_tc_get_endpoint_tree(), end, _node) {
-    end->target._dijkstra.first_hop = NULL;
-    end->target._dijkstra.path_cost = RFC7181_METRIC_INFINITE_PATH;
-    end->target._dijkstra.path_hops = 255;
-    end->target._dijkstra.done = false;
+/**
+ * Get the dijkstra data of a target, reset it if it belongs
+ * to an earlier dijkstra run
+ * @param target tc target
+ * @param ss true to get the dijkstra node of the source-specific sub-topology
+ * @return dijkstra node of the current run
+ */
+static struct olsrv2_dijkstra_node *
+_get_dijkstra_node(struct olsrv2_tc_target *target, bool ss) {
+  struct olsrv2_dijkstra_node *node;
+
+  node = ss ? &target->_ss_dijkstra : &target->_dijkstra;
+  if (node->_run != _dijkstra_run) {
+    node->_run = _dijkstra_run;
+    node->_ss_topology = ss;
+    node->first_hop = NULL;
+    node->multipath_count = 0;
+    node->path_cost = RFC7181_METRIC_INFINITE_PATH;
+    node->path_hops = 255;
+    node->local = target->type == OLSRV2_NODE_TARGET && olsrv2_originator_is_local(&target->prefix.dst);
+    node->done = false;
   }
+  return node;
 }
 
 /**
@@ -777,42 +1302,25 @@ _prepare_nodes(void) {
  */
 static bool
 _check_ssnode_split(struct nhdp_domain *domain, int af_family) {
-  struct olsrv2_tc_node *node;
   uint32_t ssnode_count, full_count;
-  bool ssnode_prefix;
 
-  ssnode_count = 0;
-  full_count = 0;
-  ssnode_prefix = false;
-
-  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
-    /* count number of source specific nodes */
-    if (netaddr_get_address_family(&node->target.prefix.dst) == af_family) {
-      full_count++;
-      if (node->source_specific) {
-        ssnode_count++;
-      }
-    }
-
-    /* remember node domain with source specific prefix */
-    ssnode_prefix |= node->ss_attached_networks[domain->index];
-  }
+  ssnode_count = _ss_node_count[af_family == AF_INET ? 0 : 1];
+  full_count = _tc_node_count[af_family == AF_INET ? 0 : 1];
 
   OONF_INFO(LOG_OLSRV2_ROUTING, "ss split for %d/%d: %d of %d/%s", domain->index, af_family, ssnode_count, full_count,
-    ssnode_prefix ? "true" : "false");
+    _ss_prefix[domain->index] ? "true" : "false");
 
-  return ssnode_count != 0 && ssnode_count != full_count && ssnode_prefix;
+  return ssnode_count != 0 && ssnode_count != full_count && _ss_prefix[domain->index];
 }
 
 /**
  * Add the single-hop TC neighbors to the dijkstra working list
  * @param domain nhdp domain for dijkstra run
  * @param af_family address family for dijkstra run
- * @param use_non_ss include non-source-specific nodes into working list
- * @param use_ss include source-specific nodes into working list
+ * @param split true if source-specific neighbors start the source-specific sub-topology
  */
 static void
-_add_one_hop_nodes(struct nhdp_domain *domain, int af_family, bool use_non_ss, bool use_ss) {
+_add_one_hop_nodes(struct nhdp_domain *domain, int af_family, bool split) {
   struct olsrv2_tc_node *node;
   struct nhdp_neighbor *neigh;
   struct nhdp_neighbor_domaindata *neigh_metric;
@@ -832,10 +1340,6 @@ _add_one_hop_nodes(struct nhdp_domain *domain, int af_family, bool use_non_ss, b
       continue;
     }
 
-    if (!use_non_ss && !(node->source_specific && use_ss)) {
-      continue;
-    }
-
     neigh_metric = nhdp_domain_get_neighbordata(domain, neigh);
 
     if (neigh_metric->metric.in > RFC7181_METRIC_MAX || neigh_metric->metric.out > RFC7181_METRIC_MAX) {
@@ -846,93 +1350,106 @@ _add_one_hop_nodes(struct nhdp_domain *domain, int af_family, bool use_non_ss, b
     OONF_DEBUG(LOG_OLSRV2_ROUTING, "Add one-hop node %s", netaddr_to_string(&nbuf, &neigh->originator));
 
     /* found node for neighbor, add to worker list */
-    _insert_into_working_tree(
-      &node->target, neigh, neigh_metric->metric.out, 0, 0, 0, true, olsrv2_originator_get(af_family));
+    _insert_into_working_tree(domain, &node->target, false, neigh, NULL, neigh_metric->metric.out, 0, 0, 0, true,
+      olsrv2_originator_get(af_family));
+
+    if (split && node->source_specific) {
+      /* source-specific neighbor also starts the source-specific sub-topology */
+      _insert_into_working_tree(domain, &node->target, true, neigh, NULL, neigh_metric->metric.out, 0, 0, 0, true,
+        olsrv2_originator_get(af_family));
+    }
   }
 }
 
 /**
  * Remove item from dijkstra working queue and process it
  * @param domain nhdp domain
- * @param use_non_ss include non-source-specific nodes into working list
- * @param use_ss include source-specific nodes into working list
+ * @param split true if source-specific targets must only be reached
+ *   through source-specific nodes
  */
 static void
-_handle_working_queue(struct nhdp_domain *domain, bool use_non_ss, bool use_ss) {
+_handle_working_queue(struct nhdp_domain *domain, bool split) {
+  struct olsrv2_dijkstra_node *node, *endpoint;
   struct olsrv2_tc_target *target;
-  struct nhdp_neighbor *first_hop;
   struct olsrv2_tc_node *tc_node;
-  struct olsrv2_tc_edge *tc_edge;
-  struct olsrv2_tc_attachment *tc_attached;
-  struct olsrv2_tc_endpoint *tc_endpoint;
+  struct _dijkstra_link *link, *link_end;
+  uint32_t cost;
+  bool ss;
 
 #ifdef OONF_LOG_DEBUG_INFO
   struct netaddr_str nbuf1, nbuf2;
 #endif
 
-  /* get tc target */
-  target = avl_first_element(&_dijkstra_working_tree, target, _dijkstra._node);
+  /* get dijkstra node and its tc target */
+  node = avl_first_element(&_dijkstra_working_tree, node, _node);
+  ss = node->_ss_topology;
+  if (ss) {
+    target = container_of(node, struct olsrv2_tc_target, _ss_dijkstra);
+  }
+  else {
+    target = container_of(node, struct olsrv2_tc_target, _dijkstra);
+  }
 
   /* remove current node from working tree */
-  OONF_DEBUG(LOG_OLSRV2_ROUTING, "Remove node %s [%s] from dijkstra tree",
-    netaddr_to_string(&nbuf1, &target->prefix.dst), netaddr_to_string(&nbuf2, &target->prefix.src));
-  avl_remove(&_dijkstra_working_tree, &target->_dijkstra._node);
+  OONF_DEBUG(LOG_OLSRV2_ROUTING, "Remove node %s [%s] from dijkstra tree%s",
+    netaddr_to_string(&nbuf1, &target->prefix.dst), netaddr_to_string(&nbuf2, &target->prefix.src),
+    ss ? " (source-specific)" : "");
+  avl_remove(&_dijkstra_working_tree, &node->_node);
 
   /* mark current node as done */
-  target->_dijkstra.done = true;
+  node->done = true;
 
-  /* fill routing entry with dijkstra result */
-  if (use_non_ss) {
-    _update_routing_entry(domain, &target->prefix, target->_dijkstra.originator, target->_dijkstra.first_hop,
-      target->_dijkstra.distance, target->_dijkstra.path_cost, target->_dijkstra.path_hops,
-      target->_dijkstra.single_hop, target->_dijkstra.last_originator);
+  /* fill routing entry with dijkstra result, the sub-topology only provides source-specific prefixes */
+  if (!ss || netaddr_get_prefix_length(&target->prefix.src) > 0) {
+    _update_routing_entry(domain, &target->prefix, node->originator, node->first_hop, node, 0, node->distance,
+      node->path_cost, node->path_hops, node->single_hop, node->last_originator);
   }
 
-  if (target->type == OLSRV2_NODE_TARGET) {
-    /* get neighbor and its domain specific data */
-    first_hop = target->_dijkstra.first_hop;
+  if (target->type != OLSRV2_NODE_TARGET) {
+    return;
+  }
 
-    /* calculate pointer of olsrv2_tc_node */
-    tc_node = container_of(target, struct olsrv2_tc_node, target);
+  /* calculate pointer of olsrv2_tc_node */
+  tc_node = container_of(target, struct olsrv2_tc_node, target);
 
-    /* iterate over edges */
-    avl_for_each_element(&tc_node->_edges, tc_edge, _node) {
-      if (!tc_edge->virtual && tc_edge->cost[domain->index] <= RFC7181_METRIC_MAX) {
-        if (!use_non_ss && !tc_node->source_specific) {
-          continue;
-        }
+  /* iterate over edges, attached networks and addresses of the shared adjacency */
+  link = &_dijkstra_links[target->_dijkstra._link_first];
+  link_end = link + target->_dijkstra._link_count;
+  for (; link < link_end; link++) {
+    cost = link->cost[domain->index];
+    if (cost > RFC7181_METRIC_MAX) {
+      continue;
+    }
 
-        /* add new tc_node to working tree */
-        _insert_into_working_tree(&tc_edge->dst->target, first_hop, tc_edge->cost[domain->index],
-          target->_dijkstra.path_cost, target->_dijkstra.path_hops, 0, false, &target->prefix.dst);
+    if (!link->attachment) {
+      if (ss && !tc_node->source_specific) {
+        /* sub-topology only continues through source-specific nodes */
+        continue;
       }
+
+      /* add new tc_node to working tree */
+      _insert_into_working_tree(domain, link->dst, ss, node->first_hop, node, cost, node->path_cost,
+        node->path_hops, 0, false, &target->prefix.dst);
+      continue;
     }
 
-    /* iterate over attached networks and addresses */
-    avl_for_each_element(&tc_node->_attached_networks, tc_attached, _src_node) {
-      if (tc_attached->cost[domain->index] <= RFC7181_METRIC_MAX) {
-        tc_endpoint = tc_attached->dst;
+    if (netaddr_get_prefix_length(&link->dst->prefix.src) > 0 ? (split && !ss) : ss) {
+      /* filter out (non-)source-specific targets if necessary */
+      continue;
+    }
+    if (link->shared) {
+      /* add attached network or address to working tree */
+      _insert_into_working_tree(domain, link->dst, ss, node->first_hop, node, cost, node->path_cost,
+        node->path_hops, link->distance[domain->index], false, &target->prefix.dst);
+    }
+    else {
+      /* no other way to this endpoint */
+      endpoint = _get_dijkstra_node(link->dst, ss);
+      endpoint->done = true;
 
-        if (!(netaddr_get_prefix_length(&tc_endpoint->target.prefix.src) > 0 ? use_ss : use_non_ss)) {
-          /* filter out (non-)source-specific targets if necessary */
-          continue;
-        }
-        if (tc_endpoint->_attached_networks.count > 1) {
-          /* add attached network or address to working tree */
-          _insert_into_working_tree(&tc_attached->dst->target, first_hop, tc_attached->cost[domain->index],
-            target->_dijkstra.path_cost, target->_dijkstra.path_hops, tc_attached->distance[domain->index], false,
-            &target->prefix.dst);
-        }
-        else {
-          /* no other way to this endpoint */
-          tc_endpoint->target._dijkstra.done = true;
-
-          /* fill routing entry with dijkstra result */
-          _update_routing_entry(domain, &tc_endpoint->target.prefix, &tc_node->target.prefix.dst, first_hop,
-            tc_attached->distance[domain->index], target->_dijkstra.path_cost + tc_attached->cost[domain->index],
-            target->_dijkstra.path_hops + 1, false, &target->prefix.dst);
-        }
-      }
+      /* fill routing entry with dijkstra result */
+      _update_routing_entry(domain, &link->dst->prefix, &tc_node->target.prefix.dst, node->first_hop, node, cost,
+        link->distance[domain->index], node->path_cost + cost, node->path_hops + 1, false, &target->prefix.dst);
     }
   }
 }
@@ -979,7 +1496,7 @@ _handle_nhdp_routes(struct nhdp_domain *domain) {
       os_routing_init_sourcespec_prefix(&ssprefix, &naddr->neigh_addr);
 
       /* update routing entry */
-      _update_routing_entry(domain, &ssprefix, originator, neigh, 0, neighcost, 1, true, originator);
+      _update_routing_entry(domain, &ssprefix, originator, neigh, NULL, 0, 0, neighcost, 1, true, originator);
     }
 
     list_for_each_element(&neigh->_links, lnk, _neigh_node) {
@@ -1001,7 +1518,7 @@ _handle_nhdp_routes(struct nhdp_domain *domain) {
 
         /* the 2-hop route is better than the dijkstra calculation */
         _update_routing_entry(
-          domain, &ssprefix, &NETADDR_UNSPEC, neigh, 0, l2hop_pathcost, 2, false, &neigh->originator);
+          domain, &ssprefix, &NETADDR_UNSPEC, neigh, NULL, 0, 0, l2hop_pathcost, 2, false, &neigh->originator);
       }
     }
   }
@@ -1061,6 +1578,16 @@ _process_dijkstra_result(struct nhdp_domain *domain) {
 #endif
 
   avl_for_each_element(&_routing_tree[domain->index], rtentry, _node) {
+    if (rtentry->adopted && !rtentry->set && oonf_timer_is_active(&_adoption_timer)) {
+      /* keep adopted kernel route until the hold time is over */
+      continue;
+    }
+    rtentry->adopted = false;
+    if (rtentry->set) {
+      /* the route replaces the kernel route of the new table */
+      rtentry->adopt_pending = false;
+    }
+
     /* initialize rest of route parameters */
     rtentry->route.p.table = _domain_parameter[rtentry->domain->index].table;
     rtentry->route.p.protocol = _domain_parameter[rtentry->domain->index].protocol;
@@ -1088,7 +1615,11 @@ _process_dijkstra_result(struct nhdp_domain *domain) {
       }
     }
 
-    if (rtentry->set && memcmp(&rtentry->_old, &rtentry->route.p, sizeof(rtentry->_old)) == 0) {
+    if (rtentry->set) {
+      _update_nexthop(rtentry);
+    }
+
+    if (rtentry->set && _is_route_unchanged(rtentry)) {
       /* no change, ignore this entry */
       OONF_INFO(LOG_OLSRV2_ROUTING, "Ignore route change: %s -> %s", os_routing_to_string(&rbuf1, &rtentry->_old),
         os_routing_to_string(&rbuf2, &rtentry->route.p));
@@ -1104,6 +1635,7 @@ _process_dijkstra_result(struct nhdp_domain *domain) {
 static void
 _process_kernel_queue(void) {
   struct olsrv2_routing_entry *rtentry, *rt_it;
+  struct olsrv2_routing_nexthop *nexthop, *nh_it;
   struct os_route_str rbuf;
 
   list_for_each_element_safe(&_kernel_queue, rtentry, _working_node, rt_it) {
@@ -1130,6 +1662,151 @@ _process_kernel_queue(void) {
       }
     }
   }
+
+  /* remove unused nexthop objects after the routes have been changed */
+  avl_for_each_element_safe(&_nexthop_tree, nexthop, _node, nh_it) {
+    if (nexthop->usage == 0) {
+      _remove_nexthop(nexthop);
+    }
+  }
+}
+
+/**
+ * Attach a routing entry to the kernel nexthop object of its first hop
+ * (or detach it if it should use a normal route) and set the nexthop id
+ * of the route.
+ * @param rtentry routing entry
+ */
+static void
+_update_nexthop(struct olsrv2_routing_entry *rtentry) {
+  struct olsrv2_routing_nexthop *nexthop = NULL;
+
+  if (_domain_parameter[rtentry->domain->index].use_nexthop_objects && !_nexthop_objects_failed &&
+      os_routing_supports_nexthop_objects() && netaddr_get_address_family(&rtentry->route.p.gw) != AF_UNSPEC &&
+      rtentry->route.p.multipath_count == 0) {
+    nexthop = _add_nexthop(rtentry);
+  }
+
+  if (nexthop != rtentry->_nexthop) {
+    if (rtentry->_nexthop) {
+      rtentry->_nexthop->usage--;
+    }
+    if (nexthop) {
+      nexthop->usage++;
+    }
+    rtentry->_nexthop = nexthop;
+  }
+  rtentry->route.p.nexthop_id = nexthop ? nexthop->os.id : 0;
+}
+
+/**
+ * Get the kernel nexthop object for the first hop of a routing entry
+ * and make sure it contains the gateway and interface of the route.
+ * @param rtentry routing entry
+ * @return nexthop object, NULL if an error happened
+ */
+static struct olsrv2_routing_nexthop *
+_add_nexthop(struct olsrv2_routing_entry *rtentry) {
+  struct olsrv2_routing_nexthop_key key;
+  struct olsrv2_routing_nexthop *nexthop;
+
+  memset(&key, 0, sizeof(key));
+  memcpy(&key.originator, &rtentry->next_originator, sizeof(key.originator));
+  key.if_index = rtentry->route.p.if_index;
+  key.family = rtentry->route.p.family;
+  key.domain = rtentry->domain->index;
+
+  nexthop = avl_find_element(&_nexthop_tree, &key, nexthop, _node);
+  if (nexthop == NULL) {
+    nexthop = oonf_class_malloc(&_nexthop_class);
+    if (nexthop == NULL) {
+      return NULL;
+    }
+
+    memcpy(&nexthop->key, &key, sizeof(key));
+    nexthop->_node.key = &nexthop->key;
+    nexthop->os.family = key.family;
+    nexthop->os.if_index = key.if_index;
+    nexthop->os.cb_finished = _cb_nexthop_finished;
+
+    avl_insert(&_nexthop_tree, &nexthop->_node);
+  }
+  else if (nexthop->os.id != 0 && nexthop->os.protocol == rtentry->route.p.protocol &&
+           netaddr_cmp(&nexthop->os.gw, &rtentry->route.p.gw) == 0) {
+    /* nexthop is up to date */
+    return nexthop;
+  }
+
+  /* a changed gateway of the neighbor only needs a single nexthop update */
+  memcpy(&nexthop->os.gw, &rtentry->route.p.gw, sizeof(nexthop->os.gw));
+  nexthop->os.protocol = rtentry->route.p.protocol;
+
+  if (os_routing_nexthop_set(&nexthop->os, true)) {
+    OONF_WARN(LOG_OLSRV2_ROUTING, "Could not set nexthop object for route");
+    return NULL;
+  }
+  return nexthop;
+}
+
+/**
+ * Remove a kernel nexthop object. The memory is released when
+ * the kernel has processed the removal.
+ * @param nexthop nexthop object
+ */
+static void
+_remove_nexthop(struct olsrv2_routing_nexthop *nexthop) {
+  avl_remove(&_nexthop_tree, &nexthop->_node);
+
+  if (nexthop->os.id != 0 && os_routing_nexthop_set(&nexthop->os, false) == 0) {
+    list_add_tail(&_removed_nexthops, &nexthop->_removed_node);
+    return;
+  }
+
+  nexthop->os.cb_finished = NULL;
+  os_routing_nexthop_interrupt(&nexthop->os);
+  oonf_class_free(&_nexthop_class, nexthop);
+}
+
+/**
+ * Check if a routing entry has to be sent to the kernel again
+ * @param rtentry routing entry
+ * @return true if the kernel route is still up to date
+ */
+static bool
+_is_route_unchanged(struct olsrv2_routing_entry *rtentry) {
+  struct os_route_parameter old;
+
+  memcpy(&old, &rtentry->_old, sizeof(old));
+  if (old.nexthop_id != 0 && old.nexthop_id == rtentry->route.p.nexthop_id) {
+    /* gateway and interface are part of the nexthop object */
+    memcpy(&old.gw, &rtentry->route.p.gw, sizeof(old.gw));
+    old.if_index = rtentry->route.p.if_index;
+  }
+  return memcmp(&old, &rtentry->route.p, sizeof(old)) == 0;
+}
+
+/**
+ * Calculate the hold time after a dijkstra run. The hold time doubles
+ * with each run until it reaches the maximum and falls back to the
+ * initial hold time if no dijkstra was necessary for the quiet period.
+ */
+static void
+_update_hold_time(void) {
+  uint64_t now;
+
+  now = oonf_clock_getNow();
+  if (_statistics.runs == 1 || now - _last_dijkstra >= _throttling.quiet_period) {
+    _statistics.hold_time = _throttling.hold_time;
+  }
+  else if (_statistics.hold_time >= _throttling.max_hold_time / 2) {
+    _statistics.hold_time = _throttling.max_hold_time;
+  }
+  else {
+    _statistics.hold_time *= 2;
+  }
+  _last_dijkstra = now;
+
+  OONF_DEBUG(LOG_OLSRV2_ROUTING, "Dijkstra hold time is now %" PRIu64 " ms", _statistics.hold_time);
 }
 
 /**
@@ -1145,6 +1822,62 @@ _cb_trigger_dijkstra(struct oonf_timer_instance *ptr __attribute__((unused))) {
   }
 }
 
+/**
+ * AVL comparator for kernel nexthop keys
+ * @param k1 pointer to first key
+ * @param k2 pointer to second key
+ * @return <0, 0 or >0 if first key is smaller, equal or larger than the second
+ */
+static int
+_avlcmp_nexthop_key(const void *k1, const void *k2) {
+  const struct olsrv2_routing_nexthop_key *key1 = k1;
+  const struct olsrv2_routing_nexthop_key *key2 = k2;
+
+  if (key1->domain != key2->domain) {
+    return key1->domain < key2->domain ? -1 : 1;
+  }
+  if (key1->family != key2->family) {
+    return key1->family < key2->family ? -1 : 1;
+  }
+  if (key1->if_index != key2->if_index) {
+    return key1->if_index < key2->if_index ? -1 : 1;
+  }
+  return netaddr_cmp(&key1->originator, &key2->originator);
+}
+
+/**
+ * Callback for kernel nexthop processing results
+ * @param os_nexthop OS nexthop data
+ * @param error 0 if no error happened
+ */
+static void
+_cb_nexthop_finished(struct os_route_nexthop *os_nexthop, int error) {
+  struct olsrv2_routing_nexthop *nexthop;
+  struct netaddr_str nbuf;
+
+  nexthop = container_of(os_nexthop, struct olsrv2_routing_nexthop, os);
+  if (error == -1) {
+    /* someone called an interrupt */
+    return;
+  }
+
+  if (list_is_node_added(&nexthop->_removed_node)) {
+    /* kernel removal is finished */
+    list_remove(&nexthop->_removed_node);
+    oonf_class_free(&_nexthop_class, nexthop);
+    return;
+  }
+
+  if (error) {
+    OONF_WARN(LOG_OLSRV2_ROUTING, "Error in setting nexthop %u (gw %s): %s (%d), falling back to normal routes",
+      os_nexthop->id, netaddr_to_string(&nbuf, &os_nexthop->gw), strerror(error), error);
+
+    /* rewrite all routes without nexthop objects */
+    _nexthop_objects_failed = true;
+    olsrv2_routing_domain_changed(NULL, false);
+  }
+}
+
 /**
  * Callback for kernel route processing results
  * @param route OS route data
@@ -1190,8 +1923,167 @@ _cb_route_finished(struct os_route *route, int error) {
     /* route was set/updated successfully */
     OONF_INFO(LOG_OLSRV2_ROUTING, "Successfully set route %s", os_routing_to_string(&rbuf, &rtentry->route.p));
   }
+  else if (rtentry->adopt_pending) {
+    OONF_INFO(LOG_OLSRV2_ROUTING, "Successfully removed route %s", os_routing_to_string(&rbuf, &rtentry->route.p));
+
+    /* the dijkstra decides about the route of the new table */
+    _adopt_kernel_route(rtentry, &rtentry->_adopt);
+    olsrv2_routing_domain_changed(rtentry->domain, false);
+  }
   else {
     OONF_INFO(LOG_OLSRV2_ROUTING, "Successfully removed route %s", os_routing_to_string(&rbuf, &rtentry->route.p));
     _remove_entry(rtentry);
   }
 }
+
+/**
+ * Start a dump of the kernel routes of a domain
+ * @param domain nhdp domain
+ */
+static void
+_reconcile_domain(struct nhdp_domain *domain) {
+  struct os_route *query;
+
+  query = &_reconcile_query[domain->index];
+  if (os_routing_is_in_progress(query)) {
+    return;
+  }
+
+  os_routing_init_wildcard_route(query);
+  query->cb_get = _cb_reconcile_route;
+  query->cb_finished = _cb_reconcile_finished;
+  query->p.type = OS_ROUTE_UNICAST;
+  query->p.table = _domain_parameter[domain->index].table;
+  query->p.protocol = _domain_parameter[domain->index].protocol;
+  query->p.metric = _domain_parameter[domain->index].distance;
+
+  if (os_routing_query(query)) {
+    OONF_WARN(LOG_OLSRV2_ROUTING, "Could not query kernel routes of domain %u", domain->ext);
+  }
+}
+
+/**
+ * @return true if a kernel route dump of any domain is still running
+ */
+static bool
+_is_reconciliation_running(void) {
+  int i;
+
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    if (os_routing_is_in_progress(&_reconcile_query[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Callback for each kernel route found by the reconciliation dump
+ * @param filter reconciliation query of a domain
+ * @param route kernel route
+ */
+static void
+_cb_reconcile_route(struct os_route *filter, struct os_route *route) {
+  struct olsrv2_routing_entry *rtentry;
+  struct nhdp_domain *domain, *d;
+  struct os_route_key key;
+
+  domain = NULL;
+  list_for_each_element(nhdp_domain_get_list(), d, _node) {
+    if (filter == &_reconcile_query[d->index]) {
+      domain = d;
+      break;
+    }
+  }
+  if (domain == NULL) {
+    return;
+  }
+
+  if (route->p.metric != filter->p.metric) {
+    /* route with a different distance does not belong to this domain */
+    return;
+  }
+
+  /* the dijkstra uses a zero-length source prefix for non-source-specific routes */
+  memcpy(&key, &route->p.key, sizeof(key));
+  if (netaddr_get_address_family(&key.src) == AF_UNSPEC) {
+    os_routing_init_sourcespec_prefix(&key, &route->p.key.dst);
+  }
+
+  rtentry = avl_find_element(&_routing_tree[domain->index], &key, rtentry, _node);
+  if (rtentry) {
+    if (!rtentry->set && rtentry->route.p.table != filter->p.table) {
+      /* entry still removes the route from the old table, adopt this one afterwards */
+      memcpy(&rtentry->_adopt, &route->p, sizeof(rtentry->_adopt));
+      rtentry->adopt_pending = true;
+    }
+    return;
+  }
+
+  rtentry = _add_entry(domain, &key);
+  if (rtentry) {
+    _adopt_kernel_route(rtentry, &route->p);
+  }
+}
+
+/**
+ * Use a kernel route as the known kernel state of a routing entry
+ * @param rtentry routing entry
+ * @param param kernel route
+ */
+static void
+_adopt_kernel_route(struct olsrv2_routing_entry *rtentry, const struct os_route_parameter *param) {
+  struct os_route_key key;
+  struct os_route_str rbuf;
+
+  /* keep the key of the entry, it is the key of the routing tree */
+  memcpy(&key, &rtentry->route.p.key, sizeof(key));
+  memcpy(&rtentry->route.p, param, sizeof(rtentry->route.p));
+  memcpy(&rtentry->route.p.key, &key, sizeof(key));
+
+  if (rtentry->route.p.nexthop_id == 0 && rtentry->route.p.multipath_count == 0 &&
+      netaddr_get_address_family(&key.dst) == AF_INET && netaddr_get_prefix_length(&key.dst) == 32 &&
+      netaddr_cmp(&rtentry->route.p.gw, &key.dst) == 0) {
+    /* the kernel reports the destination of a single hop IPv4 route as its gateway */
+    netaddr_invalidate(&rtentry->route.p.gw);
+  }
+  memcpy(&rtentry->_old, &rtentry->route.p, sizeof(rtentry->_old));
+  rtentry->adopted = true;
+  rtentry->adopt_pending = false;
+
+  OONF_INFO(LOG_OLSRV2_ROUTING, "Adopted kernel route %s", os_routing_to_string(&rbuf, &rtentry->route.p));
+}
+
+/**
+ * Callback for the end of a reconciliation dump
+ * @param filter reconciliation query of a domain
+ * @param error 0 if no error happened
+ */
+static void
+_cb_reconcile_finished(struct os_route *filter __attribute__((unused)), int error) {
+  if (error) {
+    OONF_WARN(LOG_OLSRV2_ROUTING, "Could not read kernel routes for reconciliation: %s (%d)", strerror(error), error);
+  }
+  if (!_is_reconciliation_running()) {
+    /* compare the computed routes with the kernel state */
+    olsrv2_routing_domain_changed(NULL, false);
+  }
+}
+
+/**
+ * Callback to remove all adopted kernel routes that have not been
+ * confirmed by the dijkstra
+ * @param ptr timer instance that fired
+ */
+static void
+_cb_adoption_timeout(struct oonf_timer_instance *ptr __attribute__((unused))) {
+  struct olsrv2_routing_entry *rtentry;
+  int i;
+
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    avl_for_each_element(&_routing_tree[i], rtentry, _node) {
+      rtentry->adopted = false;
+    }
+  }
+  olsrv2_routing_domain_changed(NULL, false);
+}
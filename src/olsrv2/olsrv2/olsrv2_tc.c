@@ -99,10 +99,14 @@ static struct oonf_timer_class _validity_info = {
   .callback = _cb_tc_node_timeout,
 };
 
-/* global trees for tc nodes and endpoints */
+/* global trees for tc nodes and endpoints, used for ordered iteration */
 static struct avl_tree _tc_tree;
 static struct avl_tree _tc_endpoint_tree;
 
+/* global hash indices for lookups of tc nodes and endpoints */
+static struct netaddr_hash _tc_hash;
+static struct netaddr_hash _tc_endpoint_hash;
+
 /**
  * Initialize tc database
  */
@@ -117,6 +121,9 @@ olsrv2_tc_init(void) {
 
   avl_init(&_tc_tree, avl_comp_netaddr, false);
   avl_init(&_tc_endpoint_tree, os_routing_avl_cmp_route_key, true);
+
+  netaddr_hash_init(&_tc_hash, 1);
+  netaddr_hash_init(&_tc_endpoint_hash, 2);
 }
 
 /**
@@ -143,6 +150,9 @@ olsrv2_tc_cleanup(void) {
     olsrv2_tc_node_remove(node);
   }
 
+  netaddr_hash_cleanup(&_tc_endpoint_hash);
+  netaddr_hash_cleanup(&_tc_hash);
+
   oonf_class_extension_remove(&_nhdp_neighbor_extension);
 
   oonf_class_remove(&_tc_endpoint_class);
@@ -162,7 +172,7 @@ struct olsrv2_tc_node *
 olsrv2_tc_node_add(struct netaddr *originator, uint64_t vtime, uint16_t ansn) {
   struct olsrv2_tc_node *node;
 
-  node = avl_find_element(&_tc_tree, originator, node, _originator_node);
+  node = olsrv2_tc_node_get(originator);
   if (!node) {
     node = oonf_class_malloc(&_tc_node_class);
     if (node == NULL) {
@@ -172,6 +182,13 @@ olsrv2_tc_node_add(struct netaddr *originator, uint64_t vtime, uint16_t ansn) {
     /* copy key and attach it to node */
     os_routing_init_sourcespec_prefix(&node->target.prefix, originator);
     node->_originator_node.key = &node->target.prefix.dst;
+    node->_originator_hash.key = &node->target.prefix.dst;
+
+    /* hook into hash index */
+    if (netaddr_hash_add(&_tc_hash, &node->_originator_hash)) {
+      oonf_class_free(&_tc_node_class, node);
+      return NULL;
+    }
 
     /* initialize node */
     avl_init(&node->_edges, avl_comp_netaddr, false);
@@ -184,6 +201,7 @@ olsrv2_tc_node_add(struct netaddr *originator, uint64_t vtime, uint16_t ansn) {
     /* initialize dijkstra data */
     node->target.type = OLSRV2_NODE_TARGET;
     olsrv2_routing_dijkstra_node_init(&node->target._dijkstra, &node->target.prefix.dst);
+    olsrv2_routing_dijkstra_node_init(&node->target._ss_dijkstra, &node->target.prefix.dst);
 
     /* hook into global tree */
     avl_insert(&_tc_tree, &node->_originator_node);
@@ -230,6 +248,7 @@ olsrv2_tc_node_remove(struct olsrv2_tc_node *node) {
   /* remove from global tree and free memory if node is not needed anymore*/
   if (node->_edges.count == 0 && !node->direct_neighbor) {
     avl_remove(&_tc_tree, &node->_originator_node);
+    netaddr_hash_remove(&_tc_hash, &node->_originator_hash);
     oonf_class_free(&_tc_node_class, node);
   }
 
@@ -277,7 +296,7 @@ olsrv2_tc_edge_add(struct olsrv2_tc_node *src, struct netaddr *addr) {
   }
 
   /* find or allocate destination node */
-  dst = avl_find_element(&_tc_tree, addr, dst, _originator_node);
+  dst = olsrv2_tc_node_get(addr);
   if (dst == NULL) {
     /* create virtual node */
     dst = olsrv2_tc_node_add(addr, 0, 0);
@@ -355,7 +374,7 @@ olsrv2_tc_endpoint_add(struct olsrv2_tc_node *node, struct os_route_key *prefix,
     return NULL;
   }
 
-  end = avl_find_element(&_tc_endpoint_tree, prefix, end, _node);
+  end = olsrv2_tc_endpoint_get(prefix);
   if (end == NULL) {
     /* create new endpoint */
     end = oonf_class_malloc(&_tc_endpoint_class);
@@ -368,8 +387,15 @@ olsrv2_tc_endpoint_add(struct olsrv2_tc_node *node, struct os_route_key *prefix,
     end->target.type = mesh ? OLSRV2_ADDRESS_TARGET : OLSRV2_NETWORK_TARGET;
     avl_init(&end->_attached_networks, os_routing_avl_cmp_route_key, false);
 
-    /* attach to global tree */
+    /* attach to hash index and global tree */
     memcpy(&end->target.prefix, prefix, sizeof(*prefix));
+    end->_hash_node.key = &end->target.prefix.dst;
+    if (netaddr_hash_add(&_tc_endpoint_hash, &end->_hash_node)) {
+      oonf_class_free(&_tc_endpoint_class, end);
+      oonf_class_free(&_tc_attached_class, net);
+      return NULL;
+    }
+
     end->_node.key = &end->target.prefix;
     avl_insert(&_tc_endpoint_tree, &end->_node);
 
@@ -393,6 +419,7 @@ olsrv2_tc_endpoint_add(struct olsrv2_tc_node *node, struct os_route_key *prefix,
 
   /* initialize dijkstra data */
   olsrv2_routing_dijkstra_node_init(&end->target._dijkstra, &node->target.prefix.dst);
+  olsrv2_routing_dijkstra_node_init(&end->target._ss_dijkstra, &node->target.prefix.dst);
 
   oonf_class_event(&_tc_attached_class, net, OONF_OBJECT_ADDED);
   return net;
@@ -417,6 +444,7 @@ olsrv2_tc_endpoint_remove(struct olsrv2_tc_attachment *net) {
 
     /* remove endpoint */
     avl_remove(&_tc_endpoint_tree, &net->dst->_node);
+    netaddr_hash_remove(&_tc_endpoint_hash, &net->dst->_hash_node);
     oonf_class_free(&_tc_endpoint_class, net->dst);
   }
 
@@ -436,6 +464,28 @@ olsrv2_tc_trigger_change(struct olsrv2_tc_node *node) {
   oonf_class_event(&_tc_node_class, node, OONF_OBJECT_CHANGED);
 }
 
+/**
+ * @param originator originator address of a tc node
+ * @return pointer to tc node, NULL if not found
+ */
+struct olsrv2_tc_node *
+olsrv2_tc_node_get(const struct netaddr *originator) {
+  struct olsrv2_tc_node *node;
+
+  return netaddr_hash_find_element(&_tc_hash, NULL, originator, node, _originator_hash);
+}
+
+/**
+ * @param prefix network prefix of tc endpoint, might be source specific
+ * @return pointer to tc endpoint, NULL if not found
+ */
+struct olsrv2_tc_endpoint *
+olsrv2_tc_endpoint_get(const struct os_route_key *prefix) {
+  struct olsrv2_tc_endpoint *end;
+
+  return netaddr_hash_find_element(&_tc_endpoint_hash, NULL, &prefix->dst, end, _hash_node);
+}
+
 /**
  * Get tree of olsrv2 tc nodes
  * @return node tree
@@ -0,0 +1,500 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <oonf/libcommon/autobuf.h>
+#include <oonf/libcommon/avl.h>
+#include <oonf/oonf.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/libcore/oonf_logging.h>
+
+#include <oonf/nhdp/nhdp/nhdp_domain.h>
+
+#include <oonf/olsrv2/olsrv2/olsrv2_internal.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_routing.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_tc.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_warm_restart.h>
+
+/*! identifier at the start of a snapshot file */
+#define SNAPSHOT_MAGIC "OLSRv2WR"
+
+/*! version of the snapshot format, increase when the records change */
+#define SNAPSHOT_VERSION 1
+
+/**
+ * Header of a snapshot file
+ */
+struct _snapshot_header {
+  /*! SNAPSHOT_MAGIC without 0-byte */
+  char magic[8];
+
+  /*! SNAPSHOT_VERSION */
+  uint32_t version;
+
+  /*! number of tc nodes in snapshot */
+  uint32_t node_count;
+
+  /*! extension of the domains by domain index, -1 if unused */
+  int32_t domain_ext[NHDP_MAXIMUM_DOMAINS];
+};
+
+/**
+ * Snapshot of a tc node, followed by its edges and attachments
+ */
+struct _snapshot_node {
+  /*! originator of tc node */
+  struct netaddr originator;
+
+  /*! answer set number */
+  uint16_t ansn;
+
+  /*! node can do source specific routing */
+  bool source_specific;
+
+  /*! reported interval time */
+  uint64_t interval_time;
+
+  /*! number of edges following the node */
+  uint32_t edge_count;
+
+  /*! number of attachments following the edges */
+  uint32_t attachment_count;
+};
+
+/**
+ * Snapshot of a non-virtual tc edge
+ */
+struct _snapshot_edge {
+  /*! originator of edge destination */
+  struct netaddr dst;
+
+  /*! link cost of edge */
+  uint32_t cost[NHDP_MAXIMUM_DOMAINS];
+
+  /*! link cost of the inverse edge, only used if the inverse edge is virtual */
+  uint32_t inverse_cost[NHDP_MAXIMUM_DOMAINS];
+};
+
+/**
+ * Snapshot of a tc attachment
+ */
+struct _snapshot_attachment {
+  /*! prefix of endpoint */
+  struct os_route_key prefix;
+
+  /*! true if endpoint is an interface address of a mesh node */
+  bool mesh;
+
+  /*! link cost of attachment */
+  uint32_t cost[NHDP_MAXIMUM_DOMAINS];
+
+  /*! distance to attached network */
+  uint8_t distance[NHDP_MAXIMUM_DOMAINS];
+};
+
+static int _write_file(const char *file, struct autobuf *abuf);
+static int _read_file(const char *file, struct autobuf *abuf);
+static int _read_record(struct autobuf *abuf, size_t *offset, void *record, size_t len);
+static int _restore_node(
+  struct autobuf *abuf, size_t *offset, const int *domain_index, uint64_t vtime, struct _snapshot_node *s_node);
+
+/**
+ * Write the current topology database into a snapshot file
+ * @param file name of snapshot file
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+olsrv2_warm_restart_save(const char *file) {
+  struct _snapshot_header header;
+  struct _snapshot_node s_node;
+  struct _snapshot_edge s_edge;
+  struct _snapshot_attachment s_attachment;
+  struct olsrv2_tc_node *node;
+  struct olsrv2_tc_edge *edge;
+  struct olsrv2_tc_attachment *attachment;
+  struct nhdp_domain *domain;
+  struct autobuf abuf;
+  int i, result;
+
+  if (abuf_init(&abuf)) {
+    return -1;
+  }
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+  header.version = SNAPSHOT_VERSION;
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    header.domain_ext[i] = -1;
+  }
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    header.domain_ext[domain->index] = domain->ext;
+  }
+
+  /* reserve space for header */
+  abuf_memcpy(&abuf, &header, sizeof(header));
+
+  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
+    if (olsrv2_tc_is_node_virtual(node)) {
+      continue;
+    }
+
+    memset(&s_node, 0, sizeof(s_node));
+    memcpy(&s_node.originator, &node->target.prefix.dst, sizeof(s_node.originator));
+    s_node.ansn = node->ansn;
+    s_node.source_specific = node->source_specific;
+    s_node.interval_time = node->interval_time;
+
+    avl_for_each_element(&node->_edges, edge, _node) {
+      if (!edge->virtual) {
+        s_node.edge_count++;
+      }
+    }
+    s_node.attachment_count = node->_attached_networks.count;
+
+    abuf_memcpy(&abuf, &s_node, sizeof(s_node));
+
+    avl_for_each_element(&node->_edges, edge, _node) {
+      if (edge->virtual) {
+        continue;
+      }
+
+      memset(&s_edge, 0, sizeof(s_edge));
+      memcpy(&s_edge.dst, &edge->dst->target.prefix.dst, sizeof(s_edge.dst));
+      memcpy(s_edge.cost, edge->cost, sizeof(s_edge.cost));
+      memcpy(s_edge.inverse_cost, edge->inverse->cost, sizeof(s_edge.inverse_cost));
+      abuf_memcpy(&abuf, &s_edge, sizeof(s_edge));
+    }
+
+    avl_for_each_element(&node->_attached_networks, attachment, _src_node) {
+      memset(&s_attachment, 0, sizeof(s_attachment));
+      memcpy(&s_attachment.prefix, &attachment->dst->target.prefix, sizeof(s_attachment.prefix));
+      s_attachment.mesh = attachment->dst->target.type == OLSRV2_ADDRESS_TARGET;
+      memcpy(s_attachment.cost, attachment->cost, sizeof(s_attachment.cost));
+      memcpy(s_attachment.distance, attachment->distance, sizeof(s_attachment.distance));
+      abuf_memcpy(&abuf, &s_attachment, sizeof(s_attachment));
+    }
+
+    header.node_count++;
+  }
+
+  if (abuf_has_failed(&abuf)) {
+    OONF_WARN(LOG_OLSRV2, "Out of memory for warm restart snapshot");
+    abuf_free(&abuf);
+    return -1;
+  }
+
+  /* fill in final header */
+  memcpy(abuf_getptr(&abuf), &header, sizeof(header));
+
+  result = _write_file(file, &abuf);
+  if (!result) {
+    OONF_INFO(LOG_OLSRV2, "Saved %u tc nodes into warm restart snapshot %s", header.node_count, file);
+  }
+  abuf_free(&abuf);
+  return result;
+}
+
+/**
+ * Restore the topology database from a snapshot file and remove
+ * the file afterwards. Restored information is only valid for
+ * a limited time and is replaced by the first TC of each node.
+ * @param file name of snapshot file
+ * @param vtime validity time of restored information
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+olsrv2_warm_restart_load(const char *file, uint64_t vtime) {
+  struct _snapshot_header header;
+  struct _snapshot_node s_node;
+  int domain_index[NHDP_MAXIMUM_DOMAINS];
+  struct nhdp_domain *domain;
+  struct autobuf abuf;
+  size_t offset;
+  uint32_t i;
+  int result;
+
+  if (abuf_init(&abuf)) {
+    return -1;
+  }
+  if (_read_file(file, &abuf)) {
+    abuf_free(&abuf);
+    return -1;
+  }
+
+  /* the snapshot is only good for one restart */
+  unlink(file);
+
+  offset = 0;
+  if (_read_record(&abuf, &offset, &header, sizeof(header)) ||
+      memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 || header.version != SNAPSHOT_VERSION) {
+    OONF_WARN(LOG_OLSRV2, "Warm restart snapshot %s has an unknown format", file);
+    abuf_free(&abuf);
+    return -1;
+  }
+
+  /* map domain indices of old instance to current ones */
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    domain = NULL;
+    if (header.domain_ext[i] >= 0) {
+      domain = nhdp_domain_get_by_ext(header.domain_ext[i]);
+    }
+    domain_index[i] = domain ? domain->index : -1;
+  }
+
+  result = 0;
+  for (i = 0; i < header.node_count && result == 0; i++) {
+    result = _read_record(&abuf, &offset, &s_node, sizeof(s_node));
+    if (result == 0) {
+      result = _restore_node(&abuf, &offset, domain_index, vtime, &s_node);
+    }
+  }
+
+  if (result) {
+    OONF_WARN(LOG_OLSRV2, "Warm restart snapshot %s is truncated", file);
+  }
+  else {
+    OONF_INFO(LOG_OLSRV2, "Restored %u tc nodes from warm restart snapshot %s", header.node_count, file);
+  }
+
+  olsrv2_routing_domain_changed(NULL, false);
+  abuf_free(&abuf);
+  return result;
+}
+
+/**
+ * Restore a tc node with its edges and attachments
+ * @param abuf buffer with snapshot
+ * @param offset pointer to current read offset
+ * @param domain_index mapping of snapshot domain indices to current ones
+ * @param vtime validity time of restored node
+ * @param s_node snapshot of tc node
+ * @return -1 if snapshot was truncated, 0 otherwise
+ */
+static int
+_restore_node(
+  struct autobuf *abuf, size_t *offset, const int *domain_index, uint64_t vtime, struct _snapshot_node *s_node) {
+  struct _snapshot_edge s_edge;
+  struct _snapshot_attachment s_attachment;
+  struct olsrv2_tc_node *node;
+  struct olsrv2_tc_edge *edge;
+  struct olsrv2_tc_attachment *attachment;
+  struct nhdp_domain *domain;
+  uint32_t i;
+  int j, idx;
+  bool skip;
+
+  /* fresh information is better than restored one */
+  node = olsrv2_tc_node_get(&s_node->originator);
+  skip = node != NULL && !olsrv2_tc_is_node_virtual(node);
+
+  if (!skip) {
+    node = olsrv2_tc_node_add(&s_node->originator, vtime, s_node->ansn);
+    if (node) {
+      node->ansn = s_node->ansn;
+      node->interval_time = s_node->interval_time;
+      node->source_specific = s_node->source_specific;
+      node->restored = true;
+    }
+  }
+
+  for (i = 0; i < s_node->edge_count; i++) {
+    if (_read_record(abuf, offset, &s_edge, sizeof(s_edge))) {
+      return -1;
+    }
+    if (skip || node == NULL) {
+      continue;
+    }
+
+    edge = olsrv2_tc_edge_add(node, &s_edge.dst);
+    if (edge == NULL) {
+      continue;
+    }
+
+    edge->ansn = node->ansn;
+    for (j = 0; j < NHDP_MAXIMUM_DOMAINS; j++) {
+      idx = domain_index[j];
+      if (idx < 0) {
+        continue;
+      }
+      edge->cost[idx] = s_edge.cost[j];
+      if (edge->inverse->virtual) {
+        edge->inverse->cost[idx] = s_edge.inverse_cost[j];
+      }
+    }
+  }
+
+  for (i = 0; i < s_node->attachment_count; i++) {
+    if (_read_record(abuf, offset, &s_attachment, sizeof(s_attachment))) {
+      return -1;
+    }
+    if (skip || node == NULL) {
+      continue;
+    }
+
+    attachment = olsrv2_tc_endpoint_add(node, &s_attachment.prefix, s_attachment.mesh);
+    if (attachment == NULL) {
+      continue;
+    }
+
+    attachment->ansn = node->ansn;
+    for (j = 0; j < NHDP_MAXIMUM_DOMAINS; j++) {
+      idx = domain_index[j];
+      if (idx < 0) {
+        continue;
+      }
+      attachment->cost[idx] = s_attachment.cost[j];
+      attachment->distance[idx] = s_attachment.distance[j];
+    }
+  }
+
+  if (skip || node == NULL) {
+    return 0;
+  }
+
+  /* remember domains with source specific attached networks */
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    node->ss_attached_networks[domain->index] = false;
+    avl_for_each_element(&node->_attached_networks, attachment, _src_node) {
+      if (attachment->cost[domain->index] <= RFC7181_METRIC_MAX &&
+          netaddr_get_prefix_length(&attachment->dst->target.prefix.src) > 0) {
+        node->ss_attached_networks[domain->index] = true;
+        break;
+      }
+    }
+  }
+
+  olsrv2_tc_trigger_change(node);
+  return 0;
+}
+
+/**
+ * Write a buffer into a file, replacing the old file atomically
+ * @param file name of file
+ * @param abuf buffer with file content
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_write_file(const char *file, struct autobuf *abuf) {
+  char tmp_file[PATH_MAX];
+  FILE *f;
+  size_t written;
+
+  if (snprintf(tmp_file, sizeof(tmp_file), "%s.tmp", file) >= (int)sizeof(tmp_file)) {
+    OONF_WARN(LOG_OLSRV2, "Filename of warm restart snapshot is too long: %s", file);
+    return -1;
+  }
+
+  f = fopen(tmp_file, "w");
+  if (f == NULL) {
+    OONF_WARN(LOG_OLSRV2, "Cannot open warm restart snapshot %s: %s (%d)", tmp_file, strerror(errno), errno);
+    return -1;
+  }
+
+  written = fwrite(abuf_getptr(abuf), 1, abuf_getlen(abuf), f);
+  if (fclose(f) != 0 || written != abuf_getlen(abuf)) {
+    OONF_WARN(LOG_OLSRV2, "Cannot write warm restart snapshot %s", tmp_file);
+    unlink(tmp_file);
+    return -1;
+  }
+
+  if (rename(tmp_file, file)) {
+    OONF_WARN(LOG_OLSRV2, "Cannot rename warm restart snapshot to %s: %s (%d)", file, strerror(errno), errno);
+    unlink(tmp_file);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * Read a whole file into a buffer
+ * @param file name of file
+ * @param abuf buffer for file content
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_read_file(const char *file, struct autobuf *abuf) {
+  char buffer[4096];
+  FILE *f;
+  size_t len;
+
+  f = fopen(file, "r");
+  if (f == NULL) {
+    if (errno != ENOENT) {
+      OONF_WARN(LOG_OLSRV2, "Cannot open warm restart snapshot %s: %s (%d)", file, strerror(errno), errno);
+    }
+    return -1;
+  }
+
+  while ((len = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+    abuf_memcpy(abuf, buffer, len);
+  }
+  fclose(f);
+
+  return abuf_has_failed(abuf) ? -1 : 0;
+}
+
+/**
+ * Copy the next record of a snapshot
+ * @param abuf buffer with snapshot
+ * @param offset pointer to current read offset, will be moved behind record
+ * @param record pointer to record buffer
+ * @param len length of record
+ * @return -1 if snapshot is truncated, 0 otherwise
+ */
+static int
+_read_record(struct autobuf *abuf, size_t *offset, void *record, size_t len) {
+  if (*offset + len > abuf_getlen(abuf)) {
+    return -1;
+  }
+
+  memcpy(record, abuf_getptr(abuf) + *offset, len);
+  *offset += len;
+  return 0;
+}
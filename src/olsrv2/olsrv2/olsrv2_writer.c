@@ -59,6 +59,7 @@
 #include <oonf/olsrv2/olsrv2/olsrv2_internal.h>
 #include <oonf/olsrv2/olsrv2/olsrv2_lan.h>
 #include <oonf/olsrv2/olsrv2/olsrv2_originator.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_reader.h>
 #include <oonf/olsrv2/olsrv2/olsrv2_routing.h>
 #include <oonf/olsrv2/olsrv2/olsrv2_writer.h>
 
@@ -85,8 +86,68 @@ enum olsrv2_addrtlv_idx
   IDX_ADDRTLV_GATEWAY_SRC_PREFIX,
 };
 
+/**
+ * Key of an address advertised in TCs
+ */
+struct _tc_adv_key {
+  /*! address of neighbor or prefix of locally attached network */
+  struct os_route_key prefix;
+
+  /*! true if this is a locally attached network */
+  bool lan;
+};
+
+/**
+ * Advertised state of an address, used to generate differential TCs
+ */
+struct _tc_adv_state {
+  /*! true if the address is advertised */
+  bool active;
+
+  /*! neighbor address type, 0 for a locally attached network */
+  uint8_t nbr_addrtype;
+
+  /*! true if the gateway distance is the same for all domains */
+  bool same_distance;
+
+  /*! gateway TLV index of a locally attached network */
+  enum olsrv2_addrtlv_idx gateway_idx;
+
+  /*! encoded link metric TLVs per domain, zero if not present */
+  struct rfc7181_metric_field metric[NHDP_MAXIMUM_DOMAINS][2];
+
+  /*! gateway distance per domain */
+  uint8_t distance[NHDP_MAXIMUM_DOMAINS];
+};
+
+/**
+ * Address advertised in TCs since the last complete TC
+ */
+struct _tc_advertisement {
+  /*! address of the advertisement */
+  struct _tc_adv_key key;
+
+  /*! state generated for the last TC */
+  struct _tc_adv_state current;
+
+  /*! state advertised in the last complete TC */
+  struct _tc_adv_state baseline;
+
+  /*! true if the state changed since the last complete TC */
+  bool dirty;
+
+  /*! true if the address was found while generating the current TC */
+  bool seen;
+
+  /*! hook into tree of advertisements */
+  struct avl_node _node;
+};
+
 /* Prototypes */
 static void _send_tc(int af_type);
+static void _flush_advertisements(void);
+static int _avlcmp_tc_adv_key(const void *, const void *);
+static bool _is_state_equal(const struct _tc_adv_state *, const struct _tc_adv_state *);
 #if 0
 static bool _cb_tc_interface_selector(struct rfc5444_writer *,
     struct rfc5444_writer_target *rfc5444_target, void *ptr);
@@ -101,6 +162,8 @@ static void _cb_addAddresses(struct rfc5444_writer *);
 static void _cb_finishMessageTLVs(
   struct rfc5444_writer *, struct rfc5444_writer_address *start, struct rfc5444_writer_address *end, bool complete);
 
+static void _cb_addHelloMessageTLVs(struct rfc5444_writer *);
+
 /* definition of NHDP writer */
 static struct rfc5444_writer_message *_olsrv2_message = NULL;
 
@@ -111,6 +174,11 @@ static struct rfc5444_writer_content_provider _olsrv2_msgcontent_provider = {
   .finishMessageTLVs = _cb_finishMessageTLVs,
 };
 
+static struct rfc5444_writer_content_provider _olsrv2_hello_provider = {
+  .msg_type = RFC6130_MSGTYPE_HELLO,
+  .addMessageTLVs = _cb_addHelloMessageTLVs,
+};
+
 static struct rfc5444_writer_tlvtype _olsrv2_addrtlvs[] = {
   [IDX_ADDRTLV_NBR_ADDR_TYPE] = { .type = RFC7181_ADDRTLV_NBR_ADDR_TYPE },
   [IDX_ADDRTLV_GATEWAY_DSTSPEC] = { .type = RFC7181_ADDRTLV_GATEWAY, .exttype = RFC7181_DSTSPEC_GATEWAY },
@@ -124,6 +192,20 @@ static struct oonf_rfc5444_protocol *_protocol;
 static bool _cleanedup = false;
 static size_t _mprtypes_size;
 
+/* hop limit of the TCs currently generated */
+static uint8_t _tc_hop_limit = 255;
+
+/* differential TC generation */
+static bool _differential_tcs = false;
+static bool _tc_is_differential = false;
+
+static struct avl_tree _advertisement_tree;
+
+static struct oonf_class _advertisement_class = {
+  .name = "OLSRV2 TC advertisement",
+  .size = sizeof(struct _tc_advertisement),
+};
+
 /**
  * initialize olsrv2 writer
  * @param protocol rfc5444 protocol
@@ -133,9 +215,13 @@ int
 olsrv2_writer_init(struct oonf_rfc5444_protocol *protocol) {
   _protocol = protocol;
 
+  oonf_class_add(&_advertisement_class);
+  avl_init(&_advertisement_tree, _avlcmp_tc_adv_key, false);
+
   _olsrv2_message = rfc5444_writer_register_message(&_protocol->writer, RFC7181_MSGTYPE_TC, false);
   if (_olsrv2_message == NULL) {
     OONF_WARN(LOG_OLSRV2, "Could not register OLSRV2 TC message");
+    oonf_class_remove(&_advertisement_class);
     return -1;
   }
 
@@ -147,6 +233,16 @@ olsrv2_writer_init(struct oonf_rfc5444_protocol *protocol) {
         &_protocol->writer, &_olsrv2_msgcontent_provider, _olsrv2_addrtlvs, ARRAYSIZE(_olsrv2_addrtlvs))) {
     OONF_WARN(LOG_OLSRV2, "Count not register OLSRV2 msg contentprovider");
     rfc5444_writer_unregister_message(&_protocol->writer, _olsrv2_message);
+    oonf_class_remove(&_advertisement_class);
+    return -1;
+  }
+
+  if (rfc5444_writer_register_msgcontentprovider(&_protocol->writer, &_olsrv2_hello_provider, NULL, 0)) {
+    OONF_WARN(LOG_OLSRV2, "Count not register OLSRV2 HELLO contentprovider");
+    rfc5444_writer_unregister_content_provider(
+      &_protocol->writer, &_olsrv2_msgcontent_provider, _olsrv2_addrtlvs, ARRAYSIZE(_olsrv2_addrtlvs));
+    rfc5444_writer_unregister_message(&_protocol->writer, _olsrv2_message);
+    oonf_class_remove(&_advertisement_class);
     return -1;
   }
 
@@ -161,25 +257,49 @@ olsrv2_writer_cleanup(void) {
   _cleanedup = true;
 
   /* remove pbb writer */
+  rfc5444_writer_unregister_content_provider(&_protocol->writer, &_olsrv2_hello_provider, NULL, 0);
   rfc5444_writer_unregister_content_provider(
     &_protocol->writer, &_olsrv2_msgcontent_provider, _olsrv2_addrtlvs, ARRAYSIZE(_olsrv2_addrtlvs));
   rfc5444_writer_unregister_message(&_protocol->writer, _olsrv2_message);
+
+  _flush_advertisements();
+  oonf_class_remove(&_advertisement_class);
 }
 
 /**
  * Send a new TC message over all relevant interfaces
+ * @param hop_limit hop limit of the TC, 255 to flood it through
+ *   the whole network
+ * @param differential true to only advertise the addresses that
+ *   changed since the last complete TC, ignored if differential
+ *   TCs are not enabled
  */
 void
-olsrv2_writer_send_tc(void) {
+olsrv2_writer_send_tc(uint8_t hop_limit, bool differential) {
   if (_cleanedup) {
     /* do not send more TCs during shutdown */
     return;
   }
 
+  _tc_hop_limit = hop_limit;
+  _tc_is_differential = _differential_tcs && differential;
   _send_tc(AF_INET);
   _send_tc(AF_INET6);
 }
 
+/**
+ * Enable or disable the tracking of advertised addresses necessary
+ * for differential TCs. The next TC after enabling it must be complete.
+ * @param enable true to enable differential TCs
+ */
+void
+olsrv2_writer_set_differential_tcs(bool enable) {
+  if (!enable) {
+    _flush_advertisements();
+  }
+  _differential_tcs = enable;
+}
+
 /**
  * Set a new forwarding selector for OLSRv2 TC messages
  * @param forward_target_selector pointer to forwarding selector
@@ -211,6 +331,19 @@ _send_tc(int af_type) {
   }
 }
 
+/**
+ * Remove all tracked TC advertisements
+ */
+static void
+_flush_advertisements(void) {
+  struct _tc_advertisement *adv, *adv_it;
+
+  avl_for_each_element_safe(&_advertisement_tree, adv, _node, adv_it) {
+    avl_remove(&_advertisement_tree, &adv->_node);
+    oonf_class_free(&_advertisement_class, adv);
+  }
+}
+
 /**
  * Callback for rfc5444 writer to add message header for tc
  * @param writer RFC5444 writer instance
@@ -231,7 +364,7 @@ _cb_addMessageHeader(struct rfc5444_writer *writer, struct rfc5444_writer_messag
   rfc5444_writer_set_msg_header(writer, message, true, true, true, true);
   rfc5444_writer_set_msg_originator(writer, message, netaddr_get_binptr(orig));
   rfc5444_writer_set_msg_hopcount(writer, message, 0);
-  rfc5444_writer_set_msg_hoplimit(writer, message, 255);
+  rfc5444_writer_set_msg_hoplimit(writer, message, _tc_hop_limit);
 
   OONF_DEBUG(LOG_OLSRV2_W, "Generate TC");
   return RFC5444_OKAY;
@@ -254,19 +387,46 @@ _cb_finishMessageHeader(struct rfc5444_writer *writer, struct rfc5444_writer_mes
  */
 static void
 _cb_addMessageTLVs(struct rfc5444_writer *writer) {
-  uint8_t vtime_encoded, itime_encoded;
+  const struct olsrv2_fisheye_scope *scopes;
+  uint8_t vtime_encoded[OLSRV2_FISHEYE_MAX_SCOPES * 2 - 1];
+  uint8_t itime_encoded[OLSRV2_FISHEYE_MAX_SCOPES * 2 - 1];
   uint8_t mprtypes[NHDP_MAXIMUM_DOMAINS];
+  size_t scope_count, i, len;
 
   /* generate validity time and interval time */
-  itime_encoded = rfc5497_timetlv_encode(olsrv2_get_tc_interval());
-  vtime_encoded = rfc5497_timetlv_encode(olsrv2_get_tc_validity());
+  scopes = olsrv2_get_fisheye_scopes(&scope_count);
+  if (scope_count == 0) {
+    itime_encoded[0] = rfc5497_timetlv_encode(olsrv2_get_tc_interval());
+    vtime_encoded[0] = rfc5497_timetlv_encode(olsrv2_get_tc_validity());
+    len = 1;
+  }
+  else {
+    /*
+     * RFC 5497 hopcount dependent time vector, nodes within the hop limit
+     * of a scope get TCs of this scope (or a larger one) every
+     * 'multiplier' TC intervals.
+     */
+    len = 0;
+    for (i = 0; i < scope_count; i++) {
+      itime_encoded[len] = rfc5497_timetlv_encode(olsrv2_get_tc_interval() * scopes[i].multiplier);
+      vtime_encoded[len] = rfc5497_timetlv_encode(olsrv2_get_tc_validity() * scopes[i].multiplier);
+      len++;
+
+      if (i < scope_count - 1) {
+        /* a node at distance n receives the TC with hopcount n-1 */
+        itime_encoded[len] = scopes[i].hop_limit - 1;
+        vtime_encoded[len] = scopes[i].hop_limit - 1;
+        len++;
+      }
+    }
+  }
 
   /* allocate space for ANSN tlv */
   rfc5444_writer_allocate_messagetlv(writer, true, 2);
 
   /* add validity and interval time TLV */
-  rfc5444_writer_add_messagetlv(writer, RFC5497_MSGTLV_VALIDITY_TIME, 0, &vtime_encoded, sizeof(vtime_encoded));
-  rfc5444_writer_add_messagetlv(writer, RFC5497_MSGTLV_INTERVAL_TIME, 0, &itime_encoded, sizeof(itime_encoded));
+  rfc5444_writer_add_messagetlv(writer, RFC5497_MSGTLV_VALIDITY_TIME, 0, vtime_encoded, len);
+  rfc5444_writer_add_messagetlv(writer, RFC5497_MSGTLV_INTERVAL_TIME, 0, itime_encoded, len);
 
   /* generate mprtypes */
   _mprtypes_size = 0;
@@ -281,16 +441,25 @@ _cb_addMessageTLVs(struct rfc5444_writer *writer) {
   if (os_routing_supports_source_specific(writer->msg_addr_len == 16 ? AF_INET6 : AF_INET)) {
     rfc5444_writer_add_messagetlv(writer, DRAFT_SSR_MSGTLV_CAPABILITY, DRAFT_SSR_MSGTLV_CAPABILITY_EXT, NULL, 0);
   }
+
+  /* nodes only send differential TCs if every node and its neighbors can process them */
+  if (olsrv2_reader_neighbors_support_differential_tcs()) {
+    rfc5444_writer_add_messagetlv(
+      writer, DRAFT_DIFF_TC_MSGTLV_CAPABILITY, DRAFT_DIFF_TC_MSGTLV_CAPABILITY_EXT, NULL, 0);
+  }
 }
 
+/**
+ * Collect the encoded link metrics of a neighbor for a TC
+ * @param state advertisement state to fill
+ * @param neigh nhdp neighbor
+ */
 static void
-_generate_neighbor_metric_tlvs(
-  struct rfc5444_writer *writer, struct rfc5444_writer_address *addr, struct nhdp_neighbor *neigh) {
+_collect_neighbor_metrics(struct _tc_adv_state *state, struct nhdp_neighbor *neigh) {
   struct nhdp_neighbor_domaindata *neigh_domain;
   struct nhdp_domain *domain;
   uint32_t metric_in, metric_out;
   struct rfc7181_metric_field metric_in_encoded, metric_out_encoded;
-  bool second_tlv;
 
   list_for_each_element(nhdp_domain_get_list(), domain, _node) {
     neigh_domain = nhdp_domain_get_neighbordata(domain, neigh);
@@ -298,7 +467,6 @@ _generate_neighbor_metric_tlvs(
     /* erase metric values */
     memset(&metric_in_encoded, 0, sizeof(metric_in_encoded));
     memset(&metric_out_encoded, 0, sizeof(metric_out_encoded));
-    second_tlv = false;
 
     if (!nhdp_domain_get_neighbordata(domain, neigh)->local_is_mpr) {
       /* not an MPR, do not mention it in the TC */
@@ -325,27 +493,214 @@ _generate_neighbor_metric_tlvs(
     metric_out = neigh_domain->metric.out;
     if (rfc7181_metric_encode(&metric_out_encoded, metric_out)) {
       OONF_DEBUG(LOG_OLSRV2_W, "Encoding of metric %u failed", metric_in);
+      memset(&metric_out_encoded, 0, sizeof(metric_out_encoded));
     }
     else if (memcmp(&metric_in_encoded, &metric_out_encoded, sizeof(metric_in_encoded)) == 0) {
       /* incoming and outgoing metric are the same */
       rfc7181_metric_set_flag(&metric_in_encoded, RFC7181_LINKMETRIC_OUTGOING_NEIGH);
+      memset(&metric_out_encoded, 0, sizeof(metric_out_encoded));
     }
     else if (metric_out <= RFC7181_METRIC_MAX) {
       /* two different link metrics */
       rfc7181_metric_set_flag(&metric_out_encoded, RFC7181_LINKMETRIC_OUTGOING_NEIGH);
-      second_tlv = true;
+    }
+    else {
+      memset(&metric_out_encoded, 0, sizeof(metric_out_encoded));
+    }
+
+    state->metric[domain->index][0] = metric_in_encoded;
+    state->metric[domain->index][1] = metric_out_encoded;
+  }
+}
+
+/**
+ * Collect the gateway metrics and distances of a locally attached network
+ * @param state advertisement state to fill
+ * @param lan locally attached network
+ */
+static void
+_collect_lan_metrics(struct _tc_adv_state *state, struct olsrv2_lan_entry *lan) {
+  struct nhdp_domain *domain;
+  struct olsrv2_lan_domaindata *lan_data;
+  uint32_t metric_out;
+  struct rfc7181_metric_field metric_out_encoded;
+
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    lan_data = olsrv2_lan_get_domaindata(domain, lan);
+    metric_out = lan_data->outgoing_metric;
+    if (metric_out > RFC7181_METRIC_MAX) {
+      /* metric value does not make sense */
+      continue;
+    }
+
+    if (rfc7181_metric_encode(&metric_out_encoded, metric_out)) {
+      OONF_WARN(LOG_OLSRV2_W, "Encoding of metric %u failed", metric_out);
+      continue;
+    }
+    rfc7181_metric_set_flag(&metric_out_encoded, RFC7181_LINKMETRIC_OUTGOING_NEIGH);
+
+    state->metric[domain->index][0] = metric_out_encoded;
+
+    OONF_DEBUG(LOG_OLSRV2_W, "Gateway (ext %u) has hopcount cost %u", domain->ext, lan_data->distance);
+    state->distance[domain->index] = lan_data->distance;
+  }
+  state->same_distance = lan->same_distance;
+}
+
+/**
+ * Add an address and its TLVs to the TC
+ * @param writer RFC5444 writer instance
+ * @param key address or prefix of the advertisement
+ * @param state state of the advertisement, metrics and distances are
+ *   left out for an inactive state to signal its removal
+ */
+static void
+_add_tc_address(struct rfc5444_writer *writer, struct _tc_adv_key *key, struct _tc_adv_state *state) {
+  static const uint8_t zero_distance[NHDP_MAXIMUM_DOMAINS] = { 0 };
+  struct rfc5444_writer_address *addr;
+  struct nhdp_domain *domain;
+  const struct netaddr *dst;
+  uint8_t srcprefix[17];
+  int i;
+#ifdef OONF_LOG_DEBUG_INFO
+  struct netaddr_str nbuf1, nbuf2;
+#endif
+
+  if (key->lan && state->gateway_idx == IDX_ADDRTLV_GATEWAY_SRCSPEC_DEF) {
+    dst = &key->prefix.src;
+  }
+  else {
+    dst = &key->prefix.dst;
+  }
+
+  OONF_DEBUG(LOG_OLSRV2_W, "Add %saddress %s [%s] to TC", state->active ? "" : "removed ",
+    netaddr_to_string(&nbuf1, &key->prefix.dst), netaddr_to_string(&nbuf2, &key->prefix.src));
+  addr = rfc5444_writer_add_address(writer, _olsrv2_msgcontent_provider.creator, dst, false);
+  if (addr == NULL) {
+    OONF_WARN(LOG_OLSRV2_W, "Out of memory error for olsrv2 address");
+    return;
+  }
+
+  if (!key->lan) {
+    /* add neighbor type TLV */
+    OONF_DEBUG(LOG_OLSRV2_W, "Add NBRAddrType TLV with value %u", state->nbr_addrtype);
+    rfc5444_writer_add_addrtlv(writer, addr, &_olsrv2_addrtlvs[IDX_ADDRTLV_NBR_ADDR_TYPE], &state->nbr_addrtype,
+      sizeof(state->nbr_addrtype), false);
+  }
+
+  if (state->active) {
+    /* add linkmetric TLVs */
+    list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+      for (i = 0; i < 2; i++) {
+        if (state->metric[domain->index][i].b[0] == 0 && state->metric[domain->index][i].b[1] == 0) {
+          continue;
+        }
+
+        OONF_DEBUG(LOG_OLSRV2_W, "Add Linkmetric (ext %u) TLV with value 0x%02x%02x", domain->ext,
+          state->metric[domain->index][i].b[0], state->metric[domain->index][i].b[1]);
+        rfc5444_writer_add_addrtlv(writer, addr, &domain->_metric_addrtlvs[i], &state->metric[domain->index][i],
+          sizeof(state->metric[domain->index][i]), !key->lan);
+      }
+    }
+  }
+
+  if (!key->lan) {
+    return;
+  }
+
+  /* add Gateway TLV */
+  rfc5444_writer_add_addrtlv(writer, addr, &_olsrv2_addrtlvs[state->gateway_idx],
+    state->active ? state->distance : zero_distance, state->same_distance ? 1 : _mprtypes_size, false);
+
+  if (state->gateway_idx == IDX_ADDRTLV_GATEWAY_SRCSPEC) {
+    /* add Src Prefix TLV */
+    srcprefix[0] = netaddr_get_prefix_length(&key->prefix.src);
+    memcpy(&srcprefix[1], netaddr_get_binptr(&key->prefix.src), netaddr_get_binlength(&key->prefix.src));
+
+    rfc5444_writer_add_addrtlv(writer, addr, &_olsrv2_addrtlvs[IDX_ADDRTLV_GATEWAY_SRC_PREFIX], srcprefix,
+      1 + (netaddr_get_prefix_length(&key->prefix.src) + 7) / 8, false);
+  }
+}
+
+/**
+ * Advertise an address in the current TC. Without differential TCs the
+ * address is added directly, otherwise only its advertisement state is
+ * updated.
+ * @param writer RFC5444 writer instance
+ * @param key address or prefix of the advertisement
+ * @param state current state of the advertisement
+ */
+static void
+_advertise(struct rfc5444_writer *writer, struct _tc_adv_key *key, struct _tc_adv_state *state) {
+  struct _tc_advertisement *adv;
+
+  if (!_differential_tcs) {
+    _add_tc_address(writer, key, state);
+    return;
+  }
+
+  adv = avl_find_element(&_advertisement_tree, key, adv, _node);
+  if (adv == NULL) {
+    adv = oonf_class_malloc(&_advertisement_class);
+    if (adv == NULL) {
+      OONF_WARN(LOG_OLSRV2_W, "Out of memory error for olsrv2 advertisement");
+      if (!_tc_is_differential) {
+        _add_tc_address(writer, key, state);
+      }
+      return;
+    }
+
+    memcpy(&adv->key, key, sizeof(*key));
+    adv->_node.key = &adv->key;
+    avl_insert(&_advertisement_tree, &adv->_node);
+  }
+
+  memcpy(&adv->current, state, sizeof(*state));
+  adv->seen = true;
+}
+
+/**
+ * Add the addresses of a differential or complete TC from the
+ * tracked advertisement states
+ * @param writer RFC5444 writer instance
+ * @param af_type address family of the TC
+ */
+static void
+_add_tracked_addresses(struct rfc5444_writer *writer, int af_type) {
+  struct _tc_advertisement *adv, *adv_it;
+
+  avl_for_each_element_safe(&_advertisement_tree, adv, _node, adv_it) {
+    if (netaddr_get_address_family(&adv->key.prefix.dst) != af_type) {
+      continue;
     }
 
-    OONF_DEBUG(LOG_OLSRV2_W, "Add Linkmetric (ext %u) TLV with value 0x%02x%02x", domain->ext, metric_in_encoded.b[0],
-      metric_in_encoded.b[1]);
-    rfc5444_writer_add_addrtlv(
-      writer, addr, &domain->_metric_addrtlvs[0], &metric_in_encoded, sizeof(metric_in_encoded), true);
+    if (!adv->seen) {
+      adv->current.active = false;
+    }
+    adv->seen = false;
 
-    if (second_tlv) {
-      OONF_DEBUG(LOG_OLSRV2_W, "Add Linkmetric (ext %u) TLV with value 0x%02x%02x", domain->ext,
-        metric_out_encoded.b[0], metric_out_encoded.b[1]);
-      rfc5444_writer_add_addrtlv(
-        writer, addr, &domain->_metric_addrtlvs[1], &metric_out_encoded, sizeof(metric_out_encoded), true);
+    if (!_is_state_equal(&adv->current, &adv->baseline)) {
+      adv->dirty = true;
+    }
+
+    if (_tc_is_differential) {
+      /* only advertise what changed since the last complete TC */
+      if (adv->dirty) {
+        _add_tc_address(writer, &adv->key, &adv->current);
+      }
+      continue;
+    }
+
+    if (adv->current.active) {
+      _add_tc_address(writer, &adv->key, &adv->current);
+
+      /* this is the new baseline for differential TCs */
+      memcpy(&adv->baseline, &adv->current, sizeof(adv->baseline));
+      adv->dirty = false;
+    }
+    else {
+      avl_remove(&_advertisement_tree, &adv->_node);
+      oonf_class_free(&_advertisement_class, adv);
     }
   }
 }
@@ -356,22 +711,16 @@ _generate_neighbor_metric_tlvs(
  */
 static void
 _cb_addAddresses(struct rfc5444_writer *writer) {
-  struct rfc5444_writer_address *addr;
   struct nhdp_neighbor *neigh;
   struct nhdp_naddr *naddr;
   struct nhdp_domain *domain;
   struct olsrv2_lan_entry *lan;
-  struct olsrv2_lan_domaindata *lan_data;
+  struct _tc_adv_key key;
+  struct _tc_adv_state neigh_state, state;
   bool any_advertised;
-  uint8_t nbr_addrtype_value;
-  uint32_t metric_out;
-  struct rfc7181_metric_field metric_out_encoded;
-  uint8_t distance_vector[NHDP_MAXIMUM_DOMAINS];
   int af_type;
-  enum olsrv2_addrtlv_idx gateway_idx;
-  uint8_t srcprefix[17];
 #ifdef OONF_LOG_DEBUG_INFO
-  struct netaddr_str nbuf1, nbuf2;
+  struct netaddr_str nbuf1;
 #endif
 
   af_type = writer->msg_addr_len == 4 ? AF_INET : AF_INET6;
@@ -399,6 +748,11 @@ _cb_addAddresses(struct rfc5444_writer *writer) {
       continue;
     }
 
+    /* linkmetrics are the same for all addresses of the neighbor */
+    memset(&neigh_state, 0, sizeof(neigh_state));
+    neigh_state.active = true;
+    _collect_neighbor_metrics(&neigh_state, neigh);
+
     /* iterate over neighbors addresses */
     avl_for_each_element(&neigh->_neigh_addresses, naddr, _neigh_node) {
       if (netaddr_get_address_family(&naddr->neigh_addr) != af_type) {
@@ -411,16 +765,16 @@ _cb_addAddresses(struct rfc5444_writer *writer) {
         continue;
       }
 
-      nbr_addrtype_value = 0;
+      memcpy(&state, &neigh_state, sizeof(state));
 
       if (olsrv2_is_routable(&naddr->neigh_addr)) {
-        nbr_addrtype_value |= RFC7181_NBR_ADDR_TYPE_ROUTABLE;
+        state.nbr_addrtype |= RFC7181_NBR_ADDR_TYPE_ROUTABLE;
       }
       if (netaddr_cmp(&neigh->originator, &naddr->neigh_addr) == 0) {
-        nbr_addrtype_value |= RFC7181_NBR_ADDR_TYPE_ORIGINATOR;
+        state.nbr_addrtype |= RFC7181_NBR_ADDR_TYPE_ORIGINATOR;
       }
 
-      if (nbr_addrtype_value == 0) {
+      if (state.nbr_addrtype == 0) {
         /* skip this address */
         OONF_DEBUG(LOG_OLSRV2_W,
           "Address %s is neither routable"
@@ -429,20 +783,9 @@ _cb_addAddresses(struct rfc5444_writer *writer) {
         continue;
       }
 
-      OONF_DEBUG(LOG_OLSRV2_W, "Add address %s to TC", netaddr_to_string(&nbuf1, &naddr->neigh_addr));
-      addr = rfc5444_writer_add_address(writer, _olsrv2_msgcontent_provider.creator, &naddr->neigh_addr, false);
-      if (addr == NULL) {
-        OONF_WARN(LOG_OLSRV2_W, "Out of memory error for olsrv2 address");
-        return;
-      }
-
-      /* add neighbor type TLV */
-      OONF_DEBUG(LOG_OLSRV2_W, "Add NBRAddrType TLV with value %u", nbr_addrtype_value);
-      rfc5444_writer_add_addrtlv(writer, addr, &_olsrv2_addrtlvs[IDX_ADDRTLV_NBR_ADDR_TYPE], &nbr_addrtype_value,
-        sizeof(nbr_addrtype_value), false);
-
-      /* add linkmetric TLVs */
-      _generate_neighbor_metric_tlvs(writer, addr, neigh);
+      memset(&key, 0, sizeof(key));
+      os_routing_init_sourcespec_prefix(&key.prefix, &naddr->neigh_addr);
+      _advertise(writer, &key, &state);
     }
   }
 
@@ -453,71 +796,31 @@ _cb_addAddresses(struct rfc5444_writer *writer) {
       continue;
     }
 
-    OONF_DEBUG(LOG_OLSRV2_W, "Add address %s [%s] to TC", netaddr_to_string(&nbuf1, &lan->prefix.dst),
-      netaddr_to_string(&nbuf2, &lan->prefix.src));
+    memset(&state, 0, sizeof(state));
+    state.active = true;
 
     if (netaddr_get_prefix_length(&lan->prefix.dst) > 0 || netaddr_get_prefix_length(&lan->prefix.src) == 0) {
-      addr = rfc5444_writer_add_address(writer, _olsrv2_msgcontent_provider.creator, &lan->prefix.dst, false);
-
       if (netaddr_get_prefix_length(&lan->prefix.src) == 0) {
-        gateway_idx = IDX_ADDRTLV_GATEWAY_DSTSPEC;
+        state.gateway_idx = IDX_ADDRTLV_GATEWAY_DSTSPEC;
       }
       else {
-        gateway_idx = IDX_ADDRTLV_GATEWAY_SRCSPEC;
+        state.gateway_idx = IDX_ADDRTLV_GATEWAY_SRCSPEC;
       }
     }
     else {
-      addr = rfc5444_writer_add_address(writer, _olsrv2_msgcontent_provider.creator, &lan->prefix.src, false);
-      gateway_idx = IDX_ADDRTLV_GATEWAY_SRCSPEC_DEF;
+      state.gateway_idx = IDX_ADDRTLV_GATEWAY_SRCSPEC_DEF;
     }
-    if (addr == NULL) {
-      OONF_WARN(LOG_OLSRV2_W, "Out of memory error for olsrv2 address");
-      return;
-    }
-
-    /* add Gateway TLV and Metric TLV */
-    memset(distance_vector, 0, sizeof(distance_vector));
 
-    list_for_each_element(nhdp_domain_get_list(), domain, _node) {
-      lan_data = olsrv2_lan_get_domaindata(domain, lan);
-      metric_out = lan_data->outgoing_metric;
-      if (metric_out > RFC7181_METRIC_MAX) {
-        /* metric value does not make sense */
-        continue;
-      }
-
-      if (rfc7181_metric_encode(&metric_out_encoded, metric_out)) {
-        OONF_WARN(LOG_OLSRV2_W, "Encoding of metric %u failed", metric_out);
-        continue;
-      }
-      rfc7181_metric_set_flag(&metric_out_encoded, RFC7181_LINKMETRIC_OUTGOING_NEIGH);
+    _collect_lan_metrics(&state, lan);
 
-      /* add Metric TLV */
-      OONF_DEBUG(LOG_OLSRV2_W, "Add Linkmetric (ext %u) TLV with value 0x%02x%02x (%u)", domain->ext,
-        metric_out_encoded.b[0], metric_out_encoded.b[1], metric_out);
-      rfc5444_writer_add_addrtlv(
-        writer, addr, &domain->_metric_addrtlvs[0], &metric_out_encoded, sizeof(metric_out_encoded), false);
-
-      OONF_DEBUG(LOG_OLSRV2_W, "Gateway (ext %u) has hopcount cost %u", domain->ext, lan_data->distance);
-      distance_vector[domain->index] = lan_data->distance;
-    }
-
-    /* add Gateway TLV */
-    if (!lan->same_distance) {
-      rfc5444_writer_add_addrtlv(writer, addr, &_olsrv2_addrtlvs[gateway_idx], distance_vector, _mprtypes_size, false);
-    }
-    else {
-      rfc5444_writer_add_addrtlv(writer, addr, &_olsrv2_addrtlvs[gateway_idx], distance_vector, 1, false);
-    }
-
-    if (gateway_idx == IDX_ADDRTLV_GATEWAY_SRCSPEC) {
-      /* add Src Prefix TLV */
-      srcprefix[0] = netaddr_get_prefix_length(&lan->prefix.src);
-      memcpy(&srcprefix[1], netaddr_get_binptr(&lan->prefix.src), netaddr_get_binlength(&lan->prefix.src));
+    memset(&key, 0, sizeof(key));
+    memcpy(&key.prefix, &lan->prefix, sizeof(key.prefix));
+    key.lan = true;
+    _advertise(writer, &key, &state);
+  }
 
-      rfc5444_writer_add_addrtlv(writer, addr, &_olsrv2_addrtlvs[IDX_ADDRTLV_GATEWAY_SRC_PREFIX], srcprefix,
-        1 + (netaddr_get_prefix_length(&lan->prefix.src) + 7) / 8, false);
-    }
+  if (_differential_tcs) {
+    _add_tracked_addresses(writer, af_type);
   }
 }
 
@@ -532,10 +835,57 @@ static void
 _cb_finishMessageTLVs(struct rfc5444_writer *writer, struct rfc5444_writer_address *start __attribute__((unused)),
   struct rfc5444_writer_address *end __attribute__((unused)), bool complete) {
   uint16_t ansn;
+  uint8_t ext;
 
   /* get ANSN */
   ansn = htons(olsrv2_routing_get_ansn());
 
-  rfc5444_writer_set_messagetlv(writer, RFC7181_MSGTLV_CONT_SEQ_NUM,
-    complete ? RFC7181_CONT_SEQ_NUM_COMPLETE : RFC7181_CONT_SEQ_NUM_INCOMPLETE, &ansn, sizeof(ansn));
+  /* differential TCs are always incomplete, mark them so fragments of full TCs can be distinguished */
+  if (_tc_is_differential) {
+    ext = RFC7181_CONT_SEQ_NUM_INCOMPLETE | DRAFT_DIFF_TC_CONT_SEQ_NUM_DIFFERENTIAL;
+  }
+  else {
+    ext = complete ? RFC7181_CONT_SEQ_NUM_COMPLETE : RFC7181_CONT_SEQ_NUM_INCOMPLETE;
+  }
+
+  rfc5444_writer_set_messagetlv(writer, RFC7181_MSGTLV_CONT_SEQ_NUM, ext, &ansn, sizeof(ansn));
+}
+
+/**
+ * Callback to add the differential TC capability to HELLOs
+ * @param writer RFC5444 writer instance
+ */
+static void
+_cb_addHelloMessageTLVs(struct rfc5444_writer *writer) {
+  rfc5444_writer_add_messagetlv(writer, DRAFT_DIFF_TC_MSGTLV_CAPABILITY, DRAFT_DIFF_TC_MSGTLV_CAPABILITY_EXT, NULL, 0);
+}
+
+/**
+ * AVL comparator for TC advertisement keys
+ * @param k1 pointer to first key
+ * @param k2 pointer to second key
+ * @return <0, 0 or >0 if first key is smaller, equal or larger than the second
+ */
+static int
+_avlcmp_tc_adv_key(const void *k1, const void *k2) {
+  const struct _tc_adv_key *key1 = k1;
+  const struct _tc_adv_key *key2 = k2;
+
+  if (key1->lan != key2->lan) {
+    return key1->lan ? 1 : -1;
+  }
+  return os_routing_avl_cmp_route_key(&key1->prefix, &key2->prefix);
+}
+
+/**
+ * @param s1 first advertisement state
+ * @param s2 second advertisement state
+ * @return true if both states would result in the same TC content
+ */
+static bool
+_is_state_equal(const struct _tc_adv_state *s1, const struct _tc_adv_state *s2) {
+  if (!s1->active && !s2->active) {
+    return true;
+  }
+  return memcmp(s1, s2, sizeof(*s1)) == 0;
 }
@@ -85,6 +85,8 @@ static void _initialize_edge_values(struct olsrv2_tc_edge *edge);
 static void _initialize_route_values(struct olsrv2_routing_entry *route);
 
 static int _cb_create_text_local(struct oonf_viewer_template *);
+static int _cb_create_text_fisheye(struct oonf_viewer_template *);
+static int _cb_create_text_dijkstra(struct oonf_viewer_template *);
 static int _cb_create_text_originator(struct oonf_viewer_template *);
 static int _cb_create_text_old_originator(struct oonf_viewer_template *);
 static int _cb_create_text_lan(struct oonf_viewer_template *);
@@ -93,6 +95,16 @@ static int _cb_create_text_attached_network(struct oonf_viewer_template *);
 static int _cb_create_text_edge(struct oonf_viewer_template *);
 static int _cb_create_text_route(struct oonf_viewer_template *);
 
+static void _print_node_attached_networks(struct oonf_viewer_template *, struct olsrv2_tc_node *);
+static void _print_node_edges(struct oonf_viewer_template *, struct olsrv2_tc_node *);
+static void _print_route(struct oonf_viewer_template *, struct nhdp_domain *, struct olsrv2_routing_entry *);
+static struct olsrv2_tc_node *_get_stream_node(struct oonf_viewer_template *);
+
+static int _cb_stream_text_node(struct oonf_viewer_template *);
+static int _cb_stream_text_attached_network(struct oonf_viewer_template *);
+static int _cb_stream_text_edge(struct oonf_viewer_template *);
+static int _cb_stream_text_route(struct oonf_viewer_template *);
+
 /*
  * list of template keys and corresponding buffers for values.
  *
@@ -114,6 +126,36 @@ static int _cb_create_text_route(struct oonf_viewer_template *);
 /*! template key for local IPv6 originator */
 #define KEY_LOCAL_ORIG_V6 "local_orig6"
 
+/*! template key for hop limit of fisheye TC scope */
+#define KEY_FISHEYE_HOPLIMIT "fisheye_hoplimit"
+
+/*! template key for TC interval multiplier of fisheye TC scope */
+#define KEY_FISHEYE_MULTIPLIER "fisheye_multiplier"
+
+/*! template key for number of TCs sent with fisheye TC scope */
+#define KEY_FISHEYE_TC_SENT "fisheye_tc_sent"
+
+/*! template key for number of TCs received within fisheye TC scope */
+#define KEY_FISHEYE_TC_RECEIVED "fisheye_tc_received"
+
+/*! template key for number of dijkstra runs */
+#define KEY_DIJKSTRA_RUNS "dijkstra_runs"
+
+/*! template key for number of dijkstra triggers delayed by throttling */
+#define KEY_DIJKSTRA_DEFERRED "dijkstra_deferred"
+
+/*! template key for current hold time between two dijkstra runs */
+#define KEY_DIJKSTRA_HOLD_TIME "dijkstra_hold_time"
+
+/*! template key for duration of last dijkstra run */
+#define KEY_DIJKSTRA_LAST_DURATION "dijkstra_last_duration"
+
+/*! template key for duration of longest dijkstra run */
+#define KEY_DIJKSTRA_MAX_DURATION "dijkstra_max_duration"
+
+/*! template key for total duration of all dijkstra runs */
+#define KEY_DIJKSTRA_TOTAL_DURATION "dijkstra_total_duration"
+
 /*! template key for originator IP */
 #define KEY_ORIGINATOR "originator"
 
@@ -223,6 +265,18 @@ static struct isonumber_str _value_local_vtime;
 static struct netaddr_str _value_local_orig4;
 static struct netaddr_str _value_local_orig6;
 
+static char _value_fisheye_hoplimit[4];
+static char _value_fisheye_multiplier[4];
+static char _value_fisheye_tc_sent[11];
+static char _value_fisheye_tc_received[11];
+
+static char _value_dijkstra_runs[11];
+static char _value_dijkstra_deferred[11];
+static struct isonumber_str _value_dijkstra_hold_time;
+static struct isonumber_str _value_dijkstra_last_duration;
+static struct isonumber_str _value_dijkstra_max_duration;
+static struct isonumber_str _value_dijkstra_total_duration;
+
 static struct netaddr_str _value_originator;
 
 static struct netaddr_str _value_old_originator;
@@ -271,6 +325,22 @@ static struct abuf_template_data_entry _tde_local[] = {
   { KEY_LOCAL_ORIG_V6, _value_local_orig6.buf, true }
 };
 
+static struct abuf_template_data_entry _tde_fisheye[] = {
+  { KEY_FISHEYE_HOPLIMIT, _value_fisheye_hoplimit, false },
+  { KEY_FISHEYE_MULTIPLIER, _value_fisheye_multiplier, false },
+  { KEY_FISHEYE_TC_SENT, _value_fisheye_tc_sent, false },
+  { KEY_FISHEYE_TC_RECEIVED, _value_fisheye_tc_received, false },
+};
+
+static struct abuf_template_data_entry _tde_dijkstra[] = {
+  { KEY_DIJKSTRA_RUNS, _value_dijkstra_runs, false },
+  { KEY_DIJKSTRA_DEFERRED, _value_dijkstra_deferred, false },
+  { KEY_DIJKSTRA_HOLD_TIME, _value_dijkstra_hold_time.buf, false },
+  { KEY_DIJKSTRA_LAST_DURATION, _value_dijkstra_last_duration.buf, false },
+  { KEY_DIJKSTRA_MAX_DURATION, _value_dijkstra_max_duration.buf, false },
+  { KEY_DIJKSTRA_TOTAL_DURATION, _value_dijkstra_total_duration.buf, false },
+};
+
 static struct abuf_template_data_entry _tde_originator[] = {
   { KEY_ORIGINATOR, _value_originator.buf, true },
 };
@@ -345,6 +415,12 @@ static struct abuf_template_storage _template_storage;
 static struct abuf_template_data _td_local[] = {
   { _tde_local, ARRAYSIZE(_tde_local) },
 };
+static struct abuf_template_data _td_fisheye[] = {
+  { _tde_fisheye, ARRAYSIZE(_tde_fisheye) },
+};
+static struct abuf_template_data _td_dijkstra[] = {
+  { _tde_dijkstra, ARRAYSIZE(_tde_dijkstra) },
+};
 static struct abuf_template_data _td_orig[] = {
   { _tde_originator, ARRAYSIZE(_tde_originator) },
 };
@@ -388,6 +464,18 @@ static struct oonf_viewer_template _templates[] = {
     .json_name = "local",
     .cb_function = _cb_create_text_local,
   },
+  {
+    .data = _td_fisheye,
+    .data_size = ARRAYSIZE(_td_fisheye),
+    .json_name = "fisheye",
+    .cb_function = _cb_create_text_fisheye,
+  },
+  {
+    .data = _td_dijkstra,
+    .data_size = ARRAYSIZE(_td_dijkstra),
+    .json_name = "dijkstra",
+    .cb_function = _cb_create_text_dijkstra,
+  },
   {
     .data = _td_orig,
     .data_size = ARRAYSIZE(_td_orig),
@@ -411,24 +499,28 @@ static struct oonf_viewer_template _templates[] = {
     .data_size = ARRAYSIZE(_td_node),
     .json_name = "node",
     .cb_function = _cb_create_text_node,
+    .cb_stream = _cb_stream_text_node,
   },
   {
     .data = _td_attached_net,
     .data_size = ARRAYSIZE(_td_attached_net),
     .json_name = "attached_network",
     .cb_function = _cb_create_text_attached_network,
+    .cb_stream = _cb_stream_text_attached_network,
   },
   {
     .data = _td_edge,
     .data_size = ARRAYSIZE(_td_edge),
     .json_name = "edge",
     .cb_function = _cb_create_text_edge,
+    .cb_stream = _cb_stream_text_edge,
   },
   {
     .data = _td_route,
     .data_size = ARRAYSIZE(_td_route),
     .json_name = "route",
     .cb_function = _cb_create_text_route,
+    .cb_stream = _cb_stream_text_route,
   } };
 
 /* telnet command of this plugin */
@@ -477,8 +569,8 @@ _cleanup(void) {
  */
 static enum oonf_telnet_result
 _cb_olsrv2info(struct oonf_telnet_data *con) {
-  return oonf_viewer_telnet_handler(
-    con->out, &_template_storage, OONF_OLSRV2INFO_SUBSYSTEM, con->parameter, _templates, ARRAYSIZE(_templates));
+  return oonf_viewer_telnet_stream(
+    con, &_template_storage, OONF_OLSRV2INFO_SUBSYSTEM, _templates, ARRAYSIZE(_templates));
 }
 
 /**
@@ -672,6 +764,49 @@ _cb_create_text_local(struct oonf_viewer_template *template) {
   return 0;
 }
 
+/**
+ * Display the fisheye TC scopes and their statistics
+ * @param template oonf viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_fisheye(struct oonf_viewer_template *template) {
+  const struct olsrv2_fisheye_scope *scopes;
+  size_t i, count;
+
+  scopes = olsrv2_get_fisheye_scopes(&count);
+  for (i = 0; i < count; i++) {
+    snprintf(_value_fisheye_hoplimit, sizeof(_value_fisheye_hoplimit), "%d", scopes[i].hop_limit);
+    snprintf(_value_fisheye_multiplier, sizeof(_value_fisheye_multiplier), "%d", scopes[i].multiplier);
+    snprintf(_value_fisheye_tc_sent, sizeof(_value_fisheye_tc_sent), "%u", scopes[i].tc_sent);
+    snprintf(_value_fisheye_tc_received, sizeof(_value_fisheye_tc_received), "%u", scopes[i].tc_received);
+
+    oonf_viewer_output_print_line(template);
+  }
+  return 0;
+}
+
+/**
+ * Display the throttling state and statistics of the dijkstra calculation
+ * @param template oonf viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_dijkstra(struct oonf_viewer_template *template) {
+  const struct olsrv2_routing_statistics *stats;
+
+  stats = olsrv2_routing_get_statistics();
+  snprintf(_value_dijkstra_runs, sizeof(_value_dijkstra_runs), "%u", stats->runs);
+  snprintf(_value_dijkstra_deferred, sizeof(_value_dijkstra_deferred), "%u", stats->deferred);
+
+  oonf_clock_toIntervalString_ext(&_value_dijkstra_hold_time, stats->hold_time, template->create_raw);
+  isonumber_from_u64(&_value_dijkstra_last_duration, stats->last_duration, "s", 1000000000, template->create_raw);
+  isonumber_from_u64(&_value_dijkstra_max_duration, stats->max_duration, "s", 1000000000, template->create_raw);
+  isonumber_from_u64(&_value_dijkstra_total_duration, stats->total_duration, "s", 1000000000, template->create_raw);
+
+  oonf_viewer_output_print_line(template);
+  return 0;
+}
 
 /**
  * Display the originator addresses of the local node
@@ -742,89 +877,236 @@ _cb_create_text_node(struct oonf_viewer_template *template) {
 static int
 _cb_create_text_attached_network(struct oonf_viewer_template *template) {
   struct olsrv2_tc_node *node;
+
+  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
+    _print_node_attached_networks(template, node);
+  }
+  return 0;
+}
+
+/**
+ * Display all known OLSRv2 edges
+ * @param template oonf viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_edge(struct oonf_viewer_template *template) {
+  struct olsrv2_tc_node *node;
+
+  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
+    _print_node_edges(template, node);
+  }
+  return 0;
+}
+
+/**
+ * Display all current entries of the OLSRv2 routing table
+ * @param template oonf viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_route(struct oonf_viewer_template *template) {
+  struct olsrv2_routing_entry *route;
+  struct nhdp_domain *domain;
+
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    avl_for_each_element(olsrv2_routing_get_tree(domain), route, _node) {
+      _print_route(template, domain, route);
+    }
+  }
+  return 0;
+}
+
+/**
+ * Print all attached networks of an OLSRv2 node
+ * @param template oonf viewer template
+ * @param node OLSRv2 node
+ */
+static void
+_print_node_attached_networks(struct oonf_viewer_template *template, struct olsrv2_tc_node *node) {
   struct olsrv2_tc_attachment *attached;
   struct nhdp_domain *domain;
 
-  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
-    _initialize_node_values(node, template->create_raw);
+  _initialize_node_values(node, template->create_raw);
+
+  if (olsrv2_tc_is_node_virtual(node)) {
+    return;
+  }
+
+  avl_for_each_element(&node->_attached_networks, attached, _src_node) {
+    _initialize_attached_network_values(attached);
+
+    list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+      _initialize_domain_values(domain);
+      _initialize_domain_link_metric_values(domain, olsrv2_tc_attachment_get_metric(domain, attached));
+      _initialize_domain_distance(olsrv2_tc_attachment_get_distance(domain, attached));
+
+      oonf_viewer_output_print_line(template);
+    }
+  }
+}
 
-    if (olsrv2_tc_is_node_virtual(node)) {
+/**
+ * Print all edges of an OLSRv2 node
+ * @param template oonf viewer template
+ * @param node OLSRv2 node
+ */
+static void
+_print_node_edges(struct oonf_viewer_template *template, struct olsrv2_tc_node *node) {
+  struct olsrv2_tc_edge *edge;
+  struct nhdp_domain *domain;
+  uint32_t metric;
+
+  _initialize_node_values(node, template->create_raw);
+
+  if (olsrv2_tc_is_node_virtual(node)) {
+    return;
+  }
+  avl_for_each_element(&node->_edges, edge, _node) {
+    if (edge->virtual) {
       continue;
     }
 
-    avl_for_each_element(&node->_attached_networks, attached, _src_node) {
-      _initialize_attached_network_values(attached);
+    _initialize_edge_values(edge);
 
-      list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+      metric = olsrv2_tc_edge_get_metric(domain, edge);
+      if (metric <= RFC7181_METRIC_MAX) {
         _initialize_domain_values(domain);
-        _initialize_domain_link_metric_values(domain, olsrv2_tc_attachment_get_metric(domain, attached));
-        _initialize_domain_distance(olsrv2_tc_attachment_get_distance(domain, attached));
+        _initialize_domain_link_metric_values(domain, metric);
 
         oonf_viewer_output_print_line(template);
       }
     }
   }
-  return 0;
 }
 
 /**
- * Display all known OLSRv2 edges
+ * Print a single entry of the OLSRv2 routing table
  * @param template oonf viewer template
- * @return -1 if an error happened, 0 otherwise
+ * @param domain NHDP domain of routing entry
+ * @param route routing entry
+ */
+static void
+_print_route(
+  struct oonf_viewer_template *template, struct nhdp_domain *domain, struct olsrv2_routing_entry *route) {
+  _initialize_domain_values(domain);
+  _initialize_domain_path_metric_values(domain, route->path_cost, route->path_hops);
+  _initialize_domain_path_hops(route->path_hops);
+  _initialize_route_values(route);
+
+  oonf_viewer_output_print_line(template);
+}
+
+/**
+ * Get the next OLSRv2 node of a streamed output
+ * @param template oonf viewer template
+ * @return next OLSRv2 node, NULL if output is complete
+ */
+static struct olsrv2_tc_node *
+_get_stream_node(struct oonf_viewer_template *template) {
+  struct avl_node *avl;
+  struct olsrv2_tc_node *node;
+
+  avl = oonf_viewer_stream_next_node(olsrv2_tc_get_tree(), &template->cursor, sizeof(struct netaddr));
+  if (!avl) {
+    return NULL;
+  }
+  return container_of(avl, typeof(*node), _originator_node);
+}
+
+/**
+ * Stream all known OLSRv2 nodes
+ * @param template oonf viewer template
+ * @return -1 if an error happened, 0 if output is complete, 1 otherwise
  */
 static int
-_cb_create_text_edge(struct oonf_viewer_template *template) {
+_cb_stream_text_node(struct oonf_viewer_template *template) {
   struct olsrv2_tc_node *node;
-  struct olsrv2_tc_edge *edge;
-  struct nhdp_domain *domain;
-  uint32_t metric;
 
-  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
+  while (!oonf_viewer_output_is_chunk_full(template)) {
+    if (!(node = _get_stream_node(template))) {
+      return 0;
+    }
+
     _initialize_node_values(node, template->create_raw);
 
-    if (olsrv2_tc_is_node_virtual(node)) {
-      continue;
-    }
-    avl_for_each_element(&node->_edges, edge, _node) {
-      if (edge->virtual) {
-        continue;
-      }
+    oonf_viewer_output_print_line(template);
+  }
+  return 1;
+}
 
-      _initialize_edge_values(edge);
+/**
+ * Stream all known OLSRv2 attached networks
+ * @param template oonf viewer template
+ * @return -1 if an error happened, 0 if output is complete, 1 otherwise
+ */
+static int
+_cb_stream_text_attached_network(struct oonf_viewer_template *template) {
+  struct olsrv2_tc_node *node;
 
-      list_for_each_element(nhdp_domain_get_list(), domain, _node) {
-        metric = olsrv2_tc_edge_get_metric(domain, edge);
-        if (metric <= RFC7181_METRIC_MAX) {
-          _initialize_domain_values(domain);
-          _initialize_domain_link_metric_values(domain, metric);
+  while (!oonf_viewer_output_is_chunk_full(template)) {
+    if (!(node = _get_stream_node(template))) {
+      return 0;
+    }
+    _print_node_attached_networks(template, node);
+  }
+  return 1;
+}
 
-          oonf_viewer_output_print_line(template);
-        }
-      }
+/**
+ * Stream all known OLSRv2 edges
+ * @param template oonf viewer template
+ * @return -1 if an error happened, 0 if output is complete, 1 otherwise
+ */
+static int
+_cb_stream_text_edge(struct oonf_viewer_template *template) {
+  struct olsrv2_tc_node *node;
+
+  while (!oonf_viewer_output_is_chunk_full(template)) {
+    if (!(node = _get_stream_node(template))) {
+      return 0;
     }
+    _print_node_edges(template, node);
   }
-  return 0;
+  return 1;
 }
 
 /**
- * Display all current entries of the OLSRv2 routing table
+ * Stream all current entries of the OLSRv2 routing table,
+ * the cursor index contains the current domain index.
  * @param template oonf viewer template
- * @return -1 if an error happened, 0 otherwise
+ * @return -1 if an error happened, 0 if output is complete, 1 otherwise
  */
 static int
-_cb_create_text_route(struct oonf_viewer_template *template) {
+_cb_stream_text_route(struct oonf_viewer_template *template) {
   struct olsrv2_routing_entry *route;
   struct nhdp_domain *domain;
+  struct avl_node *avl;
 
   list_for_each_element(nhdp_domain_get_list(), domain, _node) {
-    _initialize_domain_values(domain);
+    if (domain->index < template->cursor.index) {
+      continue;
+    }
+    if (domain->index > template->cursor.index) {
+      /* start with first route of next domain */
+      template->cursor.index = domain->index;
+      template->cursor.valid = false;
+    }
 
-    avl_for_each_element(olsrv2_routing_get_tree(domain), route, _node) {
-      _initialize_domain_path_metric_values(domain, route->path_cost, route->path_hops);
-      _initialize_domain_path_hops(route->path_hops);
-      _initialize_route_values(route);
+    while (!oonf_viewer_output_is_chunk_full(template)) {
+      avl = oonf_viewer_stream_next_node(olsrv2_routing_get_tree(domain), &template->cursor,
+        sizeof(struct os_route_key));
+      if (!avl) {
+        break;
+      }
 
-      oonf_viewer_output_print_line(template);
+      route = container_of(avl, typeof(*route), _node);
+      _print_route(template, domain, route);
+    }
+
+    if (oonf_viewer_output_is_chunk_full(template)) {
+      return 1;
     }
   }
   return 0;
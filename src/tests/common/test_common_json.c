@@ -0,0 +1,100 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <oonf/libcommon/autobuf.h>
+#include <oonf/libcommon/json.h>
+
+#include <oonf/cunit/cunit.h>
+
+static struct autobuf out, scratch;
+
+static void
+clear_elements(void) {
+  abuf_clear(&out);
+  abuf_clear(&scratch);
+}
+
+static void
+test_print_raw(void) {
+  struct json_session session, fragment_session;
+
+  START_TEST();
+
+  json_init_session(&fragment_session, &scratch);
+  json_print(&fragment_session, "a", false, "1");
+  json_print(&fragment_session, "b", true, "x");
+
+  json_init_session(&session, &out);
+  json_start_object(&session, NULL);
+  json_print_raw(&session, abuf_getptr(&scratch), abuf_getlen(&scratch));
+  json_print_raw(&session, "", 0);
+  json_print(&session, "c", false, "2");
+  json_print_raw(&session, abuf_getptr(&scratch), abuf_getlen(&scratch));
+  json_end_object(&session);
+
+  CHECK_TRUE(strcmp(abuf_getptr(&out), "{\"a\":1,\"b\":\"x\",\"c\":2,\"a\":1,\"b\":\"x\"}") == 0,
+    "unexpected output: %s", abuf_getptr(&out));
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  abuf_init(&out);
+  abuf_init(&scratch);
+
+  BEGIN_TESTING(clear_elements);
+
+  test_print_raw();
+
+  abuf_free(&out);
+  abuf_free(&scratch);
+
+  return FINISH_TESTING();
+}
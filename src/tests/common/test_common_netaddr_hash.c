@@ -0,0 +1,244 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/libcommon/netaddr_hash.h>
+#include <oonf/cunit/cunit.h>
+
+struct hash_element {
+  struct netaddr addr[2];
+  struct netaddr_hash_node node;
+  bool added;
+};
+
+#define COUNT 2000
+
+static struct netaddr_hash hash;
+static struct hash_element elements[COUNT];
+
+static void clear_elements(void) {
+  uint32_t i, value;
+
+  netaddr_hash_cleanup(&hash);
+
+  memset(elements, 0, sizeof(elements));
+  for (i = 0; i < COUNT; i++) {
+    /* consecutive addresses to get similar keys */
+    value = htonl(0x0a000000 + i);
+    netaddr_from_binary(&elements[i].addr[0], &value, 4, AF_INET);
+    value = htonl(0x0a000000 + (i % 7));
+    netaddr_from_binary(&elements[i].addr[1], &value, 4, AF_INET);
+
+    elements[i].node.key = elements[i].addr;
+  }
+}
+
+static bool check_elements(void) {
+  struct hash_element *e;
+  uint32_t i, count;
+
+  count = 0;
+  for (i = 0; i < COUNT; i++) {
+    e = netaddr_hash_find_element(&hash, NULL, elements[i].addr, e, node);
+    if (elements[i].added) {
+      count++;
+      if (e != &elements[i]) {
+        return false;
+      }
+    }
+    else if (e != NULL) {
+      return false;
+    }
+  }
+  return count == hash.count;
+}
+
+static void test_add_find(void) {
+  struct netaddr addr;
+  uint32_t i;
+
+  START_TEST();
+  netaddr_hash_init(&hash, 1);
+
+  CHECK_TRUE(netaddr_hash_is_empty(&hash), "hash not empty after init");
+  CHECK_TRUE(netaddr_hash_find(&hash, NULL, elements[0].addr) == NULL, "found element in empty hash");
+
+  for (i = 0; i < COUNT; i++) {
+    CHECK_TRUE(netaddr_hash_add(&hash, &elements[i].node) == 0, "add of element %u failed", i);
+    elements[i].added = true;
+  }
+
+  CHECK_TRUE(hash.count == COUNT, "hash has %u elements instead of %u", hash.count, COUNT);
+  CHECK_TRUE(check_elements(), "lookup of elements failed");
+
+  /* same address with a different prefix length is a different key */
+  memcpy(&addr, &elements[5].addr[0], sizeof(addr));
+  netaddr_set_prefix_length(&addr, 24);
+  CHECK_TRUE(netaddr_hash_find(&hash, NULL, &addr) == NULL, "found element with different prefix length");
+
+  END_TEST();
+}
+
+static void test_remove(void) {
+  uint32_t i;
+
+  START_TEST();
+  netaddr_hash_init(&hash, 1);
+
+  for (i = 0; i < COUNT; i++) {
+    netaddr_hash_add(&hash, &elements[i].node);
+    elements[i].added = true;
+  }
+
+  for (i = 0; i < COUNT; i += 3) {
+    netaddr_hash_remove(&hash, &elements[i].node);
+    elements[i].added = false;
+  }
+  CHECK_TRUE(check_elements(), "lookup after removal failed");
+
+  /* removing an element twice must not change the hash */
+  netaddr_hash_remove(&hash, &elements[0].node);
+  CHECK_TRUE(check_elements(), "lookup after double removal failed");
+
+  for (i = 0; i < COUNT; i++) {
+    if (elements[i].added) {
+      netaddr_hash_remove(&hash, &elements[i].node);
+      elements[i].added = false;
+    }
+  }
+  CHECK_TRUE(netaddr_hash_is_empty(&hash), "hash not empty after removing all elements");
+  CHECK_TRUE(check_elements(), "lookup in empty hash failed");
+
+  END_TEST();
+}
+
+static void test_scope(void) {
+  struct netaddr_hash_node *node;
+  int scope1, scope2;
+
+  START_TEST();
+  netaddr_hash_init(&hash, 1);
+
+  elements[0].node.scope = &scope1;
+  elements[1].node.key = elements[0].addr;
+  elements[1].node.scope = &scope2;
+
+  CHECK_TRUE(netaddr_hash_add(&hash, &elements[0].node) == 0, "add of first element failed");
+  CHECK_TRUE(netaddr_hash_add(&hash, &elements[1].node) == 0, "add of second element failed");
+
+  node = netaddr_hash_find(&hash, &scope1, elements[0].addr);
+  CHECK_TRUE(node == &elements[0].node, "lookup of key in first scope failed");
+  node = netaddr_hash_find(&hash, &scope2, elements[0].addr);
+  CHECK_TRUE(node == &elements[1].node, "lookup of key in second scope failed");
+  node = netaddr_hash_find(&hash, NULL, elements[0].addr);
+  CHECK_TRUE(node == NULL, "lookup of key without scope found an element");
+
+  END_TEST();
+}
+
+static void test_key_count(void) {
+  struct netaddr key[2];
+  uint32_t i;
+
+  START_TEST();
+  netaddr_hash_init(&hash, 2);
+
+  for (i = 0; i < COUNT; i++) {
+    netaddr_hash_add(&hash, &elements[i].node);
+    elements[i].added = true;
+  }
+  CHECK_TRUE(check_elements(), "lookup with two part key failed");
+
+  /* same first address, different second one */
+  memcpy(&key[0], &elements[10].addr[0], sizeof(key[0]));
+  memcpy(&key[1], &elements[11].addr[1], sizeof(key[1]));
+  CHECK_TRUE(netaddr_hash_find(&hash, NULL, key) == NULL, "found element with different second key part");
+
+  END_TEST();
+}
+
+static void test_random(void) {
+  uint32_t i, idx;
+
+  START_TEST();
+  netaddr_hash_init(&hash, 1);
+
+  srand(0);
+  for (i = 0; i < COUNT * 20; i++) {
+    idx = rand() % COUNT;
+
+    if (elements[idx].added) {
+      netaddr_hash_remove(&hash, &elements[idx].node);
+    }
+    else {
+      netaddr_hash_add(&hash, &elements[idx].node);
+    }
+    elements[idx].added = !elements[idx].added;
+
+    if ((i % 997) == 0) {
+      CHECK_TRUE(check_elements(), "lookup failed after %u random operations", i);
+    }
+  }
+  CHECK_TRUE(check_elements(), "lookup failed after random operations");
+
+  END_TEST();
+}
+
+int main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  BEGIN_TESTING(clear_elements);
+
+  test_add_find();
+  test_remove();
+  test_scope();
+  test_key_count();
+  test_random();
+
+  netaddr_hash_cleanup(&hash);
+  return FINISH_TESTING();
+}
@@ -495,6 +495,85 @@ handler_modify_two_sections(void) {
   }
 }
 
+static void handler_count_changes(void);
+
+static void
+test_delta_no_change(void) {
+  START_TEST();
+
+  handler_1.cb_delta_handler = handler_count_changes;
+
+  cfg_db_add_entry(db_pre, SECTION_TYPE_1, NAME_1, KEY_1, value_1.value);
+  cfg_db_add_entry(db_pre, SECTION_TYPE_1, NAME_2, KEY_2, value_2.value);
+
+  cfg_db_add_entry(db_post, SECTION_TYPE_1, NAME_1, KEY_1, value_1.value);
+  cfg_db_add_entry(db_post, SECTION_TYPE_1, NAME_2, KEY_2, value_2.value);
+
+  CHECK_TRUE(cfg_schema_handle_db_changes(db_pre, db_post) == 0,
+      "delta calculation failed");
+
+  CHECK_TRUE(callback_counter == 0, "Callback counter was called %d times", callback_counter);
+  END_TEST();
+}
+
+static void
+test_delta_modify_one_of_two_sections(void) {
+  START_TEST();
+
+  handler_1.cb_delta_handler = handler_count_changes;
+
+  cfg_db_add_entry(db_pre, SECTION_TYPE_1, NAME_1, KEY_1, value_1.value);
+  cfg_db_add_entry(db_pre, SECTION_TYPE_1, NAME_2, KEY_2, value_2.value);
+
+  cfg_db_add_entry(db_post, SECTION_TYPE_1, NAME_1, KEY_1, value_1.value);
+  cfg_db_add_entry(db_post, SECTION_TYPE_1, NAME_2, KEY_2, value_3.value);
+
+  CHECK_TRUE(cfg_schema_handle_db_changes(db_pre, db_post) == 0,
+      "delta calculation failed");
+
+  CHECK_TRUE(callback_counter == 1, "Callback counter was called %d times", callback_counter);
+  CHECK_TRUE(!callback_marker[0], "Unchanged section with first name triggered");
+  CHECK_TRUE(callback_marker[1], "Changed section with second name not triggered");
+  END_TEST();
+}
+
+static void
+test_delta_modify_unnamed_defaults(void) {
+  START_TEST();
+
+  handler_1.cb_delta_handler = handler_count_changes;
+
+  cfg_db_add_entry(db_pre, SECTION_TYPE_1, NULL, KEY_2, value_2.value);
+  cfg_db_add_entry(db_pre, SECTION_TYPE_1, NAME_1, KEY_1, value_1.value);
+
+  cfg_db_add_entry(db_post, SECTION_TYPE_1, NULL, KEY_2, value_3.value);
+  cfg_db_add_entry(db_post, SECTION_TYPE_1, NAME_1, KEY_1, value_1.value);
+
+  CHECK_TRUE(cfg_schema_handle_db_changes(db_pre, db_post) == 0,
+      "delta calculation failed");
+
+  CHECK_TRUE(callback_counter == 1, "Callback counter was called %d times", callback_counter);
+  CHECK_TRUE(callback_marker[0], "Section with changed defaults not triggered");
+  END_TEST();
+}
+
+static void
+handler_count_changes(void) {
+  callback_counter++;
+
+  if (handler_1.section_name != NULL && strcmp(handler_1.section_name, NAME_1) == 0) {
+    callback_marker[0] = true;
+
+    CHECK_TRUE(!entries_1[0].delta_changed, "Key 1 did change!");
+  }
+  else if (handler_1.section_name != NULL && strcmp(handler_1.section_name, NAME_2) == 0) {
+    callback_marker[1] = true;
+
+    CHECK_TRUE(!entries_1[0].delta_changed, "Key 1 did change!");
+    CHECK_TRUE( entries_1[1].delta_changed, "Key 2 did not change!");
+  }
+}
+
 int
 main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
   cfg_schema_add(&schema);
@@ -509,6 +588,9 @@ main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
   test_delta_remove_two_sections();
   test_delta_modify_single_section();
   test_delta_modify_two_sections();
+  test_delta_no_change();
+  test_delta_modify_one_of_two_sections();
+  test_delta_modify_unnamed_defaults();
 
   abuf_free(&out);
   if (db_post) {
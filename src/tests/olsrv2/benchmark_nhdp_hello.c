@@ -0,0 +1,185 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/base/oonf_rfc5444.h>
+
+#include <oonf/nhdp/nhdp/nhdp_db.h>
+#include <oonf/nhdp/nhdp/nhdp_interfaces.h>
+#include <oonf/nhdp/nhdp/nhdp_writer.h>
+
+#include "olsrv2_harness.h"
+
+/*
+ * Measures the generation of NHDP Hellos on an interface with many
+ * links. NHDP does not send Hellos on interfaces that do not exist,
+ * so the benchmark needs an existing interface (e.g. one end of a veth pair)
+ * with an IPv4 address and has to run as root:
+ *
+ * benchmark_nhdp_hello <interface> [<hellos>]
+ */
+
+enum
+{
+  /*! number of links on the interface */
+  BENCHMARK_LINKS = 150,
+
+  /*! default number of generated Hellos */
+  BENCHMARK_HELLOS = 2000,
+
+  /*! time in milliseconds for the interface to become active */
+  BENCHMARK_START_DELAY = 2000,
+};
+
+static int _hellos = BENCHMARK_HELLOS;
+
+static struct nhdp_neighbor *_neighbors[BENCHMARK_LINKS];
+
+static int
+_add_links(void) {
+  struct nhdp_link *lnk;
+  struct netaddr addr4, addr6;
+  char buffer[64];
+  int i;
+
+  for (i = 0; i < BENCHMARK_LINKS; i++) {
+    snprintf(buffer, sizeof(buffer), "10.100.%d.%d", i / 200, i % 200 + 1);
+    if (netaddr_from_string(&addr4, buffer)) {
+      return -1;
+    }
+    snprintf(buffer, sizeof(buffer), "fe80::100:%x", i + 1);
+    if (netaddr_from_string(&addr6, buffer)) {
+      return -1;
+    }
+
+    _neighbors[i] = olsrv2_harness_add_neighbor(&addr4, 1000 + i);
+    if (_neighbors[i] == NULL) {
+      return -1;
+    }
+
+    /* every link has addresses of both families */
+    lnk = list_first_element(&_neighbors[i]->_links, lnk, _neigh_node);
+    nhdp_db_link_addr_add(lnk, &addr6);
+    nhdp_db_neighbor_addr_add(_neighbors[i], &addr6);
+  }
+  return 0;
+}
+
+static void
+_remove_links(void) {
+  int i;
+
+  for (i = 0; i < BENCHMARK_LINKS; i++) {
+    if (_neighbors[i]) {
+      olsrv2_harness_remove_neighbor(_neighbors[i]);
+    }
+  }
+}
+
+static uint64_t
+_get_nsec(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int
+_run_benchmark(void) {
+  struct nhdp_interface *interf;
+  uint64_t start, duration;
+  int i;
+
+  interf = nhdp_interface_get(olsrv2_harness_get_interface());
+  if (interf == NULL || !oonf_rfc5444_is_target_active(interf->rfc5444_if.interface->multicast4)) {
+    fprintf(stderr, "Interface %s cannot send NHDP Hellos\n", olsrv2_harness_get_interface());
+    return 1;
+  }
+
+  if (_add_links()) {
+    fprintf(stderr, "Could not create %d links\n", BENCHMARK_LINKS);
+    _remove_links();
+    return 1;
+  }
+
+  /* warm up caches and allocations */
+  for (i = 0; i < 10; i++) {
+    nhdp_writer_send_hello(interf);
+  }
+
+  start = _get_nsec();
+  for (i = 0; i < _hellos; i++) {
+    nhdp_writer_send_hello(interf);
+  }
+  duration = _get_nsec() - start;
+
+  printf("%d links, %d Hellos: %.2f us per Hello\n", BENCHMARK_LINKS, _hellos, duration / 1000.0 / _hellos);
+
+  _remove_links();
+  return 0;
+}
+
+int
+main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s <interface> [<hellos>]\n", argv[0]);
+    return 1;
+  }
+  if (argc > 2) {
+    _hellos = atoi(argv[2]);
+    if (_hellos <= 0) {
+      _hellos = BENCHMARK_HELLOS;
+    }
+  }
+
+  olsrv2_harness_set_interface(argv[1]);
+  olsrv2_harness_set_start_delay(BENCHMARK_START_DELAY);
+  return olsrv2_harness_run(argv[0], NULL, 0, _run_benchmark);
+}
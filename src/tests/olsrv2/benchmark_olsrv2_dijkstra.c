@@ -0,0 +1,268 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/netaddr.h>
+
+#include <oonf/nhdp/nhdp/nhdp_domain.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_routing.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_tc.h>
+
+#include "olsrv2_harness.h"
+
+/*
+ * Measures full dijkstra runs of several NHDP domains over a grid
+ * topology. Every domain uses different edge costs, so each domain
+ * gets its own routing tree. The local node is connected to the first
+ * row of the grid:
+ *
+ * benchmark_olsrv2_dijkstra [<domains> [<runs>]]
+ */
+
+enum
+{
+  /*! columns of the grid topology */
+  BENCHMARK_COLUMNS = 25,
+
+  /*! rows of the grid topology */
+  BENCHMARK_ROWS = 40,
+
+  /*! number of tc nodes */
+  BENCHMARK_NODES = BENCHMARK_COLUMNS * BENCHMARK_ROWS,
+
+  /*! default number of domains */
+  BENCHMARK_DOMAINS = 4,
+
+  /*! default number of dijkstra runs */
+  BENCHMARK_RUNS = 100,
+};
+
+static int _domain_count = BENCHMARK_DOMAINS;
+static int _runs = BENCHMARK_RUNS;
+
+static struct olsrv2_tc_node *_nodes[BENCHMARK_NODES];
+static struct nhdp_neighbor *_neighbors[BENCHMARK_COLUMNS];
+
+static int
+_get_originator(struct netaddr *addr, int idx) {
+  char buffer[32];
+
+  snprintf(buffer, sizeof(buffer), "10.200.%d.%d", idx / 200, idx % 200 + 1);
+  return netaddr_from_string(addr, buffer);
+}
+
+static int
+_get_attachment(struct os_route_key *key, int idx) {
+  char buffer[32];
+
+  memset(key, 0, sizeof(*key));
+  snprintf(buffer, sizeof(buffer), "10.201.%d.%d/32", idx / 200, idx % 200 + 1);
+  if (netaddr_from_string(&key->dst, buffer)) {
+    return -1;
+  }
+  return netaddr_from_string(&key->src, "0.0.0.0/0");
+}
+
+static uint32_t
+_get_cost(int from, int to, int domain) {
+  /* deterministic pseudo random costs, different for each domain */
+  return 1000 + (uint32_t)((from * 7919 + to * 104729 + domain * 1299709) % 997) * 10;
+}
+
+static int
+_add_edge(int from, int to) {
+  struct olsrv2_tc_edge *edge;
+  struct netaddr neighbor;
+  int i;
+
+  if (_get_originator(&neighbor, to)) {
+    return -1;
+  }
+  edge = olsrv2_harness_add_edge(_nodes[from], &neighbor, _get_cost(from, to, 0));
+  if (edge == NULL) {
+    return -1;
+  }
+
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    edge->cost[i] = _get_cost(from, to, i);
+  }
+  return 0;
+}
+
+static int
+_add_topology(void) {
+  struct os_route_key key;
+  struct netaddr originator;
+  int i, x, y;
+
+  for (i = 0; i < BENCHMARK_NODES; i++) {
+    if (_get_originator(&originator, i)) {
+      return -1;
+    }
+    _nodes[i] = olsrv2_harness_add_node(&originator);
+    if (_nodes[i] == NULL) {
+      return -1;
+    }
+  }
+
+  for (i = 0; i < BENCHMARK_NODES; i++) {
+    x = i % BENCHMARK_COLUMNS;
+    y = i / BENCHMARK_COLUMNS;
+
+    if ((x > 0 && _add_edge(i, i - 1)) || (x < BENCHMARK_COLUMNS - 1 && _add_edge(i, i + 1)) ||
+        (y > 0 && _add_edge(i, i - BENCHMARK_COLUMNS)) ||
+        (y < BENCHMARK_ROWS - 1 && _add_edge(i, i + BENCHMARK_COLUMNS))) {
+      return -1;
+    }
+
+    if (_get_attachment(&key, i) || olsrv2_harness_add_attachment(_nodes[i], &key, 1000, 2) == NULL) {
+      return -1;
+    }
+    olsrv2_harness_commit_node(_nodes[i]);
+  }
+
+  for (i = 0; i < BENCHMARK_COLUMNS; i++) {
+    if (_get_originator(&originator, i)) {
+      return -1;
+    }
+    _neighbors[i] = olsrv2_harness_add_neighbor(&originator, 1000 + i * 10);
+    if (_neighbors[i] == NULL) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static void
+_remove_topology(void) {
+  int i;
+
+  for (i = 0; i < BENCHMARK_COLUMNS; i++) {
+    if (_neighbors[i]) {
+      olsrv2_harness_remove_neighbor(_neighbors[i]);
+    }
+  }
+  for (i = 0; i < BENCHMARK_NODES; i++) {
+    if (_nodes[i]) {
+      olsrv2_tc_node_remove(_nodes[i]);
+    }
+  }
+}
+
+static uint64_t
+_get_nsec(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int
+_run_benchmark(void) {
+  struct nhdp_domain *domain;
+  uint64_t start, duration;
+  size_t routes;
+  int i;
+
+  if (_add_topology()) {
+    fprintf(stderr, "Could not create topology with %d nodes\n", BENCHMARK_NODES);
+    _remove_topology();
+    return 1;
+  }
+
+  /* first run creates the routing entries */
+  olsrv2_harness_run_dijkstra();
+
+  routes = 0;
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    routes += olsrv2_routing_get_tree(domain)->count;
+  }
+
+  start = _get_nsec();
+  for (i = 0; i < _runs; i++) {
+    olsrv2_routing_domain_changed(NULL, false);
+    olsrv2_harness_run_dijkstra();
+  }
+  duration = _get_nsec() - start;
+
+  printf("%d nodes, %d domains, %" PRINTF_SIZE_T_SPECIFIER " routes, %d runs: %.2f ms per dijkstra\n",
+    BENCHMARK_NODES, _domain_count, routes, _runs, duration / 1000000.0 / _runs);
+
+  _remove_topology();
+  return 0;
+}
+
+int
+main(int argc, char **argv) {
+  char settings[NHDP_MAXIMUM_DOMAINS][32];
+  const char *settings_ptr[NHDP_MAXIMUM_DOMAINS];
+  int i;
+
+  if (argc > 1) {
+    _domain_count = atoi(argv[1]);
+    if (_domain_count <= 0 || _domain_count > NHDP_MAXIMUM_DOMAINS) {
+      fprintf(stderr, "Usage: %s [<domains> [<runs>]], up to %d domains\n", argv[0], NHDP_MAXIMUM_DOMAINS);
+      return 1;
+    }
+  }
+  if (argc > 2) {
+    _runs = atoi(argv[2]);
+    if (_runs <= 0) {
+      _runs = BENCHMARK_RUNS;
+    }
+  }
+
+  /* the default domain is only used if no domain is configured */
+  for (i = 0; i < _domain_count; i++) {
+    snprintf(settings[i], sizeof(settings[i]), "domain[%d].", i);
+    settings_ptr[i] = settings[i];
+  }
+  return olsrv2_harness_run(argv[0], settings_ptr, _domain_count, _run_benchmark);
+}
@@ -0,0 +1,274 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <oonf/libcommon/autobuf.h>
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/netaddr.h>
+
+#include <oonf/olsrv2/olsrv2/olsrv2_tc.h>
+
+#include "olsrv2_harness.h"
+
+/*
+ * Measures repeated netjsoninfo dumps of the graph and the routing
+ * tree of a grid topology with an attached network at every node.
+ * Dumps after a change event of every tc node have to generate all
+ * fragments of the graph again, repeated dumps without changes can
+ * reuse them:
+ *
+ * benchmark_olsrv2_netjsoninfo [<dumps>]
+ */
+
+enum
+{
+  /*! columns of the grid topology */
+  BENCHMARK_COLUMNS = 25,
+
+  /*! rows of the grid topology */
+  BENCHMARK_ROWS = 40,
+
+  /*! number of tc nodes */
+  BENCHMARK_NODES = BENCHMARK_COLUMNS * BENCHMARK_ROWS,
+
+  /*! default number of dumps */
+  BENCHMARK_DUMPS = 100,
+};
+
+/* netjsoninfo parameter of the dumps */
+static const char *_parameter = "graph route";
+
+static int _dumps = BENCHMARK_DUMPS;
+
+static struct olsrv2_tc_node *_nodes[BENCHMARK_NODES];
+static struct nhdp_neighbor *_neighbors[BENCHMARK_COLUMNS];
+
+static int
+_get_originator(struct netaddr *addr, int idx) {
+  char buffer[32];
+
+  snprintf(buffer, sizeof(buffer), "10.200.%d.%d", idx / 200, idx % 200 + 1);
+  return netaddr_from_string(addr, buffer);
+}
+
+static int
+_get_attachment(struct os_route_key *key, int idx) {
+  char buffer[32];
+
+  memset(key, 0, sizeof(*key));
+  snprintf(buffer, sizeof(buffer), "10.201.%d.%d/32", idx / 200, idx % 200 + 1);
+  if (netaddr_from_string(&key->dst, buffer)) {
+    return -1;
+  }
+  return netaddr_from_string(&key->src, "0.0.0.0/0");
+}
+
+static int
+_add_edge(int from, int to) {
+  struct netaddr neighbor;
+
+  if (_get_originator(&neighbor, to)) {
+    return -1;
+  }
+
+  /* deterministic pseudo random costs */
+  return olsrv2_harness_add_edge(_nodes[from], &neighbor, 1000 + (uint32_t)((from * 7919 + to * 104729) % 997) * 10)
+           ? 0
+           : -1;
+}
+
+static int
+_add_topology(void) {
+  struct os_route_key key;
+  struct netaddr originator;
+  int i, x, y;
+
+  for (i = 0; i < BENCHMARK_NODES; i++) {
+    if (_get_originator(&originator, i)) {
+      return -1;
+    }
+    _nodes[i] = olsrv2_harness_add_node(&originator);
+    if (_nodes[i] == NULL) {
+      return -1;
+    }
+  }
+
+  for (i = 0; i < BENCHMARK_NODES; i++) {
+    x = i % BENCHMARK_COLUMNS;
+    y = i / BENCHMARK_COLUMNS;
+
+    if ((x > 0 && _add_edge(i, i - 1)) || (x < BENCHMARK_COLUMNS - 1 && _add_edge(i, i + 1)) ||
+        (y > 0 && _add_edge(i, i - BENCHMARK_COLUMNS)) ||
+        (y < BENCHMARK_ROWS - 1 && _add_edge(i, i + BENCHMARK_COLUMNS))) {
+      return -1;
+    }
+
+    if (_get_attachment(&key, i) || olsrv2_harness_add_attachment(_nodes[i], &key, 1000, 2) == NULL) {
+      return -1;
+    }
+    olsrv2_harness_commit_node(_nodes[i]);
+  }
+
+  for (i = 0; i < BENCHMARK_COLUMNS; i++) {
+    if (_get_originator(&originator, i)) {
+      return -1;
+    }
+    _neighbors[i] = olsrv2_harness_add_neighbor(&originator, 1000 + i * 10);
+    if (_neighbors[i] == NULL) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static void
+_remove_topology(void) {
+  int i;
+
+  for (i = 0; i < BENCHMARK_COLUMNS; i++) {
+    if (_neighbors[i]) {
+      olsrv2_harness_remove_neighbor(_neighbors[i]);
+    }
+  }
+  for (i = 0; i < BENCHMARK_NODES; i++) {
+    if (_nodes[i]) {
+      olsrv2_tc_node_remove(_nodes[i]);
+    }
+  }
+}
+
+static uint64_t
+_get_nsec(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int
+_dump(struct autobuf *out, uint64_t *duration) {
+  uint64_t start;
+  int result;
+
+  start = _get_nsec();
+  result = olsrv2_harness_telnet(out, "netjsoninfo", _parameter);
+  *duration += _get_nsec() - start;
+
+  if (result || abuf_has_failed(out)) {
+    fprintf(stderr, "netjsoninfo %s failed\n", _parameter);
+    return -1;
+  }
+  return 0;
+}
+
+static int
+_run_benchmark(void) {
+  struct autobuf changed, cached;
+  uint64_t changed_duration, cached_duration;
+  int i, j, result;
+
+  if (abuf_init(&changed) || abuf_init(&cached)) {
+    abuf_free(&changed);
+    return 1;
+  }
+
+  result = 1;
+  if (_add_topology()) {
+    fprintf(stderr, "Could not create topology with %d nodes\n", BENCHMARK_NODES);
+    goto out;
+  }
+  olsrv2_harness_run_dijkstra();
+
+  changed_duration = 0;
+  cached_duration = 0;
+  for (i = 0; i < _dumps; i++) {
+    /* every node announces a change, all fragments of the graph are generated again */
+    for (j = 0; j < BENCHMARK_NODES; j++) {
+      olsrv2_tc_trigger_change(_nodes[j]);
+    }
+    if (_dump(&changed, &changed_duration)) {
+      goto out;
+    }
+
+    /* nothing changed since the last dump */
+    if (_dump(&cached, &cached_duration)) {
+      goto out;
+    }
+  }
+
+  if (abuf_getlen(&changed) != abuf_getlen(&cached) ||
+      memcmp(abuf_getptr(&changed), abuf_getptr(&cached), abuf_getlen(&changed)) != 0) {
+    fprintf(stderr, "Cached dump differs from generated dump\n");
+    goto out;
+  }
+
+  printf("%d nodes, %" PRINTF_SIZE_T_SPECIFIER " bytes, %d dumps: %.2f ms after changes of all nodes, "
+         "%.2f ms without changes\n",
+    BENCHMARK_NODES, abuf_getlen(&cached), _dumps, changed_duration / 1000000.0 / _dumps,
+    cached_duration / 1000000.0 / _dumps);
+  result = 0;
+
+out:
+  _remove_topology();
+  abuf_free(&cached);
+  abuf_free(&changed);
+  return result;
+}
+
+int
+main(int argc, char **argv) {
+  if (argc > 1) {
+    _dumps = atoi(argv[1]);
+    if (_dumps <= 0) {
+      fprintf(stderr, "Usage: %s [<dumps>]\n", argv[0]);
+      return 1;
+    }
+  }
+  return olsrv2_harness_run(argv[0], NULL, 0, _run_benchmark);
+}
@@ -0,0 +1,348 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/base/oonf_rfc5444.h>
+#include <oonf/librfc5444/rfc5444_iana.h>
+#include <oonf/librfc5444/rfc5444_reader.h>
+#include <oonf/librfc5444/rfc5444_writer.h>
+
+#include <oonf/crypto/rfc5444_signature/rfc5444_signature.h>
+#include <oonf/nhdp/nhdp/nhdp_domain.h>
+#include <oonf/nhdp/nhdp/nhdp_interfaces.h>
+
+#include "olsrv2_harness.h"
+
+/*
+ * Measures the reception of OLSRv2 TCs without and with a HMAC-SHA256
+ * signature. The TCs are generated by the OLSRv2 writer and advertise
+ * BENCHMARK_NEIGHBORS neighbors. Each packet contains multiple TCs like
+ * packets with forwarded TCs, so the signatures of a packet are checked
+ * in one batch. There are more packets than the verification cache can
+ * remember, so every signature is calculated again.
+ *
+ * NHDP Hellos are only generated on existing interfaces, so the benchmark
+ * does not include them. The harness interface is not active, so the
+ * OLSRv2 reader stops after the message header; benchmark_olsrv2_tc_ingest
+ * measures the topology update.
+ *
+ * benchmark_olsrv2_signature [<rounds>]
+ */
+
+enum
+{
+  /*! number of advertised neighbors in each TC */
+  BENCHMARK_NEIGHBORS = 30,
+
+  /*! number of different packets, more than the verification cache */
+  BENCHMARK_PACKETS = 256,
+
+  /*! number of TCs in each packet */
+  BENCHMARK_TCS_PER_PACKET = 4,
+
+  /*! default number of rounds over all packets */
+  BENCHMARK_ROUNDS = 20,
+};
+
+static void _cb_send_packet(
+  struct rfc5444_writer *writer, struct rfc5444_writer_target *target, void *ptr, size_t len);
+static enum rfc5444_result _cb_tc(struct rfc5444_reader_tlvblock_context *context);
+static bool _cb_is_matching_signature(struct rfc5444_signature *sig, int msg_type);
+static const void *_cb_get_crypto_key(struct rfc5444_signature *sig, size_t *length);
+
+static int _rounds = BENCHMARK_ROUNDS;
+
+static struct oonf_rfc5444_protocol *_protocol;
+
+static uint8_t _packet_buffer[RFC5444_MAX_PACKET_SIZE];
+static uint8_t _packets[BENCHMARK_PACKETS][RFC5444_MAX_PACKET_SIZE];
+static size_t _packet_sizes[BENCHMARK_PACKETS];
+static size_t _current_packet;
+
+static struct rfc5444_writer_target _target = {
+  .packet_buffer = _packet_buffer,
+  .packet_size = sizeof(_packet_buffer),
+  .sendPacket = _cb_send_packet,
+};
+
+static struct rfc5444_reader_tlvblock_consumer _tc_consumer = {
+  .order = RFC5444_MAIN_PARSER_PRIORITY,
+  .msg_id = RFC7181_MSGTYPE_TC,
+  .block_callback = _cb_tc,
+};
+
+static struct rfc5444_signature _signature = {
+  .key =
+    {
+      .hash_function = RFC7182_ICV_HASH_SHA_256,
+      .crypt_function = RFC7182_ICV_CRYPT_HMAC,
+    },
+  .drop_if_invalid = true,
+  .is_matching_signature = _cb_is_matching_signature,
+  .getCryptoKey = _cb_get_crypto_key,
+};
+
+static struct nhdp_neighbor *_neighbors[BENCHMARK_NEIGHBORS];
+static struct netaddr _source;
+static union netaddr_socket _source_socket;
+static uint64_t _received;
+
+static void
+_cb_send_packet(struct rfc5444_writer *writer __attribute__((unused)),
+  struct rfc5444_writer_target *target __attribute__((unused)), void *ptr, size_t len) {
+  memcpy(_packets[_current_packet], ptr, len);
+  _packet_sizes[_current_packet] = len;
+}
+
+static enum rfc5444_result
+_cb_tc(struct rfc5444_reader_tlvblock_context *context __attribute__((unused))) {
+  _received++;
+  return RFC5444_OKAY;
+}
+
+static bool
+_cb_is_matching_signature(struct rfc5444_signature *sig __attribute__((unused)), int msg_type) {
+  return msg_type == RFC7181_MSGTYPE_TC;
+}
+
+static const void *
+_cb_get_crypto_key(struct rfc5444_signature *sig __attribute__((unused)), size_t *length) {
+  static const char *key = "benchmark";
+
+  *length = strlen(key);
+  return key;
+}
+
+static int
+_add_neighbors(void) {
+  struct nhdp_domain *domain;
+  struct netaddr addr;
+  char buffer[64];
+  int i;
+
+  for (i = 0; i < BENCHMARK_NEIGHBORS; i++) {
+    snprintf(buffer, sizeof(buffer), "10.100.%d.%d", i / 200, i % 200 + 1);
+    if (netaddr_from_string(&addr, buffer)) {
+      return -1;
+    }
+
+    _neighbors[i] = olsrv2_harness_add_neighbor(&addr, 1000 + i);
+    if (_neighbors[i] == NULL) {
+      return -1;
+    }
+
+    /* TCs only advertise MPR selectors */
+    list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+      nhdp_domain_get_neighbordata(domain, _neighbors[i])->local_is_mpr = true;
+    }
+  }
+  return 0;
+}
+
+static void
+_remove_neighbors(void) {
+  int i;
+
+  for (i = 0; i < BENCHMARK_NEIGHBORS; i++) {
+    if (_neighbors[i]) {
+      olsrv2_harness_remove_neighbor(_neighbors[i]);
+      _neighbors[i] = NULL;
+    }
+  }
+}
+
+static int
+_generate_packets(void) {
+  void (*notifier)(struct rfc5444_writer_target *);
+  int result, i;
+
+  /* the aggregation timer of the protocol only knows oonf_rfc5444 targets, flush directly instead */
+  notifier = _protocol->writer.message_generation_notifier;
+  _protocol->writer.message_generation_notifier = NULL;
+
+  result = 0;
+  for (_current_packet = 0; result == 0 && _current_packet < BENCHMARK_PACKETS; _current_packet++) {
+    _packet_sizes[_current_packet] = 0;
+
+    for (i = 0; result == 0 && i < BENCHMARK_TCS_PER_PACKET; i++) {
+      if (rfc5444_writer_create_message_singletarget(&_protocol->writer, RFC7181_MSGTYPE_TC, 4, &_target)) {
+        result = -1;
+      }
+    }
+    rfc5444_writer_flush(&_protocol->writer, &_target, true);
+
+    if (_packet_sizes[_current_packet] == 0) {
+      result = -1;
+    }
+  }
+
+  _protocol->writer.message_generation_notifier = notifier;
+  return result;
+}
+
+static uint64_t
+_get_nsec(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int
+_parse_packets(const char *name) {
+  uint64_t start, duration, expected;
+  size_t bytes;
+  int round, i;
+
+  bytes = 0;
+  for (i = 0; i < BENCHMARK_PACKETS; i++) {
+    bytes += _packet_sizes[i];
+  }
+
+  _received = 0;
+  expected = (uint64_t)_rounds * BENCHMARK_PACKETS * BENCHMARK_TCS_PER_PACKET;
+
+  start = _get_nsec();
+  for (round = 0; round < _rounds; round++) {
+    for (i = 0; i < BENCHMARK_PACKETS; i++) {
+      rfc5444_reader_handle_packet(&_protocol->reader, _packets[i], _packet_sizes[i]);
+    }
+  }
+  duration = _get_nsec() - start;
+
+  if (_received != expected) {
+    fprintf(stderr, "%s: only %" PRIu64 " of %" PRIu64 " TCs accepted\n", name, _received, expected);
+    return -1;
+  }
+
+  printf("%s: %" PRINTF_SIZE_T_SPECIFIER " bytes per packet, %.2f us per TC, %.0f TCs per second\n", name,
+    bytes / BENCHMARK_PACKETS, duration / 1000.0 / expected, 1000000000.0 * expected / duration);
+  return 0;
+}
+
+static int
+_run_benchmark(void) {
+  const struct rfc5444_sig_statistics *stats;
+  struct nhdp_interface *interf;
+  uint32_t verifications, batched;
+  int result;
+
+  _protocol = oonf_rfc5444_get_default_protocol();
+
+  interf = nhdp_interface_get(olsrv2_harness_get_interface());
+  if (interf == NULL || netaddr_from_string(&_source, "10.100.0.1") ||
+      netaddr_socket_init(&_source_socket, &_source, 269, 0)) {
+    fprintf(stderr, "Could not initialize input of %s\n", olsrv2_harness_get_interface());
+    return 1;
+  }
+
+  /* received packets come from the first neighbor */
+  _protocol->input.src_address = &_source;
+  _protocol->input.src_socket = &_source_socket;
+  _protocol->input.interface = interf->rfc5444_if.interface;
+  _protocol->input.is_multicast = true;
+
+  rfc5444_writer_register_target(&_protocol->writer, &_target);
+  rfc5444_reader_add_message_consumer(&_protocol->reader, &_tc_consumer, NULL, 0);
+
+  result = 1;
+  if (_add_neighbors()) {
+    fprintf(stderr, "Could not add %d neighbors\n", BENCHMARK_NEIGHBORS);
+    goto cleanup;
+  }
+
+  if (_generate_packets()) {
+    fprintf(stderr, "Could not generate unsigned TCs\n");
+    goto cleanup;
+  }
+  if (_parse_packets("unsigned")) {
+    goto cleanup;
+  }
+
+  rfc5444_sig_add(&_signature);
+  if (_generate_packets()) {
+    fprintf(stderr, "Could not generate signed TCs\n");
+    rfc5444_sig_remove(&_signature);
+    goto cleanup;
+  }
+
+  stats = rfc5444_sig_get_statistics();
+  verifications = stats->verifications;
+  batched = stats->batched;
+
+  if (_parse_packets("signed")) {
+    rfc5444_sig_remove(&_signature);
+    goto cleanup;
+  }
+  printf("signed: %u signatures checked, %u of them in batches\n", stats->verifications - verifications,
+    stats->batched - batched);
+
+  rfc5444_sig_remove(&_signature);
+  result = 0;
+
+cleanup:
+  _remove_neighbors();
+  rfc5444_reader_remove_message_consumer(&_protocol->reader, &_tc_consumer);
+  rfc5444_writer_unregister_target(&_protocol->writer, &_target);
+  memset(&_protocol->input, 0, sizeof(_protocol->input));
+  return result;
+}
+
+int
+main(int argc, char **argv) {
+  if (argc > 1) {
+    _rounds = atoi(argv[1]);
+    if (_rounds <= 0) {
+      _rounds = BENCHMARK_ROUNDS;
+    }
+  }
+
+  return olsrv2_harness_run(argv[0], NULL, 0, _run_benchmark);
+}
@@ -0,0 +1,208 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <oonf/libcommon/netaddr.h>
+
+#include <oonf/olsrv2/olsrv2/olsrv2_tc.h>
+
+#include "olsrv2_harness.h"
+
+/*
+ * Measures the topology database updates of received TCs. Every node
+ * advertises its neighbors on a ring and two attached networks, each
+ * round processes one TC with a new ANSN of every node, like the
+ * OLSRv2 reader does after parsing the message:
+ *
+ * benchmark_olsrv2_tc_ingest [<rounds>]
+ */
+
+enum
+{
+  /*! number of tc nodes */
+  BENCHMARK_NODES = 1000,
+
+  /*! number of advertised neighbors of each node */
+  BENCHMARK_NEIGHBORS = 8,
+
+  /*! number of attached networks of each node */
+  BENCHMARK_ATTACHMENTS = 2,
+
+  /*! default number of rounds */
+  BENCHMARK_ROUNDS = 50,
+};
+
+static int _rounds = BENCHMARK_ROUNDS;
+
+static struct netaddr _originators[BENCHMARK_NODES];
+static struct os_route_key _attachments[BENCHMARK_NODES][BENCHMARK_ATTACHMENTS];
+
+static int
+_init_addresses(void) {
+  char buffer[64];
+  int i, j;
+
+  for (i = 0; i < BENCHMARK_NODES; i++) {
+    snprintf(buffer, sizeof(buffer), "10.200.%d.%d", i / 200, i % 200 + 1);
+    if (netaddr_from_string(&_originators[i], buffer)) {
+      return -1;
+    }
+
+    for (j = 0; j < BENCHMARK_ATTACHMENTS; j++) {
+      snprintf(buffer, sizeof(buffer), "10.%d.%d.%d/32", 201 + j, i / 200, i % 200 + 1);
+      if (netaddr_from_string(&_attachments[i][j].dst, buffer) ||
+          netaddr_from_string(&_attachments[i][j].src, "0.0.0.0/0")) {
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+static int
+_ingest_tc(int idx, uint16_t ansn) {
+  struct olsrv2_tc_node *node;
+  int i, neighbor;
+
+  node = olsrv2_harness_add_node(&_originators[idx]);
+  if (node == NULL) {
+    return -1;
+  }
+  node->ansn = ansn;
+
+  for (i = 0; i < BENCHMARK_NEIGHBORS; i++) {
+    /* neighbors on both sides of the node on the ring */
+    neighbor = idx + (i % 2 ? 1 : -1) * (i / 2 + 1);
+    neighbor = (neighbor + BENCHMARK_NODES) % BENCHMARK_NODES;
+
+    if (olsrv2_harness_add_edge(node, &_originators[neighbor], 1000) == NULL) {
+      return -1;
+    }
+  }
+  for (i = 0; i < BENCHMARK_ATTACHMENTS; i++) {
+    if (olsrv2_harness_add_attachment(node, &_attachments[idx][i], 1000, 2) == NULL) {
+      return -1;
+    }
+  }
+
+  olsrv2_harness_commit_node(node);
+  return 0;
+}
+
+static void
+_remove_nodes(void) {
+  struct olsrv2_tc_node *node;
+  int i;
+
+  for (i = 0; i < BENCHMARK_NODES; i++) {
+    node = olsrv2_tc_node_get(&_originators[i]);
+    if (node) {
+      olsrv2_tc_node_remove(node);
+    }
+  }
+}
+
+static uint64_t
+_get_nsec(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int
+_run_benchmark(void) {
+  uint64_t start, duration;
+  int i, round;
+
+  if (_init_addresses()) {
+    fprintf(stderr, "Could not create addresses of %d nodes\n", BENCHMARK_NODES);
+    return 1;
+  }
+
+  /* first round creates nodes, edges and endpoints */
+  for (i = 0; i < BENCHMARK_NODES; i++) {
+    if (_ingest_tc(i, 1)) {
+      fprintf(stderr, "Could not create topology with %d nodes\n", BENCHMARK_NODES);
+      _remove_nodes();
+      return 1;
+    }
+  }
+
+  /* following rounds only refresh the existing topology */
+  start = _get_nsec();
+  for (round = 0; round < _rounds; round++) {
+    for (i = 0; i < BENCHMARK_NODES; i++) {
+      if (_ingest_tc(i, (uint16_t)(round + 2))) {
+        _remove_nodes();
+        return 1;
+      }
+    }
+  }
+  duration = _get_nsec() - start;
+
+  printf("%d nodes, %d neighbors, %d rounds: %.2f us per TC, %.0f TCs per second\n", BENCHMARK_NODES,
+    BENCHMARK_NEIGHBORS, _rounds, duration / 1000.0 / _rounds / BENCHMARK_NODES,
+    1000000000.0 * _rounds * BENCHMARK_NODES / duration);
+
+  _remove_nodes();
+  return 0;
+}
+
+int
+main(int argc, char **argv) {
+  if (argc > 1) {
+    _rounds = atoi(argv[1]);
+    if (_rounds <= 0) {
+      _rounds = BENCHMARK_ROUNDS;
+    }
+  }
+
+  return olsrv2_harness_run(argv[0], NULL, 0, _run_benchmark);
+}
@@ -0,0 +1,224 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <string.h>
+
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/list.h>
+#include <oonf/oonf.h>
+#include <oonf/libcore/oonf_subsystem.h>
+
+#include <oonf/base/os_routing.h>
+
+#include "olsrv2_harness.h"
+
+/*
+ * Simulated kernel routing table of the harness. It implements the
+ * interface of the linux os_routing subsystem, every request is
+ * processed successfully without touching the operating system.
+ */
+
+/* prototypes */
+static int _init(void);
+
+/* subsystem definition */
+static struct oonf_subsystem _harness_os_routing_subsystem = {
+  .name = OONF_OS_ROUTING_SUBSYSTEM,
+  .init = _init,
+};
+DECLARE_OONF_PLUGIN(_harness_os_routing_subsystem);
+
+/* default wildcard route */
+static const struct os_route_parameter OS_ROUTE_WILDCARD = {
+  .family = AF_UNSPEC,
+  .src_ip = { ._type = AF_UNSPEC },
+  .gw = { ._type = AF_UNSPEC },
+  .type = OS_ROUTE_UNDEFINED,
+  .key =
+    {
+      .dst = { ._type = AF_UNSPEC },
+      .src = { ._type = AF_UNSPEC },
+    },
+  .table = 0,
+  .metric = -1,
+  .protocol = 0,
+  .if_index = 0,
+};
+
+static struct list_entity _listener;
+static struct olsrv2_harness_routing_stats _stats;
+
+/**
+ * Initialize simulated routing table
+ * @return always 0
+ */
+static int
+_init(void) {
+  list_init_head(&_listener);
+  memset(&_stats, 0, sizeof(_stats));
+  return 0;
+}
+
+/**
+ * @return counters of the simulated routing table
+ */
+const struct olsrv2_harness_routing_stats *
+olsrv2_harness_get_routing_stats(void) {
+  return &_stats;
+}
+
+/**
+ * @param af_family address family
+ * @return true for IPv6, like a current linux kernel
+ */
+bool
+os_routing_linux_supports_source_specific(int af_family) {
+  return af_family == AF_INET6;
+}
+
+/**
+ * Set or remove a route, the request finishes immediately
+ * @param route route to be set/removed
+ * @param set true if route should be set, false if it should be removed
+ * @param del_similar ignored
+ * @return always 0
+ */
+int
+os_routing_linux_set(struct os_route *route, bool set, bool del_similar __attribute__((unused))) {
+  if (set) {
+    _stats.set++;
+  }
+  else {
+    _stats.removed++;
+  }
+
+  if (route->cb_finished) {
+    route->cb_finished(route, 0);
+  }
+  return 0;
+}
+
+/**
+ * Query the routing table, the simulated table reports no routes
+ * @param route routing filter
+ * @return always 0
+ */
+int
+os_routing_linux_query(struct os_route *route) {
+  if (route->cb_finished) {
+    route->cb_finished(route, 0);
+  }
+  return 0;
+}
+
+/**
+ * Requests finish immediately, so there is nothing to interrupt
+ * @param route os route
+ */
+void
+os_routing_linux_interrupt(struct os_route *route __attribute__((unused))) {}
+
+/**
+ * @param route os route
+ * @return always false, requests finish immediately
+ */
+bool
+os_routing_linux_is_in_progress(struct os_route *route __attribute__((unused))) {
+  return false;
+}
+
+/**
+ * @return always false
+ */
+bool
+os_routing_linux_supports_nexthop_objects(void) {
+  return false;
+}
+
+/**
+ * Nexthop objects are not supported by the simulated routing table
+ * @param nexthop nexthop object
+ * @param set true if nexthop should be set, false if it should be removed
+ * @return -1 for set, 0 for removal
+ */
+int
+os_routing_linux_nexthop_set(struct os_route_nexthop *nexthop __attribute__((unused)), bool set) {
+  return set ? -1 : 0;
+}
+
+/**
+ * Nexthop objects are not supported by the simulated routing table
+ * @param nexthop nexthop object
+ */
+void
+os_routing_linux_nexthop_interrupt(struct os_route_nexthop *nexthop __attribute__((unused))) {}
+
+/**
+ * Add routing change listener, the simulated table never reports changes
+ * @param listener routing change listener
+ */
+void
+os_routing_linux_listener_add(struct os_route_listener *listener) {
+  list_add_tail(&_listener, &listener->_internal._node);
+}
+
+/**
+ * Remove routing change listener
+ * @param listener routing change listener
+ */
+void
+os_routing_linux_listener_remove(struct os_route_listener *listener) {
+  list_remove(&listener->_internal._node);
+}
+
+/**
+ * Initializes a route with default values
+ * @param route route to be initialized
+ */
+void
+os_routing_linux_init_wildcard_route(struct os_route *route) {
+  memset(route, 0, sizeof(*route));
+  memcpy(&route->p, &OS_ROUTE_WILDCARD, sizeof(route->p));
+}
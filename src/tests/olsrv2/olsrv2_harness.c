@@ -0,0 +1,517 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/list.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/libcommon/netaddr_acl.h>
+#include <oonf/oonf.h>
+#include <oonf/libcore/oonf_appdata.h>
+#include <oonf/libcore/oonf_cfg.h>
+#include <oonf/libcore/oonf_main.h>
+#include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_class.h>
+#include <oonf/base/oonf_telnet.h>
+#include <oonf/base/oonf_timer.h>
+
+#include <oonf/nhdp/nhdp/nhdp.h>
+#include <oonf/nhdp/nhdp/nhdp_db.h>
+#include <oonf/nhdp/nhdp/nhdp_domain.h>
+#include <oonf/nhdp/nhdp/nhdp_interfaces.h>
+
+#include <oonf/olsrv2/olsrv2/olsrv2.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_originator.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_routing.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_tc.h>
+
+#include "olsrv2_harness.h"
+
+/* prototypes */
+static int _init(void);
+static void _cleanup(void);
+
+static void _cb_start(struct oonf_timer_instance *);
+
+/* settings every harness instance needs */
+static const char *_default_settings[] = {
+  "global.lockfile=-",
+  "telnet.bindto=" ACL_DEFAULT_REJECT,
+};
+
+/* mesh interface of the harness */
+static const char *_interface = OLSRV2_HARNESS_INTERFACE;
+static char _interface_setting[IF_NAMESIZE + 16];
+
+/* command line parameter to overwrite a setting */
+static char _set_parameter[] = "--set";
+
+/* originators of the local node */
+static const char *_originators[2] = {
+  "10.0.0.1",
+  "fd00::1",
+};
+
+/* application data of the harness */
+static struct oonf_appdata _appdata = {
+  .app_name = "olsrv2_harness",
+  .versionstring_trailer = "",
+  .help_prefix = "",
+  .help_suffix = "",
+
+  .default_lockfile = "-",
+  .default_cfg_handler = "",
+
+  .need_root = false,
+  .need_lock = false,
+};
+
+/* start of the test code in the event loop */
+static struct oonf_timer_class _start_timer_class = {
+  .name = "olsrv2 harness start",
+  .callback = _cb_start,
+};
+
+static struct oonf_timer_instance _start_timer = {
+  .class = &_start_timer_class,
+};
+
+/* test code, its start delay and its result */
+static int (*_run)(void);
+static uint64_t _start_delay = 1;
+static int _result;
+
+/* subsystem definition */
+static const char *_dependencies[] = {
+  OONF_CLASS_SUBSYSTEM,
+  OONF_TELNET_SUBSYSTEM,
+  OONF_TIMER_SUBSYSTEM,
+  OONF_NHDP_SUBSYSTEM,
+  OONF_OLSRV2_SUBSYSTEM,
+};
+
+static struct oonf_subsystem _harness_subsystem = {
+  .name = "olsrv2_harness",
+  .dependencies = _dependencies,
+  .dependencies_count = ARRAYSIZE(_dependencies),
+  .init = _init,
+  .cleanup = _cleanup,
+};
+DECLARE_OONF_PLUGIN(_harness_subsystem);
+
+/**
+ * Set the mesh interface of the harness, must be called before
+ * olsrv2_harness_run(). An existing interface makes NHDP send
+ * Hellos, which requires root privileges.
+ * @param name interface name
+ */
+void
+olsrv2_harness_set_interface(const char *name) {
+  _interface = name;
+}
+
+/**
+ * @return name of the mesh interface of the harness
+ */
+const char *
+olsrv2_harness_get_interface(void) {
+  return _interface;
+}
+
+/**
+ * Set the originators of the local node, must be called before
+ * olsrv2_harness_run(). Instances that talk to each other need
+ * different originators.
+ * @param ipv4 IPv4 originator
+ * @param ipv6 IPv6 originator
+ */
+void
+olsrv2_harness_set_originators(const char *ipv4, const char *ipv6) {
+  _originators[0] = ipv4;
+  _originators[1] = ipv6;
+}
+
+/**
+ * Set the time between the start of the instance and the test code,
+ * must be called before olsrv2_harness_run(). A longer delay gives
+ * an existing interface the time to become active.
+ * @param delay start delay in milliseconds
+ */
+void
+olsrv2_harness_set_start_delay(uint64_t delay) {
+  _start_delay = delay > 0 ? delay : 1;
+}
+
+/**
+ * Run test code inside an OLSRv2 instance. The instance uses a
+ * mesh interface that does not exist in the operating system
+ * (unless olsrv2_harness_set_interface() was called) and
+ * a simulated kernel routing table, so it needs no privileges.
+ * @param name name of the test program
+ * @param settings additional configuration entries, each one
+ *   is handled like a --set command line argument
+ * @param settings_count number of additional configuration entries
+ * @param run test code, called once when the instance is running.
+ *   If it returns OLSRV2_HARNESS_RUNNING the instance keeps running
+ *   until olsrv2_harness_stop() is called or it gets a signal.
+ * @return return value of the test code, 1 if the instance could
+ *   not be started
+ */
+int
+olsrv2_harness_run(const char *name, const char **settings, size_t settings_count, int (*run)(void)) {
+  char **argv;
+  size_t i;
+  int argc;
+
+  argv = calloc(2 * (ARRAYSIZE(_default_settings) + settings_count + 1) + 1, sizeof(char *));
+  if (argv == NULL) {
+    return 1;
+  }
+
+  argc = 0;
+  argv[argc++] = (char *)name;
+  for (i = 0; i < ARRAYSIZE(_default_settings); i++) {
+    argv[argc++] = _set_parameter;
+    argv[argc++] = (char *)_default_settings[i];
+  }
+
+  snprintf(_interface_setting, sizeof(_interface_setting), "interface[%s].", _interface);
+  argv[argc++] = _set_parameter;
+  argv[argc++] = _interface_setting;
+
+  for (i = 0; i < settings_count; i++) {
+    argv[argc++] = _set_parameter;
+    argv[argc++] = (char *)settings[i];
+  }
+
+  _run = run;
+  _result = 1;
+
+  if (oonf_main(argc, argv, &_appdata)) {
+    _result = 1;
+  }
+
+  free(argv);
+  return _result;
+}
+
+/**
+ * Stop an instance whose test code returned OLSRV2_HARNESS_RUNNING
+ * @param result return value of olsrv2_harness_run()
+ */
+void
+olsrv2_harness_stop(int result) {
+  _result = result;
+  oonf_cfg_exit();
+}
+
+/**
+ * Add a symmetric one-hop neighbor with a single link on the
+ * mesh interface of the harness
+ * @param originator originator and link address of neighbor
+ * @param metric incoming and outgoing link metric in all domains
+ * @return nhdp neighbor, NULL if an error happened
+ */
+struct nhdp_neighbor *
+olsrv2_harness_add_neighbor(const struct netaddr *originator, uint32_t metric) {
+  struct nhdp_interface *interf;
+  struct nhdp_neighbor *neigh;
+  struct nhdp_link *lnk;
+  struct nhdp_domain *domain;
+
+  interf = nhdp_interface_get(_interface);
+  if (interf == NULL) {
+    return NULL;
+  }
+
+  neigh = nhdp_db_neighbor_add();
+  if (neigh == NULL) {
+    return NULL;
+  }
+
+  lnk = nhdp_db_link_add(neigh, interf);
+  if (lnk == NULL) {
+    nhdp_db_neighbor_remove(neigh);
+    return NULL;
+  }
+
+  memcpy(&lnk->if_addr, originator, sizeof(lnk->if_addr));
+  nhdp_db_link_addr_add(lnk, originator);
+  nhdp_db_neighbor_addr_add(neigh, originator);
+  nhdp_db_neighbor_set_originator(neigh, originator);
+
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    nhdp_domain_get_linkdata(domain, lnk)->metric.in = metric;
+    nhdp_domain_get_linkdata(domain, lnk)->metric.out = metric;
+  }
+
+  /* the link stays symmetric for the lifetime of the test */
+  oonf_timer_set(&lnk->sym_time, OLSRV2_HARNESS_VTIME);
+  oonf_timer_set(&lnk->heard_time, OLSRV2_HARNESS_VTIME);
+  oonf_timer_set(&lnk->vtime, OLSRV2_HARNESS_VTIME);
+  nhdp_db_link_update_status(lnk);
+
+  return neigh;
+}
+
+/**
+ * Change the link metric of a one-hop neighbor
+ * @param neigh nhdp neighbor
+ * @param domain nhdp domain, NULL for all domains
+ * @param metric new incoming and outgoing link metric
+ */
+void
+olsrv2_harness_set_neighbor_metric(struct nhdp_neighbor *neigh, struct nhdp_domain *domain, uint32_t metric) {
+  struct nhdp_domain *d;
+  struct nhdp_link *lnk;
+
+  list_for_each_element(&neigh->_links, lnk, _neigh_node) {
+    list_for_each_element(nhdp_domain_get_list(), d, _node) {
+      if (domain == NULL || domain == d) {
+        nhdp_domain_get_linkdata(d, lnk)->metric.in = metric;
+        nhdp_domain_get_linkdata(d, lnk)->metric.out = metric;
+      }
+    }
+  }
+  nhdp_domain_recalculate_metrics(domain, neigh, true);
+}
+
+/**
+ * Remove a one-hop neighbor
+ * @param neigh nhdp neighbor
+ */
+void
+olsrv2_harness_remove_neighbor(struct nhdp_neighbor *neigh) {
+  nhdp_db_neighbor_remove(neigh);
+}
+
+/**
+ * Add a tc node or refresh an existing one, like a received TC
+ * does before it parses its addresses
+ * @param originator originator address of node
+ * @return tc node, NULL if an error happened
+ */
+struct olsrv2_tc_node *
+olsrv2_harness_add_node(const struct netaddr *originator) {
+  struct olsrv2_tc_node *node;
+  struct netaddr addr;
+
+  memcpy(&addr, originator, sizeof(addr));
+
+  node = olsrv2_tc_node_add(&addr, OLSRV2_HARNESS_VTIME, 0);
+  if (node) {
+    node->interval_time = 0;
+  }
+  return node;
+}
+
+/**
+ * Add or refresh the edge of a tc node to one of its neighbors
+ * @param node tc node
+ * @param neighbor originator of neighbor
+ * @param cost cost of the edge in both directions for all domains
+ * @return tc edge, NULL if an error happened
+ */
+struct olsrv2_tc_edge *
+olsrv2_harness_add_edge(struct olsrv2_tc_node *node, const struct netaddr *neighbor, uint32_t cost) {
+  struct olsrv2_tc_edge *edge;
+  struct netaddr addr;
+  int i;
+
+  memcpy(&addr, neighbor, sizeof(addr));
+
+  edge = olsrv2_tc_edge_add(node, &addr);
+  if (edge == NULL) {
+    return NULL;
+  }
+
+  edge->ansn = node->ansn;
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    edge->cost[i] = cost;
+    if (edge->inverse->virtual) {
+      edge->inverse->cost[i] = cost;
+    }
+  }
+  return edge;
+}
+
+/**
+ * Add or refresh an attached network of a tc node
+ * @param node tc node
+ * @param prefix prefix of attached network, might be source-specific
+ * @param cost outgoing cost of attached network for all domains
+ * @param distance distance of attached network for all domains
+ * @return tc attachment, NULL if an error happened
+ */
+struct olsrv2_tc_attachment *
+olsrv2_harness_add_attachment(
+  struct olsrv2_tc_node *node, const struct os_route_key *prefix, uint32_t cost, uint8_t distance) {
+  struct olsrv2_tc_attachment *end;
+  struct os_route_key key;
+  int i;
+
+  memcpy(&key, prefix, sizeof(key));
+
+  end = olsrv2_tc_endpoint_add(node, &key, true);
+  if (end == NULL) {
+    return NULL;
+  }
+
+  end->ansn = node->ansn;
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    end->cost[i] = cost;
+    end->distance[i] = distance;
+  }
+  return end;
+}
+
+/**
+ * Finish the changes of a tc node, like the end of a received TC
+ * @param node tc node
+ */
+void
+olsrv2_harness_commit_node(struct olsrv2_tc_node *node) {
+  struct olsrv2_tc_attachment *end;
+  struct nhdp_domain *domain;
+
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    node->ss_attached_networks[domain->index] = false;
+
+    avl_for_each_element(&node->_attached_networks, end, _src_node) {
+      if (end->cost[domain->index] <= RFC7181_METRIC_MAX &&
+          netaddr_get_prefix_length(&end->dst->target.prefix.src) > 0) {
+        node->ss_attached_networks[domain->index] = true;
+        break;
+      }
+    }
+  }
+
+  olsrv2_tc_trigger_change(node);
+  olsrv2_routing_domain_changed(NULL, false);
+}
+
+/**
+ * Run the dijkstra for all domains with pending changes now
+ */
+void
+olsrv2_harness_run_dijkstra(void) {
+  olsrv2_routing_force_update(true);
+}
+
+/**
+ * @param domain nhdp domain
+ * @param key (source-specific) prefix of route
+ * @return routing entry, NULL if not found
+ */
+struct olsrv2_routing_entry *
+olsrv2_harness_get_route(struct nhdp_domain *domain, const struct os_route_key *key) {
+  struct olsrv2_routing_entry *rtentry;
+
+  return avl_find_element(olsrv2_routing_get_tree(domain), key, rtentry, _node);
+}
+
+/**
+ * Execute a telnet command and collect its complete output
+ * @param out buffer for output of command
+ * @param command name of command
+ * @param parameter parameter of command, might be NULL
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+olsrv2_harness_telnet(struct autobuf *out, const char *command, const char *parameter) {
+  struct netaddr remote;
+
+  memcpy(&remote, &NETADDR_IPV6_LOOPBACK, sizeof(remote));
+
+  abuf_clear(out);
+  return oonf_telnet_execute(command, parameter, out, &remote) == TELNET_RESULT_ACTIVE ? 0 : -1;
+}
+
+/**
+ * Constructor of subsystem
+ * @return always 0
+ */
+static int
+_init(void) {
+  oonf_timer_add(&_start_timer_class);
+  oonf_timer_set(&_start_timer, _start_delay);
+  return 0;
+}
+
+/**
+ * Destructor of subsystem
+ */
+static void
+_cleanup(void) {
+  oonf_timer_stop(&_start_timer);
+  oonf_timer_remove(&_start_timer_class);
+}
+
+/**
+ * Callback to run the test code in the event loop
+ * @param ptr timer instance that fired
+ */
+static void
+_cb_start(struct oonf_timer_instance *ptr __attribute__((unused))) {
+  struct netaddr originator;
+  size_t i;
+
+  for (i = 0; i < ARRAYSIZE(_originators); i++) {
+    if (netaddr_from_string(&originator, _originators[i])) {
+      fprintf(stderr, "Illegal originator: %s\n", _originators[i]);
+      oonf_cfg_exit();
+      return;
+    }
+    olsrv2_originator_set(&originator);
+  }
+
+  _result = _run();
+  if (_result != OLSRV2_HARNESS_RUNNING) {
+    oonf_cfg_exit();
+  }
+}
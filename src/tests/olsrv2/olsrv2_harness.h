@@ -0,0 +1,104 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef OLSRV2_HARNESS_H_
+#define OLSRV2_HARNESS_H_
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/autobuf.h>
+#include <oonf/libcommon/netaddr.h>
+
+#include <oonf/base/os_routing.h>
+
+#include <oonf/nhdp/nhdp/nhdp_db.h>
+
+#include <oonf/olsrv2/olsrv2/olsrv2_tc.h>
+
+/*! name of the mesh interface of the harness, it does not exist in the operating system */
+#define OLSRV2_HARNESS_INTERFACE "harness0"
+
+/*! validity time of the topology created by the harness */
+#define OLSRV2_HARNESS_VTIME 3600000
+
+/*! return value of the test code to keep the instance running */
+#define OLSRV2_HARNESS_RUNNING -1
+
+/**
+ * Counters of the simulated kernel routing table
+ */
+struct olsrv2_harness_routing_stats {
+  /*! number of route set calls */
+  uint32_t set;
+
+  /*! number of route removal calls */
+  uint32_t removed;
+};
+
+void olsrv2_harness_set_interface(const char *name);
+const char *olsrv2_harness_get_interface(void);
+void olsrv2_harness_set_originators(const char *ipv4, const char *ipv6);
+void olsrv2_harness_set_start_delay(uint64_t delay);
+int olsrv2_harness_run(const char *name, const char **settings, size_t settings_count, int (*run)(void));
+void olsrv2_harness_stop(int result);
+
+struct nhdp_neighbor *olsrv2_harness_add_neighbor(const struct netaddr *originator, uint32_t metric);
+void olsrv2_harness_set_neighbor_metric(struct nhdp_neighbor *neigh, struct nhdp_domain *domain, uint32_t metric);
+void olsrv2_harness_remove_neighbor(struct nhdp_neighbor *neigh);
+
+struct olsrv2_tc_node *olsrv2_harness_add_node(const struct netaddr *originator);
+struct olsrv2_tc_edge *olsrv2_harness_add_edge(
+  struct olsrv2_tc_node *node, const struct netaddr *neighbor, uint32_t cost);
+struct olsrv2_tc_attachment *olsrv2_harness_add_attachment(
+  struct olsrv2_tc_node *node, const struct os_route_key *prefix, uint32_t cost, uint8_t distance);
+void olsrv2_harness_commit_node(struct olsrv2_tc_node *node);
+
+void olsrv2_harness_run_dijkstra(void);
+struct olsrv2_routing_entry *olsrv2_harness_get_route(struct nhdp_domain *domain, const struct os_route_key *key);
+
+int olsrv2_harness_telnet(struct autobuf *out, const char *command, const char *parameter);
+
+const struct olsrv2_harness_routing_stats *olsrv2_harness_get_routing_stats(void);
+
+#endif /* OLSRV2_HARNESS_H_ */
@@ -0,0 +1,165 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+#include <stdio.h>
+
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/librfc5444/rfc5444.h>
+#include <oonf/librfc5444/rfc5444_iana.h>
+
+#include <oonf/nhdp/nhdp/nhdp_db.h>
+#include <oonf/nhdp/nhdp/nhdp_domain.h>
+
+#include <oonf/cunit/cunit.h>
+
+#include "olsrv2_harness.h"
+
+static struct nhdp_domain *_domain;
+static uint32_t _requested, _calculated;
+
+static void
+_parse(struct netaddr *addr, const char *string) {
+  if (netaddr_from_string(addr, string)) {
+    fprintf(stderr, "Illegal address in test: %s\n", string);
+  }
+}
+
+static void
+_set_2hop_metric(struct nhdp_l2hop *l2hop, uint32_t metric) {
+  struct rfc7181_metric_field field;
+
+  rfc7181_metric_encode(&field, metric);
+  rfc7181_metric_set_flag(&field, RFC7181_LINKMETRIC_INCOMING_NEIGH);
+  nhdp_domain_process_metric_2hoptlv(_domain, l2hop, (const uint8_t *)&field);
+}
+
+static void
+_check_recalculation(const char *step, uint32_t requested, uint32_t calculated) {
+  nhdp_domain_recalculate_mpr();
+
+  CHECK_TRUE(_domain->mpr_requested - _requested == requested, "%s: %u MPR recalculations requested, expected %u",
+    step, _domain->mpr_requested - _requested, requested);
+  CHECK_TRUE(_domain->mpr_calculated - _calculated == calculated, "%s: %u MPR sets calculated, expected %u", step,
+    _domain->mpr_calculated - _calculated, calculated);
+
+  _requested = _domain->mpr_requested;
+  _calculated = _domain->mpr_calculated;
+}
+
+static void
+test_mpr_recalculation_classification(void) {
+  struct nhdp_neighbor *neigh;
+  struct nhdp_l2hop *l2hop;
+  struct nhdp_link *lnk;
+  struct netaddr originator, twohop;
+
+  START_TEST();
+
+  _domain = nhdp_domain_get_by_ext(0);
+  _parse(&originator, "fd00::2");
+  _parse(&twohop, "fd00::3");
+
+  _requested = _domain->mpr_requested;
+  _calculated = _domain->mpr_calculated;
+
+  neigh = olsrv2_harness_add_neighbor(&originator, 1000);
+  CHECK_TRUE(neigh != NULL, "could not add neighbor");
+  if (!neigh) {
+    END_TEST();
+    return;
+  }
+  lnk = list_first_element(&neigh->_links, lnk, _neigh_node);
+  _check_recalculation("new symmetric neighbor", 1, 1);
+
+  /* a received HELLO without any relevant change */
+  nhdp_domain_request_mpr_recalculation();
+  _check_recalculation("unchanged HELLO", 1, 0);
+
+  olsrv2_harness_set_neighbor_metric(neigh, NULL, 1000);
+  _check_recalculation("unchanged link metric", 0, 0);
+
+  olsrv2_harness_set_neighbor_metric(neigh, NULL, 2000);
+  _check_recalculation("changed link metric", 1, 1);
+
+  l2hop = nhdp_db_link_2hop_add(lnk, &twohop);
+  CHECK_TRUE(l2hop != NULL, "could not add 2-hop neighbor");
+  if (l2hop) {
+    _check_recalculation("new 2-hop neighbor", 1, 1);
+
+    _set_2hop_metric(l2hop, 4000);
+    _check_recalculation("changed 2-hop metric", 1, 1);
+
+    _set_2hop_metric(l2hop, 4000);
+    _check_recalculation("unchanged 2-hop metric", 0, 0);
+
+    /* 2-hop neighbors of an unreachable neighbor cannot be covered */
+    olsrv2_harness_set_neighbor_metric(neigh, NULL, RFC7181_METRIC_INFINITE);
+    _check_recalculation("unreachable neighbor", 1, 1);
+
+    _set_2hop_metric(l2hop, 8000);
+    _check_recalculation("2-hop metric of unreachable neighbor", 0, 0);
+
+    nhdp_db_link_2hop_remove(l2hop);
+    _check_recalculation("removed 2-hop neighbor", 1, 1);
+  }
+
+  olsrv2_harness_remove_neighbor(neigh);
+  _check_recalculation("removed neighbor", 1, 1);
+
+  END_TEST();
+}
+
+static int
+_run_tests(void) {
+  BEGIN_TESTING(NULL);
+
+  test_mpr_recalculation_classification();
+
+  return FINISH_TESTING();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv) {
+  return olsrv2_harness_run(argv[0], NULL, 0, _run_tests);
+}
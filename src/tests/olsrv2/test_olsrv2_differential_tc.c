@@ -0,0 +1,1164 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <net/if.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <oonf/libcommon/autobuf.h>
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/list.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/libcommon/string.h>
+#include <oonf/librfc5444/rfc5444.h>
+#include <oonf/base/oonf_clock.h>
+#include <oonf/base/oonf_timer.h>
+#include <oonf/base/os_routing.h>
+
+#include <oonf/nhdp/nhdp/nhdp_db.h>
+#include <oonf/nhdp/nhdp/nhdp_domain.h>
+#include <oonf/olsrv2/olsrv2/olsrv2.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_lan.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_routing.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_tc.h>
+
+#include <oonf/cunit/cunit.h>
+
+#include "olsrv2_harness.h"
+
+/*
+ * Simulation of differential and fragmented TCs. In the first scenario
+ * the sender uses differential TCs with a fisheye schedule. Three
+ * harness instances run in their own network namespaces and are
+ * connected by veth pairs:
+ *
+ *   sender --- relay --- receiver
+ *
+ * The sender floods every fourth TC through the whole network, all
+ * other TCs only reach the relay. Every third full range TC is
+ * complete. While sending TCs the sender changes its locally attached
+ * networks and reports the set it advertises with each ANSN. Relay
+ * and receiver report their view of the sender for every ANSN they
+ * learn. With complete TCs both views would always match the set
+ * advertised with the ANSN, differential TCs must not change this.
+ *
+ * The second scenario enables differential TCs too, but the simulated
+ * neighbors of the sender do not announce that they can process them,
+ * so the sender must fall back to full TCs. It advertises so many
+ * attached networks that every full TC is split into multiple
+ * fragments and drops one of its neighbors after a few TCs. Relay and
+ * receiver must drop the edge to this neighbor without losing the
+ * edges and attached networks of the other fragments.
+ *
+ * The namespaces are created as an unprivileged user, the test is
+ * skipped if user namespaces or the ip tool are not available.
+ */
+
+enum
+{
+  /*! exit code of a skipped test */
+  SKIP_TEST = 77,
+
+  /*! interval of the timer that runs the node scenarios */
+  POLL_INTERVAL = 10,
+
+  /*! time the sender waits for the relay to select it as an MPR selector */
+  SETTLE_TIME = 500,
+
+  /*! time the sender waits for the network */
+  CONVERGENCE_TIMEOUT = 10000,
+
+  /*! time the sender keeps running after the last TC */
+  SHUTDOWN_DELAY = 300,
+
+  /*! number of TCs the sender generates */
+  TC_COUNT = 17,
+
+  /*! maximum number of reported items of a node view */
+  MAX_ITEMS = 16,
+
+  /*! number of attached networks that split a full TC into fragments */
+  FRAGMENTED_LAN_COUNT = 2048,
+
+  /*! number of simulated neighbors of the sender in the fragmented TC scenario */
+  FAKE_NEIGHBOR_COUNT = 8,
+
+  /*! the first simulated neighbor is dropped when this number of TCs has been generated */
+  DROP_NEIGHBOR_TC_COUNT = 5,
+};
+
+/* roles of the simulated nodes */
+enum _role
+{
+  _SENDER,
+  _RELAY,
+  _RECEIVER,
+  _ROLE_COUNT,
+};
+
+/* phases of the sender scenario */
+enum _sender_phase
+{
+  _WAIT_FOR_RECEIVER,
+  _SETTLE,
+  _SEND_TCS,
+  _SHUTDOWN,
+};
+
+/**
+ * Change of the attached networks of the sender
+ */
+struct _lan_change {
+  /*! the change is applied when this number of TCs has been generated */
+  uint32_t tc_count;
+
+  /*! true to add the prefix, false to remove it */
+  bool add;
+
+  /*! attached network */
+  const char *prefix;
+};
+
+/**
+ * Scenario of the simulation
+ */
+struct _scenario {
+  /*! settings of all simulated nodes */
+  const char **settings;
+
+  /*! number of settings */
+  size_t settings_count;
+
+  /*! prepare the sender when the network is ready */
+  void (*setup)(void);
+
+  /*! change the advertised state of the sender */
+  void (*change)(uint32_t tc_count);
+
+  /*! report the state the sender advertises with the current ANSN */
+  void (*report_sender)(void);
+
+  /*! report the view of an observer of the sender */
+  void (*report_observer)(struct olsrv2_tc_node *sender);
+
+  /*! true if observers keep outdated items until the next round of TC fragments */
+  bool fragmented;
+
+  /*! true if the sender must generate differential TCs */
+  bool differential_tcs;
+};
+
+/**
+ * Simulated node
+ */
+struct _node {
+  /*! name of the node */
+  const char *name;
+
+  /*! IPv4 and IPv6 originator */
+  const char *originator[2];
+
+  /*! mesh interfaces, NULL if not used */
+  const char *interfaces[2];
+
+  /*! addresses of the mesh interfaces */
+  const char *addresses[2];
+
+  /*! scenario of the node */
+  int (*run)(void);
+
+  /*! process id of the node */
+  pid_t pid;
+
+  /*! pipe to signal that the network namespace exists */
+  int ready[2];
+
+  /*! pipe to signal that the interfaces exist */
+  int go[2];
+
+  /*! pipe for the reports of the node */
+  int output[2];
+
+  /*! reports of the node */
+  struct autobuf report;
+};
+
+static int _run_sender(void);
+static int _run_observer(void);
+
+static struct _node _nodes[_ROLE_COUNT] = {
+  [_SENDER] =
+    {
+      .name = "sender",
+      .originator = { "10.0.0.1", "fd00::1" },
+      .interfaces = { "sim_s" },
+      .addresses = { "10.1.0.1/24" },
+      .run = _run_sender,
+    },
+  [_RELAY] =
+    {
+      .name = "relay",
+      .originator = { "10.0.0.2", "fd00::2" },
+      .interfaces = { "sim_rs", "sim_rr" },
+      .addresses = { "10.1.0.2/24", "10.2.0.2/24" },
+      .run = _run_observer,
+    },
+  [_RECEIVER] =
+    {
+      .name = "receiver",
+      .originator = { "10.0.0.3", "fd00::3" },
+      .interfaces = { "sim_r" },
+      .addresses = { "10.2.0.3/24" },
+      .run = _run_observer,
+    },
+};
+
+/* attached networks of the sender and their changes */
+static const char *_initial_prefixes[] = {
+  "10.10.0.0/24",
+  "10.11.0.0/24",
+};
+
+static const struct _lan_change _lan_changes[] = {
+  { .tc_count = 3, .add = true, .prefix = "10.12.0.0/24" },
+  { .tc_count = 5, .add = false, .prefix = "10.10.0.0/24" },
+  { .tc_count = 9, .add = true, .prefix = "10.13.0.0/24" },
+};
+
+/* settings of the differential TC scenario */
+static const char *_differential_settings[] = {
+  "olsrv2.tc_interval=0.2",
+  "olsrv2.fisheye=1 1",
+  "olsrv2.fisheye=255 4",
+  "olsrv2.differential_tc_factor=3",
+};
+
+/* settings of the fragmented TC scenario, a single scope counts the generated TCs */
+static const char *_fragmented_settings[] = {
+  "olsrv2.tc_interval=0.2",
+  "olsrv2.fisheye=255 1",
+  "olsrv2.differential_tc_factor=3",
+};
+
+static void _setup_lans(void);
+static void _change_lans(uint32_t tc_count);
+static void _report_sender_lans(void);
+static void _report_observer_lans(struct olsrv2_tc_node *sender);
+
+static void _setup_fragmented(void);
+static void _change_fragmented(uint32_t tc_count);
+static void _report_sender_fragmented(void);
+static void _report_observer_fragmented(struct olsrv2_tc_node *sender);
+
+static const struct _scenario _differential_scenario = {
+  .settings = _differential_settings,
+  .settings_count = ARRAYSIZE(_differential_settings),
+  .setup = _setup_lans,
+  .change = _change_lans,
+  .report_sender = _report_sender_lans,
+  .report_observer = _report_observer_lans,
+  .differential_tcs = true,
+};
+
+static const struct _scenario _fragmented_scenario = {
+  .settings = _fragmented_settings,
+  .settings_count = ARRAYSIZE(_fragmented_settings),
+  .setup = _setup_fragmented,
+  .change = _change_fragmented,
+  .report_sender = _report_sender_fragmented,
+  .report_observer = _report_observer_fragmented,
+  .fragmented = true,
+};
+
+/* simulated neighbors of the sender in the fragmented TC scenario */
+static struct nhdp_neighbor *_fake_neighbors[FAKE_NEIGHBOR_COUNT];
+
+/* state of the node scenario running in this process */
+static const struct _scenario *_scenario;
+static struct _node *_local;
+static enum _sender_phase _phase;
+static uint64_t _phase_start;
+static size_t _next_change;
+static char _last_report[512];
+
+static void _cb_poll(struct oonf_timer_instance *);
+
+static struct oonf_timer_class _poll_class = {
+  .name = "differential tc simulation",
+  .callback = _cb_poll,
+  .periodic = true,
+};
+
+static struct oonf_timer_instance _poll_timer = {
+  .class = &_poll_class,
+};
+
+static int
+_cmp_strings(const void *p1, const void *p2) {
+  return strcmp(*(const char *const *)p1, *(const char *const *)p2);
+}
+
+/**
+ * Print a line of the node report if it changed
+ * @param ansn answer set number
+ * @param items array of reported items, will be sorted
+ * @param count number of reported items
+ */
+static void
+_report(uint16_t ansn, const char **items, size_t count) {
+  char line[sizeof(_last_report)];
+  size_t i, len;
+
+  qsort(items, count, sizeof(*items), _cmp_strings);
+
+  len = snprintf(line, sizeof(line), "%u", ansn);
+  for (i = 0; i < count && len < sizeof(line); i++) {
+    len += snprintf(&line[len], sizeof(line) - len, " %s", items[i]);
+  }
+
+  if (strcmp(line, _last_report) != 0) {
+    strscpy(_last_report, line, sizeof(_last_report));
+    printf("%s\n", line);
+    fflush(stdout);
+  }
+}
+
+/**
+ * Report the attached networks the sender advertises with the current ANSN
+ */
+static void
+_report_sender_lans(void) {
+  struct netaddr_str nbuf[MAX_ITEMS];
+  const char *prefixes[MAX_ITEMS];
+  struct olsrv2_lan_entry *lan;
+  size_t count;
+
+  count = 0;
+  avl_for_each_element(olsrv2_lan_get_tree(), lan, _node) {
+    if (count < MAX_ITEMS) {
+      prefixes[count] = netaddr_to_string(&nbuf[count], &lan->prefix.dst);
+      count++;
+    }
+  }
+  _report(olsrv2_routing_get_ansn(), prefixes, count);
+}
+
+/**
+ * Report the attached networks of the sender known to this node
+ * @param sender tc node of the sender
+ */
+static void
+_report_observer_lans(struct olsrv2_tc_node *sender) {
+  struct netaddr_str nbuf[MAX_ITEMS];
+  const char *prefixes[MAX_ITEMS];
+  struct olsrv2_tc_attachment *attached;
+  size_t count;
+
+  count = 0;
+  avl_for_each_element(&sender->_attached_networks, attached, _src_node) {
+    if (count < MAX_ITEMS) {
+      prefixes[count] = netaddr_to_string(&nbuf[count], &attached->dst->target.prefix.dst);
+      count++;
+    }
+  }
+  _report(sender->ansn, prefixes, count);
+}
+
+/**
+ * Report the simulated neighbors and the number of attached networks
+ * the sender advertises with the current ANSN
+ */
+static void
+_report_sender_fragmented(void) {
+  struct netaddr_str nbuf[FAKE_NEIGHBOR_COUNT];
+  const char *items[FAKE_NEIGHBOR_COUNT + 1];
+  char lans[32];
+  size_t i, count;
+
+  count = 0;
+  for (i = 0; i < FAKE_NEIGHBOR_COUNT; i++) {
+    if (_fake_neighbors[i]) {
+      items[count] = netaddr_to_string(&nbuf[count], &_fake_neighbors[i]->originator);
+      count++;
+    }
+  }
+
+  snprintf(lans, sizeof(lans), "lans=%u", olsrv2_lan_get_tree()->count);
+  items[count++] = lans;
+  _report(olsrv2_routing_get_ansn(), items, count);
+}
+
+/**
+ * Report the edges to the simulated neighbors and the number of
+ * attached networks of the sender known to this node
+ * @param sender tc node of the sender
+ */
+static void
+_report_observer_fragmented(struct olsrv2_tc_node *sender) {
+  struct netaddr_str nbuf[FAKE_NEIGHBOR_COUNT];
+  const char *items[FAKE_NEIGHBOR_COUNT + 1];
+  struct olsrv2_tc_edge *edge;
+  struct netaddr fake_subnet;
+  char lans[32];
+  size_t count;
+
+  if (netaddr_from_string(&fake_subnet, "10.50.0.0/24")) {
+    return;
+  }
+
+  count = 0;
+  avl_for_each_element(&sender->_edges, edge, _node) {
+    if (count < FAKE_NEIGHBOR_COUNT && !edge->virtual &&
+        netaddr_is_in_subnet(&fake_subnet, &edge->dst->target.prefix.dst)) {
+      items[count] = netaddr_to_string(&nbuf[count], &edge->dst->target.prefix.dst);
+      count++;
+    }
+  }
+
+  /* the sender has no other attached networks in this scenario */
+  snprintf(lans, sizeof(lans), "lans=%u", sender->_attached_networks.count);
+  items[count++] = lans;
+  _report(sender->ansn, items, count);
+}
+
+/**
+ * Report the view of the sender known to this node
+ */
+static void
+_report_observer(void) {
+  struct olsrv2_tc_node *node;
+  struct netaddr originator;
+
+  if (netaddr_from_string(&originator, _nodes[_SENDER].originator[0])) {
+    return;
+  }
+
+  /* the node is created for the direct neighbor before its first TC */
+  node = olsrv2_tc_node_get(&originator);
+  if (node == NULL || node->interval_time == 0) {
+    return;
+  }
+  _scenario->report_observer(node);
+}
+
+/**
+ * Add or remove an attached network of the sender and
+ * recalculate the ANSN immediately
+ * @param prefix attached network
+ * @param add true to add it, false to remove it
+ */
+static void
+_change_lan(const char *prefix, bool add) {
+  struct nhdp_domain *domain;
+  struct os_route_key key;
+  struct netaddr dst;
+
+  domain = nhdp_domain_get_by_ext(0);
+  if (domain == NULL) {
+    return;
+  }
+  if (netaddr_from_string(&dst, prefix)) {
+    fprintf(stderr, "Illegal prefix: %s\n", prefix);
+    return;
+  }
+
+  os_routing_init_sourcespec_prefix(&key, &dst);
+  if (add) {
+    olsrv2_lan_add(domain, &key, 1, 2);
+  }
+  else {
+    olsrv2_lan_remove(domain, &key);
+  }
+  olsrv2_routing_force_update(true);
+}
+
+/**
+ * Add the initial attached networks of the differential TC scenario
+ */
+static void
+_setup_lans(void) {
+  size_t i;
+
+  for (i = 0; i < ARRAYSIZE(_initial_prefixes); i++) {
+    _change_lan(_initial_prefixes[i], true);
+  }
+}
+
+/**
+ * Apply the attached network changes that are due
+ * @param tc_count number of TCs generated by the sender
+ */
+static void
+_change_lans(uint32_t tc_count) {
+  while (_next_change < ARRAYSIZE(_lan_changes) && tc_count >= _lan_changes[_next_change].tc_count) {
+    _change_lan(_lan_changes[_next_change].prefix, _lan_changes[_next_change].add);
+    _next_change++;
+  }
+}
+
+/**
+ * Add enough attached networks to fragment every full TC and
+ * the simulated neighbors that selected the sender as MPR
+ */
+static void
+_setup_fragmented(void) {
+  struct nhdp_domain *domain;
+  struct netaddr originator;
+  char buffer[32];
+  size_t i;
+
+  /* keep each group of prefixes below the maximum size of an address block */
+  for (i = 0; i < FRAGMENTED_LAN_COUNT; i++) {
+    snprintf(buffer, sizeof(buffer), "10.%u.%u.0/24", (unsigned)(64 + i / 128), (unsigned)(i % 128));
+    _change_lan(buffer, true);
+  }
+
+  for (i = 0; i < FAKE_NEIGHBOR_COUNT; i++) {
+    snprintf(buffer, sizeof(buffer), "10.50.0.%u", (unsigned)(i + 1));
+    if (netaddr_from_string(&originator, buffer)) {
+      continue;
+    }
+
+    _fake_neighbors[i] = olsrv2_harness_add_neighbor(&originator, 1000);
+    if (_fake_neighbors[i] == NULL) {
+      fprintf(stderr, "Could not add neighbor %s\n", buffer);
+      olsrv2_harness_stop(1);
+      return;
+    }
+
+    /* only MPR selectors are advertised in TCs */
+    list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+      nhdp_domain_get_neighbordata(domain, _fake_neighbors[i])->local_is_mpr = true;
+    }
+  }
+  olsrv2_routing_force_update(true);
+}
+
+/**
+ * Drop the first simulated neighbor when it is due
+ * @param tc_count number of TCs generated by the sender
+ */
+static void
+_change_fragmented(uint32_t tc_count) {
+  if (tc_count >= DROP_NEIGHBOR_TC_COUNT && _fake_neighbors[0] != NULL) {
+    olsrv2_harness_remove_neighbor(_fake_neighbors[0]);
+    _fake_neighbors[0] = NULL;
+    olsrv2_routing_force_update(true);
+  }
+}
+
+/**
+ * @return true if the sender knows the receiver as a two-hop neighbor
+ */
+static bool
+_receiver_is_two_hop_neighbor(void) {
+  struct nhdp_link *lnk;
+  struct netaddr receiver;
+
+  if (netaddr_from_string(&receiver, _nodes[_RECEIVER].originator[0])) {
+    return false;
+  }
+
+  list_for_each_element(nhdp_db_get_link_list(), lnk, _global_node) {
+    if (ndhp_db_link_2hop_get(lnk, &receiver)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @param differential true to only count differential TCs
+ * @return number of TCs generated by the sender
+ */
+static uint32_t
+_get_tc_count(bool differential) {
+  const struct olsrv2_fisheye_scope *scopes;
+  size_t i, count;
+  uint32_t sent;
+
+  scopes = olsrv2_get_fisheye_scopes(&count);
+
+  sent = 0;
+  for (i = 0; i < count; i++) {
+    sent += differential ? scopes[i].differential_tc_sent : scopes[i].tc_sent;
+  }
+  return sent;
+}
+
+/**
+ * Run one step of the sender scenario
+ */
+static void
+_poll_sender(void) {
+  uint32_t tc_count;
+
+  switch (_phase) {
+    case _WAIT_FOR_RECEIVER:
+      if (_receiver_is_two_hop_neighbor()) {
+        _phase = _SETTLE;
+        _phase_start = oonf_clock_getNow();
+      }
+      else if (oonf_clock_get_relative(_phase_start) < -CONVERGENCE_TIMEOUT) {
+        fprintf(stderr, "Receiver did not become a two-hop neighbor of the sender\n");
+        olsrv2_harness_stop(1);
+      }
+      break;
+
+    case _SETTLE:
+      if (oonf_clock_get_relative(_phase_start) > -SETTLE_TIME) {
+        break;
+      }
+
+      _scenario->setup();
+      _scenario->report_sender();
+
+      _phase = _SEND_TCS;
+      olsrv2_generate_tcs(true);
+      break;
+
+    case _SEND_TCS:
+      tc_count = _get_tc_count(false);
+      _scenario->change(tc_count);
+      _scenario->report_sender();
+
+      if (tc_count >= TC_COUNT) {
+        olsrv2_generate_tcs(false);
+
+        if ((_get_tc_count(true) > 0) != _scenario->differential_tcs) {
+          fprintf(stderr, "Sender generated %u differential TCs\n", _get_tc_count(true));
+          olsrv2_harness_stop(1);
+          break;
+        }
+        _phase = _SHUTDOWN;
+        _phase_start = oonf_clock_getNow();
+      }
+      break;
+
+    case _SHUTDOWN:
+    default:
+      if (oonf_clock_get_relative(_phase_start) < -SHUTDOWN_DELAY) {
+        olsrv2_harness_stop(0);
+      }
+      break;
+  }
+}
+
+/**
+ * Callback for the scenario timer of the local node
+ * @param ptr timer instance that fired
+ */
+static void
+_cb_poll(struct oonf_timer_instance *ptr __attribute__((unused))) {
+  if (_local == &_nodes[_SENDER]) {
+    _poll_sender();
+  }
+  else {
+    _report_observer();
+  }
+}
+
+/**
+ * Start the sender scenario, no TC is sent before the network is ready
+ * @return OLSRV2_HARNESS_RUNNING
+ */
+static int
+_run_sender(void) {
+  olsrv2_generate_tcs(false);
+
+  _phase = _WAIT_FOR_RECEIVER;
+  _phase_start = oonf_clock_getNow();
+
+  oonf_timer_add(&_poll_class);
+  oonf_timer_set(&_poll_timer, POLL_INTERVAL);
+  return OLSRV2_HARNESS_RUNNING;
+}
+
+/**
+ * Start reporting the view of the sender, runs until the process gets a signal
+ * @return OLSRV2_HARNESS_RUNNING
+ */
+static int
+_run_observer(void) {
+  oonf_timer_add(&_poll_class);
+  oonf_timer_set(&_poll_timer, POLL_INTERVAL);
+  return OLSRV2_HARNESS_RUNNING;
+}
+
+/**
+ * Write a value into a file
+ * @param path file name
+ * @param value file content
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_write_file(const char *path, const char *value) {
+  ssize_t len;
+  int fd;
+
+  fd = open(path, O_WRONLY);
+  if (fd < 0) {
+    return -1;
+  }
+  len = write(fd, value, strlen(value));
+  close(fd);
+  return len == (ssize_t)strlen(value) ? 0 : -1;
+}
+
+/**
+ * Run a shell command
+ * @param format printf style format of the command
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int __attribute__((format(printf, 1, 2)))
+_command(const char *format, ...) {
+  char cmd[256];
+  va_list ap;
+
+  va_start(ap, format);
+  vsnprintf(cmd, sizeof(cmd), format, ap);
+  va_end(ap);
+
+  return system(cmd) == 0 ? 0 : -1;
+}
+
+/**
+ * Map the current user to root in a new user namespace
+ * and create a new network namespace
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_enter_namespaces(void) {
+  char map[64];
+  uid_t uid;
+  gid_t gid;
+
+  uid = getuid();
+  gid = getgid();
+
+  if (unshare(CLONE_NEWUSER | CLONE_NEWNET)) {
+    return -1;
+  }
+
+  /* setgroups does not exist on older kernels */
+  _write_file("/proc/self/setgroups", "deny");
+
+  snprintf(map, sizeof(map), "0 %u 1", (unsigned)uid);
+  if (_write_file("/proc/self/uid_map", map)) {
+    return -1;
+  }
+  snprintf(map, sizeof(map), "0 %u 1", (unsigned)gid);
+  return _write_file("/proc/self/gid_map", map);
+}
+
+/**
+ * Process of a simulated node
+ * @param node simulated node
+ * @param argv0 name of the program
+ * @return exit code of the process
+ */
+static int
+_run_node(struct _node *node, const char *argv0) {
+  const char *settings[MAX_ITEMS];
+  char hello_settings[2][IF_NAMESIZE + 32];
+  char path[64 + IF_NAMESIZE];
+  size_t i, count;
+  int result;
+  char c = 0;
+
+  if (unshare(CLONE_NEWNET)) {
+    return 1;
+  }
+  if (write(node->ready[1], &c, 1) != 1 || read(node->go[0], &c, 1) != 1) {
+    return 1;
+  }
+
+  memcpy(settings, _scenario->settings, _scenario->settings_count * sizeof(*settings));
+  count = _scenario->settings_count;
+
+  for (i = 0; i < ARRAYSIZE(node->interfaces) && node->interfaces[i]; i++) {
+    /* IPv4 is enough, avoid waiting for IPv6 duplicate address detection */
+    snprintf(path, sizeof(path), "/proc/sys/net/ipv6/conf/%s/disable_ipv6", node->interfaces[i]);
+    _write_file(path, "1");
+
+    if (_command("ip addr add %s dev %s && ip link set %s up", node->addresses[i], node->interfaces[i],
+          node->interfaces[i])) {
+      return 1;
+    }
+
+    snprintf(hello_settings[i], sizeof(hello_settings[i]), "interface[%s].hello_interval=0.1", node->interfaces[i]);
+    settings[count++] = hello_settings[i];
+  }
+
+  /* the originator must be an interface address, each link has its own subnet */
+  if (_command("ip addr add %s/32 dev %s", node->originator[0], node->interfaces[0])) {
+    return 1;
+  }
+
+  /* the first interface is the default interface of the harness, add the second one */
+  if (node->interfaces[1]) {
+    snprintf(path, sizeof(path), "interface[%s].", node->interfaces[1]);
+    settings[count++] = path;
+  }
+
+  if (dup2(node->output[1], STDOUT_FILENO) < 0) {
+    return 1;
+  }
+
+  _local = node;
+  olsrv2_harness_set_interface(node->interfaces[0]);
+  olsrv2_harness_set_originators(node->originator[0], node->originator[1]);
+  /* observers run until they are terminated */
+  result = olsrv2_harness_run(argv0, settings, count, node->run);
+  return result == OLSRV2_HARNESS_RUNNING ? 0 : result;
+}
+
+/**
+ * Read the reports of a node until it closes its output
+ * @param node simulated node
+ */
+static void
+_read_report(struct _node *node) {
+  char buffer[256];
+  ssize_t len;
+
+  while ((len = read(node->output[0], buffer, sizeof(buffer))) > 0) {
+    abuf_memcpy(&node->report, buffer, len);
+  }
+}
+
+/**
+ * @param line start of a line
+ * @return length of the line without the line break
+ */
+static int
+_line_length(const char *line) {
+  return (int)strcspn(line, "\n");
+}
+
+/**
+ * @param line start of a line
+ * @return start of the next line
+ */
+static const char *
+_next_line(const char *line) {
+  line += _line_length(line);
+  return *line ? line + 1 : line;
+}
+
+/**
+ * Lookup the attached networks the sender advertised with an ANSN
+ * @param ansn answer set number
+ * @return report line of the sender, NULL if not found
+ */
+static const char *
+_get_advertised(uint16_t ansn) {
+  const char *line, *found;
+  unsigned value;
+
+  /* the sender reports every ANSN that changed its attached networks */
+  found = NULL;
+  for (line = abuf_getptr(&_nodes[_SENDER].report); *line; line = _next_line(line)) {
+    if (sscanf(line, "%u", &value) == 1 && !rfc5444_seqno_is_smaller(ansn, value)) {
+      found = line;
+    }
+  }
+  return found;
+}
+
+/**
+ * @param line report line
+ * @param item start of an item
+ * @param item_len length of the item
+ * @return true if the report line contains the item
+ */
+static bool
+_has_item(const char *line, const char *item, int item_len) {
+  const char *ptr, *end;
+  int len;
+
+  end = line + _line_length(line);
+  for (ptr = line; ptr < end; ptr += len + 1) {
+    len = (int)strcspn(ptr, " \n");
+    if (len == item_len && strncmp(ptr, item, len) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @param line report line of an observer
+ * @param advertised report line of the sender
+ * @return true if the observer knows all items the sender advertised
+ */
+static bool
+_has_all_items(const char *line, const char *advertised) {
+  const char *ptr, *end;
+  int len;
+
+  end = advertised + _line_length(advertised);
+
+  /* skip the ANSN */
+  ptr = advertised + strcspn(advertised, " \n");
+  for (; ptr < end; ptr += len) {
+    ptr++;
+    len = (int)strcspn(ptr, " \n");
+    if (!_has_item(line, ptr, len)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Compare the reported view of a node with the advertised attached networks
+ * @param node simulated node
+ */
+static void
+_check_view(struct _node *node) {
+  const char *line, *advertised, *last_line, *last_advertised;
+  bool learned;
+  unsigned ansn;
+
+  START_TEST();
+
+  /* the first fragmented TC is learned fragment by fragment */
+  learned = !_scenario->fragmented;
+
+  last_line = NULL;
+  for (line = abuf_getptr(&node->report); *line; line = _next_line(line)) {
+    if (sscanf(line, "%u", &ansn) != 1) {
+      continue;
+    }
+
+    advertised = _get_advertised(ansn);
+    last_line = line;
+
+    if (!learned) {
+      learned = advertised != NULL && _has_all_items(line, advertised);
+      continue;
+    }
+
+    if (_scenario->fragmented) {
+      /* removed items might stay until the next round of fragments, advertised items must not vanish */
+      CHECK_TRUE(advertised != NULL && _has_all_items(line, advertised),
+        "%s reported '%.*s', sender advertised '%.*s'", node->name, _line_length(line), line,
+        advertised ? _line_length(advertised) : 0, advertised ? advertised : "");
+      continue;
+    }
+
+    CHECK_TRUE(advertised != NULL && _line_length(advertised) == _line_length(line) &&
+                 strncmp(advertised, line, _line_length(line)) == 0,
+      "%s reported '%.*s', sender advertised '%.*s'", node->name, _line_length(line), line,
+      advertised ? _line_length(advertised) : 0, advertised ? advertised : "");
+  }
+
+  CHECK_TRUE(learned, "%s never learned the advertised state of the sender", node->name);
+
+  /* the final state of the sender must have reached the node */
+  last_advertised = NULL;
+  for (line = abuf_getptr(&_nodes[_SENDER].report); *line; line = _next_line(line)) {
+    last_advertised = line;
+  }
+
+  CHECK_TRUE(last_line != NULL && last_advertised != NULL && _line_length(last_line) == _line_length(last_advertised) &&
+               strncmp(last_line, last_advertised, _line_length(last_line)) == 0,
+    "%s did not learn the final state of the sender", node->name);
+
+  END_TEST();
+}
+
+/**
+ * Create the simulated network and run the nodes
+ * @param argv0 name of the program
+ * @return -1 if the network could not be created, 0 otherwise
+ */
+static int
+_run_simulation(const char *argv0) {
+  struct _node *node;
+  size_t i, j;
+  int status;
+  char c = 0;
+
+  for (i = 0; i < _ROLE_COUNT; i++) {
+    abuf_init(&_nodes[i].report);
+    if (pipe(_nodes[i].ready) || pipe(_nodes[i].go) || pipe(_nodes[i].output)) {
+      return -1;
+    }
+  }
+
+  /* do not duplicate buffered output into the nodes */
+  fflush(stdout);
+
+  for (i = 0; i < _ROLE_COUNT; i++) {
+    node = &_nodes[i];
+    node->pid = fork();
+    if (node->pid < 0) {
+      return -1;
+    }
+    if (node->pid == 0) {
+      /* close the pipe ends of all other nodes */
+      for (j = 0; j < _ROLE_COUNT; j++) {
+        close(_nodes[j].ready[0]);
+        close(_nodes[j].go[1]);
+        close(_nodes[j].output[0]);
+        if (j != i) {
+          close(_nodes[j].ready[1]);
+          close(_nodes[j].go[0]);
+          close(_nodes[j].output[1]);
+        }
+      }
+      _exit(_run_node(node, argv0));
+    }
+  }
+
+  for (i = 0; i < _ROLE_COUNT; i++) {
+    close(_nodes[i].ready[1]);
+    close(_nodes[i].go[0]);
+    close(_nodes[i].output[1]);
+
+    if (read(_nodes[i].ready[0], &c, 1) != 1) {
+      fprintf(stderr, "Could not create network namespace for %s\n", _nodes[i].name);
+      return -1;
+    }
+  }
+
+  if (_command("ip link add %s netns %d type veth peer name %s netns %d", _nodes[_SENDER].interfaces[0],
+        (int)_nodes[_SENDER].pid, _nodes[_RELAY].interfaces[0], (int)_nodes[_RELAY].pid) ||
+      _command("ip link add %s netns %d type veth peer name %s netns %d", _nodes[_RELAY].interfaces[1],
+        (int)_nodes[_RELAY].pid, _nodes[_RECEIVER].interfaces[0], (int)_nodes[_RECEIVER].pid)) {
+    fprintf(stderr, "Could not create veth interfaces\n");
+    return -1;
+  }
+
+  for (i = 0; i < _ROLE_COUNT; i++) {
+    if (write(_nodes[i].go[1], &c, 1) != 1) {
+      return -1;
+    }
+  }
+
+  /* the sender stops by itself when its scenario is finished */
+  _read_report(&_nodes[_SENDER]);
+  waitpid(_nodes[_SENDER].pid, &status, 0);
+  CHECK_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0, "sender scenario failed: %d", status);
+
+  for (i = _SENDER + 1; i < _ROLE_COUNT; i++) {
+    kill(_nodes[i].pid, SIGTERM);
+    _read_report(&_nodes[i]);
+    waitpid(_nodes[i].pid, &status, 0);
+  }
+  return 0;
+}
+
+/**
+ * Print the reports of all nodes and release them
+ */
+static void
+_free_reports(void) {
+  size_t i;
+
+  printf("sender advertised:\n%s", abuf_getptr(&_nodes[_SENDER].report));
+  printf("relay view:\n%s", abuf_getptr(&_nodes[_RELAY].report));
+  printf("receiver view:\n%s", abuf_getptr(&_nodes[_RECEIVER].report));
+
+  for (i = 0; i < _ROLE_COUNT; i++) {
+    abuf_free(&_nodes[i].report);
+  }
+}
+
+static void
+test_differential_tc_views(const char *argv0) {
+  START_TEST();
+
+  _scenario = &_differential_scenario;
+  CHECK_TRUE(_run_simulation(argv0) == 0, "Could not run simulation");
+
+  END_TEST();
+
+  _check_view(&_nodes[_RELAY]);
+  _check_view(&_nodes[_RECEIVER]);
+  _free_reports();
+}
+
+static void
+test_fragmented_tc_views(const char *argv0) {
+  START_TEST();
+
+  _scenario = &_fragmented_scenario;
+  CHECK_TRUE(_run_simulation(argv0) == 0, "Could not run simulation");
+
+  END_TEST();
+
+  _check_view(&_nodes[_RELAY]);
+  _check_view(&_nodes[_RECEIVER]);
+  _free_reports();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv) {
+  if (_enter_namespaces() || _command("ip -V > /dev/null")) {
+    printf("User namespaces or ip tool not available, skipping simulation\n");
+    return SKIP_TEST;
+  }
+
+  BEGIN_TESTING(NULL);
+
+  test_differential_tc_views(argv[0]);
+  test_fragmented_tc_views(argv[0]);
+
+  return FINISH_TESTING();
+}
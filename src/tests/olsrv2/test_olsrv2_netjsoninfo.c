@@ -0,0 +1,451 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <oonf/libcommon/autobuf.h>
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/base/oonf_layer2.h>
+#include <oonf/base/os_routing.h>
+
+#include <oonf/nhdp/nhdp/nhdp_db.h>
+#include <oonf/nhdp/nhdp/nhdp_domain.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_routing.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_tc.h>
+
+#include <oonf/cunit/cunit.h>
+
+#include "olsrv2_harness.h"
+
+static struct autobuf before, after;
+
+/* origin of the layer2 test data */
+static struct oonf_layer2_origin _origin = {
+  .name = "netjsoninfo test",
+  .priority = OONF_LAYER2_ORIGIN_CONFIGURED,
+};
+
+static void
+clear_elements(void) {
+  abuf_clear(&before);
+  abuf_clear(&after);
+}
+
+static void
+_parse(struct netaddr *addr, const char *string) {
+  if (netaddr_from_string(addr, string)) {
+    fprintf(stderr, "Illegal address in test: %s\n", string);
+  }
+}
+
+static bool
+_contains(struct autobuf *buf, const char *text) {
+  return strstr(abuf_getptr(buf), text) != NULL;
+}
+
+static void
+test_tc_node_changed(void) {
+  struct olsrv2_tc_node *node;
+  struct olsrv2_tc_attachment *attachment;
+  struct os_route_key prefix;
+  struct netaddr originator, neighbor;
+
+  START_TEST();
+
+  _parse(&originator, "10.0.1.1");
+  _parse(&neighbor, "10.0.0.1");
+  memset(&prefix, 0, sizeof(prefix));
+  _parse(&prefix.dst, "10.1.1.0/24");
+  _parse(&prefix.src, "0.0.0.0/0");
+
+  node = olsrv2_harness_add_node(&originator);
+  olsrv2_harness_add_edge(node, &neighbor, 1000);
+  olsrv2_harness_commit_node(node);
+
+  olsrv2_harness_telnet(&before, "netjsoninfo", "filter graph ipv4_0");
+  CHECK_TRUE(_contains(&before, "\"label\":\"10.0.1.1\""), "tc node missing: %s", abuf_getptr(&before));
+  CHECK_TRUE(!_contains(&before, "10.1.1.0/24"), "unexpected attached network: %s", abuf_getptr(&before));
+
+  /* new attached network, the attachment event must invalidate the node fragment */
+  attachment = olsrv2_harness_add_attachment(node, &prefix, 1000, 2);
+  olsrv2_harness_commit_node(node);
+
+  olsrv2_harness_telnet(&after, "netjsoninfo", "filter graph ipv4_0");
+  CHECK_TRUE(_contains(&after, "\"label\":\"10.0.1.1 - 10.1.1.0/24\""), "attached network missing: %s",
+    abuf_getptr(&after));
+
+  /* detach the network without an event, the cached fragment must be used */
+  avl_remove(&node->_attached_networks, &attachment->_src_node);
+
+  olsrv2_harness_telnet(&before, "netjsoninfo", "filter graph ipv4_0");
+  CHECK_TRUE(_contains(&before, "\"label\":\"10.0.1.1 - 10.1.1.0/24\""), "fragment of tc node was not cached: %s",
+    abuf_getptr(&before));
+
+  /* a change event of the tc node must invalidate its fragment */
+  olsrv2_tc_trigger_change(node);
+
+  olsrv2_harness_telnet(&after, "netjsoninfo", "filter graph ipv4_0");
+  CHECK_TRUE(!_contains(&after, "10.1.1.0/24"), "tc node change did not invalidate fragment: %s",
+    abuf_getptr(&after));
+
+  avl_insert(&node->_attached_networks, &attachment->_src_node);
+  olsrv2_tc_endpoint_remove(attachment);
+  olsrv2_tc_node_remove(node);
+
+  END_TEST();
+}
+
+/* returns the JSON text of a graph edge up to the end of its properties */
+static const char *
+_get_edge(struct autobuf *buf, const char *source, const char *target, char *edge, size_t len) {
+  char key[128];
+  const char *start, *end;
+
+  snprintf(key, sizeof(key), "\"source\":\"id_%s\",\"target\":\"id_%s\"", source, target);
+  start = strstr(abuf_getptr(buf), key);
+  if (start == NULL || (end = strchr(start, '}')) == NULL || (size_t)(end - start) >= len) {
+    edge[0] = 0;
+    return edge;
+  }
+
+  memcpy(edge, start, end - start);
+  edge[end - start] = 0;
+  return edge;
+}
+
+static void
+test_tc_edges_changed(void) {
+  struct olsrv2_tc_node *node1, *node2;
+  struct olsrv2_tc_edge *edge12, *edge21;
+  struct nhdp_neighbor *neigh1, *neigh2;
+  struct netaddr originator1, originator2;
+  char edge[256];
+
+  START_TEST();
+
+  _parse(&originator1, "10.0.2.1");
+  _parse(&originator2, "10.0.2.2");
+
+  node1 = olsrv2_harness_add_node(&originator1);
+  node2 = olsrv2_harness_add_node(&originator2);
+  edge12 = olsrv2_harness_add_edge(node1, &originator2, 1000);
+  edge21 = olsrv2_harness_add_edge(node2, &originator1, 3000);
+  olsrv2_harness_commit_node(node1);
+  olsrv2_harness_commit_node(node2);
+
+  neigh1 = olsrv2_harness_add_neighbor(&originator1, 1000);
+  olsrv2_harness_run_dijkstra();
+
+  olsrv2_harness_telnet(&before, "netjsoninfo", "filter graph ipv4_0");
+  _get_edge(&before, "10.0.2.1", "10.0.2.2", edge, sizeof(edge));
+  CHECK_TRUE(strstr(edge, "\"cost\":1000,") != NULL, "edge cost missing: %s", abuf_getptr(&before));
+  CHECK_TRUE(strstr(edge, "\"in_cost\":3000,") != NULL, "inverse edge cost missing: %s", edge);
+  CHECK_TRUE(strstr(edge, "\"outgoing_tree\":true") != NULL, "edge not on outgoing tree: %s", edge);
+
+  /* change the edge without an event, the cached fragment must be used */
+  edge12->cost[0] = 2000;
+
+  olsrv2_harness_telnet(&after, "netjsoninfo", "filter graph ipv4_0");
+  _get_edge(&after, "10.0.2.1", "10.0.2.2", edge, sizeof(edge));
+  CHECK_TRUE(strstr(edge, "\"cost\":1000,") != NULL, "fragment of edges was not cached: %s", edge);
+
+  /* the inverse cost belongs to the neighbor, its change event must invalidate the edges */
+  edge21->cost[0] = 4000;
+  olsrv2_tc_trigger_change(node2);
+
+  olsrv2_harness_telnet(&after, "netjsoninfo", "filter graph ipv4_0");
+  _get_edge(&after, "10.0.2.1", "10.0.2.2", edge, sizeof(edge));
+  CHECK_TRUE(strstr(edge, "\"cost\":2000,") != NULL, "neighbor change did not invalidate edges: %s", edge);
+  CHECK_TRUE(strstr(edge, "\"in_cost\":4000,") != NULL, "inverse edge cost was not updated: %s", edge);
+
+  /* a direct link to the second node removes the edge from the outgoing tree */
+  neigh2 = olsrv2_harness_add_neighbor(&originator2, 500);
+  olsrv2_harness_run_dijkstra();
+
+  olsrv2_harness_telnet(&after, "netjsoninfo", "filter graph ipv4_0");
+  _get_edge(&after, "10.0.2.1", "10.0.2.2", edge, sizeof(edge));
+  CHECK_TRUE(strstr(edge, "\"outgoing_tree\":false") != NULL, "route change did not invalidate edges: %s", edge);
+
+  olsrv2_harness_set_neighbor_metric(neigh2, NULL, 5000);
+  olsrv2_harness_run_dijkstra();
+
+  olsrv2_harness_telnet(&after, "netjsoninfo", "filter graph ipv4_0");
+  _get_edge(&after, "10.0.2.1", "10.0.2.2", edge, sizeof(edge));
+  CHECK_TRUE(strstr(edge, "\"outgoing_tree\":true") != NULL, "edge did not return to outgoing tree: %s", edge);
+
+  olsrv2_harness_remove_neighbor(neigh2);
+  olsrv2_harness_remove_neighbor(neigh1);
+  olsrv2_tc_node_remove(node2);
+  olsrv2_tc_node_remove(node1);
+  olsrv2_harness_run_dijkstra();
+
+  END_TEST();
+}
+
+static void
+test_tc_attachment_route_changed(void) {
+  struct olsrv2_tc_node *node;
+  struct nhdp_neighbor *neigh;
+  struct os_route_key prefix;
+  struct netaddr originator;
+  char edge[256];
+
+  START_TEST();
+
+  _parse(&originator, "10.0.3.1");
+  memset(&prefix, 0, sizeof(prefix));
+  _parse(&prefix.dst, "10.3.0.0/24");
+  _parse(&prefix.src, "0.0.0.0/0");
+
+  node = olsrv2_harness_add_node(&originator);
+  olsrv2_harness_add_attachment(node, &prefix, 1000, 2);
+  olsrv2_harness_commit_node(node);
+  olsrv2_harness_run_dijkstra();
+
+  olsrv2_harness_telnet(&before, "netjsoninfo", "filter graph ipv4_0");
+  _get_edge(&before, "10.0.3.1", "10.0.3.1_10.3.0.0/24", edge, sizeof(edge));
+  CHECK_TRUE(strstr(edge, "\"outgoing_tree\":false") != NULL, "unreachable attachment on outgoing tree: %s",
+    abuf_getptr(&before));
+
+  /* the new route to the attached network must invalidate the attachments of the node */
+  neigh = olsrv2_harness_add_neighbor(&originator, 1000);
+  olsrv2_harness_run_dijkstra();
+
+  olsrv2_harness_telnet(&after, "netjsoninfo", "filter graph ipv4_0");
+  _get_edge(&after, "10.0.3.1", "10.0.3.1_10.3.0.0/24", edge, sizeof(edge));
+  CHECK_TRUE(strstr(edge, "\"outgoing_tree\":true") != NULL, "route change did not invalidate attachments: %s",
+    abuf_getptr(&after));
+
+  olsrv2_harness_remove_neighbor(neigh);
+  olsrv2_tc_node_remove(node);
+  olsrv2_harness_run_dijkstra();
+
+  END_TEST();
+}
+
+static void
+test_tc_node_dualstack(void) {
+  struct olsrv2_tc_node *node;
+  struct nhdp_neighbor *neigh4, *neigh6;
+  struct netaddr originator4, originator6;
+
+  START_TEST();
+
+  _parse(&originator4, "10.0.0.2");
+  _parse(&originator6, "fd00::2");
+
+  neigh4 = olsrv2_harness_add_neighbor(&originator4, 1000);
+  neigh6 = olsrv2_harness_add_neighbor(&originator6, 1000);
+
+  node = olsrv2_harness_add_node(&originator4);
+  olsrv2_harness_commit_node(node);
+
+  olsrv2_harness_telnet(&before, "netjsoninfo", "filter graph ipv4_0");
+  CHECK_TRUE(_contains(&before, "\"label\":\"10.0.0.2\""), "tc node missing: %s", abuf_getptr(&before));
+  CHECK_TRUE(!_contains(&before, "\"dualstack_addr\":\"fd00::2\""), "unexpected dualstack partner: %s",
+    abuf_getptr(&before));
+
+  /* NHDP learns the dualstack partner without a tc node event */
+  nhdp_db_neighbor_connect_dualstack(neigh4, neigh6);
+
+  olsrv2_harness_telnet(&after, "netjsoninfo", "filter graph ipv4_0");
+  CHECK_TRUE(_contains(&after, "\"dualstack_addr\":\"fd00::2\""), "dualstack partner missing: %s",
+    abuf_getptr(&after));
+
+  nhdp_db_neigbor_disconnect_dualstack(neigh4);
+
+  olsrv2_harness_telnet(&after, "netjsoninfo", "filter graph ipv4_0");
+  CHECK_TRUE(!_contains(&after, "\"dualstack_addr\":\"fd00::2\""), "dualstack partner not removed: %s",
+    abuf_getptr(&after));
+
+  olsrv2_tc_node_remove(node);
+  olsrv2_harness_remove_neighbor(neigh6);
+  olsrv2_harness_remove_neighbor(neigh4);
+
+  END_TEST();
+}
+
+static void
+test_route_changed(void) {
+  struct nhdp_neighbor *neigh;
+  struct olsrv2_routing_entry *rtentry;
+  struct os_route_key key;
+  struct netaddr originator;
+
+  START_TEST();
+
+  _parse(&originator, "10.0.0.3");
+  memset(&key, 0, sizeof(key));
+  _parse(&key.dst, "10.0.0.3");
+  _parse(&key.src, "0.0.0.0/0");
+
+  neigh = olsrv2_harness_add_neighbor(&originator, 1000);
+  olsrv2_harness_run_dijkstra();
+
+  rtentry = olsrv2_harness_get_route(nhdp_domain_get_by_ext(0), &key);
+  CHECK_TRUE(rtentry != NULL, "no route to neighbor");
+  if (rtentry == NULL) {
+    olsrv2_harness_remove_neighbor(neigh);
+    END_TEST();
+    return;
+  }
+
+  olsrv2_harness_telnet(&before, "netjsoninfo", "filter route ipv4_0");
+  CHECK_TRUE(_contains(&before, "\"cost\":1000,"), "route cost missing: %s", abuf_getptr(&before));
+
+  /* the dijkstra updates routing entries without an event */
+  olsrv2_harness_set_neighbor_metric(neigh, NULL, 2000);
+  olsrv2_harness_run_dijkstra();
+
+  olsrv2_harness_telnet(&after, "netjsoninfo", "filter route ipv4_0");
+  CHECK_TRUE(_contains(&after, "\"cost\":2000,"), "route cost was not updated: %s", abuf_getptr(&after));
+
+  /* every value of the route state must invalidate the fragment */
+  rtentry->path_hops = 7;
+  olsrv2_harness_telnet(&after, "netjsoninfo", "filter route ipv4_0");
+  CHECK_TRUE(_contains(&after, "\"hops\":7"), "route hops were not updated: %s", abuf_getptr(&after));
+
+  _parse(&rtentry->last_originator, "10.0.9.9");
+  olsrv2_harness_telnet(&after, "netjsoninfo", "filter route ipv4_0");
+  CHECK_TRUE(_contains(&after, "\"last_router_addr\":\"10.0.9.9\""), "last originator was not updated: %s",
+    abuf_getptr(&after));
+
+  _parse(&rtentry->route.p.gw, "10.0.9.8");
+  olsrv2_harness_telnet(&after, "netjsoninfo", "filter route ipv4_0");
+  CHECK_TRUE(_contains(&after, "\"next\":\"10.0.9.8\""), "gateway was not updated: %s", abuf_getptr(&after));
+
+  olsrv2_harness_remove_neighbor(neigh);
+  olsrv2_harness_run_dijkstra();
+
+  END_TEST();
+}
+
+static void
+test_layer2_neighbor_changed(void) {
+  struct oonf_layer2_net *l2net;
+  struct oonf_layer2_neigh *l2neigh;
+  struct netaddr mac, destination, ip;
+
+  START_TEST();
+
+  _parse(&mac, "02:00:00:00:00:01");
+  _parse(&destination, "02:00:00:00:00:02");
+  _parse(&ip, "10.0.5.1");
+
+  l2net = oonf_layer2_net_add(olsrv2_harness_get_interface());
+  l2neigh = oonf_layer2_neigh_add(l2net, &mac);
+  oonf_layer2_data_set_int64(&l2neigh->data[OONF_LAYER2_NEIGH_RX_SIGNAL], &_origin,
+    oonf_layer2_neigh_metadata_get(OONF_LAYER2_NEIGH_RX_SIGNAL), -50000, 1000);
+  oonf_layer2_neigh_commit(l2neigh);
+
+  olsrv2_harness_telnet(&before, "netjsoninfo", "link");
+  CHECK_TRUE(_contains(&before, "\"rx_signal\":-50"), "layer2 data missing: %s", abuf_getptr(&before));
+
+  /* changing the data without a commit must keep the cached fragment */
+  oonf_layer2_data_set_int64(&l2neigh->data[OONF_LAYER2_NEIGH_RX_SIGNAL], &_origin,
+    oonf_layer2_neigh_metadata_get(OONF_LAYER2_NEIGH_RX_SIGNAL), -60000, 1000);
+
+  olsrv2_harness_telnet(&after, "netjsoninfo", "link");
+  CHECK_TRUE(strcmp(abuf_getptr(&before), abuf_getptr(&after)) == 0, "fragment of layer2 neighbor was not cached: %s",
+    abuf_getptr(&after));
+
+  /* the change event of the commit must invalidate the fragment */
+  oonf_layer2_neigh_commit(l2neigh);
+
+  olsrv2_harness_telnet(&after, "netjsoninfo", "link");
+  CHECK_TRUE(_contains(&after, "\"rx_signal\":-60"), "layer2 data was not updated: %s", abuf_getptr(&after));
+
+  /* destinations and neighbor addresses have their own events */
+  oonf_layer2_destination_add(l2neigh, &destination, &_origin);
+
+  olsrv2_harness_telnet(&after, "netjsoninfo", "link");
+  CHECK_TRUE(_contains(&after, "\"secondary_mac\": [\"02:00:00:00:00:02\"]"), "layer2 destination missing: %s",
+    abuf_getptr(&after));
+
+  oonf_layer2_neigh_add_ip(l2neigh, &_origin, &ip);
+
+  olsrv2_harness_telnet(&after, "netjsoninfo", "link");
+  CHECK_TRUE(_contains(&after, "\"secondary_ip\": [\"10.0.5.1\"]"), "layer2 neighbor address missing: %s",
+    abuf_getptr(&after));
+
+  oonf_layer2_neigh_remove(l2neigh, &_origin);
+  oonf_layer2_net_remove(l2net, &_origin);
+
+  END_TEST();
+}
+
+static int
+_run_tests(void) {
+  oonf_layer2_origin_add(&_origin);
+
+  BEGIN_TESTING(clear_elements);
+
+  test_tc_node_changed();
+  test_tc_edges_changed();
+  test_tc_attachment_route_changed();
+  test_tc_node_dualstack();
+  test_route_changed();
+  test_layer2_neighbor_changed();
+
+  oonf_layer2_origin_remove(&_origin);
+
+  return FINISH_TESTING();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv) {
+  int result;
+
+  abuf_init(&before);
+  abuf_init(&after);
+
+  result = olsrv2_harness_run(argv[0], NULL, 0, _run_tests);
+
+  abuf_free(&before);
+  abuf_free(&after);
+  return result;
+}
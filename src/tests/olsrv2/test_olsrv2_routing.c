@@ -0,0 +1,160 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/base/os_routing.h>
+
+#include <oonf/nhdp/nhdp/nhdp_db.h>
+#include <oonf/nhdp/nhdp/nhdp_domain.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_routing.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_tc.h>
+
+#include <oonf/cunit/cunit.h>
+
+#include "olsrv2_harness.h"
+
+static void
+_parse(struct netaddr *addr, const char *string) {
+  if (netaddr_from_string(addr, string)) {
+    fprintf(stderr, "Illegal address in test: %s\n", string);
+  }
+}
+
+static void
+_parse_key(struct os_route_key *key, const char *dst, const char *src) {
+  memset(key, 0, sizeof(*key));
+  _parse(&key->dst, dst);
+  _parse(&key->src, src);
+}
+
+static void
+test_shared_source_specific_prefix(void) {
+  struct nhdp_neighbor *neigh[3];
+  struct olsrv2_tc_node *node[3];
+  struct olsrv2_routing_entry *rtentry;
+  struct nhdp_domain *domain;
+  struct os_route_key ss_key, key;
+  struct netaddr originator[3];
+  struct netaddr_str nbuf;
+  int i;
+
+  START_TEST();
+
+  domain = nhdp_domain_get_by_ext(0);
+
+  _parse(&originator[0], "fd00::2");
+  _parse(&originator[1], "fd00::3");
+  _parse(&originator[2], "fd00::4");
+  _parse_key(&ss_key, "2001:db8:1::/48", "2001:db8:ff::/48");
+  _parse_key(&key, "2001:db8:4::/48", "::/0");
+
+  /*
+   * two source-specific neighbors attach the same source-specific prefix,
+   * the third neighbor is not source-specific, so the dijkstra has to
+   * split the topology
+   */
+  for (i = 0; i < 3; i++) {
+    neigh[i] = olsrv2_harness_add_neighbor(&originator[i], 1000 * (i + 1));
+    node[i] = olsrv2_harness_add_node(&originator[i]);
+    node[i]->source_specific = i < 2;
+    if (i < 2) {
+      olsrv2_harness_add_attachment(node[i], &ss_key, 1000, 2);
+    }
+    else {
+      olsrv2_harness_add_attachment(node[i], &key, 1000, 2);
+    }
+    olsrv2_harness_commit_node(node[i]);
+  }
+  olsrv2_harness_run_dijkstra();
+
+  rtentry = olsrv2_harness_get_route(domain, &ss_key);
+  CHECK_TRUE(rtentry != NULL && rtentry->set, "no route to shared source-specific prefix");
+  if (rtentry) {
+    CHECK_TRUE(netaddr_cmp(&rtentry->next_originator, &originator[0]) == 0,
+      "source-specific prefix not routed through cheapest neighbor: %s",
+      netaddr_to_string(&nbuf, &rtentry->next_originator));
+  }
+
+  rtentry = olsrv2_harness_get_route(domain, &key);
+  CHECK_TRUE(rtentry != NULL && rtentry->set, "no route to prefix of non source-specific node");
+
+  /* the other source-specific node must take over the prefix */
+  olsrv2_harness_set_neighbor_metric(neigh[0], NULL, 5000);
+  olsrv2_harness_run_dijkstra();
+
+  rtentry = olsrv2_harness_get_route(domain, &ss_key);
+  CHECK_TRUE(rtentry != NULL && rtentry->set, "no route to shared source-specific prefix after metric change");
+  if (rtentry) {
+    CHECK_TRUE(netaddr_cmp(&rtentry->next_originator, &originator[1]) == 0,
+      "source-specific prefix not routed through second neighbor: %s",
+      netaddr_to_string(&nbuf, &rtentry->next_originator));
+  }
+
+  for (i = 0; i < 3; i++) {
+    olsrv2_tc_node_remove(node[i]);
+    olsrv2_harness_remove_neighbor(neigh[i]);
+  }
+  olsrv2_harness_run_dijkstra();
+
+  END_TEST();
+}
+
+static int
+_run_tests(void) {
+  BEGIN_TESTING(NULL);
+
+  test_shared_source_specific_prefix();
+
+  return FINISH_TESTING();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv) {
+  return olsrv2_harness_run(argv[0], NULL, 0, _run_tests);
+}
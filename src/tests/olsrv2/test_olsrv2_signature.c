@@ -0,0 +1,556 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/base/oonf_rfc5444.h>
+#include <oonf/librfc5444/rfc5444_iana.h>
+#include <oonf/librfc5444/rfc5444_reader.h>
+#include <oonf/librfc5444/rfc5444_writer.h>
+
+#include <oonf/crypto/rfc5444_signature/rfc5444_signature.h>
+#include <oonf/crypto/rfc7182_provider/rfc7182_provider.h>
+
+#include <oonf/cunit/cunit.h>
+
+#include "olsrv2_harness.h"
+
+/*
+ * Messages of type TEST_MSGTYPE_SIGNED get a HMAC-SHA256 signature,
+ * messages of type TEST_MSGTYPE_UNSIGNED have the same content
+ * without a signature.
+ */
+enum
+{
+  TEST_MSGTYPE_SIGNED = 224,
+  TEST_MSGTYPE_UNSIGNED = 225,
+
+  /*! message TLV added by the test */
+  TEST_MSGTLV = 200,
+
+  /*! packet header (version/flags) in front of the message */
+  TEST_PKT_HEADER = 1,
+
+  /*! offset of hoplimit in message (type, flags, size, originator) */
+  TEST_MSG_HOPLIMIT = 1 + 1 + 2 + 4,
+
+  /*! offset of hopcount in message */
+  TEST_MSG_HOPCOUNT = TEST_MSG_HOPLIMIT + 1,
+
+  /*! offset of message tlvblock (hoplimit, hopcount, seqno) */
+  TEST_MSG_TLVBLOCK = TEST_MSG_HOPCOUNT + 1 + 2,
+
+  /*! offset of ICV in signed message (tlvblock length, tlv header, hash/crypt/key-id length) */
+  TEST_MSG_ICV = TEST_MSG_TLVBLOCK + 2 + 4 + 3,
+
+  /*! offset of last address tail from end of packet (in front of empty address tlvblock) */
+  TEST_ADDR_TAIL = 2 + 1,
+
+  /*! length of HMAC-SHA256 */
+  TEST_ICV_LENGTH = 32,
+
+  /*! number of messages in a packet for batch verification */
+  TEST_BATCH_SIZE = 4,
+};
+
+static const char *_settings[] = {
+  "sharedkey[test].key=secret",
+  "sharedkey[test].msgtype=224",
+  "sharedkey[test].hash=sha256",
+  "sharedkey[test].crypt=hmac",
+};
+
+static const char *_key = "secret";
+
+static void _cb_send_packet(
+  struct rfc5444_writer *writer, struct rfc5444_writer_target *target, void *ptr, size_t len);
+static int _cb_add_message_header(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg);
+static void _cb_add_message_tlvs(struct rfc5444_writer *writer);
+static void _cb_add_signed_addresses(struct rfc5444_writer *writer);
+static void _cb_add_unsigned_addresses(struct rfc5444_writer *writer);
+static enum rfc5444_result _cb_message(struct rfc5444_reader_tlvblock_context *context);
+
+static struct oonf_rfc5444_protocol *_protocol;
+
+static uint8_t _packet_buffer[RFC5444_MAX_PACKET_SIZE];
+static uint8_t _packet[RFC5444_MAX_PACKET_SIZE];
+static size_t _packet_size;
+
+static struct rfc5444_writer_target _target = {
+  .packet_buffer = _packet_buffer,
+  .packet_size = sizeof(_packet_buffer),
+  .sendPacket = _cb_send_packet,
+};
+
+static struct rfc5444_writer_message *_messages[2];
+
+static struct rfc5444_writer_content_provider _providers[2] = {
+  {
+    .msg_type = TEST_MSGTYPE_SIGNED,
+    .addMessageTLVs = _cb_add_message_tlvs,
+    .addAddresses = _cb_add_signed_addresses,
+  },
+  {
+    .msg_type = TEST_MSGTYPE_UNSIGNED,
+    .addMessageTLVs = _cb_add_message_tlvs,
+    .addAddresses = _cb_add_unsigned_addresses,
+  },
+};
+
+static struct rfc5444_reader_tlvblock_consumer _consumer = {
+  .order = RFC5444_MAIN_PARSER_PRIORITY,
+  .msg_id = TEST_MSGTYPE_SIGNED,
+  .block_callback = _cb_message,
+};
+
+static int _received;
+static uint16_t _seqno;
+
+static void
+_cb_send_packet(struct rfc5444_writer *writer __attribute__((unused)),
+  struct rfc5444_writer_target *target __attribute__((unused)), void *ptr, size_t len) {
+  memcpy(_packet, ptr, len);
+  _packet_size = len;
+}
+
+static int
+_cb_add_message_header(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg) {
+  static const uint8_t originator[] = { 10, 0, 0, 1 };
+
+  rfc5444_writer_set_msg_header(writer, msg, true, true, true, true);
+  rfc5444_writer_set_msg_originator(writer, msg, originator);
+  rfc5444_writer_set_msg_hoplimit(writer, msg, 255);
+  rfc5444_writer_set_msg_hopcount(writer, msg, 0);
+  rfc5444_writer_set_msg_seqno(writer, msg, _seqno);
+  return 0;
+}
+
+static void
+_cb_add_message_tlvs(struct rfc5444_writer *writer) {
+  rfc5444_writer_add_messagetlv(writer, TEST_MSGTLV, 0, "test", 4);
+}
+
+static void
+_add_addresses(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg) {
+  struct netaddr addr;
+  char buffer[32];
+  int i;
+
+  for (i = 1; i <= 8; i++) {
+    snprintf(buffer, sizeof(buffer), "10.1.0.%d", i);
+    if (netaddr_from_string(&addr, buffer) == 0) {
+      rfc5444_writer_add_address(writer, msg, &addr, false);
+    }
+  }
+}
+
+static void
+_cb_add_signed_addresses(struct rfc5444_writer *writer) {
+  _add_addresses(writer, _providers[0].creator);
+}
+
+static void
+_cb_add_unsigned_addresses(struct rfc5444_writer *writer) {
+  _add_addresses(writer, _providers[1].creator);
+}
+
+static enum rfc5444_result
+_cb_message(struct rfc5444_reader_tlvblock_context *context __attribute__((unused))) {
+  _received++;
+  return RFC5444_OKAY;
+}
+
+/**
+ * Generate a packet with messages that only differ in their sequence number
+ * @param msg_type message type
+ * @param seqno sequence number of first message
+ * @param count number of messages
+ * @return length of packet, 0 if an error happened
+ */
+static size_t
+_generate_packet(uint8_t msg_type, uint16_t seqno, size_t count) {
+  void (*notifier)(struct rfc5444_writer_target *);
+  enum rfc5444_result result;
+  size_t i;
+
+  /* the aggregation timer of the protocol only knows oonf_rfc5444 targets, flush directly instead */
+  notifier = _protocol->writer.message_generation_notifier;
+  _protocol->writer.message_generation_notifier = NULL;
+
+  _packet_size = 0;
+  result = RFC5444_OKAY;
+  for (i = 0; i < count && result == RFC5444_OKAY; i++) {
+    _seqno = seqno + i;
+    result = rfc5444_writer_create_message_singletarget(&_protocol->writer, msg_type, 4, &_target);
+  }
+  if (result == RFC5444_OKAY) {
+    rfc5444_writer_flush(&_protocol->writer, &_target, true);
+  }
+
+  _protocol->writer.message_generation_notifier = notifier;
+  return result == RFC5444_OKAY ? _packet_size : 0;
+}
+
+/**
+ * Generate a single message packet
+ * @param msg_type message type
+ * @return length of packet, 0 if an error happened
+ */
+static size_t
+_generate(uint8_t msg_type) {
+  return _generate_packet(msg_type, 42, 1);
+}
+
+/**
+ * Parse a packet and report if the test message was accepted
+ * @param packet pointer to packet
+ * @param length length of packet
+ * @return true if the test consumer received the message
+ */
+static bool
+_parse(const uint8_t *packet, size_t length) {
+  int received = _received;
+
+  rfc5444_reader_handle_packet(&_protocol->reader, packet, length);
+  return _received > received;
+}
+
+static void
+test_signature_matches_reference(void) {
+  uint8_t signed_pkt[RFC5444_MAX_PACKET_SIZE], unsigned_pkt[RFC5444_MAX_PACKET_SIZE];
+  uint8_t data[RFC5444_MAX_PACKET_SIZE + 3];
+  uint8_t icv[EVP_MAX_MD_SIZE];
+  size_t signed_len, unsigned_len;
+  unsigned int icv_len;
+
+  START_TEST();
+
+  signed_len = _generate(TEST_MSGTYPE_SIGNED);
+  memcpy(signed_pkt, _packet, signed_len);
+  unsigned_len = _generate(TEST_MSGTYPE_UNSIGNED);
+  memcpy(unsigned_pkt, _packet, unsigned_len);
+
+  CHECK_TRUE(signed_len > 0 && unsigned_len > 0, "could not generate messages");
+  CHECK_TRUE(signed_len == unsigned_len + 4 + 3 + TEST_ICV_LENGTH,
+    "signed message has %" PRINTF_SIZE_T_SPECIFIER " bytes instead of %" PRINTF_SIZE_T_SPECIFIER, signed_len,
+    unsigned_len + 4 + 3 + TEST_ICV_LENGTH);
+  if (signed_len != unsigned_len + 4 + 3 + TEST_ICV_LENGTH) {
+    END_TEST();
+    return;
+  }
+
+  CHECK_TRUE(signed_pkt[TEST_PKT_HEADER + TEST_MSG_TLVBLOCK + 2] == RFC7182_MSGTLV_ICV, "first TLV is no ICV");
+
+  /* RFC7182 signature over hash/crypt/key-id and the message without ICV, hoplimit and hopcount */
+  data[0] = RFC7182_ICV_HASH_SHA_256;
+  data[1] = RFC7182_ICV_CRYPT_HMAC;
+  data[2] = 0;
+  memcpy(&data[3], &unsigned_pkt[TEST_PKT_HEADER], unsigned_len - TEST_PKT_HEADER);
+  data[3] = TEST_MSGTYPE_SIGNED;
+  data[3 + TEST_MSG_HOPLIMIT] = 0;
+  data[3 + TEST_MSG_HOPCOUNT] = 0;
+
+  HMAC(EVP_sha256(), _key, strlen(_key), data, 3 + unsigned_len - TEST_PKT_HEADER, icv, &icv_len);
+
+  CHECK_TRUE(icv_len == TEST_ICV_LENGTH, "HMAC has %u bytes", icv_len);
+  CHECK_TRUE(memcmp(&signed_pkt[TEST_PKT_HEADER + TEST_MSG_ICV], icv, TEST_ICV_LENGTH) == 0,
+    "signature does not match HMAC-SHA256 of unsigned message");
+
+  END_TEST();
+}
+
+static void
+test_signed_message_accepted(void) {
+  const struct rfc5444_sig_statistics *stats;
+  uint32_t verifications;
+  size_t len;
+
+  START_TEST();
+
+  stats = rfc5444_sig_get_statistics();
+  verifications = stats->verifications;
+
+  len = _generate(TEST_MSGTYPE_SIGNED);
+  CHECK_TRUE(len > 0, "could not generate message");
+  CHECK_TRUE(_parse(_packet, len), "signed message was dropped");
+  CHECK_TRUE(stats->verifications == verifications + 1, "signature was checked %u times",
+    stats->verifications - verifications);
+
+  END_TEST();
+}
+
+static void
+test_forwarded_copy_uses_cache(void) {
+  const struct rfc5444_sig_statistics *stats;
+  uint32_t verifications, cache_hits;
+  size_t len;
+
+  START_TEST();
+
+  stats = rfc5444_sig_get_statistics();
+
+  len = _generate(TEST_MSGTYPE_SIGNED);
+  CHECK_TRUE(_parse(_packet, len), "signed message was dropped");
+
+  verifications = stats->verifications;
+  cache_hits = stats->cache_hits;
+
+  /* hoplimit and hopcount are not part of the signature */
+  _packet[TEST_PKT_HEADER + TEST_MSG_HOPLIMIT] = 254;
+  _packet[TEST_PKT_HEADER + TEST_MSG_HOPCOUNT] = 1;
+
+  CHECK_TRUE(_parse(_packet, len), "forwarded copy was dropped");
+  CHECK_TRUE(stats->verifications == verifications, "forwarded copy was checked again");
+  CHECK_TRUE(stats->cache_hits == cache_hits + 1, "forwarded copy was not found in cache");
+
+  END_TEST();
+}
+
+static void
+test_modified_message_dropped(void) {
+  const struct rfc5444_sig_statistics *stats;
+  uint32_t verifications;
+  size_t len;
+
+  START_TEST();
+
+  stats = rfc5444_sig_get_statistics();
+
+  len = _generate(TEST_MSGTYPE_SIGNED);
+  CHECK_TRUE(_parse(_packet, len), "signed message was dropped");
+
+  /* the same signature with a modified address must not be taken from the cache */
+  verifications = stats->verifications;
+  _packet[len - TEST_ADDR_TAIL] ^= 1;
+  CHECK_TRUE(!_parse(_packet, len), "message with modified address was accepted");
+  CHECK_TRUE(stats->verifications == verifications + 1, "modified message was not checked");
+
+  /* modified signature */
+  _packet[len - TEST_ADDR_TAIL] ^= 1;
+  _packet[TEST_PKT_HEADER + TEST_MSG_ICV] ^= 1;
+  CHECK_TRUE(!_parse(_packet, len), "message with modified signature was accepted");
+
+  END_TEST();
+}
+
+static void
+test_unsigned_message_dropped(void) {
+  size_t len;
+
+  START_TEST();
+
+  len = _generate(TEST_MSGTYPE_UNSIGNED);
+  CHECK_TRUE(len > 0, "could not generate message");
+
+  _packet[TEST_PKT_HEADER] = TEST_MSGTYPE_SIGNED;
+  CHECK_TRUE(!_parse(_packet, len), "message without signature was accepted");
+
+  END_TEST();
+}
+
+static void
+test_batch_verification(void) {
+  const struct rfc5444_sig_statistics *stats;
+  uint32_t verifications, cache_hits, batched;
+  size_t len, second;
+  int received;
+
+  START_TEST();
+
+  stats = rfc5444_sig_get_statistics();
+
+  /* use sequence numbers that have not been checked before */
+  len = _generate_packet(TEST_MSGTYPE_SIGNED, 1000, TEST_BATCH_SIZE);
+  CHECK_TRUE(len > 0, "could not generate packet");
+
+  /* all messages are checked in one batch before they are parsed */
+  received = _received;
+  verifications = stats->verifications;
+  cache_hits = stats->cache_hits;
+  batched = stats->batched;
+
+  rfc5444_reader_handle_packet(&_protocol->reader, _packet, len);
+  CHECK_TRUE(_received == received + TEST_BATCH_SIZE, "%d of %d messages accepted", _received - received,
+    TEST_BATCH_SIZE);
+  CHECK_TRUE(stats->verifications == verifications + TEST_BATCH_SIZE, "%u signatures checked",
+    stats->verifications - verifications);
+  CHECK_TRUE(stats->batched == batched + TEST_BATCH_SIZE, "%u signatures checked in batch",
+    stats->batched - batched);
+  CHECK_TRUE(stats->cache_hits == cache_hits + TEST_BATCH_SIZE, "%u messages took batch result from cache",
+    stats->cache_hits - cache_hits);
+
+  /* modify signature of second message, the others are still in the cache */
+  second = TEST_PKT_HEADER + 256 * _packet[TEST_PKT_HEADER + 2] + _packet[TEST_PKT_HEADER + 3];
+  _packet[second + TEST_MSG_ICV] ^= 1;
+
+  received = _received;
+  verifications = stats->verifications;
+  batched = stats->batched;
+
+  rfc5444_reader_handle_packet(&_protocol->reader, _packet, len);
+  CHECK_TRUE(_received == received + TEST_BATCH_SIZE - 1, "%d of %d messages accepted", _received - received,
+    TEST_BATCH_SIZE - 1);
+  CHECK_TRUE(stats->verifications == verifications + 1, "%u signatures checked",
+    stats->verifications - verifications);
+  CHECK_TRUE(stats->batched == batched, "single signature was checked in batch");
+
+  END_TEST();
+}
+
+static void
+test_hmac_key_states(void) {
+  /* RFC 4231 test case 1 and 2 */
+  static const uint8_t key1[20] = { 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b };
+  static const char *data1 = "Hi There";
+  static const uint8_t hmac1[32] = { 0xb0, 0x34, 0x4c, 0x61, 0xd8, 0xdb, 0x38, 0x53, 0x5c, 0xa8, 0xaf, 0xce, 0xaf,
+    0x0b, 0xf1, 0x2b, 0x88, 0x1d, 0xc2, 0x00, 0xc9, 0x83, 0x3d, 0xa7, 0x26, 0xe9, 0x37, 0x6c, 0x2e, 0x32, 0xcf,
+    0xf7 };
+  static const char *key2 = "Jefe";
+  static const char *data2 = "what do ya want for nothing?";
+  static const uint8_t hmac2[32] = { 0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a, 0x04, 0x24, 0x26, 0x08,
+    0x95, 0x75, 0xc7, 0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27, 0x39, 0x83, 0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38,
+    0x43 };
+
+  union {
+    uint64_t align;
+    uint8_t buffer[RFC7182_MAX_CONTEXT_SIZE];
+  } ctx[2];
+  struct rfc7182_segment segments[2];
+  struct rfc7182_crypt *crypt;
+  struct rfc7182_hash *hash;
+  uint8_t dst[2][TEST_ICV_LENGTH];
+  size_t dst_len[2];
+  int i;
+
+  START_TEST();
+
+  crypt = rfc7182_get_crypt(RFC7182_ICV_CRYPT_HMAC);
+  hash = rfc7182_get_hash(RFC7182_ICV_HASH_SHA_256);
+  CHECK_TRUE(crypt != NULL && hash != NULL && crypt->sign_init != NULL, "no incremental HMAC-SHA256");
+  if (crypt == NULL || hash == NULL || crypt->sign_init == NULL) {
+    END_TEST();
+    return;
+  }
+
+  /* alternate between keys, so remembered key states are used */
+  for (i = 0; i < 3; i++) {
+    segments[0].data = data1;
+    segments[0].length = 3;
+    segments[1].data = data1 + 3;
+    segments[1].length = strlen(data1) - 3;
+
+    dst_len[0] = sizeof(dst[0]);
+    CHECK_TRUE(rfc7182_sign_segments(crypt, hash, dst[0], &dst_len[0], segments, 2, key1, sizeof(key1)) == 0,
+      "round %d: HMAC 1 failed", i);
+    CHECK_TRUE(dst_len[0] == sizeof(hmac1) && memcmp(dst[0], hmac1, sizeof(hmac1)) == 0, "round %d: bad HMAC 1", i);
+
+    segments[0].data = data2;
+    segments[0].length = strlen(data2);
+
+    dst_len[1] = sizeof(dst[1]);
+    CHECK_TRUE(rfc7182_sign_segments(crypt, hash, dst[1], &dst_len[1], segments, 1, key2, strlen(key2)) == 0,
+      "round %d: HMAC 2 failed", i);
+    CHECK_TRUE(dst_len[1] == sizeof(hmac2) && memcmp(dst[1], hmac2, sizeof(hmac2)) == 0, "round %d: bad HMAC 2", i);
+  }
+
+  /* two concurrent calculations with the same key */
+  CHECK_TRUE(crypt->sign_init(crypt, hash, &ctx[0], key2, strlen(key2)) == 0, "init of first HMAC failed");
+  CHECK_TRUE(crypt->sign_init(crypt, hash, &ctx[1], key2, strlen(key2)) == 0, "init of second HMAC failed");
+  for (i = 0; i < 2; i++) {
+    CHECK_TRUE(crypt->sign_update(crypt, &ctx[i], data2, strlen(data2)) == 0, "update of HMAC %d failed", i);
+  }
+  for (i = 0; i < 2; i++) {
+    dst_len[i] = sizeof(dst[i]);
+    CHECK_TRUE(crypt->sign_final(crypt, &ctx[i], dst[i], &dst_len[i]) == 0, "final of HMAC %d failed", i);
+    CHECK_TRUE(dst_len[i] == sizeof(hmac2) && memcmp(dst[i], hmac2, sizeof(hmac2)) == 0, "bad concurrent HMAC %d", i);
+  }
+
+  END_TEST();
+}
+
+static int
+_run_tests(void) {
+  size_t i;
+
+  _protocol = oonf_rfc5444_get_default_protocol();
+
+  rfc5444_writer_register_target(&_protocol->writer, &_target);
+  for (i = 0; i < ARRAYSIZE(_providers); i++) {
+    _messages[i] = rfc5444_writer_register_message(&_protocol->writer, _providers[i].msg_type, false);
+    _messages[i]->addMessageHeader = _cb_add_message_header;
+    rfc5444_writer_register_msgcontentprovider(&_protocol->writer, &_providers[i], NULL, 0);
+  }
+  rfc5444_reader_add_message_consumer(&_protocol->reader, &_consumer, NULL, 0);
+
+  BEGIN_TESTING(NULL);
+
+  test_signature_matches_reference();
+  test_signed_message_accepted();
+  test_forwarded_copy_uses_cache();
+  test_modified_message_dropped();
+  test_unsigned_message_dropped();
+  test_batch_verification();
+  test_hmac_key_states();
+
+  rfc5444_reader_remove_message_consumer(&_protocol->reader, &_consumer);
+  for (i = 0; i < ARRAYSIZE(_providers); i++) {
+    rfc5444_writer_unregister_content_provider(&_protocol->writer, &_providers[i], NULL, 0);
+    rfc5444_writer_unregister_message(&_protocol->writer, _messages[i]);
+  }
+  rfc5444_writer_unregister_target(&_protocol->writer, &_target);
+
+  return FINISH_TESTING();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv) {
+  return olsrv2_harness_run(argv[0], _settings, ARRAYSIZE(_settings), _run_tests);
+}